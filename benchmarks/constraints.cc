@@ -0,0 +1,283 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+// Time the evaluation of the value and of the jacobian of the functions.
+//
+// Usage: constraints [filter] [iterations]
+//
+// Only the benchmarks whose name contains filter are run. The results
+// are written on the standard output, one line per measure, in CSV:
+//   name,evaluation,iterations,nanoseconds
+// where nanoseconds is the mean time of one evaluation. The evaluation of
+// the projectors is "solve" and their number of successes is written on
+// the standard error.
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/simple-device.hh>
+#include <hpp/pinocchio/center-of-mass-computation.hh>
+
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/differentiable-function-stack.hh>
+#include <hpp/constraints/relative-com.hh>
+#include <hpp/constraints/com-between-feet.hh>
+#include <hpp/constraints/symbolic-calculus.hh>
+#include <hpp/constraints/symbolic-function.hh>
+#include <hpp/constraints/convex-shape.hh>
+#include <hpp/constraints/convex-shape-contact.hh>
+#include <hpp/constraints/distance-between-bodies.hh>
+#include <hpp/constraints/newton-projector.hh>
+#ifdef HPP_CONSTRAINTS_USE_QPOASES
+# include <hpp/constraints/static-stability.hh>
+# include <hpp/constraints/qp-static-stability.hh>
+#endif
+
+using hpp::pinocchio::Configuration_t;
+using hpp::pinocchio::DevicePtr_t;
+using hpp::pinocchio::JointPtr_t;
+using hpp::pinocchio::Transform3f;
+
+using namespace hpp::constraints;
+
+namespace {
+  typedef std::vector <Configuration_t> Configurations_t;
+  typedef boost::posix_time::ptime Time_t;
+
+  std::string filter;
+  std::size_t iterations = 1000;
+
+  Time_t now ()
+  {
+    return boost::posix_time::microsec_clock::universal_time ();
+  }
+
+  /// Random configurations. The evaluations cycle through them so that
+  /// the caches of the functions are not hit.
+  Configurations_t shoot (const DevicePtr_t& robot, std::size_t n)
+  {
+    Configurations_t qs (n, Configuration_t (robot->configSize ()));
+    const size_type extraDim = robot->extraConfigSpace ().dimension ();
+    for (std::size_t i = 0; i < n; ++i) {
+      qs[i].head (robot->configSize () - extraDim) =
+        se3::randomConfiguration (robot->model ());
+      qs[i].tail (extraDim).setZero ();
+    }
+    return qs;
+  }
+
+  void print (const std::string& name, const std::string& evaluation,
+      const Time_t& start)
+  {
+    const double ns = (double) (now () - start).total_microseconds ()
+      * 1e3 / (double) iterations;
+    std::cout << name << ',' << evaluation << ',' << iterations << ','
+      << ns << std::endl;
+  }
+
+  /// Time the value, the jacobian and both.
+  void run (const std::string& name, const DifferentiableFunction& f,
+      const Configurations_t& qs)
+  {
+    if (name.find (filter) == std::string::npos) return;
+    vector_t value (f.outputSize ());
+    matrix_t jacobian (f.outputDerivativeSize (), f.inputDerivativeSize ());
+
+    Time_t start = now ();
+    for (std::size_t i = 0; i < iterations; ++i)
+      f (value, qs [i % qs.size ()]);
+    print (name, "value", start);
+
+    start = now ();
+    for (std::size_t i = 0; i < iterations; ++i)
+      f.jacobian (jacobian, qs [i % qs.size ()]);
+    print (name, "jacobian", start);
+
+    start = now ();
+    for (std::size_t i = 0; i < iterations; ++i) {
+      f (value, qs [i % qs.size ()]);
+      f.jacobian (jacobian, qs [i % qs.size ()]);
+    }
+    print (name, "value+jacobian", start);
+  }
+
+  /// Time the projection of the configurations.
+  void run (const std::string& name, NewtonProjector& projector,
+      const Configurations_t& qs)
+  {
+    if (name.find (filter) == std::string::npos) return;
+    Configuration_t q;
+    std::size_t nbSuccesses = 0;
+    Time_t start = now ();
+    for (std::size_t i = 0; i < iterations; ++i) {
+      q = qs [i % qs.size ()];
+      if (projector.solve (q) == NewtonProjector::SUCCESS) ++nbSuccesses;
+    }
+    print (name, "solve", start);
+    std::cerr << name << ": " << nbSuccesses << " successes out of "
+      << iterations << std::endl;
+  }
+
+  /// Square of side 2*half in the plane z = 0 of a joint.
+  ConvexShape square (const JointPtr_t& joint, const vector3_t& center,
+      value_type half)
+  {
+    std::vector <vector3_t> pts (4, center);
+    pts[0] += vector3_t (-half, -half, 0);
+    pts[1] += vector3_t ( half, -half, 0);
+    pts[2] += vector3_t ( half,  half, 0);
+    pts[3] += vector3_t (-half,  half, 0);
+    return ConvexShape (pts, joint);
+  }
+} // namespace
+
+int main (int argc, char** argv)
+{
+  if (argc > 1) filter = argv[1];
+  if (argc > 2) iterations = std::strtoul (argv[2], NULL, 10);
+
+  DevicePtr_t robot = hpp::pinocchio::humanoidSimple ("benchmark");
+  const Configurations_t qs = shoot (robot, 100);
+  const JointPtr_t ee1 = robot->getJointByName ("lleg5_joint"),
+                   ee2 = robot->getJointByName ("rleg5_joint");
+  robot->currentConfiguration (qs [0]);
+  robot->computeForwardKinematics ();
+  const Transform3f tf1 (ee1->currentTransformation ());
+  const Transform3f tf2 (ee2->currentTransformation ());
+
+  std::cout << "name,evaluation,iterations,nanoseconds" << std::endl;
+
+  // GenericTransformation
+  run ("Position", *Position::create
+      ("Position", robot, ee2, tf2, tf1), qs);
+  run ("Orientation", *Orientation::create
+      ("Orientation", robot, ee2, tf2), qs);
+  run ("Transformation", *Transformation::create
+      ("Transformation", robot, ee1, tf1), qs);
+  run ("RelativePosition", *RelativePosition::create
+      ("RelativePosition", robot, ee1, ee2, tf1, tf2), qs);
+  run ("RelativeOrientation", *RelativeOrientation::create
+      ("RelativeOrientation", robot, ee1, ee2, tf1), qs);
+  run ("RelativeTransformation", *RelativeTransformation::create
+      ("RelativeTransformation", robot, ee1, ee2, tf1, tf2), qs);
+
+  // Center of mass
+  run ("RelativeCom", *RelativeCom::create
+      (robot, ee1, vector3_t (0, 0, 1)), qs);
+  run ("ComBetweenFeet", *ComBetweenFeet::create
+      ("ComBetweenFeet", robot, ee1, ee2, vector3_t::Zero (),
+       vector3_t::Zero (), robot->rootJoint (), vector3_t::Zero ()), qs);
+
+  // SymbolicFunction
+  {
+    CalculusArena arena;
+    CalculusArena::Scope scope (arena);
+    typedef Difference <PointInJoint, PointInJoint> Expression_t;
+    Traits <Expression_t>::Ptr_t expr =
+      PointInJoint::create (ee1, vector3_t::Zero (), robot->numberDof ())
+      - PointInJoint::create (ee2, vector3_t::Zero (), robot->numberDof ());
+    run ("SymbolicFunction", *SymbolicFunction <Expression_t>::create
+        ("SymbolicFunction", robot, expr), qs);
+  }
+
+  // ConvexShapeContact with a growing number of floors.
+  for (std::size_t n = 1; n <= 64; n *= 4) {
+    ConvexShapeContactPtr_t f = ConvexShapeContact::create
+      ("ConvexShapeContact", robot);
+    f->addObject (square (ee1, vector3_t::Zero (), 0.05));
+    f->addObject (square (ee2, vector3_t::Zero (), 0.05));
+    for (std::size_t i = 0; i < n; ++i)
+      f->addFloor (square (JointPtr_t (),
+            vector3_t (0.2 * (value_type) i, 0, 0), 0.1));
+    std::ostringstream name; name << "ConvexShapeContact/" << n;
+    run (name.str (), *f, qs);
+  }
+
+#ifdef HPP_CONSTRAINTS_USE_QPOASES
+  // Static stability with a growing number of contacts.
+  CenterOfMassComputationPtr_t com = CenterOfMassComputation::create (robot);
+  com->add (robot->rootJoint ());
+  for (std::size_t n = 1; n <= 16; n *= 2) {
+    StaticStability::Contacts_t contacts (n);
+    for (std::size_t i = 0; i < n; ++i) {
+      StaticStability::Contact_t& c = contacts [i];
+      c.joint1 = (i % 2 == 0) ? ee1 : ee2;
+      c.point1 = vector3_t (0.01 * (value_type) i, 0, 0);
+      c.normal1 = vector3_t (0, 0, 1);
+      c.point2 = vector3_t (0.01 * (value_type) i, 0, 0);
+      c.normal2 = vector3_t (0, 0, 1);
+    }
+    std::ostringstream name; name << "StaticStability/" << n;
+    run (name.str (), *StaticStability::create
+        ("StaticStability", robot, contacts, com), qs);
+    // One run per solver of the contact forces.
+    const char* solverNames [4] =
+      { "FullQP", "ReducedQP", "NNLS", "DualActiveSet" };
+    const QPStaticStability::Solver_t solvers [4] = {
+      QPStaticStability::FULL_QP, QPStaticStability::REDUCED_QP,
+      QPStaticStability::NNLS, QPStaticStability::DUAL_ACTIVE_SET };
+    for (std::size_t s = 0; s < 4; ++s) {
+      QPStaticStabilityPtr_t qp (QPStaticStability::create
+          ("QPStaticStability", robot, contacts, com));
+      qp->solver (solvers [s]);
+      std::ostringstream qpName;
+      qpName << "QPStaticStability/" << solverNames [s] << '/' << n;
+      run (qpName.str (), *qp, qs);
+    }
+  }
+#endif
+
+  // DistanceBetweenBodies requires collision pairs between the feet.
+  try {
+    run ("DistanceBetweenBodies", *DistanceBetweenBodies::create
+        ("DistanceBetweenBodies", robot, ee1, ee2), qs);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "DistanceBetweenBodies: " << e.what () << std::endl;
+  }
+
+  // DifferentiableFunctionStack, sequential and in parallel.
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("DifferentiableFunctionStack");
+  stack->add (Transformation::create ("Transformation1", robot, ee1, tf1));
+  stack->add (Transformation::create ("Transformation2", robot, ee2, tf2));
+  stack->add (RelativeCom::create (robot, ee1, vector3_t (0, 0, 1)));
+  stack->add (RelativeTransformation::create
+      ("RelativeTransformation", robot, ee1, ee2, tf1, tf2));
+  run ("DifferentiableFunctionStack", *stack, qs);
+  stack->parallel (robot, 4);
+  run ("DifferentiableFunctionStack/parallel", *stack, qs);
+
+  // NewtonProjector on the placements of the feet.
+  DifferentiableFunctionStackPtr_t feet =
+    DifferentiableFunctionStack::create ("Feet");
+  feet->add (Transformation::create ("Transformation1", robot, ee1, tf1));
+  feet->add (Transformation::create ("Transformation2", robot, ee2, tf2));
+  NewtonProjectorPtr_t projector (NewtonProjector::create (feet, robot));
+  run ("NewtonProjector/QR", *projector, qs);
+  projector->decomposition (NewtonProjector::TRUNCATED_SVD);
+  run ("NewtonProjector/SVD", *projector, qs);
+  return 0;
+}
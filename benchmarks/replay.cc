@@ -0,0 +1,143 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+// Record the evaluations of the functions of a projection workload and
+// replay them.
+//
+// Usage: replay record file [iterations]
+//        replay file
+//
+// The first form projects random configurations on the placements of the
+// feet of a humanoid robot and records the evaluations in file (see
+// Recorder). The second one replays the evaluations of file on the same
+// functions, so that two builds can be compared on identical inputs. The
+// results are written on the standard output, in CSV:
+//   evaluation,count,recorded,replayed
+// where recorded and replayed are the mean times in nanoseconds.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/simple-device.hh>
+
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/differentiable-function-stack.hh>
+#include <hpp/constraints/newton-projector.hh>
+#include <hpp/constraints/recorder.hh>
+
+using hpp::pinocchio::Configuration_t;
+using hpp::pinocchio::DevicePtr_t;
+using hpp::pinocchio::JointPtr_t;
+using hpp::pinocchio::Transform3f;
+
+using namespace hpp::constraints;
+
+namespace {
+  Configuration_t shoot (const DevicePtr_t& robot)
+  {
+    Configuration_t q (robot->configSize ());
+    const size_type extraDim = robot->extraConfigSpace ().dimension ();
+    q.head (robot->configSize () - extraDim) =
+      se3::randomConfiguration (robot->model ());
+    q.tail (extraDim).setZero ();
+    return q;
+  }
+
+  /// The placements of the feet at a fixed configuration.
+  DifferentiableFunctionStackPtr_t feet (const DevicePtr_t& robot)
+  {
+    std::srand (0);
+    const JointPtr_t ee1 = robot->getJointByName ("lleg5_joint"),
+                     ee2 = robot->getJointByName ("rleg5_joint");
+    robot->currentConfiguration (shoot (robot));
+    robot->computeForwardKinematics ();
+    const Transform3f tf1 (ee1->currentTransformation ());
+    const Transform3f tf2 (ee2->currentTransformation ());
+    DifferentiableFunctionStackPtr_t stack =
+      DifferentiableFunctionStack::create ("Feet");
+    stack->add (Transformation::create ("Transformation1", robot, ee1, tf1));
+    stack->add (Transformation::create ("Transformation2", robot, ee2, tf2));
+    return stack;
+  }
+
+  void record (const DevicePtr_t& robot, const std::string& filename,
+      std::size_t iterations)
+  {
+    RecorderPtr_t recorder (Recorder::create (feet (robot), filename));
+    DifferentiableFunctionStackPtr_t stack =
+      DifferentiableFunctionStack::create ("Recorded feet");
+    stack->add (recorder);
+    NewtonProjectorPtr_t projector (NewtonProjector::create (stack, robot));
+    Configuration_t q;
+    for (std::size_t i = 0; i < iterations; ++i) {
+      q = shoot (robot);
+      projector->solve (q);
+    }
+    recorder->flush ();
+    std::cerr << recorder->nbRecords () << " evaluations recorded in "
+      << filename << std::endl;
+  }
+
+  void replay (const DevicePtr_t& robot, const std::string& filename)
+  {
+    RecordingPtr_t recording (Recording::load (filename));
+    std::cerr << recording->description () << std::endl;
+    DifferentiableFunctionStackPtr_t stack (feet (robot));
+    vector_t durations;
+    recording->replay (*stack, durations);
+
+    const EvaluationStatistics::Evaluation evaluations [3] = {
+      EvaluationStatistics::VALUE, EvaluationStatistics::JACOBIAN,
+      EvaluationStatistics::VALUE_AND_JACOBIAN };
+    std::cout << "evaluation,count,recorded,replayed" << std::endl;
+    for (std::size_t e = 0; e < 3; ++e) {
+      std::size_t count = 0;
+      value_type recorded = 0, replayed = 0;
+      for (std::size_t i = 0; i < recording->size (); ++i) {
+        if (recording->evaluation (i) != evaluations [e]) continue;
+        ++count;
+        recorded += recording->duration (i);
+        replayed += durations [(size_type) i];
+      }
+      if (count == 0) continue;
+      std::cout << EvaluationStatistics::name (evaluations [e]) << ','
+        << count << ',' << 1e9 * recorded / (value_type) count << ','
+        << 1e9 * replayed / (value_type) count << std::endl;
+    }
+  }
+} // namespace
+
+int main (int argc, char** argv)
+{
+  DevicePtr_t robot = hpp::pinocchio::humanoidSimple ("replay");
+  if (argc > 2 && std::string (argv[1]) == "record") {
+    const std::size_t iterations =
+      (argc > 3 ? std::strtoul (argv[3], NULL, 10) : 100);
+    record (robot, argv[2], iterations);
+  } else if (argc == 2) {
+    replay (robot, argv[1]);
+  } else {
+    std::cerr << "Usage: " << argv[0] << " record file [iterations]\n"
+      << "       " << argv[0] << " file" << std::endl;
+    return 1;
+  }
+  return 0;
+}
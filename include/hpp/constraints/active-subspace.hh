@@ -0,0 +1,118 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_ACTIVE_SUBSPACE_HH
+# define HPP_CONSTRAINTS_ACTIVE_SUBSPACE_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Subspace of the velocity in which the jacobians are expressed.
+    ///
+    /// When parts of the robot are locked, only the velocity of the other
+    /// joints matters. The reduced jacobian of a function is \f$ J S \f$
+    /// where the columns of the selection matrix \f$ S \f$ span the active
+    /// subspace. \f$ S \f$ is either a selection of columns of the
+    /// velocity, or a general matrix, for instance to move a Lie group
+    /// segment along some directions only.
+    ///
+    /// \sa DifferentiableFunction::reducedJacobian
+    class HPP_CONSTRAINTS_DLLAPI ActiveSubspace
+    {
+      public:
+        typedef std::vector <size_type> Columns_t;
+
+        /// The whole velocity space of dimension size.
+        explicit ActiveSubspace (size_type size);
+
+        /// The columns for which columns[i] is true.
+        explicit ActiveSubspace (const ArrayXb& columns);
+
+        /// The span of the columns of selection, a matrix with as many
+        /// rows as the velocity.
+        explicit ActiveSubspace (const matrix_t& selection);
+
+        /// Remove the velocity columns of a joint.
+        /// \throw std::logic_error if the subspace is not a selection of
+        ///        columns.
+        void lock (const JointConstPtr_t& joint);
+
+        /// Dimension of the velocity.
+        size_type size () const
+        {
+          return support_.size ();
+        }
+
+        /// Dimension of the subspace.
+        size_type dimension () const
+        {
+          return isSelection () ? (size_type) columns_.size ()
+            : selection_.cols ();
+        }
+
+        /// Whether the subspace is a selection of columns.
+        bool isSelection () const
+        {
+          return selection_.size () == 0;
+        }
+
+        /// Selected columns, in increasing order.
+        /// \note only for a selection of columns.
+        const Columns_t& columns () const
+        {
+          return columns_;
+        }
+
+        /// The selection matrix \f$ S \f$.
+        /// \note empty for a selection of columns.
+        const matrix_t& selection () const
+        {
+          return selection_;
+        }
+
+        /// Columns of the velocity that have a component in the subspace,
+        /// i.e. non zero rows of \f$ S \f$.
+        const ArrayXb& support () const
+        {
+          return support_;
+        }
+
+        /// reduced = jacobian \f$ S \f$
+        void reduce (matrixIn_t jacobian, matrixOut_t reduced) const;
+
+        /// velocity = \f$ S \f$ reducedVelocity
+        void expand (vectorIn_t reducedVelocity, vectorOut_t velocity) const;
+
+      private:
+        void computeColumns ();
+
+        ArrayXb support_;
+        Columns_t columns_;
+        matrix_t selection_;
+    }; // class ActiveSubspace
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_ACTIVE_SUBSPACE_HH
@@ -0,0 +1,144 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_AUTO_DIFF_FUNCTION_HH
+# define HPP_CONSTRAINTS_AUTO_DIFF_FUNCTION_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+
+# include <unsupported/Eigen/AutoDiff>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Derivative of the configuration \f$ q \oplus v \f$ with respect to
+    /// the velocity \f$ v \f$, at \f$ v = 0 \f$.
+    ///
+    /// \param robot the robot. If NULL, the configuration space is a vector
+    ///        space and the derivative is the identity.
+    /// \retval jacobian matrix of size q.size () x nv.
+    ///
+    /// The columns of the joints whose configuration and velocity have the
+    /// same size are exact. The others are computed by central differences
+    /// of the integration of the joint.
+    HPP_CONSTRAINTS_DLLAPI void integrateJacobian (const DevicePtr_t& robot,
+        ConfigurationIn_t q, matrixOut_t jacobian);
+
+    /// Differentiable function whose jacobian is computed by automatic
+    /// differentiation.
+    ///
+    /// Derived classes implement the function once, for any scalar type:
+    /// \code
+    ///   template <typename Scalar> void compute
+    ///     (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+    ///      const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& argument) const;
+    /// \endcode
+    /// The value calls it with value_type. The jacobian calls it once with
+    /// a forward mode scalar holding the derivatives with respect to the
+    /// velocity, instead of evaluating the function inputDerivativeSize ()
+    /// + 1 times as the finite differences do.
+    ///
+    /// \note compute must only depend on the argument. The forward
+    ///       kinematics of hpp-pinocchio is not templated on the scalar type.
+    template <typename Derived>
+    class AutoDiffFunction : public DifferentiableFunction
+    {
+      public:
+        typedef Eigen::AutoDiffScalar <vector_t> ADScalar_t;
+        typedef Eigen::Matrix <ADScalar_t, Eigen::Dynamic, 1> ADVector_t;
+
+        virtual ~AutoDiffFunction () throw () {}
+
+      protected:
+        /// \param robot used to differentiate the configuration with
+        ///        respect to the velocity, see integrateJacobian.
+        AutoDiffFunction (size_type sizeInput, size_type sizeInputDerivative,
+            size_type sizeOutput, const std::string& name,
+            const DevicePtr_t& robot = DevicePtr_t ()) :
+          DifferentiableFunction (sizeInput, sizeInputDerivative, sizeOutput,
+              name), robot_ (robot),
+          argument_ (sizeInput), value_ (sizeOutput),
+          adArgument_ (sizeInput), adValue_ (sizeOutput),
+          seed_ (sizeInput, sizeInputDerivative)
+        {}
+
+        virtual void impl_compute (vectorOut_t result,
+            ConfigurationIn_t argument) const throw ()
+        {
+          argument_ = argument;
+          derived ().compute (value_, argument_);
+          result = value_;
+        }
+
+        virtual void impl_jacobian (matrixOut_t jacobian,
+            ConfigurationIn_t arg) const throw ()
+        {
+          computeAD (arg);
+          copyJacobian (jacobian);
+        }
+
+        virtual void impl_valueAndJacobian (vectorOut_t result,
+            matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+        {
+          computeAD (arg);
+          for (size_type i = 0; i < outputSize (); ++i)
+            result [i] = adValue_ [i].value ();
+          copyJacobian (jacobian);
+        }
+
+      private:
+        const Derived& derived () const
+        {
+          return static_cast <const Derived&> (*this);
+        }
+
+        /// Evaluate the function with the derivatives.
+        void computeAD (ConfigurationIn_t arg) const
+        {
+          integrateJacobian (robot_, arg, seed_);
+          for (size_type i = 0; i < inputSize (); ++i) {
+            adArgument_ [i].value () = arg [i];
+            adArgument_ [i].derivatives () = seed_.row (i).transpose ();
+          }
+          derived ().compute (adValue_, adArgument_);
+        }
+
+        void copyJacobian (matrixOut_t jacobian) const
+        {
+          for (size_type i = 0; i < outputDerivativeSize (); ++i) {
+            // The derivatives of a constant output are empty.
+            if (adValue_ [i].derivatives ().size () == 0)
+              jacobian.row (i).setZero ();
+            else
+              jacobian.row (i) = adValue_ [i].derivatives ().transpose ();
+          }
+        }
+
+        DevicePtr_t robot_;
+        mutable vector_t argument_, value_;
+        mutable ADVector_t adArgument_, adValue_;
+        mutable matrix_t seed_;
+    }; // class AutoDiffFunction
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_AUTO_DIFF_FUNCTION_HH
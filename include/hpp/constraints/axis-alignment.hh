@@ -0,0 +1,134 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_AXIS_ALIGNMENT_HH
+# define HPP_CONSTRAINTS_AXIS_ALIGNMENT_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+# include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Alignment of two axes fixed in joints
+    ///
+    /// Let \f$u_1 = R_1 a_1\f$ and \f$u_2 = R_2 a_2\f$ be the unit vectors
+    /// \f$a_1, a_2\f$ of joints 1 and 2 expressed in the world frame. If
+    /// joint 1 is NULL, \f$a_1\f$ is fixed in the world frame.
+    ///
+    /// \li PARALLEL: the value is \f$\left(R_1 b_k\right)^T u_2\f$ for
+    ///     \f$k=1,2\f$, where \f$(a_1, b_1, b_2)\f$ is an orthonormal basis.
+    ///     It is the cross product \f$u_1 \times u_2\f$ expressed in the
+    ///     plane orthogonal to \f$u_1\f$. It is zero when the axes are
+    ///     parallel, or anti-parallel.
+    /// \li ORTHOGONAL: the value is \f$u_1^T u_2\f$.
+    ///
+    /// Each row \f$v = w^T u_2\f$ has jacobian
+    /// \f$\left(w \times u_2\right)^T W\f$ where \f$W\f$ is the opposite of
+    /// the relative angular velocity, see RelativeKinematics. Contrary to
+    /// RelativeOrientation with a mask, neither the log of the rotation
+    /// nor its jacobian are computed: the function is smooth everywhere.
+    ///
+    /// "Keep the tool axis z vertical" is
+    /// \code
+    ///   AxisAlignment::create ("vertical", robot, JointPtr_t (),
+    ///       vector3_t (0, 0, 1), tool, vector3_t (0, 0, 1));
+    /// \endcode
+    class HPP_CONSTRAINTS_DLLAPI AxisAlignment : public DifferentiableFunction
+    {
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      enum Mode_t {
+        /// The axes are parallel, 2 rows.
+        PARALLEL,
+        /// The axes are orthogonal, 1 row.
+        ORTHOGONAL
+      };
+
+      /// Create instance and return shared pointer
+      ///
+      /// \param name name of the constraint,
+      /// \param robot robot that own the joints,
+      /// \param joint1 joint holding axis1, NULL for the world frame,
+      /// \param axis1 axis in the frame of joint1,
+      /// \param joint2 joint holding axis2, may not be NULL,
+      /// \param axis2 axis in the frame of joint2,
+      /// \param mode alignment of the axes.
+      /// The axes are normalized.
+      static AxisAlignmentPtr_t create
+	(const std::string& name, const DevicePtr_t& robot,
+         const JointPtr_t& joint1, const vector3_t& axis1,
+         const JointPtr_t& joint2, const vector3_t& axis2,
+         Mode_t mode = PARALLEL);
+
+      virtual ~AxisAlignment () throw () {}
+
+      Mode_t mode () const
+      {
+        return mode_;
+      }
+
+      /// The rows are the coordinates of unit vectors.
+      virtual value_type lipschitzConstant () const;
+
+    protected:
+      /// Protected constructor
+      /// \sa create
+      AxisAlignment (const std::string& name, const DevicePtr_t& robot,
+         const JointPtr_t& joint1, const vector3_t& axis1,
+         const JointPtr_t& joint2, const vector3_t& axis2, Mode_t mode);
+
+      virtual void impl_compute (vectorOut_t result,
+				 ConfigurationIn_t argument) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_valueAndJacobian (vectorOut_t result,
+                                          matrixOut_t jacobian,
+                                          ConfigurationIn_t arg) const;
+
+    private:
+      /// Compute w_ and u2_.
+      void computeAxes () const;
+      /// Compute the value from w_ and u2_.
+      void computeValue (vectorOut_t result) const;
+
+      DevicePtr_t robot_;
+      KinematicsCachePtr_t kinematics_;
+      JointPtr_t joint1_, joint2_;
+      vector3_t axis1_, axis2_;
+      Mode_t mode_;
+      /// Vectors of joint 1 multiplied with u2: b1 and b2 for PARALLEL,
+      /// a1 for ORTHOGONAL.
+      Eigen::Matrix <value_type, 3, 2> local_;
+      KinematicsCache::Joints_t joints_;
+      RelativeKinematicsPtr_t relative_;
+      /// Columns where the jacobian may be non zero.
+      size_type colBegin_, activeCols_;
+      /// local_ and axis2 in the world frame.
+      mutable Eigen::Matrix <value_type, 3, 2> w_;
+      mutable vector3_t u2_;
+    }; // class AxisAlignment
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_AXIS_ALIGNMENT_HH
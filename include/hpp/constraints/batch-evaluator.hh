@@ -0,0 +1,122 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_BATCH_EVALUATOR_HH
+# define HPP_CONSTRAINTS_BATCH_EVALUATOR_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Evaluate several functions at several configurations on a pool of
+    /// threads.
+    ///
+    /// The grid of evaluations is cut into jobs of similar cost (see
+    /// DifferentiableFunction::evaluationCost), run as OpenMP tasks so
+    /// that idle threads take the remaining jobs:
+    /// \li the cheap thread safe functions are evaluated together on
+    ///     chunks of configurations, one configuration after the other,
+    ///     so that the forward kinematics of a configuration are computed
+    ///     once in the Workspace of the thread,
+    /// \li the expensive thread safe functions (cost above jobCost) have
+    ///     their own jobs, with fewer configurations,
+    /// \li the functions that are not thread safe are evaluated by a
+    ///     single job, with their own data.
+    ///
+    /// Each job writes its own columns of the output, so that the result
+    /// does not depend on the scheduling and no lock is needed.
+    ///
+    /// \note the jobs run in parallel only if the library is compiled with
+    ///       OpenMP.
+    class HPP_CONSTRAINTS_DLLAPI BatchEvaluator
+    {
+      public:
+        typedef std::vector <DifferentiableFunctionPtr_t> Functions_t;
+
+        /// \param robot the robot the functions are bound to. One Workspace
+        ///        of this robot is created per thread.
+        static BatchEvaluatorPtr_t create (const DevicePtr_t& robot,
+            std::size_t nbThreads);
+
+        /// Evaluate the functions.
+        /// \param configurations one configuration per column.
+        /// \retval values values[i] is the outputSize() x N matrix of the
+        ///         values of functions[i].
+        /// \retval jacobians if not NULL, (*jacobians)[i] is the jacobian of
+        ///         functions[i] at each configuration, laid out as by
+        ///         DifferentiableFunction::jacobianBatch.
+        void evaluate (const Functions_t& functions,
+            matrixIn_t configurations, std::vector <matrix_t>& values,
+            std::vector <matrix_t>* jacobians = NULL);
+
+        /// Target cost of a job, in units of evaluationCost.
+        void jobCost (value_type cost)
+        {
+          jobCost_ = cost;
+        }
+
+        value_type jobCost () const
+        {
+          return jobCost_;
+        }
+
+        std::size_t nbThreads () const
+        {
+          return workspaces_.size ();
+        }
+
+        /// Number of jobs of the last evaluation.
+        std::size_t nbJobs () const
+        {
+          return jobs_.size ();
+        }
+
+      private:
+        /// Functions [begin, end[ of order_ at configurations
+        /// [first, first + count[.
+        struct Job
+        {
+          std::size_t begin, end;
+          size_type first, count;
+          bool parallel;
+        };
+
+        BatchEvaluator (const DevicePtr_t& robot, std::size_t nbThreads);
+
+        void computeJobs (const Functions_t& functions, size_type nbConfigs);
+        void run (const Job& job, const Functions_t& functions,
+            matrixIn_t configurations, std::vector <matrix_t>& values,
+            std::vector <matrix_t>* jacobians, Workspace* workspace) const;
+
+        std::vector <WorkspacePtr_t> workspaces_;
+        value_type jobCost_;
+        /// Indices of the functions: the cheap thread safe ones, the
+        /// expensive thread safe ones and the others.
+        std::vector <std::size_t> order_;
+        std::vector <Job> jobs_;
+    }; // class BatchEvaluator
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_BATCH_EVALUATOR_HH
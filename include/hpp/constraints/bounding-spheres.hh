@@ -0,0 +1,57 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_BOUNDING_SPHERES_HH
+# define HPP_CONSTRAINTS_BOUNDING_SPHERES_HH
+
+# include <vector>
+
+# include <pinocchio/multibody/geometry.hpp>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Sphere of a coarse model of a geometry.
+    struct BoundingSphere
+    {
+      vector3_t center;
+      value_type radius;
+    };
+    typedef std::vector <BoundingSphere> BoundingSpheres_t;
+
+    /// Cover a geometry with spheres.
+    ///
+    /// The bounding box of the geometry is cut along its largest extent
+    /// into at most 16 pieces as long as its second largest extent, and each
+    /// piece is covered by its circumscribed sphere.
+    ///
+    /// \param placement placement of the geometry in the frame of the
+    ///        spheres,
+    /// \retval spheres the spheres are appended to this vector.
+    HPP_CONSTRAINTS_DLLAPI void coverWithSpheres
+      (fcl::CollisionGeometry& geometry, const Transform3f& placement,
+       BoundingSpheres_t& spheres);
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_BOUNDING_SPHERES_HH
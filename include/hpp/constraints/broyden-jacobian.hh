@@ -0,0 +1,196 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_BROYDEN_JACOBIAN_HH
+# define HPP_CONSTRAINTS_BROYDEN_JACOBIAN_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Approximate the jacobian of a function by Broyden updates.
+    ///
+    /// The value is the value of the wrapped function. The jacobian is
+    /// computed exactly once and then updated at each evaluation by the
+    /// rank one correction
+    /// \f$ J \leftarrow J + \frac{(\Delta f - J \Delta q) \Delta q^T}
+    ///                           {\Delta q^T \Delta q} \f$
+    /// where \f$\Delta q\f$ is the step from the configuration of the
+    /// previous jacobian and \f$\Delta f\f$ the variation of the value.
+    /// Each update costs one evaluation of the value of the function, which
+    /// is worth it for functions with expensive jacobians, such as
+    /// QPStaticStability and DistanceBetweenBodies.
+    ///
+    /// The exact jacobian is computed again
+    /// \li after maxUpdates updates,
+    /// \li when the norm of the value did not decrease by refreshRatio
+    ///     since the previous jacobian, since the approximation then does
+    ///     not lead the solver towards a solution,
+    /// \li after refresh has been called.
+    ///
+    /// The inactive columns of the function remain zero.
+    ///
+    /// \note The value of the function must be a vector: the output size
+    ///       and the output derivative size must be equal.
+    class HPP_CONSTRAINTS_DLLAPI BroydenJacobian :
+      public DifferentiableFunction
+    {
+      public:
+        /// Return a shared pointer to a new instance.
+        /// \param function the wrapped function,
+        /// \param robot robot used to compute the configuration steps.
+        ///        If NULL, the steps are the differences of the arguments.
+        static BroydenJacobianPtr_t create
+          (const DifferentiableFunctionPtr_t& function,
+           const DevicePtr_t& robot = DevicePtr_t ());
+
+        virtual ~BroydenJacobian () throw () {}
+
+        const DifferentiableFunctionPtr_t& function () const
+        {
+          return function_;
+        }
+
+        /// Maximal number of updates between two exact jacobians.
+        /// The default is 10. 0 disables the updates.
+        void maxUpdates (std::size_t n)
+        {
+          maxUpdates_ = n;
+        }
+
+        std::size_t maxUpdates () const
+        {
+          return maxUpdates_;
+        }
+
+        /// Minimal decrease of the norm of the value between two jacobians.
+        /// The jacobian is computed exactly if the norm of the value is
+        /// above ratio times the norm at the previous jacobian. The default
+        /// is 1.
+        void refreshRatio (value_type ratio)
+        {
+          refreshRatio_ = ratio;
+        }
+
+        value_type refreshRatio () const
+        {
+          return refreshRatio_;
+        }
+
+        /// Compute the exact jacobian at the next evaluation.
+        void refresh ()
+        {
+          valid_ = false;
+        }
+
+        /// Number of exact jacobians and of updates since the creation.
+        std::size_t nbExactJacobians () const
+        {
+          return nbExactJacobians_;
+        }
+
+        std::size_t nbUpdates () const
+        {
+          return nbBroydenUpdates_;
+        }
+
+        virtual void jacobianPattern (ArrayXXb& pattern) const
+        {
+          function_->jacobianPattern (pattern);
+        }
+
+        virtual value_type evaluationCost () const
+        {
+          return function_->evaluationCost ();
+        }
+
+        virtual value_type lipschitzConstant () const
+        {
+          return function_->lipschitzConstant ();
+        }
+
+        /// Switch the wrapped function and compute the exact jacobian at the
+        /// next evaluation.
+        virtual void approximate (bool approximate)
+        {
+          function_->approximate (approximate);
+          refresh ();
+        }
+
+        /// Set the accuracy of the wrapped function and compute the exact
+        /// jacobian at the next evaluation.
+        virtual void accuracy (value_type tolerance)
+        {
+          function_->accuracy (tolerance);
+          refresh ();
+        }
+
+        virtual void saveWarmStart (vector_t& state) const
+        {
+          function_->saveWarmStart (state);
+        }
+
+        /// Restore the state of the wrapped function and compute the exact
+        /// jacobian at the next evaluation.
+        virtual void restoreWarmStart (vectorIn_t state)
+        {
+          function_->restoreWarmStart (state);
+          refresh ();
+        }
+
+        virtual std::ostream& print (std::ostream& o) const;
+
+      protected:
+        BroydenJacobian (const DifferentiableFunctionPtr_t& function,
+                         const DevicePtr_t& robot);
+
+        void impl_compute (vectorOut_t result, vectorIn_t argument) const;
+
+        void impl_jacobian (matrixOut_t jacobian, vectorIn_t argument) const;
+
+        void impl_valueAndJacobian (vectorOut_t result, matrixOut_t jacobian,
+                                    vectorIn_t argument) const;
+
+      private:
+        /// Compute the exact jacobian or update the approximation.
+        /// \param value value of the function at argument.
+        void update (vectorIn_t value, vectorIn_t argument) const;
+
+        DifferentiableFunctionPtr_t function_;
+        DevicePtr_t robot_;
+        std::size_t maxUpdates_;
+        value_type refreshRatio_;
+
+        /// Approximation of the jacobian and the point where it was computed.
+        mutable matrix_t jacobian_;
+        mutable vector_t argument_, value_;
+        mutable bool valid_;
+        /// Updates since the last exact jacobian.
+        mutable std::size_t updates_;
+        /// Buffers of the updates.
+        mutable vector_t current_, step_, variation_;
+        mutable std::size_t nbExactJacobians_, nbBroydenUpdates_;
+    }; // class BroydenJacobian
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_BROYDEN_JACOBIAN_HH
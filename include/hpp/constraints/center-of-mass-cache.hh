@@ -0,0 +1,118 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_CENTER_OF_MASS_CACHE_HH
+# define HPP_CONSTRAINTS_CENTER_OF_MASS_CACHE_HH
+
+# include <vector>
+
+# include <hpp/pinocchio/device.hh>
+# include <hpp/pinocchio/center-of-mass-computation.hh>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Center of mass of a set of subtrees, computed once per version of
+    /// the KinematicsCache.
+    ///
+    /// Functions depending on the same center of mass (RelativeCom,
+    /// ComBetweenFeet, StaticStability...) share the same instance, so
+    /// that the center of mass and its jacobian are computed once per
+    /// configuration.
+    ///
+    /// Functions call KinematicsCache::update and then
+    /// CenterOfMassCache::compute before reading com and jacobian.
+    class HPP_CONSTRAINTS_DLLAPI CenterOfMassCache
+    {
+      public:
+        /// Get the instance for the whole robot.
+        /// It is created if it does not exist.
+        static CenterOfMassCachePtr_t get
+          (const KinematicsCachePtr_t& kinematics);
+
+        /// Get the instance for the subtrees of some joints.
+        /// It is created if it does not exist.
+        static CenterOfMassCachePtr_t get
+          (const KinematicsCachePtr_t& kinematics, const JointVector_t& roots);
+
+        /// Get the instance wrapping a CenterOfMassComputation.
+        /// It is created if it does not exist.
+        static CenterOfMassCachePtr_t get
+          (const KinematicsCachePtr_t& kinematics,
+           const CenterOfMassComputationPtr_t& comc);
+
+        /// Compute the center of mass, if it has not been computed with
+        /// flag at the current version of the KinematicsCache.
+        void compute (Device::Computation_t flag = Device::ALL)
+        {
+          if (version_ != kinematics_->version ()) {
+            version_ = kinematics_->version ();
+            flag_ = 0;
+          }
+          if ((flag_ & flag) == flag) return;
+          comc_->compute (flag);
+          flag_ |= flag;
+        }
+
+        const vector3_t& com () const
+        {
+          return comc_->com ();
+        }
+
+        const ComJacobian_t& jacobian () const
+        {
+          return comc_->jacobian ();
+        }
+
+        const CenterOfMassComputationPtr_t& computation () const
+        {
+          return comc_;
+        }
+
+        /// Columns of the jacobian that may be non zero.
+        ///
+        /// They correspond to the joints of the subtrees and their
+        /// ancestors. If the instance wraps a user defined
+        /// CenterOfMassComputation, the subtrees are not known and all the
+        /// columns but those of the extra config space are active.
+        const ArrayXb& activeDerivativeColumns () const
+        {
+          return activeDerivativeColumns_;
+        }
+
+      private:
+        /// \param roots root joints of the subtrees, empty if unknown.
+        CenterOfMassCache (const KinematicsCachePtr_t& kinematics,
+            const CenterOfMassComputationPtr_t& comc,
+            const JointVector_t& roots);
+
+        KinematicsCachePtr_t kinematics_;
+        CenterOfMassComputationPtr_t comc_;
+        std::size_t version_;
+        int flag_;
+        ArrayXb activeDerivativeColumns_;
+    }; // class CenterOfMassCache
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_CENTER_OF_MASS_CACHE_HH
@@ -26,6 +26,7 @@
 # include <hpp/constraints/fwd.hh>
 # include <hpp/constraints/tools.hh>
 # include <hpp/constraints/symbolic-calculus.hh>
+# include <hpp/constraints/fused-calculus.hh>
 
 namespace hpp {
   namespace constraints {
@@ -93,25 +94,33 @@ namespace hpp {
 
         virtual void impl_jacobian (matrixOut_t jacobian,
             ConfigurationIn_t arg) const throw ();
+
+        virtual void impl_valueAndJacobian (vectorOut_t result,
+            matrixOut_t jacobian, ConfigurationIn_t arg) const throw ();
       private:
         DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
         mutable Traits<PointCom>::Ptr_t com_;
         Traits<PointInJoint>::Ptr_t left_, right_;
         eigen::vector3_t pointRef_;
         JointPtr_t jointRef_;
         typedef Difference < PointCom, PointInJoint > DiffPCPiJ;
         typedef Difference < PointInJoint, PointInJoint > DiffPiJPiJ;
-        typedef Sum < PointInJoint, PointInJoint > SumPiJPiJ;
-        typedef CrossProduct < Difference < PointCom,
-                                            ScalarMultiply < SumPiJPiJ > >,
-                               DiffPiJPiJ > ECrossU_t;
         mutable Traits<DiffPCPiJ>::Ptr_t xmxl_, xmxr_;
         mutable Traits<DiffPiJPiJ>::Ptr_t u_;
-        mutable Traits<ECrossU_t>::Ptr_t ecrossu_;
-        mutable Traits<RotationMultiply <ECrossU_t> >::Ptr_t expr_;
+        // R^T (e x u) is evaluated with the fused expressions, so that
+        // only the row used by the function is computed.
+        typedef fused::PointInJoint FPiJ_t;
+        typedef fused::CrossProduct < fused::Difference < fused::PointCom,
+                  fused::ScalarMultiply < fused::Sum < FPiJ_t, FPiJ_t > > >,
+                fused::Difference < FPiJ_t, FPiJ_t > > ECrossU_t;
+        typedef fused::RotationMultiply < ECrossU_t > RTECrossU_t;
+        RTECrossU_t expr_;
         mutable Traits<CalculusBaseAbstract<value_type, RowJacobianMatrix > >::Ptr_t xmxlDotu_, xmxrDotu_;
         std::vector <bool> mask_;
         mutable eigen::matrix3_t cross_;
+        /// Invalidates the nodes shared by the expressions once.
+        mutable CalculusGraph graph_;
     }; // class ComBetweenFeet
   } // namespace constraints
 } // namespace hpp
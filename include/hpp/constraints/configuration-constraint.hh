@@ -28,23 +28,75 @@
 
 namespace hpp {
   namespace constraints {
+    /// Weighted squared distance to a goal configuration
+    ///
+    /// \f$ f(\mathbf{q}) = \frac{1}{2} \sum_i w_i d_i^2 \f$ where
+    /// \f$\mathbf{d} = \mathbf{q} - \mathbf{q}^{*}\f$ is the difference
+    /// of the configurations in the tangent space.
+    ///
+    /// The difference is only computed on the joints with a non zero
+    /// weight. It is computed once by the combined evaluation of the value
+    /// and of the jacobian.
     class HPP_CONSTRAINTS_DLLAPI ConfigurationConstraint : public DifferentiableFunction
     {
       public:
         EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
         /// Return a shared pointer to a new instance
+        /// \param mask the weight of DOF i is 1 if mask[i] is true, 0
+        ///        otherwise. Missing values are true.
         static ConfigurationConstraintPtr_t create (
             const std::string& name, const DevicePtr_t& robot,
             ConfigurationIn_t goal,
             std::vector <bool> mask = std::vector <bool> (0));
 
+        /// Return a shared pointer to a new instance
+        /// \param weights weights of the DOFs, of size robot->numberDof ().
+        static ConfigurationConstraintPtr_t create (
+            const std::string& name, const DevicePtr_t& robot,
+            ConfigurationIn_t goal, const vector_t& weights);
+
         virtual ~ConfigurationConstraint () throw () {}
 
         ConfigurationConstraint (const std::string& name,
             const DevicePtr_t& robot, ConfigurationIn_t goal,
             std::vector <bool> mask);
 
+        ConfigurationConstraint (const std::string& name,
+            const DevicePtr_t& robot, ConfigurationIn_t goal,
+            const vector_t& weights);
+
+        const vector_t& weights () const
+        {
+          return weights_;
+        }
+
+        const Configuration_t& goal () const
+        {
+          return goal_;
+        }
+
+        void goal (ConfigurationIn_t goal)
+        {
+          assert (goal.size () == goal_.size ());
+          goal_ = goal;
+        }
+
+        /// Jacobian of the value with respect to the goal.
+        ///
+        /// The goal is perturbed as \f$\mathbf{q}^{*} \oplus \delta\f$.
+        /// The jacobian is \f$-(w_i d_i)_i\f$, the opposite of the
+        /// configuration jacobian. It is exact for vector spaces and for
+        /// rotations whose degrees of freedom have the same weight.
+        /// \retval jacobian matrix of size 1 x robot->numberDof ().
+        void goalJacobian (matrixOut_t jacobian, ConfigurationIn_t argument)
+          const;
+
+        virtual bool threadSafe () const
+        {
+          return true;
+        }
+
       protected:
         /// Compute value of error
         ///
@@ -55,13 +107,49 @@ namespace hpp {
 
         virtual void impl_jacobian (matrixOut_t jacobian,
             ConfigurationIn_t arg) const throw ();
+
+        virtual void impl_valueAndJacobian (vectorOut_t result,
+            matrixOut_t jacobian, ConfigurationIn_t arg) const;
+
+        virtual void impl_valueBatch (matrixOut_t results,
+            matrixIn_t configurations) const;
+
+        virtual void impl_jacobianBatch (matrixOut_t jacobians,
+            matrixIn_t configurations) const;
+
+        virtual void impl_compute (vectorOut_t result,
+            ConfigurationIn_t argument, Workspace& workspace) const throw ();
+
+        virtual void impl_jacobian (matrixOut_t jacobian,
+            ConfigurationIn_t arg, Workspace& workspace) const throw ();
       private:
-        typedef Eigen::Array <bool, Eigen::Dynamic, 1> EigenBoolVector_t;
+        /// Range of the configuration and of the velocity of a joint.
+        struct JointRange
+        {
+          size_type iq, iv, nq, nv;
+        };
+
+        /// Compute the joint ranges with a non zero weight.
+        void init ();
+        /// Return the difference vector stored in the workspace.
+        vector_t& diff (Workspace& workspace) const;
+        /// Compute the difference between q and the goal on the joint
+        /// ranges. The other coefficients of d are not set.
+        void difference (ConfigurationIn_t q, vector_t& d) const;
+        value_type value (const vector_t& d) const;
+        void jacobian (const vector_t& d, matrixOut_t jacobian) const;
+
         DevicePtr_t robot_;
         Configuration_t goal_;
-        EigenBoolVector_t mask_;
+        vector_t weights_;
+        std::vector <JointRange> ranges_;
+        /// Whether some joints of ranges_ are not vector spaces.
+        bool lieGroup_;
         mutable vector_t diff_;
-    }; // class ComBetweenFeet
+
+        /// Evaluates the compiled stacks without virtual call.
+        friend class DifferentiableFunctionStack;
+    }; // class ConfigurationConstraint
   } // namespace constraints
 } // namespace hpp
 #endif // HPP_CONSTRAINTS_CONFIGURATION_CONSTRAINT_HH
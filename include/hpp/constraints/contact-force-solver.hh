@@ -0,0 +1,224 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_CONTACT_FORCE_SOLVER_HH
+# define HPP_CONSTRAINTS_CONTACT_FORCE_SOLVER_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/non-negative-least-squares.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup solvers
+    /// \{
+
+    /// Solve \f$ \min_{F \ge 0} \| A F - b \|^2 \f$ where \f$ A \f$ has 6
+    /// rows, the wrenches of the contact points.
+    ///
+    /// This is the problem solved by QPStaticStability. Successive problems
+    /// are close, so the solvers start from the solution of the previous
+    /// problem when the number of variables did not change, unless reset
+    /// was called.
+    class HPP_CONSTRAINTS_DLLAPI ContactForceSolver
+    {
+      public:
+        virtual ~ContactForceSolver () {}
+
+        /// Solve the problem.
+        /// \return true if the solution is optimal.
+        virtual bool solve (matrixIn_t A, vectorIn_t b) = 0;
+
+        /// Start the next problem from scratch.
+        virtual void reset () = 0;
+
+        /// Start the next problem from a solution, for instance the solution
+        /// of the problem at another configuration, saved by
+        /// QPStaticStability::saveWarmStart. The solution is ignored if the
+        /// next problem has another number of variables.
+        /// The default implementation calls reset.
+        virtual void warmStart (vectorIn_t /* solution */)
+        {
+          reset ();
+        }
+
+        /// Solution of the last call to solve.
+        const vector_t& solution () const
+        {
+          return solution_;
+        }
+
+        /// Gradient \f$ A^T (A F - b) \f$ at the solution, that is the
+        /// multipliers of the constraints \f$ F \ge 0 \f$.
+        const vector_t& dual () const
+        {
+          return dual_;
+        }
+
+        /// \f$ \| A F - b \|^2 \f$ at the solution.
+        value_type residual () const
+        {
+          return residual_;
+        }
+
+        /// Iterations of the last call to solve, in the unit of the solver.
+        std::size_t iterations () const
+        {
+          return iterations_;
+        }
+
+        /// Whether the last call to solve started from the previous solution
+        /// and succeeded.
+        bool warmStarted () const
+        {
+          return warmStarted_;
+        }
+
+        /// Maximal number of iterations of each call to solve, in the unit
+        /// of iterations.
+        void maxIterations (std::size_t n)
+        {
+          maxIterations_ = n;
+        }
+
+        std::size_t maxIterations () const
+        {
+          return maxIterations_;
+        }
+
+        /// Threshold of the violation of the optimality conditions.
+        /// A larger threshold stops the solver earlier.
+        void tolerance (value_type eps)
+        {
+          tolerance_ = eps;
+        }
+
+        value_type tolerance () const
+        {
+          return tolerance_;
+        }
+
+      protected:
+        ContactForceSolver (std::size_t maxIterations, value_type tolerance) :
+          residual_ (0), iterations_ (0), warmStarted_ (false),
+          maxIterations_ (maxIterations), tolerance_ (tolerance) {}
+
+        vector_t solution_, dual_;
+        value_type residual_;
+        std::size_t iterations_;
+        bool warmStarted_;
+        std::size_t maxIterations_;
+        value_type tolerance_;
+    }; // class ContactForceSolver
+
+    /// ContactForceSolver using NonNegativeLeastSquares.
+    class HPP_CONSTRAINTS_DLLAPI NNLSContactForceSolver :
+      public ContactForceSolver
+    {
+      public:
+        static ContactForceSolverPtr_t create ()
+        {
+          return ContactForceSolverPtr_t (new NNLSContactForceSolver);
+        }
+
+        virtual bool solve (matrixIn_t A, vectorIn_t b);
+
+        virtual void reset ()
+        {
+          reset_ = true;
+        }
+
+        virtual void warmStart (vectorIn_t solution)
+        {
+          start_ = solution;
+        }
+
+        /// The maximal number of iterations and the tolerance of the solver
+        /// are given to the NonNegativeLeastSquares at each call to solve.
+        NonNegativeLeastSquares& nnls ()
+        {
+          return nnls_;
+        }
+
+      private:
+        NNLSContactForceSolver () : ContactForceSolver (100, 1e-10),
+          reset_ (true) {}
+
+        NonNegativeLeastSquares nnls_;
+        bool reset_;
+        /// Solution given to warmStart, empty if none.
+        vector_t start_;
+    }; // class NNLSContactForceSolver
+
+    /// ContactForceSolver solving the dual problem
+    /// \f$ \min \frac{1}{2} \| u \|^2 + b^T u \f$ s.t. \f$ A^T u \ge 0 \f$,
+    /// whose multipliers are \f$ F \f$, by the dual active set method of
+    /// Goldfarb and Idnani (as eiquadprog).
+    ///
+    /// The hessian being the identity, the method only needs the QR
+    /// decomposition of the normals of the active constraints, of size
+    /// at most 6 x 6. The warm start begins with the active set of the
+    /// previous solution, without the constraints whose multipliers are
+    /// negative.
+    class HPP_CONSTRAINTS_DLLAPI DualActiveSetContactForceSolver :
+      public ContactForceSolver
+    {
+      public:
+        static ContactForceSolverPtr_t create ()
+        {
+          return ContactForceSolverPtr_t (new DualActiveSetContactForceSolver);
+        }
+
+        virtual bool solve (matrixIn_t A, vectorIn_t b);
+
+        virtual void reset ()
+        {
+          active_.clear ();
+        }
+
+        /// The active set is made of the positive variables of the
+        /// solution.
+        virtual void warmStart (vectorIn_t solution);
+
+      private:
+        typedef Eigen::Matrix <value_type, 6, 1> vector6_t;
+        typedef Eigen::Matrix <value_type, 6, 6> matrix6_t;
+        typedef Eigen::Matrix <value_type, 6, Eigen::Dynamic, 0, 6, 6>
+          Normals_t;
+
+        /// An iteration is a change of the active set.
+        DualActiveSetContactForceSolver () : ContactForceSolver (100, 1e-10),
+          size_ (0) {}
+
+        /// Decompose the normals of the active constraints.
+        void decompose (matrixIn_t A);
+
+        /// Active constraints and their multipliers.
+        std::vector <size_type> active_;
+        std::vector <value_type> multipliers_;
+        /// Q R = normals of the active constraints.
+        Normals_t normals_;
+        matrix6_t Q_, R_;
+        /// Number of variables of the previous problem.
+        size_type size_;
+    }; // class DualActiveSetContactForceSolver
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_CONTACT_FORCE_SOLVER_HH
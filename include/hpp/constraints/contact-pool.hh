@@ -0,0 +1,113 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_CONTACT_POOL_HH
+# define HPP_CONSTRAINTS_CONTACT_POOL_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/convex-shape-contact.hh>
+# include <hpp/constraints/symbolic-calculus.hh>
+# include <hpp/constraints/non-negative-least-squares.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Static stability of subsets of a set of candidate contacts.
+    ///
+    /// The residual of a subset is the value of QPStaticStability restricted
+    /// to the contacts of the subset:
+    /// \f$ \min_{F \ge 0} \| \phi F + G \|^2 \f$ where the columns of
+    /// \f$ \phi \f$ are the wrenches of the contact points of the subset.
+    ///
+    /// The expressions of the wrenches of all the candidates are built once,
+    /// and evaluated once per configuration. The problem of a subset starts
+    /// from the forces of the previous subsets, so that querying subsets
+    /// with most contacts in common is cheap.
+    class HPP_CONSTRAINTS_DLLAPI ContactPool
+    {
+      public:
+        typedef ConvexShapeContact::ForceData ForceData;
+        /// Selection of contacts, one boolean per candidate contact.
+        typedef std::vector <bool> Subset_t;
+
+        /// Return a shared pointer to a new instance
+        /// \param contacts the candidate contacts,
+        /// \param com center of mass of the robot.
+        static ContactPoolPtr_t create (const DevicePtr_t& robot,
+            const std::vector <ForceData>& contacts,
+            const CenterOfMassComputationPtr_t& com);
+
+        /// Number of candidate contacts.
+        std::size_t nbContacts () const
+        {
+          return firstColumn_.size () - 1;
+        }
+
+        /// Residual of a subset of contacts at a configuration.
+        value_type residual (ConfigurationIn_t q, const Subset_t& subset)
+          const;
+
+        /// Residual of a subset of contacts and its jacobian.
+        /// \retval jacobian the 1 x nv jacobian of the residual.
+        value_type residualAndJacobian (ConfigurationIn_t q,
+            const Subset_t& subset, matrixOut_t jacobian) const;
+
+        /// Forces of the contact points of all the candidates computed by
+        /// the last query. The forces of the contacts that were not in the
+        /// subset are zero.
+        const vector_t& forces () const
+        {
+          return subsetForces_;
+        }
+
+      protected:
+        ContactPool (const DevicePtr_t& robot,
+            const std::vector <ForceData>& contacts,
+            const CenterOfMassComputationPtr_t& com);
+
+      private:
+        typedef MatrixOfExpressions<eigen::vector3_t, JacobianMatrix> MoE_t;
+
+        /// Compute phi_ at q if needed and solve the problem of subset.
+        value_type solve (ConfigurationIn_t q, const Subset_t& subset,
+            bool jacobian) const;
+
+        DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
+        /// First column of phi_ of each contact, and the number of columns.
+        std::vector <size_type> firstColumn_;
+        /// Memory of the nodes of phi_.
+        CalculusArena arena_;
+        mutable MoE_t phi_;
+        /// Version of the KinematicsCache at which phi_ was computed.
+        mutable std::size_t version_;
+        /// Columns of phi_ of the current subset.
+        mutable matrix_t A_;
+        /// Latest forces of each contact point, used as starting points.
+        mutable vector_t forces_;
+        mutable vector_t x0_, subsetForces_;
+        mutable NonNegativeLeastSquares nnls_;
+    }; // class ContactPool
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_CONTACT_POOL_HH
@@ -25,6 +25,7 @@
 # include <hpp/constraints/generic-transformation.hh>
 # include <hpp/constraints/differentiable-function.hh>
 # include <hpp/constraints/convex-shape.hh>
+# include <hpp/constraints/convex-shape-tree.hh>
 
 namespace hpp {
   namespace constraints {
@@ -53,7 +54,9 @@ namespace hpp {
         \li \f$d_{\parallel} = d(f_j, P (C_{o_i}, f_j))\f$ is the distance returned by ConvexShape::distance,
         \li \f$d_{\perp} = \textbf{n}_{f_j}.C_{f_j}P(C_{o_i}, f_j)\f$ is the distance along the normal of \f$ f_j \f$,
 
-        The function first selects the pair \f$(o_i,f_j)\f$ with shortest distance.
+        The function first selects the pair \f$(o_i,f_j)\f$ with shortest
+        distance. The floor shapes are stored in a ConvexShapeTree so that
+        the floor shapes far from the object shapes are not considered.
         \f$o_i\f$ is \emph{inside} \f$f_j\f$ if \f$d(i,j) < 0\f$.
         returns a value that depends on the contact types:
 
@@ -131,10 +134,25 @@ namespace hpp {
         /// Add a ConvexShape as an object.
         void addObject (const ConvexShape& t);
 
+        const std::vector <ConvexShape>& objectConvexShapes () const
+        {
+          return objectConvexShapes_;
+        }
+
+        /// The floor shapes, reversed by addFloor.
+        const std::vector <ConvexShape>& floorConvexShapes () const
+        {
+          return floorConvexShapes_;
+        }
+
         /// Add a ConvexShape as a floor.
         ///
         /// The convex shape will be reverted using ConvexShape::reverse
         /// so that the normal points inside the floor object.
+        ///
+        /// As long as the floor shapes are not attached to a joint, the
+        /// transformation between the selected pair is computed by the
+        /// absolute Transformation, which does not read a second joint.
         void addFloor (const ConvexShape& t);
 
         /// Set the normal margin, i.e. the desired distance between matching
@@ -142,32 +160,149 @@ namespace hpp {
         /// Default to 0
         void setNormalMargin (const value_type& margin);
 
+        value_type normalMargin () const
+        {
+          return normalMargin_;
+        }
+
+        /// Set the selection margin.
+        ///
+        /// When positive, the pair selected at the previous configuration is
+        /// kept as long as its distance is less than the margin, without
+        /// looking for the closest pair. This avoids searching the pairs
+        /// along a path and switching between pairs at almost the same
+        /// distance during the resolution.
+        /// Default to 0, i.e. the closest pair is selected at each
+        /// configuration.
+        void setSelectionMargin (const value_type& margin);
+
+        value_type selectionMargin () const
+        {
+          return selectionMargin_;
+        }
+
+        /// Compute the distances between the shapes in single precision
+        /// when looking for the closest pair.
+        ///
+        /// Distances less than threshold are computed again in double
+        /// precision, so that the selected pair is the same as in double
+        /// precision unless two pairs are at almost the same distance.
+        /// The value and the jacobian are always computed in double
+        /// precision.
+        /// Default to infinity, i.e. the distances are computed in double
+        /// precision.
+        void setSinglePrecisionThreshold (const value_type& threshold);
+
+        value_type singlePrecisionThreshold () const
+        {
+          return singlePrecisionThreshold_;
+        }
+
+        /// Select the closest pair in single precision, except for the
+        /// distances less than tolerance.
+        ///
+        /// The pairs close to the contact, whose selection determines the
+        /// value, are still compared in double precision. The threshold
+        /// of setSinglePrecisionThreshold is used if it is smaller.
+        /// 0 restores the threshold of setSinglePrecisionThreshold.
+        virtual void accuracy (value_type tolerance);
+
+        /// Save the indices of the selected pair.
+        /// The state is empty if no pair was selected.
+        virtual void saveWarmStart (vector_t& state) const;
+
+        /// Select the saved pair again.
+        /// It is kept at the next configurations while its distance is less
+        /// than the selection margin, see setSelectionMargin.
+        virtual void restoreWarmStart (vectorIn_t state);
+
         /// Compute the contact points in the last configuration.
+        /// The points of a contact are all the points of the object shape.
         std::vector <ForceData> computeContactPoints (const value_type& normalMargin) const;
 
+        /// Compute the contact points in the last configuration.
+        /// \param[in,out] fds the contacts. It is resized to the number of
+        ///                contacts and the existing elements are reused, so
+        ///                that passing the same vector at each call does not
+        ///                allocate once it is large enough.
+        /// \param clip if true, the points of a contact are the vertices of
+        ///             the intersection of the object shape with the prism
+        ///             normal to the floor shape. Duplicated and aligned
+        ///             vertices are removed. Otherwise, they are all the
+        ///             points of the object shape.
+        /// \return the number of contacts.
+        std::size_t computeContactPoints (const value_type& normalMargin,
+            std::vector <ForceData>& fds, bool clip = true) const;
+
       private:
         void impl_compute (vectorOut_t result, ConfigurationIn_t argument) const;
 
         void impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const;
-        void computeInternalJacobian (ConfigurationIn_t argument) const;
 
+        /// Compute the forward kinematics and select the pair of shapes.
+        /// The selection is shared with ConvexShapeContactComplement.
+        void select (ConfigurationIn_t argument, int quantities) const;
+
+        /// Transformation between the selected pair.
+        /// \param complement whether the rows are those of the complement
+        ///        (y, z, rx) or those of this function (x, y, z, ry, rz).
+        const DifferentiableFunction& transformation (bool complement) const
+        {
+          if (staticFloors_)
+            return complement ? absoluteComplement_ : absoluteTransformation_;
+          return complement ? relativeComplement_ : relativeTransformation_;
+        }
+
+        /// Force the next evaluation to select the convex shapes again.
+        void invalidate ();
+
+        /// Set the single precision threshold of floorTree_ from
+        /// singlePrecisionThreshold_ and accuracy_.
+        void updateThreshold ();
+
+        /// Build the hierarchy of the floor shapes or update it to the
+        /// current transform of their joints.
+        void updateFloorTree () const;
         void selectConvexShapes () const;
+        /// Bind the transformations to a pair, unless it is selected.
+        void selectPair (size_type object, size_type floor) const;
         ContactType contactType (const ConvexShape& object,
             const ConvexShape& floor) const;
 
         DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
+        /// Transformation between the selected pair, relative to the joint
+        /// of the floor shape. Its mask selects the rows of the value, so
+        /// that it is written straight into the output.
         mutable RelativeTransformation relativeTransformation_;
+        /// Same as relativeTransformation_ when all the floor shapes belong
+        /// to the environment. The frame of the floor shape is then the
+        /// world frame placement computed once by ConvexShape.
+        mutable Transformation absoluteTransformation_;
+        /// Same as above with the rows of ConvexShapeContactComplement.
+        mutable RelativeTransformation relativeComplement_;
+        mutable Transformation absoluteComplement_;
+        /// Whether no floor shape is attached to a joint, in which case
+        /// absoluteTransformation_ is evaluated.
+        bool staticFloors_;
 
         typedef std::vector <ConvexShape> ConvexShapes_t;
         ConvexShapes_t objectConvexShapes_;
         ConvexShapes_t floorConvexShapes_;
+        mutable ConvexShapeTree floorTree_;
 
-        value_type normalMargin_;
+        value_type normalMargin_, selectionMargin_;
+        /// Threshold of setSinglePrecisionThreshold and tolerance of
+        /// accuracy.
+        value_type singlePrecisionThreshold_, accuracy_;
+        /// Indices of the selected pair, -1 if none.
+        mutable size_type selectedObject_, selectedFloor_;
 
         mutable bool isInside_;
         mutable ContactType contactType_;
-        mutable vector6_t result_;
-        mutable matrix_t jacobian_;
+        mutable std::size_t selectionVersion_;
+        /// Buffers of the polygon clipping.
+        mutable std::vector <vector3_t> polygon_, clipped_;
     };
 
     /** Complement to full transformation constraint of ConvexShapeContact
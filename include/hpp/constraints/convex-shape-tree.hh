@@ -0,0 +1,144 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_CONVEX_SHAPE_TREE_HH
+# define HPP_CONSTRAINTS_CONVEX_SHAPE_TREE_HH
+
+# include <limits>
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/convex-shape.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Hierarchy of bounding spheres of a set of convex shapes.
+    ///
+    /// Each node stores a sphere, in the world frame, that contains the
+    /// shapes of the node. The hierarchy is built by build() and the shapes
+    /// are split at the median of the largest extent of their centers. When
+    /// the shapes attached to joints move, update() recomputes the spheres
+    /// without changing the hierarchy.
+    ///
+    /// The distance between a point \f$ C \f$ and a shape \f$ f \f$ is the
+    /// one of ConvexShapeContact:
+    /// \f$ d^2 = d_{\parallel}^2 + d_{\perp}^2 \f$ if the projection of
+    /// \f$ C \f$ onto the plane of \f$ f \f$ is outside \f$ f \f$ and
+    /// \f$ d^2 = d_{\perp}^2 \f$ otherwise. It is not smaller than the
+    /// distance between \f$ C \f$ and any sphere containing \f$ f \f$, which
+    /// is used to prune the branches of the hierarchy.
+    class HPP_CONSTRAINTS_DLLAPI ConvexShapeTree
+    {
+      public:
+        typedef std::vector <ConvexShape> ConvexShapes_t;
+
+        ConvexShapeTree () : shapes_ (NULL),
+          threshold_ (std::numeric_limits <value_type>::infinity ()) {}
+
+        /// Build the hierarchy.
+        /// \param shapes the shapes, of dimension at least 3. They are not
+        ///        copied and must not be modified until the next call to
+        ///        build.
+        void build (const ConvexShapes_t& shapes);
+
+        /// Remove all the shapes.
+        void clear ();
+
+        bool empty () const
+        {
+          return nodes_.empty ();
+        }
+
+        /// Update the shapes attached to joints to the current transform of
+        /// their joint and the spheres that contain them.
+        /// \param version KinematicsCache::version of the robot the joints
+        ///        belong to. See ConvexShape::updateToCurrentTransform.
+        /// \return whether a shape moved.
+        bool update (std::size_t version);
+
+        /// Find the shape closest to a point.
+        /// \param point a point in the world frame,
+        /// \param[in,out] minDist a squared distance. Only the shapes closer
+        ///                than minDist are considered. It is set to the
+        ///                squared distance to the closest shape.
+        /// \param[out] inside whether the projection of point onto the
+        ///                    plane of the closest shape is inside it.
+        /// \return the index of the closest shape, or -1 if no shape is
+        ///         closer than minDist. If several shapes are at the same
+        ///         distance, the first one is returned.
+        size_type closest (const vector3_t& point, value_type& minDist,
+            bool& inside) const;
+
+        /// Radius of the sphere centered at ConvexShape::center that
+        /// contains a shape.
+        value_type radius (size_type shape) const
+        {
+          return radii_ [shape];
+        }
+
+        /// Compute the distances of closest in single precision.
+        /// \param threshold distances to the shapes less than threshold are
+        ///        computed again in double precision. See
+        ///        ConvexShape::distance (const vector3_t&, value_type) const.
+        ///        Default to infinity, i.e. double precision only.
+        void singlePrecisionThreshold (value_type threshold)
+        {
+          threshold_ = threshold;
+        }
+
+        /// Squared distance between a point and a shape.
+        /// \param[out] inside whether the projection of point onto the
+        ///                    plane of the shape is inside it.
+        /// \param threshold see singlePrecisionThreshold.
+        static value_type squaredDistance (const ConvexShape& shape,
+            const vector3_t& point, bool& inside,
+            value_type threshold = std::numeric_limits <value_type>::infinity ());
+
+      private:
+        struct Node {
+          vector3_t center;
+          value_type radius;
+          /// Index of the children in nodes_.
+          size_type left, right;
+          /// Index of the shape if the node is a leaf, -1 otherwise.
+          size_type shape;
+        };
+        typedef std::vector <Node> Nodes_t;
+
+        size_type build (std::vector <size_type>& shapes,
+            size_type begin, size_type end);
+
+        /// Compute the spheres from the leaves to the root.
+        void refit ();
+
+        const ConvexShapes_t* shapes_;
+        std::vector <value_type> radii_;
+        /// Indices of the shapes attached to a joint.
+        std::vector <size_type> moving_;
+        /// Nodes in depth first order. The children of a node are after it.
+        Nodes_t nodes_;
+        mutable std::vector <size_type> stack_;
+        value_type threshold_;
+    }; // class ConvexShapeTree
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_CONVEX_SHAPE_TREE_HH
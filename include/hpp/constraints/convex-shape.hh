@@ -17,6 +17,8 @@
 #ifndef HPP_CONSTRAINTS_CONVEX_SHAPE_HH
 # define HPP_CONSTRAINTS_CONVEX_SHAPE_HH
 
+# include <algorithm>
+# include <limits>
 # include <vector>
 
 # include <hpp/fcl/shape/geometric_shapes.h>
@@ -28,6 +30,7 @@
 
 # include <hpp/constraints/fwd.hh>
 # include <hpp/constraints/config.hh>
+# include <hpp/constraints/kinematics-batch.hh>
 
 namespace hpp {
   namespace constraints {
@@ -47,6 +50,197 @@ namespace hpp {
       else               B = A + c1 / c2 * v;
     }
 
+    /// \cond DEVEL
+    namespace details {
+      /// Edge data, packed as a structure of arrays: row \f$ i \f$
+      /// corresponds to edge \f$ i \f$ and each coordinate is contiguous,
+      /// so that the tests against all the edges are vectorized.
+      ///
+      /// The computations are templated on the scalar type so that they
+      /// can be done in single precision.
+      template <typename Scalar> struct ConvexShapeEdges
+      {
+        typedef Eigen::Matrix <Scalar, Eigen::Dynamic, 3> Matrix_t;
+        typedef Eigen::Array <Scalar, Eigen::Dynamic, 1> Values_t;
+        typedef Eigen::Matrix <Scalar, 3, 1> Vector_t;
+
+        /// Buffers of isInside and distance.
+        /// They are kept apart from the edges so that the edges of a
+        /// ConvexShapeGeometry can be shared.
+        struct Buffers
+        {
+          Values_t s, c1, w0, w1, d;
+          void resize (std::size_t n)
+          {
+            s.resize (n); c1.resize (n); w0.resize (n); w1.resize (n);
+            d.resize (n);
+          }
+        };
+
+        /// Points, next points, normals to the edges and unit vectors
+        /// along the edges.
+        Matrix_t pts, next, ns, us;
+        /// Lengths of the edges.
+        Values_t ls;
+
+        void resize (std::size_t n)
+        {
+          pts.resize (n, 3); next.resize (n, 3);
+          ns.resize (n, 3); us.resize (n, 3);
+          ls.resize (n);
+        }
+
+        std::size_t size () const
+        {
+          return ls.size ();
+        }
+
+        /// values[i] = v_i . (a - pts_i)
+        inline void edgeDot (const Matrix_t& v, const Vector_t& a,
+            Values_t& values) const {
+          values =
+              v.col (0).array () * (a[0] - pts.col (0).array ())
+            + v.col (1).array () * (a[1] - pts.col (1).array ())
+            + v.col (2).array () * (a[2] - pts.col (2).array ());
+        }
+
+        /// values[i] = || a - p_i ||
+        static inline void distanceTo (const Matrix_t& p, const Vector_t& a,
+            Values_t& values) {
+          values = (
+              (a[0] - p.col (0).array ()).square ()
+            + (a[1] - p.col (1).array ()).square ()
+            + (a[2] - p.col (2).array ()).square ()).sqrt ();
+        }
+
+        inline bool isInside (const Vector_t& a, Buffers& b) const {
+          edgeDot (ns, a, b.s);
+          return (b.s <= 0).all ();
+        }
+
+        inline Scalar distance (const Vector_t& a, Buffers& b) const {
+          const Scalar inf = std::numeric_limits<Scalar>::infinity();
+          // Signed distance to each edge: distance to the closest point of
+          // the edge, positive if a is outside of the half plane of the
+          // edge.
+          edgeDot (ns, a, b.s);
+          edgeDot (us, a, b.c1);
+          distanceTo (pts, a, b.w0);
+          distanceTo (next, a, b.w1);
+          b.d = (b.c1 <= 0).select (b.w0, (ls <= b.c1).select (b.w1, b.s.abs ()));
+          b.d = (b.s > 0).select (b.d, - b.d);
+          if ((b.d > 0).any ()) return (b.d > 0).select (b.d, inf).minCoeff ();
+          return b.d.maxCoeff ();
+        }
+
+        /// Apply M to the edges of other.
+        void transform (const ConvexShapeEdges& other, const Transform3f& M)
+        {
+          const matrix3_t& R = M.rotation ();
+          pts .noalias() = other.pts  * R.transpose ();
+          next.noalias() = other.next * R.transpose ();
+          ns  .noalias() = other.ns   * R.transpose ();
+          us  .noalias() = other.us   * R.transpose ();
+          pts .rowwise() += M.translation ().transpose ();
+          next.rowwise() += M.translation ().transpose ();
+          ls = other.ls;
+        }
+
+        /// Copy other in another precision.
+        template <typename Other> void cast
+          (const ConvexShapeEdges <Other>& other)
+        {
+          pts  = other.pts .template cast <Scalar> ();
+          next = other.next.template cast <Scalar> ();
+          ns   = other.ns  .template cast <Scalar> ();
+          us   = other.us  .template cast <Scalar> ();
+          ls   = other.ls  .template cast <Scalar> ();
+        }
+      }; // struct ConvexShapeEdges
+    } // namespace details
+    /// \endcond DEVEL
+
+    class ConvexShapeGeometry;
+    typedef boost::shared_ptr <const ConvexShapeGeometry>
+      ConvexShapeGeometryPtr_t;
+
+    /// Geometry of a convex shape in the frame of its joint.
+    ///
+    /// It does not depend on the joint nor on the configuration, so that the
+    /// shapes with the same points share one instance: the normals, the edges
+    /// and the enclosing radius are computed once for all the copies of a
+    /// shape and for all the shapes with the same points (the treads of a
+    /// staircase, the boards of a shelf...).
+    class HPP_CONSTRAINTS_DLLAPI ConvexShapeGeometry
+    {
+      public:
+        typedef details::ConvexShapeEdges <value_type> Edges_t;
+
+        /// Get the geometry of a sequence of points.
+        /// It is computed if no instance with the same points exists.
+        /// \param pts see ConvexShape::ConvexShape.
+        static ConvexShapeGeometryPtr_t get
+          (const std::vector <vector3_t>& pts);
+
+        /// Geometry of the points in reverse order.
+        ConvexShapeGeometryPtr_t reversed () const;
+
+        /// Radius of the sphere centered at C_ that contains the points.
+        value_type radius () const
+        {
+          return radius_;
+        }
+
+        /// The edges of the shape, packed for vectorized queries.
+        const Edges_t& edges () const
+        {
+          return edges_;
+        }
+
+        /// The points in the joint frame.
+        const std::vector <vector3_t> Pts_;
+        size_t shapeDimension_;
+        /// the center in the joint frame.
+        vector3_t C_;
+        /// the normal to the shape in the joint frame.
+        vector3_t N_;
+        /// Ns_ and Us_ are unit vector, in the plane containing the shape,
+        /// expressed in the joint frame.
+        /// Ns_[i] is normal to edge i, pointing inside.
+        /// Ns_[i] is a vector director of edge i.
+        std::vector <vector3_t> Ns_, Us_;
+        vector_t Ls_;
+        Transform3f MinJoint_;
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      private:
+        ConvexShapeGeometry (const std::vector <vector3_t>& pts);
+
+        /// Geometry whose quantities were computed by init on another
+        /// instance and saved by FunctionArchive.
+        ConvexShapeGeometry (const std::vector <vector3_t>& pts,
+            const vector3_t& C, const vector3_t& N,
+            const std::vector <vector3_t>& Ns,
+            const std::vector <vector3_t>& Us, const vector_t& Ls,
+            value_type radius);
+
+        /// Share a new geometry, unless a geometry with the same points
+        /// exists.
+        static ConvexShapeGeometryPtr_t insert
+          (const ConvexShapeGeometryPtr_t& geometry);
+
+        void init ();
+        /// Compute the packed edges and MinJoint_.
+        void finish ();
+        void pack ();
+
+        value_type radius_;
+        Edges_t edges_;
+
+        friend class FunctionArchive;
+    }; // class ConvexShapeGeometry
+
     class HPP_CONSTRAINTS_DLLAPI ConvexShape
     {
       public:
@@ -59,13 +253,14 @@ namespace hpp {
         ///       The normal to the segment in the plane are directed outward.
         ///             (pts[i+1] - pts[i]).cross (normalToConvexShape)
         ConvexShape (const std::vector <vector3_t>& pts, JointPtr_t joint = JointPtr_t()):
-          Pts_ (pts), joint_ (joint)
+          geometry_ (ConvexShapeGeometry::get (pts)), joint_ (joint)
         {
           init ();
         }
 
         ConvexShape (const fcl::TriangleP& t, const JointPtr_t& joint = JointPtr_t()):
-          Pts_ (triangleToPoints (t)), joint_ (joint)
+          geometry_ (ConvexShapeGeometry::get (triangleToPoints (t))),
+          joint_ (joint)
         {
           init ();
         }
@@ -74,26 +269,116 @@ namespace hpp {
         /// Triangle constructor.
         ConvexShape (const vector3_t& p0, const vector3_t& p1,
             const vector3_t& p2, const JointPtr_t& joint = JointPtr_t()):
-          Pts_ (points(p0,p1,p2)), joint_ (joint)
+          geometry_ (ConvexShapeGeometry::get (points(p0,p1,p2))),
+          joint_ (joint)
         {
           init ();
         }
 
-        // Copy constructor
-        ConvexShape (const ConvexShape& t) :
-          Pts_ (t.Pts_), joint_ (t.joint_)
+        /// Instance of a shared geometry attached to a joint.
+        ConvexShape (const ConvexShapeGeometryPtr_t& geometry,
+            const JointPtr_t& joint = JointPtr_t()):
+          geometry_ (geometry), joint_ (joint)
         {
           init ();
         }
 
+        /// Copy constructor.
+        /// The geometry is shared and the quantities in the world frame are
+        /// copied instead of being computed again.
+        ConvexShape (const ConvexShape& t) :
+          geometry_ (t.geometry_), joint_ (t.joint_),
+          n_ (t.n_), c_ (t.c_), world_ (t.world_),
+          worldFloatValid_ (false), version_ (t.version_), M_ (t.M_)
+        {
+          buffers_.resize (geometry_->edges ().size ());
+        }
+
+        /// Exchange the content of two shapes without allocating.
+        /// Use it to move a shape into a container:
+        /// \code
+        /// shapes.push_back (ConvexShape (geometry)); shapes.back ().swap (s);
+        /// \endcode
+        void swap (ConvexShape& other)
+        {
+          geometry_.swap (other.geometry_);
+          joint_.swap (other.joint_);
+          std::swap (n_, other.n_);
+          std::swap (c_, other.c_);
+          swapEdges (world_, other.world_);
+          swapEdges (worldFloat_, other.worldFloat_);
+          std::swap (worldFloatValid_, other.worldFloatValid_);
+          std::swap (version_, other.version_);
+          std::swap (M_, other.M_);
+          buffers_.s.swap (other.buffers_.s);
+          buffers_.c1.swap (other.buffers_.c1);
+          buffers_.w0.swap (other.buffers_.w0);
+          buffers_.w1.swap (other.buffers_.w1);
+          buffers_.d.swap (other.buffers_.d);
+          floatBuffers_.s.swap (other.floatBuffers_.s);
+          floatBuffers_.c1.swap (other.floatBuffers_.c1);
+          floatBuffers_.w0.swap (other.floatBuffers_.w0);
+          floatBuffers_.w1.swap (other.floatBuffers_.w1);
+          floatBuffers_.d.swap (other.floatBuffers_.d);
+        }
+
+        /// Reverse the order of the points.
+        /// The reversed geometry is shared as well.
         void reverse () {
-          std::reverse (Pts_.begin (), Pts_.end());
+          geometry_ = geometry_->reversed ();
           init ();
         }
 
+        /// The geometry in the joint frame. It is constant.
+        const ConvexShapeGeometry& geometry () const
+        {
+          return *geometry_;
+        }
+
+        const ConvexShapeGeometryPtr_t& geometryPtr () const
+        {
+          return geometry_;
+        }
+
+        /// Compute the center, the normal and the edges in the world frame
+        /// from the current transform of the joint.
         void updateToCurrentTransform () const
         {
-          if (joint_ != NULL) recompute (joint_->currentTransformation());
+          if (joint_ != NULL) {
+            recompute (joint_->currentTransformation());
+            version_ = std::numeric_limits <std::size_t>::max ();
+          }
+        }
+
+        /// Same as updateToCurrentTransform() but does nothing if the
+        /// forward kinematics did not change since the previous call.
+        /// \param version KinematicsCache::version of the robot the joint
+        ///        belongs to.
+        ///
+        /// Shapes that are not attached to a joint are computed in the
+        /// world frame once for all.
+        void updateToCurrentTransform (std::size_t version) const
+        {
+          if (joint_ == NULL || version == version_) return;
+          recompute (joint_->currentTransformation());
+          version_ = version;
+        }
+
+        /// Same as updateToCurrentTransform() but reads the placement of
+        /// the joint at configuration k of a batch of forward kinematics.
+        /// The joint must have been registered with addKinematics.
+        void updateToKinematics (const KinematicsBatch& batch, size_type k)
+          const
+        {
+          if (joint_ == NULL) return;
+          recompute (batch.placements (joint_).get (k));
+          version_ = std::numeric_limits <std::size_t>::max ();
+        }
+
+        /// Register the joint of the shape in a batch of forward kinematics.
+        void addKinematics (KinematicsBatch& batch) const
+        {
+          batch.addJoint (joint_);
         }
 
         /// Intersection with a line defined by a point and a vector.
@@ -103,124 +388,109 @@ namespace hpp {
           return A + u * (n_.dot(c_ - A)) / n_.dot (u);
         }
         inline vector3_t intersectionLocal (const vector3_t& A, const vector3_t& u) const {
-          assert (std::abs (N_.dot (u)) > 1e-8);
-          return A + u * (N_.dot(C_ - A)) / N_.dot (u);
+          const ConvexShapeGeometry& g = *geometry_;
+          assert (std::abs (g.N_.dot (u)) > 1e-8);
+          return A + u * (g.N_.dot(g.C_ - A)) / g.N_.dot (u);
         }
 
         /// Check whether the intersection of the line defined by A and u
         /// onto the plane containing the triangle is inside the triangle.
         inline bool isInside (const vector3_t& A, const vector3_t& u) const {
-          assert (shapeDimension_ > 2);
+          assert (geometry_->shapeDimension_ > 2);
           return isInside (intersection (A, u));
         }
+        /// updateToCurrentTransform() should be called before.
         inline bool isInside (const vector3_t& Ap) const {
-          assert (shapeDimension_ > 2);
-          if (joint_ == NULL) return isInsideLocal (Ap);
-          const Transform3f& M = joint_->currentTransformation ();
-          vector3_t Ap_loc = M.actInv(Ap);
-          return isInsideLocal (Ap_loc);
+          assert (geometry_->shapeDimension_ > 2);
+          return world_.isInside (Ap, buffers_);
         }
         /// As isInside but consider A as expressed in joint frame.
         inline bool isInsideLocal (const vector3_t& Ap) const {
-          assert (shapeDimension_ > 2);
-          for (std::size_t i = 0; i < shapeDimension_; ++i) {
-            if (Ns_[i].dot (Ap-Pts_[i]) > 0) return false;
-          }
-          return true;
+          assert (geometry_->shapeDimension_ > 2);
+          return geometry_->edges ().isInside (Ap, buffers_);
         }
 
         /// Return the shortest distance from a point to the shape
         /// A negative value means the point is inside the shape
         /// \param A a point already in the plane containing the convex shape,
         ///        and expressed in the global frame.
-        inline value_type distance (vector3_t a) const {
-          assert (shapeDimension_ > 1);
-          if (joint_!=NULL) a = joint_->currentTransformation ().actInv(a);
-          const value_type inf = std::numeric_limits<value_type>::infinity();
-          value_type minPosDist = inf, maxNegDist = - inf;
-          bool outside = false;
-          for (std::size_t i = 0; i < shapeDimension_; ++i) {
-            value_type d = dist (a - Pts_[i], Ls_[i], Us_[i], Ns_[i]);
-            if (d > 0) {
-              outside = true;
-              if (d < minPosDist) minPosDist = d;
-            }
-            if (d <= 0 && d > maxNegDist) maxNegDist = d;
+        /// updateToCurrentTransform() should be called before.
+        inline value_type distance (const vector3_t& a) const {
+          assert (geometry_->shapeDimension_ > 1);
+          return world_.distance (a, buffers_);
+        }
+
+        /// Same as distance(const vector3_t&) const but evaluated in single
+        /// precision first.
+        /// \param threshold the distance is computed again in double
+        ///        precision if its absolute value is less than threshold.
+        ///
+        /// Far from the shape, the single precision error does not matter
+        /// and the edges are processed twice as fast.
+        inline value_type distance (const vector3_t& a, value_type threshold)
+          const {
+          assert (geometry_->shapeDimension_ > 1);
+          if (!worldFloatValid_) {
+            worldFloat_.cast (world_);
+            floatBuffers_.resize (world_.size ());
+            worldFloatValid_ = true;
           }
-          if (outside) return minPosDist;
-          return maxNegDist;
+          const value_type d = worldFloat_.distance
+            (details::ConvexShapeEdges <float>::Vector_t (a.cast <float> ()), floatBuffers_);
+          if (std::abs (d) >= threshold) return d;
+          return world_.distance (a, buffers_);
+        }
+
+        /// The edges in the world frame.
+        /// updateToCurrentTransform() should be called before.
+        inline const details::ConvexShapeEdges <value_type>& worldEdges ()
+          const {
+          return world_;
         }
 
         /// Return the X axis of the plane in the joint frame
         inline const vector3_t& planeXaxis () const {
-          assert (shapeDimension_ > 2);
-          return Ns_[0];
+          assert (geometry_->shapeDimension_ > 2);
+          return geometry_->Ns_[0];
         }
         /// Return the Y axis of the plane in the joint frame
         /// The Y axis is aligned with \f$ Pts_[1] - Pts_[0] \f$
         inline const vector3_t& planeYaxis () const {
-          assert (shapeDimension_ > 2);
-          return Us_[0];
+          assert (geometry_->shapeDimension_ > 2);
+          return geometry_->Us_[0];
         }
 
         /// Return the normal in world frame.
         inline const vector3_t& normal () const {
-          assert (shapeDimension_ > 2);
+          assert (geometry_->shapeDimension_ > 2);
           return n_;
         }
         /// Return the center in world frame.
         inline const vector3_t& center () const { return c_; }
 
         /// Transform of the shape in the joint frame
-        inline const Transform3f& positionInJoint () const { return MinJoint_; }
+        inline const Transform3f& positionInJoint () const
+        {
+          return geometry_->MinJoint_;
+        }
         // \param yaxis vector in world frame to which we should try to align
         inline void computeAlignedPosition (vector3_t yaxis) const {
-          assert (shapeDimension_ > 2);
+          const ConvexShapeGeometry& g = *geometry_;
+          assert (g.shapeDimension_ > 2);
           // Project vector onto the plane
           if (joint_!=NULL) yaxis = joint_->currentTransformation ().actInv(yaxis);
-          vector3_t yproj = yaxis - yaxis.dot (N_) * N_;
-          if (yproj.isZero ()) M_ = MinJoint_;
+          vector3_t yproj = yaxis - yaxis.dot (g.N_) * g.N_;
+          if (yproj.isZero ()) M_ = g.MinJoint_;
           else {
-            M_.translation() = C_;
-            M_.rotation().col(0) = N_;
+            M_.translation() = g.C_;
+            M_.rotation().col(0) = g.N_;
             M_.rotation().col(1) = yaxis;
-            M_.rotation().col(2) = N_.cross (yaxis);
+            M_.rotation().col(2) = g.N_.cross (yaxis);
           }
         }
         inline const Transform3f& alignedPositionInJoint () const { return M_; }
 
-        /// The points in the joint frame. It is constant.
-        std::vector <vector3_t> Pts_;
-        size_t shapeDimension_;
-        /// the center in the joint frame. It is constant.
-        vector3_t C_;
-        /// the normal to the shape in the joint frame. It is constant.
-        vector3_t N_;
-        /// Ns_ and Us_ are unit vector, in the plane containing the shape,
-        /// expressed in the joint frame.
-        /// Ns_[i] is normal to edge i, pointing inside.
-        /// Ns_[i] is a vector director of edge i.
-        std::vector <vector3_t> Ns_, Us_;
-        vector_t Ls_;
-        Transform3f MinJoint_;
-        JointPtr_t joint_;
-
       private:
-        /// Return the distance between the point A and the segment
-        /// [P, c2*v] oriented by u.
-        /// w = PA.
-        inline value_type dist (const vector3_t& w, const value_type& c2, const vector3_t& v, const vector3_t& u) const {
-          value_type c1;
-          c1 = v.dot (w);
-          if (c1 <= 0)
-            return (u.dot (w) > 0)?(w.norm()):(- w.norm());
-          if (c2 <= c1)
-            // TODO: (w - c2 * v).norm() == sqrt((u.dot(w)**2 + (c1 - c2)**2)
-            // second should be cheaper.
-            return (u.dot (w) > 0)?((w-c2*v).norm()):(-(w-c2*v).norm());
-          return u.dot (w);
-        }
-
         static std::vector <vector3_t> triangleToPoints (const fcl::TriangleP& t) {
           // TODO
           // return points (t.a, t.b, t.c);
@@ -237,81 +507,51 @@ namespace hpp {
           return ret;
         }
 
-        void init ()
+        template <typename Scalar> static void swapEdges
+          (details::ConvexShapeEdges <Scalar>& a,
+           details::ConvexShapeEdges <Scalar>& b)
         {
-          shapeDimension_ = Pts_.size ();
-
-          switch (shapeDimension_) {
-            case 0:
-              throw std::logic_error ("Cannot represent an empty shape.");
-              break;
-            case 1:
-              C_ = Pts_[0];
-              // The transformation will be (N_, Ns_[0], Us_[0])
-              // Fill vectors so as to be consistent
-              N_ = vector3_t(1,0,0);
-              Ns_.push_back (vector3_t(0,1,0));
-              Us_.push_back (vector3_t(0,0,1));
-              break;
-            case 2:
-              Ls_ = vector_t(1);
-              C_ = (Pts_[0] + Pts_[1])/2;
-              // The transformation will be (N_, Ns_[0], Us_[0])
-              // Fill vectors so as to be consistent
-              Us_.push_back (Pts_[1] - Pts_[0]);
-              Ls_[0] = Us_[0].norm();
-              Us_[0].normalize ();
-              if (Us_[0][0] != 0) N_ = vector3_t(-Us_[0][1],Us_[0][0],0);
-              else                N_ = vector3_t(0,-Us_[0][2],Us_[0][1]);
-              N_.normalize ();
-              Ns_.push_back (Us_[0].cross (N_));
-              Ns_[0].normalize (); // Should be unnecessary
-              break;
-            default:
-              Ls_ = vector_t(shapeDimension_);
-              C_.setZero ();
-              for (std::size_t i = 0; i < shapeDimension_; ++i)
-                C_ += Pts_[i];
-              // TODO This is very ugly. Why Eigen does not have the operator/=(int) ...
-              C_ /= (value_type)Pts_.size();
-              N_ = (Pts_[1] - Pts_[0]).cross (Pts_[2] - Pts_[1]);
-              assert (!N_.isZero ());
-              N_.normalize ();
-
-              Us_.resize (Pts_.size());
-              Ns_.resize (Pts_.size());
-              for (std::size_t i = 0; i < shapeDimension_; ++i) {
-                Us_[i] = Pts_[(i+1)%shapeDimension_] - Pts_[i];
-                Ls_[i] = Us_[i].norm();
-                Us_[i].normalize ();
-                Ns_[i] = Us_[i].cross (N_);
-                Ns_[i].normalize ();
-              }
-              for (std::size_t i = 0; i < shapeDimension_; ++i) {
-                assert (Us_[(i+1)%shapeDimension_].dot (Ns_[i]) < 0 &&
-                    "The sequence does not define a convex surface");
-              }
-              break;
-          }
-
-          MinJoint_.translation() = C_;
-          MinJoint_.rotation().col(0) = N_;
-          MinJoint_.rotation().col(1) = Ns_[0];
-          MinJoint_.rotation().col(2) = Us_[0];
+          a.pts.swap (b.pts); a.next.swap (b.next);
+          a.ns.swap (b.ns); a.us.swap (b.us); a.ls.swap (b.ls);
+        }
 
+        void init ()
+        {
+          const std::size_t n = geometry_->edges ().size ();
+          world_.resize (n);
+          buffers_.resize (n);
           if (joint_ == NULL) recompute (Transform3f::Identity());
           else                recompute (joint_->currentTransformation ());
+          version_ = std::numeric_limits <std::size_t>::max ();
         }
 
         void recompute (const Transform3f& M) const
         {
-          c_ = M.act (C_);
-          n_ = M.rotation () * N_;
+          const ConvexShapeGeometry& g = *geometry_;
+          c_ = M.act (g.C_);
+          n_ = M.rotation () * g.N_;
+          world_.transform (g.edges (), M);
+          worldFloatValid_ = false;
         }
 
+        ConvexShapeGeometryPtr_t geometry_;
+
+      public:
+        JointPtr_t joint_;
+
+      private:
         /// The positions and vectors in the global frame
         mutable vector3_t n_, c_;
+        mutable details::ConvexShapeEdges <value_type> world_;
+        /// Single precision copy of world_, computed when needed.
+        mutable details::ConvexShapeEdges <float> worldFloat_;
+        mutable bool worldFloatValid_;
+        /// Version of the forward kinematics of the world frame quantities.
+        mutable std::size_t version_;
         mutable Transform3f M_;
+        /// Buffers of the queries.
+        mutable details::ConvexShapeEdges <value_type>::Buffers buffers_;
+        mutable details::ConvexShapeEdges <float>::Buffers floatBuffers_;
     };
   } // namespace constraints
 } // namespace hpp
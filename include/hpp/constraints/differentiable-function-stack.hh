@@ -19,8 +19,14 @@
 #ifndef HPP_CONSTRAINTS_DIFFERENTIABLE_FUNCTION_STACK_HH
 # define HPP_CONSTRAINTS_DIFFERENTIABLE_FUNCTION_STACK_HH
 
+# include <cmath>
+
+# include <Eigen/SparseCore>
+
 # include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/active-subspace.hh>
 # include <hpp/constraints/differentiable-function.hh>
+# include <hpp/constraints/executor.hh>
 
 namespace hpp {
   namespace constraints {
@@ -35,6 +41,12 @@ namespace hpp {
     {
       public:
         typedef std::vector<DifferentiableFunctionPtr_t> Functions_t;
+        /// Identifier of a function in the stack.
+        typedef std::size_t Handle_t;
+        typedef Eigen::SparseMatrix <value_type, Eigen::RowMajor>
+          SparseMatrix_t;
+
+        using DifferentiableFunction::jacobian;
 
         /// Return a shared pointer to a new instance
         ///
@@ -56,38 +68,24 @@ namespace hpp {
           return functions_;
         }
 
-        void add (const DifferentiableFunctionPtr_t& func)
-        {
-          if (functions_.empty()) {
-            inputSize_           = func->inputSize();
-            inputDerivativeSize_ = func->inputDerivativeSize();
-          } else {
-            assert (inputSize_           == func->inputSize());
-            assert (inputDerivativeSize_ == func->inputDerivativeSize());
-          }
-          functions_.push_back(func);
-          outputSize_           += func->outputSize();
-          outputDerivativeSize_ += func->outputDerivativeSize();
-        }
+        /// Add a function to the stack.
+        /// \return a handle to the function, that remains valid until the
+        ///         function is erased.
+        ///
+        /// \note the active derivative columns of the stack are computed
+        ///       when the functions are added. They are not updated if the
+        ///       columns of a function change afterwards.
+        Handle_t add (const DifferentiableFunctionPtr_t& func);
 
         /// Remove a function from the stack.
         /// \return True if the function was removed, False otherwise.
         ///
         /// \note The function stops after having removed one element. If there
         /// are duplicates, the function should be called several times.
-        bool erase (const DifferentiableFunctionPtr_t& func)
-        {
-          for (Functions_t::iterator _func = functions_.begin();
-              _func != functions_.end(); ++_func) {
-            if (func == *_func) {
-              functions_.erase(_func);
-              outputSize_           -= func->outputSize();
-              outputDerivativeSize_ -= func->outputDerivativeSize();
-              return true;
-            }
-          }
-          return false;
-        }
+        bool erase (const DifferentiableFunctionPtr_t& func);
+
+        /// Remove the function of a handle from the stack.
+        void erase (Handle_t handle);
 
         /// The output columns selection of other is not taken into account.
         void merge (const DifferentiableFunctionStackPtr_t& other)
@@ -98,37 +96,744 @@ namespace hpp {
             add (*_f);
         }
 
+        /// Activate or deactivate a function.
+        ///
+        /// The rows of an inactive function remain in the output and are
+        /// set to zero, so that the sizes of the stack do not change.
+        void active (const Handle_t& handle, bool flag)
+        {
+          active_ [index (handle)] = flag;
+          if (flatten_) flatten (true);
+          if (compiled_) compile (true);
+        }
+
+        /// Whether a function is active.
+        bool active (const Handle_t& handle) const
+        {
+          return active_ [index (handle)];
+        }
+
+        /// Index in functions() of the function of a handle.
+        std::size_t index (const Handle_t& handle) const
+        {
+          assert (handle < indices_.size ());
+          assert (indices_ [handle] < functions_.size ());
+          return indices_ [handle];
+        }
+
+        /// Handle of function i of functions().
+        Handle_t handle (std::size_t i) const
+        {
+          assert (i < handles_.size ());
+          return handles_ [i];
+        }
+
+        /// First row of function i of functions() in the value.
+        size_type row (std::size_t i) const
+        {
+          return rows_ [i];
+        }
+
+        /// First row of function i of functions() in the jacobian.
+        size_type derivativeRow (std::size_t i) const
+        {
+          return derivativeRows_ [i];
+        }
+
+        /// \}
+
+        /// \name Independent blocks
+        /// \{
+
+        /// Functions of the stack that share no velocity column with the
+        /// functions of the other blocks.
+        ///
+        /// The functions of several robots in a composite device, for
+        /// instance, form one block per robot: the jacobian of the stack is
+        /// block diagonal up to a permutation of its rows and columns.
+        ///
+        /// Once blockKinematics is called, the forward kinematics of a block
+        /// is restricted to its joints, see KinematicsCache::update, and
+        /// blockJacobians evaluates the blocks in parallel.
+        struct Block
+        {
+          /// Indices in functions(), in increasing order.
+          std::vector <std::size_t> functions;
+          /// Velocity columns of the block, the union of the active
+          /// derivative columns of its functions.
+          ActiveSubspace columns;
+          /// Sum of the output derivative sizes of the functions.
+          size_type derivativeSize;
+          /// Joints of the columns and their ancestors, a
+          /// KinematicsCache::Joints_t. Empty if blockKinematics is not
+          /// called.
+          std::vector <bool> joints;
+          /// Whether the functions of the block are thread safe.
+          bool threadSafe;
+
+          Block (size_type size) : columns (size),
+            derivativeSize (0), threadSafe (true) {}
+        };
+        typedef std::vector <Block> Blocks_t;
+
+        /// Independent blocks, ordered by their first function.
+        /// They are computed when functions are added or erased.
+        /// \note a function without active column forms a block alone.
+        const Blocks_t& blocks () const
+        {
+          return blocks_;
+        }
+
+        /// Compute the jacobian of a block.
+        /// \retval jacobian matrix of size blocks()[b].derivativeSize x
+        ///         blocks()[b].columns.dimension(). Its rows are those of
+        ///         the functions of the block, in the order of the stack.
+        ///         The rows of the inactive functions are set to zero.
+        ///
+        /// If blockKinematics was called, the forward kinematics of the
+        /// joints of the block is computed first.
+        void blockJacobian (std::size_t b, matrixOut_t jacobian,
+            vectorIn_t argument) const;
+
+        /// Restrict the forward kinematics of each block to its joints.
+        /// \param robot the robot the functions are bound to. NULL disables
+        ///        the restriction.
+        void blockKinematics (const DevicePtr_t& robot);
+
+        /// Compute the jacobians of all the blocks.
+        /// \retval jacobians the jacobian of each block, as blockJacobian.
+        ///
+        /// If parallel evaluation is enabled, see parallel, the blocks of
+        /// thread safe functions are evaluated concurrently, each with the
+        /// Workspace of its thread and the forward kinematics of its joints
+        /// only. The other blocks are evaluated by the calling thread.
+        void blockJacobians (std::vector <matrix_t>& jacobians,
+            vectorIn_t argument) const;
+
         /// \}
 
+        /// Evaluate the functions of the stack in parallel.
+        ///
+        /// \param robot the robot the functions are bound to. One Workspace
+        ///        of this robot is created per thread.
+        /// \param nbThreads number of threads. 0 disables parallel
+        ///        evaluation.
+        /// \param minTaskCost consecutive functions are grouped in tasks of
+        ///        at least this cost, in order not to spawn one task per
+        ///        cheap function. See DifferentiableFunction::evaluationCost.
+        ///
+        /// Functions that are not thread safe are evaluated sequentially by
+        /// the calling thread.
+        /// The functions run in parallel only if the library is compiled
+        /// with OpenMP.
+        void parallel (const DevicePtr_t& robot, std::size_t nbThreads,
+            value_type minTaskCost = 5);
+
+        /// Evaluate the functions of the stack with an executor.
+        ///
+        /// The active functions are submitted to the executor, which
+        /// evaluates the most expensive ones first, and the stack waits for
+        /// the results. Evaluations submitted to the executor before the
+        /// stack is evaluated are run in the same batch.
+        ///
+        /// \param executor NULL disables the evaluation with an executor.
+        ///        Otherwise, it takes precedence over parallel.
+        void executor (const ExecutorPtr_t& executor)
+        {
+          executor_ = executor;
+        }
+
+        /// Evaluate the functions of the nested stacks directly.
+        ///
+        /// The functions of the stacks added to this stack, recursively,
+        /// are listed with their rows in the value and in the jacobian, so
+        /// that they are evaluated in a single loop instead of through each
+        /// nested stack. Nested stacks evaluated in parallel, by an executor
+        /// or with a cache are evaluated as one function.
+        ///
+        /// A function that appears several times in the list, in several
+        /// nested stacks for instance, is evaluated once and its rows are
+        /// copied to its other offsets. This is the case of the functions
+        /// shared by a FunctionRegistry.
+        ///
+        /// \warning the list is built when this method is called and when
+        ///          functions are added to or erased from this stack. Call
+        ///          it again after modifying a nested stack.
+        void flatten (bool flag);
+
+        /// Evaluate the functions grouped by concrete type.
+        ///
+        /// The functions of the stack, and of the nested stacks as in
+        /// flatten, are sorted in one bucket per type, in the order of the
+        /// stack within a bucket. The functions of the types listed below
+        /// are evaluated in a loop that calls their implementation
+        /// directly instead of through the virtual table:
+        /// \li the six GenericTransformation,
+        /// \li RelativeCom,
+        /// \li ConfigurationConstraint.
+        /// The functions of the other types form the last bucket, evaluated
+        /// with virtual calls. The rows of each function are written at
+        /// their offsets in the stack. As in flatten, a function is
+        /// evaluated once. It takes precedence over flatten.
+        ///
+        /// \warning as for flatten, call it again after modifying a nested
+        ///          stack.
+        void compile (bool flag);
+
+        /// Reuse the rows of the functions that do not depend on the
+        /// configuration variables modified since the previous evaluation.
+        ///
+        /// \param robot the robot the functions are bound to. The variables
+        ///        a function depends on are the configuration variables of
+        ///        the joints of its active derivative columns.
+        ///        NULL disables the cache.
+        ///
+        /// Values and jacobians are cached separately. Rows are not reused
+        /// while parallel evaluation is enabled.
+        /// \warning call invalidateRows when a function is modified, for
+        ///          instance when its reference changes.
+        void cacheRows (const DevicePtr_t& robot);
+
+        /// Discard the cached rows.
+        void invalidateRows ()
+        {
+          valueCache_.valid.clear ();
+          jacobianCache_.valid.clear ();
+        }
+
+        virtual bool threadSafe () const
+        {
+          for (Functions_t::const_iterator _f = functions_.begin();
+              _f != functions_.end(); ++_f)
+            if (!(*_f)->threadSafe ()) return false;
+          return true;
+        }
+
+        /// Rows of each function follow the pattern of the function.
+        virtual void jacobianPattern (ArrayXXb& pattern) const
+        {
+          pattern.setConstant (outputDerivativeSize_, inputDerivativeSize_,
+              false);
+          ArrayXXb p;
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            functions_[i]->jacobianPattern (p);
+            pattern.middleRows (derivativeRows_[i], p.rows ()) = p;
+          }
+        }
+
+        /// Switch the functions of the stack to their approximate model.
+        /// The cached rows are discarded.
+        virtual void approximate (bool approximate)
+        {
+          for (Functions_t::const_iterator _f = functions_.begin();
+              _f != functions_.end(); ++_f)
+            (*_f)->approximate (approximate);
+          computeSatisfactionOrder ();
+          invalidateRows ();
+        }
+
+        /// Set the accuracy of the functions of the stack.
+        /// The cached rows are discarded.
+        virtual void accuracy (value_type tolerance)
+        {
+          for (Functions_t::const_iterator _f = functions_.begin();
+              _f != functions_.end(); ++_f)
+            (*_f)->accuracy (tolerance);
+          invalidateRows ();
+        }
+
+        /// Save the states of the functions of the stack.
+        /// The state of each function is preceded by its size.
+        virtual void saveWarmStart (vector_t& state) const;
+
+        /// Restore the states of the functions of the stack.
+        /// The cached rows are discarded.
+        virtual void restoreWarmStart (vectorIn_t state);
+
+        /// Order in which isSatisfied tests the functions: the cheapest
+        /// first, by increasing evaluationCost.
+        ///
+        /// The order is computed when functions are added or erased and when
+        /// the model of the functions changes, see approximate.
+        const std::vector <std::size_t>& satisfactionOrder () const
+        {
+          return satisfactionOrder_;
+        }
+
+        /// Count the buffers and the row caches of the stack and the memory
+        /// of its functions.
+        virtual MemoryUsage memoryUsage () const;
+
+        /// The norm of the stack is the Euclidean norm of the norms of its
+        /// active functions, so that their constants add up in quadrature.
+        virtual value_type lipschitzConstant () const
+        {
+          value_type squared = 0;
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            if (!active_[i]) continue;
+            const value_type L = functions_[i]->lipschitzConstant ();
+            squared += L * L;
+          }
+          return std::sqrt (squared);
+        }
+
+        virtual value_type evaluationCost () const
+        {
+          value_type cost = 0;
+          for (Functions_t::const_iterator _f = functions_.begin();
+              _f != functions_.end(); ++_f)
+            cost += (*_f)->evaluationCost ();
+          return cost;
+        }
+
+# ifdef HPP_CONSTRAINTS_WITH_STATISTICS
+        /// Reset the statistics of the stack and of its functions.
+        virtual void resetStatistics ();
+
+        /// Write the statistics of each function, one per line, sorted by
+        /// decreasing evaluation time.
+        std::ostream& printStatistics (std::ostream& os) const;
+
+        /// Order the functions tested by isSatisfied by their mean value
+        /// evaluation time.
+        ///
+        /// The cost of the functions that were not evaluated yet is their
+        /// evaluationCost scaled by the mean time per unit of cost of the
+        /// other functions.
+        void sortByMeasuredCost ();
+# endif // HPP_CONSTRAINTS_WITH_STATISTICS
+
+        /// Compute the jacobian in a sparse matrix.
+        ///
+        /// The structure of the matrix contains the active derivative columns
+        /// of each function. It is built when the matrix is not the one of
+        /// the previous call or when functions were added or erased since.
+        /// Otherwise, only the values are updated, so the same matrix should
+        /// be passed at each call. Each function writes the jacobian of its
+        /// active columns directly in the values of the matrix: the dense
+        /// jacobian of the stack is never formed.
+        void jacobian (SparseMatrix_t& jacobian, vectorIn_t argument) const;
+
         /// Constructor
         ///
         /// \param name the name of the constraints,
         DifferentiableFunctionStack (const std::string& name)
-          : DifferentiableFunction (0, 0, 0, 0, name) {}
+          : DifferentiableFunction (0, 0, 0, 0, name), structureVersion_ (0),
+          sparseVersion_ (0), sparseInner_ (NULL), minTaskCost_ (0),
+          flatten_ (false), compiled_ (false) {}
 
       protected:
+        /// Test the active functions in satisfactionOrder and stop as soon
+        /// as the norm of the values computed so far exceeds the threshold.
+        bool impl_isSatisfied (vectorIn_t arg, value_type threshold) const;
+
         void impl_compute (vectorOut_t result, ConfigurationIn_t arg) const throw ()
         {
-          size_type row = 0;
-          for (Functions_t::const_iterator _f = functions_.begin();
-              _f != functions_.end(); ++_f) {
-            const DifferentiableFunction& f = **_f;
-            f.impl_compute(result.segment(row, f.outputSize()), arg);
-            row += f.outputSize();
+          if (executor_) {
+            asyncEvaluate (&result, NULL, arg);
+            return;
+          }
+          if (!workspaces_.empty ()) {
+            parallelEvaluate (&result, NULL, arg);
+            return;
+          }
+          if (robot_) {
+            cachedEvaluate (&result, NULL, arg);
+            return;
+          }
+          if (!buckets_.empty ()) {
+            compiledEvaluate (&result, NULL, arg);
+            return;
+          }
+          if (!leaves_.empty ()) {
+            flatEvaluate (&result, NULL, arg);
+            return;
+          }
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i]) {
+              HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                  EvaluationStatistics::VALUE);
+              f.impl_compute(result.segment(rows_[i], f.outputSize()), arg);
+            } else result.segment(rows_[i], f.outputSize()).setZero();
           }
         }
         void impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
         {
+          if (executor_) {
+            asyncEvaluate (NULL, &jacobian, arg);
+            return;
+          }
+          if (!workspaces_.empty ()) {
+            parallelEvaluate (NULL, &jacobian, arg);
+            return;
+          }
+          if (robot_) {
+            cachedEvaluate (NULL, &jacobian, arg);
+            return;
+          }
+          if (!buckets_.empty ()) {
+            compiledEvaluate (NULL, &jacobian, arg);
+            return;
+          }
+          if (!leaves_.empty ()) {
+            flatEvaluate (NULL, &jacobian, arg);
+            return;
+          }
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i]) {
+              HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                  EvaluationStatistics::JACOBIAN);
+              f.impl_jacobian(jacobian.middleRows(derivativeRows_[i],
+                    f.outputDerivativeSize()), arg);
+            } else jacobian.middleRows(derivativeRows_[i],
+                f.outputDerivativeSize()).setZero();
+          }
+        }
+        void impl_valueAndJacobian (vectorOut_t result, matrixOut_t jacobian,
+            ConfigurationIn_t arg) const throw ()
+        {
+          if (executor_) {
+            asyncEvaluate (&result, &jacobian, arg);
+            return;
+          }
+          if (!workspaces_.empty ()) {
+            parallelEvaluate (&result, &jacobian, arg);
+            return;
+          }
+          if (robot_) {
+            cachedEvaluate (&result, &jacobian, arg);
+            return;
+          }
+          if (!buckets_.empty ()) {
+            compiledEvaluate (&result, &jacobian, arg);
+            return;
+          }
+          if (!leaves_.empty ()) {
+            flatEvaluate (&result, &jacobian, arg);
+            return;
+          }
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i]) {
+              HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                  EvaluationStatistics::VALUE_AND_JACOBIAN);
+              f.impl_valueAndJacobian(result.segment(rows_[i], f.outputSize()),
+                  jacobian.middleRows(derivativeRows_[i],
+                    f.outputDerivativeSize()), arg);
+            } else {
+              result.segment(rows_[i], f.outputSize()).setZero();
+              jacobian.middleRows(derivativeRows_[i],
+                  f.outputDerivativeSize()).setZero();
+            }
+          }
+        }
+        void impl_compute (vectorOut_t result, ConfigurationIn_t arg,
+            Workspace& workspace) const throw ()
+        {
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i]) {
+              HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                  EvaluationStatistics::VALUE);
+              f.impl_compute(result.segment(rows_[i], f.outputSize()), arg,
+                  workspace);
+            } else result.segment(rows_[i], f.outputSize()).setZero();
+          }
+        }
+        void impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t arg,
+            Workspace& workspace) const throw ()
+        {
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i]) {
+              HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                  EvaluationStatistics::JACOBIAN);
+              f.impl_jacobian(jacobian.middleRows(derivativeRows_[i],
+                    f.outputDerivativeSize()), arg, workspace);
+            } else jacobian.middleRows(derivativeRows_[i],
+                f.outputDerivativeSize()).setZero();
+          }
+        }
+        /// The products of the functions are computed sequentially.
+        void impl_jacobianTimes (vectorOut_t result, ConfigurationIn_t arg,
+            vectorIn_t v) const;
+        void impl_jacobianTransposeTimes (vectorOut_t result,
+            ConfigurationIn_t arg, vectorIn_t w) const;
+        /// The functions without active column in the subspace are not
+        /// evaluated: their rows are set to zero.
+        void impl_reducedJacobian (matrixOut_t jacobian, ConfigurationIn_t arg,
+            const ActiveSubspace& subspace) const;
+        void impl_valueBatch (matrixOut_t results,
+            matrixIn_t configurations) const
+        {
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i])
+              f.impl_valueBatch(results.middleRows(rows_[i], f.outputSize()),
+                  configurations);
+            else results.middleRows(rows_[i], f.outputSize()).setZero();
+          }
+        }
+        void impl_jacobianBatch (matrixOut_t jacobians,
+            matrixIn_t configurations) const
+        {
+          for (std::size_t i = 0; i < functions_.size(); ++i) {
+            const DifferentiableFunction& f = *functions_[i];
+            if (active_[i])
+              f.impl_jacobianBatch(jacobians.middleRows(derivativeRows_[i],
+                    f.outputDerivativeSize()), configurations);
+            else jacobians.middleRows(derivativeRows_[i],
+                f.outputDerivativeSize()).setZero();
+          }
+        }
+      private:
+        /// Number of non zeros of the sparse jacobian.
+        size_type sparseNonZeros () const
+        {
+          size_type nnz = 0;
+          for (Functions_t::const_iterator _f = functions_.begin();
+              _f != functions_.end(); ++_f)
+            nnz += (*_f)->outputDerivativeSize()
+              * (*_f)->activeDerivativeColumns().count();
+          return nnz;
+        }
+
+        /// Build the structure of the sparse jacobian.
+        void sparsityPattern (SparseMatrix_t& jacobian) const
+        {
+          sparseVersion_ = structureVersion_;
+          jacobian.resize (outputDerivativeSize_, inputDerivativeSize_);
+          Eigen::VectorXi nnzPerRow (outputDerivativeSize_);
           size_type row = 0;
           for (Functions_t::const_iterator _f = functions_.begin();
               _f != functions_.end(); ++_f) {
-            const DifferentiableFunction& f = **_f;
-            f.impl_jacobian(jacobian.middleRows(row, f.outputSize()), arg);
-            row += f.outputSize();
+            nnzPerRow.segment (row, (*_f)->outputDerivativeSize()).setConstant
+              ((int) (*_f)->activeDerivativeColumns().count());
+            row += (*_f)->outputDerivativeSize();
+          }
+          jacobian.reserve (nnzPerRow);
+          row = 0;
+          for (Functions_t::const_iterator _f = functions_.begin();
+              _f != functions_.end(); ++_f) {
+            const ArrayXb& active = (*_f)->activeDerivativeColumns();
+            for (size_type r = 0; r < (*_f)->outputDerivativeSize(); ++r)
+              for (size_type c = 0; c < inputDerivativeSize_; ++c)
+                if (active[c]) jacobian.insert (row + r, c) = 0;
+            row += (*_f)->outputDerivativeSize();
           }
+          jacobian.makeCompressed ();
+          sparseInner_ = jacobian.innerIndexPtr ();
         }
-      private:
+
+        /// Consecutive functions evaluated by the same thread.
+        struct Task
+        {
+          std::size_t begin, end;
+          bool parallel;
+        };
+
+        /// Group the functions in tasks.
+        void computeTasks ();
+
+        /// Evaluate the tasks.
+        /// \param result, jacobian outputs. Not computed if NULL.
+        void parallelEvaluate (vectorOut_t* result, matrixOut_t* jacobian,
+            ConfigurationIn_t arg) const;
+
+        /// Function of a nested stack, see flatten.
+        struct Leaf
+        {
+          const DifferentiableFunction* function;
+          /// Rows of the function in the value and in the jacobian.
+          size_type row, derivativeRow;
+          bool active;
+        };
+
+        /// Append the functions of stack to leaves, expanding the nested
+        /// stacks.
+        static void appendLeaves (const DifferentiableFunctionStack& stack,
+            size_type row, size_type derivativeRow, bool active,
+            std::vector <Leaf>& leaves);
+
+        /// Rows of an active leaf whose function is evaluated by a previous
+        /// leaf.
+        struct Copy
+        {
+          /// Rows of the evaluated leaf and of the copy.
+          size_type from, to, size;
+          /// Rows in the jacobian.
+          size_type derivativeFrom, derivativeTo, derivativeSize;
+        };
+
+        /// Remove the active leaves whose function is evaluated by a
+        /// previous active leaf and list the rows to copy.
+        static void removeDuplicates (std::vector <Leaf>& leaves,
+            std::vector <Copy>& copies);
+
+        /// Copy the rows of the duplicated leaves, once the others are
+        /// evaluated.
+        static void applyCopies (const std::vector <Copy>& copies,
+            vectorOut_t* result, matrixOut_t* jacobian)
+        {
+          for (std::vector <Copy>::const_iterator _c = copies.begin ();
+              _c != copies.end (); ++_c) {
+            if (result)
+              result->segment (_c->to, _c->size) =
+                result->segment (_c->from, _c->size);
+            if (jacobian)
+              jacobian->middleRows (_c->derivativeTo, _c->derivativeSize) =
+                jacobian->middleRows (_c->derivativeFrom, _c->derivativeSize);
+          }
+        }
+
+        /// Functions of the same concrete type, see compile.
+        struct Bucket
+        {
+          typedef void (*Evaluate_t) (const std::vector <Leaf>& leaves,
+              vectorOut_t* result, matrixOut_t* jacobian,
+              ConfigurationIn_t arg);
+          /// Evaluation of the functions of the bucket.
+          Evaluate_t evaluate;
+          std::vector <Leaf> leaves;
+        };
+
+        /// Evaluate leaves whose functions are of type T, without virtual
+        /// call.
+        template <typename T> static void evaluateBucket
+          (const std::vector <Leaf>& leaves, vectorOut_t* result,
+           matrixOut_t* jacobian, ConfigurationIn_t arg);
+
+        /// Evaluate leaves of any type. The rows of the inactive leaves are
+        /// set to zero.
+        static void evaluateLeaves (const std::vector <Leaf>& leaves,
+            vectorOut_t* result, matrixOut_t* jacobian,
+            ConfigurationIn_t arg);
+
+        /// Evaluate buckets_.
+        /// \param result, jacobian outputs. Not computed if NULL.
+        void compiledEvaluate (vectorOut_t* result, matrixOut_t* jacobian,
+            ConfigurationIn_t arg) const
+        {
+          for (std::size_t b = 0; b < buckets_.size (); ++b)
+            buckets_[b].evaluate (buckets_[b].leaves, result, jacobian, arg);
+          applyCopies (compiledCopies_, result, jacobian);
+        }
+
+        /// Evaluate leaves_.
+        /// \param result, jacobian outputs. Not computed if NULL.
+        void flatEvaluate (vectorOut_t* result, matrixOut_t* jacobian,
+            ConfigurationIn_t arg) const
+        {
+          evaluateLeaves (leaves_, result, jacobian, arg);
+          applyCopies (flatCopies_, result, jacobian);
+        }
+
+        /// Evaluate the functions with executor_.
+        /// \param result, jacobian outputs. Not computed if NULL.
+        void asyncEvaluate (vectorOut_t* result, matrixOut_t* jacobian,
+            ConfigurationIn_t arg) const;
+
+        /// Evaluate the functions, reusing the cached rows.
+        /// \param result, jacobian outputs. Not computed if NULL.
+        void cachedEvaluate (vectorOut_t* result, matrixOut_t* jacobian,
+            ConfigurationIn_t arg) const;
+
+        /// Compute the configuration variables each function depends on.
+        void computeSupports ();
+
+        /// Sort the functions by increasing evaluationCost.
+        void computeSatisfactionOrder ();
+        /// Compute the independent blocks.
+        void computeBlocks ();
+        /// Compute the joints of the blocks.
+        void computeBlockJoints ();
+
+        /// Compute the row offsets and the active derivative columns.
+        void update ();
+
+        /// Rows of the functions computed at the previous evaluation.
+        struct RowCache
+        {
+          /// Configuration of the previous evaluation.
+          vector_t argument;
+          /// Configuration variables modified since the previous evaluation.
+          ArrayXb changed;
+          /// Whether the rows of each function are cached.
+          std::vector <bool> valid;
+
+          /// Compare arg to the configuration of the previous evaluation.
+          void update (ConfigurationIn_t arg, std::size_t nbFunctions)
+          {
+            if (argument.size () != arg.size ()) {
+              valid.clear ();
+              changed.setConstant (arg.size (), true);
+            } else changed = (argument.array () != arg.array ());
+            valid.resize (nbFunctions, false);
+            argument = arg;
+          }
+
+          /// Whether the cached rows of function i can be reused.
+          bool reusable (std::size_t i, const ArrayXb& support) const
+          {
+            return valid[i] && !(changed && support).any ();
+          }
+        };
+
         Functions_t functions_;
+        /// Row offsets of the functions in the value and in the jacobian.
+        std::vector <size_type> rows_, derivativeRows_;
+        std::vector <bool> active_;
+        /// Handle of each function.
+        std::vector <Handle_t> handles_;
+        /// Index of the function of each handle. Erased handles are mapped
+        /// to std::numeric_limits<std::size_t>::max ().
+        std::vector <std::size_t> indices_;
+        /// Incremented by update, when the functions change.
+        std::size_t structureVersion_;
+        /// Structure version and indices of the last sparse jacobian.
+        mutable std::size_t sparseVersion_;
+        mutable const int* sparseInner_;
+        /// Active derivative columns of each function.
+        std::vector <ActiveSubspace> sparseSubspaces_;
+        /// Jacobian of the active columns of each function.
+        mutable std::vector <matrix_t> sparseBlocks_;
+        /// Product of one function in impl_jacobianTransposeTimes.
+        mutable vector_t product_;
+        Blocks_t blocks_;
+        /// Robot of the blocks. NULL if their kinematics is not restricted.
+        DevicePtr_t blockRobot_;
+        /// Jacobian of one function of a block, per thread.
+        mutable std::vector <matrix_t> blockScratch_;
+        /// Indices of the functions, by increasing evaluation cost.
+        std::vector <std::size_t> satisfactionOrder_;
+        /// Value of one function in impl_isSatisfied.
+        mutable vector_t value_;
+        /// Workspaces of the threads. Empty if parallel evaluation is disabled.
+        std::vector <WorkspacePtr_t> workspaces_;
+        std::vector <Task> tasks_;
+        value_type minTaskCost_;
+        /// Executor of the evaluations. May be NULL.
+        ExecutorPtr_t executor_;
+        mutable std::vector <EvaluationFuture> futures_;
+        /// Functions of the nested stacks. Empty if flatten is disabled.
+        std::vector <Leaf> leaves_;
+        /// Duplicated leaves of leaves_.
+        std::vector <Copy> flatCopies_;
+        bool flatten_;
+        /// Functions grouped by type. Empty if compile is disabled.
+        std::vector <Bucket> buckets_;
+        /// Duplicated leaves of buckets_.
+        std::vector <Copy> compiledCopies_;
+        bool compiled_;
+        /// Robot of the row cache. NULL if the cache is disabled.
+        DevicePtr_t robot_;
+        /// Configuration variables each function depends on.
+        std::vector <ArrayXb> supports_;
+        mutable RowCache valueCache_, jacobianCache_;
+        mutable vector_t cachedValue_;
+        mutable matrix_t cachedJacobian_;
     }; // class DifferentiableFunctionStack
     /// \}
   } // namespace constraints
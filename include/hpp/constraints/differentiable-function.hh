@@ -19,8 +19,22 @@
 #ifndef HPP_CONSTRAINTS_DIFFERENTIABLE_FUNCTION_HH
 # define HPP_CONSTRAINTS_DIFFERENTIABLE_FUNCTION_HH
 
+# include <limits>
+
 # include <hpp/constraints/fwd.hh>
 # include <hpp/constraints/config.hh>
+# include <hpp/constraints/memory-usage.hh>
+# include <hpp/constraints/statistics.hh>
+# include <hpp/constraints/trace.hh>
+
+/// Record an evaluation of function f until the end of the enclosing block,
+/// in the statistics and in the trace of the evaluations.
+/// \param evaluation an EvaluationStatistics::Evaluation.
+# define HPP_CONSTRAINTS_EVALUATION_SCOPE(f, evaluation)                 \
+  HPP_CONSTRAINTS_STATISTICS (::hpp::constraints::EvaluationStatistics::  \
+      Scope _hpp_constraints_statistics ((f).statistics_, evaluation));   \
+  HPP_CONSTRAINTS_TRACE_SCOPE ((f).name ().c_str (),                      \
+      ::hpp::constraints::EvaluationStatistics::name (evaluation))
 
 namespace hpp {
   namespace constraints {
@@ -40,6 +54,8 @@ namespace hpp {
       {
 	assert (result.size () == outputSize ());
 	assert (argument.size () == inputSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::VALUE);
 	impl_compute (result, argument);
       }
       /// Computes the jacobian.
@@ -51,9 +67,266 @@ namespace hpp {
 	assert (argument.size () == inputSize ());
 	assert (jacobian.rows () == outputDerivativeSize ());
 	assert (jacobian.cols () == inputDerivativeSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::JACOBIAN);
 	impl_jacobian (jacobian, argument);
       }
 
+      /// Evaluate the function and compute its jacobian at the same point.
+      ///
+      /// \retval result value of the function,
+      /// \retval jacobian jacobian of the function,
+      /// \param argument point at which the function is evaluated.
+      ///
+      /// Equivalent to calling operator() and then jacobian() but lets
+      /// concrete classes share the forward kinematics and the intermediate
+      /// results between both computations.
+      void valueAndJacobian (vectorOut_t result, matrixOut_t jacobian,
+                             vectorIn_t argument) const
+      {
+	assert (result.size () == outputSize ());
+	assert (argument.size () == inputSize ());
+	assert (jacobian.rows () == outputDerivativeSize ());
+	assert (jacobian.cols () == inputDerivativeSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::VALUE_AND_JACOBIAN);
+	impl_valueAndJacobian (result, jacobian, argument);
+      }
+
+      /// Evaluate the function using a workspace.
+      ///
+      /// Functions that support workspaces store their intermediate results
+      /// in the workspace instead of in the function. Several threads can
+      /// then evaluate the same function, provided each uses its own
+      /// Workspace.
+      void operator () (vectorOut_t result, vectorIn_t argument,
+                        Workspace& workspace) const
+      {
+	assert (result.size () == outputSize ());
+	assert (argument.size () == inputSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::VALUE);
+	impl_compute (result, argument, workspace);
+      }
+
+      /// Compute the jacobian using a workspace.
+      /// \sa operator() (vectorOut_t, vectorIn_t, Workspace&) const
+      void jacobian (matrixOut_t jacobian, vectorIn_t argument,
+                     Workspace& workspace) const
+      {
+	assert (argument.size () == inputSize ());
+	assert (jacobian.rows () == outputDerivativeSize ());
+	assert (jacobian.cols () == inputDerivativeSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::JACOBIAN);
+	impl_jacobian (jacobian, argument, workspace);
+      }
+
+      /// Compute the jacobian in a subspace of the velocity.
+      ///
+      /// \retval jacobian matrix of size outputDerivativeSize() x
+      ///         subspace.dimension(), the product of the jacobian by the
+      ///         selection matrix of the subspace.
+      void reducedJacobian (matrixOut_t jacobian, vectorIn_t argument,
+                            const ActiveSubspace& subspace) const;
+
+      /// Whether the norm of the value is below a threshold.
+      ///
+      /// \param argument point at which the function is evaluated,
+      /// \param threshold bound on the Euclidean norm of the value.
+      ///
+      /// Rejection sampling only needs this test. Concrete classes may stop
+      /// the computation as soon as the threshold is exceeded.
+      bool isSatisfied (vectorIn_t argument, value_type threshold) const
+      {
+	assert (argument.size () == inputSize ());
+	return impl_isSatisfied (argument, threshold);
+      }
+
+      /// Submit an evaluation of the function to an executor.
+      ///
+      /// \param argument the configuration is copied,
+      /// \param computeJacobian whether the jacobian is computed as well.
+      /// \return the result, computed in the background once the executor
+      ///         runs.
+      /// \sa Executor
+      EvaluationFuture evaluateAsync (vectorIn_t argument, Executor& executor,
+                                      bool computeJacobian = true) const;
+
+      /// Compute the product of the jacobian with a vector.
+      ///
+      /// \retval result \f$ J v \f$, of size outputDerivativeSize(),
+      /// \param argument point at which the jacobian is computed,
+      /// \param v vector of size inputDerivativeSize().
+      ///
+      /// Iterative solvers only need products with the jacobian. Concrete
+      /// classes may compute them without building the jacobian.
+      void jacobianTimes (vectorOut_t result, vectorIn_t argument,
+                          vectorIn_t v) const
+      {
+	assert (argument.size () == inputSize ());
+	assert (result.size () == outputDerivativeSize ());
+	assert (v.size () == inputDerivativeSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::JACOBIAN);
+	impl_jacobianTimes (result, argument, v);
+      }
+
+      /// Compute the product of the transpose of the jacobian with a vector.
+      ///
+      /// \retval result \f$ J^T w \f$, of size inputDerivativeSize(),
+      /// \param argument point at which the jacobian is computed,
+      /// \param w vector of size outputDerivativeSize().
+      void jacobianTransposeTimes (vectorOut_t result, vectorIn_t argument,
+                                   vectorIn_t w) const
+      {
+	assert (argument.size () == inputSize ());
+	assert (result.size () == inputDerivativeSize ());
+	assert (w.size () == outputDerivativeSize ());
+	HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+            EvaluationStatistics::JACOBIAN);
+	impl_jacobianTransposeTimes (result, argument, w);
+      }
+
+      /// Compute the second order term of the Newton step of
+      /// \f$ \frac{1}{2}\|f\|^2 \f$ in a direction.
+      ///
+      /// \retval result \f$ \sum_i r_i \nabla^2 f_i \, v \f$, of size
+      ///         inputDerivativeSize(),
+      /// \param argument point at which the hessians are computed,
+      /// \param r weights of the components, of size outputDerivativeSize(),
+      /// \param v direction, of size inputDerivativeSize(),
+      /// \param robot used to integrate the direction. If NULL, the
+      ///        direction is added to the configuration.
+      void hessianTimes (vectorOut_t result, vectorIn_t argument,
+                         vectorIn_t r, vectorIn_t v,
+                         const DevicePtr_t& robot = DevicePtr_t ()) const
+      {
+	assert (argument.size () == inputSize ());
+	assert (result.size () == inputDerivativeSize ());
+	assert (r.size () == outputDerivativeSize ());
+	assert (v.size () == inputDerivativeSize ());
+	impl_hessianTimes (result, argument, r, v, robot);
+      }
+
+      /// Whether evaluations with distinct workspaces can run concurrently.
+      ///
+      /// The default implementation returns false since the default workspace
+      /// overloads use the data of the function.
+      virtual bool threadSafe () const
+      {
+	return false;
+      }
+
+      /// Estimated cost of an evaluation, relative to the cost of a
+      /// Position constraint. Used to balance parallel evaluations and to
+      /// test the cheapest functions of a stack first in isSatisfied.
+      virtual value_type evaluationCost () const
+      {
+	return 1;
+      }
+
+      /// Memory used by the function.
+      ///
+      /// Memory shared with other functions, such as the KinematicsCache of
+      /// the robot, is not counted. The default implementation counts the
+      /// members of DifferentiableFunction. Derived classes should add
+      /// theirs, sizeof the derived members included.
+      virtual MemoryUsage memoryUsage () const;
+
+      /// Bound on the variation of the norm of the value.
+      ///
+      /// \return \f$L\f$ such that
+      ///         \f$ | \|f(q_1)\| - \|f(q_0)\| | \leq L \|q_1 - q_0\| \f$
+      ///         for any configurations, where \f$q_1 - q_0\f$ is the
+      ///         difference on the configuration space.
+      ///
+      /// Path validation uses it to certify intervals between samples, see
+      /// validateSegment. The default implementation returns infinity,
+      /// meaning that no bound is known.
+      virtual value_type lipschitzConstant () const
+      {
+	return std::numeric_limits <value_type>::infinity ();
+      }
+
+      /// Switch to an approximate model of the function, if it has one.
+      ///
+      /// Solvers may iterate on the approximate model, which is cheaper,
+      /// and switch back to the exact model for the final iterations.
+      /// The default implementation does nothing.
+      virtual void approximate (bool /* approximate */)
+      {
+      }
+
+      /// Set the accuracy of the evaluation.
+      ///
+      /// \param tolerance error on the value the function may trade for
+      ///        speed, in the unit of the value. 0, the default, is the
+      ///        most accurate evaluation.
+      ///
+      /// Coarse phases of a planner may evaluate the functions with a large
+      /// tolerance and the final refinement with 0. The functions whose
+      /// evaluation relies on an iterative backend (distance computation,
+      /// quadratic program, selection of a pair of shapes) stop it earlier.
+      /// The default implementation does nothing.
+      virtual void accuracy (value_type /* tolerance */)
+      {
+      }
+
+      /// Save the state the next evaluation starts from.
+      ///
+      /// Some functions start from the result of the previous evaluation:
+      /// the active set of a quadratic program, the selected pair of
+      /// shapes, the closest pair of bodies, the previous singular value
+      /// decomposition. A planner may save this state with a roadmap node
+      /// and restore it before projecting configurations near the node, so
+      /// that the evaluations start hot.
+      /// \retval state the state of the function, empty if it has none,
+      ///         which is the default.
+      virtual void saveWarmStart (vector_t& state) const
+      {
+        state.resize (0);
+      }
+
+      /// Restore a state saved by saveWarmStart on the same function.
+      /// A state that does not match the function is ignored.
+      /// The default implementation does nothing.
+      virtual void restoreWarmStart (vectorIn_t /* state */)
+      {
+      }
+
+      /// Evaluate the function at several configurations.
+      ///
+      /// \retval results matrix of size outputSize() x N. Column i
+      ///         contains the value at configuration i.
+      /// \param configurations matrix of size inputSize() x N. Each column
+      ///         is a configuration.
+      void valueBatch (matrixOut_t results, matrixIn_t configurations) const
+      {
+	assert (results.rows () == outputSize ());
+	assert (configurations.rows () == inputSize ());
+	assert (results.cols () == configurations.cols ());
+	impl_valueBatch (results, configurations);
+      }
+
+      /// Compute the jacobian at several configurations.
+      ///
+      /// \retval jacobians matrix of size outputDerivativeSize() x
+      ///         (N * inputDerivativeSize()). The jacobian at configuration i
+      ///         is stored in columns [i * inputDerivativeSize(),
+      ///         (i+1) * inputDerivativeSize()[.
+      /// \param configurations matrix of size inputSize() x N. Each column
+      ///         is a configuration.
+      void jacobianBatch (matrixOut_t jacobians,
+                          matrixIn_t configurations) const
+      {
+	assert (configurations.rows () == inputSize ());
+	assert (jacobians.rows () == outputDerivativeSize ());
+	assert (jacobians.cols () ==
+                inputDerivativeSize () * configurations.cols ());
+	impl_jacobianBatch (jacobians, configurations);
+      }
+
       /// Get dimension of input vector
       size_type inputSize () const
       {
@@ -78,6 +351,49 @@ namespace hpp {
       {
 	return outputDerivativeSize_;
       }
+      /// Columns of the jacobian that may be non zero.
+      ///
+      /// If activeDerivativeColumns()[i] is false, column i of the jacobian
+      /// is zero whatever the configuration. Solvers can use this to skip
+      /// computations on the corresponding DOFs.
+      const ArrayXb& activeDerivativeColumns () const
+      {
+	return activeDerivativeColumns_;
+      }
+
+      /// Structural pattern of the jacobian.
+      ///
+      /// \retval pattern matrix of size outputDerivativeSize() x
+      ///         inputDerivativeSize(). If pattern (i,j) is false,
+      ///         coefficient (i,j) of the jacobian is zero whatever the
+      ///         configuration.
+      ///
+      /// The default implementation uses activeDerivativeColumns() for all
+      /// the rows.
+      virtual void jacobianPattern (ArrayXXb& pattern) const
+      {
+	pattern.resize (outputDerivativeSize_, inputDerivativeSize_);
+	pattern.rowwise () = activeDerivativeColumns_.transpose ();
+      }
+
+# ifdef HPP_CONSTRAINTS_WITH_STATISTICS
+      /// Statistics on the evaluations of the function.
+      ///
+      /// Only available if the library is compiled with ENABLE_STATISTICS.
+      /// Evaluations through operator(), jacobian and valueAndJacobian, and
+      /// evaluations by a DifferentiableFunctionStack are recorded.
+      const EvaluationStatistics& statistics () const
+      {
+	return statistics_;
+      }
+
+      /// Set the statistics to zero.
+      virtual void resetStatistics ()
+      {
+	statistics_.reset ();
+      }
+# endif // HPP_CONSTRAINTS_WITH_STATISTICS
+
       /// \brief Get function name.
       ///
       /// \return Function name.
@@ -107,20 +423,55 @@ namespace hpp {
       ///              the configuration space is considered a vector space.
       /// \param eps refers to \f$\epsilon\f$ in
       ///            http://en.wikipedia.org/wiki/Numerical_differentiation
+      /// \param nbThreads number of threads the columns are spread
+      ///        between. It requires a robot and a thread safe function
+      ///        (see threadSafe): each thread evaluates the function with
+      ///        its own Workspace.
       /// Evaluate the function (x.size() + 1) times but less precise the
       /// finiteDifferenceCentral
       void finiteDifferenceForward (matrixOut_t jacobian, vectorIn_t arg,
           DevicePtr_t robot = DevicePtr_t (),
-          value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon())) const;
+          value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon()),
+          std::size_t nbThreads = 1) const;
 
       /// Approximate the jacobian using forward finite difference.
       /// \param eps refers to \f$\epsilon\f$ in
       ///            http://en.wikipedia.org/wiki/Numerical_differentiation
+      /// \param nbThreads see finiteDifferenceForward.
       /// Evaluate the function 2*x.size() times but more precise the
       /// finiteDifferenceForward
       void finiteDifferenceCentral (matrixOut_t jacobian, vectorIn_t arg,
           DevicePtr_t robot = DevicePtr_t (),
-          value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon())) const;
+          value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon()),
+          std::size_t nbThreads = 1) const;
+
+      /// Approximate the reduced jacobian using finite difference,
+      /// perturbing the configuration only along the subspace.
+      ///
+      /// For a selection of columns, the steps are those of
+      /// finiteDifferenceForward. Otherwise, the configuration moves by
+      /// eps along each column of the selection matrix.
+      /// \param central whether central or forward finite differences
+      ///        are used.
+      /// \sa reducedJacobian
+      void finiteDifference (matrixOut_t jacobian, vectorIn_t arg,
+          const ActiveSubspace& subspace, bool central,
+          DevicePtr_t robot = DevicePtr_t (),
+          value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon()))
+        const;
+
+      /// Approximate the jacobian using forward finite difference,
+      /// perturbing several columns per evaluation.
+      ///
+      /// Columns are grouped so that the columns of a group have no row in
+      /// common in jacobianPattern (Curtis, Powell and Reid). Each group is
+      /// perturbed in one evaluation, so that the function is evaluated
+      /// (number of groups + 1) times. The parameters are those of
+      /// finiteDifferenceForward.
+      void finiteDifferenceColored (matrixOut_t jacobian, vectorIn_t arg,
+          DevicePtr_t robot = DevicePtr_t (),
+          value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon()),
+          std::size_t nbThreads = 1) const;
 
     protected:
       /// \brief Concrete class constructor should call this constructor.
@@ -135,6 +486,7 @@ namespace hpp {
 			      std::string name = std::string ()) :
 	inputSize_ (sizeInput), inputDerivativeSize_ (sizeInputDerivative),
 	outputSize_ (sizeOutput), outputDerivativeSize_ (sizeOutput),
+	activeDerivativeColumns_ (ArrayXb::Constant (sizeInputDerivative, true)),
 	name_ (name)
       {
       }
@@ -153,10 +505,29 @@ namespace hpp {
 			      std::string name = std::string ()) :
 	inputSize_ (sizeInput), inputDerivativeSize_ (sizeInputDerivative),
 	outputSize_ (sizeOutput), outputDerivativeSize_ (sizeOutputDerivative),
+	activeDerivativeColumns_ (ArrayXb::Constant (sizeInputDerivative, true)),
 	name_ (name), context_ ()
       {
       }
 
+      /// Set as active the columns of the DOFs of joint and of its
+      /// ancestors.
+      ///
+      /// Concrete classes depending only on some joints should call
+      /// activeDerivativeColumns_.setConstant (false) and then this method
+      /// for each of these joints. Nothing is done if joint is NULL.
+      void activateJointColumns (const JointConstPtr_t& joint);
+
+      /// Set as active the columns of the DOFs on the kinematic path
+      /// between joint1 and joint2.
+      ///
+      /// The common ancestors of the joints move both joints together: their
+      /// columns are exactly zero in the jacobian of any quantity that
+      /// depends on the relative placement of the joints only. A NULL joint
+      /// stands for the world frame.
+      void activateRelativeColumns (const JointConstPtr_t& joint1,
+          const JointConstPtr_t& joint2);
+
       /// User implementation of function evaluation
       virtual void impl_compute (vectorOut_t result,
 				 vectorIn_t argument) const = 0;
@@ -164,6 +535,100 @@ namespace hpp {
       virtual void impl_jacobian (matrixOut_t jacobian,
 				  vectorIn_t arg) const = 0;
 
+      /// User implementation of the combined evaluation.
+      ///
+      /// The default implementation calls impl_compute and impl_jacobian.
+      /// Override it when both computations share expensive steps.
+      virtual void impl_valueAndJacobian (vectorOut_t result,
+                                          matrixOut_t jacobian,
+                                          vectorIn_t arg) const
+      {
+	impl_compute (result, arg);
+	impl_jacobian (jacobian, arg);
+      }
+
+      /// User implementation of isSatisfied.
+      ///
+      /// The default implementation evaluates the function in a buffer of
+      /// the function and compares the norm of the value to the threshold.
+      virtual bool impl_isSatisfied (vectorIn_t arg,
+                                     value_type threshold) const;
+
+      /// User implementation of jacobianTimes.
+      ///
+      /// The default implementation computes the jacobian with
+      /// impl_jacobian in a buffer of the function.
+      virtual void impl_jacobianTimes (vectorOut_t result, vectorIn_t arg,
+                                       vectorIn_t v) const;
+
+      /// User implementation of jacobianTransposeTimes.
+      ///
+      /// The default implementation computes the jacobian with
+      /// impl_jacobian in a buffer of the function.
+      virtual void impl_jacobianTransposeTimes (vectorOut_t result,
+                                                vectorIn_t arg,
+                                                vectorIn_t w) const;
+
+      /// User implementation of hessianTimes.
+      ///
+      /// The default implementation differentiates
+      /// \f$ J^T r \f$ along \f$ v \f$ with central finite differences,
+      /// which costs two evaluations of impl_jacobianTransposeTimes.
+      virtual void impl_hessianTimes (vectorOut_t result, vectorIn_t arg,
+                                      vectorIn_t r, vectorIn_t v,
+                                      const DevicePtr_t& robot) const;
+
+      /// User implementation of batch evaluation.
+      ///
+      /// The default implementation calls impl_compute for each
+      /// configuration.
+      virtual void impl_valueBatch (matrixOut_t results,
+                                    matrixIn_t configurations) const
+      {
+	for (size_type i = 0; i < configurations.cols (); ++i)
+	  impl_compute (results.col (i), configurations.col (i));
+      }
+
+      /// User implementation of batch jacobian computation.
+      ///
+      /// The default implementation calls impl_jacobian for each
+      /// configuration.
+      virtual void impl_jacobianBatch (matrixOut_t jacobians,
+                                       matrixIn_t configurations) const
+      {
+	const size_type nv = inputDerivativeSize ();
+	for (size_type i = 0; i < configurations.cols (); ++i)
+	  impl_jacobian (jacobians.middleCols (i * nv, nv),
+                         configurations.col (i));
+      }
+
+      /// User implementation of reducedJacobian.
+      ///
+      /// The default implementation computes the whole jacobian and
+      /// multiplies it by the selection matrix.
+      virtual void impl_reducedJacobian (matrixOut_t jacobian, vectorIn_t arg,
+                                         const ActiveSubspace& subspace) const;
+
+      /// User implementation of function evaluation using a workspace.
+      ///
+      /// The default implementation ignores the workspace and calls
+      /// impl_compute (vectorOut_t, vectorIn_t). It is thus not thread safe.
+      virtual void impl_compute (vectorOut_t result, vectorIn_t argument,
+                                 Workspace& /* workspace */) const
+      {
+	impl_compute (result, argument);
+      }
+
+      /// User implementation of the jacobian using a workspace.
+      ///
+      /// The default implementation ignores the workspace and calls
+      /// impl_jacobian (matrixOut_t, vectorIn_t). It is thus not thread safe.
+      virtual void impl_jacobian (matrixOut_t jacobian, vectorIn_t arg,
+                                  Workspace& /* workspace */) const
+      {
+	impl_jacobian (jacobian, arg);
+      }
+
       /// Dimension of input vector.
       size_type inputSize_;
       /// Dimension of input derivative
@@ -172,11 +637,20 @@ namespace hpp {
       size_type outputSize_;
       /// Dimension of output derivative vector
       size_type outputDerivativeSize_;
+      /// Columns of the jacobian that may be non zero.
+      ArrayXb activeDerivativeColumns_;
 
     private:
       std::string name_;
       /// Context of creation of function
       std::string context_;
+      /// Buffers of the default implementations of isSatisfied and of the
+      /// jacobian products.
+      mutable vector_t valueBuffer_;
+      mutable matrix_t jacobianBuffer_;
+# ifdef HPP_CONSTRAINTS_WITH_STATISTICS
+      mutable EvaluationStatistics statistics_;
+# endif
 
       friend class DifferentiableFunctionStack;
     }; // class DifferentiableFunction
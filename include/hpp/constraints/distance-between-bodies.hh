@@ -25,6 +25,7 @@
 # include <hpp/pinocchio/collision-object.hh>
 
 # include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/bounding-spheres.hh>
 # include <hpp/constraints/differentiable-function.hh>
 
 namespace hpp {
@@ -36,6 +37,18 @@ namespace hpp {
     ///   \li or objects of a joint with a list of fixed objects.
     ///
     /// The above type of distance is determined by the method "create" called.
+    ///
+    /// The exact distance is only computed for the pairs whose bounding
+    /// spheres are closer than the smallest distance found so far, starting
+    /// with the closest pair of the previous evaluation.
+    ///
+    /// The distance results are cached with the version of the
+    /// KinematicsCache, in the function or in the Workspace. The jacobian at
+    /// the configuration of the latest value reuses the witness points.
+    ///
+    /// The placements of the geometries are shared by the functions bound to
+    /// the same robot, see GeometryPlacements. Only the geometries of the
+    /// collision pairs of the function are updated.
     class HPP_CONSTRAINTS_DLLAPI DistanceBetweenBodies :
       public DifferentiableFunction
     {
@@ -77,6 +90,107 @@ namespace hpp {
 
       virtual ~DistanceBetweenBodies () throw () {}
 
+      virtual bool threadSafe () const
+      {
+        return true;
+      }
+
+      /// The cost grows with the number of collision pairs.
+      virtual value_type evaluationCost () const;
+
+      /// The distance does not depend on the frame it is measured in. It is
+      /// bounded by the velocity of the geometries of joint 1 relative to
+      /// joint 2, or to the world frame for fixed objects.
+      virtual value_type lipschitzConstant () const;
+
+      /// The placements of the geometries are shared and not counted.
+      virtual MemoryUsage memoryUsage () const;
+
+      /// Result of distanceAlongSegment.
+      struct SegmentDistance
+      {
+        /// Smallest distance found along the segment.
+        value_type distance;
+        /// Parameter in [0, 1] of the configuration of distance.
+        value_type parameter;
+        /// Lower bound of the distance on the whole segment. It is
+        /// certified by lipschitzConstant, minus infinity if the function
+        /// has no Lipschitz constant.
+        value_type lowerBound;
+        /// Number of distance computations.
+        std::size_t nbEvaluations;
+      };
+
+      /// Minimal distance along a straight path
+      ///
+      /// \param q0, q1 ends of the straight path in the configuration space,
+      /// \param tolerance the search stops when the certified lower bound is
+      ///        within tolerance of the smallest distance found,
+      /// \param maxEvaluations maximal number of distance computations.
+      ///
+      /// Conservative advancement on the Lipschitz constant \f$L\f$ of the
+      /// distance along the path: between samples \f$t_a, t_b\f$ of
+      /// distance \f$d_a, d_b\f$, the distance is above
+      /// \f$(d_a + d_b - L \ell (t_b - t_a)) / 2\f$ where \f$\ell\f$ is
+      /// the length of the path. The interval of smallest bound is split at
+      /// the parameter where the bound is reached, so that the distant
+      /// parts of the path are certified by a few samples.
+      ///
+      /// With the approximate model, the lower bound also holds for the
+      /// exact model.
+      SegmentDistance distanceAlongSegment (ConfigurationIn_t q0,
+          ConfigurationIn_t q1, value_type tolerance,
+          std::size_t maxEvaluations = 100) const;
+
+      /// Set the number of threads computing the distance of the collision
+      /// pairs.
+      ///
+      /// Values greater than 1 split the pairs between threads, if the
+      /// library is compiled with OpenMP. It only applies to the evaluation
+      /// without Workspace, since the evaluation with a Workspace is
+      /// already done in parallel by DifferentiableFunctionStack.
+      /// Default to 1.
+      void nbThreads (std::size_t nbThreads);
+
+      std::size_t nbThreads () const
+      {
+        return nbThreads_;
+      }
+
+      /// Use a coarse model of the geometries instead of the meshes.
+      ///
+      /// Each geometry is covered by spheres (see coverWithSpheres) and the
+      /// distance of a pair is the smallest distance between their spheres.
+      /// The witness points are on the closest spheres, so that the
+      /// jacobian is given by the same formula as for the meshes.
+      /// The approximate distance does not exceed the exact one.
+      virtual void approximate (bool approximate);
+
+      bool approximate () const
+      {
+        return approximate_;
+      }
+
+      /// Set the absolute error of the distance computations.
+      ///
+      /// The error is given to FCL, and the search of the closest pair
+      /// skips the pairs whose lower bound is within tolerance of the
+      /// smallest distance computed so far. The distance is then at most
+      /// tolerance more than the exact one.
+      virtual void accuracy (value_type tolerance);
+
+      value_type accuracy () const
+      {
+        return request_.abs_err;
+      }
+
+      /// Save the index of the closest pair.
+      /// The search of the closest pair of the exact model starts with this
+      /// pair.
+      virtual void saveWarmStart (vector_t& state) const;
+
+      virtual void restoreWarmStart (vectorIn_t state);
+
     protected:
       /// Protected constructor
       ///
@@ -112,20 +226,51 @@ namespace hpp {
 				 ConfigurationIn_t argument) const throw ();
       virtual void impl_jacobian (matrixOut_t jacobian,
 				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_compute (vectorOut_t result,
+				 ConfigurationIn_t argument,
+                                 Workspace& workspace) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg,
+                                  Workspace& workspace) const throw ();
     private:
       template <typename Iterator1, typename Iterator2>
       void initGeomData(const Iterator1& begin1, const Iterator1& end1,
           const Iterator2& begin2, const Iterator2& end2);
 
-      typedef se3::GeometryData GeometryData;
+      /// Compute the distance of the pairs at argument, unless the forward
+      /// kinematics has not changed since the previous computation.
+      /// \param quantities see KinematicsCache::update.
+      void updateDistances (ConfigurationIn_t argument, int quantities) const;
+
+      /// Compute the jacobian from the result of the distance computation.
+      static void computeJacobian (matrixOut_t jacobian,
+          const JointPtr_t& joint1, const JointPtr_t& joint2,
+          const fcl::DistanceResult& result);
 
       DevicePtr_t robot_;
+      KinematicsCachePtr_t kinematics_;
       JointPtr_t joint1_;
       JointPtr_t joint2_;
-      mutable GeometryData data_;
+      GeometryPlacementsPtr_t placements_;
+      /// Indices of the active collision pairs.
+      std::vector <std::size_t> activePairs_;
+      /// Geometries of the active collision pairs.
+      std::vector <se3::GeomIndex> geometries_;
+      /// Distance results of the active collision pairs.
+      mutable std::vector <fcl::DistanceResult> results_;
+      std::size_t nbThreads_;
+      /// Position in activePairs_ of the closest pair.
       mutable std::size_t minIndex_;
-      mutable Configuration_t latestArgument_;
-      mutable vector_t latestResult_;
+      /// Buffer of the lower bounds of the distance of the pairs.
+      mutable std::vector <std::pair <value_type, std::size_t> > bounds_;
+      /// Version of the kinematics cache results_ were computed at.
+      mutable std::size_t version_;
+      bool approximate_;
+      /// Request of the distance computations, see accuracy.
+      fcl::DistanceRequest request_;
+      /// Spheres covering each geometry of the active collision pairs, in
+      /// the frame of the geometry, indexed by geometry.
+      std::vector <BoundingSpheres_t> spheres_;
     }; // class DistanceBetweenBodies
   } // namespace constraints
 } // namespace hpp
@@ -0,0 +1,133 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_DISTANCE_BETWEEN_BODY_AND_FIELD_HH
+# define HPP_CONSTRAINTS_DISTANCE_BETWEEN_BODY_AND_FIELD_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/bounding-spheres.hh>
+# include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// Distance between the body of a joint and fixed objects represented
+    /// by a SignedDistanceField.
+    ///
+    /// This is a coarse alternative to DistanceBetweenBodies with fixed
+    /// objects. The body is covered by spheres and the function maps a
+    /// configuration to
+    /// \f$ \min_i \left( d(c_i) - r_i \right) \f$
+    /// where \f$ d \f$ is the signed distance of the field and
+    /// \f$ c_i, r_i \f$ the centers and radii of the spheres. The cost of
+    /// an evaluation is one lookup in the field per sphere, instead of the
+    /// exact distance between the meshes.
+    ///
+    /// The value is negative when a sphere penetrates the objects and never
+    /// exceeds the exact distance, up to the resolution of the field.
+    class HPP_CONSTRAINTS_DLLAPI DistanceBetweenBodyAndField :
+      public DifferentiableFunction
+    {
+    public:
+      /// Sphere in the frame of a joint.
+      typedef BoundingSphere Sphere;
+      typedef BoundingSpheres_t Spheres_t;
+
+      /// Create instance and return shared pointer
+      ///
+      /// \param name name of the constraint,
+      /// \param robot robot that own the body,
+      /// \param joint joint that holds the body,
+      /// \param field the fixed objects.
+      ///
+      /// The body is covered by boundingSpheres (joint).
+      static DistanceBetweenBodyAndFieldPtr_t create
+        (const std::string& name, const DevicePtr_t& robot,
+         const JointPtr_t& joint, const SignedDistanceFieldPtr_t& field);
+
+      /// Create instance and return shared pointer
+      ///
+      /// \param spheres spheres covering the body, in the joint frame.
+      static DistanceBetweenBodyAndFieldPtr_t create
+        (const std::string& name, const DevicePtr_t& robot,
+         const JointPtr_t& joint, const SignedDistanceFieldPtr_t& field,
+         const Spheres_t& spheres);
+
+      /// Spheres covering the objects of the body of a joint.
+      /// \sa coverWithSpheres
+      static Spheres_t boundingSpheres (const JointPtr_t& joint);
+
+      virtual ~DistanceBetweenBodyAndField () throw () {}
+
+      const Spheres_t& spheres () const
+      {
+        return spheres_;
+      }
+
+      const SignedDistanceFieldPtr_t& field () const
+      {
+        return field_;
+      }
+
+      virtual bool threadSafe () const
+      {
+        return true;
+      }
+
+      /// The cost grows with the number of spheres.
+      virtual value_type evaluationCost () const;
+
+    protected:
+      /// Protected constructor
+      ///
+      /// \param name name of the constraint,
+      /// \param robot robot that own the body,
+      /// \param joint joint that holds the body,
+      /// \param field the fixed objects,
+      /// \param spheres spheres covering the body, in the joint frame.
+      DistanceBetweenBodyAndField (const std::string& name,
+          const DevicePtr_t& robot, const JointPtr_t& joint,
+          const SignedDistanceFieldPtr_t& field, const Spheres_t& spheres);
+
+      virtual void impl_compute (vectorOut_t result,
+				 ConfigurationIn_t argument) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_compute (vectorOut_t result,
+				 ConfigurationIn_t argument,
+                                 Workspace& workspace) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg,
+                                  Workspace& workspace) const throw ();
+    private:
+      /// Find the closest sphere at the current placement of joint.
+      /// \retval jacobian the jacobian, if not NULL.
+      /// \return the distance.
+      value_type compute (const JointPtr_t& joint, matrixOut_t* jacobian)
+        const;
+
+      DevicePtr_t robot_;
+      KinematicsCachePtr_t kinematics_;
+      JointPtr_t joint_;
+      SignedDistanceFieldPtr_t field_;
+      Spheres_t spheres_;
+    }; // class DistanceBetweenBodyAndField
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_DISTANCE_BETWEEN_BODY_AND_FIELD_HH
@@ -0,0 +1,128 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_DISTANCE_BETWEEN_POINT_PAIRS_HH
+# define HPP_CONSTRAINTS_DISTANCE_BETWEEN_POINT_PAIRS_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Distances between several pairs of points
+    ///
+    /// Row \f$i\f$ of the function is the distance between the points of
+    /// pair \f$i\f$, as DistanceBetweenPointsInBodies. Each point is fixed
+    /// in a joint or, if the joint is NULL, in the world frame.
+    ///
+    /// All the pairs are computed in one pass: the forward kinematics is
+    /// computed once and the points are grouped by joint, so that
+    /// \f$R J\f$ is computed once per joint. No memory is allocated by the
+    /// evaluation.
+    class HPP_CONSTRAINTS_DLLAPI DistanceBetweenPointPairs :
+      public DifferentiableFunction
+    {
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      /// A pair of points.
+      struct PointPair
+      {
+        PointPair (const JointPtr_t& j1, const vector3_t& p1,
+            const JointPtr_t& j2, const vector3_t& p2) :
+          joint1 (j1), point1 (p1), joint2 (j2), point2 (p2) {}
+        /// Joint holding point1, NULL for the world frame.
+        JointPtr_t joint1;
+        /// Point in the frame of joint1.
+        vector3_t point1;
+        /// Joint holding point2, NULL for the world frame.
+        JointPtr_t joint2;
+        /// Point in the frame of joint2.
+        vector3_t point2;
+      };
+      typedef std::vector <PointPair> PointPairs_t;
+
+      /// Create instance and return shared pointer
+      ///
+      /// \param name name of the constraint,
+      /// \param robot robot that own the joints,
+      /// \param pairs the pairs of points.
+      static DistanceBetweenPointPairsPtr_t create
+	(const std::string& name, const DevicePtr_t& robot,
+         const PointPairs_t& pairs);
+
+      virtual ~DistanceBetweenPointPairs () throw () {}
+
+      const PointPairs_t& pairs () const
+      {
+        return pairs_;
+      }
+
+    protected:
+      /// Protected constructor
+      ///
+      /// \param name name of the constraint,
+      /// \param robot robot that own the joints,
+      /// \param pairs the pairs of points.
+      DistanceBetweenPointPairs (const std::string& name,
+				 const DevicePtr_t& robot,
+                                 const PointPairs_t& pairs);
+
+      virtual void impl_compute (vectorOut_t result,
+				 ConfigurationIn_t argument) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_valueAndJacobian (vectorOut_t result,
+                                          matrixOut_t jacobian,
+                                          ConfigurationIn_t arg) const;
+
+    private:
+      typedef Eigen::Matrix <value_type, 3, Eigen::Dynamic> Points_t;
+
+      /// Position of the points in the world frame.
+      void computePoints () const;
+      /// \f$R J\f$ of the joints.
+      void computeJointJacobians () const;
+      /// Index of a joint in joints_, creating it if needed.
+      /// \return noJoint for NULL.
+      std::size_t group (const JointPtr_t& joint);
+
+      static const std::size_t noJoint;
+
+      DevicePtr_t robot_;
+      KinematicsCachePtr_t kinematics_;
+      PointPairs_t pairs_;
+      /// Joints holding the points, without duplicates.
+      std::vector <JointPtr_t> joints_;
+      /// Index in joints_ of the joints of the pairs.
+      std::vector <std::size_t> group1_, group2_;
+      /// Rows 6j to 6j+3 contain \f$R J_{\mathbf{v}}\f$ of joint j and
+      /// rows 6j+3 to 6j+6 contain \f$R J_{\omega}\f$.
+      mutable matrix_t RJ_;
+      mutable Points_t global1_, global2_;
+      mutable std::size_t pointsVersion_, jacobianVersion_;
+    }; // class DistanceBetweenPointPairs
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_DISTANCE_BETWEEN_POINT_PAIRS_HH
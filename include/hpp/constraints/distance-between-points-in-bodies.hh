@@ -64,6 +64,10 @@ namespace hpp {
 
       virtual ~DistanceBetweenPointsInBodies () throw () {}
 
+      /// The distance does not depend on the frame it is measured in. It is
+      /// bounded by the velocity of point 1 relative to joint 2.
+      virtual value_type lipschitzConstant () const;
+
     protected:
       /// Protected constructor
       ///
@@ -96,6 +100,7 @@ namespace hpp {
 				  ConfigurationIn_t arg) const throw ();
     private:
       DevicePtr_t robot_;
+      KinematicsCachePtr_t kinematics_;
       JointPtr_t joint1_;
       JointPtr_t joint2_;
       vector3_t point1_;
@@ -0,0 +1,196 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_EVALUATION_SERVER_HH
+# define HPP_CONSTRAINTS_EVALUATION_SERVER_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/batch-evaluator.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Evaluate a set of functions for remote clients.
+    ///
+    /// The server reads batches of configurations from a file descriptor,
+    /// a socket connected to an EvaluationClient on another node or a pipe
+    /// to a worker process, evaluates the functions with a BatchEvaluator
+    /// and writes the values, and the jacobians if requested, back. The
+    /// robot and the functions are built once by the server, so that the
+    /// clients only send configurations.
+    ///
+    /// The messages are made of unsigned 64 bits integers (words) and
+    /// doubles, in the byte order of the machine. A request is
+    /// \li the 8 characters "HPPCEVL1",
+    /// \li 3 words: the size of a configuration, the number N of
+    ///     configurations and 1 if the jacobians are requested, 0
+    ///     otherwise,
+    /// \li the configurations, one after the other.
+    ///
+    /// The response starts with a word: 0 if the request was evaluated. It
+    /// is then followed by 2 words, the number of functions and whether the
+    /// jacobians follow, and the matrices BatchEvaluator::evaluate returns:
+    /// the values of each function and, if requested, the jacobians of each
+    /// function. Each
+    /// matrix is sent as 2 words, its numbers of rows and of columns,
+    /// followed by its coefficients in column major order. Otherwise the
+    /// first word is 1 and it is followed by the size of an error message
+    /// and the message.
+    ///
+    /// \code
+    ///   // on the server
+    ///   EvaluationServerPtr_t server = EvaluationServer::create
+    ///     (BatchEvaluator::create (robot, nbThreads), functions);
+    ///   server->serve (socket, socket);
+    ///   // on the client
+    ///   EvaluationClientPtr_t client = EvaluationClient::create
+    ///     (socket, socket);
+    ///   client->evaluate (configurations, values, &jacobians);
+    /// \endcode
+    ///
+    /// \note The robot and the functions are not serialized: the server
+    ///       builds them with the usual API before serving.
+    class HPP_CONSTRAINTS_DLLAPI EvaluationServer
+    {
+      public:
+        typedef BatchEvaluator::Functions_t Functions_t;
+
+        /// \param evaluator evaluator of the robot the functions are bound
+        ///        to,
+        /// \param functions functions evaluated for the clients. They must
+        ///        have the same input size.
+        /// \param maxBatch maximal number of configurations of a request.
+        ///        It bounds the memory a client can make the server
+        ///        allocate.
+        /// \throw std::invalid_argument if the input sizes differ or if
+        ///        maxBatch is not positive.
+        static EvaluationServerPtr_t create
+          (const BatchEvaluatorPtr_t& evaluator,
+           const Functions_t& functions, size_type maxBatch = 1024);
+
+        /// Process one request.
+        ///
+        /// The sizes of the request are checked before anything is
+        /// allocated. If the request is invalid (wrong header, wrong
+        /// configuration size or number of configurations not in
+        /// [1, maxBatch]), an error is sent to the client and false is
+        /// returned, as the rest of the request is not read: the caller
+        /// should close the connection. An error of the evaluation itself
+        /// is sent to the client, which can go on.
+        /// \param input, output file descriptors the request is read from
+        ///        and the response written to. They may be the same socket.
+        /// \return false if the input is closed before the request or if
+        ///         the request is invalid.
+        /// \throw std::runtime_error if the input or the output fail, or
+        ///        if the input is closed in the middle of the request.
+        bool process (int input, int output);
+
+        /// Process requests until the input is closed or a request is
+        /// invalid.
+        /// \return the number of processed requests.
+        std::size_t serve (int input, int output);
+
+        const Functions_t& functions () const
+        {
+          return functions_;
+        }
+
+        const BatchEvaluatorPtr_t& evaluator () const
+        {
+          return evaluator_;
+        }
+
+        /// Maximal number of configurations of a request.
+        size_type maxBatch () const
+        {
+          return maxBatch_;
+        }
+
+        /// Number of configurations evaluated so far.
+        std::size_t nbConfigurations () const
+        {
+          return nbConfigurations_;
+        }
+
+      private:
+        EvaluationServer (const BatchEvaluatorPtr_t& evaluator,
+            const Functions_t& functions, size_type maxBatch);
+
+        BatchEvaluatorPtr_t evaluator_;
+        Functions_t functions_;
+        size_type inputSize_, maxBatch_;
+        std::size_t nbConfigurations_;
+        matrix_t configurations_;
+        std::vector <matrix_t> values_, jacobians_;
+    }; // class EvaluationServer
+
+    /// Client of an EvaluationServer.
+    ///
+    /// The client does not own the file descriptors: they are not closed
+    /// when it is destroyed.
+    class HPP_CONSTRAINTS_DLLAPI EvaluationClient
+    {
+      public:
+        /// \param input, output file descriptors the responses are read
+        ///        from and the requests written to.
+        /// \param maxSize maximal number of coefficients of a received
+        ///        matrix, and of characters of an error message.
+        /// \throw std::invalid_argument if maxSize is not positive.
+        static EvaluationClientPtr_t create (int input, int output,
+            size_type maxSize = 1 << 24);
+
+        /// Send a request.
+        /// Several requests may be sent before their responses are
+        /// received, to overlap the communications with the evaluations.
+        /// \param configurations one configuration per column.
+        /// \param jacobians whether the jacobians are requested.
+        /// \throw std::runtime_error if the output fails.
+        void send (matrixIn_t configurations, bool jacobians);
+
+        /// Receive the response of the oldest request.
+        /// \retval values, jacobians as BatchEvaluator::evaluate. jacobians
+        ///         is left unchanged if they were not requested.
+        /// \throw std::runtime_error if the input fails, if the server
+        ///        cannot evaluate the request or if a received matrix is
+        ///        larger than maxSize.
+        void receive (std::vector <matrix_t>& values,
+            std::vector <matrix_t>* jacobians = NULL);
+
+        /// Send a request and receive its response.
+        void evaluate (matrixIn_t configurations,
+            std::vector <matrix_t>& values,
+            std::vector <matrix_t>* jacobians = NULL)
+        {
+          send (configurations, jacobians != NULL);
+          receive (values, jacobians);
+        }
+
+      private:
+        EvaluationClient (int input, int output, size_type maxSize);
+
+        int input_, output_;
+        size_type maxSize_;
+    }; // class EvaluationClient
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_EVALUATION_SERVER_HH
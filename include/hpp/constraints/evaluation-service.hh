@@ -0,0 +1,114 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_EVALUATION_SERVICE_HH
+# define HPP_CONSTRAINTS_EVALUATION_SERVICE_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Evaluate functions on behalf of several threads, by batches.
+    ///
+    /// Each thread calls evaluate with a single configuration. The request
+    /// is pushed onto a lock-free queue and one of the waiting threads, the
+    /// combiner, takes all the queued requests at once, groups them by
+    /// function and evaluates each group with
+    /// DifferentiableFunction::valueBatch and
+    /// DifferentiableFunction::jacobianBatch. The other threads wait until
+    /// their request is done, or become the combiner of the next batch.
+    ///
+    /// Since only one thread evaluates at a time, the functions need not be
+    /// thread safe, provided all the threads evaluate them through the
+    /// same service.
+    ///
+    /// \code
+    ///   // shared by the planner threads
+    ///   EvaluationServicePtr_t service = EvaluationService::create ();
+    ///   // in each thread
+    ///   service->evaluate (*stack, q, value, jacobian);
+    /// \endcode
+    class HPP_CONSTRAINTS_DLLAPI EvaluationService
+    {
+      public:
+        static EvaluationServicePtr_t create ();
+
+        /// Evaluate the function.
+        /// Returns when the value is computed.
+        void evaluate (const DifferentiableFunction& function,
+            vectorIn_t argument, vectorOut_t value);
+
+        /// Evaluate the function and its jacobian.
+        /// Returns when the value and the jacobian are computed.
+        void evaluate (const DifferentiableFunction& function,
+            vectorIn_t argument, vectorOut_t value, matrixOut_t jacobian);
+
+        /// Number of batches evaluated so far.
+        std::size_t nbBatches () const
+        {
+          return nbBatches_;
+        }
+
+        /// Number of requests evaluated so far.
+        std::size_t nbRequests () const
+        {
+          return nbRequests_;
+        }
+
+      private:
+        struct Request
+        {
+          const DifferentiableFunction* function;
+          const vectorIn_t* argument;
+          vectorOut_t* value;
+          matrixOut_t* jacobian;
+          Request* next;
+          volatile int done;
+        };
+        typedef std::vector <Request*> Requests_t;
+
+        EvaluationService ();
+
+        void submit (Request& request);
+        /// Evaluate the queued requests.
+        void combine ();
+        /// Evaluate requests [begin, end[, that share the same function.
+        void evaluate (Requests_t::const_iterator begin,
+            Requests_t::const_iterator end);
+
+        /// Last pushed request. The queued requests are linked through
+        /// Request::next.
+        Request* volatile head_;
+        /// Whether a thread is combining.
+        volatile int busy_;
+
+        // Used by the combiner only.
+        Requests_t batch_;
+        matrix_t arguments_, values_, jacobians_;
+        std::size_t nbBatches_, nbRequests_;
+    }; // class EvaluationService
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_EVALUATION_SERVICE_HH
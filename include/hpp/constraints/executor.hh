@@ -0,0 +1,209 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_EXECUTOR_HH
+# define HPP_CONSTRAINTS_EXECUTOR_HH
+
+# include <vector>
+
+# include <pthread.h>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Result of an evaluation submitted to an Executor.
+    ///
+    /// The evaluation starts in the background when Executor::run is
+    /// called. Waiting for an evaluation that was not started runs the
+    /// pending evaluations of the executor first.
+    ///
+    /// \sa DifferentiableFunction::evaluateAsync
+    class HPP_CONSTRAINTS_DLLAPI EvaluationFuture
+    {
+      public:
+        /// Build an invalid future.
+        EvaluationFuture () {}
+
+        /// Whether the future refers to an evaluation.
+        bool valid () const
+        {
+          return state_.get () != NULL;
+        }
+
+        /// Whether the evaluation is done. It does not block.
+        bool ready () const;
+
+        /// Wait for the evaluation.
+        void wait () const;
+
+        /// Value of the function. Wait for the evaluation.
+        const vector_t& value () const
+        {
+          wait ();
+          return state_->value;
+        }
+
+        /// Jacobian of the function. Wait for the evaluation.
+        /// \note it is empty if the jacobian was not requested.
+        const matrix_t& jacobian () const
+        {
+          wait ();
+          return state_->jacobian;
+        }
+
+      private:
+        struct State
+        {
+          const DifferentiableFunction* function;
+          Executor* executor;
+          vector_t argument, value;
+          matrix_t jacobian;
+          bool computeJacobian;
+          /// Whether Executor::run took the evaluation, accessed by the
+          /// thread owning the executor only.
+          bool started;
+          /// Whether the evaluation is done, guarded by the mutex of the
+          /// executor.
+          bool ready;
+        };
+        typedef boost::shared_ptr <State> StatePtr_t;
+
+        EvaluationFuture (const StatePtr_t& state) : state_ (state) {}
+
+        StatePtr_t state_;
+
+        friend class Executor;
+    }; // class EvaluationFuture
+
+    /// Run evaluations of functions in the background, on a pool of
+    /// threads.
+    ///
+    /// Evaluations are submitted first, then started all at once by run,
+    /// which returns immediately. The thread owning the executor continues
+    /// its own work and waits for the results through the futures. The
+    /// batch is evaluated by a worker thread, the most expensive
+    /// evaluations first (see DifferentiableFunction::evaluationCost), so
+    /// that the duration of a batch is bounded by its slowest evaluation
+    /// rather than by the sum of the evaluations, provided there are
+    /// enough threads. Each future is ready as soon as its own evaluation
+    /// is done.
+    ///
+    /// Thread safe functions are evaluated with one Workspace per thread.
+    /// The other functions use their own data and the robot they were
+    /// created with: they are evaluated one after the other by a single
+    /// thread, concurrently with the thread safe ones.
+    ///
+    /// \code
+    ///   ExecutorPtr_t executor = Executor::create (robot, 4);
+    ///   EvaluationFuture d = distance->evaluateAsync (q, *executor);
+    ///   EvaluationFuture s = stability->evaluateAsync (q, *executor);
+    ///   executor->run ();
+    ///   // Work of the caller, overlapping the evaluations.
+    ///   d.value (); s.jacobian ();
+    /// \endcode
+    ///
+    /// \note the evaluations of a batch run in parallel only if the library
+    ///       is compiled with OpenMP. Otherwise, the worker thread evaluates
+    ///       them sequentially, still concurrently with the caller.
+    /// \warning submit, run and wait must be called by the thread owning
+    ///          the executor. Until a batch is done, this thread must not
+    ///          evaluate the functions that are not thread safe, nor use the
+    ///          robot they were created with. The functions must outlive the
+    ///          pending evaluations and the executor must outlive its
+    ///          futures.
+    class HPP_CONSTRAINTS_DLLAPI Executor
+    {
+      public:
+        /// Create an executor.
+        /// \param robot the robot the functions are bound to. One Workspace
+        ///        of this robot is created per thread.
+        /// \param nbThreads number of threads evaluating a batch.
+        static ExecutorPtr_t create (const DevicePtr_t& robot,
+            std::size_t nbThreads);
+
+        /// Wait for the running batch.
+        ~Executor ();
+
+        /// Submit an evaluation. It starts at the next call to run.
+        /// \param argument the configuration is copied.
+        /// \param computeJacobian whether the jacobian is computed as well.
+        EvaluationFuture submit (const DifferentiableFunction& function,
+            vectorIn_t argument, bool computeJacobian = true);
+
+        /// Start the pending evaluations in the background and return.
+        /// If the previous batch is still running, wait for it first.
+        void run ();
+
+        /// Wait for the evaluations started by run.
+        void wait ();
+
+        /// Number of evaluations that are not started.
+        std::size_t pending () const
+        {
+          return pending_.size ();
+        }
+
+        std::size_t nbThreads () const
+        {
+          return workspaces_.size ();
+        }
+
+      private:
+        typedef EvaluationFuture::StatePtr_t StatePtr_t;
+        typedef std::vector <StatePtr_t> States_t;
+
+        Executor (const DevicePtr_t& robot, std::size_t nbThreads);
+        Executor (const Executor&);
+        Executor& operator= (const Executor&);
+
+        /// Entry point of the worker thread.
+        static void* work (void* executor);
+
+        /// Evaluate parallel_ and sequential_.
+        void evaluateBatch ();
+
+        void evaluate (EvaluationFuture::State& state, Workspace* workspace);
+
+        bool ready (const EvaluationFuture::State& state) const;
+        void wait (const EvaluationFuture::State& state);
+
+        std::vector <WorkspacePtr_t> workspaces_;
+        States_t pending_;
+        /// Evaluations of the running batch, of thread safe functions and
+        /// of the other functions, sorted by decreasing cost. They are
+        /// accessed by the worker thread only while it runs.
+        States_t parallel_, sequential_;
+        /// Worker thread of the running batch, if running_.
+        pthread_t worker_;
+        bool running_;
+        /// Guards EvaluationFuture::State::ready.
+        mutable pthread_mutex_t mutex_;
+        /// Signaled when an evaluation is done.
+        pthread_cond_t done_;
+
+        friend class EvaluationFuture;
+    }; // class Executor
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_EXECUTOR_HH
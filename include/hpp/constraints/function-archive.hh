@@ -0,0 +1,84 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_FUNCTION_ARCHIVE_HH
+# define HPP_CONSTRAINTS_FUNCTION_ARCHIVE_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/convex-shape.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Save the definitions of functions to a binary file and create them
+    /// again from the file.
+    ///
+    /// Loading a file avoids computing the geometry of the convex shapes
+    /// again, and building the functions through the applications that
+    /// define them. The supported functions are
+    /// \li the GenericTransformation: the joints, the frames, the mask and
+    ///     useQuaternion,
+    /// \li ConfigurationConstraint: the goal and the weights,
+    /// \li ConvexShapeContact: the shapes with their normals and edges, the
+    ///     joints and the margins,
+    /// \li DifferentiableFunctionStack: the functions of the stack.
+    /// A function saved several times, in several stacks for instance, is
+    /// created once by load, and so are the geometries shared by several
+    /// shapes. The joints are saved by name, so that a file can be loaded
+    /// on another instance of the robot.
+    ///
+    /// The file starts with the 8 characters "HPPCFUN1" and a version
+    /// number. Numbers are unsigned 64 bits integers and doubles, in the byte
+    /// order of the machine. The file is mapped in memory by load.
+    class HPP_CONSTRAINTS_DLLAPI FunctionArchive
+    {
+      public:
+        typedef std::vector <DifferentiableFunctionPtr_t> Functions_t;
+
+        /// Write the definitions of functions to a file.
+        /// \throw std::invalid_argument if a function is not supported,
+        /// \throw std::runtime_error if the file cannot be written.
+        static void save (const std::string& filename,
+            const Functions_t& functions);
+
+        /// Create the functions saved in a file.
+        /// \param robot the robot the functions are bound to.
+        /// \throw std::runtime_error if the file cannot be read, is not an
+        ///        archive of this version, or refers to a joint that the
+        ///        robot does not have.
+        static Functions_t load (const std::string& filename,
+            const DevicePtr_t& robot);
+
+      private:
+        struct Writer;
+        struct Reader;
+
+        /// Write the geometry, or its index if it was already written.
+        static void write (Writer& writer,
+            const ConvexShapeGeometryPtr_t& geometry);
+        /// Read a geometry written by write.
+        static ConvexShapeGeometryPtr_t readGeometry (Reader& reader);
+    }; // class FunctionArchive
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_FUNCTION_ARCHIVE_HH
@@ -0,0 +1,149 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_FUNCTION_REGISTRY_HH
+# define HPP_CONSTRAINTS_FUNCTION_REGISTRY_HH
+
+# include <map>
+# include <typeinfo>
+# include <vector>
+
+# include <boost/assign/list_of.hpp>
+
+# include <hpp/pinocchio/joint.hh>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/generic-transformation.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Share the functions with identical definitions.
+    ///
+    /// The methods of this class take the arguments of the create method
+    /// of a class of function. The first call with a definition creates
+    /// the function, the next calls with the same definition return the
+    /// same instance as long as it is used. The key of a definition is
+    /// made of the class, the robot, the joints and the exact values of
+    /// the frames, references and masks. The name is not part of the key:
+    /// a shared instance keeps the name of its first definition.
+    ///
+    /// A constraint graph builder creating the same RelativeTransformation
+    /// for many edges then holds one instance, and a
+    /// DifferentiableFunctionStack evaluating several stacks that contain
+    /// it evaluates it once, see DifferentiableFunctionStack::flatten.
+    ///
+    /// \warning a shared instance must not be modified, for instance with
+    ///          GenericTransformation::reference, since the modification
+    ///          applies to all the definitions.
+    class HPP_CONSTRAINTS_DLLAPI FunctionRegistry
+    {
+      public:
+        /// Return a shared pointer to a new instance
+        static FunctionRegistryPtr_t create ();
+
+        /// Get the GenericTransformation of a definition.
+        /// \tparam T one of Position, Orientation, Transformation and the
+        ///         relative versions.
+        /// \param joint1 must be NULL if T is not relative.
+        /// Other parameters as in GenericTransformation::create.
+        template <typename T> boost::shared_ptr <T> transformation
+          (const std::string& name, const DevicePtr_t& robot,
+           const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
+           const Transform3f& frame1, const Transform3f& frame2,
+           std::vector <bool> mask = std::vector <bool> (T::ValueSize, true))
+        {
+          assert (T::IsRelative || !joint1);
+          Key key (typeid (T), robot);
+          key.add (joint1);
+          key.add (joint2);
+          key.add (frame1);
+          key.add (frame2);
+          key.add (mask);
+          boost::shared_ptr <T> f =
+            boost::static_pointer_cast <T> (find (key));
+          if (f) return f;
+          if (T::IsRelative)
+            f = T::create (name, robot, joint1, joint2, frame1, frame2, mask);
+          else
+            f = T::create (name, robot, joint2, frame2, frame1, mask);
+          insert (key, f);
+          return f;
+        }
+
+        /// Get the RelativeCom of a definition.
+        /// See RelativeCom::create.
+        RelativeComPtr_t relativeCom (const DevicePtr_t& robot,
+            const CenterOfMassComputationPtr_t& comc,
+            const JointPtr_t& joint, const vector3_t& reference,
+            std::vector <bool> mask =
+            boost::assign::list_of (true)(true)(true));
+
+        /// Get the ConfigurationConstraint of a definition.
+        /// See ConfigurationConstraint::create.
+        ConfigurationConstraintPtr_t configurationConstraint
+          (const std::string& name, const DevicePtr_t& robot,
+           ConfigurationIn_t goal,
+           std::vector <bool> mask = std::vector <bool> (0));
+
+        /// Get the ConfigurationConstraint of a definition.
+        /// See ConfigurationConstraint::create.
+        ConfigurationConstraintPtr_t configurationConstraint
+          (const std::string& name, const DevicePtr_t& robot,
+           ConfigurationIn_t goal, const vector_t& weights);
+
+        /// Number of definitions whose function is still used.
+        std::size_t size () const;
+
+      private:
+        /// Definition of a function.
+        struct Key
+        {
+          Key (const std::type_info& t, const DevicePtr_t& robot);
+
+          void add (const JointConstPtr_t& joint);
+          void add (const Transform3f& M);
+          void add (const std::vector <bool>& mask);
+          void add (vectorIn_t v);
+          void add (const void* object);
+
+          bool operator< (const Key& other) const;
+
+          const std::type_info* type;
+          std::vector <const void*> objects;
+          std::vector <value_type> numbers;
+        }; // struct Key
+        typedef std::map <Key, DifferentiableFunctionWkPtr_t> Functions_t;
+
+        FunctionRegistry () {}
+
+        /// The function of a definition, NULL if there is none.
+        DifferentiableFunctionPtr_t find (const Key& key) const;
+        /// Register the function of a definition and remove the functions
+        /// that are not used anymore.
+        void insert (const Key& key, const DifferentiableFunctionPtr_t& f);
+
+        Functions_t functions_;
+    }; // class FunctionRegistry
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_FUNCTION_REGISTRY_HH
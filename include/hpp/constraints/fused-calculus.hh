@@ -0,0 +1,522 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_FUSED_CALCULUS_HH
+# define HPP_CONSTRAINTS_FUSED_CALCULUS_HH
+
+# include <hpp/pinocchio/joint.hh>
+# include <hpp/pinocchio/device.hh>
+# include <hpp/pinocchio/center-of-mass-computation.hh>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/tools.hh>
+# include <hpp/constraints/symbolic-calculus.hh>
+# include <hpp/constraints/center-of-mass-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// Expression templates with fused evaluation.
+    ///
+    /// This is a stack allocated counterpart of the classes of
+    /// symbolic-calculus.hh. Operators return objects whose type describes
+    /// the whole expression. The sub-expressions are stored by value, so
+    /// the evaluation does not follow pointers and does not allocate memory.
+    ///
+    /// The jacobian is computed in reverse mode: each node passes to its
+    /// children the fixed size matrix by which their jacobian is multiplied
+    /// and only the leaves multiply the jacobian of a joint. No
+    /// intermediate 3xN jacobian is stored, and computing one row of the
+    /// jacobian of a vector expression costs one row per leaf.
+    ///
+    /// \code
+    ///   fused::PointInJoint left (jointL, pointL), right (jointR, pointR);
+    ///   fused::PointCom com (comc);
+    ///   // The operators build the type of e.
+    ///   typedef fused::PointInJoint P_t;
+    ///   fused::CrossProduct <fused::Difference <fused::PointCom,
+    ///     fused::ScalarMultiply <fused::Sum <P_t, P_t> > >,
+    ///     fused::Difference <P_t, P_t> > e =
+    ///       (com - 0.5 * (left + right)) ^ (right - left);
+    ///   e.jacobian (J); // computes e.value () as well.
+    /// \endcode
+    ///
+    /// \note Sub-expressions are copied, not shared: a leaf used twice is
+    ///       evaluated twice.
+    ///
+    /// fused::Calculus wraps an expression in a CalculusBase, so that it
+    /// can be used with SymbolicFunction.
+    namespace fused {
+      /// \addtogroup symbolic_calculus
+      /// \{
+
+      /// Base class of the expressions.
+      ///
+      /// Derived classes implement
+      /// \li void impl_compute (bool jacobian) const, that computes the value
+      ///     of the children, if any, and sets value_,
+      /// \li template <int R> void impl_addJacobian
+      ///     (const Eigen::Matrix<value_type, R, Rows>& A, matrixOut_t J)
+      ///     const, that adds A times the jacobian of the expression to J.
+      template <typename Derived, int _Rows = 3> class Expression
+      {
+        public:
+          enum { Rows = _Rows };
+          typedef Eigen::Matrix<value_type, Rows, 1> Value_t;
+
+          const Derived& derived () const
+          {
+            return static_cast <const Derived&> (*this);
+          }
+
+          /// Value of the expression, computed by the latest call to
+          /// compute.
+          const Value_t& value () const
+          {
+            return value_;
+          }
+
+          /// Compute the value of the expression.
+          /// \param jacobian whether addJacobian is called afterwards.
+          void compute (bool jacobian) const
+          {
+            derived ().impl_compute (jacobian);
+          }
+
+          /// Add A times the jacobian of the expression to J.
+          /// \pre compute (true) has been called.
+          template <int R> void addJacobian
+            (const Eigen::Matrix<value_type, R, Rows>& A, matrixOut_t J) const
+          {
+            derived ().impl_addJacobian (A, J);
+          }
+
+          /// Compute the value and the jacobian of the expression.
+          void jacobian (matrixOut_t J) const
+          {
+            assert (J.rows () == Rows);
+            compute (true);
+            J.setZero ();
+            const Eigen::Matrix<value_type, Rows, Rows> I
+              (Eigen::Matrix<value_type, Rows, Rows>::Identity ());
+            addJacobian (I, J);
+          }
+
+        protected:
+          mutable Value_t value_;
+      }; // class Expression
+
+      /// Sum of two expressions.
+      template <typename Lhs, typename Rhs>
+      class Sum : public Expression <Sum <Lhs, Rhs>, Lhs::Rows>
+      {
+        public:
+          enum { Rows = Lhs::Rows };
+
+          Sum (const Lhs& lhs, const Rhs& rhs) : lhs_ (lhs), rhs_ (rhs) {}
+
+          void impl_compute (bool jacobian) const
+          {
+            lhs_.compute (jacobian);
+            rhs_.compute (jacobian);
+            this->value_ = lhs_.value () + rhs_.value ();
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, Rows>& A, matrixOut_t J) const
+          {
+            lhs_.addJacobian (A, J);
+            rhs_.addJacobian (A, J);
+          }
+
+          Lhs lhs_;
+          Rhs rhs_;
+      };
+
+      /// Difference of two expressions.
+      template <typename Lhs, typename Rhs>
+      class Difference : public Expression <Difference <Lhs, Rhs>, Lhs::Rows>
+      {
+        public:
+          enum { Rows = Lhs::Rows };
+
+          Difference (const Lhs& lhs, const Rhs& rhs) : lhs_ (lhs), rhs_ (rhs)
+          {}
+
+          void impl_compute (bool jacobian) const
+          {
+            lhs_.compute (jacobian);
+            rhs_.compute (jacobian);
+            this->value_ = lhs_.value () - rhs_.value ();
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, Rows>& A, matrixOut_t J) const
+          {
+            lhs_.addJacobian (A, J);
+            const Eigen::Matrix<value_type, R, Rows> mA (- A);
+            rhs_.addJacobian (mA, J);
+          }
+
+          Lhs lhs_;
+          Rhs rhs_;
+      };
+
+      /// Multiplication of an expression by a scalar.
+      template <typename Rhs>
+      class ScalarMultiply : public Expression <ScalarMultiply <Rhs>, Rhs::Rows>
+      {
+        public:
+          enum { Rows = Rhs::Rows };
+
+          ScalarMultiply (const value_type& scalar, const Rhs& rhs) :
+            scalar_ (scalar), rhs_ (rhs) {}
+
+          void impl_compute (bool jacobian) const
+          {
+            rhs_.compute (jacobian);
+            this->value_ = scalar_ * rhs_.value ();
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, Rows>& A, matrixOut_t J) const
+          {
+            const Eigen::Matrix<value_type, R, Rows> sA (scalar_ * A);
+            rhs_.addJacobian (sA, J);
+          }
+
+          value_type scalar_;
+          Rhs rhs_;
+      };
+
+      /// Cross product of two expressions.
+      template <typename Lhs, typename Rhs>
+      class CrossProduct : public Expression <CrossProduct <Lhs, Rhs> >
+      {
+        public:
+          CrossProduct (const Lhs& lhs, const Rhs& rhs) :
+            lhs_ (lhs), rhs_ (rhs) {}
+
+          void impl_compute (bool jacobian) const
+          {
+            lhs_.compute (jacobian);
+            rhs_.compute (jacobian);
+            this->value_ = lhs_.value ().cross (rhs_.value ());
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 3>& A, matrixOut_t J) const
+          {
+            // d (l x r) = [l]x dr - [r]x dl
+            matrix3_t X;
+            computeCrossMatrix (rhs_.value (), X);
+            const Eigen::Matrix<value_type, R, 3> Al (- A * X);
+            lhs_.addJacobian (Al, J);
+            computeCrossMatrix (lhs_.value (), X);
+            const Eigen::Matrix<value_type, R, 3> Ar (A * X);
+            rhs_.addJacobian (Ar, J);
+          }
+
+          Lhs lhs_;
+          Rhs rhs_;
+      };
+
+      /// Scalar product of two expressions.
+      template <typename Lhs, typename Rhs>
+      class ScalarProduct : public Expression <ScalarProduct <Lhs, Rhs>, 1>
+      {
+        public:
+          enum { Rows = 1 };
+
+          ScalarProduct (const Lhs& lhs, const Rhs& rhs) :
+            lhs_ (lhs), rhs_ (rhs) {}
+
+          void impl_compute (bool jacobian) const
+          {
+            lhs_.compute (jacobian);
+            rhs_.compute (jacobian);
+            this->value_[0] = lhs_.value ().dot (rhs_.value ());
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 1>& A, matrixOut_t J) const
+          {
+            const Eigen::Matrix<value_type, R, 3> Al (A * rhs_.value ().transpose ());
+            lhs_.addJacobian (Al, J);
+            const Eigen::Matrix<value_type, R, 3> Ar (A * lhs_.value ().transpose ());
+            rhs_.addJacobian (Ar, J);
+          }
+
+          Lhs lhs_;
+          Rhs rhs_;
+      };
+
+      /// Multiplication of an expression by the rotation of a joint, or by
+      /// its transpose.
+      template <typename Rhs>
+      class RotationMultiply : public Expression <RotationMultiply <Rhs> >
+      {
+        public:
+          RotationMultiply (const JointPtr_t& joint, const Rhs& rhs,
+              bool transpose = false) :
+            joint_ (joint), transpose_ (transpose), rhs_ (rhs)
+          {
+            assert (joint_);
+          }
+
+          void impl_compute (bool jacobian) const
+          {
+            rhs_.compute (jacobian);
+            const matrix3_t& R = joint_->currentTransformation ().rotation ();
+            if (transpose_) this->value_.noalias() = R.transpose () * rhs_.value ();
+            else            this->value_.noalias() = R * rhs_.value ();
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 3>& A, matrixOut_t J) const
+          {
+            const JointJacobian_t& Jj (joint_->jacobian ());
+            const matrix3_t& Rot = joint_->currentTransformation ().rotation ();
+            matrix3_t X;
+            if (transpose_) {
+              // d (RT e) = RT [e]x R Jw + RT de
+              const Eigen::Matrix<value_type, R, 3> ART (A * Rot.transpose ());
+              computeCrossMatrix (rhs_.value (), X);
+              J.leftCols (Jj.cols ()).noalias() +=
+                (ART * X * Rot) * Jj.template bottomRows<3> ();
+              rhs_.addJacobian (ART, J);
+            } else {
+              // d (R e) = - [R e]x R Jw + R de
+              computeCrossMatrix (this->value_, X);
+              J.leftCols (Jj.cols ()).noalias() -=
+                (A * X * Rot) * Jj.template bottomRows<3> ();
+              const Eigen::Matrix<value_type, R, 3> AR (A * Rot);
+              rhs_.addJacobian (AR, J);
+            }
+          }
+
+          JointPtr_t joint_;
+          bool transpose_;
+          Rhs rhs_;
+      };
+
+      /// Point fixed in a joint frame.
+      class PointInJoint : public Expression <PointInJoint>
+      {
+        public:
+          PointInJoint (const JointPtr_t& joint, const vector3_t& local) :
+            joint_ (joint), local_ (local), center_ (local.isZero ())
+          {
+            assert (joint_);
+          }
+
+          void impl_compute (bool) const
+          {
+            this->value_ = joint_->currentTransformation ().act (local_);
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 3>& A, matrixOut_t J) const
+          {
+            // J = R Jv - [R l]x R Jw
+            const JointJacobian_t& Jj (joint_->jacobian ());
+            const Transform3f& M = joint_->currentTransformation ();
+            J.leftCols (Jj.cols ()).noalias() +=
+              (A * M.rotation ()) * Jj.template topRows<3> ();
+            if (!center_) {
+              matrix3_t X;
+              computeCrossMatrix (this->value_ - M.translation (), X);
+              J.leftCols (Jj.cols ()).noalias() -=
+                (A * X * M.rotation ()) * Jj.template bottomRows<3> ();
+            }
+          }
+
+          JointPtr_t joint_;
+          vector3_t local_;
+          bool center_;
+      };
+
+      /// Vector fixed in a joint frame.
+      class VectorInJoint : public Expression <VectorInJoint>
+      {
+        public:
+          VectorInJoint (const JointPtr_t& joint, const vector3_t& vector) :
+            joint_ (joint), vector_ (vector)
+          {
+            assert (joint_);
+          }
+
+          void impl_compute (bool) const
+          {
+            this->value_.noalias() =
+              joint_->currentTransformation ().rotation () * vector_;
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 3>& A, matrixOut_t J) const
+          {
+            // J = - [R v]x R Jw
+            const JointJacobian_t& Jj (joint_->jacobian ());
+            matrix3_t X;
+            computeCrossMatrix (this->value_, X);
+            J.leftCols (Jj.cols ()).noalias() -=
+              (A * X * joint_->currentTransformation ().rotation ())
+              * Jj.template bottomRows<3> ();
+          }
+
+          JointPtr_t joint_;
+          vector3_t vector_;
+      };
+
+      /// Point fixed in the world frame.
+      class Point : public Expression <Point>
+      {
+        public:
+          Point (const vector3_t& point)
+          {
+            this->value_ = point;
+          }
+
+          void impl_compute (bool) const {}
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 3>&, matrixOut_t) const {}
+      };
+
+      /// Center of mass.
+      class PointCom : public Expression <PointCom>
+      {
+        public:
+          PointCom (const CenterOfMassComputationPtr_t& comc) : comc_ (comc)
+          {
+            assert (comc_);
+          }
+
+          PointCom (const CenterOfMassCachePtr_t& cache) :
+            comc_ (cache->computation ()), cache_ (cache)
+          {
+            assert (comc_);
+          }
+
+          void impl_compute (bool jacobian) const
+          {
+            const Device::Computation_t flag =
+              jacobian ? Device::ALL : Device::COM;
+            if (cache_) cache_->compute (flag);
+            else        comc_->compute (flag);
+            this->value_ = comc_->com ();
+          }
+          template <int R> void impl_addJacobian
+            (const Eigen::Matrix<value_type, R, 3>& A, matrixOut_t J) const
+          {
+            const ComJacobian_t& Jc (comc_->jacobian ());
+            J.leftCols (Jc.cols ()).noalias() += A * Jc;
+          }
+
+          CenterOfMassComputationPtr_t comc_;
+          CenterOfMassCachePtr_t cache_;
+      };
+
+      template <typename Lhs, int LRows, typename Rhs, int RRows>
+      Sum <Lhs, Rhs> operator+ (const Expression <Lhs, LRows>& lhs,
+          const Expression <Rhs, RRows>& rhs)
+      {
+        return Sum <Lhs, Rhs> (lhs.derived (), rhs.derived ());
+      }
+
+      template <typename Lhs, int LRows, typename Rhs, int RRows>
+      Difference <Lhs, Rhs> operator- (const Expression <Lhs, LRows>& lhs,
+          const Expression <Rhs, RRows>& rhs)
+      {
+        return Difference <Lhs, Rhs> (lhs.derived (), rhs.derived ());
+      }
+
+      template <typename Lhs, typename Rhs>
+      CrossProduct <Lhs, Rhs> operator^ (const Expression <Lhs>& lhs,
+          const Expression <Rhs>& rhs)
+      {
+        return CrossProduct <Lhs, Rhs> (lhs.derived (), rhs.derived ());
+      }
+
+      template <typename Lhs, typename Rhs>
+      ScalarProduct <Lhs, Rhs> operator* (const Expression <Lhs>& lhs,
+          const Expression <Rhs>& rhs)
+      {
+        return ScalarProduct <Lhs, Rhs> (lhs.derived (), rhs.derived ());
+      }
+
+      template <typename Rhs, int RRows>
+      ScalarMultiply <Rhs> operator* (const value_type& scalar,
+          const Expression <Rhs, RRows>& rhs)
+      {
+        return ScalarMultiply <Rhs> (scalar, rhs.derived ());
+      }
+
+      template <typename Rhs>
+      RotationMultiply <Rhs> operator* (const JointPtr_t& joint,
+          const Expression <Rhs>& rhs)
+      {
+        return RotationMultiply <Rhs> (joint, rhs.derived ());
+      }
+
+      template <typename Rhs>
+      RotationMultiply <Rhs> operator* (const JointTranspose& joint,
+          const Expression <Rhs>& rhs)
+      {
+        return RotationMultiply <Rhs> (joint.j_, rhs.derived (), true);
+      }
+
+      /// Wrap an expression in a CalculusBase.
+      ///
+      /// The jacobian is computed in the storage of the CalculusBase, so
+      /// that the expression can be used with SymbolicFunction:
+      /// \code
+      ///   typedef fused::Calculus <Expr_t> Calculus_t;
+      ///   SymbolicFunction<Calculus_t>::Ptr_t f =
+      ///     SymbolicFunction<Calculus_t>::create (name, robot,
+      ///         Calculus_t::create (expr, robot->numberDof ()));
+      /// \endcode
+      template <typename E>
+      class Calculus : public CalculusBase <Calculus <E>, typename E::Value_t,
+                         Eigen::Matrix <value_type, E::Rows, Eigen::Dynamic> >
+      {
+        public:
+          typedef CalculusBase <Calculus <E>, typename E::Value_t,
+                  Eigen::Matrix <value_type, E::Rows, Eigen::Dynamic> >
+                    Parent_t;
+
+          HPP_CONSTRAINTS_CB_CREATE2 (Calculus, const E&, const size_type&)
+
+          Calculus (const E& expression, const size_type& nbDof) :
+            expression_ (expression)
+          {
+            this->jacobian_.resize (E::Rows, nbDof);
+          }
+
+          const E& expression () const
+          {
+            return expression_;
+          }
+
+          void impl_value ()
+          {
+            expression_.compute (false);
+            this->value_ = expression_.value ();
+          }
+          void impl_jacobian ()
+          {
+            expression_.jacobian (this->jacobian_);
+          }
+
+        private:
+          E expression_;
+      };
+      /// \}
+    } // namespace fused
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_FUSED_CALCULUS_HH
@@ -31,6 +31,7 @@ namespace hpp {
     typedef pinocchio::value_type value_type;
     typedef pinocchio::JointPtr_t JointPtr_t;
     typedef pinocchio::JointConstPtr_t JointConstPtr_t;
+    typedef pinocchio::JointVector_t JointVector_t;
     typedef pinocchio::vector3_t vector3_t;
     typedef pinocchio::matrix3_t matrix3_t;
     typedef pinocchio::matrix_t matrix_t;
@@ -48,16 +49,46 @@ namespace hpp {
     } // namespace eigen
     typedef Eigen::Matrix <value_type, 5, 1> vector5_t;
     typedef Eigen::Matrix <value_type, 6, 1> vector6_t;
+    typedef Eigen::Array <bool, Eigen::Dynamic, 1> ArrayXb;
+    typedef Eigen::Array <bool, Eigen::Dynamic, Eigen::Dynamic> ArrayXXb;
 
     HPP_PREDEF_CLASS (DistanceBetweenBodies);
     HPP_PREDEF_CLASS (DistanceBetweenPointsInBodies);
+    HPP_PREDEF_CLASS (DistanceBetweenPointPairs);
+    HPP_PREDEF_CLASS (AxisAlignment);
+    HPP_PREDEF_CLASS (TransformationSet);
+    HPP_PREDEF_CLASS (DistanceBetweenBodyAndField);
+    HPP_PREDEF_CLASS (SignedDistanceField);
     HPP_PREDEF_CLASS (RelativeCom);
     HPP_PREDEF_CLASS (ComBetweenFeet);
     HPP_PREDEF_CLASS (StaticStability);
     HPP_PREDEF_CLASS (QPStaticStability);
+    HPP_PREDEF_CLASS (ContactPool);
+    struct PackedPlacements;
+    HPP_PREDEF_CLASS (SupportPolygonStability);
     HPP_PREDEF_CLASS (ConvexShapeContact);
     HPP_PREDEF_CLASS (ConvexShapeContactComplement);
     HPP_PREDEF_CLASS (ConfigurationConstraint);
+    HPP_PREDEF_CLASS (KinematicsCache);
+    HPP_PREDEF_CLASS (Workspace);
+    HPP_PREDEF_CLASS (Executor);
+    class EvaluationFuture;
+    HPP_PREDEF_CLASS (RelativeKinematics);
+    HPP_PREDEF_CLASS (CenterOfMassCache);
+    HPP_PREDEF_CLASS (GeometryPlacements);
+    HPP_PREDEF_CLASS (ModelMetadata);
+    HPP_PREDEF_CLASS (BroydenJacobian);
+    HPP_PREDEF_CLASS (NewtonProjector);
+    HPP_PREDEF_CLASS (EvaluationService);
+    HPP_PREDEF_CLASS (BatchEvaluator);
+    HPP_PREDEF_CLASS (Recorder);
+    HPP_PREDEF_CLASS (Recording);
+    HPP_PREDEF_CLASS (ContactForceSolver);
+    HPP_PREDEF_CLASS (KinematicsBatch);
+    HPP_PREDEF_CLASS (FunctionRegistry);
+    HPP_PREDEF_CLASS (EvaluationServer);
+    HPP_PREDEF_CLASS (EvaluationClient);
+    class ActiveSubspace;
 
     typedef pinocchio::ObjectVector_t ObjectVector_t;
     typedef pinocchio::CollisionObjectPtr_t CollisionObjectPtr_t;
@@ -67,6 +98,7 @@ namespace hpp {
     typedef pinocchio::ConfigurationOut_t ConfigurationOut_t;
     typedef pinocchio::Device Device;
     typedef pinocchio::DevicePtr_t DevicePtr_t;
+    typedef pinocchio::DeviceWkPtr_t DeviceWkPtr_t;
     typedef pinocchio::CenterOfMassComputation CenterOfMassComputation;
     typedef pinocchio::CenterOfMassComputationPtr_t CenterOfMassComputationPtr_t;
     typedef boost::shared_ptr <DifferentiableFunction>
@@ -77,6 +109,14 @@ namespace hpp {
     DistanceBetweenBodiesPtr_t;
     typedef boost::shared_ptr <DistanceBetweenPointsInBodies>
     DistanceBetweenPointsInBodiesPtr_t;
+    typedef boost::shared_ptr <DistanceBetweenPointPairs>
+    DistanceBetweenPointPairsPtr_t;
+    typedef boost::shared_ptr <AxisAlignment> AxisAlignmentPtr_t;
+    typedef boost::shared_ptr <TransformationSet> TransformationSetPtr_t;
+    typedef boost::shared_ptr <DistanceBetweenBodyAndField>
+    DistanceBetweenBodyAndFieldPtr_t;
+    typedef boost::shared_ptr <SignedDistanceField>
+    SignedDistanceFieldPtr_t;
     typedef boost::shared_ptr<RelativeCom> RelativeComPtr_t;
     typedef boost::shared_ptr<ComBetweenFeet> ComBetweenFeetPtr_t;
     typedef boost::shared_ptr<ConvexShapeContact>
@@ -85,8 +125,29 @@ namespace hpp {
       ConvexShapeContactComplementPtr_t;
     typedef boost::shared_ptr<StaticStability> StaticStabilityPtr_t;
     typedef boost::shared_ptr<QPStaticStability> QPStaticStabilityPtr_t;
+    typedef boost::shared_ptr<ContactPool> ContactPoolPtr_t;
+    typedef boost::shared_ptr<SupportPolygonStability>
+      SupportPolygonStabilityPtr_t;
     typedef boost::shared_ptr<ConfigurationConstraint>
       ConfigurationConstraintPtr_t;
+    typedef boost::shared_ptr<KinematicsCache> KinematicsCachePtr_t;
+    typedef boost::shared_ptr<Workspace> WorkspacePtr_t;
+    typedef boost::shared_ptr<Executor> ExecutorPtr_t;
+    typedef boost::shared_ptr<RelativeKinematics> RelativeKinematicsPtr_t;
+    typedef boost::shared_ptr<CenterOfMassCache> CenterOfMassCachePtr_t;
+    typedef boost::shared_ptr<GeometryPlacements> GeometryPlacementsPtr_t;
+    typedef boost::shared_ptr<const ModelMetadata> ModelMetadataConstPtr_t;
+    typedef boost::shared_ptr<BroydenJacobian> BroydenJacobianPtr_t;
+    typedef boost::shared_ptr<NewtonProjector> NewtonProjectorPtr_t;
+    typedef boost::shared_ptr<EvaluationService> EvaluationServicePtr_t;
+    typedef boost::shared_ptr<BatchEvaluator> BatchEvaluatorPtr_t;
+    typedef boost::shared_ptr<Recorder> RecorderPtr_t;
+    typedef boost::shared_ptr<Recording> RecordingPtr_t;
+    typedef boost::shared_ptr<ContactForceSolver> ContactForceSolverPtr_t;
+    typedef boost::shared_ptr<KinematicsBatch> KinematicsBatchPtr_t;
+    typedef boost::shared_ptr<FunctionRegistry> FunctionRegistryPtr_t;
+    typedef boost::shared_ptr<EvaluationServer> EvaluationServerPtr_t;
+    typedef boost::shared_ptr<EvaluationClient> EvaluationClientPtr_t;
 
     typedef HPP_CONSTRAINTS_DEPRECATED ConvexShapeContact StaticStabilityGravity;
     typedef HPP_CONSTRAINTS_DEPRECATED ConvexShapeContactComplement StaticStabilityGravityComplement;
@@ -95,7 +156,8 @@ namespace hpp {
     typedef HPP_CONSTRAINTS_DEPRECATED
       ConvexShapeContactComplementPtr_t StaticStabilityGravityComplementPtr_t;
 
-    template <int _Options> class GenericTransformation;
+    template <int _Options, int _NV = Eigen::Dynamic>
+      class GenericTransformation;
 
     /// \cond DEVEL
     const int RelativeBit       = 0x1;
@@ -67,30 +67,48 @@ namespace hpp {
       mutable eigen::matrix3_t JlogXTR1inJ1;
     };
     /// This class contains the data of the GenericTransformation class.
-    template <bool rel, bool pos, bool ori> struct GenericTransformationData :
+    /// \tparam nv number of columns of the jacobian, if known at compile
+    ///         time.
+    template <bool rel, bool pos, bool ori, int nv = Eigen::Dynamic>
+    struct GenericTransformationData :
       GenericTransformationJointData<rel>,
       GenericTransformationOriData<ori>
     {
       enum {
         NbRows = (pos?3:0)+(ori?3:0),
+        NV = nv,
         RowPos = (pos? 0:-1),
         RowOri = (ori?(pos?3:0):-1)
       };
       typedef Eigen::Matrix<value_type, NbRows, 1> ValueType;
-      typedef Eigen::Matrix<value_type, NbRows, Eigen::Dynamic> JacobianType;
+      typedef Eigen::Matrix<size_type, NbRows, 1> RowsType;
+      typedef Eigen::Matrix<value_type, 3, NV> Jacobian_t;
+      /// View of a RelativeKinematics::Jacobian_t with NV columns.
+      typedef Eigen::Map<const Jacobian_t> JacobianMap_t;
       bool fullPos, fullOri;
       size_type rowOri;
+      /// Row of the output of each coordinate of the error, -1 if the
+      /// coordinate is masked out.
+      RowsType outputRow;
+      /// Number of coordinates selected by the mask.
+      size_type outputSize;
       const size_type cols;
+      /// Range of columns of the jacobian that may be non zero.
+      size_type colBegin, activeCols;
+      /// Compute the log of the orientation from its quaternion.
+      bool useQuaternion;
       mutable ValueType value;
-      mutable JacobianType jacobian;
-      mutable Eigen::Matrix<value_type, 3, Eigen::Dynamic> tmpJac;
-      mutable eigen::vector3_t cross1, cross2;
+      mutable Jacobian_t tmpJac;
+      mutable eigen::vector3_t cross2;
+      /// Quantities shared with the functions bound to the same joints.
+      RelativeKinematicsPtr_t relative;
       GenericTransformationData (const size_type nCols) :
         GenericTransformationJointData<rel>(),
         GenericTransformationOriData<ori> (),
-        fullPos(false), fullOri(false), cols (nCols),
-        jacobian((int)NbRows, cols)
-      { cross1.setZero(); cross2.setZero(); }
+        fullPos(false), fullOri(false), rowOri (0), outputSize (0),
+        cols (nCols), colBegin (0), activeCols (nCols), useQuaternion (false),
+        tmpJac (3, nv == Eigen::Dynamic ? nCols : nv)
+      { cross2.setZero(); }
       void checkIsIdentity1() {
         this->R1isID = this->F1inJ1.rotation().isIdentity(); this->t1isZero = this->F1inJ1.translation().isZero();
       }
@@ -138,8 +156,16 @@ namespace hpp {
      *  (J_{2\,\omega} - J_{1\,\omega})
      *  \end{array}\right)
      *  \f}
+     *
+     *  When the number of degrees of freedom of the robot is known at
+     *  compile time, \c _NV can be set to it: the jacobians of the
+     *  joints are then handled as fixed size matrices, which lets Eigen
+     *  unroll the products. The columns are not restricted to those the
+     *  joints depend on in this case. The create methods throw if
+     *  robot->numberDof() minus the dimension of the extra config space
+     *  is not \c _NV.
     */
-    template <int _Options>
+    template <int _Options, int _NV>
     class HPP_CONSTRAINTS_DLLAPI GenericTransformation :
       public DifferentiableFunction
     {
@@ -244,6 +270,7 @@ namespace hpp {
         d_.checkIsIdentity1();
 	d_.F2inJ2.setIdentity ();
         d_.checkIsIdentity2();
+        invalidate ();
       }
 
       /// Get desired relative orientation
@@ -256,6 +283,8 @@ namespace hpp {
       inline void joint1 (const JointConstPtr_t& joint) {
         // static_assert(IsRelative);
 	d_.setJoint1(joint);
+        computeActiveColumns ();
+        invalidate ();
 	assert (!joint || joint->robot () == robot_);
       }
 
@@ -267,6 +296,8 @@ namespace hpp {
       /// Set joint 2
       inline void joint2 (const JointConstPtr_t& joint) {
 	d_.joint2 = joint;
+        computeActiveColumns ();
+        invalidate ();
 	assert (!joint || joint->robot () == robot_);
       }
 
@@ -279,6 +310,7 @@ namespace hpp {
       inline void frame1InJoint1 (const Transform3f& M) {
 	d_.F1inJ1 = M;
         d_.checkIsIdentity1();
+        invalidate ();
       }
       /// Get position of frame 1 in joint 1
       inline const Transform3f& frame1InJoint1 () const {
@@ -288,14 +320,185 @@ namespace hpp {
       inline void frame2InJoint2 (const Transform3f& M) {
 	d_.F2inJ2 = M;
         d_.checkIsIdentity2();
+        invalidate ();
       }
       /// Get position of frame 2 in joint 2
       inline const Transform3f& frame2InJoint2 () const {
 	return d_.F2inJ2;
       }
 
+      /// Which coordinates of the error vector are taken into account.
+      inline const std::vector <bool>& mask () const {
+        return mask_;
+      }
+
+      /// Compute the log of the orientation error from its quaternion.
+      ///
+      /// The log is then computed with atan2, which is accurate for
+      /// rotations of angle close to pi. By default, the log is computed
+      /// from the trace of the rotation matrix.
+      inline void useQuaternion (bool flag)
+      {
+        d_.useQuaternion = flag;
+        invalidate ();
+      }
+
+      /// Whether the log of the orientation error uses the quaternion.
+      inline bool useQuaternion () const
+      {
+        return d_.useQuaternion;
+      }
+
+      /// Evaluate the function for several references at the same
+      /// configuration.
+      ///
+      /// \param argument configuration of the robot,
+      /// \param references desired transformations, see reference,
+      /// \retval values column k is the value for references [k],
+      /// \retval jacobians if not NULL, columns
+      ///         [k * inputDerivativeSize (), (k+1) * inputDerivativeSize ()[
+      ///         are the jacobian for references [k].
+      ///
+      /// The forward kinematics and the quantities of the joints are
+      /// computed once for all the references. The reference of the
+      /// function is not modified.
+      void referenceBatch (matrixOut_t values, matrixOut_t* jacobians,
+          ConfigurationIn_t argument,
+          const std::vector <Transform3f>& references);
+
+      /// Evaluate the function from the placements of the joints at N
+      /// configurations, computed elsewhere.
+      ///
+      /// \param M1 placements of joint 1. It must be NULL if and only if
+      ///        joint 1 is the world,
+      /// \param M2 placements of joint 2,
+      /// \retval values column k is the value at configuration k.
+      ///
+      /// The forward kinematics is not computed. The relative placements
+      /// and their logs are computed for the N configurations at once, see
+      /// relativePlacements and computeLogs.
+      void valueFromPlacements (matrixOut_t values,
+          const PackedPlacements* M1, const PackedPlacements& M2) const;
+
+      /// Compute the jacobians from the placements and the jacobians of the
+      /// joints at N configurations, computed elsewhere.
+      ///
+      /// \param M1, M2 see valueFromPlacements,
+      /// \param J1, J2 jacobians of the joints, expressed in the joint frame
+      ///        as Joint::jacobian. Columns
+      ///        [k * inputDerivativeSize (), (k+1) * inputDerivativeSize ()[
+      ///        are the jacobian at configuration k. J1 is not read if M1 is
+      ///        NULL.
+      /// \retval jacobians same layout as jacobianBatch.
+      ///
+      /// The N configurations are processed in the lanes of each
+      /// operation, see relativeJacobians.
+      void jacobianFromPlacements (matrixOut_t jacobians,
+          const PackedPlacements* M1, matrixIn_t J1,
+          const PackedPlacements& M2, matrixIn_t J2) const;
+
+      /// Compute the values and the jacobians at N configurations.
+      ///
+      /// The relative placements and their logs are computed once for
+      /// both. See valueFromPlacements and jacobianFromPlacements.
+      void valueAndJacobianFromPlacements (matrixOut_t values,
+          matrixOut_t jacobians, const PackedPlacements* M1, matrixIn_t J1,
+          const PackedPlacements& M2, matrixIn_t J2) const;
+
+      /// Register the joints read by the function in a batch of forward
+      /// kinematics, see valueFromKinematics.
+      void addKinematics (KinematicsBatch& batch) const;
+
+      /// Evaluate the function at the configurations of a batch of forward
+      /// kinematics.
+      ///
+      /// \param batch forward kinematics computed at N configurations. The
+      ///        joints must have been registered with addKinematics.
+      /// \retval values column k is the value at configuration k.
+      ///
+      /// The Device is not read. See valueFromPlacements.
+      void valueFromKinematics (matrixOut_t values,
+          const KinematicsBatch& batch) const;
+
+      /// Compute the jacobians at the configurations of a batch of forward
+      /// kinematics, computed with KinematicsCache::JACOBIANS.
+      /// \retval jacobians same layout as jacobianBatch.
+      void jacobianFromKinematics (matrixOut_t jacobians,
+          const KinematicsBatch& batch) const;
+
+      /// Compute the values and the jacobians at the configurations of a
+      /// batch of forward kinematics.
+      void valueAndJacobianFromKinematics (matrixOut_t values,
+          matrixOut_t jacobians, const KinematicsBatch& batch) const;
+
+      /// Jacobians of the value with respect to the frames.
+      ///
+      /// Frame \f$F_i\f$ is perturbed as \f$F_i \exp(\nu_i)\f$, where
+      /// \f$\nu_i = (\mathbf{v}_i, \omega_i)\f$ is a velocity expressed
+      /// in frame i. With \f$(R, \mathbf{t})\f$ the placement of frame 2
+      /// in frame 1 and \f$J_{log}\f$ the jacobian of the log,
+      /// \f{eqnarray*}
+      /// \frac{\partial\mathbf{f}}{\partial\nu_1} &=&
+      ///   \left(\begin{array}{cc} -I_3 & [\mathbf{t}]_{\times} \\
+      ///   0 & -J_{log} \end{array}\right) \\
+      /// \frac{\partial\mathbf{f}}{\partial\nu_2} &=&
+      ///   \left(\begin{array}{cc} R & 0 \\
+      ///   0 & J_{log} R \end{array}\right)
+      /// \f}
+      /// restricted to the rows of the mask.
+      ///
+      /// \param argument configuration of the robot,
+      /// \retval frame1 if not NULL, the jacobian with respect to frame 1,
+      ///         of size outputDerivativeSize () x 6. For absolute
+      ///         functions, frame 1 is the reference.
+      /// \retval frame2 if not NULL, the jacobian with respect to frame 2.
+      void frameJacobians (matrixOut_t* frame1, matrixOut_t* frame2,
+          ConfigurationIn_t argument) const;
+
+      /// \name Explicit solution
+      /// \{
+
+      /// Whether the constraint can be solved in closed form.
+      ///
+      /// This is the case of transformations with a full mask when joint 2
+      /// is a free-flyer child of the world, for instance the root joint of
+      /// a grasped object, and joint 1 does not move with joint 2.
+      /// The constraint is then satisfied by
+      /// \f$ M_2 = M_1 F_{1/J_1} F_{2/J_2}^{-1} \f$.
+      bool explicitSolvable () const;
+
+      /// Write in q the configuration of joint 2 that satisfies the
+      /// constraint. The other joints of q are not modified.
+      /// \pre explicitSolvable ()
+      void explicitSolve (ConfigurationOut_t q) const;
+
+      /// Jacobian of the explicit solution.
+      ///
+      /// \retval jacobian the 6 x inputDerivativeSize () matrix that maps
+      ///         the velocity of the robot to the velocity of joint 2,
+      /// \param q configuration of the robot.
+      /// \pre explicitSolvable ()
+      void explicitJacobian (matrixOut_t jacobian, ConfigurationIn_t q) const;
+
+      /// \}
+
       virtual std::ostream& print (std::ostream& o) const;
 
+      /// Bounded by the velocity of frame 2 relative to frame 1, see
+      /// relativeVelocityBounds.
+      ///
+      /// The coordinates of the log of a rotation are discontinuous at an
+      /// angle of pi, only its norm is Lipschitz. Infinity is returned if
+      /// the mask selects some coordinates of the orientation only.
+      virtual value_type lipschitzConstant () const;
+
+      virtual MemoryUsage memoryUsage () const;
+
+      virtual bool threadSafe () const
+      {
+        return true;
+      }
+
       ///Constructor
       ///
       /// \param name the name of the constraints,
@@ -321,14 +524,81 @@ namespace hpp {
 				 ConfigurationIn_t argument) const throw ();
       virtual void impl_jacobian (matrixOut_t jacobian,
 				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_valueAndJacobian (vectorOut_t result,
+                                          matrixOut_t jacobian,
+                                          ConfigurationIn_t arg) const throw ();
+      virtual void impl_valueBatch (matrixOut_t results,
+                                    matrixIn_t configurations) const;
+      virtual void impl_jacobianBatch (matrixOut_t jacobians,
+                                       matrixIn_t configurations) const;
+      /// The products are computed from the relative velocity of the
+      /// frames, without computing the jacobian.
+      virtual void impl_jacobianTimes (vectorOut_t result,
+                                       ConfigurationIn_t arg,
+                                       vectorIn_t v) const;
+      virtual void impl_jacobianTransposeTimes (vectorOut_t result,
+                                                ConfigurationIn_t arg,
+                                                vectorIn_t w) const;
+      /// The direction is integrated on the robot of the function when no
+      /// robot is given.
+      virtual void impl_hessianTimes (vectorOut_t result,
+                                      ConfigurationIn_t arg,
+                                      vectorIn_t r, vectorIn_t v,
+                                      const DevicePtr_t& robot) const
+      {
+        DifferentiableFunction::impl_hessianTimes (result, arg, r, v,
+            robot ? robot : robot_);
+      }
+      virtual void impl_compute	(vectorOut_t result,
+				 ConfigurationIn_t argument,
+                                 Workspace& workspace) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg,
+                                  Workspace& workspace) const throw ();
     private:
-      void computeError (const ConfigurationIn_t& argument) const;
+      typedef GenericTransformationData
+        <IsRelative,ComputePosition,ComputeOrientation,_NV> Data_t;
+
+      /// Compute the error.
+      /// \param quantities the kinematic quantities that are needed, see
+      ///        KinematicsCache::update.
+      void computeError (const ConfigurationIn_t& argument,
+                         int quantities) const;
+      /// Compute the error in the data stored in the workspace.
+      const Data_t& computeError (const ConfigurationIn_t& argument,
+                                  int quantities,
+                                  Workspace& workspace) const;
+      /// Evaluate the function from packed placements.
+      /// \param values, jacobians outputs. Not computed if NULL.
+      void fromPlacements (matrixOut_t* values, matrixOut_t* jacobians,
+          const PackedPlacements* M1, matrixIn_t J1,
+          const PackedPlacements& M2, matrixIn_t J2) const;
+
+      /// Compute the columns of the jacobian that depend on joint1 and
+      /// joint2, the joints of the forward kinematics, and bind d_ to the
+      /// RelativeKinematics of the joints.
+      void computeActiveColumns ();
+      /// Invalidate the cached error after a change of definition.
+      void invalidate ()
+      {
+        latestVersion_ = 0;
+        ++definitionVersion_;
+      }
       DevicePtr_t robot_;
-      GenericTransformationData<IsRelative,ComputePosition,ComputeOrientation>
-        d_;
+      Data_t d_;
       const std::vector <bool> mask_;
       WkPtr_t self_;
-      mutable Configuration_t latestArgument_;
+      KinematicsCachePtr_t kinematics_;
+      /// Version of the kinematics cache at which d_ was computed.
+      mutable std::size_t latestVersion_;
+      /// Joints read by the function: joint1, joint2 and their ancestors,
+      /// see KinematicsCache::Joints_t.
+      std::vector <bool> joints_;
+      /// Incremented each time a joint or a frame is modified.
+      std::size_t definitionVersion_;
+
+      /// Evaluates the compiled stacks without virtual call.
+      friend class DifferentiableFunctionStack;
     }; // class GenericTransformation
     /// \}
   } // namespace constraints
@@ -0,0 +1,83 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_GEOMETRY_PLACEMENTS_HH
+# define HPP_CONSTRAINTS_GEOMETRY_PLACEMENTS_HH
+
+# include <vector>
+
+# include <pinocchio/multibody/geometry.hpp>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Placements of the geometries of a Device, computed once per version
+    /// of the KinematicsCache.
+    ///
+    /// There is one instance per KinematicsCache. Functions depending on
+    /// the placement of geometries (DistanceBetweenBodies) share it instead
+    /// of holding a se3::GeometryData and updating all the geometries of
+    /// the robot. Each function updates only the geometries it reads.
+    ///
+    /// Functions call KinematicsCache::update, for all the joints, and then
+    /// GeometryPlacements::update before reading the placements.
+    class HPP_CONSTRAINTS_DLLAPI GeometryPlacements
+    {
+      public:
+        typedef std::vector <se3::GeomIndex> Geometries_t;
+
+        /// Get the instance of a KinematicsCache.
+        /// It is created if it does not exist.
+        static GeometryPlacementsPtr_t get
+          (const KinematicsCachePtr_t& kinematics);
+
+        /// Compute the placements of some geometries, unless they have
+        /// been computed at the current version of the KinematicsCache.
+        void update (const Geometries_t& geometries);
+
+        /// Placement of a geometry in the world frame.
+        /// \note it must have been updated at the current version.
+        const Transform3f& placement (se3::GeomIndex geometry) const
+        {
+          assert (versions_ [geometry] == kinematics_->version ());
+          return placements_ [geometry];
+        }
+
+        const KinematicsCachePtr_t& kinematics () const
+        {
+          return kinematics_;
+        }
+
+      private:
+        GeometryPlacements (const KinematicsCachePtr_t& kinematics);
+
+        KinematicsCachePtr_t kinematics_;
+        std::vector <Transform3f> placements_;
+        /// Version of the KinematicsCache each placement was computed at.
+        std::vector <std::size_t> versions_;
+    }; // class GeometryPlacements
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_GEOMETRY_PLACEMENTS_HH
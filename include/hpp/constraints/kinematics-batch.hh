@@ -0,0 +1,152 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_KINEMATICS_BATCH_HH
+# define HPP_CONSTRAINTS_KINEMATICS_BATCH_HH
+
+# include <map>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/kinematics-cache.hh>
+# include <hpp/constraints/packed-kinematics.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Forward kinematics of a Device at N configurations.
+    ///
+    /// The functions that evaluate from the kinematics of several
+    /// configurations (GenericTransformation::valueFromKinematics,
+    /// RelativeCom::valueFromKinematics...) register the joints and the
+    /// centers of mass they read with addKinematics. compute then runs the
+    /// forward kinematics once per configuration through the
+    /// KinematicsCache of the Device, and packs the quantities of the
+    /// registered joints and centers of mass for the N configurations:
+    /// \li the placements of each joint, see PackedPlacements,
+    /// \li the jacobians of each joint, a 6 x (N nv) matrix whose columns
+    ///     [k nv, (k+1) nv[ are Joint::jacobian at configuration k,
+    /// \li the position of each center of mass, a vectors3_t,
+    /// \li the jacobian of each center of mass, a 3 x (N nv) matrix laid
+    ///     out as the joint jacobians.
+    ///
+    /// The functions read these buffers only, so that the N
+    /// configurations are processed without going through the Device.
+    ///
+    /// \note The buffers grow linearly with N. Large sets of
+    ///       configurations should be processed by tiles of a few tens of
+    ///       configurations, calling compute on consecutive blocks of
+    ///       columns, so that the buffers remain in cache between the
+    ///       forward kinematics and the evaluation.
+    class HPP_CONSTRAINTS_DLLAPI KinematicsBatch
+    {
+      public:
+        /// Return a shared pointer to a new instance
+        static KinematicsBatchPtr_t create (const DevicePtr_t& robot);
+
+        /// Register a joint. Nothing is done if joint is NULL.
+        void addJoint (const JointConstPtr_t& joint);
+
+        /// Register a center of mass.
+        void addCenterOfMass (const CenterOfMassCachePtr_t& com);
+
+        /// Compute the forward kinematics at each configuration.
+        /// \param configurations column k is configuration k,
+        /// \param quantities KinematicsCache::PLACEMENTS if only the values
+        ///        are evaluated, KinematicsCache::JACOBIANS otherwise.
+        ///
+        /// If no center of mass is registered, the forward kinematics is
+        /// restricted to the registered joints and their ancestors.
+        void compute (matrixIn_t configurations, int quantities);
+
+        /// Number of configurations of the latest call to compute.
+        size_type size () const
+        {
+          return size_;
+        }
+
+        /// Placements of a registered joint.
+        const PackedPlacements& placements (const JointConstPtr_t& joint) const
+        {
+          return findJoint (joint).placements;
+        }
+
+        /// Jacobians of a registered joint.
+        /// Only available if compute was called with
+        /// KinematicsCache::JACOBIANS.
+        const matrix_t& jacobians (const JointConstPtr_t& joint) const
+        {
+          return findJoint (joint).jacobians;
+        }
+
+        /// Positions of a registered center of mass.
+        const vectors3_t& centerOfMass (const CenterOfMassCachePtr_t& com)
+          const
+        {
+          return findCenterOfMass (com).com;
+        }
+
+        /// Jacobians of a registered center of mass.
+        /// Only available if compute was called with
+        /// KinematicsCache::JACOBIANS.
+        const matrix_t& centerOfMassJacobians
+          (const CenterOfMassCachePtr_t& com) const
+        {
+          return findCenterOfMass (com).jacobians;
+        }
+
+        DevicePtr_t robot () const
+        {
+          return robot_.lock ();
+        }
+
+      private:
+        KinematicsBatch (const DevicePtr_t& robot);
+
+        struct JointData_t {
+          JointConstPtr_t joint;
+          PackedPlacements placements;
+          matrix_t jacobians;
+        };
+        struct CenterOfMassData_t {
+          CenterOfMassCachePtr_t cache;
+          vectors3_t com;
+          matrix_t jacobians;
+        };
+        typedef std::map <std::size_t, JointData_t> JointMap_t;
+        typedef std::map <const CenterOfMassCache*, CenterOfMassData_t>
+          CenterOfMassMap_t;
+
+        const JointData_t& findJoint (const JointConstPtr_t& joint) const;
+        const CenterOfMassData_t& findCenterOfMass
+          (const CenterOfMassCachePtr_t& com) const;
+
+        DeviceWkPtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
+        /// Registered joints and their ancestors.
+        KinematicsCache::Joints_t joints_;
+        JointMap_t jointData_;
+        CenterOfMassMap_t comData_;
+        size_type size_;
+    }; // class KinematicsBatch
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_KINEMATICS_BATCH_HH
@@ -0,0 +1,174 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_KINEMATICS_CACHE_HH
+# define HPP_CONSTRAINTS_KINEMATICS_CACHE_HH
+
+# include <map>
+# include <utility>
+# include <vector>
+
+# include <hpp/pinocchio/device.hh>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Avoid recomputing the forward kinematics of a Device.
+    ///
+    /// There is one instance per Device, shared by all the functions
+    /// bound to this Device. Functions call KinematicsCache::update instead
+    /// of setting the configuration and computing the forward kinematics
+    /// themselves. The forward kinematics is recomputed only if the
+    /// configuration has changed since the last computation or if
+    /// quantities that were not computed are needed.
+    ///
+    /// Functions request only the quantities they need: evaluating the
+    /// value only requires KinematicsCache::PLACEMENTS, so that the joint
+    /// jacobians are computed only when a jacobian is evaluated.
+    ///
+    /// Functions that read only a few joints may restrict the forward
+    /// kinematics to these joints and their ancestors, see Joints_t.
+    ///
+    /// Each change of configuration increments KinematicsCache::version, so
+    /// that functions can cache results that depend only on the kinematics.
+    ///
+    /// \note If the Device is modified without going through this cache,
+    ///       call KinematicsCache::invalidate.
+    class HPP_CONSTRAINTS_DLLAPI KinematicsCache
+    {
+      public:
+        /// Quantities computed by the forward kinematics.
+        ///
+        /// The centers of mass are computed by CenterOfMassCache from the
+        /// placements, and their jacobians from the joint jacobians.
+        enum Quantities_t {
+          /// Placements of the joints, needed by the values.
+          PLACEMENTS = Device::JOINT_POSITION,
+          /// Placements and jacobians of the joints, needed by the
+          /// jacobians.
+          JACOBIANS = Device::JOINT_POSITION | Device::JACOBIAN
+        };
+
+        /// Joints of the Device, indexed as in the pinocchio model.
+        ///
+        /// A set of joints passed to update must contain the ancestors of
+        /// its joints, use addJoint to build it. An empty set stands for
+        /// all the joints.
+        typedef std::vector <bool> Joints_t;
+
+        /// Add a joint and its ancestors to a set of joints.
+        /// Nothing is done if joint is NULL.
+        static void addJoint (Joints_t& joints, const JointConstPtr_t& joint);
+
+        /// Get the cache of a Device. It is created if it does not exist.
+        /// The registry of caches may be accessed from several threads,
+        /// the returned cache may not.
+        static KinematicsCachePtr_t get (const DevicePtr_t& robot);
+
+        /// Compute the forward kinematics at q, if necessary.
+        /// \param quantities the quantities that are needed, a combination
+        ///        of Device::Computation_t, see Quantities_t.
+        /// \return true if the forward kinematics was computed.
+        ///
+        /// The computation flag of the Device is restored after the
+        /// computation. If q is the configuration of the previous
+        /// computation, the version does not change and the quantities
+        /// computed previously remain available.
+        bool update (ConfigurationIn_t q, int quantities);
+
+        /// Compute the forward kinematics of some joints at q, if necessary.
+        /// \param quantities see update (ConfigurationIn_t, int),
+        /// \param joints the joints that are read. The other joints of the
+        ///        Device are not up to date, and neither are the geometries
+        ///        and the centers of mass.
+        ///
+        /// When several functions request different sets of joints at the
+        /// same configuration, the joints that are missing are computed
+        /// with the joints computed previously.
+        bool update (ConfigurationIn_t q, int quantities,
+                     const Joints_t& joints);
+
+        /// Compute the quantities of the computation flag of the Device.
+        bool update (ConfigurationIn_t q);
+
+        /// Force the next call to update to compute the forward kinematics.
+        void invalidate ()
+        {
+          valid_ = false;
+        }
+
+        /// Number of forward kinematics computations done through the cache.
+        /// A value of 0 means that nothing has been computed yet.
+        std::size_t version () const
+        {
+          return version_;
+        }
+
+        DevicePtr_t robot () const
+        {
+          return robot_.lock ();
+        }
+
+      private:
+        KinematicsCache (const DevicePtr_t& robot);
+
+        /// Compute the forward kinematics of a set of joints, without
+        /// going through the Device.
+        void computeJoints (Device& robot, int quantities) const;
+
+        typedef std::map <std::pair <std::size_t, std::size_t>,
+                          RelativeKinematicsWkPtr_t> RelativeKinematicsMap_t;
+        friend class RelativeKinematics;
+        typedef std::map <std::vector <std::size_t>,
+                          CenterOfMassCacheWkPtr_t> CenterOfMassMap_t;
+        typedef std::map <const CenterOfMassComputation*,
+                          CenterOfMassCacheWkPtr_t> ComputationMap_t;
+        friend class CenterOfMassCache;
+        friend class GeometryPlacements;
+        friend class ModelMetadata;
+
+        DeviceWkPtr_t robot_;
+        Configuration_t latest_;
+        int flag_;
+        /// Joints computed at latest_ if not all of them, empty otherwise.
+        Joints_t joints_;
+        bool valid_;
+        std::size_t version_;
+        /// Instances of RelativeKinematics bound to this cache, indexed by
+        /// the pair of joint indices.
+        RelativeKinematicsMap_t relativeKinematics_;
+        /// Instances of CenterOfMassCache bound to this cache, indexed by
+        /// the indices of the root joints of the subtrees.
+        CenterOfMassMap_t centersOfMass_;
+        /// Instances of CenterOfMassCache built from a user defined
+        /// CenterOfMassComputation.
+        ComputationMap_t computations_;
+        /// Placements of the geometries bound to this cache.
+        GeometryPlacementsWkPtr_t geometryPlacements_;
+        /// Structure of the model, shared by the functions bound to this
+        /// cache.
+        ModelMetadataConstPtr_t metadata_;
+    }; // class KinematicsCache
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_KINEMATICS_CACHE_HH
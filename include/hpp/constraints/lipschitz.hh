@@ -0,0 +1,80 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_LIPSCHITZ_HH
+# define HPP_CONSTRAINTS_LIPSCHITZ_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Bounds on the velocity of the points of a body.
+    struct HPP_CONSTRAINTS_DLLAPI VelocityBounds
+    {
+      /// Bounds on the linear velocity of the points and on the angular
+      /// velocity of the body, per unit of norm of the velocity of the
+      /// robot.
+      value_type linear, angular;
+    };
+
+    /// Bound the velocity of the points of a joint relative to another joint.
+    ///
+    /// \param joint1 index of the reference joint in the pinocchio model,
+    ///        0 for the world frame,
+    /// \param joint2 index of the moving joint,
+    /// \param radius maximal distance of the points to the origin of joint2.
+    ///
+    /// The bounds hold for any configuration. They are derived from
+    /// pinocchio::Joint::upperBoundLinearVelocity,
+    /// pinocchio::Joint::upperBoundAngularVelocity and from the lengths
+    /// pinocchio::Joint::maximalDistanceToParent of the kinematic chain
+    /// between the joints. The common ancestors of both joints do not
+    /// contribute.
+    HPP_CONSTRAINTS_DLLAPI VelocityBounds relativeVelocityBounds
+      (const DevicePtr_t& robot, se3::JointIndex joint1,
+       se3::JointIndex joint2, value_type radius);
+
+    /// Check that the norm of a function remains below a threshold along
+    /// a straight path.
+    ///
+    /// \param f the function, bound to robot,
+    /// \param q0, q1 ends of the straight path in the configuration space,
+    /// \param threshold bound on the norm of the value,
+    /// \param step distance between consecutive samples when the
+    ///        DifferentiableFunction::lipschitzConstant of f does not
+    ///        certify a longer interval,
+    /// \retval validPart parameter in [0, 1] up to which the path is valid,
+    /// \retval nbEvaluations number of evaluations of f.
+    /// \return whether the whole path is valid.
+    ///
+    /// After a sample of value \f$f_i\f$, the path is certified on the
+    /// interval of length \f$(\epsilon - \|f_i\|) / L\f$ where \f$L\f$ is
+    /// the Lipschitz constant and \f$\epsilon\f$ the threshold, so that
+    /// the next sample is the end of this interval. When the interval is
+    /// shorter than step, the space between the samples is not certified.
+    HPP_CONSTRAINTS_DLLAPI bool validateSegment
+      (const DifferentiableFunction& f, const DevicePtr_t& robot,
+       ConfigurationIn_t q0, ConfigurationIn_t q1, value_type threshold,
+       value_type step, value_type& validPart, std::size_t& nbEvaluations);
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_LIPSCHITZ_HH
@@ -0,0 +1,94 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_MEMORY_USAGE_HH
+# define HPP_CONSTRAINTS_MEMORY_USAGE_HH
+
+# include <ostream>
+# include <string>
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Memory used by a function, in bytes.
+    ///
+    /// \sa DifferentiableFunction::memoryUsage
+    struct MemoryUsage
+    {
+      /// The object and the parameters of the function: frames, shapes,
+      /// masks...
+      std::size_t definition;
+      /// Buffers of the intermediate results of an evaluation.
+      std::size_t scratch;
+      /// Results kept from one evaluation to the next.
+      std::size_t caches;
+
+      MemoryUsage () : definition (0), scratch (0), caches (0) {}
+
+      std::size_t total () const
+      {
+        return definition + scratch + caches;
+      }
+
+      MemoryUsage& operator+= (const MemoryUsage& other)
+      {
+        definition += other.definition;
+        scratch += other.scratch;
+        caches += other.caches;
+        return *this;
+      }
+    }; // struct MemoryUsage
+
+    /// Bytes allocated by an Eigen matrix or array.
+    template <typename Derived>
+    inline std::size_t memorySize (const Eigen::DenseBase <Derived>& m)
+    {
+      return (std::size_t) m.size () * sizeof (typename Derived::Scalar);
+    }
+
+    /// Bytes allocated by a vector, without the memory of its elements.
+    template <typename T>
+    inline std::size_t memorySize (const std::vector <T>& v)
+    {
+      return v.capacity () * sizeof (T);
+    }
+
+    inline std::size_t memorySize (const std::vector <bool>& v)
+    {
+      return v.capacity () / 8;
+    }
+
+    inline std::size_t memorySize (const std::string& s)
+    {
+      return s.capacity ();
+    }
+
+    inline std::ostream& operator<< (std::ostream& os, const MemoryUsage& m)
+    {
+      return os << m.total () << " bytes (definition " << m.definition
+        << ", scratch " << m.scratch << ", caches " << m.caches << ')';
+    }
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_MEMORY_USAGE_HH
@@ -0,0 +1,145 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_MODEL_METADATA_HH
+# define HPP_CONSTRAINTS_MODEL_METADATA_HH
+
+# include <utility>
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Quantities that depend only on the structure of the model of a Device.
+    ///
+    /// They are computed once and shared by all the functions bound to the
+    /// Device, instead of being recomputed by each function or at each
+    /// finite difference evaluation. The instance is owned by the
+    /// KinematicsCache of the Device.
+    ///
+    /// Velocity columns are indexed in the tangent space of the Device,
+    /// the extra config space coming last. Joint indices are the indices of
+    /// the pinocchio model, 0 being the universe.
+    class HPP_CONSTRAINTS_DLLAPI ModelMetadata
+    {
+      public:
+        typedef std::vector <se3::JointIndex> JointIndices_t;
+        /// Range of columns [first, second[.
+        typedef std::pair <size_type, size_type> Range_t;
+
+        /// Get the metadata of a Device.
+        /// They are computed if they do not exist or if the dimensions of
+        /// the Device have changed. This method may be called from several
+        /// threads.
+        static ModelMetadataConstPtr_t get (const DevicePtr_t& robot);
+
+        /// Number of configuration variables.
+        size_type configSize () const
+        {
+          return configSize_;
+        }
+
+        /// Number of velocity columns.
+        size_type numberDof () const
+        {
+          return numberDof_;
+        }
+
+        /// Dimension of the extra config space.
+        size_type extraConfigSize () const
+        {
+          return extraConfigSize_;
+        }
+
+        /// Joint of each velocity column of the kinematic chain.
+        /// The size is the number of velocity columns of the model, without
+        /// the extra config space.
+        const JointIndices_t& velocityToJoint () const
+        {
+          return velocityToJoint_;
+        }
+
+        /// Finite difference increments of the velocity columns of the
+        /// kinematic chain.
+        const vector_t& finiteDifferenceIncrements () const
+        {
+          return increments_;
+        }
+
+        /// Velocity columns of a joint.
+        const Range_t& velocityRange (se3::JointIndex joint) const
+        {
+          assert (joint < velocities_.size ());
+          return velocities_[joint];
+        }
+
+        /// Configuration variables of a joint.
+        const Range_t& configurationRange (se3::JointIndex joint) const
+        {
+          assert (joint < configurations_.size ());
+          return configurations_[joint];
+        }
+
+        /// Velocity columns of a joint and of its ancestors.
+        /// The size is the number of velocity columns of the model.
+        const ArrayXb& support (se3::JointIndex joint) const
+        {
+          assert (joint < supports_.size ());
+          return supports_[joint];
+        }
+
+        /// Velocity columns of the subtree rooted at a joint.
+        /// Joints are sorted depth first, so that these columns are
+        /// contiguous.
+        const Range_t& subtreeColumns (se3::JointIndex joint) const
+        {
+          assert (joint < subtrees_.size ());
+          return subtrees_[joint];
+        }
+
+        /// Configuration variables of the joints having an active velocity
+        /// column.
+        /// \param columns active velocity columns, of size numberDof,
+        /// \retval variables configuration variables, of size configSize.
+        void configurationVariables (const ArrayXb& columns,
+                                     ArrayXb& variables) const;
+
+      private:
+        ModelMetadata (const DevicePtr_t& robot);
+
+        bool matches (const DevicePtr_t& robot) const;
+
+        size_type configSize_, numberDof_, extraConfigSize_;
+        JointIndices_t velocityToJoint_;
+        vector_t increments_;
+        std::vector <ArrayXb> supports_;
+        std::vector <Range_t> subtrees_;
+        /// Configuration and velocity ranges of the joints, indexed as in
+        /// the model.
+        std::vector <Range_t> configurations_, velocities_;
+
+        friend class KinematicsCache;
+    }; // class ModelMetadata
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_MODEL_METADATA_HH
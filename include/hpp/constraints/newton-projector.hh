@@ -0,0 +1,190 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_NEWTON_PROJECTOR_HH
+# define HPP_CONSTRAINTS_NEWTON_PROJECTOR_HH
+
+# include <cmath>
+
+# include <Eigen/QR>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/svd.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup solvers
+    /// \{
+
+    /// Project configurations on the zero set of a stack of functions.
+    ///
+    /// Each iteration computes the value and the jacobian of the stack,
+    /// the Gauss-Newton step \f$ \Delta q = - J^+ f(q) \f$ and a
+    /// backtracking line search on \f$ \|f\|^2 \f$ along this step.
+    /// The configuration is updated on the Lie group of the robot.
+    ///
+    /// The buffers are allocated at construction for the sizes of the
+    /// stack, so that solve does not allocate memory. Only the active
+    /// derivative columns of the stack are factorized.
+    ///
+    /// \note The value of the stack must be a vector: its output size and
+    ///       its output derivative size must be equal.
+    /// \warning Call update after adding functions to or removing functions
+    ///          from the stack.
+    class HPP_CONSTRAINTS_DLLAPI NewtonProjector
+    {
+      public:
+        /// Decomposition of the jacobian.
+        enum Decomposition_t {
+          /// Householder QR with column pivoting. The step is the basic
+          /// solution, with zeros on the columns beyond the rank.
+          COLUMN_PIVOTING_QR,
+          /// Singular value decomposition truncated at the rank, warm
+          /// started with the decomposition of the previous iteration, see
+          /// WarmStartJacobiSVD. The step is the least norm solution.
+          TRUNCATED_SVD
+        };
+
+        enum Status_t {
+          /// The norm of the value is below the error threshold.
+          SUCCESS,
+          /// The line search did not decrease the norm of the value.
+          NO_DESCENT,
+          MAX_ITERATIONS_REACHED
+        };
+
+        /// Return a shared pointer to a new instance.
+        /// \param stack the functions to cancel,
+        /// \param robot robot used to integrate the steps. If NULL, the
+        ///        steps are added to the configuration.
+        static NewtonProjectorPtr_t create
+          (const DifferentiableFunctionStackPtr_t& stack,
+           const DevicePtr_t& robot);
+
+        /// Project a configuration.
+        /// \param q the initial configuration, replaced by the result.
+        Status_t solve (ConfigurationOut_t q);
+
+        /// Allocate the buffers for the current sizes of the stack.
+        void update ();
+
+        const DifferentiableFunctionStackPtr_t& stack () const
+        {
+          return stack_;
+        }
+
+        /// Bound on the norm of the value of a solution.
+        /// The default is 1e-6.
+        void errorThreshold (value_type threshold)
+        {
+          squaredErrorThreshold_ = threshold * threshold;
+        }
+
+        value_type errorThreshold () const
+        {
+          return std::sqrt (squaredErrorThreshold_);
+        }
+
+        /// The default is 20.
+        void maxIterations (std::size_t iterations)
+        {
+          maxIterations_ = iterations;
+        }
+
+        std::size_t maxIterations () const
+        {
+          return maxIterations_;
+        }
+
+        /// The default is COLUMN_PIVOTING_QR.
+        void decomposition (Decomposition_t decomposition)
+        {
+          decomposition_ = decomposition;
+          svd_.reset ();
+        }
+
+        Decomposition_t decomposition () const
+        {
+          return decomposition_;
+        }
+
+        /// Relative threshold under which the pivots or the singular
+        /// values are considered as zero. The default is 1e-8.
+        void rankThreshold (value_type threshold);
+
+        value_type rankThreshold () const
+        {
+          return rankThreshold_;
+        }
+
+        /// Number of iterations of the latest call to solve.
+        std::size_t iterations () const
+        {
+          return iterations_;
+        }
+
+        /// Squared norm of the value at the result of the latest call to
+        /// solve.
+        value_type squaredNorm () const
+        {
+          return squaredNorm_;
+        }
+
+        /// Rank of the jacobian at the last iteration.
+        size_type rank () const
+        {
+          return rank_;
+        }
+
+      private:
+        NewtonProjector (const DifferentiableFunctionStackPtr_t& stack,
+            const DevicePtr_t& robot);
+
+        /// Compute step_ from value_ and the active columns of jacobian_.
+        void computeStep ();
+
+        /// Integrate the step. The output may be the input.
+        void integrate (vectorIn_t q, value_type alpha, vectorOut_t result);
+
+        DifferentiableFunctionStackPtr_t stack_;
+        DevicePtr_t robot_;
+        value_type squaredErrorThreshold_;
+        std::size_t maxIterations_;
+        Decomposition_t decomposition_;
+        value_type rankThreshold_;
+
+        /// Indices of the active derivative columns of the stack.
+        std::vector <size_type> columns_;
+        vector_t value_, trialValue_;
+        matrix_t jacobian_, reduced_;
+        /// Right hand side and solution of the reduced problem, and
+        /// \f$ \Sigma_1^{-1} U_1^T \f$ rhs.
+        vector_t rhs_, reducedStep_, projected_;
+        vector_t step_, scaledStep_;
+        Configuration_t trial_;
+        Eigen::ColPivHouseholderQR <matrix_t> qr_;
+        WarmStartJacobiSVD <matrix_t> svd_;
+
+        std::size_t iterations_;
+        value_type squaredNorm_;
+        size_type rank_;
+    }; // class NewtonProjector
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_NEWTON_PROJECTOR_HH
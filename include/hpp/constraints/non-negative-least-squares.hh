@@ -0,0 +1,122 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_NON_NEGATIVE_LEAST_SQUARES_HH
+# define HPP_CONSTRAINTS_NON_NEGATIVE_LEAST_SQUARES_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup solvers
+    /// \{
+
+    /// Solve \f$ \min_{x \ge 0} \| A x - b \|^2 \f$.
+    ///
+    /// This is the active set method of Lawson and Hanson. The least
+    /// squares problems are solved on the columns of \f$ A \f$ of the
+    /// positive variables, so that \f$ A^T A \f$ is never formed.
+    ///
+    /// The solver is meant for wrenches: \f$ A \f$ has at most MaxRows
+    /// rows. Since the columns of the positive variables are linearly
+    /// independent, there are at most MaxRows of them and the solver does
+    /// not allocate memory once the number of variables is known.
+    class HPP_CONSTRAINTS_DLLAPI NonNegativeLeastSquares
+    {
+      public:
+        enum { MaxRows = 6 };
+
+        NonNegativeLeastSquares () :
+          maxIterations_ (100), tolerance_ (1e-10), iterations_ (0),
+          residual_ (0)
+        {}
+
+        /// Solve the problem.
+        /// \param warmStart start from the positive variables of the
+        ///        previous solution, if the number of variables did not
+        ///        change.
+        /// \return true if the solution is optimal, false if the maximal
+        ///         number of iterations was reached.
+        bool solve (matrixIn_t A, vectorIn_t b, bool warmStart = true);
+
+        /// Solve the problem starting from the positive variables of x0,
+        /// for instance the solution of a problem sharing most columns.
+        bool solve (matrixIn_t A, vectorIn_t b, vectorIn_t x0)
+        {
+          assert (x0.size () == A.cols ());
+          x_ = x0;
+          return solve (A, b, true);
+        }
+
+        /// Solution of the last call to solve.
+        const vector_t& solution () const
+        {
+          return x_;
+        }
+
+        /// Gradient \f$ A^T (A x - b) \f$ at the solution, that is the
+        /// multipliers of the constraints \f$ x \ge 0 \f$.
+        const vector_t& dual () const
+        {
+          return dual_;
+        }
+
+        /// \f$ \| A x - b \|^2 \f$ at the solution.
+        value_type residual () const
+        {
+          return residual_;
+        }
+
+        /// Number of least squares problems solved by the last call to solve.
+        std::size_t iterations () const
+        {
+          return iterations_;
+        }
+
+        /// Maximal number of least squares problems solved by each call to
+        /// solve.
+        void maxIterations (std::size_t n)
+        {
+          maxIterations_ = n;
+        }
+
+        /// Threshold of positivity of the variables and of the dual.
+        void tolerance (value_type eps)
+        {
+          tolerance_ = eps;
+        }
+
+      private:
+        /// Solve the least squares problem on the positive variables.
+        void solvePassive (matrixIn_t A, vectorIn_t b);
+
+        vector_t x_, z_, dual_;
+        /// Whether each variable is positive.
+        std::vector <bool> passive_;
+        std::size_t nbPassive_;
+        std::size_t maxIterations_;
+        value_type tolerance_;
+        std::size_t iterations_;
+        value_type residual_;
+    }; // class NonNegativeLeastSquares
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_NON_NEGATIVE_LEAST_SQUARES_HH
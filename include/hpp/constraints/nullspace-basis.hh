@@ -0,0 +1,92 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_NULLSPACE_BASIS_HH
+# define HPP_CONSTRAINTS_NULLSPACE_BASIS_HH
+
+# include <Eigen/QR>
+# include <Eigen/Cholesky>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup solvers
+    /// \{
+
+    /// Orthonormal basis of the kernel of a jacobian.
+    ///
+    /// The basis is a thin \f$ n \times (n - r) \f$ matrix \f$ N \f$ where
+    /// \f$ n \f$ is the number of columns and \f$ r \f$ the rank of the
+    /// jacobian \f$ J \f$. compute builds it from the column pivoting QR
+    /// decomposition of \f$ J^T \f$.
+    ///
+    /// Between nearby configurations, update projects the previous basis
+    /// \f$ N_0 \f$ onto the new kernel,
+    /// \f$ N = N_0 - Q_1 Q_1^T N_0 \f$ where \f$ Q_1 \f$ is an orthonormal
+    /// basis of the rows of \f$ J \f$, and orthonormalizes the result with
+    /// the Cholesky factor of \f$ N^T N \f$. Only the \f$ r \f$ first
+    /// columns of the orthogonal factor are formed, and the basis varies
+    /// continuously with the configuration, which keeps the charts of
+    /// tangent space samplers consistent.
+    class HPP_CONSTRAINTS_DLLAPI NullspaceBasis
+    {
+      public:
+        /// \param threshold relative threshold on the pivots of the QR
+        ///        decomposition under which the rank is decreased.
+        NullspaceBasis (value_type threshold = 1e-8);
+
+        /// Compute the basis from scratch.
+        void compute (matrixIn_t jacobian);
+
+        /// Update the basis from the previous one.
+        ///
+        /// The basis is computed from scratch if there is no previous
+        /// basis, if the rank has changed or if the projected basis is
+        /// degenerate, i.e. the jacobian has moved too much.
+        /// \return true if the basis was updated, false if it was
+        ///         computed from scratch.
+        bool update (matrixIn_t jacobian);
+
+        /// Orthonormal basis of the kernel.
+        const matrix_t& basis () const
+        {
+          return basis_;
+        }
+
+        /// Rank of the jacobian.
+        size_type rank () const
+        {
+          return rank_;
+        }
+
+      private:
+        /// Decompose the transpose of the jacobian and compute rank_.
+        void decompose (matrixIn_t jacobian);
+
+        value_type threshold_;
+        size_type rank_;
+        matrix_t basis_, rows_, gram_;
+        Eigen::ColPivHouseholderQR <matrix_t> qr_;
+        Eigen::LLT <matrix_t> llt_;
+    }; // class NullspaceBasis
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_NULLSPACE_BASIS_HH
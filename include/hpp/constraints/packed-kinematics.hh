@@ -0,0 +1,284 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_PACKED_KINEMATICS_HH
+# define HPP_CONSTRAINTS_PACKED_KINEMATICS_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/tools.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Placements of a joint at N configurations.
+    ///
+    /// The rotations and the translations are stored as structures of
+    /// arrays (see matrices3_t and vectors3_t), so that the operations
+    /// below process the N placements row by row. This is the layout a
+    /// forward kinematics computed elsewhere for a batch of configurations
+    /// should be packed into.
+    struct HPP_CONSTRAINTS_DLLAPI PackedPlacements
+    {
+      matrices3_t rotation;
+      vectors3_t translation;
+
+      PackedPlacements () {}
+
+      explicit PackedPlacements (size_type n) : rotation (9, n),
+        translation (3, n) {}
+
+      void resize (size_type n)
+      {
+        rotation.resize (9, n);
+        translation.resize (3, n);
+      }
+
+      size_type size () const
+      {
+        return translation.cols ();
+      }
+
+      void set (size_type k, const Transform3f& M)
+      {
+        for (int j = 0; j < 3; ++j)
+          for (int i = 0; i < 3; ++i)
+            rotation (3*j+i, k) = M.rotation () (i, j);
+        translation.col (k) = M.translation ();
+      }
+
+      Transform3f get (size_type k) const
+      {
+        matrix3_t R;
+        for (int j = 0; j < 3; ++j)
+          for (int i = 0; i < 3; ++i)
+            R (i, j) = rotation (3*j+i, k);
+        return Transform3f (R, vector3_t (translation.col (k)));
+      }
+    }; // struct PackedPlacements
+
+    /// \cond DEVEL
+    namespace packed {
+      /// C = A^T B, or A B if transpose is false.
+      inline void multiply (const matrices3_t& A, const matrices3_t& B,
+          matrices3_t& C, bool transpose)
+      {
+        C.resize (9, B.cols ());
+        for (int i = 0; i < 3; ++i)
+          for (int j = 0; j < 3; ++j) {
+            // A(i,k) is row 3k+i and A(k,i) is row 3i+k
+            C.row (3*j+i).array () = (transpose ? A.row (3*i).array ()
+                : A.row (i).array ()) * B.row (3*j).array ();
+            for (int k = 1; k < 3; ++k)
+              C.row (3*j+i).array () += (transpose ? A.row (3*i+k).array ()
+                  : A.row (3*k+i).array ()) * B.row (3*j+k).array ();
+          }
+      }
+
+      /// C = K^T B K', for constant K and K'.
+      inline void conjugate (const matrix3_t& K, const matrices3_t& B,
+          const matrix3_t& Kp, matrices3_t& C)
+      {
+        matrices3_t tmp (9, B.cols ());
+        for (int i = 0; i < 3; ++i)
+          for (int j = 0; j < 3; ++j) {
+            // tmp = K^T B: tmp(i,j) = sum_k K(k,i) B(k,j)
+            tmp.row (3*j+i) = K(0,i) * B.row (3*j);
+            for (int k = 1; k < 3; ++k)
+              tmp.row (3*j+i) += K(k,i) * B.row (3*j+k);
+          }
+        C.resize (9, B.cols ());
+        for (int i = 0; i < 3; ++i)
+          for (int j = 0; j < 3; ++j) {
+            // C(i,j) = sum_k tmp(i,k) K'(k,j)
+            C.row (3*j+i) = Kp(0,j) * tmp.row (i);
+            for (int k = 1; k < 3; ++k)
+              C.row (3*j+i) += Kp(k,j) * tmp.row (3*k+i);
+          }
+      }
+
+      /// w = R^T v, or R v if transpose is false.
+      inline void apply (const matrices3_t& R, const vectors3_t& v,
+          vectors3_t& w, bool transpose)
+      {
+        w.resize (3, v.cols ());
+        for (int i = 0; i < 3; ++i) {
+          w.row (i).array () = (transpose ? R.row (3*i).array ()
+              : R.row (i).array ()) * v.row (0).array ();
+          for (int k = 1; k < 3; ++k)
+            w.row (i).array () += (transpose ? R.row (3*i+k).array ()
+                : R.row (3*k+i).array ()) * v.row (k).array ();
+        }
+      }
+
+      /// c += a x b
+      inline void addCross (const vectors3_t& a, const vectors3_t& b,
+          vectors3_t& c)
+      {
+        for (int i = 0; i < 3; ++i) {
+          const int j = (i+1) % 3, k = (i+2) % 3;
+          c.row (i).array () += a.row (j).array () * b.row (k).array ()
+            - a.row (k).array () * b.row (j).array ();
+        }
+      }
+    } // namespace packed
+    /// \endcond
+
+    /// Compute \f$ (M_1 F_1)^{-1} M_2 F_2 \f$ for N pairs of placements.
+    ///
+    /// \param M1 placements of joint 1. If NULL, the identity.
+    /// \param F1 constant frame in joint 1,
+    /// \param M2 placements of joint 2,
+    /// \param F2 constant frame in joint 2,
+    /// \retval result the N relative placements.
+    inline void relativePlacements (const PackedPlacements* M1,
+        const Transform3f& F1, const PackedPlacements& M2,
+        const Transform3f& F2, PackedPlacements& result)
+    {
+      const size_type n = M2.size ();
+      assert (!M1 || M1->size () == n);
+      matrices3_t R;
+      vectors3_t t (M2.translation), tmp;
+      if (M1) {
+        packed::multiply (M1->rotation, M2.rotation, R, true);
+        t -= M1->translation;
+        packed::apply (M1->rotation, t, tmp, true);
+        t.swap (tmp);
+      } else {
+        R = M2.rotation;
+      }
+      // t = t_P + R_P t_F2 - t_F1
+      for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < 3; ++k)
+          t.row (i) += F2.translation ()[k] * R.row (3*k+i);
+        t.row (i).array () -= F1.translation ()[i];
+      }
+      result.resize (n);
+      packed::conjugate (F1.rotation (), R, F2.rotation (), result.rotation);
+      // R_F1^T t
+      const matrix3_t& R1 = F1.rotation ();
+      for (int i = 0; i < 3; ++i)
+        result.translation.row (i) = R1 (0, i) * t.row (0)
+          + R1 (1, i) * t.row (1) + R1 (2, i) * t.row (2);
+    }
+
+    /// Compute the jacobians of \f$ (M_1 F_1)^{-1} M_2 F_2 \f$ for N
+    /// configurations.
+    ///
+    /// The jacobians of the joints are gathered one velocity column at a
+    /// time into structures of arrays, so that each operation processes
+    /// the N configurations along a row and Eigen vectorizes it across
+    /// the configurations.
+    ///
+    /// \param M1, F1, M2, F2 see relativePlacements,
+    /// \param J1, J2 jacobians of the joints, expressed in the joint frame
+    ///        as Joint::jacobian. Columns [k nv, (k+1) nv[ are the jacobian
+    ///        at configuration k. J1 is not read if M1 is NULL.
+    /// \param Jlog if not NULL, the jacobians of the logs of the relative
+    ///        rotations, see computeJlogs.
+    /// \retval result matrix of size 6 x N nv, with the layout of J2. Rows
+    ///         0 to 2 are the jacobian of the translation of the relative
+    ///         placement. Rows 3 to 5 are the jacobian of the relative
+    ///         angular velocity in frame 1, multiplied by Jlog if not NULL.
+    inline void relativeJacobians (const PackedPlacements* M1, matrixIn_t J1,
+        const Transform3f& F1, const PackedPlacements& M2, matrixIn_t J2,
+        const Transform3f& F2, const matrices3_t* Jlog, matrixOut_t result)
+    {
+      typedef Eigen::Map <const Eigen::Matrix <value_type, 1, Eigen::Dynamic>,
+              0, Eigen::InnerStride <> > LanesIn_t;
+      typedef Eigen::Map <Eigen::Matrix <value_type, 1, Eigen::Dynamic>,
+              0, Eigen::InnerStride <> > LanesOut_t;
+      const size_type n = M2.size ();
+      if (n == 0) return;
+      const size_type nv = J2.cols () / n;
+      assert (!M1 || M1->size () == n);
+      assert (J2.rows () == 6 && J2.cols () == n * nv);
+      assert (!M1 || (J1.rows () == 6 && J1.cols () == n * nv));
+      assert (result.rows () == 6 && result.cols () == n * nv);
+
+      const matrix3_t& RF1 = F1.rotation ();
+      // L = RF1^T R1^T maps the world frame to frame 1.
+      matrices3_t L (9, n);
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) {
+          if (M1) {
+            L.row (3*j+i) = RF1 (0,i) * M1->rotation.row (j);
+            for (int m = 1; m < 3; ++m)
+              L.row (3*j+i) += RF1 (m,i) * M1->rotation.row (3*m+j);
+          } else L.row (3*j+i).setConstant (RF1 (j,i));
+        }
+      // p = R2 t_F2 and d = t2 - t1
+      vectors3_t p (3, n), d;
+      for (int i = 0; i < 3; ++i) {
+        p.row (i) = F2.translation ()[0] * M2.rotation.row (i);
+        for (int m = 1; m < 3; ++m)
+          p.row (i) += F2.translation ()[m] * M2.rotation.row (3*m+i);
+      }
+      if (M1) d = M2.translation - M1->translation;
+
+      vectors3_t v1 (3, n), w1 (3, n), v2 (3, n), w2 (3, n), T, W, a, b;
+      const Eigen::InnerStride <> stride1 (M1 ? nv * J1.outerStride () : 1),
+        stride2 (nv * J2.outerStride ()),
+        strideOut (nv * result.outerStride ());
+      for (size_type c = 0; c < nv; ++c) {
+        for (int i = 0; i < 3; ++i) {
+          v2.row (i) = LanesIn_t (J2.data () + i + c * J2.outerStride (),
+              n, stride2);
+          w2.row (i) = LanesIn_t (J2.data () + 3 + i + c * J2.outerStride (),
+              n, stride2);
+        }
+        // T = [ t2 - t1 ]x R1 Jw1 + R2 Jv2 - R1 Jv1
+        // W = R1 Jw1 - R2 Jw2
+        packed::apply (M2.rotation, v2, T, false);
+        packed::apply (M2.rotation, w2, W, false);
+        W = -W;
+        if (M1) {
+          for (int i = 0; i < 3; ++i) {
+            v1.row (i) = LanesIn_t (J1.data () + i + c * J1.outerStride (),
+                n, stride1);
+            w1.row (i) = LanesIn_t (J1.data () + 3 + i
+                + c * J1.outerStride (), n, stride1);
+          }
+          packed::apply (M1->rotation, w1, a, false);
+          W += a;
+          packed::addCross (d, a, T);
+          packed::apply (M1->rotation, v1, b, false);
+          T -= b;
+        }
+        // Velocity of the origin of frame 2: T + [ R2 t_F2 ]x W
+        packed::addCross (p, W, T);
+        packed::apply (L, T, a, false);
+        packed::apply (L, W, b, false);
+        b = -b;
+        if (Jlog) {
+          packed::apply (*Jlog, b, W, false);
+          b.swap (W);
+        }
+        for (int i = 0; i < 3; ++i) {
+          LanesOut_t (result.data () + i + c * result.outerStride (), n,
+              strideOut) = a.row (i);
+          LanesOut_t (result.data () + 3 + i + c * result.outerStride (), n,
+              strideOut) = b.row (i);
+        }
+      }
+    }
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_PACKED_KINEMATICS_HH
@@ -22,8 +22,9 @@
 # include <hpp/constraints/differentiable-function.hh>
 # include <hpp/constraints/convex-shape-contact.hh>
 # include <hpp/constraints/static-stability.hh>
+# include <hpp/constraints/contact-force-solver.hh>
 
-# include <qpOASES.hpp>
+# include <limits>
 
 namespace hpp {
   namespace constraints {
@@ -72,38 +73,147 @@ namespace hpp {
           return phi_;
         }
 
+        /// Method used to compute the contact forces.
+        enum Solver_t {
+          /// qpOASES on the problem with a variable per contact point.
+          FULL_QP,
+          /// qpOASES on the dual problem, with 6 variables and a
+          /// constraint per contact point.
+          REDUCED_QP,
+          /// NNLSContactForceSolver on the problem with a variable per
+          /// contact point.
+          NNLS,
+          /// DualActiveSetContactForceSolver on the dual problem.
+          DUAL_ACTIVE_SET,
+          /// A solver given to forceSolver.
+          CUSTOM
+        };
+
+        /// Set the method used to compute the contact forces.
+        /// The default is NNLS.
+        /// \throw std::invalid_argument for CUSTOM.
+        void solver (Solver_t solver);
+
+        Solver_t solver () const
+        {
+          return solver_;
+        }
+
+        /// Set the solver used to compute the contact forces.
+        /// It solves problems with a variable per contact point.
+        void forceSolver (const ContactForceSolverPtr_t& solver);
+
+        const ContactForceSolverPtr_t& forceSolver () const
+        {
+          return forceSolver_;
+        }
+
+        /// Use REDUCED_QP if reduced is true, FULL_QP otherwise.
+        void reducedProblem (bool reduced)
+        {
+          solver (reduced ? REDUCED_QP : FULL_QP);
+        }
+
+        bool reducedProblem () const
+        {
+          return solver_ == REDUCED_QP;
+        }
+
+        /// Number of quadratic programs solved.
+        std::size_t nbSolves () const
+        {
+          return nbSolves_;
+        }
+
+        /// Number of quadratic programs solved from the active set of the
+        /// previous solution.
+        std::size_t nbWarmStarts () const
+        {
+          return nbWarmStarts_;
+        }
+
+        /// Ratio of quadratic programs solved from the active set of the
+        /// previous solution.
+        value_type warmStartRate () const
+        {
+          if (nbSolves_ == 0) return 0;
+          return (value_type) nbWarmStarts_ / (value_type) nbSolves_;
+        }
+
+        /// Stop the contact force solver when the violation of the
+        /// optimality conditions is less than tolerance.
+        ///
+        /// The tolerance of the solver is the largest of tolerance and of
+        /// its tolerance when it was set. Its maximal number of iterations
+        /// can be set with forceSolver ()->maxIterations.
+        virtual void accuracy (value_type tolerance);
+
+        value_type accuracy () const
+        {
+          return accuracy_;
+        }
+
+        /// Save the contact forces of the last solution.
+        /// The contact force solver starts from their active set.
+        virtual void saveWarmStart (vector_t& state) const;
+
+        /// Start the next quadratic program from saved contact forces.
+        /// See ContactForceSolver::warmStart.
+        virtual void restoreWarmStart (vectorIn_t state);
+
+        /// The memory of the contact force solver is not counted.
+        virtual MemoryUsage memoryUsage () const;
+
+        /// Solving the quadratic program dominates the forward kinematics.
+        virtual value_type evaluationCost () const
+        {
+          return 20 + (value_type) nbContacts_;
+        }
+
       private:
         static const Eigen::Matrix <value_type, 6, 1> MinusGravity;
 
-        qpOASES::real_t* Zeros;
-        const qpOASES::int_t nWSR;
-
         void impl_compute (vectorOut_t result, ConfigurationIn_t argument) const;
 
         void impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const;
 
-        qpOASES::returnValue solveQP (vectorOut_t result) const;
+        void impl_valueAndJacobian (vectorOut_t result, matrixOut_t jacobian,
+            ConfigurationIn_t argument) const;
+
+        /// Compute the jacobian from the current QP solution.
+        void computeJacobian (matrixOut_t jacobian) const;
+
+        /// \return whether the solution is optimal.
+        bool solveQP (vectorOut_t result) const;
+
+        /// Set the tolerance of forceSolver_ from accuracy_.
+        void updateTolerance ();
 
         bool checkQPSol () const;
         bool checkStrictComplementarity () const;
 
         DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
         std::size_t nbContacts_;
         CenterOfMassComputationPtr_t com_;
 
         typedef MatrixOfExpressions<eigen::vector3_t, JacobianMatrix> MoE_t;
-        typedef Eigen::Matrix<qpOASES::real_t, Eigen::Dynamic, Eigen::Dynamic,
-                Eigen::RowMajor> RowMajorMatrix_t;
-        typedef Eigen::Map <RowMajorMatrix_t> InvertStorageOrderMap_t;
-        typedef Eigen::Map <Eigen::Matrix <qpOASES::real_t, Eigen::Dynamic, 1>
-          > VectorMap_t;
-        typedef Eigen::Map <const vector_t> ConstVectorMap_t;
-
-        mutable RowMajorMatrix_t H_;
-        mutable vector_t G_;
-        mutable qpOASES::QProblemB qp_;
+
+        ContactForceSolverPtr_t forceSolver_;
+        /// Tolerance of forceSolver_ when it was set, and the tolerance
+        /// given to accuracy.
+        value_type exactTolerance_, accuracy_;
+        /// Memory of the nodes of phi_.
+        CalculusArena arena_;
         mutable MoE_t phi_;
         mutable vector_t primal_, dual_;
+
+        /// Version of the KinematicsCache of the last solution.
+        mutable std::size_t solvedVersion_;
+        mutable value_type objective_;
+        mutable bool solvedOptimal_;
+        mutable std::size_t nbSolves_, nbWarmStarts_;
+        Solver_t solver_;
     };
     /// \}
   } // namespace constraints
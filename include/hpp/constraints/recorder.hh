@@ -0,0 +1,225 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_RECORDER_HH
+# define HPP_CONSTRAINTS_RECORDER_HH
+
+# include <fstream>
+# include <string>
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Record the evaluations of a function in a file.
+    ///
+    /// The recorder is a function that evaluates the wrapped function and
+    /// appends the kind of evaluation, its duration and the configuration to
+    /// the file. Replace a constraint, or a whole stack, by its recorder to
+    /// record a workload of an application, and replay it on the same
+    /// constraints with Recording::replay.
+    ///
+    /// The file starts with
+    /// \li the 8 characters "HPPCREC1",
+    /// \li 7 unsigned 64 bits integers: the input size, the input
+    ///     derivative size, the output size, the output derivative size of
+    ///     the function, the size of the description, the size of a record,
+    ///     and 0,
+    /// \li the description, padded with zeros to a multiple of 8 bytes. It
+    ///     is the name of the function followed by its print.
+    ///
+    /// It is followed by the records, of 16 + 8 * inputSize bytes: the kind
+    /// (a EvaluationStatistics::Evaluation) and the duration in nanoseconds,
+    /// as 64 bits integers, followed by the configuration as doubles.
+    /// Numbers are in the byte order of the machine. Since the records have
+    /// a fixed size, the file can be memory-mapped and read while it is
+    /// being recorded.
+    ///
+    /// \note Only the value, the jacobian and valueAndJacobian are
+    ///       recorded. The other evaluations are forwarded to the wrapped
+    ///       function by the default implementations of
+    ///       DifferentiableFunction, that call them.
+    class HPP_CONSTRAINTS_DLLAPI Recorder : public DifferentiableFunction
+    {
+      public:
+        /// Return a shared pointer to a new instance.
+        /// \param function the wrapped function,
+        /// \param filename file created, or truncated, to record the calls.
+        /// \throw std::runtime_error if the file cannot be opened.
+        static RecorderPtr_t create
+          (const DifferentiableFunctionPtr_t& function,
+           const std::string& filename);
+
+        virtual ~Recorder () throw () {}
+
+        const DifferentiableFunctionPtr_t& function () const
+        {
+          return function_;
+        }
+
+        /// Number of evaluations recorded.
+        std::size_t nbRecords () const
+        {
+          return nbRecords_;
+        }
+
+        /// Write the records to the file.
+        void flush ();
+
+        virtual void jacobianPattern (ArrayXXb& pattern) const
+        {
+          function_->jacobianPattern (pattern);
+        }
+
+        virtual value_type evaluationCost () const
+        {
+          return function_->evaluationCost ();
+        }
+
+        virtual value_type lipschitzConstant () const
+        {
+          return function_->lipschitzConstant ();
+        }
+
+        virtual void approximate (bool approximate)
+        {
+          function_->approximate (approximate);
+        }
+
+        virtual void accuracy (value_type tolerance)
+        {
+          function_->accuracy (tolerance);
+        }
+
+        virtual void saveWarmStart (vector_t& state) const
+        {
+          function_->saveWarmStart (state);
+        }
+
+        virtual void restoreWarmStart (vectorIn_t state)
+        {
+          function_->restoreWarmStart (state);
+        }
+
+        virtual std::ostream& print (std::ostream& o) const;
+
+      protected:
+        Recorder (const DifferentiableFunctionPtr_t& function,
+                  const std::string& filename);
+
+        void impl_compute (vectorOut_t result, vectorIn_t argument) const;
+
+        void impl_jacobian (matrixOut_t jacobian, vectorIn_t argument) const;
+
+        void impl_valueAndJacobian (vectorOut_t result, matrixOut_t jacobian,
+                                    vectorIn_t argument) const;
+
+      private:
+        void record (EvaluationStatistics::Evaluation evaluation, long start,
+            vectorIn_t argument) const;
+
+        DifferentiableFunctionPtr_t function_;
+        mutable std::ofstream file_;
+        mutable std::size_t nbRecords_;
+    }; // class Recorder
+
+    /// The evaluations recorded by a Recorder.
+    class HPP_CONSTRAINTS_DLLAPI Recording
+    {
+      public:
+        /// Read a file written by a Recorder.
+        /// An incomplete last record is ignored.
+        /// \throw std::runtime_error if the file cannot be read or is not
+        ///        a recording.
+        static RecordingPtr_t load (const std::string& filename);
+
+        /// Name and print of the recorded function.
+        const std::string& description () const
+        {
+          return description_;
+        }
+
+        size_type inputSize () const
+        {
+          return arguments_.rows ();
+        }
+
+        size_type inputDerivativeSize () const
+        {
+          return inputDerivativeSize_;
+        }
+
+        size_type outputSize () const
+        {
+          return outputSize_;
+        }
+
+        size_type outputDerivativeSize () const
+        {
+          return outputDerivativeSize_;
+        }
+
+        /// Number of recorded evaluations.
+        std::size_t size () const
+        {
+          return evaluations_.size ();
+        }
+
+        EvaluationStatistics::Evaluation evaluation (std::size_t i) const
+        {
+          return evaluations_ [i];
+        }
+
+        /// Duration of evaluation i, in seconds.
+        value_type duration (std::size_t i) const
+        {
+          return durations_ [(size_type) i];
+        }
+
+        /// Configuration of evaluation i.
+        vectorIn_t argument (std::size_t i) const
+        {
+          return arguments_.col ((size_type) i);
+        }
+
+        /// Evaluate a function in the recorded sequence.
+        ///
+        /// \param function a function of the same sizes as the recorded one,
+        /// \retval durations the duration of each evaluation, in seconds.
+        /// \throw std::invalid_argument if the sizes differ.
+        void replay (const DifferentiableFunction& function,
+            vector_t& durations) const;
+
+      private:
+        Recording () {}
+
+        std::string description_;
+        size_type inputDerivativeSize_, outputSize_, outputDerivativeSize_;
+        std::vector <EvaluationStatistics::Evaluation> evaluations_;
+        vector_t durations_;
+        matrix_t arguments_;
+    }; // class Recording
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_RECORDER_HH
@@ -68,10 +68,54 @@ namespace hpp {
                                       std::vector <bool> mask =
                                       boost::assign::list_of (true)(true)(true));
       virtual ~RelativeCom () throw () {}
+
+      /// The center of mass is a weighted mean of the centers of mass of
+      /// the bodies. The largest velocity bound of a body relative to the
+      /// joint is returned.
+      virtual value_type lipschitzConstant () const;
       RelativeCom (const DevicePtr_t& robot,
           const CenterOfMassComputationPtr_t& comc,
           const JointPtr_t& joint, const vector3_t reference,
           std::vector <bool> mask);
+
+      /// Desired position of the center of mass in the joint frame.
+      const vector3_t& reference () const
+      {
+        return reference_;
+      }
+
+      void reference (const vector3_t& reference)
+      {
+        reference_ = reference;
+      }
+
+      /// Jacobian of the value with respect to the reference.
+      /// It is the opposite of the rows of the mask of the identity and
+      /// does not depend on the configuration.
+      /// \retval jacobian matrix of size outputSize () x 3.
+      void referenceJacobian (matrixOut_t jacobian) const
+      {
+        jacobian = - selection_;
+      }
+
+      /// Register the joint and the center of mass read by the function in
+      /// a batch of forward kinematics, see valueFromKinematics.
+      void addKinematics (KinematicsBatch& batch) const;
+
+      /// Evaluate the function at the configurations of a batch of forward
+      /// kinematics.
+      /// \retval values column k is the value at configuration k.
+      /// The Device is not read.
+      void valueFromKinematics (matrixOut_t values,
+          const KinematicsBatch& batch) const;
+
+      /// Compute the jacobians at the configurations of a batch of forward
+      /// kinematics, computed with KinematicsCache::JACOBIANS.
+      /// \retval jacobians columns
+      ///         [k * inputDerivativeSize (), (k+1) * inputDerivativeSize ()[
+      ///         are the jacobian at configuration k.
+      void jacobianFromKinematics (matrixOut_t jacobians,
+          const KinematicsBatch& batch) const;
     protected:
       /// Compute value of error
       ///
@@ -82,14 +126,46 @@ namespace hpp {
 	const throw ();
       virtual void impl_jacobian (matrixOut_t jacobian,
 				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_valueAndJacobian (vectorOut_t result,
+                                          matrixOut_t jacobian,
+                                          ConfigurationIn_t arg) const throw ();
+      /// The products are computed block by block on the active columns
+      /// without forming the jacobian.
+      virtual void impl_jacobianTimes (vectorOut_t result,
+                                       ConfigurationIn_t arg,
+                                       vectorIn_t v) const;
+      virtual void impl_jacobianTransposeTimes (vectorOut_t result,
+                                                ConfigurationIn_t arg,
+                                                vectorIn_t w) const;
     private:
+      /// Compute value from the placement of the joint and the center of
+      /// mass.
+      void computeValue (vectorOut_t result, const Transform3f& M,
+                         const vector3_t& x) const;
+      /// Compute jacobian from the kinematics of the joint and the center
+      /// of mass.
+      void computeJacobian (matrixOut_t jacobian, const Transform3f& M,
+                            const vector3_t& x, matrixIn_t Jcom,
+                            matrixIn_t Jjoint) const;
+
+      /// Selection of the rows of the mask, at most 3 x 3.
+      typedef Eigen::Matrix <value_type, Eigen::Dynamic, 3, Eigen::RowMajor,
+                             3, 3> RowSelection_t;
+      /// First column and number of columns of a block of active columns.
+      typedef std::pair <size_type, size_type> Segment_t;
+
       DevicePtr_t robot_;
-      CenterOfMassComputationPtr_t comc_;
+      KinematicsCachePtr_t kinematics_;
+      CenterOfMassCachePtr_t com_;
       JointPtr_t joint_;
       vector3_t reference_;
       std::vector <bool> mask_;
-      bool nominalCase_;
-      mutable ComJacobian_t jacobian_;
+      RowSelection_t selection_;
+      /// Blocks of active columns.
+      std::vector <Segment_t> columns_;
+
+      /// Evaluates the compiled stacks without virtual call.
+      friend class DifferentiableFunctionStack;
     }; // class RelativeCom
     /// \}
   } // namespace constraints
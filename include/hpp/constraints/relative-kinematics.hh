@@ -0,0 +1,123 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_RELATIVE_KINEMATICS_HH
+# define HPP_CONSTRAINTS_RELATIVE_KINEMATICS_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Kinematic quantities of a pair of joints that do not depend on the
+    /// frames attached to the joints.
+    ///
+    /// Several GenericTransformation bound to the same pair of joints with
+    /// different frames (several handles of the same object for instance)
+    /// share the same instance. The quantities are computed once for each
+    /// version of the KinematicsCache and each function only applies the
+    /// correction due to its frames.
+    ///
+    /// Let \f$R_i, t_i\f$ be the placement of joint \f$i\f$ and
+    /// \f$J_{i\,\mathbf{v}}, J_{i\,\omega}\f$ its jacobian expressed in the
+    /// joint frame. This class stores
+    /// \li the placement \f$M_1^{-1} M_2\f$ of joint 2 in joint 1,
+    /// \li \f$T = R_2 J_{2\,\mathbf{v}} - R_1 J_{1\,\mathbf{v}} +
+    ///     \left[t_2 - t_1\right]_{\times} R_1 J_{1\,\omega}\f$,
+    /// \li \f$W = R_1 J_{1\,\omega} - R_2 J_{2\,\omega}\f$.
+    ///
+    /// The velocity of a point \f$p\f$ fixed in joint 2 with respect to
+    /// joint 1, expressed in the world frame, is then
+    /// \f$T + \left[R_2 p\right]_{\times} W\f$ and the relative angular
+    /// velocity is \f$-W\f$.
+    ///
+    /// When joint 1 is NULL, it is the world frame.
+    ///
+    /// \note The jacobians restricted to columns
+    ///       [colBegin, colBegin + activeCols[ are stored.
+    class HPP_CONSTRAINTS_DLLAPI RelativeKinematics
+    {
+      public:
+        typedef Eigen::Matrix<value_type, 3, Eigen::Dynamic> Jacobian_t;
+
+        /// Get the instance for a pair of joints.
+        /// It is created if it does not exist.
+        /// \param kinematics cache of the robot the joints belong to,
+        /// \param colBegin, activeCols range of columns where the jacobians
+        ///        of the joints may be non zero.
+        static RelativeKinematicsPtr_t get
+          (const KinematicsCachePtr_t& kinematics,
+           const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
+           size_type colBegin, size_type activeCols);
+
+        /// Placement of joint 2 in joint 1.
+        const Transform3f& placement () const
+        {
+          if (placementVersion_ != kinematics_->version ()) computePlacement ();
+          return placement_;
+        }
+
+        /// Relative linear velocity of the center of joint 2.
+        const Jacobian_t& translation () const
+        {
+          if (jacobianVersion_ != kinematics_->version ()) computeJacobian ();
+          return translation_;
+        }
+
+        /// Opposite of the relative angular velocity.
+        const Jacobian_t& rotation () const
+        {
+          if (jacobianVersion_ != kinematics_->version ()) computeJacobian ();
+          return rotation_;
+        }
+
+        const JointConstPtr_t& joint1 () const
+        {
+          return joint1_;
+        }
+
+        const JointConstPtr_t& joint2 () const
+        {
+          return joint2_;
+        }
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      private:
+        RelativeKinematics (const KinematicsCachePtr_t& kinematics,
+           const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
+           size_type colBegin, size_type activeCols);
+
+        void computePlacement () const;
+        void computeJacobian () const;
+
+        KinematicsCachePtr_t kinematics_;
+        JointConstPtr_t joint1_, joint2_;
+        size_type colBegin_, activeCols_;
+
+        mutable Transform3f placement_;
+        mutable Jacobian_t translation_, rotation_;
+        mutable std::size_t placementVersion_, jacobianVersion_;
+    }; // class RelativeKinematics
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_RELATIVE_KINEMATICS_HH
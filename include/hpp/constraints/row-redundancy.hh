@@ -0,0 +1,101 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_ROW_REDUNDANCY_HH
+# define HPP_CONSTRAINTS_ROW_REDUNDANCY_HH
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Detect the rows of the jacobian of a stack that are linear
+    /// combinations of other rows.
+    ///
+    /// Stacking overlapping constraints (a Transformation and a Position of
+    /// the same frame, grasps in a closed chain...) gives a jacobian with
+    /// more rows than its rank. A row is redundant if
+    /// \li its jacobian pattern is empty or its function is inactive
+    ///     (structural redundancy), or
+    /// \li at each sample configuration given to analyse, it is in the
+    ///     span of the rows that precede it and that are not redundant at
+    ///     this configuration (numeric redundancy).
+    ///
+    /// The rows are examined in the order of the stack, so that the
+    /// functions added first are kept.
+    ///
+    /// \note numeric redundancy only holds at the samples. The values are
+    ///       not considered: redundant constraints may still be
+    ///       inconsistent.
+    class HPP_CONSTRAINTS_DLLAPI RowRedundancy
+    {
+      public:
+        /// \param threshold a row is dependent on other rows if the norm of
+        ///        its component orthogonal to these rows is below
+        ///        threshold times its norm.
+        RowRedundancy (const DifferentiableFunctionStackPtr_t& stack,
+            value_type threshold = 1e-8);
+
+        /// Analyse the jacobian at each column of configurations.
+        void analyse (matrixIn_t configurations);
+
+        /// Rows of the jacobian that are redundant.
+        const ArrayXb& redundantRows () const
+        {
+          return redundant_;
+        }
+
+        /// Rows of the jacobian that are structurally zero.
+        const ArrayXb& structurallyZeroRows () const
+        {
+          return structural_;
+        }
+
+        /// Maximal rank of the jacobian over the samples.
+        size_type rank () const
+        {
+          return rank_;
+        }
+
+        /// Whether all the rows of function i of the stack are redundant.
+        bool redundant (std::size_t i) const;
+
+        /// Deactivate the active functions whose rows are all redundant.
+        /// \return the number of deactivated functions.
+        std::size_t prune ();
+
+        /// Stack of the active functions that have a row that is not
+        /// redundant.
+        DifferentiableFunctionStackPtr_t reducedStack () const;
+
+      private:
+        DifferentiableFunctionStackPtr_t stack_;
+        value_type threshold_;
+        ArrayXb structural_, redundant_;
+        size_type rank_;
+        /// Orthonormal basis of the rows kept at a sample.
+        matrix_t basis_;
+        matrix_t jacobian_;
+    }; // class RowRedundancy
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_ROW_REDUNDANCY_HH
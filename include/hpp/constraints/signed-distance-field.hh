@@ -0,0 +1,134 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CONSTRAINTS_SIGNED_DISTANCE_FIELD_HH
+# define HPP_CONSTRAINTS_SIGNED_DISTANCE_FIELD_HH
+
+# include <string>
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Signed distance to a set of fixed objects, sampled on a voxel grid.
+    ///
+    /// The grid covers the bounding box of the objects, enlarged by a margin.
+    /// A voxel is occupied if it collides with one of the objects. The value
+    /// at the center of a voxel is the distance to the closest voxel of the
+    /// other kind, computed by an exact Euclidean distance transform, positive
+    /// outside the objects and negative inside. Values in between are
+    /// interpolated trilinearly.
+    ///
+    /// Baking the grid requires one collision test per voxel close to the
+    /// objects. The grid can be saved in a cache file, which is mapped in
+    /// memory by the next instance built with the same objects and
+    /// parameters.
+    ///
+    /// \note the objects are not updated: the field is only valid for
+    ///       objects that do not move.
+    class HPP_CONSTRAINTS_DLLAPI SignedDistanceField
+    {
+      public:
+        /// Bake the field.
+        /// \param objects the fixed objects,
+        /// \param resolution size of a voxel,
+        /// \param margin distance between the bounding box of the objects
+        ///        and the border of the grid. Beyond the grid, the distance
+        ///        is extrapolated from the border.
+        /// \param cacheFile if not empty, the grid is read from this file if
+        ///        it was built with the same objects and parameters.
+        ///        Otherwise, it is baked and written to this file.
+        ///
+        /// The cache is identified by the names, the placements and the
+        /// bounding spheres of the objects. Remove the file when the
+        /// geometry of an object changes.
+        static SignedDistanceFieldPtr_t create
+          (const std::vector <CollisionObjectPtr_t>& objects,
+           value_type resolution, value_type margin,
+           const std::string& cacheFile = "");
+
+        ~SignedDistanceField ();
+
+        /// Signed distance at a point of the world frame.
+        value_type value (const vector3_t& point) const;
+
+        /// Signed distance and its gradient at a point.
+        value_type value (const vector3_t& point, vector3_t& gradient) const;
+
+        /// Center of the first voxel.
+        const vector3_t& origin () const
+        {
+          return origin_;
+        }
+
+        value_type resolution () const
+        {
+          return resolution_;
+        }
+
+        /// Number of voxels along each axis.
+        const Eigen::Vector3i& dimensions () const
+        {
+          return dimensions_;
+        }
+
+        /// Whether the grid was mapped from the cache file.
+        bool mapped () const
+        {
+          return map_ != NULL;
+        }
+
+      private:
+        SignedDistanceField (value_type resolution);
+        SignedDistanceField (const SignedDistanceField&);
+        SignedDistanceField& operator= (const SignedDistanceField&);
+
+        /// Compute the values of the voxels.
+        void bake (const std::vector <CollisionObjectPtr_t>& objects);
+
+        /// Map the grid from a cache file.
+        /// \return false if the file does not exist or does not match.
+        bool load (const std::string& file, unsigned long long key);
+
+        void save (const std::string& file, unsigned long long key) const;
+
+        /// Value of voxel (i, j, k).
+        value_type at (int i, int j, int k) const
+        {
+          return values_ [(k * dimensions_ [1] + j) * dimensions_ [0] + i];
+        }
+
+        vector3_t origin_;
+        value_type resolution_;
+        Eigen::Vector3i dimensions_;
+        /// Voxel values, the first index varying the fastest. They point
+        /// either to buffer_ or to the mapped cache file.
+        const float* values_;
+        std::vector <float> buffer_;
+        void* map_;
+        std::size_t mapSize_;
+    }; // class SignedDistanceField
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_SIGNED_DISTANCE_FIELD_HH
@@ -62,15 +62,47 @@ namespace hpp {
             const Contacts_t& contacts,
             const CenterOfMassComputationPtr_t& com);
 
-        MatrixOfExpressions<>& phi () {
+        /// The singular value decomposition of phi is warm started from the
+        /// one of the previous evaluation.
+        typedef MatrixOfExpressions<eigen::vector3_t, JacobianMatrix,
+                WarmStartJacobiSVD <Eigen::Matrix <value_type, Eigen::Dynamic,
+                                    Eigen::Dynamic> > > MoE_t;
+
+        MoE_t& phi () {
           return phi_;
         }
 
+        virtual MemoryUsage memoryUsage () const;
+
+        /// Save the orthogonal factor the decomposition of phi starts from.
+        virtual void saveWarmStart (vector_t& state) const;
+
+        virtual void restoreWarmStart (vectorIn_t state);
+
       private:
         void impl_compute (vectorOut_t result, ConfigurationIn_t argument) const;
 
         void impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const;
 
+        void impl_valueAndJacobian (vectorOut_t result, matrixOut_t jacobian,
+            ConfigurationIn_t argument) const;
+
+        /// Compute value from the current SVD of phi.
+        /// \return true if u has negative components.
+        bool computeValue (vectorOut_t result) const;
+
+        /// Compute jacobian from the current SVD of phi.
+        /// \param hasUMinus whether u has negative components.
+        /// \note u_, uMinus_ and v_ must be up to date.
+        ///
+        /// The derivatives of \f$ u = \Phi^+ G \f$ and of
+        /// \f$ v = (I - \Phi^+ \Phi) u^- \f$ share the contractions of the
+        /// jacobian of \f$ \Phi \f$: they are computed in one pass on
+        /// \f$ \frac{d\Phi}{dq} \f$ with right hand sides \f$ u, v \f$
+        /// and one pass on \f$ \frac{d\Phi^T}{dq} \f$ with right hand sides
+        /// \f$ (I - \Phi\Phi^+) G, \Phi^{+T} u, \Phi^{+T} (u^- - v) \f$.
+        void computeJacobian (matrixOut_t jacobian, bool hasUMinus) const;
+
         static void findBoundIndex (vectorIn_t u, vectorIn_t v, 
             value_type& lambdaMin, size_type* iMin,
             value_type& lambdaMax, size_type* iMax);
@@ -79,22 +111,29 @@ namespace hpp {
         bool computeUminusAndV (vectorIn_t u, vectorOut_t uMinus,
             vectorOut_t v) const;
 
-        void computeVDot (vectorIn_t uMinus, vectorIn_t S,
-            matrixIn_t uDot, matrixOut_t uMinusDot, matrixOut_t vDot) const;
-
         void computeLambdaDot (vectorIn_t u, vectorIn_t v, const std::size_t i0,
             matrixIn_t uDot, matrixIn_t vDot, vectorOut_t lambdaDot) const;
 
         DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
         Contacts_t contacts_;
         CenterOfMassComputationPtr_t com_;
 
-        typedef MatrixOfExpressions<eigen::vector3_t, JacobianMatrix> MoE_t;
-
+        /// Memory of the nodes of phi_.
+        CalculusArena arena_;
         mutable MoE_t phi_;
         mutable vector_t u_, uMinus_, v_;
         mutable matrix_t uDot_, uMinusDot_, vDot_;
         mutable vector_t lambdaDot_; 
+        // Buffers of computeJacobian.
+        mutable vector_t s_;
+        /// Right hand sides of the passes on the jacobian of phi and their
+        /// results, see computeJacobian.
+        mutable matrix_t timesRhs_, transposeTimesRhs_;
+        mutable matrix_t times_, transposeTimes_;
+        /// \f$ V_1^T X \f$ of the projections on the kernel of phi.
+        mutable matrix_t V1tX_;
+        mutable Eigen::Matrix <value_type, 6, Eigen::Dynamic> piTX_;
     };
     /// \}
   } // namespace constraints
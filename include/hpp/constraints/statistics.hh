@@ -0,0 +1,122 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_STATISTICS_HH
+# define HPP_CONSTRAINTS_STATISTICS_HH
+
+# include <iosfwd>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+/// Expand to its argument only if the library is compiled with
+/// ENABLE_STATISTICS, so that the instrumentation costs nothing otherwise.
+# ifdef HPP_CONSTRAINTS_WITH_STATISTICS
+#  define HPP_CONSTRAINTS_STATISTICS(statement) statement
+# else
+#  define HPP_CONSTRAINTS_STATISTICS(statement)
+# endif
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Statistics on the evaluations of a DifferentiableFunction.
+    ///
+    /// They are recorded only if the library is compiled with the CMake
+    /// option ENABLE_STATISTICS. See DifferentiableFunction::statistics.
+    ///
+    /// Times are wall times in seconds and include the evaluation of the
+    /// functions called by the function (the functions of a
+    /// DifferentiableFunctionStack for instance). The other counters are
+    /// only incremented for the innermost function being evaluated.
+    ///
+    /// \note The counters are not synchronized so the statistics of a
+    ///       function evaluated concurrently by several threads are
+    ///       approximate.
+    struct HPP_CONSTRAINTS_DLLAPI EvaluationStatistics
+    {
+      /// Kind of evaluation.
+      enum Evaluation {
+        VALUE,
+        JACOBIAN,
+        VALUE_AND_JACOBIAN
+      };
+
+      /// Number of evaluations of the value, of the jacobian, and of both.
+      std::size_t nbValues, nbJacobians, nbValueAndJacobians;
+      /// Time spent in each kind of evaluation.
+      value_type valueTime, jacobianTime, valueAndJacobianTime;
+      /// Calls to KinematicsCache::update that computed the forward
+      /// kinematics and calls that did not need to.
+      std::size_t nbKinematicsUpdates, nbKinematicsHits;
+      /// Quadratic programs solved, working set recalculations of the
+      /// solver and failures (QPStaticStability).
+      std::size_t nbQPSolves, nbQPIterations, nbQPFailures;
+      /// Exact distance computations between pairs of geometries
+      /// (DistanceBetweenBodies).
+      std::size_t nbNarrowPhases;
+
+      EvaluationStatistics ()
+      {
+        reset ();
+      }
+
+      /// Set all the counters to zero.
+      void reset ();
+
+      /// Total time spent in the evaluations.
+      value_type time () const
+      {
+        return valueTime + jacobianTime + valueAndJacobianTime;
+      }
+
+      EvaluationStatistics& operator+= (const EvaluationStatistics& other);
+
+      /// Name of an evaluation, "value", "jacobian" or "valueAndJacobian".
+      static const char* name (Evaluation evaluation);
+
+      /// Statistics of the function being evaluated by the calling thread.
+      /// \return NULL if no function is being evaluated.
+      static EvaluationStatistics* current ();
+
+      /// Record an evaluation for the lifetime of the instance.
+      ///
+      /// The evaluation becomes the current one of the thread, measures
+      /// its time and restores the previous one when destroyed.
+      class HPP_CONSTRAINTS_DLLAPI Scope
+      {
+        public:
+          Scope (EvaluationStatistics& statistics, Evaluation evaluation);
+          ~Scope ();
+
+        private:
+          EvaluationStatistics& statistics_;
+          EvaluationStatistics* previous_;
+          Evaluation evaluation_;
+          long start_;
+      }; // class Scope
+    }; // struct EvaluationStatistics
+
+    /// Write the counters on one line.
+    HPP_CONSTRAINTS_DLLAPI std::ostream& operator<<
+      (std::ostream& os, const EvaluationStatistics& statistics);
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_STATISTICS_HH
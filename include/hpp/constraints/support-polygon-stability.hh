@@ -0,0 +1,123 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_SUPPORT_POLYGON_STABILITY_HH
+# define HPP_CONSTRAINTS_SUPPORT_POLYGON_STABILITY_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+# include <hpp/constraints/convex-shape-contact.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Static stability on horizontal coplanar contacts.
+    ///
+    /// When the normals of the contacts are vertical and the contact points
+    /// lie in a horizontal plane, the robot is statically stable if and
+    /// only if the projection of its center of mass on the plane is inside
+    /// the convex hull of the contact points. The value of the function is
+    /// then the signed distance of the projection to the convex hull,
+    /// negative inside. No SVD nor QP is needed.
+    ///
+    /// Otherwise, the function falls back to QPStaticStability and its value
+    /// is the residual of QPStaticStability, see supportPolygon.
+    class HPP_CONSTRAINTS_DLLAPI SupportPolygonStability :
+      public DifferentiableFunction
+    {
+      public:
+        typedef ConvexShapeContact::ForceData ForceData;
+
+        static SupportPolygonStabilityPtr_t create (const std::string& name,
+            const DevicePtr_t& robot, const std::vector <ForceData>& contacts,
+            const CenterOfMassComputationPtr_t& com);
+
+        virtual ~SupportPolygonStability () throw () {}
+
+        /// Whether the last evaluation used the support polygon, as opposed
+        /// to QPStaticStability.
+        bool supportPolygon () const
+        {
+          return supportPolygon_;
+        }
+
+        /// Tolerance on the height of the points and on the angle between
+        /// the normals and the vertical.
+        void tolerance (value_type eps)
+        {
+          tolerance_ = eps;
+        }
+
+      protected:
+        SupportPolygonStability (const std::string& name,
+            const DevicePtr_t& robot, const std::vector <ForceData>& contacts,
+            const CenterOfMassComputationPtr_t& com);
+
+        virtual void impl_compute (vectorOut_t result,
+            ConfigurationIn_t argument) const throw ();
+        virtual void impl_jacobian (matrixOut_t jacobian,
+            ConfigurationIn_t argument) const throw ();
+        virtual void impl_valueAndJacobian (vectorOut_t result,
+            matrixOut_t jacobian, ConfigurationIn_t argument) const throw ();
+
+      private:
+        /// A contact point.
+        struct Point
+        {
+          JointPtr_t joint;
+          vector3_t local;
+        };
+
+        /// Compute the contact points in the world frame and the convex
+        /// hull of their projections.
+        /// \return false if the contacts are not horizontal and coplanar.
+        bool computeSupport (ConfigurationIn_t argument, bool jacobian) const;
+        /// Compute the signed distance of the projection of the center of
+        /// mass and its gradient with respect to the closest vertices.
+        value_type computeDistance () const;
+        /// Add the gradient of a point to the jacobian.
+        void addPointJacobian (std::size_t i, const vector3_t& g,
+            matrixOut_t jacobian) const;
+
+        DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
+        CenterOfMassCachePtr_t com_;
+        std::vector <Point> points_;
+        std::vector <vector3_t> normals_;
+        std::vector <JointPtr_t> normalJoints_;
+        QPStaticStabilityPtr_t fallback_;
+        value_type tolerance_;
+
+        mutable bool supportPolygon_;
+        /// Contact points in the world frame.
+        mutable std::vector <vector3_t> world_;
+        /// Indices of the vertices of the convex hull, counterclockwise.
+        mutable std::vector <std::size_t> hull_, order_;
+        /// Closest vertices and gradients of the distance with respect to
+        /// the center of mass and to these vertices.
+        mutable std::size_t ia_, ib_;
+        mutable vector3_t gc_, ga_, gb_;
+    }; // class SupportPolygonStability
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_SUPPORT_POLYGON_STABILITY_HH
@@ -19,8 +19,13 @@
 #ifndef HPP_CONSTRAINTS_SVD_HH
 # define HPP_CONSTRAINTS_SVD_HH
 
+# include <algorithm>
+# include <cmath>
+# include <limits>
+
 # include <hpp/constraints/fwd.hh>
 # include <Eigen/SVD>
+# include <Eigen/Eigenvalues>
 
 namespace hpp {
   namespace constraints {
@@ -68,7 +73,7 @@ namespace hpp {
     }
 
     template < typename SVD >
-    void projectorOnSpan (const SVD svd,
+    void projectorOnSpan (const SVD& svd,
         Eigen::Ref <typename SVD::MatrixType> projector)
     {
       eigen_assert(svd.computeU() && svd.computeV() && "Eigen::JacobiSVD "
@@ -78,7 +83,7 @@ namespace hpp {
     }
 
     template < typename SVD >
-    void projectorOnSpanOfInv (const SVD svd,
+    void projectorOnSpanOfInv (const SVD& svd,
         Eigen::Ref <typename SVD::MatrixType> projector)
     {
       eigen_assert(svd.computeU() && svd.computeV() && "Eigen::JacobiSVD "
@@ -88,7 +93,7 @@ namespace hpp {
     }
 
     template < typename SVD >
-    void projectorOnKernel (const SVD svd,
+    void projectorOnKernel (const SVD& svd,
         Eigen::Ref <typename SVD::MatrixType> projector,
         const bool& computeFullV = false)
     {
@@ -104,7 +109,7 @@ namespace hpp {
     }
 
     template < typename SVD >
-    void projectorOnKernelOfInv (const SVD svd,
+    void projectorOnKernelOfInv (const SVD& svd,
         Eigen::Ref <typename SVD::MatrixType> projector,
         const bool& computeFullU = false)
     {
@@ -120,6 +125,436 @@ namespace hpp {
         projector.diagonal().noalias () += vector_t::Ones(svd.matrixU().rows());
       }
     }
+
+    /// Apply the projectors defined by a singular value decomposition
+    /// \f$ A = U_1 \Sigma_1 V_1^T \f$ without forming them.
+    ///
+    /// The projectors are computed from \f$ U_1 \f$ and \f$ V_1 \f$ only,
+    /// i.e. \f$ U_2 U_2^T = I - U_1 U_1^T \f$ and
+    /// \f$ V_2 V_2^T = I - V_1 V_1^T \f$, so that the decomposition may
+    /// compute thin factors. Applying a projector to a \f$ n \times p \f$
+    /// matrix costs \f$ O(n p r) \f$ where \f$ r \f$ is the rank, instead of
+    /// \f$ O(n^2 p) \f$ with the \f$ n \times n \f$ projector matrix.
+    ///
+    /// update() must be called after each decomposition. The output may be
+    /// the input.
+    template <typename SVD>
+    class SVDProjectors
+    {
+      public:
+        typedef typename SVD::Index Index;
+        typedef Eigen::Ref<const typename SVD::MatrixUType> Factor_t;
+
+        SVDProjectors (const SVD& svd) : svd_ (&svd), rank_ (0) {}
+
+        /// Store the rank of the current decomposition.
+        void update ()
+        {
+          rank_ = svd_->rank ();
+        }
+
+        Factor_t U1 () const { return svd_->matrixU ().leftCols (rank_); }
+        Factor_t V1 () const { return svd_->matrixV ().leftCols (rank_); }
+        Factor_t U2 () const
+        {
+          return svd_->matrixU ().rightCols (svd_->matrixU ().cols () - rank_);
+        }
+        Factor_t V2 () const
+        {
+          return svd_->matrixV ().rightCols (svd_->matrixV ().cols () - rank_);
+        }
+
+        /// out = \f$ V_1 V_1^T \f$ in
+        void projectOnSpan (matrixIn_t in, matrixOut_t out) const
+        {
+          project (V1 (), in, out, false);
+        }
+
+        /// out = \f$ U_1 U_1^T \f$ in
+        void projectOnSpanOfInv (matrixIn_t in, matrixOut_t out) const
+        {
+          project (U1 (), in, out, false);
+        }
+
+        /// out = \f$ V_2 V_2^T \f$ in
+        void projectOnKernel (matrixIn_t in, matrixOut_t out) const
+        {
+          project (V1 (), in, out, true);
+        }
+
+        /// out = \f$ U_2 U_2^T \f$ in
+        void projectOnKernelOfInv (matrixIn_t in, matrixOut_t out) const
+        {
+          project (U1 (), in, out, true);
+        }
+
+      private:
+        /// out = \f$ F F^T \f$ in, or \f$ (I - F F^T) \f$ in if complement.
+        void project (const Factor_t& F, matrixIn_t in, matrixOut_t out,
+            bool complement) const
+        {
+          assert (in.rows () == F.rows ());
+          // The buffer only grows so that no memory is allocated once
+          // the largest input has been seen.
+          const Index r = std::min (svd_->rows (), svd_->cols ());
+          if (tmp_.rows () != r || tmp_.cols () < in.cols ())
+            tmp_.resize (r, in.cols ());
+          Eigen::Block<matrix_t> tmp (tmp_.topLeftCorner (rank_, in.cols ()));
+          tmp.noalias() = F.adjoint () * in;
+          if (complement) {
+            out = in;
+            out.noalias() -= F * tmp;
+          } else
+            out.noalias() = F * tmp;
+        }
+
+        const SVD* svd_;
+        Index rank_;
+        mutable matrix_t tmp_;
+    }; // class SVDProjectors
+
+    /// \addtogroup solvers
+    /// \{
+
+    /// Singular value decomposition computed on the smaller side of a matrix.
+    ///
+    /// Let \f$ B \f$ be the matrix \f$ A \f$ if it has less rows than columns
+    /// and \f$ A^T \f$ otherwise, so that \f$ B \f$ has \f$ m \le n \f$ rows.
+    /// The derived classes compute an orthogonal \f$ m \times m \f$ matrix
+    /// \f$ W \f$ such that the columns of \f$ B^T W \f$ are orthogonal. The
+    /// singular values are the norms of these columns.
+    ///
+    /// The interface is the one of Eigen::JacobiSVD used by
+    /// MatrixOfExpressions and by the functions of this file. Only thin
+    /// factors are computed:
+    /// \li the factor of the smaller side is a full \f$ m \times m \f$
+    ///     orthogonal matrix,
+    /// \li the factor of the larger side has \f$ m \f$ columns and its
+    ///     columns beyond rank() are zero.
+    ///
+    /// \note The matrix is a template parameter only to match the interface
+    ///       of Eigen::JacobiSVD. The factors are dynamic size matrices.
+    template <typename _MatrixType>
+    class SmallSideSVDBase
+    {
+      public:
+        typedef _MatrixType MatrixType;
+        typedef typename MatrixType::Scalar Scalar;
+        typedef typename MatrixType::Index Index;
+        typedef Eigen::Matrix <Scalar, Eigen::Dynamic, Eigen::Dynamic>
+          MatrixUType;
+        typedef MatrixUType MatrixVType;
+        typedef Eigen::Matrix <Scalar, Eigen::Dynamic, 1> SingularValuesType;
+
+        const MatrixUType& matrixU () const
+        {
+          assert (computed_);
+          return transposed_ ? M_ : W_;
+        }
+
+        const MatrixVType& matrixV () const
+        {
+          assert (computed_);
+          return transposed_ ? W_ : M_;
+        }
+
+        const SingularValuesType& singularValues () const
+        {
+          assert (computed_);
+          return singularValues_;
+        }
+
+        Index rank () const
+        {
+          assert (computed_);
+          return rank_;
+        }
+
+        bool computeU () const { return true; }
+        bool computeV () const { return true; }
+
+        Index rows () const { return rows_; }
+        Index cols () const { return cols_; }
+
+        /// Relative threshold under which singular values are considered
+        /// as zero.
+        Scalar threshold () const
+        {
+          return usePrescribedThreshold_ ? prescribedThreshold_
+            : defaultThreshold_ * (Scalar) std::min (rows_, cols_);
+        }
+
+        void setThreshold (const Scalar& threshold)
+        {
+          usePrescribedThreshold_ = true;
+          prescribedThreshold_ = threshold;
+        }
+
+      protected:
+        SmallSideSVDBase (Index rows, Index cols, Scalar defaultThreshold) :
+          rows_ (-1), cols_ (-1), rank_ (0), transposed_ (false),
+          computed_ (false), usePrescribedThreshold_ (false),
+          prescribedThreshold_ (0), defaultThreshold_ (defaultThreshold)
+        {
+          resize (rows, cols);
+        }
+
+        /// Allocate the factors.
+        /// \return false if the size did not change.
+        bool resize (Index rows, Index cols)
+        {
+          if (rows == rows_ && cols == cols_) return false;
+          rows_ = rows;
+          cols_ = cols;
+          transposed_ = (rows > cols);
+          const Index m = std::min (rows, cols), n = std::max (rows, cols);
+          W_.setIdentity (m, m);
+          M_.resize (n, m);
+          singularValues_.resize (m);
+          computed_ = false;
+          return true;
+        }
+
+        /// Compute \f$ B^T W \f$.
+        template <typename Derived>
+        void computeLargeSide (const Eigen::MatrixBase <Derived>& matrix)
+        {
+          if (transposed_) M_.noalias() = matrix * W_;
+          else             M_.noalias() = matrix.transpose () * W_;
+        }
+
+        /// Compute the singular values from the columns of \f$ B^T W \f$,
+        /// sort them and normalize the columns.
+        void finalize ()
+        {
+          const Index m = W_.cols ();
+          for (Index i = 0; i < m; ++i)
+            singularValues_ [i] = M_.col (i).norm ();
+          for (Index i = 0; i < m; ++i) {
+            Index j;
+            singularValues_.tail (m - i).maxCoeff (&j);
+            j += i;
+            if (j == i) continue;
+            std::swap (singularValues_ [i], singularValues_ [j]);
+            M_.col (i).swap (M_.col (j));
+            W_.col (i).swap (W_.col (j));
+          }
+          const Scalar threshold = std::max (
+              (m > 0 ? singularValues_ [0] : 0) * this->threshold (),
+              (std::numeric_limits <Scalar>::min) ());
+          rank_ = 0;
+          for (Index i = 0; i < m; ++i) {
+            if (singularValues_ [i] > threshold) {
+              M_.col (i) /= singularValues_ [i];
+              ++rank_;
+            } else
+              M_.col (i).setZero ();
+          }
+          computed_ = true;
+        }
+
+        Index rows_, cols_, rank_;
+        /// Whether \f$ B = A^T \f$.
+        bool transposed_;
+        bool computed_;
+        bool usePrescribedThreshold_;
+        Scalar prescribedThreshold_, defaultThreshold_;
+        /// Factor of the smaller side.
+        MatrixUType W_;
+        /// Factor of the larger side.
+        MatrixUType M_;
+        SingularValuesType singularValues_;
+    }; // class SmallSideSVDBase
+
+    /// Singular value decomposition from the eigen decomposition of the
+    /// Gram matrix \f$ B B^T \f$ of the smaller side.
+    ///
+    /// For a \f$ 6 \times n \f$ matrix, this is a \f$ 6 \times 6 \f$
+    /// self adjoint eigen problem and a product, whatever the value of
+    /// \f$ n \f$.
+    ///
+    /// \warning Forming the Gram matrix squares the condition number. The
+    ///          singular values smaller than \f$ \sqrt{\epsilon} \f$ times
+    ///          the largest one are not accurate, which is why they are
+    ///          considered as zero by default.
+    template <typename _MatrixType>
+    class GramSVD : public SmallSideSVDBase <_MatrixType>
+    {
+      public:
+        typedef SmallSideSVDBase <_MatrixType> Parent_t;
+        typedef typename Parent_t::Scalar Scalar;
+        typedef typename Parent_t::Index Index;
+        typedef typename Parent_t::MatrixUType MatrixUType;
+
+        /// \param computationOptions unused. The factors are always computed.
+        GramSVD (Index rows, Index cols, unsigned int computationOptions = 0) :
+          Parent_t (rows, cols,
+              std::sqrt (Eigen::NumTraits <Scalar>::epsilon ())),
+          eigen_ (std::min (rows, cols))
+        {
+          (void) computationOptions;
+        }
+
+        template <typename Derived>
+        GramSVD& compute (const Eigen::MatrixBase <Derived>& matrix)
+        {
+          if (this->resize (matrix.rows (), matrix.cols ()))
+            eigen_ = Eigen::SelfAdjointEigenSolver <MatrixUType>
+              (std::min (matrix.rows (), matrix.cols ()));
+          if (this->transposed_) gram_.noalias() = matrix.transpose () * matrix;
+          else                   gram_.noalias() = matrix * matrix.transpose ();
+          eigen_.compute (gram_);
+          this->W_ = eigen_.eigenvectors ();
+          this->computeLargeSide (matrix);
+          this->finalize ();
+          return *this;
+        }
+
+      private:
+        MatrixUType gram_;
+        Eigen::SelfAdjointEigenSolver <MatrixUType> eigen_;
+    }; // class GramSVD
+
+    /// One sided Jacobi singular value decomposition, warm started with the
+    /// factor computed at the previous call.
+    ///
+    /// The columns of \f$ B^T W \f$ are orthogonalized by plane rotations,
+    /// starting from the orthogonal matrix \f$ W \f$ of the previous
+    /// decomposition. When the matrix changes little between two calls,
+    /// as the matrix of the contact normals and moments between two nearby
+    /// configurations, a few rotations are enough.
+    ///
+    /// The result has the accuracy of Eigen::JacobiSVD.
+    template <typename _MatrixType>
+    class WarmStartJacobiSVD : public SmallSideSVDBase <_MatrixType>
+    {
+      public:
+        typedef SmallSideSVDBase <_MatrixType> Parent_t;
+        typedef typename Parent_t::Scalar Scalar;
+        typedef typename Parent_t::Index Index;
+
+        /// \param computationOptions unused. The factors are always computed.
+        WarmStartJacobiSVD (Index rows, Index cols,
+            unsigned int computationOptions = 0) :
+          Parent_t (rows, cols, Eigen::NumTraits <Scalar>::epsilon ()),
+          maxSweeps_ (30), sweeps_ (0)
+        {
+          (void) computationOptions;
+        }
+
+        template <typename Derived>
+        WarmStartJacobiSVD& compute (const Eigen::MatrixBase <Derived>& matrix)
+        {
+          if (!this->resize (matrix.rows (), matrix.cols ()))
+            orthonormalize ();
+          this->computeLargeSide (matrix);
+          sweeps_ = 0;
+          bool rotated = true;
+          while (rotated && sweeps_ < maxSweeps_) {
+            rotated = sweep ();
+            ++sweeps_;
+          }
+          this->finalize ();
+          return *this;
+        }
+
+        /// Start the next decomposition from the identity.
+        void reset ()
+        {
+          this->W_.setIdentity ();
+        }
+
+        /// Orthogonal factor the next decomposition starts from.
+        const typename Parent_t::MatrixUType& warmStart () const
+        {
+          return this->W_;
+        }
+
+        /// Start the next decomposition from W, for instance the factor of
+        /// a decomposition at another configuration.
+        /// It is ignored if its size is not the size of the factor.
+        template <typename Derived>
+        void warmStart (const Eigen::MatrixBase <Derived>& W)
+        {
+          if (W.rows () != this->W_.rows () || W.cols () != this->W_.cols ())
+            return;
+          this->W_ = W;
+        }
+
+        /// Number of sweeps of the last decomposition.
+        /// The last sweep does not apply any rotation, unless
+        /// maxSweeps () was reached.
+        Index sweeps () const
+        {
+          return sweeps_;
+        }
+
+        Index maxSweeps () const
+        {
+          return maxSweeps_;
+        }
+
+        void maxSweeps (Index maxSweeps)
+        {
+          maxSweeps_ = maxSweeps;
+        }
+
+      private:
+        /// Apply a rotation to each pair of columns that are not orthogonal.
+        /// \return whether a rotation was applied.
+        bool sweep ()
+        {
+          typedef Eigen::NumTraits <Scalar> NT;
+          const Scalar precision = 2 * NT::epsilon ();
+          const Scalar zero = (std::numeric_limits <Scalar>::min) ();
+          const Index m = this->W_.cols ();
+          bool rotated = false;
+          for (Index p = 1; p < m; ++p) {
+            for (Index q = 0; q < p; ++q) {
+              const Scalar a = this->M_.col (p).squaredNorm ();
+              const Scalar b = this->M_.col (q).squaredNorm ();
+              const Scalar c = this->M_.col (p).dot (this->M_.col (q));
+              if (std::abs (c) <= std::max (zero, precision * std::sqrt (a * b)))
+                continue;
+              rotated = true;
+              const Scalar zeta = (b - a) / (2 * c);
+              const Scalar t = (zeta < 0 ? -1 : 1)
+                / (std::abs (zeta) + std::sqrt (1 + zeta * zeta));
+              const Scalar cs = 1 / std::sqrt (1 + t * t), sn = cs * t;
+              rotate (this->M_, p, q, cs, sn);
+              rotate (this->W_, p, q, cs, sn);
+            }
+          }
+          return rotated;
+        }
+
+        static void rotate (typename Parent_t::MatrixUType& m, Index p, Index q,
+            const Scalar& cs, const Scalar& sn)
+        {
+          for (Index i = 0; i < m.rows (); ++i) {
+            const Scalar x = m (i, p), y = m (i, q);
+            m (i, p) = cs * x - sn * y;
+            m (i, q) = sn * x + cs * y;
+          }
+        }
+
+        /// Remove the rounding errors accumulated in \f$ W \f$ by the
+        /// previous decompositions.
+        void orthonormalize ()
+        {
+          const Index m = this->W_.cols ();
+          for (Index i = 0; i < m; ++i) {
+            for (Index j = 0; j < i; ++j)
+              this->W_.col (i) -=
+                this->W_.col (j).dot (this->W_.col (i)) * this->W_.col (j);
+            this->W_.col (i).normalize ();
+          }
+        }
+
+        Index maxSweeps_, sweeps_;
+    }; // class WarmStartJacobiSVD
+
+    /// \}
   } // namespace constraints
 } // namespace hpp
 
@@ -51,25 +51,35 @@
 
 #define HPP_CONSTRAINTS_CB_CREATE1(Class, Arg0Type) \
   static typename Traits <Class>::Ptr_t create (Arg0Type arg0) { \
-    typename Traits <Class>::Ptr_t ptr (new Class (arg0)); \
+    typename Traits <Class>::Ptr_t ptr (allocateCalculus <Class> (arg0)); \
     ptr->init (ptr); \
     return ptr; \
   }
 
 #define HPP_CONSTRAINTS_CB_CREATE2(Class, Arg0Type, Arg1Type) \
   static typename Traits <Class>::Ptr_t create (Arg0Type arg0, Arg1Type arg1) { \
-    typename Traits <Class>::Ptr_t ptr (new Class (arg0, arg1)); \
+    typename Traits <Class>::Ptr_t ptr (allocateCalculus <Class> (arg0, arg1)); \
     ptr->init (ptr); \
     return ptr; \
   }
 
 #define HPP_CONSTRAINTS_CB_CREATE3(Class, Arg0Type, Arg1Type, Arg2Type) \
   static typename Traits <Class>::Ptr_t create (Arg0Type arg0, Arg1Type arg1, Arg2Type arg2) { \
-    typename Traits <Class>::Ptr_t ptr (new Class (arg0, arg1, arg2)); \
+    typename Traits <Class>::Ptr_t ptr (allocateCalculus <Class> (arg0, arg1, arg2)); \
     ptr->init (ptr); \
     return ptr; \
   }
 
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <map>
+#include <set>
+#include <vector>
+#include <limits>
+
+#include <boost/make_shared.hpp>
+
 #include <Eigen/SVD>
 
 #include <hpp/pinocchio/joint.hh>
@@ -79,6 +89,8 @@
 #include <hpp/constraints/svd.hh>
 #include <hpp/constraints/tools.hh>
 #include <hpp/constraints/macros.hh>
+#include <hpp/constraints/trace.hh>
+#include <hpp/constraints/center-of-mass-cache.hh>
 
 namespace hpp {
   namespace constraints {
@@ -100,6 +112,7 @@ namespace hpp {
     typedef eigen::matrix3_t CrossMatrix;
     typedef Eigen::Matrix <value_type, 1, Eigen::Dynamic, Eigen::RowMajor> RowJacobianMatrix;
     typedef Eigen::Matrix <value_type, 3, Eigen::Dynamic, Eigen::RowMajor> JacobianMatrix;
+    typedef Eigen::Ref <RowJacobianMatrix, 0, Eigen::InnerStride<> > RowJacobianOut_t;
 
     template <typename Class>
     struct Traits {
@@ -125,6 +138,449 @@ namespace hpp {
       typedef JointTranspose WkPtr_t;
     };
 
+    /// Memory pool for the nodes of expressions.
+    ///
+    /// While a CalculusArena::Scope is alive, the create methods of the
+    /// expressions allocate the node and its reference counter in the
+    /// current arena instead of calling new. Allocation is then a pointer
+    /// increment and the memory of all the nodes is released at once.
+    ///
+    /// The memory is released when the arena and all the nodes
+    /// allocated in it are destroyed, so a node may outlive the arena
+    /// it was allocated in.
+    ///
+    /// \code
+    ///   // arena_ is a member of the function owning the expressions.
+    ///   CalculusArena::Scope scope (arena_);
+    ///   phi_ (1,i) = (OG - OP) ^ n;
+    /// \endcode
+    ///
+    /// \note The dynamic storage of the nodes, the jacobians for
+    ///       instance, is still allocated by Eigen.
+    /// \note The current arena is global: expressions should not be
+    ///       created concurrently while a scope is alive.
+    class CalculusArena
+    {
+      private:
+        class Storage
+        {
+          public:
+            Storage (std::size_t blockSize) :
+              blockSize_ (blockSize), begin_ (NULL), end_ (NULL), used_ (0)
+            {}
+
+            ~Storage ()
+            {
+              for (std::size_t i = 0; i < blocks_.size (); ++i)
+                std::free (blocks_[i]);
+            }
+
+            void* allocate (std::size_t size)
+            {
+              size = (size + Align - 1) & ~(Align - 1);
+              if (begin_ + size > end_) {
+                const std::size_t s = std::max (size, blockSize_);
+                // malloc aligns on 16 bytes on the supported platforms.
+                char* block = static_cast <char*> (std::malloc (s));
+                if (block == NULL) throw std::bad_alloc ();
+                assert (reinterpret_cast <std::size_t> (block) % Align == 0);
+                blocks_.push_back (block);
+                begin_ = block;
+                end_ = block + s;
+              }
+              void* res = begin_;
+              begin_ += size;
+              used_ += size;
+              return res;
+            }
+
+            enum { Align = 16 };
+            const std::size_t blockSize_;
+            std::vector <char*> blocks_;
+            char *begin_, *end_;
+            std::size_t used_;
+        };
+
+      public:
+        /// Standard allocator using an arena.
+        template <typename T> class Allocator
+        {
+          public:
+            typedef T value_type;
+            typedef T* pointer;
+            typedef const T* const_pointer;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef std::size_t size_type;
+            typedef std::ptrdiff_t difference_type;
+            template <typename U> struct rebind { typedef Allocator<U> other; };
+
+            Allocator (const boost::shared_ptr <Storage>& storage) :
+              storage_ (storage) {}
+            template <typename U> Allocator (const Allocator<U>& other) :
+              storage_ (other.storage_) {}
+
+            pointer allocate (size_type n, const void* = 0)
+            {
+              return static_cast <pointer> (storage_->allocate (n * sizeof (T)));
+            }
+            /// Memory is released with the arena.
+            void deallocate (pointer, size_type) {}
+            void construct (pointer p, const T& value)
+            {
+              new (p) T (value);
+            }
+            void destroy (pointer p)
+            {
+              p->~T ();
+            }
+            size_type max_size () const
+            {
+              return std::numeric_limits <size_type>::max () / sizeof (T);
+            }
+            pointer address (reference r) const { return &r; }
+            const_pointer address (const_reference r) const { return &r; }
+
+            template <typename U> bool operator== (const Allocator<U>& o) const
+            {
+              return storage_ == o.storage_;
+            }
+            template <typename U> bool operator!= (const Allocator<U>& o) const
+            {
+              return storage_ != o.storage_;
+            }
+
+            boost::shared_ptr <Storage> storage_;
+        };
+
+        /// Make an arena current during the lifetime of this object.
+        class Scope
+        {
+          public:
+            Scope (CalculusArena& arena) : previous_ (current ())
+            {
+              current () = &arena;
+            }
+            ~Scope ()
+            {
+              current () = previous_;
+            }
+
+          private:
+            CalculusArena* previous_;
+        };
+
+        /// \param blockSize size in bytes of the blocks of memory
+        ///        allocated when the arena is full.
+        explicit CalculusArena (std::size_t blockSize = 16384) :
+          storage_ (new Storage (blockSize)) {}
+
+        template <typename T> Allocator<T> allocator () const
+        {
+          return Allocator<T> (storage_);
+        }
+
+        /// Number of bytes allocated in the arena.
+        std::size_t used () const
+        {
+          return storage_->used_;
+        }
+
+        /// Arena used by the create methods, NULL if there is none.
+        static CalculusArena*& current ()
+        {
+          static CalculusArena* arena = NULL;
+          return arena;
+        }
+
+      private:
+        boost::shared_ptr <Storage> storage_;
+    };
+
+    /// Allocate a node in the current CalculusArena, if any.
+    template <typename T> boost::shared_ptr <T> allocateCalculus ()
+    {
+      if (CalculusArena* a = CalculusArena::current ())
+        return boost::allocate_shared <T> (a->allocator <T> ());
+      return boost::shared_ptr <T> (new T ());
+    }
+    template <typename T, typename A0>
+      boost::shared_ptr <T> allocateCalculus (const A0& a0)
+    {
+      if (CalculusArena* a = CalculusArena::current ())
+        return boost::allocate_shared <T> (a->allocator <T> (), a0);
+      return boost::shared_ptr <T> (new T (a0));
+    }
+    template <typename T, typename A0, typename A1>
+      boost::shared_ptr <T> allocateCalculus (const A0& a0, const A1& a1)
+    {
+      if (CalculusArena* a = CalculusArena::current ())
+        return boost::allocate_shared <T> (a->allocator <T> (), a0, a1);
+      return boost::shared_ptr <T> (new T (a0, a1));
+    }
+    template <typename T, typename A0, typename A1, typename A2>
+      boost::shared_ptr <T> allocateCalculus (const A0& a0, const A1& a1,
+          const A2& a2)
+    {
+      if (CalculusArena* a = CalculusArena::current ())
+        return boost::allocate_shared <T> (a->allocator <T> (), a0, a1, a2);
+      return boost::shared_ptr <T> (new T (a0, a1, a2));
+    }
+
+    class CalculusGraph;
+
+    /// Node of an expression graph, independently of its value type.
+    ///
+    /// This interface gives to CalculusGraph access to the structure of an
+    /// expression.
+    class CalculusNode
+    {
+      public:
+        virtual ~CalculusNode () {}
+
+        virtual void computeValue () = 0;
+        virtual void computeJacobian () = 0;
+        /// Reset the validity flags of this node only.
+        virtual void invalidateNode () = 0;
+
+        /// Append the sub-expressions this node reads to deps.
+        virtual void dependencies (std::vector <CalculusNode*>&) const {}
+
+        /// Call CalculusGraph::merge on each sub-expression.
+        virtual void mergeLeaves (CalculusGraph&) {}
+
+        /// Whether this node is a leaf with the same value as other.
+        virtual bool equivalent (const CalculusNode&) const
+        {
+          return false;
+        }
+    };
+    typedef boost::shared_ptr <CalculusNode> CalculusNodePtr_t;
+
+    /// Flat evaluation of expression graphs.
+    ///
+    /// Composite expressions invalidate their whole subtree recursively, so
+    /// a node shared by several sub-expressions is invalidated once for
+    /// each path leading to it. CalculusGraph instead
+    /// \li replaces equivalent leaves (same joint and local point for
+    ///     instance) by a single instance, when an expression is added,
+    /// \li sorts the nodes so that a node comes after its dependencies,
+    /// \li invalidates each node once, when the version given to
+    ///     CalculusGraph::update changes.
+    ///
+    /// \code
+    ///   CalculusGraph graph;
+    ///   graph.add (expr1);
+    ///   graph.add (expr2);
+    ///   kinematics->update (q, KinematicsCache::PLACEMENTS);
+    ///   graph.update (kinematics->version ());
+    ///   expr1->computeValue (); // or graph.computeValue ()
+    /// \endcode
+    ///
+    /// \note Nodes shared between several graphs should depend on the same
+    ///       KinematicsCache, so that the versions all come from the same
+    ///       counter.
+    class CalculusGraph
+    {
+      public:
+        CalculusGraph () :
+          version_ (std::numeric_limits <std::size_t>::max ()) {}
+
+        /// Add an expression to the graph.
+        ///
+        /// The leaves of the expression that are equivalent to a leaf of
+        /// the graph are replaced by it, in expression itself.
+        template <typename T> void add (boost::shared_ptr <T>& expression)
+        {
+          merge (expression);
+          roots_.push_back (expression);
+          sort ();
+          version_ = std::numeric_limits <std::size_t>::max ();
+        }
+
+        /// Invalidate all the nodes if version is not the version of the
+        /// latest call.
+        /// \return true if the nodes were invalidated.
+        bool update (std::size_t version)
+        {
+          if (version == version_) return false;
+          invalidate ();
+          version_ = version;
+          return true;
+        }
+
+        /// Invalidate all the nodes, once each.
+        void invalidate ()
+        {
+          for (std::size_t i = 0; i < nodes_.size (); ++i)
+            nodes_[i]->invalidateNode ();
+        }
+
+        /// Compute the value of all the nodes in a single forward pass.
+        void computeValue ()
+        {
+          for (std::size_t i = 0; i < nodes_.size (); ++i)
+            nodes_[i]->computeValue ();
+        }
+
+        /// Compute the jacobian of all the nodes in a single forward pass.
+        void computeJacobian ()
+        {
+          for (std::size_t i = 0; i < nodes_.size (); ++i)
+            nodes_[i]->computeJacobian ();
+        }
+
+        /// Nodes of the graph, in topological order.
+        const std::vector <CalculusNode*>& nodes () const
+        {
+          return nodes_;
+        }
+
+        /// Number of distinct leaves.
+        std::size_t nbLeaves () const
+        {
+          return leaves_.size ();
+        }
+
+        /// Merge the leaves of node with the leaves of the graph.
+        /// If node is a leaf equivalent to a leaf of the graph, it is
+        /// replaced by it.
+        template <typename T> void merge (boost::shared_ptr <T>& node)
+        {
+          if (!node) return;
+          Replaced_t::const_iterator _r = replaced_.find (node.get ());
+          if (_r != replaced_.end ()) {
+            node = boost::static_pointer_cast <T> (_r->second.second);
+            return;
+          }
+          if (!merged_.insert (node.get ()).second) return;
+          node->mergeLeaves (*this);
+          std::vector <CalculusNode*> deps;
+          node->dependencies (deps);
+          if (!deps.empty ()) return;
+          for (std::size_t i = 0; i < leaves_.size (); ++i) {
+            if (leaves_[i]->equivalent (*node)) {
+              // Keep the replaced leaf alive, so that its address is not
+              // reused.
+              replaced_[node.get ()] = std::make_pair
+                (CalculusNodePtr_t (node), leaves_[i]);
+              node = boost::static_pointer_cast <T> (leaves_[i]);
+              return;
+            }
+          }
+          leaves_.push_back (node);
+        }
+
+      private:
+        void sort ()
+        {
+          nodes_.clear ();
+          std::set <CalculusNode*> visited;
+          for (std::size_t i = 0; i < roots_.size (); ++i)
+            visit (roots_[i].get (), visited);
+        }
+        // Depth first post-order.
+        void visit (CalculusNode* node, std::set <CalculusNode*>& visited)
+        {
+          if (!visited.insert (node).second) return;
+          std::vector <CalculusNode*> deps;
+          node->dependencies (deps);
+          for (std::size_t i = 0; i < deps.size (); ++i)
+            visit (deps[i], visited);
+          nodes_.push_back (node);
+        }
+
+        typedef std::map <CalculusNode*,
+                std::pair <CalculusNodePtr_t, CalculusNodePtr_t> > Replaced_t;
+
+        std::vector <CalculusNodePtr_t> roots_, leaves_;
+        std::set <CalculusNode*> merged_;
+        Replaced_t replaced_;
+        std::vector <CalculusNode*> nodes_;
+        std::size_t version_;
+    };
+
+    /// Range \f$ [begin, end[ \f$ of the columns where the jacobian of a
+    /// joint may be non zero.
+    /// The velocity indices of the ancestors of a joint are lower than its
+    /// own ones. The range is empty if the joint is NULL.
+    inline void jointColumns (const JointPtr_t& joint,
+        size_type& begin, size_type& end)
+    {
+      if (!joint) { begin = end = 0; return; }
+      begin = joint->rankInVelocity ();
+      end = begin + joint->numberDof ();
+      for (JointPtr_t j = joint->parentJoint (); j; j = j->parentJoint ())
+        begin = std::min (begin, j->rankInVelocity ());
+    }
+
+    /// Extend \f$ [begin, end[ \f$ to contain \f$ [b, e[ \f$.
+    /// Empty ranges are ignored.
+    inline void uniteColumns (size_type& begin, size_type& end,
+        size_type b, size_type e)
+    {
+      if (b >= e) return;
+      if (begin >= end) { begin = b; end = e; return; }
+      begin = std::min (begin, b);
+      end = std::max (end, e);
+    }
+
+    /// Columns where the jacobians of the operands of a binary operation
+    /// may be non zero, see CalculusBaseAbstract::jacobianColumns.
+    ///
+    /// They are computed when the operation is built, since the structure
+    /// of an expression does not change. An operand with an empty range,
+    /// a Point or a PointInJoint without joint for instance, is a constant:
+    /// its jacobian is neither added nor multiplied, and the operation only
+    /// writes the columns of the union of the ranges.
+    struct OperandColumns
+    {
+      size_type lhsBegin, lhsEnd, rhsBegin, rhsEnd;
+      /// Union of the ranges of the operands.
+      size_type begin, end;
+
+      OperandColumns () :
+        lhsBegin (0), lhsEnd (std::numeric_limits <size_type>::max ()),
+        rhsBegin (0), rhsEnd (std::numeric_limits <size_type>::max ()),
+        begin (0), end (std::numeric_limits <size_type>::max ())
+      {}
+
+      template <typename LhsPtr, typename RhsPtr>
+      OperandColumns (const LhsPtr& lhs, const RhsPtr& rhs)
+      {
+        lhs->jacobianColumns (lhsBegin, lhsEnd);
+        rhs->jacobianColumns (rhsBegin, rhsEnd);
+        begin = lhsBegin;
+        end = lhsEnd;
+        uniteColumns (begin, end, rhsBegin, rhsEnd);
+      }
+
+      bool lhsConstant () const
+      {
+        return lhsBegin >= lhsEnd;
+      }
+
+      bool rhsConstant () const
+      {
+        return rhsBegin >= rhsEnd;
+      }
+
+      /// Resize the jacobian of the operation to the zero columns of the
+      /// jacobians of the operands, if its size differs, and clamp the
+      /// union to them.
+      /// \retval b, n first column and number of columns of the union.
+      template <typename Jacobian, typename LhsJacobian, typename RhsJacobian>
+        void resize (Jacobian& jacobian, const LhsJacobian& lhs,
+            const RhsJacobian& rhs, size_type& b, size_type& n) const
+      {
+        const size_type nbCols = (lhsConstant () ? rhs.cols () : lhs.cols ());
+        if (jacobian.cols () != nbCols)
+          jacobian.setZero (jacobian.rows (), nbCols);
+        b = std::min (begin, nbCols);
+        n = std::max (std::min (end, nbCols) - b, size_type (0));
+      }
+    };
+
     /// Abstract class defining a basic common interface.
     ///
     /// The purpose of this class is to allow the user to define an expression
@@ -138,7 +594,7 @@ namespace hpp {
     /// \endcode
     template <class ValueType = eigen::vector3_t,
              class JacobianType = JacobianMatrix >
-    class CalculusBaseAbstract
+    class CalculusBaseAbstract : public CalculusNode
     {
       public:
         typedef ValueType ValueType_t;
@@ -149,6 +605,28 @@ namespace hpp {
         virtual void computeValue () = 0;
         virtual void computeJacobian () = 0;
         virtual void invalidate () = 0;
+
+        /// Add \f$ s^T J \f$ to \c out, where \f$ J \f$ is the jacobian.
+        ///
+        /// This is the reverse mode differentiation: operations propagate
+        /// the seed \f$ s \f$ to their operands down to the joint jacobians,
+        /// so the jacobians of the operations are not computed.
+        /// The values of the nodes must be up to date.
+        virtual void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) = 0;
+
+        /// Write the jacobian in \c out, a matrix with as many rows as the
+        /// value and as many columns as the jacobian.
+        ///
+        /// The jacobian of the node is not stored, so that it can be written
+        /// directly in the block of the caller output.
+        virtual void jacobianInto (matrixOut_t out) = 0;
+
+        /// Range \f$ [begin, end[ \f$ of the columns where the jacobian may
+        /// be non zero. It only depends on the structure of the expression.
+        /// end is std::numeric_limits<size_type>::max () when the range is
+        /// not known.
+        virtual void jacobianColumns (size_type& begin, size_type& end)
+          const = 0;
     };
 
     /// Main abstract class.
@@ -202,6 +680,42 @@ namespace hpp {
           jValid_ = false;
           cValid_ = false;
         }
+        void invalidateNode () {
+          vValid_ = false;
+          jValid_ = false;
+          cValid_ = false;
+        }
+        /// The default implementation computes the jacobian of the node.
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          computeJacobian ();
+          out.noalias() += seed.transpose ()
+            * static_cast<const T*>(this)->jacobian ();
+        }
+        /// The default implementation copies the jacobian of the node if it
+        /// is up to date. Otherwise, each row is computed in reverse mode by
+        /// accumulateAdjoint, so that neither the node nor its operands form
+        /// their jacobian.
+        void jacobianInto (matrixOut_t out) {
+          if (jValid_) {
+            out = static_cast<const T*>(this)->jacobian ();
+            return;
+          }
+          assert (out.rows () <= 6);
+          computeValue ();
+          out.setZero ();
+          Eigen::Matrix <value_type, Eigen::Dynamic, 1, 0, 6, 1>
+            seed (out.rows ());
+          for (size_type k = 0; k < out.rows (); ++k) {
+            seed.setZero ();
+            seed[k] = 1;
+            this->accumulateAdjoint (seed, out.row (k));
+          }
+        }
+        /// The default implementation returns all the columns.
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          begin = 0;
+          end = std::numeric_limits <size_type>::max ();
+        }
         inline const CrossType& cross () const {
           return cross_;
         }
@@ -252,14 +766,14 @@ namespace hpp {
           > WkPtr_t;
 
         static Ptr_t create () {
-          Ptr_t p (new Expression ());
+          Ptr_t p (allocateCalculus <Expression> ());
           p->init (p);
           return p;
         }
 
         static Ptr_t create (const typename Traits<LhsValue>::Ptr_t& lhs,
             const typename Traits<RhsValue>::Ptr_t& rhs) {
-          Ptr_t p (new Expression (lhs, rhs));
+          Ptr_t p (allocateCalculus <Expression> (lhs, rhs));
           p->init (p);
           return p;
         }
@@ -310,11 +824,13 @@ namespace hpp {
 
         CrossProduct (const CalculusBase <CrossProduct>& other) :
           Parent_t (other),
-          e_ (static_cast <const CrossProduct&>(other).e_)
+          e_ (static_cast <const CrossProduct&>(other).e_),
+          columns_ (static_cast <const CrossProduct&>(other).columns_)
         {}
 
         CrossProduct (const typename Traits<LhsValue>::Ptr_t& lhs, const typename Traits<RhsValue>::Ptr_t& rhs):
-          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs))
+          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs)),
+          columns_ (e_->lhs_, e_->rhs_)
         {}
 
         void impl_value () {
@@ -327,17 +843,54 @@ namespace hpp {
           e_->rhs_->computeCrossValue ();
           e_->lhs_->computeJacobian ();
           e_->rhs_->computeJacobian ();
-          this->jacobian_ = e_->lhs_->cross () * e_->rhs_->jacobian ()
-                          - e_->rhs_->cross () * e_->lhs_->jacobian ();
+          size_type b, n;
+          columns_.resize (this->jacobian_, e_->lhs_->jacobian (),
+              e_->rhs_->jacobian (), b, n);
+          if (columns_.rhsConstant ()) {
+            if (!columns_.lhsConstant ())
+              this->jacobian_.middleCols (b, n).noalias() =
+                - e_->rhs_->cross () * e_->lhs_->jacobian ().middleCols (b, n);
+            return;
+          }
+          this->jacobian_.middleCols (b, n).noalias() =
+            e_->lhs_->cross () * e_->rhs_->jacobian ().middleCols (b, n);
+          if (!columns_.lhsConstant ())
+            this->jacobian_.middleCols (b, n).noalias() -=
+              e_->rhs_->cross () * e_->lhs_->jacobian ().middleCols (b, n);
+        }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          e_->lhs_->computeCrossValue ();
+          e_->rhs_->computeCrossValue ();
+          if (!columns_.lhsConstant ()) {
+            const vector3_t sl (e_->rhs_->cross () * seed);
+            e_->lhs_->accumulateAdjoint (sl, out);
+          }
+          if (!columns_.rhsConstant ()) {
+            const vector3_t sr (- e_->lhs_->cross () * seed);
+            e_->rhs_->accumulateAdjoint (sr, out);
+          }
         }
         void invalidate () {
           Parent_t::invalidate ();
           e_->rhs_->invalidate ();
           e_->lhs_->invalidate ();
         }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          deps.push_back (e_->lhs_.get ());
+          deps.push_back (e_->rhs_.get ());
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          begin = columns_.begin;
+          end = columns_.end;
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          graph.merge (e_->lhs_);
+          graph.merge (e_->rhs_);
+        }
 
       protected:
         typename Expression < LhsValue, RhsValue >::Ptr_t e_;
+        OperandColumns columns_;
 
         friend class Expression <LhsValue, RhsValue>;
     };
@@ -357,11 +910,13 @@ namespace hpp {
 
         ScalarProduct (const CalculusBase <ScalarProduct>& other) :
           CalculusBase <ScalarProduct> (other),
-          e_ (static_cast <const ScalarProduct&>(other).e_)
+          e_ (static_cast <const ScalarProduct&>(other).e_),
+          columns_ (static_cast <const ScalarProduct&>(other).columns_)
         {}
 
         ScalarProduct (const typename Traits<LhsValue>::Ptr_t& lhs, const typename Traits<RhsValue>::Ptr_t& rhs):
-          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs))
+          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs)),
+          columns_ (e_->lhs_, e_->rhs_)
         {}
 
         void impl_value () {
@@ -374,17 +929,50 @@ namespace hpp {
           e_->rhs_->computeValue ();
           e_->lhs_->computeJacobian ();
           e_->rhs_->computeJacobian ();
-          this->jacobian_ = e_->lhs_->value ().transpose () * e_->rhs_->jacobian ()
-                          + e_->rhs_->value ().transpose () * e_->lhs_->jacobian ();
+          size_type b, n;
+          columns_.resize (this->jacobian_, e_->lhs_->jacobian (),
+              e_->rhs_->jacobian (), b, n);
+          this->jacobian_.middleCols (b, n).setZero ();
+          if (!columns_.rhsConstant ())
+            this->jacobian_.middleCols (b, n).noalias() +=
+              e_->lhs_->value ().transpose () * e_->rhs_->jacobian ().middleCols (b, n);
+          if (!columns_.lhsConstant ())
+            this->jacobian_.middleCols (b, n).noalias() +=
+              e_->rhs_->value ().transpose () * e_->lhs_->jacobian ().middleCols (b, n);
+        }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          e_->lhs_->computeValue ();
+          e_->rhs_->computeValue ();
+          if (!columns_.lhsConstant ()) {
+            const vector3_t sl (seed[0] * e_->rhs_->value ());
+            e_->lhs_->accumulateAdjoint (sl, out);
+          }
+          if (!columns_.rhsConstant ()) {
+            const vector3_t sr (seed[0] * e_->lhs_->value ());
+            e_->rhs_->accumulateAdjoint (sr, out);
+          }
         }
         void invalidate () {
           Parent_t::invalidate ();
           e_->rhs_->invalidate ();
           e_->lhs_->invalidate ();
         }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          deps.push_back (e_->lhs_.get ());
+          deps.push_back (e_->rhs_.get ());
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          begin = columns_.begin;
+          end = columns_.end;
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          graph.merge (e_->lhs_);
+          graph.merge (e_->rhs_);
+        }
 
       protected:
         typename Expression < LhsValue, RhsValue >::Ptr_t e_;
+        OperandColumns columns_;
 
         friend class Expression <LhsValue, RhsValue>;
     };
@@ -404,11 +992,13 @@ namespace hpp {
 
         Difference (const CalculusBase <Difference>& other) :
           CalculusBase <Difference> (other),
-          e_ (static_cast <const Difference&>(other).e_)
+          e_ (static_cast <const Difference&>(other).e_),
+          columns_ (static_cast <const Difference&>(other).columns_)
         {}
 
         Difference (const typename Traits<LhsValue>::Ptr_t& lhs, const typename Traits<RhsValue>::Ptr_t& rhs):
-          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs))
+          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs)),
+          columns_ (e_->lhs_, e_->rhs_)
         {}
 
         void impl_value () {
@@ -419,16 +1009,50 @@ namespace hpp {
         void impl_jacobian () {
           e_->lhs_->computeJacobian ();
           e_->rhs_->computeJacobian ();
-          this->jacobian_ = e_->lhs_->jacobian () - e_->rhs_->jacobian ();
+          size_type b, n;
+          columns_.resize (this->jacobian_, e_->lhs_->jacobian (),
+              e_->rhs_->jacobian (), b, n);
+          if (columns_.rhsConstant ()) {
+            if (!columns_.lhsConstant ())
+              this->jacobian_.middleCols (b, n) =
+                e_->lhs_->jacobian ().middleCols (b, n);
+          } else if (columns_.lhsConstant ())
+            this->jacobian_.middleCols (b, n) =
+              - e_->rhs_->jacobian ().middleCols (b, n);
+          else
+            this->jacobian_.middleCols (b, n) =
+              e_->lhs_->jacobian ().middleCols (b, n)
+              - e_->rhs_->jacobian ().middleCols (b, n);
+        }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          if (!columns_.lhsConstant ())
+            e_->lhs_->accumulateAdjoint (seed, out);
+          if (!columns_.rhsConstant ()) {
+            const vector3_t sr (- seed);
+            e_->rhs_->accumulateAdjoint (sr, out);
+          }
         }
         void invalidate () {
           Parent_t::invalidate ();
           e_->rhs_->invalidate ();
           e_->lhs_->invalidate ();
         }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          deps.push_back (e_->lhs_.get ());
+          deps.push_back (e_->rhs_.get ());
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          begin = columns_.begin;
+          end = columns_.end;
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          graph.merge (e_->lhs_);
+          graph.merge (e_->rhs_);
+        }
 
       protected:
         typename Expression < LhsValue, RhsValue >::Ptr_t e_;
+        OperandColumns columns_;
 
         friend class Expression <LhsValue, RhsValue>;
     };
@@ -448,11 +1072,13 @@ namespace hpp {
 
         Sum (const CalculusBase < Sum >& other) :
           CalculusBase < Sum > (other),
-          e_ (static_cast <const Sum&>(other).e_)
+          e_ (static_cast <const Sum&>(other).e_),
+          columns_ (static_cast <const Sum&>(other).columns_)
         {}
 
-        Sum (const typename Traits<RhsValue>::Ptr_t& rhs, const typename Traits<LhsValue>::Ptr_t& lhs):
-          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs))
+        Sum (const typename Traits<LhsValue>::Ptr_t& lhs, const typename Traits<RhsValue>::Ptr_t& rhs):
+          e_ (Expression < LhsValue, RhsValue >::create (lhs, rhs)),
+          columns_ (e_->lhs_, e_->rhs_)
         {}
 
         void impl_value () {
@@ -463,16 +1089,48 @@ namespace hpp {
         void impl_jacobian () {
           e_->lhs_->computeJacobian ();
           e_->rhs_->computeJacobian ();
-          this->jacobian_ = e_->lhs_->jacobian () + e_->rhs_->jacobian ();
+          size_type b, n;
+          columns_.resize (this->jacobian_, e_->lhs_->jacobian (),
+              e_->rhs_->jacobian (), b, n);
+          if (columns_.rhsConstant ()) {
+            if (!columns_.lhsConstant ())
+              this->jacobian_.middleCols (b, n) =
+                e_->lhs_->jacobian ().middleCols (b, n);
+          } else if (columns_.lhsConstant ())
+            this->jacobian_.middleCols (b, n) =
+              e_->rhs_->jacobian ().middleCols (b, n);
+          else
+            this->jacobian_.middleCols (b, n) =
+              e_->lhs_->jacobian ().middleCols (b, n)
+              + e_->rhs_->jacobian ().middleCols (b, n);
+        }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          if (!columns_.lhsConstant ())
+            e_->lhs_->accumulateAdjoint (seed, out);
+          if (!columns_.rhsConstant ())
+            e_->rhs_->accumulateAdjoint (seed, out);
         }
         void invalidate () {
           Parent_t::invalidate ();
           e_->rhs_->invalidate ();
           e_->lhs_->invalidate ();
         }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          deps.push_back (e_->lhs_.get ());
+          deps.push_back (e_->rhs_.get ());
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          begin = columns_.begin;
+          end = columns_.end;
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          graph.merge (e_->lhs_);
+          graph.merge (e_->rhs_);
+        }
 
       protected:
         typename Expression < LhsValue, RhsValue >::Ptr_t e_;
+        OperandColumns columns_;
 
         friend class Expression <LhsValue, RhsValue>;
     };
@@ -507,10 +1165,23 @@ namespace hpp {
           e_->rhs_->computeJacobian ();
           this->jacobian_ = e_->lhs_ * e_->rhs_->jacobian ();
         }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          const vector3_t sr (e_->lhs_ * seed);
+          e_->rhs_->accumulateAdjoint (sr, out);
+        }
         void invalidate () {
           Parent_t::invalidate ();
           e_->rhs_->invalidate ();
         }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          deps.push_back (e_->rhs_.get ());
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          graph.merge (e_->rhs_);
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          e_->rhs_->jacobianColumns (begin, end);
+        }
 
       protected:
         typename Expression < value_type, RhsValue >::Ptr_t e_;
@@ -563,17 +1234,44 @@ namespace hpp {
           e_->rhs_->computeCrossValue ();
           const JointJacobian_t& J = e_->lhs_->jacobian ();
           const matrix3_t& R = e_->lhs_->currentTransformation ().rotation ();
-          if (transpose_)
-            this->jacobian_ = R.transpose()
-              * ((e_->rhs_->cross () * R) * J.bottomRows<3>() + e_->rhs_->jacobian ());
-          else
-            this->jacobian_ = R
-              * ((e_->rhs_->cross () * R) * J.bottomRows<3>() + e_->rhs_->jacobian ());
+          if (transpose_) {
+            this->jacobian_.noalias() = (R.transpose() * e_->rhs_->cross () * R)
+              * J.bottomRows<3>();
+            this->jacobian_.noalias() += R.transpose() * e_->rhs_->jacobian ();
+          } else {
+            this->jacobian_.noalias() = (R * e_->rhs_->cross () * R)
+              * J.bottomRows<3>();
+            this->jacobian_.noalias() += R * e_->rhs_->jacobian ();
+          }
+        }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          e_->rhs_->computeCrossValue ();
+          const JointJacobian_t& J = e_->lhs_->jacobian ();
+          const matrix3_t& R = e_->lhs_->currentTransformation ().rotation ();
+          vector3_t sr;
+          if (transpose_) sr.noalias() = R             * seed;
+          else            sr.noalias() = R.transpose() * seed;
+          const vector3_t sw (R.transpose()
+              * (e_->rhs_->cross ().transpose() * sr));
+          out.noalias() += sw.transpose () * J.bottomRows<3>();
+          e_->rhs_->accumulateAdjoint (sr, out);
         }
         void invalidate () {
           Parent_t::invalidate ();
           e_->rhs_->invalidate ();
         }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          deps.push_back (e_->rhs_.get ());
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          graph.merge (e_->rhs_);
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          size_type b, e;
+          e_->rhs_->jacobianColumns (begin, end);
+          jointColumns (e_->lhs_, b, e);
+          uniteColumns (begin, end, b, e);
+        }
 
       protected:
         typename Expression < pinocchio::Joint, RhsValue >::Ptr_t e_;
@@ -653,6 +1351,23 @@ namespace hpp {
             this->jacobian_.noalias() -= (this->cross_ * R) * J.bottomRows<3>();
           }
         }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          if (joint_ == NULL) return;
+          const JointJacobian_t& J (joint_->jacobian ());
+          const vector3_t u (joint_->currentTransformation ().rotation ()
+              .transpose () * seed);
+          out.noalias() += u.transpose () * J.topRows<3>();
+          if (!center_)
+            out.noalias() += local_.cross (u).transpose () * J.bottomRows<3>();
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          jointColumns (joint_, begin, end);
+        }
+        bool equivalent (const CalculusNode& other) const {
+          const PointInJoint* o = dynamic_cast <const PointInJoint*> (&other);
+          return o && o->joint_ == joint_ && o->local_ == local_
+            && (joint_ || o->jacobian_.cols () == this->jacobian_.cols ());
+        }
         void computeCrossRXl () {
           if (joint_ == NULL) return;
           if (center_) {
@@ -730,6 +1445,21 @@ namespace hpp {
           computeCrossRXl ();
           this->jacobian_.noalias() = (- this->cross_ * R ) * J.bottomRows<3>();
         }
+        void accumulateAdjoint (vectorIn_t seed, RowJacobianOut_t out) {
+          if (joint_ == NULL) return;
+          const JointJacobian_t& J (joint_->jacobian ());
+          const vector3_t u (joint_->currentTransformation ().rotation ()
+              .transpose () * seed);
+          out.noalias() += vector_.cross (u).transpose () * J.bottomRows<3>();
+        }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          jointColumns (joint_, begin, end);
+        }
+        bool equivalent (const CalculusNode& other) const {
+          const VectorInJoint* o = dynamic_cast <const VectorInJoint*> (&other);
+          return o && o->joint_ == joint_ && o->vector_ == vector_
+            && (joint_ || o->jacobian_.cols () == this->jacobian_.cols ());
+        }
         void computeCrossRXl () {
           if (joint_ == NULL) return;
           computeCrossMatrix (
@@ -777,26 +1507,44 @@ namespace hpp {
 
         void impl_value () {}
         void impl_jacobian () {}
+        void accumulateAdjoint (vectorIn_t, RowJacobianOut_t) {}
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          begin = end = 0;
+        }
+        bool equivalent (const CalculusNode& other) const {
+          const Point* o = dynamic_cast <const Point*> (&other);
+          return o && o->value_ == this->value_
+            && o->jacobian_.cols () == this->jacobian_.cols ();
+        }
     };
 
     /// Basic expression representing a COM.
+    ///
+    /// When built from a CenterOfMassCache, the center of mass is computed
+    /// once per configuration for all the expressions sharing the cache.
     class PointCom : public CalculusBase <PointCom, vector3_t, ComJacobian_t>
     {
       public:
         typedef CalculusBase <PointCom, vector3_t, ComJacobian_t > Parent_t;
         HPP_CONSTRAINTS_CB_CREATE1 (PointCom, const CenterOfMassComputationPtr_t&)
+        HPP_CONSTRAINTS_CB_CREATE1 (PointCom, const CenterOfMassCachePtr_t&)
 
         PointCom () {}
 
         PointCom (const Parent_t& other):
           Parent_t (other),
-          comc_ (static_cast <const PointCom&>(other).centerOfMassComputation ())
+          comc_ (static_cast <const PointCom&>(other).centerOfMassComputation ()),
+          cache_ (static_cast <const PointCom&>(other).cache_)
         {
         }
 
         PointCom (const CenterOfMassComputationPtr_t& comc): comc_ (comc)
         {}
 
+        PointCom (const CenterOfMassCachePtr_t& cache):
+          comc_ (cache->computation ()), cache_ (cache)
+        {}
+
         inline const vector3_t& value () const {
           return comc_->com();
         }
@@ -808,17 +1556,29 @@ namespace hpp {
           return comc_;
         }
         void impl_value () {
-          comc_->compute (Device::COM);
+          if (cache_) cache_->compute (Device::COM);
+          else        comc_->compute (Device::COM);
         }
         void impl_jacobian () {
-          comc_->compute (Device::ALL);
-          // TODO: there is memory and time to be saved here as this copy is
-          // not important.
-          //this->jacobian_ = comc_->jacobian ();
+          if (cache_) cache_->compute (Device::ALL);
+          else        comc_->compute (Device::ALL);
+          // jacobian () refers to the jacobian of comc_, which is not
+          // copied.
+        }
+        /// Same as the default but the jacobian of comc_ is copied once
+        /// instead of being multiplied by unit seeds.
+        void jacobianInto (matrixOut_t out) {
+          computeJacobian ();
+          out = comc_->jacobian ();
+        }
+        bool equivalent (const CalculusNode& other) const {
+          const PointCom* o = dynamic_cast <const PointCom*> (&other);
+          return o && o->comc_ == comc_;
         }
 
       protected:
         CenterOfMassComputationPtr_t comc_;
+        CenterOfMassCachePtr_t cache_;
     };
 
     class JointFrame : public CalculusBase <JointFrame, Eigen::Matrix<value_type, 6, 1>, Eigen::Matrix<value_type, 6, Eigen::Dynamic> >
@@ -865,6 +1625,13 @@ namespace hpp {
           this->jacobian_.topRows<3>().noalias() = R * J.topRows<3>();
           this->jacobian_.bottomRows<3>().noalias() = (Jlog * R) * J.bottomRows<3>();
         }
+        void jacobianColumns (size_type& begin, size_type& end) const {
+          jointColumns (joint_, begin, end);
+        }
+        bool equivalent (const CalculusNode& other) const {
+          const JointFrame* o = dynamic_cast <const JointFrame*> (&other);
+          return o && o->joint_ == joint_;
+        }
 
       protected:
         JointPtr_t joint_;
@@ -875,9 +1642,24 @@ namespace hpp {
     };
 
     /// Matrix having Expression elements
-    template <typename ValueType = eigen::vector3_t, typename JacobianType = JacobianMatrix>
+    ///
+    /// \tparam Decomposition the singular value decomposition of the value.
+    ///         It has the interface of Eigen::JacobiSVD and is constructed
+    ///         with <tt>(rows, cols, Eigen::ComputeFullU |
+    ///         Eigen::ComputeFullV)</tt>. Possible choices are
+    ///         \li Eigen::JacobiSVD, the default,
+    ///         \li Eigen::BDCSVD (Eigen 3.3 or later), faster for large
+    ///             matrices,
+    ///         \li GramSVD, for wide matrices with few rows,
+    ///         \li WarmStartJacobiSVD, when the matrix is decomposed at
+    ///             nearby configurations.
+    template <typename ValueType = eigen::vector3_t,
+              typename JacobianType = JacobianMatrix,
+              typename Decomposition = Eigen::JacobiSVD <
+                Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic > > >
     class MatrixOfExpressions :
-      public CalculusBase <MatrixOfExpressions <ValueType, JacobianType > ,
+      public CalculusBase <MatrixOfExpressions <ValueType, JacobianType,
+                                                Decomposition > ,
                            Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic >,
                            Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic > >
     {
@@ -893,7 +1675,7 @@ namespace hpp {
         typedef CalculusBase <MatrixOfExpressions, Value_t, Jacobian_t > Parent_t;
         typedef CalculusBaseAbstract <ValueType, JacobianType> Element_t;
         typedef typename Traits<Element_t>::Ptr_t ElementPtr_t;
-        typedef Eigen::JacobiSVD <Value_t> SVD_t;
+        typedef Decomposition SVD_t;
 
         HPP_CONSTRAINTS_CB_CREATE2 (MatrixOfExpressions, const Eigen::Ref<const Value_t>&, const Eigen::Ref<const Jacobian_t>&)
 
@@ -902,7 +1684,8 @@ namespace hpp {
           Parent_t (value, jacobian),
           nRows_ (0), nCols_ (0),
           svd_ (value.rows(), value.cols(), Eigen::ComputeFullU | Eigen::ComputeFullV),
-          piValid_ (false), svdValid_ (false)
+          projectors_ (svd_),
+          piValid_ (false), svdValid_ (false), columnsValid_ (false)
         {}
 
         MatrixOfExpressions (const Parent_t& other) :
@@ -911,9 +1694,12 @@ namespace hpp {
           nCols_ (static_cast <const MatrixOfExpressions&>(other).nCols_),
           elements_ (static_cast <const MatrixOfExpressions&>(other).elements_),
           svd_ (static_cast <const MatrixOfExpressions&>(other).svd_),
+          projectors_ (svd_),
           piValid_ (static_cast <const MatrixOfExpressions&>(other).piValid_),
-          svdValid_ (static_cast <const MatrixOfExpressions&>(other).svdValid_)
+          svdValid_ (static_cast <const MatrixOfExpressions&>(other).svdValid_),
+          columnsValid_ (false)
         {
+          if (svdValid_) projectors_.update ();
         }
 
         MatrixOfExpressions (const MatrixOfExpressions& matrix) :
@@ -921,9 +1707,12 @@ namespace hpp {
           nRows_ (matrix.nRows_), nCols_ (matrix.nCols_),
           elements_ (matrix.elements_),
           svd_ (matrix.svd_),
+          projectors_ (svd_),
           piValid_ (matrix.piValid_),
-          svdValid_ (matrix.svdValid_)
+          svdValid_ (matrix.svdValid_),
+          columnsValid_ (false)
         {
+          if (svdValid_) projectors_.update ();
         }
 
         void setSize (std::size_t nRows, std::size_t nCols) {
@@ -932,14 +1721,26 @@ namespace hpp {
           elements_.resize (nRows_);
           for (std::size_t i = 0; i < nRows; ++i)
             elements_[i].resize(nCols);
+          columnsValid_ = false;
         }
 
         ElementPtr_t& operator() (std::size_t i, std::size_t j) {
+          columnsValid_ = false;
           return elements_[i][j];
         }
 
         void set (std::size_t i, std::size_t j, const ElementPtr_t ptr) {
           elements_[i][j] = ptr;
+          columnsValid_ = false;
+        }
+
+        /// Range of the columns where the jacobian of element (i,j) may be
+        /// non zero, relatively to the block of the element.
+        /// \return the first column and the number of columns.
+        const std::pair <size_type, size_type>& columns (std::size_t i,
+            std::size_t j) const {
+          computeColumns ();
+          return columns_[i][j];
         }
 
         void impl_value () {
@@ -958,17 +1759,18 @@ namespace hpp {
             r += nr;
           }
         }
+        /// The jacobians of the elements are written directly in their
+        /// block of the jacobian.
         void impl_jacobian () {
-          size_type r = 0, c = 0, nr = 0, nc = 0;
+          this->computeValue ();
+          size_type r = 0, c = 0, nr = 0;
+          const size_type nc = this->jacobian_.cols () / nCols_;
           for (std::size_t i = 0; i < nRows_; ++i) {
             c = 0;
-            nr = elements_[i][0]->jacobian().rows();
+            nr = elements_[i][0]->value().rows();
             for (std::size_t j = 0; j < nCols_; ++j) {
-              elements_[i][j]->computeJacobian ();
-              assert (nr == elements_[i][j]->jacobian().rows());
-              nc = elements_[i][j]->jacobian().cols();
-              this->jacobian_.block (r, c, nr, nc)
-                = elements_[i][j]->jacobian();
+              elements_[i][j]->jacobianInto
+                (this->jacobian_.block (r, c, nr, nc));
               c += nc;
             }
             r += nr;
@@ -984,78 +1786,215 @@ namespace hpp {
         void computeSVD () {
           if (svdValid_) return;
           this->computeValue ();
+          HPP_CONSTRAINTS_TRACE_SCOPE ("computeSVD", "svd");
           svd_.compute (this->value_);
+          projectors_.update ();
           HPP_DEBUG_SVDCHECK(svd_);
           svdValid_ = true;
         }
+        /// The buffers have a constant size so that no memory is
+        /// allocated after the first evaluation.
         void computePseudoInverse () {
           if (piValid_) return;
           this->computeValue ();
           this->computeSVD();
-          pi_.resize (this->value_.cols(), this->value_.rows());
-          pseudoInverse <SVD_t> (svd_, pi_);
+          // Singular values above the rank are zeroed instead of being
+          // removed.
+          const size_type k = svd_.singularValues ().size ();
+          const size_type rank = svd_.rank ();
+          invSv_.resize (k);
+          for (size_type i = 0; i < k; ++i)
+            invSv_[i] = (i < rank ? 1 / svd_.singularValues ()[i] : 0);
+          vs_.noalias() = svd_.matrixV ().leftCols (k) * invSv_.asDiagonal ();
+          pi_.noalias() = vs_ * svd_.matrixU ().leftCols (k).adjoint ();
           piValid_ = true;
         }
         void computePseudoInverseJacobian (const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, 1> >& rhs) {
           this->computeJacobian ();
           computePseudoInverse ();
-          const std::size_t nbDof = elements_[0][0]->jacobian().cols();
-          const std::size_t inSize = this->value_.cols();
-          const vector_t piTrhs = svd_.solve (rhs);
+          const size_type nbDof = this->jacobian_.cols () / nCols_;
+          const size_type inSize = this->value_.cols();
+          piTrhs_.noalias() = pi_ * rhs;
           assert (pi_.rows () == inSize);
 
-          Jacobian_t cache (this->jacobian_.rows(), nbDof);
-          jacobianTimes (piTrhs, cache);
-          pij_.noalias() = - pi_ * cache;
-          cache.resize (inSize, nbDof);
+          cacheJ_.resize (this->jacobian_.rows(), nbDof);
+          jacobianTimes (piTrhs_, cacheJ_);
+          pij_.noalias() = - pi_ * cacheJ_;
 
-          pkInv_.resize (pi_.cols(), pi_.cols());
-          projectorOnKernelOfInv <SVD_t> (svd_, pkInv_, true);
-          jacobianTransposeTimes (pkInv_ * rhs, cache);
-          pij_.noalias() += (pi_ * pi_.transpose()) * cache;
+          // The projectors on the kernels are applied without being formed.
+          cacheJT_.resize (inSize, nbDof);
+          rhsTmp_.resize (rhs.size ());
+          projectors_.projectOnKernelOfInv (rhs, rhsTmp_);
+          jacobianTransposeTimes (rhsTmp_, cacheJT_);
+          piTcache_.noalias() = pi_.transpose() * cacheJT_;
+          pij_.noalias() += pi_ * piTcache_;
 
-          jacobianTransposeTimes (pi_.transpose() * piTrhs , cache);
-          pk_.resize (inSize, inSize);
-          projectorOnKernel <SVD_t> (svd_, pk_, true);
-          pij_.noalias() += pk_ * cache;
+          rhsTmp_.noalias() = pi_.transpose() * piTrhs_;
+          jacobianTransposeTimes (rhsTmp_, cacheJT_);
+          projectors_.projectOnKernel (cacheJT_, cacheJT_);
+          pij_ += cacheJT_;
         }
 
+        /// computeJacobian should be called before.
+        /// Only the columns where the jacobians of the elements may be non
+        /// zero are read.
         void jacobianTimes (const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, 1> >& rhs, Eigen::Ref<Jacobian_t> cache) const {
-          size_type r = 0, c = 0, nr = 0, nc = 0;
+          computeColumns ();
+          size_type r = 0, c = 0, nr = 0;
+          const size_type nc = this->jacobian_.cols () / nCols_;
           cache.setZero();
           for (std::size_t i = 0; i < nRows_; ++i) {
             c = 0;
-            nr = elements_[i][0]->jacobian().rows();
+            nr = elements_[i][0]->value().rows();
             for (std::size_t j = 0; j < nCols_; ++j) {
-              elements_[i][j]->computeJacobian ();
-              assert (nr == elements_[i][j]->jacobian().rows());
-              nc = elements_[i][j]->jacobian().cols();
-              cache.middleRows (r,nr).noalias() +=
-                this->jacobian_.block (r, c, nr, nc) * rhs[j];
+              const std::pair <size_type, size_type>& cols = columns_[i][j];
+              if (cols.second > 0 && rhs[j] != 0)
+                cache.block (r, cols.first, nr, cols.second).noalias() +=
+                  this->jacobian_.block (r, c + cols.first, nr, cols.second)
+                  * rhs[j];
               c += nc;
             }
             r += nr;
           }
         }
 
+        /// Row \f$ j \f$ of cache is \f$ \sum_i rhs_i^T J_{ij} \f$.
+        /// If the jacobian of the matrix is up to date, only the columns
+        /// where the jacobians of the elements may be non zero are read.
+        /// Otherwise, it is computed in reverse mode and does not require
+        /// the jacobian of the matrix.
         void jacobianTransposeTimes (const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, 1> >& rhs, Eigen::Ref<Jacobian_t> cache) const {
-          size_type r = 0, c = 0, nr = 0, nc = 0;
+          size_type r = 0, nr = 0;
+          cache.setZero();
+          if (this->jValid_) {
+            computeColumns ();
+            const size_type nc = this->jacobian_.cols () / nCols_;
+            for (std::size_t i = 0; i < nRows_; ++i) {
+              nr = elements_[i][0]->value().rows();
+              for (std::size_t j = 0; j < nCols_; ++j) {
+                const std::pair <size_type, size_type>& cols = columns_[i][j];
+                if (cols.second == 0) continue;
+                cache.row (j).segment (cols.first, cols.second).noalias() +=
+                  rhs.segment (r, nr).transpose () * this->jacobian_.block
+                  (r, j * nc + cols.first, nr, cols.second);
+              }
+              r += nr;
+            }
+            return;
+          }
+          for (std::size_t i = 0; i < nRows_; ++i) {
+            nr = elements_[i][0]->value().rows();
+            for (std::size_t j = 0; j < nCols_; ++j) {
+              elements_[i][j]->computeValue ();
+              elements_[i][j]->accumulateAdjoint (rhs.segment (r, nr), cache.row (j));
+            }
+            r += nr;
+          }
+        }
+
+        /// jacobianTimes for each column of rhs, in one pass on the
+        /// jacobian of the matrix.
+        ///
+        /// Rows \f$ k R \f$ to \f$ (k+1) R \f$ of cache, where \f$ R \f$
+        /// is the number of rows of the matrix, are jacobianTimes of column
+        /// \f$ k \f$ of rhs. computeJacobian should be called before.
+        void jacobianTimesColumns (const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic> >& rhs, Eigen::Ref <Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic> > cache) const {
+          computeColumns ();
+          const size_type R = this->jacobian_.rows ();
+          const size_type nc = this->jacobian_.cols () / nCols_;
+          assert (cache.rows () == R * rhs.cols ());
+          size_type r = 0, c = 0, nr = 0;
           cache.setZero();
           for (std::size_t i = 0; i < nRows_; ++i) {
             c = 0;
-            nr = elements_[i][0]->jacobian().rows();
+            nr = elements_[i][0]->value().rows();
             for (std::size_t j = 0; j < nCols_; ++j) {
-              elements_[i][j]->computeJacobian ();
-              assert (nr == elements_[i][j]->jacobian().rows());
-              nc = elements_[i][j]->jacobian().cols();
-              cache.row (j) += rhs.segment (r, nr).transpose() * this->jacobian_.block (r, c, nr, nc);
+              const std::pair <size_type, size_type>& cols = columns_[i][j];
+              if (cols.second > 0)
+                for (size_type k = 0; k < rhs.cols (); ++k)
+                  if (rhs (j, k) != 0)
+                    cache.block (k * R + r, cols.first, nr, cols.second)
+                      .noalias() += this->jacobian_.block
+                      (r, c + cols.first, nr, cols.second) * rhs (j, k);
               c += nc;
             }
             r += nr;
           }
         }
 
-        Eigen::JacobiSVD <Value_t>& svd () { return svd_; }
+        /// jacobianTransposeTimes for each column of rhs, in one pass on
+        /// the jacobian of the matrix.
+        ///
+        /// Rows \f$ k C \f$ to \f$ (k+1) C \f$ of cache, where \f$ C \f$
+        /// is the number of columns of the matrix, are
+        /// jacobianTransposeTimes of column \f$ k \f$ of rhs.
+        /// computeJacobian should be called before.
+        void jacobianTransposeTimesColumns (const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic> >& rhs, Eigen::Ref <Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic> > cache) const {
+          assert (this->jValid_);
+          computeColumns ();
+          const size_type C = (size_type) nCols_;
+          const size_type nc = this->jacobian_.cols () / nCols_;
+          assert (cache.rows () == C * rhs.cols ());
+          size_type r = 0, nr = 0;
+          cache.setZero();
+          for (std::size_t i = 0; i < nRows_; ++i) {
+            nr = elements_[i][0]->value().rows();
+            for (std::size_t j = 0; j < nCols_; ++j) {
+              const std::pair <size_type, size_type>& cols = columns_[i][j];
+              if (cols.second == 0) continue;
+              for (size_type k = 0; k < rhs.cols (); ++k)
+                cache.row (k * C + j).segment (cols.first, cols.second)
+                  .noalias() += rhs.col (k).segment (r, nr).transpose ()
+                  * this->jacobian_.block (r, j * nc + cols.first, nr,
+                      cols.second);
+            }
+            r += nr;
+          }
+        }
+
+        /// Compute \f$ lhs^T \frac{d (M rhs)}{dq} \f$, \f$ rhs \f$ being
+        /// constant, i.e. \f$ \sum_{i,j} rhs_j lhs_i^T J_{ij} \f$.
+        ///
+        /// It is computed in reverse mode and the cost does not depend on
+        /// the number of columns of the jacobian of the matrix.
+        void jacobianAdjoint (const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, 1> >& lhs,
+            const Eigen::Ref <const Eigen::Matrix<value_type, Eigen::Dynamic, 1> >& rhs,
+            RowJacobianOut_t out) const {
+          size_type r = 0, nr = 0;
+          out.setZero();
+          ValueType seed;
+          for (std::size_t i = 0; i < nRows_; ++i) {
+            nr = elements_[i][0]->value().rows();
+            for (std::size_t j = 0; j < nCols_; ++j) {
+              if (rhs[j] == 0) continue;
+              elements_[i][j]->computeValue ();
+              seed = rhs[j] * lhs.segment (r, nr);
+              elements_[i][j]->accumulateAdjoint (seed, out);
+            }
+            r += nr;
+          }
+        }
+
+        SVD_t& svd () { return svd_; }
+
+        /// Compute the ranges of columns of the elements if the elements
+        /// changed.
+        void computeColumns () const {
+          if (columnsValid_) return;
+          const size_type nc = this->jacobian_.cols () / nCols_;
+          columns_.resize (nRows_);
+          for (std::size_t i = 0; i < nRows_; ++i) {
+            columns_[i].resize (nCols_);
+            for (std::size_t j = 0; j < nCols_; ++j) {
+              size_type b, e;
+              elements_[i][j]->jacobianColumns (b, e);
+              b = std::min (std::max (b, size_type (0)), nc);
+              e = std::min (std::max (e, b), nc);
+              columns_[i][j] = std::make_pair (b, e - b);
+            }
+          }
+          columnsValid_ = true;
+        }
 
         void invalidate () {
           Parent_t::invalidate ();
@@ -1065,16 +2004,41 @@ namespace hpp {
           piValid_ = false;
           svdValid_ = false;
         }
+        void invalidateNode () {
+          Parent_t::invalidateNode ();
+          piValid_ = false;
+          svdValid_ = false;
+        }
+        void dependencies (std::vector <CalculusNode*>& deps) const {
+          for (std::size_t i = 0; i < nRows_; ++i)
+            for (std::size_t j = 0; j < nCols_; ++j)
+              deps.push_back (elements_[i][j].get ());
+        }
+        void mergeLeaves (CalculusGraph& graph) {
+          for (std::size_t i = 0; i < nRows_; ++i)
+            for (std::size_t j = 0; j < nCols_; ++j)
+              graph.merge (elements_[i][j]);
+        }
 
         std::size_t nRows_, nCols_;
         std::vector <std::vector <ElementPtr_t> > elements_;
 
       private:
         SVD_t svd_;
-        matrix_t pkInv_, pk_;
+        SVDProjectors <SVD_t> projectors_;
         PseudoInv_t pi_;
         PseudoInvJacobian_t pij_;
         bool piValid_, svdValid_;
+        /// First column and number of columns of the jacobian of each
+        /// element.
+        mutable std::vector <std::vector <std::pair <size_type, size_type> > >
+          columns_;
+        mutable bool columnsValid_;
+
+        // Buffers of computePseudoInverse and computePseudoInverseJacobian.
+        vector_t invSv_, piTrhs_, rhsTmp_;
+        matrix_t vs_;
+        Jacobian_t cacheJ_, cacheJT_, piTcache_;
 
       public:
         EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -17,12 +17,15 @@
 #ifndef HPP_CONSTRAINTS_SYMBOLIC_FUNCTION_HH
 # define HPP_CONSTRAINTS_SYMBOLIC_FUNCTION_HH
 
+# include <algorithm>
+
 # include <boost/assign/list_of.hpp>
 
 # include <hpp/constraints/fwd.hh>
 # include <hpp/constraints/config.hh>
 # include <hpp/constraints/symbolic-calculus.hh>
 # include <hpp/constraints/differentiable-function.hh>
+# include <hpp/constraints/kinematics-cache.hh>
 
 # include <hpp/pinocchio/device.hh>
 
@@ -64,7 +67,12 @@ namespace hpp {
             const typename Traits<Expression>::Ptr_t expr,
             std::vector <bool> mask) :
           DifferentiableFunction (robot->configSize(), robot->numberDof(), expr->value().size(), name),
-          robot_ (robot), expr_ (expr), mask_ (mask) {}
+          robot_ (robot), kinematics_ (KinematicsCache::get (robot)),
+          expr_ (expr), mask_ (mask),
+          fullMask_ (std::find (mask.begin (), mask.end (), false) == mask.end ())
+        {
+          graph_.add (expr_);
+        }
 
       protected:
         /// Compute value of error
@@ -74,9 +82,8 @@ namespace hpp {
         virtual void impl_compute (vectorOut_t result,
             ConfigurationIn_t argument) const throw ()
         {
-          robot_->currentConfiguration (argument);
-          robot_->computeForwardKinematics ();
-          expr_->invalidate ();
+          kinematics_->update (argument, KinematicsCache::PLACEMENTS);
+          graph_.update (kinematics_->version ());
           expr_->computeValue ();
           size_t index = 0;
           for (std::size_t i = 0; i < mask_.size (); i++) {
@@ -88,9 +95,12 @@ namespace hpp {
         virtual void impl_jacobian (matrixOut_t jacobian,
             ConfigurationIn_t arg) const throw ()
         {
-          robot_->currentConfiguration (arg);
-          robot_->computeForwardKinematics ();
-          expr_->invalidate ();
+          kinematics_->update (arg, KinematicsCache::JACOBIANS);
+          graph_.update (kinematics_->version ());
+          if (fullMask_) {
+            expr_->jacobianInto (jacobian);
+            return;
+          }
           expr_->computeJacobian ();
           size_t index = 0;
           for (std::size_t i = 0; i < mask_.size (); i++) {
@@ -99,14 +109,41 @@ namespace hpp {
           }
         }
 
+        virtual void impl_valueAndJacobian (vectorOut_t result,
+            matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+        {
+          kinematics_->update (arg, KinematicsCache::JACOBIANS);
+          graph_.update (kinematics_->version ());
+          expr_->computeValue ();
+          if (fullMask_) {
+            for (std::size_t i = 0; i < mask_.size (); i++)
+              result[i] = expr_->value ()[i];
+            expr_->jacobianInto (jacobian);
+            return;
+          }
+          expr_->computeJacobian ();
+          size_t index = 0;
+          for (std::size_t i = 0; i < mask_.size (); i++) {
+            if (mask_[i]) {
+              result[index] = expr_->value ()[i];
+              jacobian.row (index++) = expr_->jacobian ().row (i);
+            }
+          }
+        }
+
         void init (const Ptr_t& self) {
           wkPtr_ = self;
         }
       private:
         WkPtr_t wkPtr_;
         DevicePtr_t robot_;
+        KinematicsCachePtr_t kinematics_;
         typename Traits<Expression>::Ptr_t expr_;
         std::vector <bool> mask_;
+        /// Whether all the rows are selected, in which case the jacobian
+        /// is written directly in the output.
+        bool fullMask_;
+        mutable CalculusGraph graph_;
     }; // class ComBetweenFeet
   } // namespace constraints
 } // namespace hpp
@@ -18,6 +18,7 @@
 #define HPP_CONSTRAINTS_TOOL_HH
 
 #include <boost/math/constants/constants.hpp>
+#include <Eigen/Geometry>
 
 #include <hpp/constraints/fwd.hh>
 
@@ -56,6 +57,25 @@ namespace hpp {
       }
     }
 
+    /// Compute the log of a rotation from its quaternion.
+    ///
+    /// The angle is computed with atan2, which is accurate for all angles,
+    /// so there is no special case around rotations of angle pi.
+    /// computeJlog can be used on the result.
+    template <typename Derived>
+      inline void computeLogFromQuaternion (const matrix3_t& Rerror,
+          value_type& theta, Eigen::MatrixBase<Derived> const& result)
+    {
+      Eigen::MatrixBase<Derived>& value = const_cast<Eigen::MatrixBase<Derived>&> (result);
+      Eigen::Quaternion<value_type> q (Rerror);
+      // Keep theta in [0, pi].
+      if (q.w () < 0) q.coeffs () *= -1;
+      const value_type n = q.vec ().norm ();
+      theta = 2 * atan2 (n, q.w ());
+      // theta / n tends to 2 / w when n tends to 0.
+      value = ((n > 1e-6) ? theta / n : 2 / q.w ()) * q.vec ();
+    }
+
     template <typename Derived>
       void computeJlog (const value_type& theta, const Eigen::MatrixBase<Derived>& log, matrix3_t& Jlog)
     {
@@ -80,6 +100,81 @@ namespace hpp {
       }
     }
 
+    /// Coefficients of N 3x3 matrices stored as a structure of arrays.
+    /// Row 3*j+i contains coefficient (i,j) of every matrix, so that the
+    /// batched functions below work on contiguous rows.
+    typedef Eigen::Matrix <value_type, 9, Eigen::Dynamic, Eigen::RowMajor>
+      matrices3_t;
+    /// Coordinates of N 3d vectors stored as a structure of arrays.
+    typedef Eigen::Matrix <value_type, 3, Eigen::Dynamic, Eigen::RowMajor>
+      vectors3_t;
+
+    /// Compute the log of N rotations.
+    ///
+    /// Both regimes of computeLog are evaluated for all rotations and the
+    /// result is selected without branching, so that Eigen can vectorize
+    /// the computation along the rows.
+    /// \param R the rotations,
+    /// \retval theta the N angles,
+    /// \retval result the N logs.
+    inline void computeLogs (const matrices3_t& R, vector_t& theta,
+        vectors3_t& result)
+    {
+      typedef Eigen::Array <value_type, 1, Eigen::Dynamic> Row_t;
+      const value_type PI = ::boost::math::constants::pi<value_type>();
+      const size_type n = R.cols ();
+      theta.resize (n);
+      result.resize (3, n);
+      // Same thresholds as computeLog.
+      const Row_t tr = R.row (0).array () + R.row (4).array () + R.row (8).array ();
+      const Row_t th = ((tr - 1) / 2).max (-1).min (1).acos ();
+      const Row_t t = (th > 1e-6).select (th / th.sin (), 1) / 2;
+      const Row_t cphi = (th - PI).cos ();
+      const Row_t beta = th.square () / (1 + cphi);
+      // Rows of R(2,1), R(0,2), R(1,0), of R(1,2), R(2,0), R(0,1) and of
+      // the diagonal.
+      const int up [3] = { 5, 6, 1 }, low [3] = { 7, 2, 3 },
+                diag [3] = { 0, 4, 8 };
+      for (int k = 0; k < 3; ++k) {
+        const Row_t diff = R.row (up[k]).array () - R.row (low[k]).array ();
+        const Row_t tmp = ((R.row (diag[k]).array () + cphi) * beta).max (0);
+        const Row_t sign = (diff > 0).template cast <value_type> () * 2 - 1;
+        result.row (k).array () =
+          (th < PI - 1e-2).select (t * diff, sign * tmp.sqrt ());
+      }
+      theta = th.matrix ().transpose ();
+    }
+
+    /// Compute the jacobian of the log of N rotations.
+    ///
+    /// \param theta, log the output of computeLogs,
+    /// \retval Jlog the N jacobians.
+    /// \sa computeJlog
+    inline void computeJlogs (const vector_t& theta, const vectors3_t& log,
+        matrices3_t& Jlog)
+    {
+      typedef Eigen::Array <value_type, 1, Eigen::Dynamic> Row_t;
+      const size_type n = theta.size ();
+      Jlog.resize (9, n);
+      const Row_t th = theta.transpose ().array ();
+      const Eigen::Array <bool, 1, Eigen::Dynamic> small = (th < 1e-6);
+      const Row_t st_1mct = th.sin () / (1 - th.cos ());
+      const Row_t alpha = 1 / th.square () - st_1mct / (2 * th);
+      const Row_t d = th * st_1mct / 2;
+      const Row_t l0 = log.row (0).array (), l1 = log.row (1).array (),
+                  l2 = log.row (2).array ();
+      // Jlog = (theta st_1mct I - r_{\times}) / 2 + alpha r r^T
+      Jlog.row (0).array () = small.select (1, d + alpha * l0 * l0);
+      Jlog.row (4).array () = small.select (1, d + alpha * l1 * l1);
+      Jlog.row (8).array () = small.select (1, d + alpha * l2 * l2);
+      Jlog.row (3).array () = small.select (0,  l2 / 2 + alpha * l0 * l1);
+      Jlog.row (1).array () = small.select (0, -l2 / 2 + alpha * l0 * l1);
+      Jlog.row (6).array () = small.select (0, -l1 / 2 + alpha * l0 * l2);
+      Jlog.row (2).array () = small.select (0,  l1 / 2 + alpha * l0 * l2);
+      Jlog.row (7).array () = small.select (0,  l0 / 2 + alpha * l1 * l2);
+      Jlog.row (5).array () = small.select (0, -l0 / 2 + alpha * l1 * l2);
+    }
+
     template < typename VectorType, typename MatrixType >
     static void computeCrossMatrix (const VectorType& v, MatrixType& m)
     {
@@ -0,0 +1,88 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_TRACE_HH
+# define HPP_CONSTRAINTS_TRACE_HH
+
+# include <iosfwd>
+# include <string>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+/// Record a span named name, of category category, until the end of the
+/// enclosing block. Both are C strings. The span is recorded only if the
+/// library is compiled with ENABLE_TRACE and tracing is started.
+# ifdef HPP_CONSTRAINTS_WITH_TRACE
+#  define HPP_CONSTRAINTS_TRACE_SCOPE(name, category)                   \
+  ::hpp::constraints::trace::Span _hpp_constraints_span (name, category)
+# else
+#  define HPP_CONSTRAINTS_TRACE_SCOPE(name, category)
+# endif
+
+namespace hpp {
+  namespace constraints {
+    /// Record the evaluations of the functions in the Chrome trace event
+    /// format, that can be opened with chrome://tracing or Perfetto.
+    ///
+    /// Each thread writes its spans in its own ring buffer, without
+    /// locking. When a buffer is full, the oldest spans are overwritten.
+    ///
+    /// \code
+    ///   trace::start ();
+    ///   // Solve...
+    ///   trace::stop ();
+    ///   std::ofstream file ("constraints.json");
+    ///   trace::write (file);
+    /// \endcode
+    ///
+    /// Spans are recorded only if the library is compiled with the CMake
+    /// option ENABLE_TRACE.
+    namespace trace {
+      /// Start recording.
+      /// \param capacity number of spans kept per thread.
+      /// The spans recorded before are cleared. No function should be
+      /// being evaluated.
+      HPP_CONSTRAINTS_DLLAPI void start (std::size_t capacity = 1 << 16);
+
+      /// Stop recording. The recorded spans are kept.
+      HPP_CONSTRAINTS_DLLAPI void stop ();
+
+      /// Whether spans are being recorded.
+      HPP_CONSTRAINTS_DLLAPI bool started ();
+
+      /// Write the recorded spans in the JSON trace event format.
+      /// \note No span should be recorded while writing.
+      HPP_CONSTRAINTS_DLLAPI void write (std::ostream& os);
+
+      /// A span of time.
+      class HPP_CONSTRAINTS_DLLAPI Span
+      {
+        public:
+          /// \param name, category C strings, copied at the end of the span.
+          Span (const char* name, const char* category);
+          ~Span ();
+
+        private:
+          const char* name_;
+          const char* category_;
+          long begin_;
+      }; // class Span
+    } // namespace trace
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_TRACE_HH
@@ -0,0 +1,161 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_TRANSFORMATION_SET_HH
+# define HPP_CONSTRAINTS_TRANSFORMATION_SET_HH
+
+# include <vector>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+# include <hpp/constraints/differentiable-function.hh>
+# include <hpp/constraints/kinematics-cache.hh>
+# include <hpp/constraints/tools.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// A set of absolute Position, Orientation or Transformation constraints
+    ///
+    /// Target \f$i\f$ is the same function as
+    /// \code
+    ///   Transformation::create (name, robot, joint, frame, reference, mask)
+    /// \endcode
+    /// that is the position and the log of the orientation of the frame
+    /// \f$F_i\f$ of its joint with respect to the reference
+    /// \f$M_{ref\,i}\f$, expressed in the reference frame. The rows of the
+    /// targets are stacked in the order of the targets, the masked rows
+    /// being removed.
+    ///
+    /// The frames, the references and the masks are stored as structures
+    /// of arrays, sorted by joint. After one forward kinematics, the
+    /// errors of all the targets are computed row by row (see
+    /// packed-kinematics.hh) and \f$R J\f$ is computed once per joint.
+    /// The jacobian rows are written straight into the output and no
+    /// memory is allocated by the evaluation.
+    ///
+    /// This is meant for marker tracking and retargeting, where tens or
+    /// hundreds of frames of the robot have a target.
+    class HPP_CONSTRAINTS_DLLAPI TransformationSet :
+      public DifferentiableFunction
+    {
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      /// A frame of a joint and its reference in the world frame.
+      struct Target
+      {
+        Target (const JointPtr_t& j, const Transform3f& f,
+            const Transform3f& r,
+            const std::vector <bool>& m = std::vector <bool> (6, true)) :
+          joint (j), frame (f), reference (r), mask (m) {}
+        /// Joint holding the frame, may not be NULL.
+        JointPtr_t joint;
+        /// Frame in joint.
+        Transform3f frame;
+        /// Desired placement of the frame in the world frame.
+        Transform3f reference;
+        /// Rows of the error taken into account: 3 for the position
+        /// followed by 3 for the orientation.
+        std::vector <bool> mask;
+      };
+      typedef std::vector <Target> Targets_t;
+
+      /// Create instance and return shared pointer
+      ///
+      /// \param name name of the constraint,
+      /// \param robot robot that own the joints,
+      /// \param targets the frames and their references.
+      static TransformationSetPtr_t create
+	(const std::string& name, const DevicePtr_t& robot,
+         const Targets_t& targets);
+
+      virtual ~TransformationSet () throw () {}
+
+      const Targets_t& targets () const
+      {
+        return targets_;
+      }
+
+      /// Set the reference of target i.
+      /// The frames and the masks cannot be changed.
+      void reference (std::size_t i, const Transform3f& reference);
+
+      virtual MemoryUsage memoryUsage () const;
+
+    protected:
+      /// Protected constructor
+      /// \sa create
+      TransformationSet (const std::string& name, const DevicePtr_t& robot,
+          const Targets_t& targets);
+
+      virtual void impl_compute (vectorOut_t result,
+				 ConfigurationIn_t argument) const throw ();
+      virtual void impl_jacobian (matrixOut_t jacobian,
+				  ConfigurationIn_t arg) const throw ();
+      virtual void impl_valueAndJacobian (vectorOut_t result,
+                                          matrixOut_t jacobian,
+                                          ConfigurationIn_t arg) const;
+
+    private:
+      typedef Eigen::Matrix <size_type, 6, Eigen::Dynamic> Rows_t;
+
+      /// Compute the errors of all the targets.
+      void computeErrors () const;
+      /// \f$R J\f$ of the joints.
+      void computeJointJacobians () const;
+      void copyValue (vectorOut_t result) const;
+
+      DevicePtr_t robot_;
+      KinematicsCachePtr_t kinematics_;
+      Targets_t targets_;
+      KinematicsCache::Joints_t jointSet_;
+      /// Joints holding the frames, without duplicates.
+      std::vector <JointPtr_t> joints_;
+      /// The targets of joint j are the columns
+      /// [groupBegin_[j], groupBegin_[j+1][ of the arrays below.
+      std::vector <size_type> groupBegin_;
+      /// Column of each target in the arrays below.
+      std::vector <size_type> column_;
+      /// Output row of each coordinate of the error, -1 if masked.
+      Rows_t rows_;
+      matrices3_t frameRotation_, referenceRotation_;
+      vectors3_t frameTranslation_, referenceTranslation_;
+      bool hasOrientation_;
+      /// Columns where the jacobian may be non zero.
+      size_type colBegin_, activeCols_;
+
+      /// Rows 6j to 6j+3 contain \f$R J_{\mathbf{v}}\f$ of joint j and
+      /// rows 6j+3 to 6j+6 contain \f$R J_{\omega}\f$, restricted to
+      /// the active columns.
+      mutable matrix_t RJ_;
+      /// Origin of the frames with respect to their joint and rotation of
+      /// the frames, in the world frame.
+      mutable vectors3_t arm_;
+      mutable matrices3_t rotation_;
+      /// Errors expressed in the reference frames.
+      mutable vectors3_t difference_, position_, log_;
+      mutable matrices3_t errorRotation_, Jlog_;
+      mutable vector_t theta_;
+      mutable std::size_t errorVersion_, jacobianVersion_;
+    }; // class TransformationSet
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_TRANSFORMATION_SET_HH
@@ -0,0 +1,103 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_WORKSPACE_HH
+# define HPP_CONSTRAINTS_WORKSPACE_HH
+
+# include <map>
+
+# include <hpp/constraints/fwd.hh>
+# include <hpp/constraints/config.hh>
+
+namespace hpp {
+  namespace constraints {
+    /// \addtogroup constraints
+    /// \{
+
+    /// Evaluation data of functions, to be used by one thread.
+    ///
+    /// Functions are definitions that can be shared between threads. The
+    /// intermediate results of an evaluation are stored in a Workspace,
+    /// the same way pinocchio separates se3::Model from se3::Data. Each
+    /// thread creates its own Workspace and passes it to
+    /// DifferentiableFunction::operator() and
+    /// DifferentiableFunction::jacobian.
+    ///
+    /// The workspace owns a copy of the robot, so that forward kinematics
+    /// does not modify the robot the functions were created with.
+    ///
+    /// \code
+    ///   WorkspacePtr_t ws = Workspace::create (robot);
+    ///   f (value, q, *ws);
+    ///   f.jacobian (J, q, *ws);
+    /// \endcode
+    class HPP_CONSTRAINTS_DLLAPI Workspace
+    {
+      public:
+        /// Base class of the data stored by one function in a workspace.
+        struct FunctionData
+        {
+          virtual ~FunctionData () {}
+        };
+        typedef boost::shared_ptr <FunctionData> FunctionDataPtr_t;
+
+        /// Create a workspace for functions bound to robot.
+        static WorkspacePtr_t create (const DevicePtr_t& robot);
+
+        /// Robot the functions were created with.
+        const DevicePtr_t& reference () const
+        {
+          return reference_;
+        }
+
+        /// Copy of the robot owned by this workspace.
+        const DevicePtr_t& robot () const
+        {
+          return robot_;
+        }
+
+        /// Kinematics cache of the copy of the robot.
+        const KinematicsCachePtr_t& kinematics () const
+        {
+          return kinematics_;
+        }
+
+        /// Joint of robot() corresponding to a joint of reference().
+        /// \return NULL if joint is NULL.
+        JointPtr_t joint (const JointConstPtr_t& joint) const;
+
+        /// Data of a function.
+        ///
+        /// The returned pointer is NULL the first time. The function should
+        /// then allocate it.
+        FunctionDataPtr_t& data (const DifferentiableFunction& f)
+        {
+          return data_[&f];
+        }
+
+      private:
+        Workspace (const DevicePtr_t& robot);
+
+        DevicePtr_t reference_, robot_;
+        KinematicsCachePtr_t kinematics_;
+        mutable std::vector <JointPtr_t> joints_;
+        std::map <const DifferentiableFunction*, FunctionDataPtr_t> data_;
+    }; // class Workspace
+    /// \}
+  } // namespace constraints
+} // namespace hpp
+
+#endif // HPP_CONSTRAINTS_WORKSPACE_HH
@@ -0,0 +1,187 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#define BOOST_TEST_MODULE timing
+#include <boost/test/included/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <hpp/model/device.hh>
+#include <hpp/pinocchio/device.hh>
+
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+#include <hpp/pinocchio/hpp-model/conversions.hh>
+#include <hpp/pinocchio/hpp-model/model-loader.hh>
+
+#include "hpp/_constraints/generic-transformation.hh"
+#include "hpp/constraints/generic-transformation.hh"
+#include "hpp/_constraints/relative-com.hh"
+#include "hpp/constraints/relative-com.hh"
+#include "hpp/_constraints/com-between-feet.hh"
+#include "hpp/constraints/com-between-feet.hh"
+#include "hpp/_constraints/distance-between-bodies.hh"
+#include "hpp/constraints/distance-between-bodies.hh"
+#include <hpp/_constraints/configuration-constraint.hh>
+#include <hpp/constraints/configuration-constraint.hh>
+
+#include <stdlib.h>
+#include <iostream>
+#include <limits>
+#include <math.h>
+
+const static size_t NUMBER_RANDOM_SAMPLES = 100;
+const static size_t NUMBER_ITERATIONS = 10000;
+const bool verbose = false;
+const bool verboseNum = false;
+
+using std::numeric_limits;
+using boost::assign::list_of;
+
+typedef std::vector<bool> BoolVector_t;
+
+namespace c  = hpp::constraints;
+namespace _c = hpp::_constraints;
+
+namespace model = hpp::model    ;
+namespace pinoc = hpp::pinocchio;
+
+#include <../pmdiff/tools.cc>
+
+_c::Transform3f tIdM = _c::Transform3f();
+c ::Transform3f tIdP = c ::Transform3f::Identity();
+
+typedef boost::posix_time::ptime Time_t;
+
+Time_t now ()
+{
+  return boost::posix_time::microsec_clock::universal_time ();
+}
+
+/// Average duration of an evaluation since start, in nanoseconds.
+double elapsed (const Time_t& start)
+{
+  return (double) (now () - start).total_microseconds ()
+    * 1e3 / (double) NUMBER_ITERATIONS;
+}
+
+void print (const std::string& name, const char* evaluation,
+    double model, double pinocchio)
+{
+  std::cout << name << ',' << evaluation << ',' << model << ','
+    << pinocchio << std::endl;
+  BOOST_WARN_MESSAGE (pinocchio <= model, name << ": the " << evaluation
+      << " takes " << pinocchio << " ns with hpp-pinocchio and " << model
+      << " ns with hpp-model.");
+}
+
+/// Time the value and the jacobian of both implementations at the same
+/// random configurations.
+/// Print a line per evaluation: name,evaluation,hpp-model ns,hpp-pinocchio ns
+void compare_timing (_c::DevicePtr_t rm, c::DevicePtr_t rp,
+    _c::DifferentiableFunctionPtr_t fm, c::DifferentiableFunctionPtr_t fp,
+    const std::string& name)
+{
+  std::vector <_c::Configuration_t> qms (NUMBER_RANDOM_SAMPLES);
+  std::vector <c ::Configuration_t> qps (NUMBER_RANDOM_SAMPLES);
+  for (size_t i = 0; i < NUMBER_RANDOM_SAMPLES; i++) {
+    qps[i] = se3::randomConfiguration(rp->model());
+    qms[i] = p2m::q(qps[i]);
+  }
+  _c::vector_t valueM (fm->outputSize ());
+  c ::vector_t valueP (fp->outputSize ());
+  _c::matrix_t jacobianM (fm->outputDerivativeSize (), rm->numberDof ());
+  c ::matrix_t jacobianP (fp->outputDerivativeSize (), rp->numberDof ());
+
+  Time_t start = now ();
+  for (size_t i = 0; i < NUMBER_ITERATIONS; i++)
+    (*fm) (valueM, qms[i % NUMBER_RANDOM_SAMPLES]);
+  const double valueModel = elapsed (start);
+  start = now ();
+  for (size_t i = 0; i < NUMBER_ITERATIONS; i++)
+    (*fp) (valueP, qps[i % NUMBER_RANDOM_SAMPLES]);
+  print (name, "value", valueModel, elapsed (start));
+
+  start = now ();
+  for (size_t i = 0; i < NUMBER_ITERATIONS; i++)
+    fm->jacobian (jacobianM, qms[i % NUMBER_RANDOM_SAMPLES]);
+  const double jacobianModel = elapsed (start);
+  start = now ();
+  for (size_t i = 0; i < NUMBER_ITERATIONS; i++)
+    fp->jacobian (jacobianP, qps[i % NUMBER_RANDOM_SAMPLES]);
+  print (name, "jacobian", jacobianModel, elapsed (start));
+}
+
+BOOST_AUTO_TEST_CASE (timing) {
+  model::DevicePtr_t rm;
+  pinoc::DevicePtr_t rp;
+  setupRobots(rm, rp, true);
+
+  _c::JointPtr_t eeM1 = rm->getJointByName ("RWristPitch");
+  c ::JointPtr_t eeP1 = rp->getJointByName ("RWristPitch");
+  _c::JointPtr_t eeM2 = rm->getJointByName ("LWristPitch");
+  c ::JointPtr_t eeP2 = rp->getJointByName ("LWristPitch");
+  _c::JointPtr_t eeMR = rm->getJointByName ("RAnkleRoll");
+  c ::JointPtr_t eePR = rp->getJointByName ("RAnkleRoll");
+  _c::JointPtr_t eeML = rm->getJointByName ("LAnkleRoll");
+  c ::JointPtr_t eePL = rp->getJointByName ("LAnkleRoll");
+
+  std::cout << "function,evaluation,hpp-model,hpp-pinocchio" << std::endl;
+
+  compare_timing (rm, rp,
+        _c::Position::create ("ModelPosition", rm, eeM1, tIdM),
+        c ::Position::create ("PinocPosition", rp, eeP1, tIdP),
+        "Position");
+  compare_timing (rm, rp,
+        _c::Orientation::create ("ModelOrientation", rm, eeM1, tIdM),
+        c ::Orientation::create ("PinocOrientation", rp, eeP1, tIdP),
+        "Orientation");
+  compare_timing (rm, rp,
+        _c::Transformation::create ("ModelTransformation", rm, eeM1, tIdM),
+        c ::Transformation::create ("PinocTransformation", rp, eeP1, tIdP),
+        "Transformation");
+  compare_timing (rm, rp,
+        _c::RelativeTransformation::create ("ModelRelativeTransformation", rm, eeM1, eeM2, tIdM, tIdM),
+        c ::RelativeTransformation::create ("PinocRelativeTransformation", rp, eeP1, eeP2, tIdP, tIdP),
+        "RelativeTransformation");
+
+  _c::CenterOfMassComputationPtr_t comM = _c::CenterOfMassComputation::create(rm);
+  c ::CenterOfMassComputationPtr_t comP = c ::CenterOfMassComputation::create(rp);
+  comM->add(rm->rootJoint());
+  comP->add(rp->rootJoint());
+  comM->computeMass();
+  compare_timing (rm, rp,
+        _c::RelativeCom::create (rm, comM, eeMR, _c::vector3_t (0, 0, 0)),
+        c ::RelativeCom::create (rp, comP, eePR, c ::vector3_t (0, 0, 0)),
+        "RelativeCom");
+  compare_timing (rm, rp,
+        _c::ComBetweenFeet::create ("ModelComBetweenFeet", rm, eeML, eeMR, tIdM.getTranslation(), tIdM.getTranslation(), eeMR, tIdM.getTranslation()),
+        c ::ComBetweenFeet::create ("PinocComBetweenFeet", rp, eePL, eePR, tIdP.translation()   , tIdP.translation()   , eePR, tIdP.translation()),
+        "ComBetweenFeet");
+
+  compare_timing (rm, rp,
+        _c::DistanceBetweenBodies::create ("ModelDistanceBetweenBodies", rm, eeMR, eeML),
+        c ::DistanceBetweenBodies::create ("PinocDistanceBetweenBodies", rp, eePR, eePL),
+        "DistanceBetweenBodies");
+
+  _c::Configuration_t goalM = rm->neutralConfiguration();
+  c ::Configuration_t goalP = m2p::q(goalM);
+  compare_timing (rm, rp,
+        _c::ConfigurationConstraint::create ("Model ConfigurationConstraint", rm, goalM),
+        c ::ConfigurationConstraint::create ("Pinoc ConfigurationConstraint", rp, goalP),
+        "ConfigurationConstraint");
+}
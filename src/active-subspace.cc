@@ -0,0 +1,96 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/active-subspace.hh>
+
+#include <stdexcept>
+
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/model-metadata.hh>
+
+namespace hpp {
+  namespace constraints {
+    ActiveSubspace::ActiveSubspace (size_type size) :
+      support_ (ArrayXb::Constant (size, true))
+    {
+      computeColumns ();
+    }
+
+    ActiveSubspace::ActiveSubspace (const ArrayXb& columns) :
+      support_ (columns)
+    {
+      computeColumns ();
+    }
+
+    ActiveSubspace::ActiveSubspace (const matrix_t& selection) :
+      support_ ((selection.array () != 0).rowwise ().any ()),
+      selection_ (selection)
+    {
+      if (selection_.size () == 0)
+        throw std::invalid_argument ("The selection matrix is empty.");
+    }
+
+    void ActiveSubspace::lock (const JointConstPtr_t& joint)
+    {
+      if (!isSelection ())
+        throw std::logic_error ("Only the joints of a selection of columns "
+            "can be locked.");
+      const ModelMetadata::Range_t& range =
+        ModelMetadata::get (joint->robot ())->velocityRange (joint->index ());
+      assert (range.second <= size ());
+      support_.segment (range.first, range.second - range.first)
+        .setConstant (false);
+      computeColumns ();
+    }
+
+    void ActiveSubspace::reduce (matrixIn_t jacobian, matrixOut_t reduced)
+      const
+    {
+      assert (jacobian.cols () == size ());
+      assert (reduced.rows () == jacobian.rows ());
+      assert (reduced.cols () == dimension ());
+      if (isSelection ()) {
+        for (std::size_t k = 0; k < columns_.size (); ++k)
+          reduced.col (k) = jacobian.col (columns_[k]);
+      } else {
+        reduced.noalias () = jacobian * selection_;
+      }
+    }
+
+    void ActiveSubspace::expand (vectorIn_t reducedVelocity,
+        vectorOut_t velocity) const
+    {
+      assert (reducedVelocity.size () == dimension ());
+      assert (velocity.size () == size ());
+      if (isSelection ()) {
+        velocity.setZero ();
+        for (std::size_t k = 0; k < columns_.size (); ++k)
+          velocity[columns_[k]] = reducedVelocity[k];
+      } else {
+        velocity.noalias () = selection_ * reducedVelocity;
+      }
+    }
+
+    void ActiveSubspace::computeColumns ()
+    {
+      columns_.clear ();
+      for (size_type i = 0; i < support_.size (); ++i)
+        if (support_[i]) columns_.push_back (i);
+    }
+  } // namespace constraints
+} // namespace hpp
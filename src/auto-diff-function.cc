@@ -0,0 +1,70 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/auto-diff-function.hh>
+
+#include <cmath>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/liegroup.hh>
+
+namespace hpp {
+  namespace constraints {
+    void integrateJacobian (const DevicePtr_t& robot, ConfigurationIn_t q,
+        matrixOut_t jacobian)
+    {
+      jacobian.setZero ();
+      if (!robot) {
+        assert (jacobian.rows () == jacobian.cols ());
+        jacobian.setIdentity ();
+        return;
+      }
+      const se3::Model& model = robot->model ();
+      const value_type eps = std::pow
+        (Eigen::NumTraits <value_type>::epsilon (), 1. / 3);
+      vector_t v, qp, qm;
+      for (std::size_t j = 1; j < model.joints.size (); ++j) {
+        const se3::JointModel& joint = model.joints[j];
+        const size_type iq = joint.idx_q (), iv = joint.idx_v ();
+        if (joint.nq () == joint.nv ()) {
+          jacobian.block (iq, iv, joint.nq (), joint.nv ()).setIdentity ();
+          continue;
+        }
+        // The Lie group operation of a single joint is not available:
+        // integrate the whole robot and keep only this joint.
+        using hpp::pinocchio::LieGroupTpl;
+        v.setZero (robot->numberDof ());
+        qp.resize (q.size ());
+        qm.resize (q.size ());
+        for (int k = 0; k < joint.nv (); ++k) {
+          v [iv + k] = eps;
+          hpp::pinocchio::integrate<false, LieGroupTpl> (robot, q, v, qp);
+          v [iv + k] = - eps;
+          hpp::pinocchio::integrate<false, LieGroupTpl> (robot, q, v, qm);
+          v [iv + k] = 0;
+          jacobian.block (iq, iv + k, joint.nq (), 1) =
+            (qp.segment (iq, joint.nq ()) - qm.segment (iq, joint.nq ()))
+            / (2 * eps);
+        }
+      }
+      // Extra configuration space.
+      const size_type extra = robot->extraConfigSpace ().dimension ();
+      jacobian.bottomRightCorner (extra, extra).setIdentity ();
+    }
+  } // namespace constraints
+} // namespace hpp
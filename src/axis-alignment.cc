@@ -0,0 +1,128 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/axis-alignment.hh>
+
+#include <stdexcept>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/lipschitz.hh>
+#include <hpp/constraints/relative-kinematics.hh>
+
+namespace hpp {
+  namespace constraints {
+    AxisAlignmentPtr_t AxisAlignment::create
+    (const std::string& name, const DevicePtr_t& robot,
+     const JointPtr_t& joint1, const vector3_t& axis1,
+     const JointPtr_t& joint2, const vector3_t& axis2, Mode_t mode)
+    {
+      AxisAlignment* ptr = new AxisAlignment
+	(name, robot, joint1, axis1, joint2, axis2, mode);
+      AxisAlignmentPtr_t shPtr (ptr);
+      return shPtr;
+    }
+
+    AxisAlignment::AxisAlignment
+    (const std::string& name, const DevicePtr_t& robot,
+     const JointPtr_t& joint1, const vector3_t& axis1,
+     const JointPtr_t& joint2, const vector3_t& axis2, Mode_t mode) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (),
+                              mode == PARALLEL ? 2 : 1, name),
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)),
+      joint1_ (joint1), joint2_ (joint2), axis1_ (axis1), axis2_ (axis2),
+      mode_ (mode)
+    {
+      if (!joint2)
+        throw std::invalid_argument ("AxisAlignment: joint2 may not be NULL");
+      if (axis1.norm () == 0 || axis2.norm () == 0)
+        throw std::invalid_argument ("AxisAlignment: null axis");
+      axis1_.normalize ();
+      axis2_.normalize ();
+      if (mode_ == PARALLEL) {
+        local_.col (0) = axis1_.unitOrthogonal ();
+        local_.col (1) = axis1_.cross (local_.col (0));
+      } else local_.col (0) = axis1_;
+
+      activeDerivativeColumns_.setConstant (false);
+      activateRelativeColumns (joint1_, joint2_);
+      size_type begin = 0, end = robot->numberDof ();
+      while (begin < end && !activeDerivativeColumns_[begin]) ++begin;
+      while (end > begin && !activeDerivativeColumns_[end - 1]) --end;
+      colBegin_ = begin;
+      activeCols_ = end - begin;
+      KinematicsCache::addJoint (joints_, joint1_);
+      KinematicsCache::addJoint (joints_, joint2_);
+      relative_ = RelativeKinematics::get (kinematics_, joint1_, joint2_,
+          colBegin_, activeCols_);
+      // Axis fixed in the world frame.
+      if (!joint1_) w_ = local_;
+    }
+
+    void AxisAlignment::computeAxes () const
+    {
+      if (joint1_) w_.noalias () =
+        joint1_->currentTransformation ().rotation () * local_;
+      u2_.noalias () = joint2_->currentTransformation ().rotation () * axis2_;
+    }
+
+    void AxisAlignment::computeValue (vectorOut_t result) const
+    {
+      result.noalias () =
+        w_.leftCols (outputSize ()).transpose () * u2_;
+    }
+
+    void AxisAlignment::impl_compute
+    (vectorOut_t result, ConfigurationIn_t argument) const throw ()
+    {
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS, joints_);
+      computeAxes ();
+      computeValue (result);
+    }
+
+    void AxisAlignment::impl_jacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS, joints_);
+      computeAxes ();
+      // d/dt (w^T u2) = (w x u2)^T (omega1 - omega2)
+      const RelativeKinematics::Jacobian_t& W (relative_->rotation ());
+      for (size_type k = 0; k < outputSize (); ++k)
+        jacobian.row (k).segment (colBegin_, activeCols_).noalias () =
+          w_.col (k).cross (u2_).transpose () * W;
+      jacobian.leftCols (colBegin_).setZero ();
+      jacobian.rightCols (jacobian.cols () - colBegin_ - activeCols_)
+        .setZero ();
+    }
+
+    void AxisAlignment::impl_valueAndJacobian
+    (vectorOut_t result, matrixOut_t jacobian, ConfigurationIn_t arg) const
+    {
+      impl_jacobian (jacobian, arg);
+      computeValue (result);
+    }
+
+    value_type AxisAlignment::lipschitzConstant () const
+    {
+      // The norm of the value is the sine or the cosine of the angle
+      // between the axes.
+      return relativeVelocityBounds (robot_, joint1_ ? joint1_->index () : 0,
+          joint2_->index (), 0).angular;
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,183 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/batch-evaluator.hh>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include <hpp/constraints/differentiable-function.hh>
+#include <hpp/constraints/workspace.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      inline std::size_t threadId ()
+      {
+#ifdef _OPENMP
+        return (std::size_t) omp_get_thread_num ();
+#else
+        return 0;
+#endif
+      }
+
+      struct MoreExpensive
+      {
+        MoreExpensive (const BatchEvaluator::Functions_t& f) : functions (f) {}
+        bool operator() (std::size_t i, std::size_t j) const
+        {
+          return functions[i]->evaluationCost ()
+            > functions[j]->evaluationCost ();
+        }
+        const BatchEvaluator::Functions_t& functions;
+      };
+
+      /// Number of configurations of a job of the given cost per
+      /// configuration, between 1 and nbConfigs.
+      inline size_type chunkSize (value_type jobCost, value_type cost,
+          size_type nbConfigs)
+      {
+        if (cost * (value_type) nbConfigs <= jobCost)
+          return std::max (nbConfigs, (size_type) 1);
+        return std::max ((size_type) std::floor (jobCost / cost),
+            (size_type) 1);
+      }
+    } // namespace
+
+    BatchEvaluatorPtr_t BatchEvaluator::create (const DevicePtr_t& robot,
+        std::size_t nbThreads)
+    {
+      return BatchEvaluatorPtr_t (new BatchEvaluator (robot, nbThreads));
+    }
+
+    BatchEvaluator::BatchEvaluator (const DevicePtr_t& robot,
+        std::size_t nbThreads) :
+      workspaces_ (std::max (nbThreads, (std::size_t) 1)), jobCost_ (50)
+    {
+      for (std::size_t i = 0; i < workspaces_.size (); ++i)
+        workspaces_[i] = Workspace::create (robot);
+    }
+
+    void BatchEvaluator::computeJobs (const Functions_t& functions,
+        size_type nbConfigs)
+    {
+      std::vector <std::size_t> cheap, expensive, sequential;
+      value_type cheapCost = 0;
+      for (std::size_t i = 0; i < functions.size (); ++i) {
+        const value_type cost = functions[i]->evaluationCost ();
+        if (!functions[i]->threadSafe ()) sequential.push_back (i);
+        else if (cost > jobCost_) expensive.push_back (i);
+        else {
+          cheap.push_back (i);
+          cheapCost += cost;
+        }
+      }
+      std::stable_sort (expensive.begin (), expensive.end (),
+          MoreExpensive (functions));
+      order_.clear ();
+      order_.insert (order_.end (), expensive.begin (), expensive.end ());
+      order_.insert (order_.end (), cheap.begin (), cheap.end ());
+      order_.insert (order_.end (), sequential.begin (), sequential.end ());
+
+      jobs_.clear ();
+      Job job;
+      job.parallel = true;
+      // The most expensive jobs first.
+      for (std::size_t k = 0; k < expensive.size (); ++k) {
+        const size_type chunk = chunkSize (jobCost_,
+            functions[expensive[k]]->evaluationCost (), nbConfigs);
+        job.begin = k;
+        job.end = k + 1;
+        for (job.first = 0; job.first < nbConfigs; job.first += chunk) {
+          job.count = std::min (chunk, nbConfigs - job.first);
+          jobs_.push_back (job);
+        }
+      }
+      if (!cheap.empty ()) {
+        const size_type chunk = chunkSize (jobCost_, cheapCost, nbConfigs);
+        job.begin = expensive.size ();
+        job.end = job.begin + cheap.size ();
+        for (job.first = 0; job.first < nbConfigs; job.first += chunk) {
+          job.count = std::min (chunk, nbConfigs - job.first);
+          jobs_.push_back (job);
+        }
+      }
+      if (!sequential.empty () && nbConfigs > 0) {
+        job.begin = expensive.size () + cheap.size ();
+        job.end = order_.size ();
+        job.first = 0;
+        job.count = nbConfigs;
+        job.parallel = false;
+        jobs_.push_back (job);
+      }
+    }
+
+    void BatchEvaluator::evaluate (const Functions_t& functions,
+        matrixIn_t configurations, std::vector <matrix_t>& values,
+        std::vector <matrix_t>* jacobians)
+    {
+      const size_type N = configurations.cols ();
+      values.resize (functions.size ());
+      if (jacobians) jacobians->resize (functions.size ());
+      for (std::size_t i = 0; i < functions.size (); ++i) {
+        const DifferentiableFunction& f = *functions[i];
+        assert (configurations.rows () == f.inputSize ());
+        values[i].resize (f.outputSize (), N);
+        if (jacobians)
+          (*jacobians)[i].resize (f.outputDerivativeSize (),
+              N * f.inputDerivativeSize ());
+      }
+      computeJobs (functions, N);
+
+      const int nbJobs = (int) jobs_.size ();
+#pragma omp parallel num_threads(workspaces_.size ())
+#pragma omp single
+      for (int j = 0; j < nbJobs; ++j) {
+#pragma omp task
+        run (jobs_[j], functions, configurations, values, jacobians,
+            jobs_[j].parallel ? workspaces_[threadId ()].get () : NULL);
+      }
+    }
+
+    void BatchEvaluator::run (const Job& job, const Functions_t& functions,
+        matrixIn_t configurations, std::vector <matrix_t>& values,
+        std::vector <matrix_t>* jacobians, Workspace* workspace) const
+    {
+      // All the functions at a configuration, so that they share the
+      // forward kinematics of the workspace.
+      for (size_type c = job.first; c < job.first + job.count; ++c) {
+        for (std::size_t k = job.begin; k < job.end; ++k) {
+          const std::size_t i = order_[k];
+          const DifferentiableFunction& f = *functions[i];
+          if (workspace) f (values[i].col (c), configurations.col (c),
+              *workspace);
+          else           f (values[i].col (c), configurations.col (c));
+          if (!jacobians) continue;
+          const size_type nv = f.inputDerivativeSize ();
+          if (workspace) f.jacobian ((*jacobians)[i].middleCols (c * nv, nv),
+              configurations.col (c), *workspace);
+          else           f.jacobian ((*jacobians)[i].middleCols (c * nv, nv),
+              configurations.col (c));
+        }
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,55 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/bounding-spheres.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace hpp {
+  namespace constraints {
+    void coverWithSpheres (fcl::CollisionGeometry& geometry,
+        const Transform3f& placement, BoundingSpheres_t& spheres)
+    {
+      // Number of spheres along the largest extent of a box.
+      const value_type maxSpheres = 16;
+      geometry.computeLocalAABB ();
+      vector3_t lower, extent;
+      for (int j = 0; j < 3; ++j) {
+        lower [j] = geometry.aabb_local.min_ [j];
+        extent [j] = geometry.aabb_local.max_ [j] - geometry.aabb_local.min_ [j];
+      }
+      int axis;
+      const value_type length = extent.maxCoeff (&axis);
+      value_type width = 0;
+      for (int j = 0; j < 3; ++j)
+        if (j != axis) width = std::max (width, extent [j]);
+      const std::size_t n = (std::size_t) std::max ((value_type) 1,
+          std::ceil (length / std::max (width, length / maxSpheres)));
+      vector3_t piece (extent);
+      piece [axis] = length / (value_type) n;
+      BoundingSphere s;
+      s.radius = piece.norm () / 2;
+      for (std::size_t i = 0; i < n; ++i) {
+        vector3_t center (lower + extent / 2);
+        center [axis] = lower [axis] + ((value_type) i + .5) * piece [axis];
+        s.center = placement.act (center);
+        spheres.push_back (s);
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
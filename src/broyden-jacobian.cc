@@ -0,0 +1,123 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/broyden-jacobian.hh>
+
+#include <stdexcept>
+
+#include <hpp/pinocchio/configuration.hh>
+
+namespace hpp {
+  namespace constraints {
+    BroydenJacobianPtr_t BroydenJacobian::create
+    (const DifferentiableFunctionPtr_t& function, const DevicePtr_t& robot)
+    {
+      return BroydenJacobianPtr_t (new BroydenJacobian (function, robot));
+    }
+
+    BroydenJacobian::BroydenJacobian
+    (const DifferentiableFunctionPtr_t& function, const DevicePtr_t& robot) :
+      DifferentiableFunction (function->inputSize (),
+          function->inputDerivativeSize (), function->outputSize (),
+          function->outputDerivativeSize (), function->name ()),
+      function_ (function), robot_ (robot), maxUpdates_ (10),
+      refreshRatio_ (1), valid_ (false), updates_ (0),
+      nbExactJacobians_ (0), nbBroydenUpdates_ (0)
+    {
+      if (function->outputSize () != function->outputDerivativeSize ())
+        throw std::invalid_argument
+          ("BroydenJacobian: the value of the function must be a vector.");
+      activeDerivativeColumns_ = function->activeDerivativeColumns ();
+    }
+
+    std::ostream& BroydenJacobian::print (std::ostream& o) const
+    {
+      o << "Broyden jacobian of ";
+      return function_->print (o);
+    }
+
+    void BroydenJacobian::impl_compute (vectorOut_t result,
+        vectorIn_t argument) const
+    {
+      (*function_) (result, argument);
+    }
+
+    void BroydenJacobian::impl_jacobian (matrixOut_t jacobian,
+        vectorIn_t argument) const
+    {
+      if (!valid_ || updates_ >= maxUpdates_) {
+        value_.resize (outputSize_);
+        jacobian_.resize (outputDerivativeSize_, inputDerivativeSize_);
+        function_->valueAndJacobian (value_, jacobian_, argument);
+        argument_ = argument;
+        valid_ = true;
+        updates_ = 0;
+        ++nbExactJacobians_;
+      } else {
+        current_.resize (outputSize_);
+        (*function_) (current_, argument);
+        update (current_, argument);
+      }
+      jacobian = jacobian_;
+    }
+
+    void BroydenJacobian::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, vectorIn_t argument) const
+    {
+      if (!valid_ || updates_ >= maxUpdates_) {
+        impl_jacobian (jacobian, argument);
+        result = value_;
+        return;
+      }
+      (*function_) (result, argument);
+      update (result, argument);
+      jacobian = jacobian_;
+    }
+
+    void BroydenJacobian::update (vectorIn_t value,
+        vectorIn_t argument) const
+    {
+      if (value.norm () > refreshRatio_ * value_.norm ()) {
+        jacobian_.resize (outputDerivativeSize_, inputDerivativeSize_);
+        function_->jacobian (jacobian_, argument);
+        updates_ = 0;
+        ++nbExactJacobians_;
+      } else {
+        step_.resize (inputDerivativeSize_);
+        if (robot_)
+          hpp::pinocchio::difference (robot_, argument, argument_, step_);
+        else {
+          assert (inputSize_ == inputDerivativeSize_);
+          step_ = argument - argument_;
+        }
+        // Keep the structural zeros of the jacobian.
+        for (size_type i = 0; i < inputDerivativeSize_; ++i)
+          if (!activeDerivativeColumns_[i]) step_[i] = 0;
+        const value_type squaredNorm = step_.squaredNorm ();
+        if (squaredNorm > 0) {
+          variation_ = value - value_;
+          variation_.noalias () -= jacobian_ * step_;
+          jacobian_.noalias () += (variation_ / squaredNorm)
+            * step_.transpose ();
+        }
+        ++updates_;
+        ++nbBroydenUpdates_;
+      }
+      argument_ = argument;
+      value_ = value;
+    }
+  } // namespace constraints
+} // namespace hpp
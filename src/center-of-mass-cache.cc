@@ -0,0 +1,124 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/center-of-mass-cache.hh>
+
+#include <algorithm>
+#include <limits>
+
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/model-metadata.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Remove the instances that are not used anymore.
+      template <typename Map_t> void removeExpired (Map_t& c)
+      {
+        for (typename Map_t::iterator _c = c.begin (); _c != c.end ();) {
+          if (_c->second.expired ()) c.erase (_c++);
+          else ++_c;
+        }
+      }
+    } // namespace
+
+    CenterOfMassCachePtr_t CenterOfMassCache::get
+    (const KinematicsCachePtr_t& kinematics)
+    {
+      assert (kinematics);
+      JointVector_t roots;
+      roots.push_back (kinematics->robot ()->rootJoint ());
+      return get (kinematics, roots);
+    }
+
+    CenterOfMassCachePtr_t CenterOfMassCache::get
+    (const KinematicsCachePtr_t& kinematics, const JointVector_t& roots)
+    {
+      assert (kinematics);
+      KinematicsCache::CenterOfMassMap_t& c = kinematics->centersOfMass_;
+      KinematicsCache::CenterOfMassMap_t::key_type key (roots.size ());
+      for (std::size_t i = 0; i < roots.size (); ++i)
+        key [i] = roots [i]->index ();
+      std::sort (key.begin (), key.end ());
+      KinematicsCache::CenterOfMassMap_t::iterator _c = c.find (key);
+      if (_c != c.end ()) {
+        CenterOfMassCachePtr_t com = _c->second.lock ();
+        if (com) return com;
+      }
+      CenterOfMassComputationPtr_t comc =
+        CenterOfMassComputation::create (kinematics->robot ());
+      for (std::size_t i = 0; i < roots.size (); ++i) comc->add (roots [i]);
+      CenterOfMassCachePtr_t com
+        (new CenterOfMassCache (kinematics, comc, roots));
+      c[key] = com;
+      removeExpired (c);
+      // Functions given the computation of this instance share it too.
+      kinematics->computations_[comc.get ()] = com;
+      removeExpired (kinematics->computations_);
+      return com;
+    }
+
+    CenterOfMassCachePtr_t CenterOfMassCache::get
+    (const KinematicsCachePtr_t& kinematics,
+     const CenterOfMassComputationPtr_t& comc)
+    {
+      assert (kinematics && comc);
+      KinematicsCache::ComputationMap_t& c = kinematics->computations_;
+      KinematicsCache::ComputationMap_t::iterator _c = c.find (comc.get ());
+      if (_c != c.end ()) {
+        CenterOfMassCachePtr_t com = _c->second.lock ();
+        // The address may have been reused by another computation.
+        if (com && com->comc_ == comc) return com;
+      }
+      CenterOfMassCachePtr_t com
+        (new CenterOfMassCache (kinematics, comc, JointVector_t ()));
+      c[comc.get ()] = com;
+      removeExpired (c);
+      return com;
+    }
+
+    CenterOfMassCache::CenterOfMassCache
+    (const KinematicsCachePtr_t& kinematics,
+     const CenterOfMassComputationPtr_t& comc, const JointVector_t& roots) :
+      kinematics_ (kinematics), comc_ (comc),
+      version_ (std::numeric_limits<std::size_t>::max ()), flag_ (0)
+    {
+      const DevicePtr_t robot = kinematics->robot ();
+      const size_type nv = robot->numberDof ()
+        - robot->extraConfigSpace ().dimension ();
+      activeDerivativeColumns_.setConstant (robot->numberDof (), false);
+      if (roots.empty ()) {
+        activeDerivativeColumns_.head (nv).setConstant (true);
+        return;
+      }
+      const ModelMetadataConstPtr_t metadata (ModelMetadata::get (robot));
+      for (std::size_t i = 0; i < roots.size (); ++i) {
+        // Ancestors of the root move the whole subtree.
+        const se3::JointIndex root = roots [i]->index ();
+        const ArrayXb& support = metadata->support (root);
+        activeDerivativeColumns_.head (nv) =
+          activeDerivativeColumns_.head (nv) || support;
+        const ModelMetadata::Range_t& subtree
+          (metadata->subtreeColumns (root));
+        activeDerivativeColumns_.segment
+          (subtree.first, subtree.second - subtree.first).setConstant (true);
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
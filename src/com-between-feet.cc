@@ -24,6 +24,9 @@
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/center-of-mass-computation.hh>
 
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/center-of-mass-cache.hh>
+
 namespace hpp {
   namespace constraints {
     namespace {
@@ -45,10 +48,9 @@ namespace hpp {
         const JointPtr_t& jointRef, const vector3_t pointRef,
         std::vector <bool> mask)
     {
-      CenterOfMassComputationPtr_t comc =
-        CenterOfMassComputation::create (robot);
-      comc->add (robot->rootJoint ());
-      return create (name, robot, comc, jointL, jointR,
+      CenterOfMassCachePtr_t com =
+        CenterOfMassCache::get (KinematicsCache::get (robot));
+      return create (name, robot, com->computation (), jointL, jointR,
           pointL, pointR, jointRef, pointRef, mask);
     }
 
@@ -76,50 +78,52 @@ namespace hpp {
         std::vector <bool> mask) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (),
           size (mask), name),
-      robot_ (robot),
-      com_ (PointCom::create (comc)),
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)),
+      com_ (PointCom::create (CenterOfMassCache::get (kinematics_, comc))),
       left_ (PointInJoint::create(jointL, pointL)),
       right_ (PointInJoint::create(jointR, pointR)),
       pointRef_ (),
       jointRef_ (jointRef),
+      expr_ (JointTranspose (jointRef) *
+          ((fused::PointCom (CenterOfMassCache::get (kinematics_, comc))
+            - 0.5 * (fused::PointInJoint (jointL, pointL)
+                   + fused::PointInJoint (jointR, pointR)))
+           ^ (fused::PointInJoint (jointR, pointR)
+            - fused::PointInJoint (jointL, pointL)))),
       mask_ (mask)
     {
       cross_.setZero ();
       u_ = right_ - left_;
       xmxl_ = com_ - left_;
       xmxr_ = com_ - right_;
-      ecrossu_ = (com_ - (0.5 * (left_ + right_)))^(u_);
-      // expr_ = RotationMultiply <ECrossU_t> (jointRef_, ecrossu_, true);
-      expr_ = JointTranspose (jointRef_) * ecrossu_;
       xmxlDotu_ = xmxl_ * u_;
       xmxrDotu_ = xmxr_ * u_;
       for (int i=0; i<3; i++) pointRef_[i] = pointRef[i];
+      graph_.add (com_);
+      graph_.add (xmxlDotu_);
+      graph_.add (xmxrDotu_);
     }
 
     void ComBetweenFeet::impl_compute (vectorOut_t result,
         ConfigurationIn_t argument)
       const throw ()
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
+      graph_.update (kinematics_->version ());
       size_t index = 0;
       if (mask_[0]) {
-        com_->invalidate ();
         com_->computeValue ();
         result[index++] = (com_->value () - pointRef_)[2];
       }
       if (mask_[1]) {
-        expr_->invalidate ();
-        expr_->computeValue ();
-        result[index++] = expr_->value ()[2];
+        expr_.compute (false);
+        result[index++] = expr_.value ()[2];
       }
       if (mask_[2]) {
-        xmxlDotu_->invalidate ();
         xmxlDotu_->computeValue ();
         result[index++] =   xmxlDotu_->value();
       }
       if (mask_[3]) {
-        xmxrDotu_->invalidate ();
         xmxrDotu_->computeValue ();
         result[index  ] =   xmxrDotu_->value();
       }
@@ -128,33 +132,64 @@ namespace hpp {
     void ComBetweenFeet::impl_jacobian (matrixOut_t jacobian,
         ConfigurationIn_t arg) const throw ()
     {
-      robot_->currentConfiguration (arg);
-      robot_->computeForwardKinematics ();
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      graph_.update (kinematics_->version ());
       size_t index = 0;
       if (mask_[0]) {
-        com_->invalidate ();
         com_->computeJacobian ();
         jacobian.row (index++).leftCols (jointRef_->jacobian ().cols ())
           = com_->jacobian ().row (2);
       }
       if (mask_[1]) {
-        expr_->invalidate ();
-        expr_->computeJacobian ();
-        jacobian.row (index++).leftCols (jointRef_->jacobian ().cols ())
-          = expr_->jacobian ().row (2);
+        expr_.compute (true);
+        matrixOut_t row (jacobian.middleRows (index++, 1));
+        row.setZero ();
+        expr_.addJacobian (Eigen::Matrix<value_type, 1, 3> (0, 0, 1), row);
       }
       if (mask_[2]) {
-        xmxlDotu_->invalidate ();
         xmxlDotu_->computeJacobian ();
         jacobian.row (index++).leftCols (jointRef_->jacobian ().cols ())
           = xmxlDotu_->jacobian ();
       }
       if (mask_[3]) {
-        xmxrDotu_->invalidate ();
         xmxrDotu_->computeJacobian ();
         jacobian.row (index  ).leftCols (jointRef_->jacobian ().cols ())
           = xmxrDotu_->jacobian ();
       }
     }
+
+    void ComBetweenFeet::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      graph_.update (kinematics_->version ());
+      const size_type nCols = jointRef_->jacobian ().cols ();
+      size_t index = 0;
+      if (mask_[0]) {
+        com_->computeValue ();
+        com_->computeJacobian ();
+        result[index] = (com_->value () - pointRef_)[2];
+        jacobian.row (index++).leftCols (nCols) = com_->jacobian ().row (2);
+      }
+      if (mask_[1]) {
+        expr_.compute (true);
+        result[index] = expr_.value ()[2];
+        matrixOut_t row (jacobian.middleRows (index++, 1));
+        row.setZero ();
+        expr_.addJacobian (Eigen::Matrix<value_type, 1, 3> (0, 0, 1), row);
+      }
+      if (mask_[2]) {
+        xmxlDotu_->computeValue ();
+        xmxlDotu_->computeJacobian ();
+        result[index] = xmxlDotu_->value();
+        jacobian.row (index++).leftCols (nCols) = xmxlDotu_->jacobian ();
+      }
+      if (mask_[3]) {
+        xmxrDotu_->computeValue ();
+        xmxrDotu_->computeJacobian ();
+        result[index] = xmxrDotu_->value();
+        jacobian.row (index  ).leftCols (nCols) = xmxrDotu_->jacobian ();
+      }
+    }
   } // namespace _constraints
 } // namespace hpp
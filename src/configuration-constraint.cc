@@ -16,11 +16,15 @@
 
 #include <hpp/constraints/configuration-constraint.hh>
 
+#include <pinocchio/multibody/model.hpp>
+
 #include <hpp/util/debug.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/configuration.hh>
 
+#include <hpp/constraints/workspace.hh>
+
 namespace hpp {
   namespace constraints {
     ConfigurationConstraintPtr_t ConfigurationConstraint::create (
@@ -32,35 +36,189 @@ namespace hpp {
       return ConfigurationConstraintPtr_t (ptr);
     }
 
+    ConfigurationConstraintPtr_t ConfigurationConstraint::create (
+        const std::string& name, const DevicePtr_t& robot,
+        ConfigurationIn_t goal, const vector_t& weights)
+    {
+      ConfigurationConstraint* ptr = new ConfigurationConstraint
+        (name, robot, goal, weights);
+      return ConfigurationConstraintPtr_t (ptr);
+    }
+
     ConfigurationConstraint::ConfigurationConstraint (
         const std::string& name, const DevicePtr_t& robot,
         ConfigurationIn_t goal, std::vector <bool> mask) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (),
           1, name),
-      robot_ (robot), goal_ (goal), diff_ (robot->numberDof())
+      robot_ (robot), goal_ (goal),
+      weights_ (vector_t::Ones (robot->numberDof ())),
+      diff_ (robot->numberDof())
     {
-      mask_ = EigenBoolVector_t (robot->numberDof ());
       for (std::size_t i = 0; i < mask.size (); ++i) {
-        mask_[i] = mask[i];
+        if (!mask[i]) weights_[i] = 0;
+      }
+      init ();
+    }
+
+    ConfigurationConstraint::ConfigurationConstraint (
+        const std::string& name, const DevicePtr_t& robot,
+        ConfigurationIn_t goal, const vector_t& weights) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (),
+          1, name),
+      robot_ (robot), goal_ (goal), weights_ (weights),
+      diff_ (robot->numberDof())
+    {
+      assert (weights.size () == robot->numberDof ());
+      init ();
+    }
+
+    void ConfigurationConstraint::init ()
+    {
+      const se3::Model& model = robot_->model ();
+      ranges_.clear ();
+      lieGroup_ = false;
+      for (std::size_t i = 1; i < model.joints.size (); ++i) {
+        const se3::JointModel& jmodel = model.joints[i];
+        JointRange r;
+        r.iq = jmodel.idx_q (); r.iv = jmodel.idx_v ();
+        r.nq = jmodel.nq ()   ; r.nv = jmodel.nv ();
+        if (r.nv == 0 || (weights_.segment (r.iv, r.nv).array () == 0).all ())
+          continue;
+        if (r.nq != r.nv) lieGroup_ = true;
+        ranges_.push_back (r);
+      }
+      // The extra config space is a vector space.
+      const size_type ecs = robot_->extraConfigSpace ().dimension ();
+      if (ecs > 0 && !(weights_.tail (ecs).array () == 0).all ()) {
+        JointRange r;
+        r.iq = robot_->configSize () - ecs; r.iv = robot_->numberDof () - ecs;
+        r.nq = ecs                        ; r.nv = ecs;
+        ranges_.push_back (r);
+      }
+      activeDerivativeColumns_ = (weights_.array () != 0);
+    }
+
+    void ConfigurationConstraint::difference (ConfigurationIn_t q,
+        vector_t& d) const
+    {
+      // Joints that are not vector spaces need the Lie group difference.
+      if (lieGroup_) {
+        hpp::pinocchio::difference (robot_, q, goal_, d);
+        return;
+      }
+      for (std::size_t i = 0; i < ranges_.size (); ++i) {
+        const JointRange& r = ranges_[i];
+        d.segment (r.iv, r.nv) = q.segment (r.iq, r.nq)
+          - goal_.segment (r.iq, r.nq);
+      }
+    }
+
+    value_type ConfigurationConstraint::value (const vector_t& d) const
+    {
+      value_type res = 0;
+      for (std::size_t i = 0; i < ranges_.size (); ++i) {
+        const JointRange& r = ranges_[i];
+        res += (weights_.segment (r.iv, r.nv).array ()
+            * d.segment (r.iv, r.nv).array ().square ()).sum ();
+      }
+      return 0.5 * res;
+    }
+
+    void ConfigurationConstraint::jacobian (const vector_t& d,
+        matrixOut_t jacobian) const
+    {
+      jacobian.setZero ();
+      for (std::size_t i = 0; i < ranges_.size (); ++i) {
+        const JointRange& r = ranges_[i];
+        jacobian.row (0).segment (r.iv, r.nv) =
+          (weights_.segment (r.iv, r.nv).array ()
+           * d.segment (r.iv, r.nv).array ()).matrix ().transpose ();
       }
-      mask_.tail (robot->numberDof () - mask.size ()).setConstant (true);
     }
 
     void ConfigurationConstraint::impl_compute (vectorOut_t result,
         ConfigurationIn_t argument)
       const throw ()
     {
-      // TODO: Add ability to put weights on DOF
-      hpp::pinocchio::difference (robot_, argument, goal_, diff_);
-      result [0] = 0.5 * mask_.select (diff_, 0).squaredNorm ();
+      difference (argument, diff_);
+      result [0] = value (diff_);
     }
 
     void ConfigurationConstraint::impl_jacobian (matrixOut_t jacobian,
         ConfigurationIn_t argument) const throw ()
     {
-      hpp::pinocchio::difference (robot_, argument, goal_, diff_);
-      jacobian.leftCols (robot_->numberDof ()) =
-        mask_.select (diff_, 0).transpose ();
+      difference (argument, diff_);
+      this->jacobian (diff_, jacobian);
+    }
+
+    void ConfigurationConstraint::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, ConfigurationIn_t argument) const
+    {
+      difference (argument, diff_);
+      result [0] = value (diff_);
+      this->jacobian (diff_, jacobian);
+    }
+
+    void ConfigurationConstraint::goalJacobian (matrixOut_t jacobian,
+        ConfigurationIn_t argument) const
+    {
+      difference (argument, diff_);
+      this->jacobian (diff_, jacobian);
+      jacobian *= -1;
+    }
+
+    void ConfigurationConstraint::impl_valueBatch (matrixOut_t results,
+        matrixIn_t configurations) const
+    {
+      for (size_type i = 0; i < configurations.cols (); ++i) {
+        difference (configurations.col (i), diff_);
+        results (0, i) = value (diff_);
+      }
+    }
+
+    void ConfigurationConstraint::impl_jacobianBatch (matrixOut_t jacobians,
+        matrixIn_t configurations) const
+    {
+      const size_type nv = robot_->numberDof ();
+      for (size_type i = 0; i < configurations.cols (); ++i) {
+        difference (configurations.col (i), diff_);
+        // The jacobian of a scalar function is a row: write it directly
+        // in the contiguous output.
+        jacobian (diff_, jacobians.block (0, i * nv, 1, nv));
+      }
+    }
+
+    namespace {
+      struct ConfigurationConstraintData : Workspace::FunctionData
+      {
+        ConfigurationConstraintData (size_type nv) : diff (nv) {}
+        vector_t diff;
+      };
+    } // namespace
+
+    vector_t& ConfigurationConstraint::diff (Workspace& workspace) const
+    {
+      Workspace::FunctionDataPtr_t& data = workspace.data (*this);
+      if (!data)
+        data.reset (new ConfigurationConstraintData (robot_->numberDof ()));
+      return static_cast <ConfigurationConstraintData&> (*data).diff;
+    }
+
+    void ConfigurationConstraint::impl_compute (vectorOut_t result,
+        ConfigurationIn_t argument, Workspace& workspace)
+      const throw ()
+    {
+      vector_t& d = diff (workspace);
+      difference (argument, d);
+      result [0] = value (d);
+    }
+
+    void ConfigurationConstraint::impl_jacobian (matrixOut_t jacobian,
+        ConfigurationIn_t argument, Workspace& workspace) const throw ()
+    {
+      vector_t& d = diff (workspace);
+      difference (argument, d);
+      this->jacobian (d, jacobian);
     }
   } // namespace constraints
 } // namespace hpp
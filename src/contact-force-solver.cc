@@ -0,0 +1,178 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/contact-force-solver.hh>
+
+#include <limits>
+
+#include <Eigen/Householder>
+#include <Eigen/QR>
+
+namespace hpp {
+  namespace constraints {
+    bool NNLSContactForceSolver::solve (matrixIn_t A, vectorIn_t b)
+    {
+      nnls_.maxIterations (maxIterations_);
+      nnls_.tolerance (tolerance_);
+      bool warmStart = !reset_ && (nnls_.solution ().size () > 0);
+      bool optimal;
+      if (start_.size () == A.cols ()) {
+        optimal = nnls_.solve (A, b, start_);
+        warmStart = true;
+      } else
+        optimal = nnls_.solve (A, b, warmStart);
+      start_.resize (0);
+      solution_ = nnls_.solution ();
+      dual_ = nnls_.dual ();
+      residual_ = nnls_.residual ();
+      iterations_ = nnls_.iterations ();
+      warmStarted_ = optimal && warmStart && (solution_.size () == A.cols ());
+      reset_ = false;
+      return optimal;
+    }
+
+    void DualActiveSetContactForceSolver::warmStart (vectorIn_t solution)
+    {
+      active_.clear ();
+      for (size_type i = 0; i < solution.size () && active_.size () < 6; ++i)
+        if (solution [i] > 0) active_.push_back (i);
+      size_ = solution.size ();
+    }
+
+    void DualActiveSetContactForceSolver::decompose (matrixIn_t A)
+    {
+      const size_type q = (size_type) active_.size ();
+      normals_.resize (6, q);
+      if (q == 0) {
+        Q_.setIdentity ();
+        return;
+      }
+      for (size_type j = 0; j < q; ++j)
+        normals_.col (j) = A.col (active_ [(std::size_t) j]);
+      Eigen::HouseholderQR <Normals_t> qr (normals_);
+      Q_ = qr.householderQ ();
+      R_.topLeftCorner (q, q) =
+        qr.matrixQR ().topLeftCorner (q, q).triangularView <Eigen::Upper> ();
+    }
+
+    bool DualActiveSetContactForceSolver::solve (matrixIn_t A, vectorIn_t b)
+    {
+      assert (A.rows () == 6 && b.size () == 6);
+      const value_type inf = std::numeric_limits <value_type>::infinity ();
+      const size_type n = A.cols ();
+      if (size_ != n) {
+        active_.clear ();
+        size_ = n;
+      }
+      multipliers_.resize (active_.size ());
+      iterations_ = 0;
+      const bool warmStart = !active_.empty ();
+
+      // Minimum on the active constraints of the previous problem, without
+      // the constraints whose multipliers are negative.
+      vector6_t x (-b);
+      while (!active_.empty ()) {
+        decompose (A);
+        const size_type q = (size_type) active_.size ();
+        vector6_t lambda;
+        lambda.head (q).noalias () = Q_.leftCols (q).transpose () * b;
+        R_.topLeftCorner (q, q).triangularView <Eigen::Upper> ()
+          .solveInPlace (lambda.head (q));
+        std::size_t kept = 0;
+        for (std::size_t j = 0; j < active_.size (); ++j) {
+          if (lambda [(size_type) j] < 0) continue;
+          active_ [kept] = active_ [j];
+          multipliers_ [kept] = lambda [(size_type) j];
+          ++kept;
+        }
+        if (kept == active_.size ()) {
+          x.noalias () += Q_.leftCols (q) * (Q_.leftCols (q).transpose () * b);
+          break;
+        }
+        active_.resize (kept);
+        multipliers_.resize (kept);
+      }
+      if (active_.empty ()) decompose (A);
+
+      bool optimal = false;
+      while (iterations_ < maxIterations_) {
+        // Most violated constraint.
+        size_type p = -1;
+        value_type sp = - tolerance_;
+        for (size_type i = 0; i < n; ++i) {
+          const value_type s = A.col (i).dot (x);
+          if (s < sp) { sp = s; p = i; }
+        }
+        if (p < 0) { optimal = true; break; }
+
+        value_type plus = 0;
+        bool added = false;
+        while (!added && iterations_ < maxIterations_) {
+          ++iterations_;
+          const size_type q = (size_type) active_.size ();
+          const vector6_t d (Q_.transpose () * A.col (p));
+          const vector6_t z (Q_.rightCols (6 - q) * d.tail (6 - q));
+          vector6_t r;
+          r.head (q) = d.head (q);
+          R_.topLeftCorner (q, q).triangularView <Eigen::Upper> ()
+            .solveInPlace (r.head (q));
+          // Partial step: largest step keeping the multipliers positive.
+          value_type t1 = inf;
+          std::size_t k = 0;
+          for (std::size_t j = 0; j < active_.size (); ++j)
+            if (r [(size_type) j] > 0 &&
+                multipliers_ [j] / r [(size_type) j] < t1) {
+              t1 = multipliers_ [j] / r [(size_type) j];
+              k = j;
+            }
+          // Full step: step satisfying constraint p.
+          const value_type zn = z.dot (A.col (p));
+          const value_type t2 = (zn > tolerance_ ?
+              - A.col (p).dot (x) / zn : inf);
+          const value_type t = std::min (t1, t2);
+          // The constraints cannot be satisfied, which does not happen
+          // since F = 0 is a solution of the primal problem.
+          if (t == inf) return false;
+
+          if (t2 < inf) x += t * z;
+          for (std::size_t j = 0; j < active_.size (); ++j)
+            multipliers_ [j] -= t * r [(size_type) j];
+          plus += t;
+          if (t2 <= t1) {
+            active_.push_back (p);
+            multipliers_.push_back (plus);
+            added = true;
+          } else {
+            active_.erase (active_.begin () + (std::ptrdiff_t) k);
+            multipliers_.erase (multipliers_.begin () + (std::ptrdiff_t) k);
+          }
+          decompose (A);
+        }
+      }
+
+      solution_.setZero (n);
+      for (std::size_t j = 0; j < active_.size (); ++j)
+        solution_ [active_ [j]] = std::max (multipliers_ [j], value_type (0));
+      // x = A F - b up to rounding errors.
+      x.noalias () = A * solution_;
+      x -= b;
+      dual_.noalias () = A.transpose () * x;
+      residual_ = x.squaredNorm ();
+      warmStarted_ = optimal && warmStart;
+      return optimal;
+    }
+  } // namespace constraints
+} // namespace hpp
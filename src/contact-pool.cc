@@ -0,0 +1,141 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/contact-pool.hh>
+
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/center-of-mass-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      const Eigen::Matrix <value_type, 6, 1> Gravity
+        = (Eigen::Matrix <value_type, 6, 1>() << 0,0,-1, 0, 0, 0).finished();
+
+      size_type nbPoints (const std::vector <ContactPool::ForceData>& fds)
+      {
+        size_type nb = 0;
+        for (std::size_t i = 0; i < fds.size (); ++i)
+          nb += fds[i].points.size ();
+        return nb;
+      }
+    } // namespace
+
+    ContactPoolPtr_t ContactPool::create (const DevicePtr_t& robot,
+        const std::vector <ForceData>& contacts,
+        const CenterOfMassComputationPtr_t& com)
+    {
+      return ContactPoolPtr_t (new ContactPool (robot, contacts, com));
+    }
+
+    ContactPool::ContactPool (const DevicePtr_t& robot,
+        const std::vector <ForceData>& contacts,
+        const CenterOfMassComputationPtr_t& com) :
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)),
+      firstColumn_ (contacts.size () + 1, 0),
+      phi_ (Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero
+          (6, nbPoints (contacts)),
+          Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero
+          (6, nbPoints (contacts) * robot->numberDof())),
+      version_ (std::numeric_limits<std::size_t>::max ()),
+      forces_ (vector_t::Zero (nbPoints (contacts))),
+      subsetForces_ (vector_t::Zero (nbPoints (contacts)))
+    {
+      CalculusArena::Scope scope (arena_);
+      phi_.setSize (2, nbPoints (contacts));
+      Traits<PointCom>::Ptr_t OG =
+        PointCom::create (CenterOfMassCache::get (kinematics_, com));
+      size_type col = 0;
+      for (std::size_t i = 0; i < contacts.size (); ++i) {
+        firstColumn_[i] = col;
+        Traits<VectorInJoint>::Ptr_t n = VectorInJoint::create
+          (contacts[i].joint, contacts[i].normal, robot->numberDof());
+        for (std::size_t j = 0; j < contacts[i].points.size (); ++j) {
+          Traits<PointInJoint>::Ptr_t OP = PointInJoint::create
+            (contacts[i].joint, contacts[i].points[j], robot->numberDof());
+          phi_ (0,col) = n;
+          phi_ (1,col) = (OG - OP) ^ n;
+          ++col;
+        }
+      }
+      firstColumn_.back () = col;
+      A_.resize (6, col);
+      x0_.resize (col);
+    }
+
+    value_type ContactPool::residual (ConfigurationIn_t q,
+        const Subset_t& subset) const
+    {
+      return solve (q, subset, false);
+    }
+
+    value_type ContactPool::residualAndJacobian (ConfigurationIn_t q,
+        const Subset_t& subset, matrixOut_t jacobian) const
+    {
+      const value_type res = solve (q, subset, true);
+      // As in QPStaticStability, the derivative is
+      // 2 (phi F + Gravity)^T (dphi/dq F), the forces of the contacts outside
+      // the subset being zero.
+      Eigen::Matrix <value_type, 6, 1> lhs;
+      lhs.noalias () = phi_.value () * subsetForces_;
+      lhs += Gravity;
+      phi_.jacobianAdjoint (lhs, subsetForces_, jacobian.row (0));
+      return res;
+    }
+
+    value_type ContactPool::solve (ConfigurationIn_t q,
+        const Subset_t& subset, bool jacobian) const
+    {
+      assert (subset.size () == nbContacts ());
+      kinematics_->update (q, jacobian ? KinematicsCache::JACOBIANS :
+          KinematicsCache::PLACEMENTS);
+      if (version_ != kinematics_->version ()) {
+        phi_.invalidate ();
+        phi_.computeValue ();
+        version_ = kinematics_->version ();
+      }
+
+      // Gather the columns of the subset.
+      size_type n = 0;
+      for (std::size_t i = 0; i < subset.size (); ++i) {
+        if (!subset[i]) continue;
+        const size_type b = firstColumn_[i], k = firstColumn_[i+1] - b;
+        A_.middleCols (n, k) = phi_.value ().middleCols (b, k);
+        x0_.segment (n, k) = forces_.segment (b, k);
+        n += k;
+      }
+      nnls_.solve (A_.leftCols (n), - Gravity, x0_.head (n));
+
+      // Scatter the forces.
+      const vector_t& x = nnls_.solution ();
+      subsetForces_.setZero ();
+      n = 0;
+      for (std::size_t i = 0; i < subset.size (); ++i) {
+        if (!subset[i]) continue;
+        const size_type b = firstColumn_[i], k = firstColumn_[i+1] - b;
+        subsetForces_.segment (b, k) = x.segment (n, k);
+        forces_.segment (b, k) = x.segment (n, k);
+        n += k;
+      }
+      return nnls_.residual ();
+    }
+  } // namespace constraints
+} // namespace hpp
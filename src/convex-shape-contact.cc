@@ -16,23 +16,119 @@
 
 #include "hpp/constraints/convex-shape-contact.hh"
 
+#include <algorithm>
 #include <limits>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 
+#include "hpp/constraints/kinematics-cache.hh"
+
 namespace hpp {
   namespace constraints {
+    namespace {
+      typedef details::ConvexShapeEdges <value_type> Edges_t;
+
+      /// Clip a polygon by the half spaces of the edges of a shape
+      /// (Sutherland-Hodgman algorithm).
+      /// \param[in,out] polygon the polygon, in the frame of the edges,
+      /// \param buffer a buffer.
+      void clipPolygon (const Edges_t& edges, std::vector <vector3_t>& polygon,
+          std::vector <vector3_t>& buffer)
+      {
+        for (size_type i = 0; i < edges.pts.rows () && !polygon.empty ();
+            ++i) {
+          const vector3_t ns (edges.ns.row (i).transpose ());
+          const vector3_t p (edges.pts.row (i).transpose ());
+          buffer.clear ();
+          const std::size_t m = polygon.size ();
+          for (std::size_t k = 0; k < m; ++k) {
+            const vector3_t& P = polygon[k];
+            const vector3_t& Q = polygon[(k + 1) % m];
+            const value_type sp = ns.dot (P - p), sq = ns.dot (Q - p);
+            if (sp <= 0) buffer.push_back (P);
+            if ((sp <= 0) != (sq <= 0))
+              buffer.push_back (P + (sp / (sp - sq)) * (Q - P));
+          }
+          polygon.swap (buffer);
+        }
+      }
+
+      /// Remove the duplicated vertices and the vertices lying on the
+      /// segment between their neighbours.
+      void reducePolygon (std::vector <vector3_t>& polygon)
+      {
+        const value_type eps = 1e-8;
+        bool changed = true;
+        while (changed && polygon.size () > 1) {
+          changed = false;
+          std::size_t m = polygon.size (), j = 0;
+          for (std::size_t k = 0; k < m; ++k) {
+            const vector3_t& prev = (j > 0 ? polygon[j - 1] : polygon[m - 1]);
+            const vector3_t& P = polygon[k];
+            const vector3_t& next = polygon[(k + 1) % m];
+            const vector3_t u (P - prev), v (next - P);
+            // P is removed if it lies between prev and next.
+            if (u.norm () <= eps || (m - (k - j) > 2 && u.dot (v) > 0 &&
+                  u.cross (v).norm () <= eps * v.norm ()))
+              changed = true;
+            else
+              polygon[j++] = P;
+          }
+          if (j == 0) j = 1;
+          polygon.resize (j);
+        }
+      }
+
+      /// Rows of the transformation in the value of ConvexShapeContact:
+      /// x, y, z, ry, rz.
+      std::vector <bool> contactRows ()
+      {
+        std::vector <bool> mask (6, true);
+        mask[3] = false;
+        return mask;
+      }
+
+      /// Rows of the transformation in the value of
+      /// ConvexShapeContactComplement: y, z, rx.
+      std::vector <bool> complementRows ()
+      {
+        std::vector <bool> mask (6, false);
+        mask[1] = mask[2] = mask[3] = true;
+        return mask;
+      }
+
+      /// Bind a transformation to the selected pair.
+      template <typename T> void bind (T& transformation,
+          const ConvexShape& floor, const ConvexShape& object)
+      {
+        transformation.joint1 (floor.joint_);
+        transformation.joint2 (object.joint_);
+        transformation.frame1InJoint1 (floor.positionInJoint ());
+        transformation.frame2InJoint2 (object.positionInJoint ());
+      }
+    } // namespace
+
     ConvexShapeContact::ConvexShapeContact
     (const std::string& name, const DevicePtr_t& robot) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (), 5,
 			      name),
-      robot_ (robot),
-      relativeTransformation_ (name, robot, std::vector<bool>(6, true)),
-      normalMargin_ (0)
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)),
+      relativeTransformation_ (name, robot, contactRows ()),
+      absoluteTransformation_ (name, robot, contactRows ()),
+      relativeComplement_ (name, robot, complementRows ()),
+      absoluteComplement_ (name, robot, complementRows ()),
+      staticFloors_ (true),
+      normalMargin_ (0), selectionMargin_ (0),
+      singlePrecisionThreshold_ (std::numeric_limits <value_type>::infinity ()),
+      accuracy_ (0), selectedObject_ (-1), selectedFloor_ (-1),
+      selectionVersion_ (std::numeric_limits <std::size_t>::max ())
     {
       relativeTransformation_.joint1(robot->rootJoint());
       relativeTransformation_.joint2(robot->rootJoint());
-      jacobian_.resize (6, robot->numberDof ());
+      absoluteTransformation_.joint2(robot->rootJoint());
+      relativeComplement_.joint1(robot->rootJoint());
+      relativeComplement_.joint2(robot->rootJoint());
+      absoluteComplement_.joint2(robot->rootJoint());
     }
 
     ConvexShapeContactPtr_t ConvexShapeContact::create (
@@ -64,12 +160,50 @@ namespace hpp {
     void ConvexShapeContact::addObject (const ConvexShape& t)
     {
       objectConvexShapes_.push_back (t);
+      invalidate ();
     }
 
     void ConvexShapeContact::addFloor (const ConvexShape& t)
     {
-      ConvexShape tt (t); tt.reverse ();
-      floorConvexShapes_.push_back (tt);
+      floorConvexShapes_.push_back
+        (ConvexShape (t.geometryPtr ()->reversed (), t.joint_));
+      staticFloors_ = staticFloors_ && !t.joint_;
+      floorTree_.clear ();
+      invalidate ();
+    }
+
+    void ConvexShapeContact::setSelectionMargin (const value_type& margin)
+    {
+      selectionMargin_ = margin;
+      invalidate ();
+    }
+
+    void ConvexShapeContact::setSinglePrecisionThreshold
+    (const value_type& threshold)
+    {
+      singlePrecisionThreshold_ = threshold;
+      updateThreshold ();
+    }
+
+    void ConvexShapeContact::accuracy (value_type tolerance)
+    {
+      accuracy_ = tolerance;
+      updateThreshold ();
+    }
+
+    void ConvexShapeContact::updateThreshold ()
+    {
+      value_type threshold = singlePrecisionThreshold_;
+      if (accuracy_ > 0) threshold = std::min (threshold, accuracy_);
+      floorTree_.singlePrecisionThreshold (threshold);
+      invalidate ();
+    }
+
+    void ConvexShapeContact::invalidate ()
+    {
+      selectedObject_ = -1;
+      selectedFloor_ = -1;
+      selectionVersion_ = std::numeric_limits <std::size_t>::max ();
     }
 
     void ConvexShapeContact::setNormalMargin (const value_type& margin)
@@ -83,44 +217,76 @@ namespace hpp {
           const value_type& normalMargin) const
     {
       std::vector <ForceData> fds;
-      ForceData fd;
+      computeContactPoints (normalMargin, fds, false);
+      return fds;
+    }
+
+    std::size_t ConvexShapeContact::computeContactPoints (
+        const value_type& normalMargin, std::vector <ForceData>& fds,
+        bool clip) const
+    {
+      std::size_t n = 0;
+      updateFloorTree ();
       for (ConvexShapes_t::const_iterator o_it = objectConvexShapes_.begin ();
           o_it != objectConvexShapes_.end (); ++o_it) {
-        // o_it->updateToCurrentTransform ();
+        o_it->updateToCurrentTransform (kinematics_->version ());
         const vector3_t& globalOC_ = o_it->center ();
-        for (ConvexShapes_t::const_iterator f_it = floorConvexShapes_.begin ();
-            f_it != floorConvexShapes_.end (); ++f_it) {
-          // f_it->updateToCurrentTransform ();
+        const std::vector <vector3_t>& pts = o_it->geometry ().Pts_;
+        for (std::size_t i = 0; i < floorConvexShapes_.size (); ++i) {
+          const ConvexShapes_t::const_iterator f_it =
+            floorConvexShapes_.begin () + i;
+          // The projection cannot be inside the floor shape if the center
+          // is farther than the radius from the normal line of the shape.
+          const vector3_t OC = globalOC_ - f_it->center ();
+          const value_type r = floorTree_.radius (i);
+          if ((OC - OC.dot (f_it->normal ()) * f_it->normal ()).squaredNorm ()
+              > r * r) continue;
           if (f_it->isInside (globalOC_, f_it->normal ())) {
             value_type dn = f_it->normal ().dot (globalOC_ - f_it->center ());
             if (dn < normalMargin) {
-              // TODO: compute which points of the object are inside the floor shape.
+              if (n == fds.size ()) fds.push_back (ForceData ());
+              ForceData& fd = fds[n++];
               fd.joint = o_it->joint_;
-              fd.points = o_it->Pts_;
-              fd.normal = f_it->N_;
+              fd.normal = f_it->geometry ().N_;
               fd.supportJoint = f_it->joint_;
-              fds.push_back (fd);
+              if (!clip) {
+                fd.points = pts;
+                continue;
+              }
+              const Transform3f M = (o_it->joint_ ?
+                  o_it->joint_->currentTransformation () :
+                  Transform3f::Identity ());
+              polygon_.resize (pts.size ());
+              for (std::size_t k = 0; k < pts.size (); ++k)
+                polygon_[k] = M.act (pts[k]);
+              clipPolygon (f_it->worldEdges (), polygon_, clipped_);
+              reducePolygon (polygon_);
+              fd.points.resize (polygon_.size ());
+              for (std::size_t k = 0; k < polygon_.size (); ++k)
+                fd.points[k] = M.actInv (polygon_[k]);
             }
           }
         }
       }
-      return fds;
+      fds.resize (n);
+      return n;
     }
 
-    void ConvexShapeContact::impl_compute (vectorOut_t result, ConfigurationIn_t argument) const
+    void ConvexShapeContact::select (ConfigurationIn_t argument,
+        int quantities) const
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
-
+      kinematics_->update (argument, quantities);
       selectConvexShapes ();
-      relativeTransformation_ (result_, argument);
-      if (isInside_) {
-        result [0] = result_ [0] + normalMargin_;
-        result.segment <2> (1).setZero ();
-      } else {
-        result.segment <3> (0) = result_.segment <3> (0);
-        result[0] += normalMargin_;
-      }
+    }
+
+    void ConvexShapeContact::impl_compute (vectorOut_t result, ConfigurationIn_t argument) const
+    {
+      select (argument, KinematicsCache::PLACEMENTS);
+      // The rows x, y, z, ry, rz are written in place and the rows that
+      // are not constrained are set to zero.
+      transformation (false) (result, argument);
+      result [0] += normalMargin_;
+      if (isInside_) result.segment <2> (1).setZero ();
       switch (contactType_) {
         case POINT_ON_PLANE:
           result.segment <2> (3).setZero ();
@@ -131,87 +297,122 @@ namespace hpp {
           // of the reference of "object" should be aligned with the
           // "floor" line axis (Y-axis) projection onto the plane plane.
           // result [3] = 0;
-          // result [4] = result_[5];
+          // result [4] = rz;
         case PLANE_ON_PLANE:
-          result.segment<2> (3) = result_.segment<2> (4);
           break;
       }
       hppDout (info, "result = " << result.transpose ());
     }
 
-    void ConvexShapeContact::computeInternalJacobian
-    (ConfigurationIn_t argument) const
+    void ConvexShapeContact::impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
-      selectConvexShapes ();
-      relativeTransformation_.jacobian (jacobian_, argument);
+      select (argument, KinematicsCache::JACOBIANS);
+      if (contactType_ == LINE_ON_PLANE)
+        // FIXME: See FIXME of impl_compute
+        // jacobian.row (3).setZero ();
+        // jacobian.row (4) = Jrz;
+        throw std::logic_error ("Contact LINE_ON_PLANE: Unimplement feature");
+      transformation (false).jacobian (jacobian, argument);
+      if (isInside_) jacobian.middleRows <2> (1).setZero ();
+      if (contactType_ == POINT_ON_PLANE) jacobian.bottomRows <2> ().setZero ();
     }
 
-    void ConvexShapeContact::impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const
+    void ConvexShapeContact::updateFloorTree () const
     {
-      computeInternalJacobian (argument);
-      if (isInside_) {
-	jacobian.row (0) = jacobian_.row (0);
-	jacobian.row (1).setZero ();
-	jacobian.row (2).setZero ();
-      } else {
-        jacobian.topRows<3> () = jacobian_.topRows <3> ();
-      }
-      switch (contactType_) {
-        case POINT_ON_PLANE:
-          jacobian.bottomRows<2> ().setZero ();
-          break;
-        case LINE_ON_PLANE:
-          // FIXME: See FIXME of impl_compute
-          // jacobian.row (3).setZero ();
-          // jacobian.row (4) = jacobian_.row (5);
-          throw std::logic_error ("Contact LINE_ON_PLANE: Unimplement feature");
-        case PLANE_ON_PLANE:
-          //             Row: 3 4                     Row:  4 5
-          jacobian.bottomRows<2> () = jacobian_.bottomRows <2> ();
-          break;
-      }
+      if (floorTree_.empty ()) floorTree_.build (floorConvexShapes_);
+      else                     floorTree_.update (kinematics_->version ());
     }
 
     void ConvexShapeContact::selectConvexShapes () const
     {
+      const std::size_t version = kinematics_->version ();
+      if (selectionVersion_ == version) return;
+      HPP_CONSTRAINTS_TRACE_SCOPE ("selectConvexShapes", "contact");
       ConvexShapes_t::const_iterator object;
       ConvexShapes_t::const_iterator floor;
 
-      value_type dist, minDist = + std::numeric_limits <value_type>::infinity();
+      updateFloorTree ();
+      bool inside;
+      if (selectionMargin_ > 0 && selectedObject_ >= 0) {
+        // Keep the previous pair while it is close enough.
+        object = objectConvexShapes_.begin () + selectedObject_;
+        floor = floorConvexShapes_.begin () + selectedFloor_;
+        object->updateToCurrentTransform (version);
+        const value_type dist = ConvexShapeTree::squaredDistance (*floor,
+            object->center (), inside);
+        if (dist < selectionMargin_ * selectionMargin_) {
+          isInside_ = inside;
+          selectionVersion_ = version;
+          return;
+        }
+      }
+      // The bound of the distance found for the previous objects prunes
+      // the floor shapes of the next ones.
+      value_type minDist = + std::numeric_limits <value_type>::infinity();
       for (ConvexShapes_t::const_iterator o_it = objectConvexShapes_.begin ();
           o_it != objectConvexShapes_.end (); ++o_it) {
-        o_it->updateToCurrentTransform ();
-        const vector3_t& globalOC_ = o_it->center ();
-        for (ConvexShapes_t::const_iterator f_it = floorConvexShapes_.begin ();
-            f_it != floorConvexShapes_.end (); ++f_it) {
-          f_it->updateToCurrentTransform ();
-          value_type dp = f_it->distance (f_it->intersection (globalOC_, f_it->normal ())),
-                     dn = f_it->normal ().dot (globalOC_ - f_it->center ());
-          if (dp < 0) dist = dn * dn;
-          else        dist = dp*dp + dn * dn;
-
-          if (dist < minDist) {
-            minDist = dist;
-            object = o_it;
-            floor = f_it;
-	    isInside_ = (dp < 0);
-          }
+        o_it->updateToCurrentTransform (version);
+        const size_type f = floorTree_.closest (o_it->center (), minDist,
+            inside);
+        if (f >= 0) {
+          object = o_it;
+          floor = floorConvexShapes_.begin () + f;
+          isInside_ = inside;
         }
       }
-      contactType_ = contactType (*object, *floor);
-      relativeTransformation_.joint1 (floor->joint_);
-      relativeTransformation_.joint2 (object->joint_);
-      relativeTransformation_.frame1InJoint1 (floor->positionInJoint ());
-      relativeTransformation_.frame2InJoint2 (object->positionInJoint ());
+      selectPair (object - objectConvexShapes_.begin (),
+          floor - floorConvexShapes_.begin ());
+      selectionVersion_ = version;
+    }
+
+    void ConvexShapeContact::selectPair (size_type object, size_type floor)
+      const
+    {
+      // Setting the joints and the frames invalidates the transformation,
+      // it is done only when the selected pair changes.
+      if (object == selectedObject_ && floor == selectedFloor_) return;
+      const ConvexShape& o = objectConvexShapes_ [(std::size_t) object];
+      const ConvexShape& f = floorConvexShapes_ [(std::size_t) floor];
+      contactType_ = contactType (o, f);
+      if (staticFloors_) {
+        bind (absoluteTransformation_, f, o);
+        bind (absoluteComplement_, f, o);
+      } else {
+        bind (relativeTransformation_, f, o);
+        bind (relativeComplement_, f, o);
+      }
+      selectedObject_ = object;
+      selectedFloor_ = floor;
+    }
+
+    void ConvexShapeContact::saveWarmStart (vector_t& state) const
+    {
+      if (selectedObject_ < 0) {
+        state.resize (0);
+        return;
+      }
+      state.resize (2);
+      state << (value_type) selectedObject_, (value_type) selectedFloor_;
+    }
+
+    void ConvexShapeContact::restoreWarmStart (vectorIn_t state)
+    {
+      if (state.size () != 2) return;
+      const size_type object = (size_type) state [0],
+                      floor = (size_type) state [1];
+      if (object < 0 || object >= (size_type) objectConvexShapes_.size ()
+          || floor < 0 || floor >= (size_type) floorConvexShapes_.size ())
+        return;
+      selectPair (object, floor);
+      selectionVersion_ = std::numeric_limits <std::size_t>::max ();
     }
 
     ConvexShapeContact::ContactType ConvexShapeContact::contactType (
         const ConvexShape& object, const ConvexShape& floor) const
     {
-      assert (floor.shapeDimension_ > 0 && object.shapeDimension_);
-      switch (floor.shapeDimension_) {
+      assert (floor.geometry ().shapeDimension_ > 0 &&
+          object.geometry ().shapeDimension_);
+      switch (floor.geometry ().shapeDimension_) {
         case 1:
           throw std::logic_error
             ("Contact on points is currently unimplemented");
@@ -221,7 +422,7 @@ namespace hpp {
             ("Contact on lines is currently unimplemented");
           break;
         default:
-          switch (object.shapeDimension_) {
+          switch (object.geometry ().shapeDimension_) {
             case 1:
               return POINT_ON_PLANE;
               break;
@@ -260,31 +461,19 @@ namespace hpp {
     void ConvexShapeContactComplement::impl_compute
     (vectorOut_t result, ConfigurationIn_t argument) const
     {
-      vector5_t tmp;
-      sibling_->impl_compute (tmp, argument);
-      result [2] = sibling_->result_ [3];
-      if (sibling_->isInside_) {
-	result [0] = sibling_->result_ [1];
-	result [1] = sibling_->result_ [2];
-      } else {
-	result [0] = 0;
-	result [1] = 0;
-      }
+      sibling_->select (argument, KinematicsCache::PLACEMENTS);
+      // The rows y, z, rx are written in place.
+      sibling_->transformation (true) (result, argument);
+      if (!sibling_->isInside_) result.head <2> ().setZero ();
       hppDout (info, "result = " << result.transpose ());
     }
 
     void ConvexShapeContactComplement::impl_jacobian
     (matrixOut_t jacobian, ConfigurationIn_t argument) const
     {
-      sibling_->computeInternalJacobian (argument);
-      if (sibling_->isInside_) {
-	jacobian.row (0) = sibling_->jacobian_.row (1);
-	jacobian.row (1) = sibling_->jacobian_.row (2);
-      } else {
-	jacobian.row (0).setZero ();
-	jacobian.row (1).setZero ();
-      }
-      jacobian.row (2) = sibling_->jacobian_.row (3);
+      sibling_->select (argument, KinematicsCache::JACOBIANS);
+      sibling_->transformation (true).jacobian (jacobian, argument);
+      if (!sibling_->isInside_) jacobian.topRows <2> ().setZero ();
     }
   } // namespace constraints
 } // namespace hpp
@@ -0,0 +1,185 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/convex-shape-tree.hh>
+
+#include <algorithm>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Compare the centers of two shapes along an axis.
+      struct CenterLess {
+        CenterLess (const ConvexShapeTree::ConvexShapes_t& shapes, int axis)
+          : shapes_ (shapes), axis_ (axis) {}
+        bool operator() (size_type i, size_type j) const
+        {
+          return shapes_ [i].center () [axis_] < shapes_ [j].center () [axis_];
+        }
+        const ConvexShapeTree::ConvexShapes_t& shapes_;
+        int axis_;
+      };
+
+      /// Smallest sphere that contains two spheres.
+      void enclose (const vector3_t& c1, const value_type& r1,
+          const vector3_t& c2, const value_type& r2,
+          vector3_t& c, value_type& r)
+      {
+        const vector3_t d = c2 - c1;
+        const value_type l = d.norm ();
+        if (l + r2 <= r1) { c = c1; r = r1; return; }
+        if (l + r1 <= r2) { c = c2; r = r2; return; }
+        r = (l + r1 + r2) / 2;
+        c = c1 + ((r - r1) / l) * d;
+      }
+    } // namespace
+
+    void ConvexShapeTree::build (const ConvexShapes_t& shapes)
+    {
+      clear ();
+      if (shapes.empty ()) return;
+      shapes_ = &shapes;
+      radii_.resize (shapes.size ());
+      std::vector <size_type> indices (shapes.size ());
+      for (std::size_t i = 0; i < shapes.size (); ++i) {
+        const ConvexShape& s = shapes [i];
+        s.updateToCurrentTransform ();
+        radii_ [i] = s.geometry ().radius ();
+        if (s.joint_) moving_.push_back (i);
+        indices [i] = i;
+      }
+      nodes_.reserve (2 * shapes.size () - 1);
+      build (indices, 0, shapes.size ());
+      refit ();
+    }
+
+    void ConvexShapeTree::clear ()
+    {
+      shapes_ = NULL;
+      radii_.clear ();
+      moving_.clear ();
+      nodes_.clear ();
+    }
+
+    size_type ConvexShapeTree::build (std::vector <size_type>& shapes,
+        size_type begin, size_type end)
+    {
+      const size_type node = nodes_.size ();
+      nodes_.push_back (Node ());
+      nodes_ [node].shape = -1;
+      if (end - begin == 1) {
+        nodes_ [node].shape = shapes [begin];
+        return node;
+      }
+      vector3_t lower ((*shapes_) [shapes [begin]].center ()), upper (lower);
+      for (size_type i = begin + 1; i < end; ++i) {
+        lower = lower.cwiseMin ((*shapes_) [shapes [i]].center ());
+        upper = upper.cwiseMax ((*shapes_) [shapes [i]].center ());
+      }
+      int axis;
+      (upper - lower).maxCoeff (&axis);
+      const size_type middle = (begin + end) / 2;
+      std::nth_element (shapes.begin () + begin, shapes.begin () + middle,
+          shapes.begin () + end, CenterLess (*shapes_, axis));
+      const size_type left = build (shapes, begin, middle);
+      const size_type right = build (shapes, middle, end);
+      nodes_ [node].left = left;
+      nodes_ [node].right = right;
+      return node;
+    }
+
+    void ConvexShapeTree::refit ()
+    {
+      for (std::size_t i = nodes_.size (); i-- > 0;) {
+        Node& n = nodes_ [i];
+        if (n.shape >= 0) {
+          n.center = (*shapes_) [n.shape].center ();
+          n.radius = radii_ [n.shape];
+        } else {
+          const Node& l = nodes_ [n.left];
+          const Node& r = nodes_ [n.right];
+          enclose (l.center, l.radius, r.center, r.radius, n.center, n.radius);
+        }
+      }
+    }
+
+    bool ConvexShapeTree::update (std::size_t version)
+    {
+      bool moved = false;
+      for (std::size_t i = 0; i < moving_.size (); ++i) {
+        const ConvexShape& s = (*shapes_) [moving_ [i]];
+        const vector3_t c (s.center ());
+        s.updateToCurrentTransform (version);
+        if (c != s.center ()) moved = true;
+      }
+      if (moved) refit ();
+      return moved;
+    }
+
+    value_type ConvexShapeTree::squaredDistance (const ConvexShape& shape,
+        const vector3_t& point, bool& inside, value_type threshold)
+    {
+      const vector3_t p (shape.intersection (point, shape.normal ()));
+      const value_type
+        dp = (threshold == std::numeric_limits <value_type>::infinity ()
+            ? shape.distance (p) : shape.distance (p, threshold)),
+        dn = shape.normal ().dot (point - shape.center ());
+      inside = (dp < 0);
+      if (inside) return dn * dn;
+      return dp * dp + dn * dn;
+    }
+
+    size_type ConvexShapeTree::closest (const vector3_t& point,
+        value_type& minDist, bool& inside) const
+    {
+      size_type best = -1;
+      if (nodes_.empty ()) return best;
+      stack_.clear ();
+      stack_.push_back (0);
+      while (!stack_.empty ()) {
+        const Node& n = nodes_ [stack_.back ()];
+        stack_.pop_back ();
+        const value_type d = (point - n.center).norm () - n.radius;
+        if (d > 0 && d * d > minDist) continue;
+        if (n.shape >= 0) {
+          bool in;
+          const value_type dist = squaredDistance ((*shapes_) [n.shape],
+              point, in, threshold_);
+          if (dist < minDist ||
+              (dist == minDist && best >= 0 && n.shape < best)) {
+            minDist = dist;
+            best = n.shape;
+            inside = in;
+          }
+          continue;
+        }
+        // Visit the closest child first.
+        const value_type dl = (point - nodes_ [n.left ].center).norm ()
+          - nodes_ [n.left ].radius;
+        const value_type dr = (point - nodes_ [n.right].center).norm ()
+          - nodes_ [n.right].radius;
+        if (dl < dr) {
+          stack_.push_back (n.right);
+          stack_.push_back (n.left);
+        } else {
+          stack_.push_back (n.left);
+          stack_.push_back (n.right);
+        }
+      }
+      return best;
+    }
+  } // namespace constraints
+} // namespace hpp
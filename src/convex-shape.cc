@@ -0,0 +1,192 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/convex-shape.hh>
+
+#include <map>
+#include <stdexcept>
+
+#include <boost/weak_ptr.hpp>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      struct PointsLess
+      {
+        bool operator() (const std::vector <vector3_t>& a,
+            const std::vector <vector3_t>& b) const
+        {
+          if (a.size () != b.size ()) return a.size () < b.size ();
+          for (std::size_t i = 0; i < a.size (); ++i)
+            for (int k = 0; k < 3; ++k)
+              if (a[i][k] != b[i][k]) return a[i][k] < b[i][k];
+          return false;
+        }
+      };
+
+      typedef std::map <std::vector <vector3_t>,
+              boost::weak_ptr <const ConvexShapeGeometry>, PointsLess>
+                Geometries_t;
+
+      Geometries_t& geometries ()
+      {
+        static Geometries_t g;
+        return g;
+      }
+    } // namespace
+
+    ConvexShapeGeometryPtr_t ConvexShapeGeometry::get
+    (const std::vector <vector3_t>& pts)
+    {
+      Geometries_t& g = geometries ();
+      Geometries_t::iterator _g = g.find (pts);
+      if (_g != g.end ()) {
+        ConvexShapeGeometryPtr_t geometry = _g->second.lock ();
+        if (geometry) return geometry;
+      }
+      return insert (ConvexShapeGeometryPtr_t (new ConvexShapeGeometry (pts)));
+    }
+
+    ConvexShapeGeometryPtr_t ConvexShapeGeometry::insert
+    (const ConvexShapeGeometryPtr_t& geometry)
+    {
+      Geometries_t& g = geometries ();
+      Geometries_t::iterator _g = g.find (geometry->Pts_);
+      if (_g != g.end ()) {
+        ConvexShapeGeometryPtr_t existing = _g->second.lock ();
+        if (existing) return existing;
+      }
+      g[geometry->Pts_] = geometry;
+
+      // Remove instances that are not used anymore.
+      for (_g = g.begin (); _g != g.end ();) {
+        if (_g->second.expired ()) g.erase (_g++);
+        else ++_g;
+      }
+      return geometry;
+    }
+
+    ConvexShapeGeometryPtr_t ConvexShapeGeometry::reversed () const
+    {
+      std::vector <vector3_t> pts (Pts_.rbegin (), Pts_.rend ());
+      return get (pts);
+    }
+
+    ConvexShapeGeometry::ConvexShapeGeometry
+    (const std::vector <vector3_t>& pts) : Pts_ (pts)
+    {
+      init ();
+    }
+
+    ConvexShapeGeometry::ConvexShapeGeometry
+    (const std::vector <vector3_t>& pts, const vector3_t& C,
+     const vector3_t& N, const std::vector <vector3_t>& Ns,
+     const std::vector <vector3_t>& Us, const vector_t& Ls,
+     value_type radius) :
+      Pts_ (pts), shapeDimension_ (pts.size ()), C_ (C), N_ (N), Ns_ (Ns),
+      Us_ (Us), Ls_ (Ls), radius_ (radius)
+    {
+      finish ();
+    }
+
+    void ConvexShapeGeometry::init ()
+    {
+      shapeDimension_ = Pts_.size ();
+
+      switch (shapeDimension_) {
+        case 0:
+          throw std::logic_error ("Cannot represent an empty shape.");
+          break;
+        case 1:
+          C_ = Pts_[0];
+          // The transformation will be (N_, Ns_[0], Us_[0])
+          // Fill vectors so as to be consistent
+          N_ = vector3_t(1,0,0);
+          Ns_.push_back (vector3_t(0,1,0));
+          Us_.push_back (vector3_t(0,0,1));
+          break;
+        case 2:
+          Ls_ = vector_t(1);
+          C_ = (Pts_[0] + Pts_[1])/2;
+          // The transformation will be (N_, Ns_[0], Us_[0])
+          // Fill vectors so as to be consistent
+          Us_.push_back (Pts_[1] - Pts_[0]);
+          Ls_[0] = Us_[0].norm();
+          Us_[0].normalize ();
+          if (Us_[0][0] != 0) N_ = vector3_t(-Us_[0][1],Us_[0][0],0);
+          else                N_ = vector3_t(0,-Us_[0][2],Us_[0][1]);
+          N_.normalize ();
+          Ns_.push_back (Us_[0].cross (N_));
+          Ns_[0].normalize (); // Should be unnecessary
+          break;
+        default:
+          Ls_ = vector_t(shapeDimension_);
+          C_.setZero ();
+          for (std::size_t i = 0; i < shapeDimension_; ++i)
+            C_ += Pts_[i];
+          // TODO This is very ugly. Why Eigen does not have the operator/=(int) ...
+          C_ /= (value_type)Pts_.size();
+          N_ = (Pts_[1] - Pts_[0]).cross (Pts_[2] - Pts_[1]);
+          assert (!N_.isZero ());
+          N_.normalize ();
+
+          Us_.resize (Pts_.size());
+          Ns_.resize (Pts_.size());
+          for (std::size_t i = 0; i < shapeDimension_; ++i) {
+            Us_[i] = Pts_[(i+1)%shapeDimension_] - Pts_[i];
+            Ls_[i] = Us_[i].norm();
+            Us_[i].normalize ();
+            Ns_[i] = Us_[i].cross (N_);
+            Ns_[i].normalize ();
+          }
+          for (std::size_t i = 0; i < shapeDimension_; ++i) {
+            assert (Us_[(i+1)%shapeDimension_].dot (Ns_[i]) < 0 &&
+                "The sequence does not define a convex surface");
+          }
+          break;
+      }
+
+      radius_ = 0;
+      for (std::size_t i = 0; i < shapeDimension_; ++i)
+        radius_ = std::max (radius_, (Pts_[i] - C_).norm ());
+
+      finish ();
+    }
+
+    void ConvexShapeGeometry::finish ()
+    {
+      pack ();
+
+      MinJoint_.translation() = C_;
+      MinJoint_.rotation().col(0) = N_;
+      MinJoint_.rotation().col(1) = Ns_[0];
+      MinJoint_.rotation().col(2) = Us_[0];
+    }
+
+    void ConvexShapeGeometry::pack ()
+    {
+      const std::size_t n = (shapeDimension_ > 2 ? shapeDimension_ : 1);
+      edges_.resize (n);
+      for (std::size_t i = 0; i < n; ++i) {
+        edges_.pts.row (i) = Pts_[i].transpose ();
+        edges_.next.row (i) = Pts_[(i+1)%Pts_.size ()].transpose ();
+        edges_.ns.row (i) = Ns_[i].transpose ();
+        edges_.us.row (i) = Us_[i].transpose ();
+        edges_.ls[i] = (shapeDimension_ > 1 ? Ls_[i] : 0);
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,908 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/differentiable-function-stack.hh>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <typeinfo>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/constraints/active-subspace.hh>
+#include <hpp/constraints/configuration-constraint.hh>
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/model-metadata.hh>
+#include <hpp/constraints/relative-com.hh>
+#include <hpp/constraints/workspace.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      inline std::size_t threadId ()
+      {
+#ifdef _OPENMP
+        return (std::size_t) omp_get_thread_num ();
+#else
+        return 0;
+#endif
+      }
+
+#ifdef HPP_CONSTRAINTS_WITH_STATISTICS
+      bool slower (const DifferentiableFunctionPtr_t& f1,
+          const DifferentiableFunctionPtr_t& f2)
+      {
+        return f1->statistics ().time () > f2->statistics ().time ();
+      }
+#endif
+    } // namespace
+
+    DifferentiableFunctionStack::Handle_t DifferentiableFunctionStack::add
+    (const DifferentiableFunctionPtr_t& func)
+    {
+      if (functions_.empty()) {
+        inputSize_           = func->inputSize();
+        inputDerivativeSize_ = func->inputDerivativeSize();
+      } else {
+        assert (inputSize_           == func->inputSize());
+        assert (inputDerivativeSize_ == func->inputDerivativeSize());
+      }
+      const Handle_t handle = indices_.size ();
+      indices_.push_back (functions_.size ());
+      handles_.push_back (handle);
+      functions_.push_back (func);
+      active_.push_back (true);
+      update ();
+      return handle;
+    }
+
+    bool DifferentiableFunctionStack::erase
+    (const DifferentiableFunctionPtr_t& func)
+    {
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        if (func == functions_[i]) {
+          erase (handles_[i]);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void DifferentiableFunctionStack::erase (Handle_t handle)
+    {
+      const std::size_t i = index (handle);
+      functions_.erase (functions_.begin () + i);
+      active_.erase (active_.begin () + i);
+      handles_.erase (handles_.begin () + i);
+      indices_[handle] = std::numeric_limits<std::size_t>::max ();
+      for (std::size_t j = i; j < handles_.size (); ++j)
+        indices_[handles_[j]] = j;
+      update ();
+    }
+
+    void DifferentiableFunctionStack::update ()
+    {
+      rows_.resize (functions_.size ());
+      derivativeRows_.resize (functions_.size ());
+      outputSize_ = 0;
+      outputDerivativeSize_ = 0;
+      activeDerivativeColumns_.setConstant (inputDerivativeSize_, false);
+      ++structureVersion_;
+      sparseSubspaces_.clear ();
+      sparseBlocks_.resize (functions_.size ());
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        sparseSubspaces_.push_back (ActiveSubspace
+            (f.activeDerivativeColumns ()));
+        sparseBlocks_[i].resize (f.outputDerivativeSize (),
+            sparseSubspaces_[i].dimension ());
+        rows_[i] = outputSize_;
+        derivativeRows_[i] = outputDerivativeSize_;
+        outputSize_           += f.outputSize ();
+        outputDerivativeSize_ += f.outputDerivativeSize ();
+        activeDerivativeColumns_ =
+          activeDerivativeColumns_ || f.activeDerivativeColumns ();
+      }
+      if (!workspaces_.empty ()) computeTasks ();
+      if (robot_) computeSupports ();
+      if (flatten_) flatten (true);
+      if (compiled_) compile (true);
+      computeSatisfactionOrder ();
+      computeBlocks ();
+      invalidateRows ();
+    }
+
+    void DifferentiableFunctionStack::jacobian (SparseMatrix_t& jacobian,
+        vectorIn_t argument) const
+    {
+      assert (argument.size () == inputSize ());
+      if (jacobian.rows () != outputDerivativeSize_
+          || jacobian.cols () != inputDerivativeSize_
+          || !jacobian.isCompressed ()
+          || sparseVersion_ != structureVersion_
+          || sparseInner_ != jacobian.innerIndexPtr ())
+        sparsityPattern (jacobian);
+      HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+          EvaluationStatistics::JACOBIAN);
+      const int* outer = jacobian.outerIndexPtr ();
+      value_type* values = jacobian.valuePtr ();
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        const ActiveSubspace& subspace = sparseSubspaces_[i];
+        const size_type rows = f.outputDerivativeSize (),
+                        cols = subspace.dimension ();
+        // The rows of a function are stored one after the other, each with
+        // the active columns in increasing order.
+        Eigen::Map <Eigen::Matrix <value_type, Eigen::Dynamic, Eigen::Dynamic,
+          Eigen::RowMajor> > block (values + outer[derivativeRows_[i]],
+              rows, cols);
+        if (!active_[i] || cols == 0) {
+          block.setZero ();
+          continue;
+        }
+        f.reducedJacobian (sparseBlocks_[i], argument, subspace);
+        block = sparseBlocks_[i];
+      }
+    }
+
+    MemoryUsage DifferentiableFunctionStack::memoryUsage () const
+    {
+      MemoryUsage m (DifferentiableFunction::memoryUsage ());
+      m.definition += sizeof (DifferentiableFunctionStack)
+        - sizeof (DifferentiableFunction)
+        + memorySize (functions_) + memorySize (rows_)
+        + memorySize (derivativeRows_) + memorySize (active_)
+        + memorySize (handles_) + memorySize (indices_)
+        + memorySize (satisfactionOrder_) + memorySize (workspaces_)
+        + memorySize (tasks_) + memorySize (futures_) + memorySize (leaves_)
+        + memorySize (buckets_) + memorySize (flatCopies_)
+        + memorySize (compiledCopies_) + memorySize (supports_)
+        + memorySize (blocks_);
+      for (std::size_t i = 0; i < buckets_.size (); ++i)
+        m.definition += memorySize (buckets_[i].leaves);
+      for (std::size_t i = 0; i < supports_.size (); ++i)
+        m.definition += memorySize (supports_[i]);
+      for (std::size_t i = 0; i < blocks_.size (); ++i) {
+        const ActiveSubspace& c = blocks_[i].columns;
+        m.definition += memorySize (blocks_[i].functions)
+          + memorySize (blocks_[i].joints)
+          + memorySize (c.support ()) + memorySize (c.columns ())
+          + memorySize (c.selection ());
+      }
+      m.definition += memorySize (sparseSubspaces_);
+      for (std::size_t i = 0; i < sparseSubspaces_.size (); ++i) {
+        const ActiveSubspace& c = sparseSubspaces_[i];
+        m.definition += memorySize (c.support ()) + memorySize (c.columns ());
+      }
+      m.scratch += memorySize (sparseBlocks_) + memorySize (product_)
+        + memorySize (value_);
+      for (std::size_t i = 0; i < sparseBlocks_.size (); ++i)
+        m.scratch += memorySize (sparseBlocks_[i]);
+      for (std::size_t i = 0; i < blockScratch_.size (); ++i)
+        m.scratch += memorySize (blockScratch_[i]);
+      const RowCache* caches[2] = { &valueCache_, &jacobianCache_ };
+      for (std::size_t i = 0; i < 2; ++i)
+        m.caches += memorySize (caches[i]->argument)
+          + memorySize (caches[i]->changed) + memorySize (caches[i]->valid);
+      m.caches += memorySize (cachedValue_) + memorySize (cachedJacobian_);
+      for (std::size_t i = 0; i < functions_.size (); ++i)
+        m += functions_[i]->memoryUsage ();
+      return m;
+    }
+
+    void DifferentiableFunctionStack::saveWarmStart (vector_t& state) const
+    {
+      std::vector <vector_t> states (functions_.size ());
+      size_type size = (size_type) functions_.size ();
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        functions_[i]->saveWarmStart (states[i]);
+        size += states[i].size ();
+      }
+      state.resize (size);
+      size_type k = 0;
+      for (std::size_t i = 0; i < states.size (); ++i) {
+        state [k++] = (value_type) states[i].size ();
+        state.segment (k, states[i].size ()) = states[i];
+        k += states[i].size ();
+      }
+    }
+
+    void DifferentiableFunctionStack::restoreWarmStart (vectorIn_t state)
+    {
+      size_type k = 0;
+      // Stop at the first function whose state does not fit, which means
+      // that the state was saved on another stack.
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        if (k >= state.size ()) break;
+        const size_type size = (size_type) state [k++];
+        if (size < 0 || k + size > state.size ()) break;
+        functions_[i]->restoreWarmStart (state.segment (k, size));
+        k += size;
+      }
+      invalidateRows ();
+    }
+
+    namespace {
+      std::size_t findRoot (std::vector <std::size_t>& parent, std::size_t i)
+      {
+        while (parent[i] != i) {
+          parent[i] = parent[parent[i]];
+          i = parent[i];
+        }
+        return i;
+      }
+    } // namespace
+
+    void DifferentiableFunctionStack::computeBlocks ()
+    {
+      // Union-find of the functions sharing a column.
+      const std::size_t n = functions_.size ();
+      std::vector <std::size_t> parent (n);
+      for (std::size_t i = 0; i < n; ++i) parent[i] = i;
+      std::vector <std::size_t> owner (inputDerivativeSize_, n);
+      for (std::size_t i = 0; i < n; ++i) {
+        const ArrayXb& columns = functions_[i]->activeDerivativeColumns ();
+        for (size_type j = 0; j < inputDerivativeSize_; ++j) {
+          if (!columns[j]) continue;
+          if (owner[j] == n) {
+            owner[j] = i;
+            continue;
+          }
+          const std::size_t r1 = findRoot (parent, owner[j]),
+                            r2 = findRoot (parent, i);
+          // The root is the first function of the block.
+          if (r1 < r2) parent[r2] = r1;
+          else         parent[r1] = r2;
+        }
+      }
+
+      blocks_.clear ();
+      std::vector <std::size_t> block (n);
+      std::vector <ArrayXb> columns;
+      for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t r = findRoot (parent, i);
+        if (r == i) {
+          block[i] = blocks_.size ();
+          blocks_.push_back (Block (inputDerivativeSize_));
+          columns.push_back (ArrayXb::Constant (inputDerivativeSize_, false));
+        } else block[i] = block[r];
+        Block& b = blocks_[block[i]];
+        b.functions.push_back (i);
+        b.derivativeSize += functions_[i]->outputDerivativeSize ();
+        b.threadSafe = b.threadSafe && functions_[i]->threadSafe ();
+        columns[block[i]] = columns[block[i]]
+          || functions_[i]->activeDerivativeColumns ();
+      }
+      for (std::size_t b = 0; b < blocks_.size (); ++b)
+        blocks_[b].columns = ActiveSubspace (columns[b]);
+      if (blockRobot_) computeBlockJoints ();
+    }
+
+    void DifferentiableFunctionStack::blockKinematics
+    (const DevicePtr_t& robot)
+    {
+      blockRobot_ = robot;
+      if (blockRobot_) computeBlockJoints ();
+      else
+        for (std::size_t b = 0; b < blocks_.size (); ++b)
+          blocks_[b].joints.clear ();
+    }
+
+    void DifferentiableFunctionStack::computeBlockJoints ()
+    {
+      const se3::Model& model = blockRobot_->model ();
+      const ModelMetadata::JointIndices_t& velocityToJoint =
+        ModelMetadata::get (blockRobot_)->velocityToJoint ();
+      for (std::size_t b = 0; b < blocks_.size (); ++b) {
+        Block& block = blocks_[b];
+        block.joints.assign (model.joints.size (), false);
+        const ActiveSubspace::Columns_t& columns = block.columns.columns ();
+        for (std::size_t k = 0; k < columns.size (); ++k) {
+          // The columns of the extra config space have no joint.
+          if (columns[k] >= (size_type) velocityToJoint.size ()) continue;
+          for (se3::JointIndex j = velocityToJoint[columns[k]];
+              j > 0 && !block.joints[j]; j = model.parents[j])
+            block.joints[j] = true;
+        }
+      }
+    }
+
+    void DifferentiableFunctionStack::blockJacobian (std::size_t b,
+        matrixOut_t jacobian, vectorIn_t argument) const
+    {
+      assert (b < blocks_.size ());
+      const Block& block = blocks_[b];
+      assert (argument.size () == inputSize ());
+      assert (jacobian.rows () == block.derivativeSize);
+      assert (jacobian.cols () == block.columns.dimension ());
+      // The functions of the block find the joints they read up to date.
+      if (blockRobot_)
+        KinematicsCache::get (blockRobot_)->update (argument,
+            KinematicsCache::JACOBIANS, block.joints);
+      size_type row = 0;
+      for (std::size_t k = 0; k < block.functions.size (); ++k) {
+        const std::size_t i = block.functions[k];
+        const DifferentiableFunction& f = *functions_[i];
+        matrixOut_t::RowsBlockXpr rows (jacobian.middleRows
+            (row, f.outputDerivativeSize ()));
+        row += f.outputDerivativeSize ();
+        if (!active_[i]) {
+          rows.setZero ();
+          continue;
+        }
+        HPP_CONSTRAINTS_EVALUATION_SCOPE (f, EvaluationStatistics::JACOBIAN);
+        f.impl_reducedJacobian (rows, argument, block.columns);
+      }
+    }
+
+    void DifferentiableFunctionStack::blockJacobians
+    (std::vector <matrix_t>& jacobians, vectorIn_t argument) const
+    {
+      assert (argument.size () == inputSize ());
+      jacobians.resize (blocks_.size ());
+      for (std::size_t b = 0; b < blocks_.size (); ++b)
+        jacobians[b].resize (blocks_[b].derivativeSize,
+            blocks_[b].columns.dimension ());
+      if (workspaces_.empty ()) {
+        for (std::size_t b = 0; b < blocks_.size (); ++b)
+          blockJacobian (b, jacobians[b], argument);
+        return;
+      }
+      blockScratch_.resize (workspaces_.size ());
+      const int nbBlocks = (int) blocks_.size ();
+#pragma omp parallel for schedule(dynamic) num_threads(workspaces_.size ())
+      for (int b = 0; b < nbBlocks; ++b) {
+        const Block& block = blocks_[b];
+        if (!block.threadSafe) continue;
+        const std::size_t thread = threadId ();
+        Workspace& workspace = *workspaces_[thread];
+        if (!block.joints.empty ())
+          workspace.kinematics ()->update (argument,
+              KinematicsCache::JACOBIANS, block.joints);
+        matrix_t& J = blockScratch_[thread];
+        size_type row = 0;
+        for (std::size_t k = 0; k < block.functions.size (); ++k) {
+          const std::size_t i = block.functions[k];
+          const DifferentiableFunction& f = *functions_[i];
+          matrix_t::RowsBlockXpr rows (jacobians[b].middleRows
+              (row, f.outputDerivativeSize ()));
+          row += f.outputDerivativeSize ();
+          if (!active_[i]) {
+            rows.setZero ();
+            continue;
+          }
+          J.resize (f.outputDerivativeSize (), inputDerivativeSize_);
+          HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+              EvaluationStatistics::JACOBIAN);
+          f.impl_jacobian (J, argument, workspace);
+          block.columns.reduce (J, rows);
+        }
+      }
+      // Functions that are not thread safe use the data of the function.
+      for (std::size_t b = 0; b < blocks_.size (); ++b)
+        if (!blocks_[b].threadSafe) blockJacobian (b, jacobians[b], argument);
+    }
+
+    namespace {
+      struct CompareCosts
+      {
+        CompareCosts (const std::vector <value_type>& c) : costs (c) {}
+        bool operator() (std::size_t i, std::size_t j) const
+        {
+          return costs[i] < costs[j];
+        }
+        const std::vector <value_type>& costs;
+      };
+
+      void sortByCosts (const std::vector <value_type>& costs,
+          std::vector <std::size_t>& order)
+      {
+        order.resize (costs.size ());
+        for (std::size_t i = 0; i < order.size (); ++i) order[i] = i;
+        // Keep the order of insertion for functions of equal cost.
+        std::stable_sort (order.begin (), order.end (), CompareCosts (costs));
+      }
+    } // namespace
+
+    void DifferentiableFunctionStack::computeSatisfactionOrder ()
+    {
+      std::vector <value_type> costs (functions_.size ());
+      for (std::size_t i = 0; i < functions_.size (); ++i)
+        costs[i] = functions_[i]->evaluationCost ();
+      sortByCosts (costs, satisfactionOrder_);
+    }
+
+    bool DifferentiableFunctionStack::impl_isSatisfied (vectorIn_t arg,
+        value_type threshold) const
+    {
+      const value_type max = threshold * threshold;
+      value_type squaredNorm = 0;
+      for (std::size_t k = 0; k < satisfactionOrder_.size (); ++k) {
+        const std::size_t i = satisfactionOrder_[k];
+        if (!active_[i]) continue;
+        const DifferentiableFunction& f = *functions_[i];
+        value_.resize (f.outputSize ());
+        f (value_, arg);
+        squaredNorm += value_.squaredNorm ();
+        if (squaredNorm > max) return false;
+      }
+      return true;
+    }
+
+    void DifferentiableFunctionStack::flatten (bool flag)
+    {
+      flatten_ = flag;
+      leaves_.clear ();
+      flatCopies_.clear ();
+      if (!flatten_) return;
+      appendLeaves (*this, 0, 0, true, leaves_);
+      removeDuplicates (leaves_, flatCopies_);
+    }
+
+    void DifferentiableFunctionStack::appendLeaves
+    (const DifferentiableFunctionStack& stack, size_type row,
+     size_type derivativeRow, bool active, std::vector <Leaf>& leaves)
+    {
+      for (std::size_t i = 0; i < stack.functions_.size (); ++i) {
+        const DifferentiableFunction& f = *stack.functions_[i];
+        const size_type r = row + stack.rows_[i];
+        const size_type dr = derivativeRow + stack.derivativeRows_[i];
+        const bool a = active && stack.active_[i];
+        const DifferentiableFunctionStack* nested =
+          dynamic_cast <const DifferentiableFunctionStack*> (&f);
+        if (nested && !nested->executor_ && nested->workspaces_.empty ()
+            && !nested->robot_) {
+          appendLeaves (*nested, r, dr, a, leaves);
+        } else {
+          Leaf leaf;
+          leaf.function = &f;
+          leaf.row = r;
+          leaf.derivativeRow = dr;
+          leaf.active = a;
+          leaves.push_back (leaf);
+        }
+      }
+    }
+
+    void DifferentiableFunctionStack::removeDuplicates
+    (std::vector <Leaf>& leaves, std::vector <Copy>& copies)
+    {
+      typedef std::map <const DifferentiableFunction*, std::size_t>
+        Evaluated_t;
+      Evaluated_t evaluated;
+      std::size_t n = 0;
+      for (std::size_t i = 0; i < leaves.size (); ++i) {
+        const Leaf& leaf = leaves[i];
+        if (leaf.active) {
+          std::pair <Evaluated_t::iterator, bool> e = evaluated.insert
+            (Evaluated_t::value_type (leaf.function, n));
+          if (!e.second) {
+            const Leaf& source = leaves[e.first->second];
+            Copy copy;
+            copy.from = source.row;
+            copy.to = leaf.row;
+            copy.size = leaf.function->outputSize ();
+            copy.derivativeFrom = source.derivativeRow;
+            copy.derivativeTo = leaf.derivativeRow;
+            copy.derivativeSize = leaf.function->outputDerivativeSize ();
+            copies.push_back (copy);
+            continue;
+          }
+        }
+        leaves[n++] = leaf;
+      }
+      leaves.resize (n);
+    }
+
+    void DifferentiableFunctionStack::evaluateLeaves
+    (const std::vector <Leaf>& leaves, vectorOut_t* result,
+     matrixOut_t* jacobian, ConfigurationIn_t arg)
+    {
+      for (std::vector <Leaf>::const_iterator _l = leaves.begin ();
+          _l != leaves.end (); ++_l) {
+        const DifferentiableFunction& f = *_l->function;
+        if (!_l->active) {
+          if (result) result->segment (_l->row, f.outputSize ()).setZero ();
+          if (jacobian) jacobian->middleRows (_l->derivativeRow,
+              f.outputDerivativeSize ()).setZero ();
+          continue;
+        }
+        HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+            result && jacobian ?
+             EvaluationStatistics::VALUE_AND_JACOBIAN :
+             (result ? EvaluationStatistics::VALUE :
+              EvaluationStatistics::JACOBIAN));
+        if (result && jacobian)
+          f.impl_valueAndJacobian (result->segment (_l->row, f.outputSize ()),
+              jacobian->middleRows (_l->derivativeRow,
+                f.outputDerivativeSize ()), arg);
+        else if (result)
+          f.impl_compute (result->segment (_l->row, f.outputSize ()), arg);
+        else
+          f.impl_jacobian (jacobian->middleRows (_l->derivativeRow,
+                f.outputDerivativeSize ()), arg);
+      }
+    }
+
+    template <typename T>
+    void DifferentiableFunctionStack::evaluateBucket
+    (const std::vector <Leaf>& leaves, vectorOut_t* result,
+     matrixOut_t* jacobian, ConfigurationIn_t arg)
+    {
+      // The qualified calls are not dispatched through the virtual table.
+      for (std::vector <Leaf>::const_iterator _l = leaves.begin ();
+          _l != leaves.end (); ++_l) {
+        const T& f = static_cast <const T&> (*_l->function);
+        HPP_CONSTRAINTS_EVALUATION_SCOPE (*_l->function,
+            result && jacobian ?
+             EvaluationStatistics::VALUE_AND_JACOBIAN :
+             (result ? EvaluationStatistics::VALUE :
+              EvaluationStatistics::JACOBIAN));
+        if (result && jacobian)
+          f.T::impl_valueAndJacobian
+            (result->segment (_l->row, f.outputSize ()),
+             jacobian->middleRows (_l->derivativeRow,
+               f.outputDerivativeSize ()), arg);
+        else if (result)
+          f.T::impl_compute (result->segment (_l->row, f.outputSize ()), arg);
+        else
+          f.T::impl_jacobian (jacobian->middleRows (_l->derivativeRow,
+                f.outputDerivativeSize ()), arg);
+      }
+    }
+
+    void DifferentiableFunctionStack::compile (bool flag)
+    {
+      compiled_ = flag;
+      buckets_.clear ();
+      compiledCopies_.clear ();
+      if (!compiled_) return;
+
+      // Types evaluated without virtual call. The last bucket holds the
+      // functions of the other types and the inactive functions.
+      std::vector <const std::type_info*> types;
+      std::vector <Bucket::Evaluate_t> evaluations;
+#define HPP_CONSTRAINTS_STACK_BUCKET(T)                                      \
+      types.push_back (&typeid (T));                                        \
+      evaluations.push_back (&DifferentiableFunctionStack::evaluateBucket <T>)
+      HPP_CONSTRAINTS_STACK_BUCKET (Position);
+      HPP_CONSTRAINTS_STACK_BUCKET (Orientation);
+      HPP_CONSTRAINTS_STACK_BUCKET (Transformation);
+      HPP_CONSTRAINTS_STACK_BUCKET (RelativePosition);
+      HPP_CONSTRAINTS_STACK_BUCKET (RelativeOrientation);
+      HPP_CONSTRAINTS_STACK_BUCKET (RelativeTransformation);
+      HPP_CONSTRAINTS_STACK_BUCKET (RelativeCom);
+      HPP_CONSTRAINTS_STACK_BUCKET (ConfigurationConstraint);
+#undef HPP_CONSTRAINTS_STACK_BUCKET
+      evaluations.push_back (&DifferentiableFunctionStack::evaluateLeaves);
+
+      std::vector <Leaf> leaves;
+      appendLeaves (*this, 0, 0, true, leaves);
+      removeDuplicates (leaves, compiledCopies_);
+      std::vector <Bucket> buckets (evaluations.size ());
+      for (std::size_t i = 0; i < leaves.size (); ++i) {
+        // Derived classes may override the implementation, so that the
+        // type must match exactly.
+        std::size_t b = 0;
+        if (leaves[i].active) {
+          const std::type_info& type = typeid (*leaves[i].function);
+          while (b < types.size () && *types[b] != type) ++b;
+        } else b = types.size ();
+        buckets[b].leaves.push_back (leaves[i]);
+      }
+      for (std::size_t b = 0; b < buckets.size (); ++b) {
+        if (buckets[b].leaves.empty ()) continue;
+        buckets[b].evaluate = evaluations[b];
+        buckets_.push_back (buckets[b]);
+      }
+    }
+
+    void DifferentiableFunctionStack::cacheRows (const DevicePtr_t& robot)
+    {
+      robot_ = robot;
+      supports_.clear ();
+      if (robot_) computeSupports ();
+      invalidateRows ();
+    }
+
+    void DifferentiableFunctionStack::computeSupports ()
+    {
+      const ModelMetadataConstPtr_t metadata (ModelMetadata::get (robot_));
+      supports_.resize (functions_.size ());
+      for (std::size_t i = 0; i < functions_.size (); ++i)
+        metadata->configurationVariables
+          (functions_[i]->activeDerivativeColumns (), supports_[i]);
+    }
+
+    void DifferentiableFunctionStack::parallel (const DevicePtr_t& robot,
+        std::size_t nbThreads, value_type minTaskCost)
+    {
+      workspaces_.resize (nbThreads);
+      for (std::size_t i = 0; i < nbThreads; ++i)
+        workspaces_[i] = Workspace::create (robot);
+      minTaskCost_ = minTaskCost;
+      computeTasks ();
+    }
+
+    void DifferentiableFunctionStack::computeTasks ()
+    {
+      tasks_.clear ();
+      value_type cost = 0;
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        const bool parallel = f.threadSafe ();
+        // Start a new task if the previous one is expensive enough or if it
+        // has to be evaluated differently.
+        if (tasks_.empty () || tasks_.back ().parallel != parallel
+            || (parallel && cost >= minTaskCost_)) {
+          Task task;
+          task.begin = i;
+          task.parallel = parallel;
+          tasks_.push_back (task);
+          cost = 0;
+        }
+        tasks_.back ().end = i + 1;
+        cost += f.evaluationCost ();
+      }
+    }
+
+    void DifferentiableFunctionStack::parallelEvaluate (vectorOut_t* result,
+        matrixOut_t* jacobian, ConfigurationIn_t arg) const
+    {
+      const int nbTasks = (int) tasks_.size ();
+#pragma omp parallel for schedule(dynamic) num_threads(workspaces_.size ())
+      for (int i = 0; i < nbTasks; ++i) {
+        const Task& task = tasks_[i];
+        if (!task.parallel) continue;
+        Workspace& workspace = *workspaces_[threadId ()];
+        for (std::size_t j = task.begin; j < task.end; ++j) {
+          const DifferentiableFunction& f = *functions_[j];
+          const size_type row = rows_[j], derivativeRow = derivativeRows_[j];
+          if (!active_[j]) {
+            if (result) result->segment (row, f.outputSize ()).setZero ();
+            if (jacobian) jacobian->middleRows (derivativeRow,
+                f.outputDerivativeSize ()).setZero ();
+            continue;
+          }
+          if (result) {
+            HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                EvaluationStatistics::VALUE);
+            f.impl_compute (result->segment (row, f.outputSize ()), arg,
+                workspace);
+          }
+          if (jacobian) {
+            HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+                EvaluationStatistics::JACOBIAN);
+            f.impl_jacobian (jacobian->middleRows (derivativeRow,
+                  f.outputDerivativeSize ()), arg, workspace);
+          }
+        }
+      }
+      // Functions that are not thread safe use the data of the function.
+      for (std::size_t i = 0; i < tasks_.size (); ++i) {
+        const Task& task = tasks_[i];
+        if (task.parallel) continue;
+        for (std::size_t j = task.begin; j < task.end; ++j) {
+          const DifferentiableFunction& f = *functions_[j];
+          const size_type row = rows_[j], derivativeRow = derivativeRows_[j];
+          if (!active_[j]) {
+            if (result) result->segment (row, f.outputSize ()).setZero ();
+            if (jacobian) jacobian->middleRows (derivativeRow,
+                f.outputDerivativeSize ()).setZero ();
+            continue;
+          }
+          HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+              result && jacobian ?
+               EvaluationStatistics::VALUE_AND_JACOBIAN :
+               (result ? EvaluationStatistics::VALUE :
+                EvaluationStatistics::JACOBIAN));
+          if (result && jacobian)
+            f.impl_valueAndJacobian (result->segment (row, f.outputSize ()),
+                jacobian->middleRows (derivativeRow,
+                  f.outputDerivativeSize ()), arg);
+          else if (result)
+            f.impl_compute (result->segment (row, f.outputSize ()), arg);
+          else
+            f.impl_jacobian (jacobian->middleRows (derivativeRow,
+                  f.outputDerivativeSize ()), arg);
+        }
+      }
+    }
+
+    void DifferentiableFunctionStack::asyncEvaluate (vectorOut_t* result,
+        matrixOut_t* jacobian, ConfigurationIn_t arg) const
+    {
+      futures_.resize (functions_.size ());
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        if (active_[i])
+          futures_[i] = executor_->submit (*functions_[i], arg,
+              jacobian != NULL);
+        else futures_[i] = EvaluationFuture ();
+      }
+      executor_->run ();
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        if (futures_[i].valid ()) {
+          if (result) result->segment (rows_[i], f.outputSize ()) =
+            futures_[i].value ();
+          if (jacobian) jacobian->middleRows (derivativeRows_[i],
+              f.outputDerivativeSize ()) = futures_[i].jacobian ();
+        } else {
+          if (result) result->segment (rows_[i], f.outputSize ()).setZero ();
+          if (jacobian) jacobian->middleRows (derivativeRows_[i],
+              f.outputDerivativeSize ()).setZero ();
+        }
+      }
+    }
+
+    void DifferentiableFunctionStack::cachedEvaluate (vectorOut_t* result,
+        matrixOut_t* jacobian, ConfigurationIn_t arg) const
+    {
+      if (result) {
+        valueCache_.update (arg, functions_.size ());
+        cachedValue_.resize (outputSize_);
+      }
+      if (jacobian) {
+        jacobianCache_.update (arg, functions_.size ());
+        cachedJacobian_.resize (outputDerivativeSize_, inputDerivativeSize_);
+      }
+      // The views of a buffer are only built if its output is requested:
+      // the other buffer may not be sized.
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        if (!active_[i]) {
+          if (result) {
+            cachedValue_.segment (rows_[i], f.outputSize ()).setZero ();
+            valueCache_.valid[i] = false;
+          }
+          if (jacobian) {
+            cachedJacobian_.middleRows (derivativeRows_[i],
+                f.outputDerivativeSize ()).setZero ();
+            jacobianCache_.valid[i] = false;
+          }
+          continue;
+        }
+        const bool computeValue = result &&
+          !valueCache_.reusable (i, supports_[i]);
+        const bool computeJacobian = jacobian &&
+          !jacobianCache_.reusable (i, supports_[i]);
+        if (computeValue && computeJacobian) {
+          HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+              EvaluationStatistics::VALUE_AND_JACOBIAN);
+          f.impl_valueAndJacobian
+            (cachedValue_.segment (rows_[i], f.outputSize ()),
+             cachedJacobian_.middleRows (derivativeRows_[i],
+               f.outputDerivativeSize ()), arg);
+        } else if (computeValue) {
+          HPP_CONSTRAINTS_EVALUATION_SCOPE (f, EvaluationStatistics::VALUE);
+          f.impl_compute (cachedValue_.segment (rows_[i], f.outputSize ()),
+              arg);
+        } else if (computeJacobian) {
+          HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+              EvaluationStatistics::JACOBIAN);
+          f.impl_jacobian (cachedJacobian_.middleRows (derivativeRows_[i],
+                f.outputDerivativeSize ()), arg);
+        }
+        if (result) valueCache_.valid[i] = true;
+        if (jacobian) jacobianCache_.valid[i] = true;
+      }
+      if (result) *result = cachedValue_;
+      if (jacobian) *jacobian = cachedJacobian_;
+    }
+
+    void DifferentiableFunctionStack::impl_jacobianTimes (vectorOut_t result,
+        ConfigurationIn_t arg, vectorIn_t v) const
+    {
+      for (std::size_t i = 0; i < functions_.size(); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        vectorOut_t Jv (result.segment (derivativeRows_[i],
+              f.outputDerivativeSize ()));
+        if (active_[i]) {
+          HPP_CONSTRAINTS_EVALUATION_SCOPE (f,
+              EvaluationStatistics::JACOBIAN);
+          f.impl_jacobianTimes (Jv, arg, v);
+        } else Jv.setZero ();
+      }
+    }
+
+    void DifferentiableFunctionStack::impl_jacobianTransposeTimes
+    (vectorOut_t result, ConfigurationIn_t arg, vectorIn_t w) const
+    {
+      result.setZero ();
+      product_.resize (inputDerivativeSize_);
+      for (std::size_t i = 0; i < functions_.size(); ++i) {
+        if (!active_[i]) continue;
+        const DifferentiableFunction& f = *functions_[i];
+        HPP_CONSTRAINTS_EVALUATION_SCOPE (f, EvaluationStatistics::JACOBIAN);
+        f.impl_jacobianTransposeTimes (product_, arg,
+            w.segment (derivativeRows_[i], f.outputDerivativeSize ()));
+        result += product_;
+      }
+    }
+
+    void DifferentiableFunctionStack::impl_reducedJacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg,
+     const ActiveSubspace& subspace) const
+    {
+      // The other evaluation modes compute the whole jacobian of the stack.
+      if (executor_ || !workspaces_.empty () || robot_ || !leaves_.empty ()
+          || !buckets_.empty ()) {
+        DifferentiableFunction::impl_reducedJacobian (jacobian, arg, subspace);
+        return;
+      }
+      for (std::size_t i = 0; i < functions_.size(); ++i) {
+        const DifferentiableFunction& f = *functions_[i];
+        matrixOut_t::RowsBlockXpr rows (jacobian.middleRows
+            (derivativeRows_[i], f.outputDerivativeSize ()));
+        if (!active_[i] ||
+            !(f.activeDerivativeColumns () && subspace.support ()).any ()) {
+          rows.setZero ();
+          continue;
+        }
+        HPP_CONSTRAINTS_EVALUATION_SCOPE (f, EvaluationStatistics::JACOBIAN);
+        f.impl_reducedJacobian (rows, arg, subspace);
+      }
+    }
+
+#ifdef HPP_CONSTRAINTS_WITH_STATISTICS
+    void DifferentiableFunctionStack::resetStatistics ()
+    {
+      DifferentiableFunction::resetStatistics ();
+      for (std::size_t i = 0; i < functions_.size (); ++i)
+        functions_[i]->resetStatistics ();
+    }
+
+    std::ostream& DifferentiableFunctionStack::printStatistics
+    (std::ostream& os) const
+    {
+      os << name () << ": " << statistics () << std::endl;
+      Functions_t sorted (functions_);
+      std::stable_sort (sorted.begin (), sorted.end (), slower);
+      for (std::size_t i = 0; i < sorted.size (); ++i)
+        os << "  " << sorted[i]->name () << ": " << sorted[i]->statistics ()
+          << std::endl;
+      return os;
+    }
+
+    void DifferentiableFunctionStack::sortByMeasuredCost ()
+    {
+      std::vector <value_type> costs (functions_.size (), -1);
+      value_type time = 0, cost = 0;
+      for (std::size_t i = 0; i < functions_.size (); ++i) {
+        const EvaluationStatistics& s = functions_[i]->statistics ();
+        if (s.nbValues == 0) continue;
+        costs[i] = s.valueTime / (value_type) s.nbValues;
+        time += costs[i];
+        cost += functions_[i]->evaluationCost ();
+      }
+      const value_type timePerCost = (cost > 0 ? time / cost : 1);
+      for (std::size_t i = 0; i < functions_.size (); ++i)
+        if (costs[i] < 0)
+          costs[i] = timePerCost * functions_[i]->evaluationCost ();
+      sortByCosts (costs, satisfactionOrder_);
+    }
+#endif // HPP_CONSTRAINTS_WITH_STATISTICS
+  } // namespace constraints
+} // namespace hpp
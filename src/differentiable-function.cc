@@ -16,36 +16,45 @@
 
 #include <hpp/constraints/differentiable-function.hh>
 
-#include <pinocchio/algorithm/finite-differences.hpp>
+#include <algorithm>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include <pinocchio/algorithm/joint-configuration.hpp>
 
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/liegroup.hh>
 
+#include <hpp/constraints/active-subspace.hh>
+#include <hpp/constraints/executor.hh>
+#include <hpp/constraints/model-metadata.hh>
+#include <hpp/constraints/workspace.hh>
+
 namespace hpp {
   namespace constraints {
     namespace {
-      typedef std::vector<se3::JointIndex> JointIndexVector;
-
-      JointIndexVector fromVelocityRank (const se3::Model& model)
+      inline std::size_t threadId ()
       {
-        JointIndexVector ret (model.nv, 0);
-        for (se3::JointIndex j = 1; j < model.joints.size(); ++j) {
-          const std::size_t i = model.joints[j].idx_v();
-          for (std::size_t k = 0; k < (std::size_t)model.joints[j].nv(); ++k) ret[i+k] = j;
-        }
-        return ret;
+#ifdef _OPENMP
+        return (std::size_t) omp_get_thread_num ();
+#else
+        return 0;
+#endif
       }
 
       struct FiniteDiffRobotOp
       {
         FiniteDiffRobotOp (const DevicePtr_t& r, const value_type& epsilon)
-          : robot(r), model(robot->model()), 
-          // velocityRankToJointIndex (fromVelocityRank(model)),
-          increments(se3::finiteDifferenceIncrement(model)),
+          : robot(r), model(robot->model()),
+          metadata (ModelMetadata::get (robot)),
+          velocityRankToJointIndex (metadata->velocityToJoint ()),
+          increments(metadata->finiteDifferenceIncrements ()),
           epsilon(epsilon),
-          v(robot->numberDof())
+          offset(robot->configSize() - robot->numberDof())
         {}
 
         inline value_type step (const size_type& i, const vector_t& x) const
@@ -54,47 +63,75 @@ namespace hpp {
           value_type r;
           if (i < increments.size()) {
             return increments[i];
-          // if ((std::size_t)i < velocityRankToJointIndex.size()) {
-            // const se3::JointModel& joint
-              // (model.joints[velocityRankToJointIndex[i]]);
-            // r = x.segment(joint.idx_q(), joint.nq()).norm();
           } else {
-            r = std::abs(x[i]);
+            r = std::abs(x[i + offset]);
           }
 
           if (r == 0) return epsilon;
           else        return epsilon * r;
         }
 
+        /// Integrate the velocity h[i] e_i, where e_i is the i-th vector of
+        /// the canonical basis, from x.
+        /// \param velocity scratch vector of size the number of columns.
         template <bool forward>
-        inline void integrate (const vector_t& x, const vector_t& h, const size_type& /*i*/, vector_t& result) const
+        inline void integrate (const vector_t& x, const vector_t& h, const size_type& i, vector_t& result, vector_t& velocity) const
         {
-          using hpp::pinocchio::LieGroupTpl;
           // Use only the joint corresponding to velocity index i
-          if (forward)
-            hpp::pinocchio::integrate<false, LieGroupTpl> (robot, x,  h, result);
-          else
-            hpp::pinocchio::integrate<false, LieGroupTpl> (robot, x, -h, result);
+          if ((std::size_t)i < velocityRankToJointIndex.size()) {
+            const se3::JointModel& joint
+              (model.joints[velocityRankToJointIndex[i]]);
+            if (joint.nq() == joint.nv()) {
+              const size_type k = joint.idx_q() + i - joint.idx_v();
+              result[k] = x[k] + (forward ? h[i] : -h[i]);
+              return;
+            }
+            // Apply the Lie group operation of this joint only.
+            typedef se3::IntegrateStep <hpp::pinocchio::LieGroupTpl>
+              IntegrateStep_t;
+            if (forward)
+              velocity.segment (joint.idx_v(), joint.nv()) =
+                h.segment (joint.idx_v(), joint.nv());
+            else
+              velocity.segment (joint.idx_v(), joint.nv()) =
+                - h.segment (joint.idx_v(), joint.nv());
+            IntegrateStep_t::run (joint,
+                IntegrateStep_t::ArgsType (x, velocity, result));
+          } else {
+            // Extra config space
+            result[i + offset] = x[i + offset] + (forward ? h[i] : -h[i]);
+          }
         }
 
-        inline value_type difference (const vector_t& x0, const vector_t& x1, const size_type& i) const
+        /// result = x + v
+        inline void integrateVelocity (const vector_t& x, const vector_t& v, vector_t& result) const
         {
-          hpp::pinocchio::difference (robot, x0, x1, v);
-          return v[i];
+          using hpp::pinocchio::LieGroupTpl;
+          hpp::pinocchio::integrate<false, LieGroupTpl> (robot, x, v, result);
         }
 
-        inline void reset (const vector_t& x, const size_type& /*i*/, vector_t& result) const
+        inline void reset (const vector_t& x, const size_type& i, vector_t& result) const
         {
           // Use only the joint corresponding to velocity index i
-          result = x;
+          if ((std::size_t)i < velocityRankToJointIndex.size()) {
+            const se3::JointModel& joint
+              (model.joints[velocityRankToJointIndex[i]]);
+            result.segment (joint.idx_q(), joint.nq()) =
+              x.segment (joint.idx_q(), joint.nq());
+          } else {
+            result[i + offset] = x[i + offset];
+          }
         }
 
         const DevicePtr_t& robot;
         const se3::Model& model;
-        // const JointIndexVector velocityRankToJointIndex;
-        const vector_t increments;
+        const ModelMetadataConstPtr_t metadata;
+        const ModelMetadata::JointIndices_t& velocityRankToJointIndex;
+        const vector_t& increments;
         const value_type& epsilon;
-        mutable vector_t v;
+        /// Difference between the configuration and velocity indices of
+        /// the extra config space.
+        const size_type offset;
       };
 
       struct FiniteDiffVectorSpaceOp
@@ -110,14 +147,15 @@ namespace hpp {
         }
 
         template <bool forward>
-        inline void integrate (const vector_t& x, const vector_t& h, const size_type& i, vector_t& result) const
+        inline void integrate (const vector_t& x, const vector_t& h, const size_type& i, vector_t& result, vector_t& /* velocity */) const
         {
           result[i] = x[i] + (forward ? h[i] : -h[i]);
         }
 
-        inline value_type difference (const vector_t& x0, const vector_t& x1, const size_type& i) const
+        /// result = x + v
+        inline void integrateVelocity (const vector_t& x, const vector_t& v, vector_t& result) const
         {
-          return x0[i] - x1[i];
+          result = x + v;
         }
 
         inline void reset (const vector_t& x, const size_type& i, vector_t& result) const
@@ -128,25 +166,45 @@ namespace hpp {
         const value_type& epsilon;
       };
 
-      template <typename FiniteDiffOp, typename Function>
-        void finiteDiffCentral(matrixOut_t jacobian, vectorIn_t x,
-            const FiniteDiffOp& op, const Function& f)
+      inline void evaluate (const DifferentiableFunction& f,
+          vectorOut_t result, vectorIn_t x, Workspace* workspace)
+      {
+        if (workspace) f (result, x, *workspace);
+        else           f (result, x);
+      }
+
+      /// Columns are spread between threads if workspaces are given: thread
+      /// i evaluates the function with workspaces [i].
+      template <typename FiniteDiffOp>
+        void finiteDiffCentral(matrixOut_t jacobian, vectorIn_t arg,
+            const FiniteDiffOp& op, const DifferentiableFunction& f,
+            const std::vector <WorkspacePtr_t>& workspaces)
         {
-          size_type n = jacobian.cols();
+          const int n = (int) jacobian.cols();
+          const std::size_t nbThreads =
+            std::max (workspaces.size (), (std::size_t) 1);
+          // The operations take a vector_t: copy arg once.
+          const vector_t x (arg);
+#pragma omp parallel num_threads(nbThreads)
+          {
           vector_t x_pdx = x;
           vector_t x_mdx = x;
           vector_t h = vector_t::Zero (jacobian.cols());
+          vector_t velocity = vector_t::Zero (jacobian.cols());
           vector_t f_x_mdx (jacobian.rows()),
                    f_x_pdx (jacobian.rows());
+          Workspace* workspace =
+            workspaces.empty () ? NULL : workspaces[threadId ()].get ();
 
-          for (size_type j = 0; j < n; ++j) {
+#pragma omp for schedule(static)
+          for (int j = 0; j < n; ++j) {
             h[j] = op.step(j, x);
 
-            op.template integrate<false>(x, h, j, x_mdx);
-            f (f_x_mdx, x_mdx);
+            op.template integrate<false>(x, h, j, x_mdx, velocity);
+            evaluate (f, f_x_mdx, x_mdx, workspace);
 
-            op.template integrate<true >(x, h, j, x_pdx);
-            f (f_x_pdx, x_pdx);
+            op.template integrate<true >(x, h, j, x_pdx, velocity);
+            evaluate (f, f_x_pdx, x_pdx, workspace);
 
             jacobian.col (j) = ((f_x_pdx - f_x_mdx) / h[j]) / 2;
 
@@ -154,58 +212,381 @@ namespace hpp {
             op.reset(x, j, x_pdx);
             h[j] = 0;
           }
+          }
           if (jacobian.hasNaN ()) {
             hppDout (error, "Central finite difference: NaN");
           }
         }
 
-      template <typename FiniteDiffOp, typename Function>
-        void finiteDiffForward(matrixOut_t jacobian, vectorIn_t x,
-            const FiniteDiffOp& op, const Function& f)
+      template <typename FiniteDiffOp>
+        void finiteDiffForward(matrixOut_t jacobian, vectorIn_t arg,
+            const FiniteDiffOp& op, const DifferentiableFunction& f,
+            const std::vector <WorkspacePtr_t>& workspaces)
         {
-          size_type n = jacobian.cols();
+          const int n = (int) jacobian.cols();
+          const std::size_t nbThreads =
+            std::max (workspaces.size (), (std::size_t) 1);
+          // The operations take a vector_t: copy arg once.
+          const vector_t x (arg);
+          vector_t f_x (jacobian.rows());
+
+          evaluate (f, f_x, x,
+              workspaces.empty () ? NULL : workspaces[0].get ());
+
+#pragma omp parallel num_threads(nbThreads)
+          {
           vector_t x_dx = x;
           vector_t h = vector_t::Zero (jacobian.cols());
-          vector_t f_x     (jacobian.rows()),
-                   f_x_pdx (jacobian.rows());
-
-          f (f_x, x);
+          vector_t velocity = vector_t::Zero (jacobian.cols());
+          vector_t f_x_pdx (jacobian.rows());
+          Workspace* workspace =
+            workspaces.empty () ? NULL : workspaces[threadId ()].get ();
 
-          for (size_type j = 0; j < n; ++j) {
+#pragma omp for schedule(static)
+          for (int j = 0; j < n; ++j) {
             h[j] = op.step(j, x);
 
-            op.template integrate<true >(x, h, j, x_dx);
-            f (f_x_pdx, x_dx);
+            op.template integrate<true >(x, h, j, x_dx, velocity);
+            evaluate (f, f_x_pdx, x_dx, workspace);
 
             jacobian.col (j) = (f_x_pdx - f_x) / h[j];
 
             op.reset(x, j, x_dx);
             h[j] = 0;
           }
+          }
+          if (jacobian.hasNaN ()) {
+            hppDout (warning, "Finite difference of \"" << f.name() << "\" has NaN values.");
+          }
+        }
+
+      /// Finite difference restricted to the columns or the directions of
+      /// a subspace.
+      template <typename FiniteDiffOp>
+        void finiteDiffSubspace(matrixOut_t jacobian, vectorIn_t arg,
+            const FiniteDiffOp& op, const DifferentiableFunction& f,
+            const ActiveSubspace& subspace, bool central, value_type eps)
+        {
+          const vector_t x (arg);
+          vector_t x_pdx = x;
+          vector_t x_mdx = x;
+          vector_t f_x (jacobian.rows()), f_x_pdx (jacobian.rows()),
+                   f_x_mdx (jacobian.rows());
+          if (!central) f (f_x, x);
+
+          if (subspace.isSelection ()) {
+            const ActiveSubspace::Columns_t& columns = subspace.columns ();
+            vector_t h = vector_t::Zero (subspace.size ());
+            vector_t velocity = vector_t::Zero (subspace.size ());
+            for (std::size_t k = 0; k < columns.size (); ++k) {
+              const size_type j = columns[k];
+              h[j] = op.step(j, x);
+              op.template integrate<true >(x, h, j, x_pdx, velocity);
+              f (f_x_pdx, x_pdx);
+              if (central) {
+                op.template integrate<false>(x, h, j, x_mdx, velocity);
+                f (f_x_mdx, x_mdx);
+                jacobian.col (k) = ((f_x_pdx - f_x_mdx) / h[j]) / 2;
+                op.reset(x, j, x_mdx);
+              } else {
+                jacobian.col (k) = (f_x_pdx - f_x) / h[j];
+              }
+              op.reset(x, j, x_pdx);
+              h[j] = 0;
+            }
+          } else {
+            const matrix_t& S = subspace.selection ();
+            vector_t v (S.rows ());
+            for (size_type k = 0; k < S.cols (); ++k) {
+              const value_type norm = S.col (k).norm ();
+              if (norm == 0) {
+                jacobian.col (k).setZero ();
+                continue;
+              }
+              // Move by eps along the direction, whatever its scale.
+              const value_type h = eps / norm;
+              v = h * S.col (k);
+              op.integrateVelocity (x, v, x_pdx);
+              f (f_x_pdx, x_pdx);
+              if (central) {
+                v = - v;
+                op.integrateVelocity (x, v, x_mdx);
+                f (f_x_mdx, x_mdx);
+                jacobian.col (k) = ((f_x_pdx - f_x_mdx) / h) / 2;
+              } else {
+                jacobian.col (k) = (f_x_pdx - f_x) / h;
+              }
+            }
+          }
+          if (jacobian.hasNaN ()) {
+            hppDout (warning, "Finite difference of \"" << f.name() << "\" has NaN values.");
+          }
+        }
+
+      typedef std::vector <std::vector <size_type> > ColumnGroups_t;
+
+      /// Group the columns so that the columns of a group have no row in
+      /// common in pattern. Greedy coloring, in the order of the columns.
+      /// Columns without non zero coefficient are in no group.
+      void groupColumns (const ArrayXXb& pattern, ColumnGroups_t& groups)
+      {
+        groups.clear ();
+        std::vector <ArrayXb> rows;
+        for (size_type j = 0; j < pattern.cols (); ++j) {
+          if (!pattern.col (j).any ()) continue;
+          std::size_t c = 0;
+          while (c < groups.size () && (rows[c] && pattern.col (j)).any ())
+            ++c;
+          if (c == groups.size ()) {
+            groups.push_back (std::vector <size_type> ());
+            rows.push_back (ArrayXb::Constant (pattern.rows (), false));
+          }
+          groups[c].push_back (j);
+          rows[c] = rows[c] || pattern.col (j);
+        }
+      }
+
+      template <typename FiniteDiffOp>
+        void finiteDiffColored(matrixOut_t jacobian, vectorIn_t arg,
+            const FiniteDiffOp& op, const DifferentiableFunction& f,
+            const std::vector <WorkspacePtr_t>& workspaces)
+        {
+          // The operations take a vector_t: copy arg once.
+          const vector_t x (arg);
+          ArrayXXb pattern;
+          f.jacobianPattern (pattern);
+          ColumnGroups_t groups;
+          groupColumns (pattern, groups);
+
+          const int n = (int) groups.size();
+          const std::size_t nbThreads =
+            std::max (workspaces.size (), (std::size_t) 1);
+          vector_t f_x (jacobian.rows());
+
+          jacobian.setZero ();
+          evaluate (f, f_x, x,
+              workspaces.empty () ? NULL : workspaces[0].get ());
+
+#pragma omp parallel num_threads(nbThreads)
+          {
+          vector_t x_dx = x;
+          vector_t h = vector_t::Zero (jacobian.cols());
+          vector_t velocity = vector_t::Zero (jacobian.cols());
+          vector_t f_x_pdx (jacobian.rows());
+          Workspace* workspace =
+            workspaces.empty () ? NULL : workspaces[threadId ()].get ();
+
+#pragma omp for schedule(dynamic)
+          for (int g = 0; g < n; ++g) {
+            const std::vector <size_type>& group = groups[g];
+            for (std::size_t k = 0; k < group.size (); ++k)
+              h[group[k]] = op.step(group[k], x);
+            for (std::size_t k = 0; k < group.size (); ++k)
+              op.template integrate<true >(x, h, group[k], x_dx, velocity);
+            evaluate (f, f_x_pdx, x_dx, workspace);
+
+            // The rows of the columns of a group are disjoint.
+            for (std::size_t k = 0; k < group.size (); ++k) {
+              const size_type j = group[k];
+              for (size_type r = 0; r < jacobian.rows (); ++r)
+                if (pattern (r, j))
+                  jacobian (r, j) = (f_x_pdx[r] - f_x[r]) / h[j];
+              op.reset(x, j, x_dx);
+              h[j] = 0;
+            }
+          }
+          }
           if (jacobian.hasNaN ()) {
             hppDout (warning, "Finite difference of \"" << f.name() << "\" has NaN values.");
           }
         }
+
+      /// Workspaces of the threads, empty if the evaluation is sequential.
+      std::vector <WorkspacePtr_t> finiteDiffWorkspaces
+      (const DifferentiableFunction& f, const DevicePtr_t& robot,
+       std::size_t nbThreads)
+      {
+        std::vector <WorkspacePtr_t> workspaces;
+        if (!robot || nbThreads <= 1 || !f.threadSafe ()) return workspaces;
+        workspaces.resize (nbThreads);
+        for (std::size_t i = 0; i < nbThreads; ++i)
+          workspaces[i] = Workspace::create (robot);
+        return workspaces;
+      }
+    }
+
+    void DifferentiableFunction::reducedJacobian (matrixOut_t jacobian,
+        vectorIn_t argument, const ActiveSubspace& subspace) const
+    {
+      assert (argument.size () == inputSize ());
+      assert (subspace.size () == inputDerivativeSize ());
+      assert (jacobian.rows () == outputDerivativeSize ());
+      assert (jacobian.cols () == subspace.dimension ());
+      HPP_CONSTRAINTS_EVALUATION_SCOPE (*this,
+          EvaluationStatistics::JACOBIAN);
+      impl_reducedJacobian (jacobian, argument, subspace);
+    }
+
+    void DifferentiableFunction::impl_reducedJacobian (matrixOut_t jacobian,
+        vectorIn_t arg, const ActiveSubspace& subspace) const
+    {
+      jacobianBuffer_.resize (outputDerivativeSize_, inputDerivativeSize_);
+      impl_jacobian (jacobianBuffer_, arg);
+      subspace.reduce (jacobianBuffer_, jacobian);
+    }
+
+    MemoryUsage DifferentiableFunction::memoryUsage () const
+    {
+      MemoryUsage m;
+      m.definition = sizeof (DifferentiableFunction) + memorySize (name_)
+        + memorySize (context_) + memorySize (activeDerivativeColumns_);
+      m.scratch = memorySize (valueBuffer_) + memorySize (jacobianBuffer_);
+      return m;
+    }
+
+    bool DifferentiableFunction::impl_isSatisfied (vectorIn_t arg,
+        value_type threshold) const
+    {
+      valueBuffer_.resize (outputSize_);
+      (*this) (valueBuffer_, arg);
+      return valueBuffer_.squaredNorm () <= threshold * threshold;
+    }
+
+    void DifferentiableFunction::impl_jacobianTimes (vectorOut_t result,
+        vectorIn_t arg, vectorIn_t v) const
+    {
+      jacobianBuffer_.resize (outputDerivativeSize_, inputDerivativeSize_);
+      impl_jacobian (jacobianBuffer_, arg);
+      result.noalias () = jacobianBuffer_ * v;
+    }
+
+    void DifferentiableFunction::impl_jacobianTransposeTimes
+    (vectorOut_t result, vectorIn_t arg, vectorIn_t w) const
+    {
+      jacobianBuffer_.resize (outputDerivativeSize_, inputDerivativeSize_);
+      impl_jacobian (jacobianBuffer_, arg);
+      result.noalias () = jacobianBuffer_.transpose () * w;
+    }
+
+    void DifferentiableFunction::impl_hessianTimes (vectorOut_t result,
+        vectorIn_t arg, vectorIn_t r, vectorIn_t v, const DevicePtr_t& robot)
+      const
+    {
+      const value_type norm = v.norm ();
+      if (norm == 0) {
+        result.setZero ();
+        return;
+      }
+      // The step is taken along v / |v| so that its length does not depend
+      // on the scale of v.
+      const value_type eps =
+        std::pow (Eigen::NumTraits<value_type>::epsilon (), 1./3);
+      const value_type h = eps / norm;
+      vector_t qPlus (arg.size ()), qMinus (arg.size ()),
+               JtrMinus (inputDerivativeSize_);
+      if (robot) {
+        using hpp::pinocchio::LieGroupTpl;
+        hpp::pinocchio::integrate<false, LieGroupTpl>
+          (robot, arg,  h * v, qPlus);
+        hpp::pinocchio::integrate<false, LieGroupTpl>
+          (robot, arg, -h * v, qMinus);
+      } else {
+        assert (inputSize_ == inputDerivativeSize_);
+        qPlus  = arg + h * v;
+        qMinus = arg - h * v;
+      }
+      impl_jacobianTransposeTimes (result, qPlus, r);
+      impl_jacobianTransposeTimes (JtrMinus, qMinus, r);
+      result -= JtrMinus;
+      result /= 2 * h;
+    }
+
+    void DifferentiableFunction::activateJointColumns
+    (const JointConstPtr_t& joint)
+    {
+      if (!joint) return;
+      const ArrayXb& support
+        (ModelMetadata::get (joint->robot ())->support (joint->index ()));
+      activeDerivativeColumns_.head (support.size ()) =
+        activeDerivativeColumns_.head (support.size ()) || support;
+    }
+
+    void DifferentiableFunction::activateRelativeColumns
+    (const JointConstPtr_t& joint1, const JointConstPtr_t& joint2)
+    {
+      if (!joint1 || !joint2) {
+        activateJointColumns (joint1);
+        activateJointColumns (joint2);
+        return;
+      }
+      ModelMetadataConstPtr_t metadata (ModelMetadata::get (joint1->robot ()));
+      const ArrayXb& s1 (metadata->support (joint1->index ()));
+      const ArrayXb& s2 (metadata->support (joint2->index ()));
+      assert (s1.size () == s2.size ());
+      activeDerivativeColumns_.head (s1.size ()) =
+        activeDerivativeColumns_.head (s1.size ()) || (s1 != s2);
     }
 
     void DifferentiableFunction::finiteDifferenceForward
       (matrixOut_t jacobian, vectorIn_t x,
-       DevicePtr_t robot, value_type eps) const
+       DevicePtr_t robot, value_type eps, std::size_t nbThreads) const
       {
+        const std::vector <WorkspacePtr_t> workspaces
+          (finiteDiffWorkspaces (*this, robot, nbThreads));
         if (robot)
-          finiteDiffForward(jacobian, x, FiniteDiffRobotOp(robot, eps), *this);
+          finiteDiffForward(jacobian, x, FiniteDiffRobotOp(robot, eps), *this,
+              workspaces);
         else
-          finiteDiffForward(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this);
+          finiteDiffForward(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this,
+              workspaces);
       }
 
     void DifferentiableFunction::finiteDifferenceCentral
       (matrixOut_t jacobian, vectorIn_t x,
-       DevicePtr_t robot, value_type eps) const
+       DevicePtr_t robot, value_type eps, std::size_t nbThreads) const
+      {
+        const std::vector <WorkspacePtr_t> workspaces
+          (finiteDiffWorkspaces (*this, robot, nbThreads));
+        if (robot)
+          finiteDiffCentral(jacobian, x, FiniteDiffRobotOp(robot, eps), *this,
+              workspaces);
+        else
+          finiteDiffCentral(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this,
+              workspaces);
+      }
+
+    EvaluationFuture DifferentiableFunction::evaluateAsync
+    (vectorIn_t argument, Executor& executor, bool computeJacobian) const
+    {
+      return executor.submit (*this, argument, computeJacobian);
+    }
+
+    void DifferentiableFunction::finiteDifference
+      (matrixOut_t jacobian, vectorIn_t x, const ActiveSubspace& subspace,
+       bool central, DevicePtr_t robot, value_type eps) const
+      {
+        assert (subspace.size () == inputDerivativeSize ());
+        assert (jacobian.cols () == subspace.dimension ());
+        if (robot)
+          finiteDiffSubspace(jacobian, x, FiniteDiffRobotOp(robot, eps), *this,
+              subspace, central, eps);
+        else
+          finiteDiffSubspace(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this,
+              subspace, central, eps);
+      }
+
+    void DifferentiableFunction::finiteDifferenceColored
+      (matrixOut_t jacobian, vectorIn_t x,
+       DevicePtr_t robot, value_type eps, std::size_t nbThreads) const
       {
+        const std::vector <WorkspacePtr_t> workspaces
+          (finiteDiffWorkspaces (*this, robot, nbThreads));
         if (robot)
-          finiteDiffCentral(jacobian, x, FiniteDiffRobotOp(robot, eps), *this);
+          finiteDiffColored(jacobian, x, FiniteDiffRobotOp(robot, eps), *this,
+              workspaces);
         else
-          finiteDiffCentral(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this);
+          finiteDiffColored(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this,
+              workspaces);
       }
   } // namespace constraints
 } // namespace hpp
@@ -19,14 +19,212 @@
 
 #include <hpp/constraints/distance-between-bodies.hh>
 
-#include <pinocchio/algorithm/geometry.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include <hpp/fcl/distance.h>
+#include <pinocchio/multibody/fcl.hpp>
 
 #include <hpp/pinocchio/body.hh>
+#include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/liegroup.hh>
+
+#include <hpp/constraints/bounding-spheres.hh>
+#include <hpp/constraints/geometry-placements.hh>
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/lipschitz.hh>
+#include <hpp/constraints/workspace.hh>
 
 namespace hpp {
   namespace constraints {
+    namespace {
+      typedef std::vector <fcl::DistanceResult> DistanceResults_t;
+
+      /// Compute the exact distance of a collision pair.
+      value_type computeDistance (const se3::GeometryModel& model,
+          const GeometryPlacements& placements, std::size_t pair,
+          const fcl::DistanceRequest& request, fcl::DistanceResult& result)
+      {
+        const se3::GeomIndex i1 = model.collisionPairs [pair].first;
+        const se3::GeomIndex i2 = model.collisionPairs [pair].second;
+        result.clear ();
+        fcl::distance (model.geometryObjects [i1].fcl.get (),
+            se3::toFclTransform3f (placements.placement (i1)),
+            model.geometryObjects [i2].fcl.get (),
+            se3::toFclTransform3f (placements.placement (i2)),
+            request, result);
+        return result.min_distance;
+      }
+
+      /// Compute the distance of the given collision pairs with
+      /// nbThreads threads.
+      /// \return the position in pairs of the closest pair.
+      ///
+      /// Each pair writes its own element of results, so the threads do
+      /// not share any output.
+      std::size_t computeDistances (const se3::GeometryModel& model,
+          const GeometryPlacements& placements,
+          const std::vector <std::size_t>& pairs,
+          const fcl::DistanceRequest& request, DistanceResults_t& results,
+          std::size_t nbThreads)
+      {
+        const int n = (int) pairs.size ();
+#pragma omp parallel for schedule(dynamic) num_threads(nbThreads)
+        for (int i = 0; i < n; ++i)
+          computeDistance (model, placements, pairs [i], request,
+              results [i]);
+        HPP_CONSTRAINTS_STATISTICS (
+            if (EvaluationStatistics* s = EvaluationStatistics::current ())
+              s->nbNarrowPhases += pairs.size ();
+            );
+
+        std::size_t minIndex = pairs.size ();
+        value_type minDistance = std::numeric_limits <value_type>::infinity ();
+        for (int i = 0; i < n; ++i) {
+          const value_type d = results [i].min_distance;
+          if (d < minDistance) {
+            minDistance = d;
+            minIndex = i;
+          }
+        }
+        return minIndex;
+      }
+
+      typedef std::pair <value_type, std::size_t> Bound_t;
+      typedef std::vector <Bound_t> Bounds_t;
+
+      /// Lower bound of the distance of a collision pair, from the bounding
+      /// spheres of the geometries.
+      value_type lowerBound (const se3::GeometryModel& model,
+          const GeometryPlacements& placements, std::size_t pair)
+      {
+        const se3::GeomIndex i1 = model.collisionPairs [pair].first;
+        const se3::GeomIndex i2 = model.collisionPairs [pair].second;
+        const fcl::CollisionGeometry& g1 = *model.geometryObjects [i1].fcl;
+        const fcl::CollisionGeometry& g2 = *model.geometryObjects [i2].fcl;
+        const vector3_t c1 = placements.placement (i1).act (vector3_t
+            (g1.aabb_center [0], g1.aabb_center [1], g1.aabb_center [2]));
+        const vector3_t c2 = placements.placement (i2).act (vector3_t
+            (g2.aabb_center [0], g2.aabb_center [1], g2.aabb_center [2]));
+        return (c1 - c2).norm () - g1.aabb_radius - g2.aabb_radius;
+      }
+
+      /// Record an exact distance computation.
+      inline void countNarrowPhase ()
+      {
+        HPP_CONSTRAINTS_STATISTICS (
+            if (EvaluationStatistics* s = EvaluationStatistics::current ())
+              ++s->nbNarrowPhases;
+            );
+      }
+
+      /// Find the closest collision pair.
+      /// \param previous position in pairs of the closest pair at the
+      ///        previous configuration, which is computed first.
+      /// \param bounds buffer.
+      /// \return the position in pairs of the closest pair.
+      ///
+      /// The exact distance is computed by increasing lower bound, until the
+      /// lower bound exceeds the smallest distance minus the absolute error
+      /// of request. The distance results of the other pairs are not up to
+      /// date.
+      std::size_t closestPair (const se3::GeometryModel& model,
+          const GeometryPlacements& placements,
+          const std::vector <std::size_t>& pairs,
+          const fcl::DistanceRequest& request, DistanceResults_t& results,
+          std::size_t previous, Bounds_t& bounds)
+      {
+        std::size_t minIndex = pairs.size ();
+        value_type minDistance = std::numeric_limits <value_type>::infinity ();
+        if (previous < pairs.size ()) {
+          minDistance = computeDistance (model, placements, pairs [previous],
+              request, results [previous]);
+          minIndex = previous;
+          countNarrowPhase ();
+        }
+        bounds.clear ();
+        for (std::size_t i = 0; i < pairs.size (); ++i) {
+          if (i == previous) continue;
+          const value_type lb = lowerBound (model, placements, pairs [i]);
+          if (lb < minDistance - request.abs_err)
+            bounds.push_back (Bound_t (lb, i));
+        }
+        // Pop the pairs by increasing lower bound.
+        std::make_heap (bounds.begin (), bounds.end (), std::greater <Bound_t> ());
+        while (!bounds.empty ()
+            && bounds.front ().first < minDistance - request.abs_err) {
+          const std::size_t i = bounds.front ().second;
+          std::pop_heap (bounds.begin (), bounds.end (), std::greater <Bound_t> ());
+          bounds.pop_back ();
+          const value_type d = computeDistance (model, placements, pairs [i],
+              request, results [i]);
+          countNarrowPhase ();
+          if (d < minDistance) {
+            minDistance = d;
+            minIndex = i;
+          }
+        }
+        return minIndex;
+      }
+
+      /// Compute the distance between the spheres covering the geometries
+      /// of a collision pair. The witness points are on the closest spheres.
+      value_type approximateDistance (const se3::GeometryModel& model,
+          const GeometryPlacements& placements,
+          const std::vector <BoundingSpheres_t>& spheres, std::size_t pair,
+          fcl::DistanceResult& result)
+      {
+        const se3::GeomIndex i1 = model.collisionPairs [pair].first;
+        const se3::GeomIndex i2 = model.collisionPairs [pair].second;
+        const Transform3f& M1 = placements.placement (i1);
+        const Transform3f& M2 = placements.placement (i2);
+        result.min_distance = std::numeric_limits <value_type>::infinity ();
+        for (std::size_t k1 = 0; k1 < spheres [i1].size (); ++k1) {
+          const BoundingSphere& s1 = spheres [i1][k1];
+          const vector3_t c1 (M1.act (s1.center));
+          for (std::size_t k2 = 0; k2 < spheres [i2].size (); ++k2) {
+            const BoundingSphere& s2 = spheres [i2][k2];
+            const vector3_t c2 (M2.act (s2.center));
+            vector3_t u (c1 - c2);
+            const value_type n = u.norm ();
+            const value_type d = n - s1.radius - s2.radius;
+            if (d >= result.min_distance) continue;
+            // P1 - P2 = d u, so that the jacobian of the exact model
+            // applies.
+            if (n > 0) u /= n;
+            else u = vector3_t::UnitX ();
+            result.min_distance = d;
+            result.nearest_points [0] = c1 - s1.radius * u;
+            result.nearest_points [1] = c2 + s2.radius * u;
+          }
+        }
+        return result.min_distance;
+      }
+
+      /// Find the closest collision pair of the approximate model.
+      /// \return the position in pairs of the closest pair.
+      std::size_t closestApproximatePair (const se3::GeometryModel& model,
+          const GeometryPlacements& placements,
+          const std::vector <BoundingSpheres_t>& spheres,
+          const std::vector <std::size_t>& pairs, DistanceResults_t& results)
+      {
+        std::size_t minIndex = pairs.size ();
+        value_type minDistance = std::numeric_limits <value_type>::infinity ();
+        for (std::size_t i = 0; i < pairs.size (); ++i) {
+          const value_type d = approximateDistance (model, placements,
+              spheres, pairs [i], results [i]);
+          if (d < minDistance) {
+            minDistance = d;
+            minIndex = i;
+          }
+        }
+        return minIndex;
+      }
+    } // namespace
 
     DistanceBetweenBodiesPtr_t DistanceBetweenBodies::create
     (const std::string& name, const DevicePtr_t& robot,
@@ -62,88 +260,368 @@ namespace hpp {
     (const std::string& name, const DevicePtr_t& robot,
      const JointPtr_t& joint1, const JointPtr_t& joint2) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
-			      name), robot_ (robot), joint1_ (joint1),
+			      name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), joint1_ (joint1),
       joint2_ (joint2),
-      data_ (robot->geomModel())
+      placements_ (GeometryPlacements::get (kinematics_)), nbThreads_ (1),
+      minIndex_ (std::numeric_limits <std::size_t>::max ()),
+      version_ (std::numeric_limits <std::size_t>::max ()),
+      approximate_ (false), request_ (true)
     {
       ObjectVector_t objs1 (joint1_->linkedBody ()->innerObjects ());
       ObjectVector_t objs2 (joint2_->linkedBody ()->innerObjects ());
       initGeomData(objs1.begin(), objs1.end(), objs2.begin(), objs2.end());
+      activeDerivativeColumns_.setConstant (false);
+      activateJointColumns (joint1_);
+      activateJointColumns (joint2_);
     }
 
     DistanceBetweenBodies::DistanceBetweenBodies
     (const std::string& name, const DevicePtr_t& robot,
      const JointPtr_t& joint, const ObjectVector_t& objects) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
-			      name), robot_ (robot), joint1_ (joint),
-      joint2_ (), data_ (robot->geomModel())
+			      name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), joint1_ (joint),
+      joint2_ (), placements_ (GeometryPlacements::get (kinematics_)),
+      nbThreads_ (1), minIndex_ (std::numeric_limits <std::size_t>::max ()),
+      version_ (std::numeric_limits <std::size_t>::max ()),
+      approximate_ (false), request_ (true)
     {
       ObjectVector_t objs1 (joint1_->linkedBody ()->innerObjects ());
       initGeomData(objs1.begin(), objs1.end(), objects.begin(), objects.end());
+      activeDerivativeColumns_.setConstant (false);
+      activateJointColumns (joint1_);
     }
 
     DistanceBetweenBodies::DistanceBetweenBodies
     (const std::string& name, const DevicePtr_t& robot,
      const JointPtr_t& joint, const std::vector<CollisionObjectPtr_t>& objects) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
-			      name), robot_ (robot), joint1_ (joint),
-      joint2_ (), data_ (robot->geomModel())
+			      name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), joint1_ (joint),
+      joint2_ (), placements_ (GeometryPlacements::get (kinematics_)),
+      nbThreads_ (1), minIndex_ (std::numeric_limits <std::size_t>::max ()),
+      version_ (std::numeric_limits <std::size_t>::max ()),
+      approximate_ (false), request_ (true)
     {
       ObjectVector_t objs1 (joint1_->linkedBody ()->innerObjects ());
       initGeomData(objs1.begin(), objs1.end(), objects.begin(), objects.end());
+      activeDerivativeColumns_.setConstant (false);
+      activateJointColumns (joint1_);
+    }
+
+    void DistanceBetweenBodies::updateDistances (ConfigurationIn_t argument,
+        int quantities) const
+    {
+      kinematics_->update (argument, quantities);
+      // The distance results, including the witness points, are valid as
+      // long as the forward kinematics has not been recomputed.
+      if (version_ == kinematics_->version ()) return;
+      placements_->update (geometries_);
+      if (approximate_)
+        minIndex_ = closestApproximatePair (robot_->geomModel(),
+            *placements_, spheres_, activePairs_, results_);
+      else if (nbThreads_ > 1)
+        minIndex_ = computeDistances (robot_->geomModel(), *placements_,
+            activePairs_, request_, results_, nbThreads_);
+      else
+        minIndex_ = closestPair (robot_->geomModel(), *placements_,
+            activePairs_, request_, results_, minIndex_, bounds_);
+      version_ = kinematics_->version ();
     }
 
     void DistanceBetweenBodies::impl_compute
     (vectorOut_t result, ConfigurationIn_t argument) const throw ()
     {
-      if ((argument.rows () == latestArgument_.rows ()) &&
-	  (argument == latestArgument_)) {
-	result = latestResult_;
-	return;
-      }
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
-      se3::updateGeometryPlacements(robot_->model(), robot_->data(), robot_->geomModel(), data_);
-      minIndex_ = se3::computeDistances(robot_->geomModel(), data_);
-      result [0] = data_.distanceResults[minIndex_].min_distance;
-      latestArgument_ = argument;
-      latestResult_ = result;
+      updateDistances (argument, KinematicsCache::PLACEMENTS);
+      result [0] = results_ [minIndex_].min_distance;
     }
 
     void DistanceBetweenBodies::impl_jacobian
     (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
     {
-      vector_t dist; dist.resize (1);
-      impl_compute (dist, arg);
-      const JointJacobian_t& J1 (joint1_->jacobian());
-      const Transform3f& M1 (joint1_->currentTransformation());
+      updateDistances (arg, KinematicsCache::JACOBIANS);
+      computeJacobian (jacobian, joint1_, joint2_, results_ [minIndex_]);
+    }
+
+    namespace {
+      struct DistanceBetweenBodiesData : Workspace::FunctionData
+      {
+        DistanceBetweenBodiesData (const GeometryPlacementsPtr_t& p,
+            std::size_t nbPairs) :
+          placements (p), results (nbPairs),
+          minIndex (std::numeric_limits <std::size_t>::max ()),
+          version (std::numeric_limits <std::size_t>::max ()),
+          approximate (false), accuracy (0) {}
+        /// Placements of the geometries of the robot of the workspace.
+        GeometryPlacementsPtr_t placements;
+        DistanceResults_t results;
+        std::size_t minIndex;
+        Bounds_t bounds;
+        /// Version of the kinematics cache of the workspace data was
+        /// computed at.
+        std::size_t version;
+        /// Whether the results are those of the approximate model.
+        bool approximate;
+        /// Absolute error of the distance computations of the results.
+        value_type accuracy;
+      };
+
+      /// Compute the distance with the robot of the workspace.
+      DistanceBetweenBodiesData& computeDistance
+      (const DifferentiableFunction& f, const std::vector <std::size_t>& pairs,
+       const GeometryPlacements::Geometries_t& geometries,
+       const std::vector <BoundingSpheres_t>* spheres,
+       const fcl::DistanceRequest& request,
+       ConfigurationIn_t argument, int quantities, Workspace& workspace)
+      {
+        Workspace::FunctionDataPtr_t& ptr = workspace.data (f);
+        const KinematicsCachePtr_t& kinematics = workspace.kinematics ();
+        if (!ptr) ptr.reset (new DistanceBetweenBodiesData
+            (GeometryPlacements::get (kinematics), pairs.size ()));
+        DistanceBetweenBodiesData& d =
+          static_cast <DistanceBetweenBodiesData&> (*ptr);
+        kinematics->update (argument, quantities);
+        const bool approximate = (spheres != NULL);
+        if (d.version == kinematics->version ()
+            && d.approximate == approximate
+            && d.accuracy == request.abs_err) return d;
+        d.placements->update (geometries);
+        if (approximate)
+          d.minIndex = closestApproximatePair (workspace.robot ()->geomModel(),
+              *d.placements, *spheres, pairs, d.results);
+        else
+          d.minIndex = closestPair (workspace.robot ()->geomModel(),
+              *d.placements, pairs, request, d.results, d.minIndex,
+              d.bounds);
+        d.version = kinematics->version ();
+        d.approximate = approximate;
+        d.accuracy = request.abs_err;
+        return d;
+      }
+    } // namespace
+
+    void DistanceBetweenBodies::impl_compute
+    (vectorOut_t result, ConfigurationIn_t argument, Workspace& workspace)
+      const throw ()
+    {
+      const DistanceBetweenBodiesData& d =
+        computeDistance (*this, activePairs_, geometries_,
+            approximate_ ? &spheres_ : NULL, request_, argument,
+            KinematicsCache::PLACEMENTS, workspace);
+      result [0] = d.results [d.minIndex].min_distance;
+    }
+
+    void DistanceBetweenBodies::impl_jacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg, Workspace& workspace)
+      const throw ()
+    {
+      const DistanceBetweenBodiesData& d =
+        computeDistance (*this, activePairs_, geometries_,
+            approximate_ ? &spheres_ : NULL, request_, arg,
+            KinematicsCache::JACOBIANS, workspace);
+      computeJacobian (jacobian, workspace.joint (joint1_),
+          workspace.joint (joint2_), d.results [d.minIndex]);
+    }
+
+    void DistanceBetweenBodies::approximate (bool approximate)
+    {
+      if (approximate == approximate_) return;
+      approximate_ = approximate;
+      // The closest pair of the approximate model is not a good guess for
+      // the exact model.
+      minIndex_ = std::numeric_limits <std::size_t>::max ();
+      version_ = std::numeric_limits <std::size_t>::max ();
+    }
+
+    void DistanceBetweenBodies::accuracy (value_type tolerance)
+    {
+      if (tolerance == request_.abs_err) return;
+      request_.abs_err = tolerance;
+      version_ = std::numeric_limits <std::size_t>::max ();
+    }
+
+    void DistanceBetweenBodies::saveWarmStart (vector_t& state) const
+    {
+      if (minIndex_ >= activePairs_.size ()) {
+        state.resize (0);
+        return;
+      }
+      state.resize (1);
+      state [0] = (value_type) minIndex_;
+    }
+
+    void DistanceBetweenBodies::restoreWarmStart (vectorIn_t state)
+    {
+      if (state.size () != 1 || state [0] < 0
+          || state [0] >= (value_type) activePairs_.size ()) return;
+      minIndex_ = (std::size_t) state [0];
+      // results_ may not hold the distance of the restored pair.
+      version_ = std::numeric_limits <std::size_t>::max ();
+    }
+
+    void DistanceBetweenBodies::nbThreads (std::size_t nbThreads)
+    {
+      nbThreads_ = nbThreads;
+    }
+
+    value_type DistanceBetweenBodies::evaluationCost () const
+    {
+      // A distance query costs roughly as much as ten Position constraints.
+      return 10 * (value_type) activePairs_.size ();
+    }
+
+    MemoryUsage DistanceBetweenBodies::memoryUsage () const
+    {
+      MemoryUsage m (DifferentiableFunction::memoryUsage ());
+      m.definition += sizeof (DistanceBetweenBodies)
+        - sizeof (DifferentiableFunction) + memorySize (activePairs_)
+        + memorySize (geometries_) + memorySize (spheres_);
+      for (std::size_t i = 0; i < spheres_.size (); ++i)
+        m.definition += memorySize (spheres_[i]);
+      m.scratch += memorySize (bounds_);
+      m.caches += memorySize (results_);
+      return m;
+    }
+
+    value_type DistanceBetweenBodies::lipschitzConstant () const
+    {
+      const se3::GeometryModel& model = robot_->geomModel ();
+      // Distance of the geometries of joint 1 to its origin.
+      value_type radius = 0;
+      for (std::size_t i = 0; i < geometries_.size (); ++i) {
+        const se3::GeometryObject& object =
+          model.geometryObjects [geometries_[i]];
+        if (object.parentJoint != joint1_->index ()) continue;
+        const fcl::CollisionGeometry& g = *object.fcl;
+        radius = std::max (radius, object.placement.act (vector3_t
+              (g.aabb_center [0], g.aabb_center [1], g.aabb_center [2]))
+            .norm () + g.aabb_radius);
+        // The spheres of the approximate model may exceed the bounding
+        // sphere of the geometry.
+        const BoundingSpheres_t& spheres = spheres_ [geometries_[i]];
+        for (std::size_t k = 0; k < spheres.size (); ++k)
+          radius = std::max (radius,
+              object.placement.act (spheres[k].center).norm ()
+              + spheres[k].radius);
+      }
+      return relativeVelocityBounds (robot_, joint2_ ? joint2_->index () : 0,
+          joint1_->index (), radius).linear;
+    }
+
+    namespace {
+      /// Interval of a path between two samples of the distance.
+      struct SegmentInterval
+      {
+        value_type begin, end, dBegin, dEnd, lowerBound;
+        /// Order of the priority queue: smallest lower bound first.
+        bool operator< (const SegmentInterval& other) const
+        {
+          return lowerBound > other.lowerBound;
+        }
+      };
+    } // namespace
+
+    DistanceBetweenBodies::SegmentDistance
+    DistanceBetweenBodies::distanceAlongSegment (ConfigurationIn_t q0,
+        ConfigurationIn_t q1, value_type tolerance,
+        std::size_t maxEvaluations) const
+    {
+      using hpp::pinocchio::LieGroupTpl;
+      vector_t v (robot_->numberDof ());
+      hpp::pinocchio::difference<LieGroupTpl> (robot_, q1, q0, v);
+      // Bound on the variation of the distance per unit of parameter.
+      const value_type K = lipschitzConstant () * v.norm ();
+
+      SegmentDistance res;
+      vector_t value (1);
+      Configuration_t q (q0.size ());
+      (*this) (value, q0);
+      res.distance = value[0];
+      res.parameter = 0;
+      res.nbEvaluations = 1;
+      if (K == 0) {
+        res.lowerBound = res.distance;
+        return res;
+      }
+      (*this) (value, q1);
+      ++res.nbEvaluations;
+      if (value[0] < res.distance) {
+        res.distance = value[0];
+        res.parameter = 1;
+      }
+      if (K == std::numeric_limits <value_type>::infinity ()) {
+        res.lowerBound = - std::numeric_limits <value_type>::infinity ();
+        return res;
+      }
+
+      std::priority_queue <SegmentInterval> intervals;
+      SegmentInterval I;
+      I.begin = 0; I.end = 1; I.dBegin = res.distance; I.dEnd = value[0];
+      I.lowerBound = (I.dBegin + I.dEnd - K) / 2;
+      intervals.push (I);
+      while (true) {
+        I = intervals.top ();
+        if (I.lowerBound >= res.distance - tolerance
+            || res.nbEvaluations >= maxEvaluations) {
+          res.lowerBound = std::min (res.distance, I.lowerBound);
+          return res;
+        }
+        intervals.pop ();
+        // Parameter where the lower bound is reached, kept away from the
+        // ends of the interval.
+        const value_type length = I.end - I.begin;
+        value_type t = (I.begin + I.end) / 2 + (I.dBegin - I.dEnd) / (2 * K);
+        t = std::max (I.begin + .1 * length, std::min (I.end - .1 * length, t));
+        hpp::pinocchio::interpolate<LieGroupTpl> (robot_, q0, q1, t, q);
+        (*this) (value, q);
+        ++res.nbEvaluations;
+        if (value[0] < res.distance) {
+          res.distance = value[0];
+          res.parameter = t;
+        }
+        SegmentInterval left (I), right (I);
+        left.end = right.begin = t;
+        left.dEnd = right.dBegin = value[0];
+        left.lowerBound = (left.dBegin + left.dEnd - K * (t - I.begin)) / 2;
+        right.lowerBound = (right.dBegin + right.dEnd - K * (I.end - t)) / 2;
+        intervals.push (left);
+        intervals.push (right);
+      }
+    }
+
+    void DistanceBetweenBodies::computeJacobian (matrixOut_t jacobian,
+        const JointPtr_t& joint1, const JointPtr_t& joint2,
+        const fcl::DistanceResult& result)
+    {
+      const value_type dist = result.min_distance;
+      const JointJacobian_t& J1 (joint1->jacobian());
+      const Transform3f& M1 (joint1->currentTransformation());
       const matrix3_t& R1 (M1.rotation());
-      vector3_t point1 (data_.distanceResults[minIndex_].nearest_points[0]);
-      vector3_t point2 (data_.distanceResults[minIndex_].nearest_points[1]);
-      // P1 - P2
-      vector3_t P1_minus_P2 (point1 - point2);
-      // P1 - t1
-      vector3_t P1_minus_t1 (point1 - M1.translation ());
-      //        T (                              )
-      // (P1-P2)  ( J    -   [P1 - t1]  J        )
-      //          (  1 [0:3]          x  1 [3:6] )
-      jacobian = (
-          P1_minus_P2.transpose () * R1 * J1.topRows<3>()
-          + P1_minus_P2.transpose () * R1.colwise().cross(P1_minus_t1) * J1.bottomRows<3>()
-          ) / dist[0];
-      if (joint2_) {
-        const JointJacobian_t& J2 (joint2_->jacobian());
-        const Transform3f& M2 (joint2_->currentTransformation());
+      vector3_t point1 (result.nearest_points[0]);
+      vector3_t point2 (result.nearest_points[1]);
+      // (P1 - P2) / dist
+      const vector3_t u ((point1 - point2) / dist);
+      //  T (                              )
+      // u  ( J    -   [P1 - t1]  J        )
+      //    (  1 [0:3]          x  1 [3:6] )
+      // where u^T [P1 - t1]x R1 = - ((P1 - t1) x u)^T R1. Only fixed size
+      // vectors are computed so that no memory is allocated.
+      vector3_t a (R1.transpose () * u);
+      vector3_t b (R1.transpose () * (point1 - M1.translation ()).cross (u));
+      jacobian.noalias() = a.transpose () * J1.topRows<3>();
+      jacobian.noalias() += b.transpose () * J1.bottomRows<3>();
+      if (joint2) {
+        const JointJacobian_t& J2 (joint2->jacobian());
+        const Transform3f& M2 (joint2->currentTransformation());
         const matrix3_t& R2 (M2.rotation());
-	// P2 - t2
-	vector3_t P2_minus_t2 (point2 - M2.translation ());
-	//        T (                              )
-	// (P1-P2)  ( J    -   [P1 - t1]  J        )
-	//          (  2 [0:3]          x  2 [3:6] )
-	matrix_t tmp2
-	  (  P1_minus_P2.transpose () * R2 * J2.topRows<3>()
-           + P1_minus_P2.transpose () * R2.colwise().cross(P2_minus_t2) * J2.bottomRows<3>());
-	jacobian.noalias() -= tmp2/dist [0];
+        //  T (                              )
+        // u  ( J    -   [P2 - t2]  J        )
+        //    (  2 [0:3]          x  2 [3:6] )
+        a.noalias() = R2.transpose () * u;
+        b.noalias() = R2.transpose () * (point2 - M2.translation ()).cross (u);
+        jacobian.noalias() -= a.transpose () * J2.topRows<3>();
+        jacobian.noalias() -= b.transpose () * J2.bottomRows<3>();
       }
     }
 
@@ -154,10 +632,8 @@ namespace hpp {
     {
       using se3::GeometryModel;
       const GeometryModel& model = robot_->geomModel();
-      // Deactivate all collision pairs.
-      for (std::size_t i = 0; i < model.collisionPairs.size(); ++i)
-        data_.activateCollisionPair(i, false);
-      // Activate only the relevant ones.
+      activePairs_.clear ();
+      geometries_.clear ();
       for (Iterator1 it1 = begin1; it1 != end1; ++it1) {
 	CollisionObjectConstPtr_t obj1 (*it1);
 	for (Iterator2 it2 = begin2; it2 != end2; ++it2) {
@@ -165,12 +641,26 @@ namespace hpp {
           std::size_t idx = model.findCollisionPair(
               se3::CollisionPair (obj1->indexInModel(), obj2->indexInModel())
               );
-          if (idx < model.collisionPairs.size())
-            data_.activateCollisionPair(idx);
-          else
+          if (idx < model.collisionPairs.size()) {
+            activePairs_.push_back (idx);
+            geometries_.push_back (obj1->indexInModel());
+            geometries_.push_back (obj2->indexInModel());
+            // Make sure that the bounding spheres used by the lower bounds
+            // are computed.
+            model.geometryObjects [obj1->indexInModel()].fcl->computeLocalAABB ();
+            model.geometryObjects [obj2->indexInModel()].fcl->computeLocalAABB ();
+          } else
             throw std::invalid_argument("Collision pair not found");
 	}
       }
+      std::sort (geometries_.begin (), geometries_.end ());
+      geometries_.erase (std::unique (geometries_.begin (), geometries_.end ()),
+          geometries_.end ());
+      results_.resize (activePairs_.size ());
+      spheres_.assign (model.geometryObjects.size (), BoundingSpheres_t ());
+      for (std::size_t i = 0; i < geometries_.size (); ++i)
+        coverWithSpheres (*model.geometryObjects [geometries_[i]].fcl,
+            Transform3f::Identity (), spheres_ [geometries_[i]]);
     }
   } // namespace constraints
 } // namespace hpp
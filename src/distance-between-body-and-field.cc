@@ -0,0 +1,146 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/distance-between-body-and-field.hh>
+
+#include <limits>
+
+#include <hpp/pinocchio/body.hh>
+#include <hpp/pinocchio/collision-object.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/signed-distance-field.hh>
+#include <hpp/constraints/workspace.hh>
+
+namespace hpp {
+  namespace constraints {
+    DistanceBetweenBodyAndFieldPtr_t DistanceBetweenBodyAndField::create
+    (const std::string& name, const DevicePtr_t& robot,
+     const JointPtr_t& joint, const SignedDistanceFieldPtr_t& field)
+    {
+      return create (name, robot, joint, field, boundingSpheres (joint));
+    }
+
+    DistanceBetweenBodyAndFieldPtr_t DistanceBetweenBodyAndField::create
+    (const std::string& name, const DevicePtr_t& robot,
+     const JointPtr_t& joint, const SignedDistanceFieldPtr_t& field,
+     const Spheres_t& spheres)
+    {
+      DistanceBetweenBodyAndField* ptr = new DistanceBetweenBodyAndField
+        (name, robot, joint, field, spheres);
+      DistanceBetweenBodyAndFieldPtr_t shPtr (ptr);
+      return shPtr;
+    }
+
+    DistanceBetweenBodyAndField::Spheres_t
+    DistanceBetweenBodyAndField::boundingSpheres (const JointPtr_t& joint)
+    {
+      Spheres_t spheres;
+      const ObjectVector_t& objects (joint->linkedBody ()->innerObjects ());
+      for (ObjectVector_t::const_iterator _o = objects.begin ();
+          _o != objects.end (); ++_o)
+        coverWithSpheres (*(*_o)->geometry (), (*_o)->positionInJointFrame (),
+            spheres);
+      return spheres;
+    }
+
+    DistanceBetweenBodyAndField::DistanceBetweenBodyAndField
+    (const std::string& name, const DevicePtr_t& robot,
+     const JointPtr_t& joint, const SignedDistanceFieldPtr_t& field,
+     const Spheres_t& spheres) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
+			      name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), joint_ (joint),
+      field_ (field), spheres_ (spheres)
+    {
+      assert (field_);
+      activeDerivativeColumns_.setConstant (false);
+      activateJointColumns (joint_);
+    }
+
+    value_type DistanceBetweenBodyAndField::evaluationCost () const
+    {
+      // The forward kinematics and about ten lookups cost as much as a
+      // Position constraint.
+      return 1 + (value_type) spheres_.size () / 10;
+    }
+
+    value_type DistanceBetweenBodyAndField::compute (const JointPtr_t& joint,
+        matrixOut_t* jacobian) const
+    {
+      const Transform3f& M = joint->currentTransformation ();
+      value_type minDistance = std::numeric_limits <value_type>::infinity ();
+      std::size_t closest = spheres_.size ();
+      vector3_t gradient, g;
+      for (std::size_t i = 0; i < spheres_.size (); ++i) {
+        const value_type d = field_->value (M.act (spheres_ [i].center), g)
+          - spheres_ [i].radius;
+        if (d < minDistance) {
+          minDistance = d;
+          closest = i;
+          gradient = g;
+        }
+      }
+      if (jacobian) {
+        if (closest == spheres_.size ()) {
+          jacobian->setZero ();
+        } else {
+          // The velocity of the center p in the world frame is
+          // R (v + w x p), where v, w are expressed in the joint frame.
+          const JointJacobian_t& J (joint->jacobian ());
+          const vector3_t a (M.rotation ().transpose () * gradient);
+          const vector3_t b (spheres_ [closest].center.cross (a));
+          jacobian->noalias () = a.transpose () * J.topRows <3> ();
+          jacobian->noalias () += b.transpose () * J.bottomRows <3> ();
+        }
+      }
+      return minDistance;
+    }
+
+    void DistanceBetweenBodyAndField::impl_compute
+    (vectorOut_t result, ConfigurationIn_t argument) const throw ()
+    {
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
+      result [0] = compute (joint_, NULL);
+    }
+
+    void DistanceBetweenBodyAndField::impl_jacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      compute (joint_, &jacobian);
+    }
+
+    void DistanceBetweenBodyAndField::impl_compute
+    (vectorOut_t result, ConfigurationIn_t argument, Workspace& workspace)
+      const throw ()
+    {
+      workspace.kinematics ()->update (argument, KinematicsCache::PLACEMENTS);
+      result [0] = compute (workspace.joint (joint_), NULL);
+    }
+
+    void DistanceBetweenBodyAndField::impl_jacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg, Workspace& workspace)
+      const throw ()
+    {
+      workspace.kinematics ()->update (arg, KinematicsCache::JACOBIANS);
+      compute (workspace.joint (joint_), &jacobian);
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,151 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/distance-between-point-pairs.hh>
+
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    const std::size_t DistanceBetweenPointPairs::noJoint =
+      std::numeric_limits <std::size_t>::max ();
+
+    DistanceBetweenPointPairsPtr_t DistanceBetweenPointPairs::create
+    (const std::string& name, const DevicePtr_t& robot,
+     const PointPairs_t& pairs)
+    {
+      DistanceBetweenPointPairs* ptr = new DistanceBetweenPointPairs
+	(name, robot, pairs);
+      DistanceBetweenPointPairsPtr_t shPtr (ptr);
+      return shPtr;
+    }
+
+    DistanceBetweenPointPairs::DistanceBetweenPointPairs
+    (const std::string& name, const DevicePtr_t& robot,
+     const PointPairs_t& pairs) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (),
+                              pairs.size (), name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), pairs_ (pairs),
+      group1_ (pairs.size ()), group2_ (pairs.size ()),
+      global1_ (3, pairs.size ()), global2_ (3, pairs.size ()),
+      pointsVersion_ (std::numeric_limits <std::size_t>::max ()),
+      jacobianVersion_ (std::numeric_limits <std::size_t>::max ())
+    {
+      activeDerivativeColumns_.setConstant (false);
+      for (std::size_t i = 0; i < pairs_.size (); ++i) {
+        group1_ [i] = group (pairs_ [i].joint1);
+        group2_ [i] = group (pairs_ [i].joint2);
+        // Points fixed in the world frame.
+        if (group1_ [i] == noJoint) global1_.col (i) = pairs_ [i].point1;
+        if (group2_ [i] == noJoint) global2_.col (i) = pairs_ [i].point2;
+      }
+      RJ_.resize (6 * joints_.size (), robot->numberDof ());
+    }
+
+    std::size_t DistanceBetweenPointPairs::group (const JointPtr_t& joint)
+    {
+      if (!joint) return noJoint;
+      for (std::size_t j = 0; j < joints_.size (); ++j)
+        if (joints_ [j]->index () == joint->index ()) return j;
+      joints_.push_back (joint);
+      activateJointColumns (joint);
+      return joints_.size () - 1;
+    }
+
+    void DistanceBetweenPointPairs::computePoints () const
+    {
+      if (pointsVersion_ == kinematics_->version ()) return;
+      for (std::size_t i = 0; i < pairs_.size (); ++i) {
+        if (group1_ [i] != noJoint) global1_.col (i) =
+          joints_ [group1_ [i]]->currentTransformation ().act
+          (pairs_ [i].point1);
+        if (group2_ [i] != noJoint) global2_.col (i) =
+          joints_ [group2_ [i]]->currentTransformation ().act
+          (pairs_ [i].point2);
+      }
+      pointsVersion_ = kinematics_->version ();
+    }
+
+    void DistanceBetweenPointPairs::computeJointJacobians () const
+    {
+      if (jacobianVersion_ == kinematics_->version ()) return;
+      for (std::size_t j = 0; j < joints_.size (); ++j) {
+        const JointJacobian_t& J (joints_ [j]->jacobian ());
+        const matrix3_t& R (joints_ [j]->currentTransformation ().rotation ());
+        RJ_.middleRows <3> (6*j    ).noalias () = R * J.topRows <3> ();
+        RJ_.middleRows <3> (6*j + 3).noalias () = R * J.bottomRows <3> ();
+      }
+      jacobianVersion_ = kinematics_->version ();
+    }
+
+    void DistanceBetweenPointPairs::impl_compute
+    (vectorOut_t result, ConfigurationIn_t argument) const throw ()
+    {
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
+      computePoints ();
+      result = (global2_ - global1_).colwise ().norm ().transpose ();
+    }
+
+    void DistanceBetweenPointPairs::impl_jacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      computePoints ();
+      computeJointJacobians ();
+      for (std::size_t i = 0; i < pairs_.size (); ++i) {
+        const size_type row = (size_type) i;
+        // (P1 - P2) / dist
+        const vector3_t P1_minus_P2 (global1_.col (i) - global2_.col (i));
+        const vector3_t u (P1_minus_P2 / P1_minus_P2.norm ());
+        //  T (                              )
+        // u  ( J    -   [P1 - t1]  J        )
+        //    (  1 [0:3]          x  1 [3:6] )
+        // minus the same term for point 2.
+        jacobian.row (row).setZero ();
+        std::size_t j = group1_ [i];
+        if (j != noJoint) {
+          const vector3_t b ((global1_.col (i) - joints_ [j]->
+                currentTransformation ().translation ()).cross (u));
+          jacobian.row (row).noalias () +=
+            u.transpose () * RJ_.middleRows <3> (6*j);
+          jacobian.row (row).noalias () +=
+            b.transpose () * RJ_.middleRows <3> (6*j + 3);
+        }
+        j = group2_ [i];
+        if (j != noJoint) {
+          const vector3_t b ((global2_.col (i) - joints_ [j]->
+                currentTransformation ().translation ()).cross (u));
+          jacobian.row (row).noalias () -=
+            u.transpose () * RJ_.middleRows <3> (6*j);
+          jacobian.row (row).noalias () -=
+            b.transpose () * RJ_.middleRows <3> (6*j + 3);
+        }
+      }
+    }
+
+    void DistanceBetweenPointPairs::impl_valueAndJacobian
+    (vectorOut_t result, matrixOut_t jacobian, ConfigurationIn_t arg) const
+    {
+      impl_jacobian (jacobian, arg);
+      result = (global2_ - global1_).colwise ().norm ().transpose ();
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -26,6 +26,9 @@
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/lipschitz.hh>
+
 namespace hpp {
   namespace constraints {
 
@@ -63,7 +66,8 @@ namespace hpp {
      const JointPtr_t& joint1, const JointPtr_t& joint2,
      const vector3_t& point1, const vector3_t& point2) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
-			      name), robot_ (robot), joint1_ (joint1),
+			      name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), joint1_ (joint1),
       joint2_ (joint2), point1_ (point1), point2_ (point2)
     {
       assert (joint1);
@@ -74,7 +78,8 @@ namespace hpp {
     (const std::string& name, const DevicePtr_t& robot,
      const JointPtr_t& joint1, const vector3_t& point1, const vector3_t& point2)
       : DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
-				name), robot_ (robot), joint1_ (joint1),
+				name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), joint1_ (joint1),
 	joint2_ (), point1_ (point1), point2_ (point2)
     {
       assert (joint1);
@@ -89,8 +94,7 @@ namespace hpp {
 	result = latestResult_;
 	return;
       }
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
       global1_ = joint1_->currentTransformation ().act (point1_);
       if (joint2_) {
 	global2_ = joint2_->currentTransformation ().act (point2_);
@@ -108,6 +112,9 @@ namespace hpp {
     {
       vector_t dist; dist.resize (1);
       impl_compute (dist, arg);
+      // impl_compute may return the latest result without computing the
+      // joint jacobians.
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
       const JointJacobian_t& J1 (joint1_->jacobian());
       const Transform3f& M1 (joint1_->currentTransformation());
       const matrix3_t& R1 (M1.rotation());
@@ -145,5 +152,11 @@ namespace hpp {
       }
     }
 
+
+    value_type DistanceBetweenPointsInBodies::lipschitzConstant () const
+    {
+      return relativeVelocityBounds (robot_, joint2_ ? joint2_->index () : 0,
+          joint1_->index (), point1_.norm ()).linear;
+    }
   } // namespace constraints
 } // namespace hpp
@@ -0,0 +1,262 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/evaluation-server.hh>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <boost/cstdint.hpp>
+
+#include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef boost::uint64_t Word_t;
+
+      const char magic [8] = { 'H', 'P', 'P', 'C', 'E', 'V', 'L', '1' };
+
+      /// Read exactly size bytes.
+      /// \return false if the input is closed before the first byte.
+      bool readAll (int fd, void* data, std::size_t size)
+      {
+        char* d = static_cast <char*> (data);
+        std::size_t done = 0;
+        while (done < size) {
+          const ssize_t n = ::read (fd, d + done, size - done);
+          if (n < 0 && errno == EINTR) continue;
+          if (n < 0)
+            throw std::runtime_error (std::string ("Evaluation: read failed: ")
+                + std::strerror (errno));
+          if (n == 0) {
+            if (done == 0) return false;
+            throw std::runtime_error ("Evaluation: truncated message");
+          }
+          done += (std::size_t) n;
+        }
+        return true;
+      }
+
+      void readAllOrThrow (int fd, void* data, std::size_t size)
+      {
+        if (size > 0 && !readAll (fd, data, size))
+          throw std::runtime_error ("Evaluation: truncated message");
+      }
+
+      void writeAll (int fd, const void* data, std::size_t size)
+      {
+        const char* d = static_cast <const char*> (data);
+        std::size_t done = 0;
+        while (done < size) {
+          const ssize_t n = ::write (fd, d + done, size - done);
+          if (n < 0 && errno == EINTR) continue;
+          if (n < 0)
+            throw std::runtime_error (std::string ("Evaluation: write failed: ")
+                + std::strerror (errno));
+          done += (std::size_t) n;
+        }
+      }
+
+      inline Word_t readWord (int fd)
+      {
+        Word_t w = 0;
+        readAllOrThrow (fd, &w, sizeof (Word_t));
+        return w;
+      }
+
+      inline void writeWord (int fd, Word_t w)
+      {
+        writeAll (fd, &w, sizeof (Word_t));
+      }
+
+      void writeMatrix (int fd, const matrix_t& m)
+      {
+        writeWord (fd, (Word_t) m.rows ());
+        writeWord (fd, (Word_t) m.cols ());
+        writeAll (fd, m.data (), (std::size_t) m.size () * sizeof (double));
+      }
+
+      /// Whether a rows x cols matrix of doubles has at most maxSize
+      /// coefficients.
+      inline bool fits (Word_t rows, Word_t cols, Word_t maxSize)
+      {
+        if (rows == 0 || cols == 0) return true;
+        return rows <= maxSize && cols <= maxSize / rows;
+      }
+
+      void readMatrix (int fd, matrix_t& m, Word_t maxSize)
+      {
+        const Word_t rows = readWord (fd);
+        const Word_t cols = readWord (fd);
+        if (!fits (rows, cols, maxSize))
+          throw std::runtime_error ("Evaluation: matrix too large");
+        m.resize ((size_type) rows, (size_type) cols);
+        readAllOrThrow (fd, m.data (),
+            (std::size_t) m.size () * sizeof (double));
+      }
+
+      void writeError (int fd, const std::string& message)
+      {
+        writeWord (fd, 1);
+        writeWord (fd, (Word_t) message.size ());
+        writeAll (fd, message.data (), message.size ());
+      }
+    } // namespace
+
+    EvaluationServerPtr_t EvaluationServer::create
+    (const BatchEvaluatorPtr_t& evaluator, const Functions_t& functions,
+     size_type maxBatch)
+    {
+      return EvaluationServerPtr_t (new EvaluationServer
+          (evaluator, functions, maxBatch));
+    }
+
+    EvaluationServer::EvaluationServer (const BatchEvaluatorPtr_t& evaluator,
+        const Functions_t& functions, size_type maxBatch) :
+      evaluator_ (evaluator), functions_ (functions), inputSize_ (0),
+      maxBatch_ (maxBatch), nbConfigurations_ (0)
+    {
+      assert (evaluator_);
+      if (maxBatch_ <= 0)
+        throw std::invalid_argument ("EvaluationServer: the maximal number "
+            "of configurations must be positive");
+      if (!functions_.empty ()) inputSize_ = functions_[0]->inputSize ();
+      for (std::size_t i = 0; i < functions_.size (); ++i)
+        if (functions_[i]->inputSize () != inputSize_)
+          throw std::invalid_argument ("EvaluationServer: the functions "
+              "must have the same input size");
+    }
+
+    bool EvaluationServer::process (int input, int output)
+    {
+      char m [sizeof (magic)];
+      if (!readAll (input, m, sizeof (m))) return false;
+      if (std::memcmp (m, magic, sizeof (magic)) != 0) {
+        writeError (output, "EvaluationServer: invalid request");
+        return false;
+      }
+      const Word_t rows = readWord (input);
+      const Word_t N = readWord (input);
+      const bool jacobians = readWord (input) != 0;
+      // Check the sizes before allocating. The configurations of an invalid
+      // request are not read, so the connection cannot be kept in sync.
+      if (rows != (Word_t) inputSize_) {
+        writeError (output, "EvaluationServer: configurations have a wrong "
+            "size");
+        return false;
+      }
+      if (N == 0 || N > (Word_t) maxBatch_ || !fits (rows, N,
+            (Word_t) std::numeric_limits <std::size_t>::max ()
+            / sizeof (double))) {
+        writeError (output, "EvaluationServer: wrong number of "
+            "configurations");
+        return false;
+      }
+      configurations_.resize (inputSize_, (size_type) N);
+      readAllOrThrow (input, configurations_.data (),
+          (std::size_t) configurations_.size () * sizeof (double));
+
+      try {
+        evaluator_->evaluate (functions_, configurations_, values_,
+            jacobians ? &jacobians_ : NULL);
+      } catch (const std::exception& e) {
+        writeError (output, e.what ());
+        return true;
+      }
+      nbConfigurations_ += (std::size_t) N;
+
+      writeWord (output, 0);
+      writeWord (output, (Word_t) values_.size ());
+      writeWord (output, jacobians ? 1 : 0);
+      for (std::size_t i = 0; i < values_.size (); ++i)
+        writeMatrix (output, values_[i]);
+      if (jacobians)
+        for (std::size_t i = 0; i < jacobians_.size (); ++i)
+          writeMatrix (output, jacobians_[i]);
+      return true;
+    }
+
+    std::size_t EvaluationServer::serve (int input, int output)
+    {
+      std::size_t n = 0;
+      while (process (input, output)) ++n;
+      return n;
+    }
+
+    EvaluationClientPtr_t EvaluationClient::create (int input, int output,
+        size_type maxSize)
+    {
+      return EvaluationClientPtr_t (new EvaluationClient
+          (input, output, maxSize));
+    }
+
+    EvaluationClient::EvaluationClient (int input, int output,
+        size_type maxSize) :
+      input_ (input), output_ (output), maxSize_ (maxSize)
+    {
+      if (maxSize_ <= 0)
+        throw std::invalid_argument ("EvaluationClient: the maximal size "
+            "must be positive");
+    }
+
+    void EvaluationClient::send (matrixIn_t configurations, bool jacobians)
+    {
+      writeAll (output_, magic, sizeof (magic));
+      writeWord (output_, (Word_t) configurations.rows ());
+      writeWord (output_, (Word_t) configurations.cols ());
+      writeWord (output_, jacobians ? 1 : 0);
+      // matrixIn_t may have an outer stride: send column by column.
+      for (size_type c = 0; c < configurations.cols (); ++c) {
+        const vector_t q (configurations.col (c));
+        writeAll (output_, q.data (),
+            (std::size_t) q.size () * sizeof (double));
+      }
+    }
+
+    void EvaluationClient::receive (std::vector <matrix_t>& values,
+        std::vector <matrix_t>* jacobians)
+    {
+      const Word_t maxSize = (Word_t) maxSize_;
+      if (readWord (input_) != 0) {
+        const Word_t size = readWord (input_);
+        if (size > maxSize)
+          throw std::runtime_error ("Evaluation: message too large");
+        std::string message ((std::size_t) size, '\0');
+        readAllOrThrow (input_, &message [0], message.size ());
+        throw std::runtime_error (message);
+      }
+      const Word_t nbMatrices = readWord (input_);
+      if (nbMatrices > maxSize)
+        throw std::runtime_error ("Evaluation: too many matrices");
+      const std::size_t n = (std::size_t) nbMatrices;
+      const bool hasJacobians = readWord (input_) != 0;
+      values.resize (n);
+      for (std::size_t i = 0; i < n; ++i)
+        readMatrix (input_, values[i], maxSize);
+      if (!hasJacobians) return;
+      std::vector <matrix_t> ignored;
+      std::vector <matrix_t>& J = jacobians ? *jacobians : ignored;
+      J.resize (n);
+      for (std::size_t i = 0; i < n; ++i)
+        readMatrix (input_, J[i], maxSize);
+    }
+  } // namespace constraints
+} // namespace hpp
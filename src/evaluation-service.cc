@@ -0,0 +1,157 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/evaluation-service.hh>
+
+#include <algorithm>
+#include <sched.h>
+
+#include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      template <typename Request>
+      bool sameBatch (const Request* r1, const Request* r2)
+      {
+        return r1->function == r2->function
+          && (r1->jacobian == NULL) == (r2->jacobian == NULL);
+      }
+
+      template <typename Request>
+      bool compareBatches (const Request* r1, const Request* r2)
+      {
+        if (r1->function != r2->function) return r1->function < r2->function;
+        return (r1->jacobian == NULL) < (r2->jacobian == NULL);
+      }
+    } // namespace
+
+    EvaluationServicePtr_t EvaluationService::create ()
+    {
+      return EvaluationServicePtr_t (new EvaluationService);
+    }
+
+    EvaluationService::EvaluationService () :
+      head_ (NULL), busy_ (0), nbBatches_ (0), nbRequests_ (0)
+    {}
+
+    void EvaluationService::evaluate (const DifferentiableFunction& function,
+        vectorIn_t argument, vectorOut_t value)
+    {
+      assert (argument.size () == function.inputSize ());
+      assert (value.size () == function.outputSize ());
+      Request request;
+      request.function = &function;
+      request.argument = &argument;
+      request.value = &value;
+      request.jacobian = NULL;
+      submit (request);
+    }
+
+    void EvaluationService::evaluate (const DifferentiableFunction& function,
+        vectorIn_t argument, vectorOut_t value, matrixOut_t jacobian)
+    {
+      assert (argument.size () == function.inputSize ());
+      assert (value.size () == function.outputSize ());
+      assert (jacobian.rows () == function.outputDerivativeSize ());
+      assert (jacobian.cols () == function.inputDerivativeSize ());
+      Request request;
+      request.function = &function;
+      request.argument = &argument;
+      request.value = &value;
+      request.jacobian = &jacobian;
+      submit (request);
+    }
+
+    void EvaluationService::submit (Request& request)
+    {
+      request.done = 0;
+      Request* head;
+      do {
+        head = head_;
+        request.next = head;
+      } while (!__sync_bool_compare_and_swap (&head_, head, &request));
+
+      // Evaluate the queued requests if no other thread does, or wait.
+      while (!request.done) {
+        if (__sync_lock_test_and_set (&busy_, 1) == 0) {
+          combine ();
+          __sync_lock_release (&busy_);
+        } else {
+          sched_yield ();
+        }
+      }
+      // Make the results written by the combiner visible.
+      __sync_synchronize ();
+    }
+
+    void EvaluationService::combine ()
+    {
+      Request* head;
+      do {
+        head = head_;
+      } while (!__sync_bool_compare_and_swap (&head_, head, (Request*) NULL));
+      if (head == NULL) return;
+
+      batch_.clear ();
+      for (Request* r = head; r != NULL; r = r->next) batch_.push_back (r);
+      // Oldest requests first.
+      std::reverse (batch_.begin (), batch_.end ());
+      std::stable_sort (batch_.begin (), batch_.end (),
+          compareBatches <Request>);
+
+      Requests_t::const_iterator begin = batch_.begin ();
+      while (begin != batch_.end ()) {
+        Requests_t::const_iterator end = begin + 1;
+        while (end != batch_.end () && sameBatch (*begin, *end)) ++end;
+        evaluate (begin, end);
+        begin = end;
+      }
+      ++nbBatches_;
+      nbRequests_ += batch_.size ();
+
+      __sync_synchronize ();
+      // The requests must not be accessed once done: they belong to the
+      // stack of the waiting threads.
+      for (std::size_t i = 0; i < batch_.size (); ++i) batch_[i]->done = 1;
+      batch_.clear ();
+    }
+
+    void EvaluationService::evaluate (Requests_t::const_iterator begin,
+        Requests_t::const_iterator end)
+    {
+      const DifferentiableFunction& f = *(*begin)->function;
+      const size_type n = (size_type) (end - begin);
+      const size_type nv = f.inputDerivativeSize ();
+
+      arguments_.resize (f.inputSize (), n);
+      for (size_type i = 0; i < n; ++i)
+        arguments_.col (i) = *begin[i]->argument;
+
+      values_.resize (f.outputSize (), n);
+      f.valueBatch (values_, arguments_);
+      for (size_type i = 0; i < n; ++i)
+        *begin[i]->value = values_.col (i);
+
+      if ((*begin)->jacobian == NULL) return;
+      jacobians_.resize (f.outputDerivativeSize (), n * nv);
+      f.jacobianBatch (jacobians_, arguments_);
+      for (size_type i = 0; i < n; ++i)
+        *begin[i]->jacobian = jacobians_.middleCols (i * nv, nv);
+    }
+  } // namespace constraints
+} // namespace hpp
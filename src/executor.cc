@@ -0,0 +1,193 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/executor.hh>
+
+#include <algorithm>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include <hpp/constraints/differentiable-function.hh>
+#include <hpp/constraints/workspace.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      inline std::size_t threadId ()
+      {
+#ifdef _OPENMP
+        return (std::size_t) omp_get_thread_num ();
+#else
+        return 0;
+#endif
+      }
+
+      template <typename StatePtr_t>
+      bool moreExpensive (const StatePtr_t& s1, const StatePtr_t& s2)
+      {
+        return s1->function->evaluationCost ()
+          > s2->function->evaluationCost ();
+      }
+    } // namespace
+
+    bool EvaluationFuture::ready () const
+    {
+      assert (valid ());
+      return state_->executor->ready (*state_);
+    }
+
+    void EvaluationFuture::wait () const
+    {
+      assert (valid ());
+      state_->executor->wait (*state_);
+    }
+
+    ExecutorPtr_t Executor::create (const DevicePtr_t& robot,
+        std::size_t nbThreads)
+    {
+      return ExecutorPtr_t (new Executor (robot, nbThreads));
+    }
+
+    Executor::Executor (const DevicePtr_t& robot, std::size_t nbThreads) :
+      workspaces_ (std::max (nbThreads, (std::size_t) 1)), running_ (false)
+    {
+      for (std::size_t i = 0; i < workspaces_.size (); ++i)
+        workspaces_[i] = Workspace::create (robot);
+      pthread_mutex_init (&mutex_, NULL);
+      pthread_cond_init (&done_, NULL);
+    }
+
+    Executor::~Executor ()
+    {
+      wait ();
+      pthread_cond_destroy (&done_);
+      pthread_mutex_destroy (&mutex_);
+    }
+
+    EvaluationFuture Executor::submit (const DifferentiableFunction& function,
+        vectorIn_t argument, bool computeJacobian)
+    {
+      assert (argument.size () == function.inputSize ());
+      StatePtr_t state (new EvaluationFuture::State);
+      state->function = &function;
+      state->executor = this;
+      state->argument = argument;
+      state->computeJacobian = computeJacobian;
+      state->started = false;
+      state->ready = false;
+      pending_.push_back (state);
+      return EvaluationFuture (state);
+    }
+
+    void Executor::evaluate (EvaluationFuture::State& state,
+        Workspace* workspace)
+    {
+      const DifferentiableFunction& f = *state.function;
+      state.value.resize (f.outputSize ());
+      if (state.computeJacobian)
+        state.jacobian.resize (f.outputDerivativeSize (),
+            f.inputDerivativeSize ());
+      if (workspace) {
+        f (state.value, state.argument, *workspace);
+        if (state.computeJacobian)
+          f.jacobian (state.jacobian, state.argument, *workspace);
+      } else if (state.computeJacobian) {
+        f.valueAndJacobian (state.value, state.jacobian, state.argument);
+      } else {
+        f (state.value, state.argument);
+      }
+      // Locking the mutex also publishes the results to the waiting thread.
+      pthread_mutex_lock (&mutex_);
+      state.ready = true;
+      pthread_cond_broadcast (&done_);
+      pthread_mutex_unlock (&mutex_);
+    }
+
+    bool Executor::ready (const EvaluationFuture::State& state) const
+    {
+      pthread_mutex_lock (&mutex_);
+      const bool r = state.ready;
+      pthread_mutex_unlock (&mutex_);
+      return r;
+    }
+
+    void Executor::wait (const EvaluationFuture::State& state)
+    {
+      if (!state.started) run ();
+      pthread_mutex_lock (&mutex_);
+      while (!state.ready) pthread_cond_wait (&done_, &mutex_);
+      pthread_mutex_unlock (&mutex_);
+    }
+
+    void Executor::wait ()
+    {
+      if (!running_) return;
+      pthread_join (worker_, NULL);
+      running_ = false;
+    }
+
+    void Executor::run ()
+    {
+      // The workspaces and the batch are used by the running batch.
+      wait ();
+      if (pending_.empty ()) return;
+      parallel_.clear ();
+      sequential_.clear ();
+      for (States_t::const_iterator _s = pending_.begin ();
+          _s != pending_.end (); ++_s) {
+        (*_s)->started = true;
+        if ((*_s)->function->threadSafe ()) parallel_.push_back (*_s);
+        else sequential_.push_back (*_s);
+      }
+      pending_.clear ();
+      std::stable_sort (parallel_.begin (), parallel_.end (),
+          moreExpensive <StatePtr_t>);
+      std::stable_sort (sequential_.begin (), sequential_.end (),
+          moreExpensive <StatePtr_t>);
+
+      running_ = (pthread_create (&worker_, NULL, &Executor::work, this) == 0);
+      // Without a worker thread, the batch is evaluated by the caller.
+      if (!running_) evaluateBatch ();
+    }
+
+    void* Executor::work (void* executor)
+    {
+      static_cast <Executor*> (executor)->evaluateBatch ();
+      return NULL;
+    }
+
+    void Executor::evaluateBatch ()
+    {
+      const int nbParallel = (int) parallel_.size ();
+#pragma omp parallel num_threads(workspaces_.size ())
+      {
+        // One thread evaluates the functions that are not thread safe while
+        // the others start with the most expensive thread safe functions.
+#pragma omp single nowait
+        for (std::size_t i = 0; i < sequential_.size (); ++i)
+          evaluate (*sequential_[i], NULL);
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < nbParallel; ++i)
+          evaluate (*parallel_[i], workspaces_[threadId ()].get ());
+      }
+      parallel_.clear ();
+      sequential_.clear ();
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,519 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/function-archive.hh>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/cstdint.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/configuration-constraint.hh>
+#include <hpp/constraints/convex-shape-contact.hh>
+#include <hpp/constraints/differentiable-function-stack.hh>
+#include <hpp/constraints/generic-transformation.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef boost::uint64_t Word_t;
+
+      const char magic [8] = { 'H', 'P', 'P', 'C', 'F', 'U', 'N', '1' };
+      const Word_t version = 1;
+
+      /// Kinds of the saved functions.
+      enum Type_t {
+        TRANSFORMATION = 1,
+        CONFIGURATION_CONSTRAINT = 2,
+        CONVEX_SHAPE_CONTACT = 3,
+        STACK = 4
+      };
+
+      inline std::size_t padded (std::size_t n)
+      {
+        return (n + sizeof (Word_t) - 1) / sizeof (Word_t) * sizeof (Word_t);
+      }
+
+      /// A file mapped in memory, for reading.
+      struct Mapping
+      {
+        Mapping (const std::string& filename) : data (NULL), size (0)
+        {
+          const int fd = open (filename.c_str (), O_RDONLY);
+          if (fd < 0)
+            throw std::runtime_error ("FunctionArchive: cannot open "
+                + filename);
+          struct stat st;
+          void* map = MAP_FAILED;
+          if (fstat (fd, &st) == 0 && st.st_size > 0) {
+            size = (std::size_t) st.st_size;
+            map = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+          }
+          close (fd);
+          if (map == MAP_FAILED)
+            throw std::runtime_error ("FunctionArchive: cannot map "
+                + filename);
+          data = static_cast <const char*> (map);
+        }
+
+        ~Mapping ()
+        {
+          munmap (const_cast <char*> (data), size);
+        }
+
+        const char* data;
+        std::size_t size;
+      }; // struct Mapping
+    } // namespace
+
+    struct FunctionArchive::Writer
+    {
+      Writer (const std::string& filename) :
+        file (filename.c_str (), std::ios::binary | std::ios::trunc)
+      {
+        if (!file)
+          throw std::runtime_error ("FunctionArchive: cannot open "
+              + filename);
+      }
+
+      void word (Word_t w)
+      {
+        file.write (reinterpret_cast <const char*> (&w), sizeof (Word_t));
+      }
+
+      void numbers (const value_type* x, std::size_t n)
+      {
+        file.write (reinterpret_cast <const char*> (x),
+            (std::streamsize) (n * sizeof (value_type)));
+      }
+
+      void vector (vectorIn_t v)
+      {
+        word ((Word_t) v.size ());
+        numbers (v.data (), (std::size_t) v.size ());
+      }
+
+      void string (const std::string& s)
+      {
+        static const char zeros [sizeof (Word_t)] = { 0 };
+        word ((Word_t) s.size ());
+        file.write (s.data (), (std::streamsize) s.size ());
+        file.write (zeros, (std::streamsize) (padded (s.size ()) - s.size ()));
+      }
+
+      void transform (const Transform3f& M)
+      {
+        const matrix3_t R (M.rotation ());
+        const vector3_t t (M.translation ());
+        numbers (R.data (), 9);
+        numbers (t.data (), 3);
+      }
+
+      void joint (const JointConstPtr_t& joint)
+      {
+        string (joint ? joint->name () : std::string ());
+      }
+
+      void mask (const std::vector <bool>& m)
+      {
+        word ((Word_t) m.size ());
+        for (std::size_t i = 0; i < m.size (); ++i) word (m [i] ? 1 : 0);
+      }
+
+      template <int _Options> bool transformation
+        (const DifferentiableFunction& function)
+      {
+        typedef GenericTransformation <_Options> T;
+        const T* f = dynamic_cast <const T*> (&function);
+        if (!f) return false;
+        word (TRANSFORMATION);
+        string (f->name ());
+        word (_Options);
+        joint (T::IsRelative ? f->joint1 () : JointConstPtr_t ());
+        joint (f->joint2 ());
+        transform (f->frame1InJoint1 ());
+        transform (f->frame2InJoint2 ());
+        mask (f->mask ());
+        word (f->useQuaternion () ? 1 : 0);
+        return true;
+      }
+
+      void shapes (const std::vector <ConvexShape>& s, bool floors)
+      {
+        word ((Word_t) s.size ());
+        for (std::size_t i = 0; i < s.size (); ++i) {
+          // addFloor reverses the geometry: save the one it was given and
+          // the reversed one, so that load does not compute it again.
+          if (floors) write (*this, s [i].geometryPtr ()->reversed ());
+          write (*this, s [i].geometryPtr ());
+          joint (s [i].joint_);
+        }
+      }
+
+      /// Write the function, or its index if it was already written.
+      void function (const DifferentiableFunctionPtr_t& f)
+      {
+        std::map <const DifferentiableFunction*, std::size_t>::const_iterator
+          _f = functions.find (f.get ());
+        if (_f != functions.end ()) {
+          word ((Word_t) _f->second);
+          return;
+        }
+        const std::size_t index = functions.size ();
+        functions [f.get ()] = index;
+        word ((Word_t) index);
+
+        if (transformation <RelativeBit | PositionBit | OrientationBit> (*f)
+            || transformation <RelativeBit | PositionBit> (*f)
+            || transformation <RelativeBit | OrientationBit> (*f)
+            || transformation <PositionBit | OrientationBit> (*f)
+            || transformation <PositionBit> (*f)
+            || transformation <OrientationBit> (*f))
+          return;
+        if (const ConfigurationConstraint* c =
+            dynamic_cast <const ConfigurationConstraint*> (f.get ())) {
+          word (CONFIGURATION_CONSTRAINT);
+          string (c->name ());
+          vector (c->goal ());
+          vector (c->weights ());
+          return;
+        }
+        if (const ConvexShapeContact* c =
+            dynamic_cast <const ConvexShapeContact*> (f.get ())) {
+          word (CONVEX_SHAPE_CONTACT);
+          string (c->name ());
+          shapes (c->objectConvexShapes (), false);
+          shapes (c->floorConvexShapes (), true);
+          const value_type margins [3] = { c->normalMargin (),
+            c->selectionMargin (), c->singlePrecisionThreshold () };
+          numbers (margins, 3);
+          return;
+        }
+        if (const DifferentiableFunctionStack* s =
+            dynamic_cast <const DifferentiableFunctionStack*> (f.get ())) {
+          word (STACK);
+          string (s->name ());
+          const DifferentiableFunctionStack::Functions_t& fs =
+            s->functions ();
+          word ((Word_t) fs.size ());
+          for (std::size_t i = 0; i < fs.size (); ++i) function (fs [i]);
+          return;
+        }
+        throw std::invalid_argument ("FunctionArchive: cannot save function "
+            + f->name ());
+      }
+
+      std::ofstream file;
+      std::map <const DifferentiableFunction*, std::size_t> functions;
+      std::map <const ConvexShapeGeometry*, std::size_t> geometries;
+    }; // struct FunctionArchive::Writer
+
+    struct FunctionArchive::Reader
+    {
+      Reader (const char* begin, std::size_t size, const DevicePtr_t& r) :
+        data (begin), end (begin + size), robot (r)
+      {}
+
+      void bytes (void* x, std::size_t n)
+      {
+        if ((std::size_t) (end - data) < n)
+          throw std::runtime_error ("FunctionArchive: truncated file");
+        std::memcpy (x, data, n);
+        data += n;
+      }
+
+      Word_t word ()
+      {
+        Word_t w;
+        bytes (&w, sizeof (Word_t));
+        return w;
+      }
+
+      void numbers (value_type* x, std::size_t n)
+      {
+        bytes (x, n * sizeof (value_type));
+      }
+
+      /// The number of elements of a vector or of a mask.
+      std::size_t size ()
+      {
+        const Word_t n = word ();
+        if (n > (Word_t) (end - data))
+          throw std::runtime_error ("FunctionArchive: truncated file");
+        return (std::size_t) n;
+      }
+
+      vector_t vector ()
+      {
+        vector_t v ((size_type) size ());
+        numbers (v.data (), (std::size_t) v.size ());
+        return v;
+      }
+
+      std::string string ()
+      {
+        std::string s (size (), '\0');
+        bytes (&s [0], s.size ());
+        const std::size_t padding = padded (s.size ()) - s.size ();
+        if ((std::size_t) (end - data) < padding)
+          throw std::runtime_error ("FunctionArchive: truncated file");
+        data += padding;
+        return s;
+      }
+
+      Transform3f transform ()
+      {
+        matrix3_t R;
+        vector3_t t;
+        numbers (R.data (), 9);
+        numbers (t.data (), 3);
+        return Transform3f (R, t);
+      }
+
+      JointPtr_t joint ()
+      {
+        const std::string name (string ());
+        if (name.empty ()) return JointPtr_t ();
+        JointPtr_t j = robot->getJointByName (name);
+        if (!j)
+          throw std::runtime_error ("FunctionArchive: no joint " + name);
+        return j;
+      }
+
+      std::vector <bool> mask ()
+      {
+        std::vector <bool> m (size ());
+        for (std::size_t i = 0; i < m.size (); ++i) m [i] = (word () != 0);
+        return m;
+      }
+
+      template <int _Options> DifferentiableFunctionPtr_t transformation
+        (const std::string& name)
+      {
+        typedef GenericTransformation <_Options> T;
+        const JointConstPtr_t joint1 (joint ()), joint2 (joint ());
+        const Transform3f frame1 (transform ()), frame2 (transform ());
+        const std::vector <bool> m (mask ());
+        typename T::Ptr_t f;
+        if (T::IsRelative)
+          f = T::create (name, robot, joint1, joint2, frame1, frame2, m);
+        else
+          f = T::create (name, robot, joint2, frame2, frame1, m);
+        f->useQuaternion (word () != 0);
+        return f;
+      }
+
+      DifferentiableFunctionPtr_t transformation (const std::string& name)
+      {
+        switch (word ()) {
+          case RelativeBit | PositionBit | OrientationBit:
+            return transformation
+              <RelativeBit | PositionBit | OrientationBit> (name);
+          case RelativeBit | PositionBit:
+            return transformation <RelativeBit | PositionBit> (name);
+          case RelativeBit | OrientationBit:
+            return transformation <RelativeBit | OrientationBit> (name);
+          case PositionBit | OrientationBit:
+            return transformation <PositionBit | OrientationBit> (name);
+          case PositionBit:
+            return transformation <PositionBit> (name);
+          case OrientationBit:
+            return transformation <OrientationBit> (name);
+        }
+        throw std::runtime_error ("FunctionArchive: invalid transformation");
+      }
+
+      DifferentiableFunctionPtr_t convexShapeContact (const std::string& name)
+      {
+        ConvexShapeContactPtr_t c (ConvexShapeContact::create (name, robot));
+        for (std::size_t i = size (); i > 0; --i) {
+          const ConvexShapeGeometryPtr_t g (readGeometry (*this));
+          c->addObject (ConvexShape (g, joint ()));
+        }
+        for (std::size_t i = size (); i > 0; --i) {
+          const ConvexShapeGeometryPtr_t g (readGeometry (*this));
+          // Keep the reversed geometry alive until addFloor reverses g.
+          const ConvexShapeGeometryPtr_t reversed (readGeometry (*this));
+          c->addFloor (ConvexShape (g, joint ()));
+        }
+        value_type margins [3];
+        numbers (margins, 3);
+        c->setNormalMargin (margins [0]);
+        c->setSelectionMargin (margins [1]);
+        c->setSinglePrecisionThreshold (margins [2]);
+        return c;
+      }
+
+      /// Read a function written by Writer::function.
+      DifferentiableFunctionPtr_t function ()
+      {
+        const std::size_t index = (std::size_t) word ();
+        if (index < functions.size ()) {
+          if (!functions [index])
+            throw std::runtime_error ("FunctionArchive: invalid file");
+          return functions [index];
+        }
+        if (index != functions.size ())
+          throw std::runtime_error ("FunctionArchive: invalid file");
+        functions.push_back (DifferentiableFunctionPtr_t ());
+
+        const Word_t type = word ();
+        const std::string name (string ());
+        DifferentiableFunctionPtr_t f;
+        switch (type) {
+          case TRANSFORMATION:
+            f = transformation (name);
+            break;
+          case CONFIGURATION_CONSTRAINT:
+            {
+              const vector_t goal (vector ()), weights (vector ());
+              f = ConfigurationConstraint::create (name, robot, goal,
+                  weights);
+            }
+            break;
+          case CONVEX_SHAPE_CONTACT:
+            f = convexShapeContact (name);
+            break;
+          case STACK:
+            {
+              DifferentiableFunctionStackPtr_t s
+                (DifferentiableFunctionStack::create (name));
+              for (std::size_t i = size (); i > 0; --i) s->add (function ());
+              f = s;
+            }
+            break;
+          default:
+            throw std::runtime_error ("FunctionArchive: invalid file");
+        }
+        functions [index] = f;
+        return f;
+      }
+
+      const char* data;
+      const char* end;
+      DevicePtr_t robot;
+      Functions_t functions;
+      std::vector <ConvexShapeGeometryPtr_t> geometries;
+    }; // struct FunctionArchive::Reader
+
+    void FunctionArchive::write (Writer& writer,
+        const ConvexShapeGeometryPtr_t& geometry)
+    {
+      std::map <const ConvexShapeGeometry*, std::size_t>::const_iterator
+        _g = writer.geometries.find (geometry.get ());
+      if (_g != writer.geometries.end ()) {
+        writer.word ((Word_t) _g->second);
+        return;
+      }
+      const std::size_t index = writer.geometries.size ();
+      writer.geometries [geometry.get ()] = index;
+      writer.word ((Word_t) index);
+
+      const ConvexShapeGeometry& g = *geometry;
+      writer.word ((Word_t) g.Pts_.size ());
+      for (std::size_t i = 0; i < g.Pts_.size (); ++i)
+        writer.numbers (g.Pts_ [i].data (), 3);
+      writer.numbers (g.C_.data (), 3);
+      writer.numbers (g.N_.data (), 3);
+      assert (g.Ns_.size () == g.Us_.size ());
+      writer.word ((Word_t) g.Ns_.size ());
+      for (std::size_t i = 0; i < g.Ns_.size (); ++i) {
+        writer.numbers (g.Ns_ [i].data (), 3);
+        writer.numbers (g.Us_ [i].data (), 3);
+      }
+      writer.vector (g.Ls_);
+      writer.numbers (&g.radius_, 1);
+    }
+
+    ConvexShapeGeometryPtr_t FunctionArchive::readGeometry (Reader& reader)
+    {
+      const std::size_t index = (std::size_t) reader.word ();
+      if (index < reader.geometries.size ())
+        return reader.geometries [index];
+      if (index != reader.geometries.size ())
+        throw std::runtime_error ("FunctionArchive: invalid file");
+
+      std::vector <vector3_t> pts (reader.size ());
+      for (std::size_t i = 0; i < pts.size (); ++i)
+        reader.numbers (pts [i].data (), 3);
+      vector3_t C, N;
+      reader.numbers (C.data (), 3);
+      reader.numbers (N.data (), 3);
+      std::vector <vector3_t> Ns (reader.size ()), Us (Ns.size ());
+      for (std::size_t i = 0; i < Ns.size (); ++i) {
+        reader.numbers (Ns [i].data (), 3);
+        reader.numbers (Us [i].data (), 3);
+      }
+      const vector_t Ls (reader.vector ());
+      value_type radius;
+      reader.numbers (&radius, 1);
+      const std::size_t nbEdges = (pts.size () > 2 ? pts.size () : 1);
+      if (pts.empty () || Ns.size () != nbEdges
+          || (pts.size () > 1 && (std::size_t) Ls.size () < nbEdges))
+        throw std::runtime_error ("FunctionArchive: invalid geometry");
+
+      const ConvexShapeGeometryPtr_t geometry (ConvexShapeGeometry::insert
+          (ConvexShapeGeometryPtr_t (new ConvexShapeGeometry
+            (pts, C, N, Ns, Us, Ls, radius))));
+      reader.geometries.push_back (geometry);
+      return geometry;
+    }
+
+    void FunctionArchive::save (const std::string& filename,
+        const Functions_t& functions)
+    {
+      Writer writer (filename);
+      writer.file.write (magic, sizeof (magic));
+      writer.word (version);
+      writer.word ((Word_t) functions.size ());
+      for (std::size_t i = 0; i < functions.size (); ++i)
+        writer.function (functions [i]);
+      writer.file.flush ();
+      if (!writer.file)
+        throw std::runtime_error ("FunctionArchive: cannot write "
+            + filename);
+    }
+
+    FunctionArchive::Functions_t FunctionArchive::load
+    (const std::string& filename, const DevicePtr_t& robot)
+    {
+      const Mapping mapping (filename);
+      Reader reader (mapping.data, mapping.size, robot);
+      char m [sizeof (magic)];
+      reader.bytes (m, sizeof (m));
+      if (std::memcmp (m, magic, sizeof (magic)) != 0)
+        throw std::runtime_error ("FunctionArchive: " + filename
+            + " is not an archive");
+      if (reader.word () != version)
+        throw std::runtime_error ("FunctionArchive: " + filename
+            + " has another version");
+      Functions_t functions (reader.size ());
+      for (std::size_t i = 0; i < functions.size (); ++i)
+        functions [i] = reader.function ();
+      return functions;
+    }
+  } // namespace constraints
+} // namespace hpp
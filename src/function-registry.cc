@@ -0,0 +1,161 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/function-registry.hh>
+
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/constraints/configuration-constraint.hh>
+#include <hpp/constraints/relative-com.hh>
+
+namespace hpp {
+  namespace constraints {
+    FunctionRegistryPtr_t FunctionRegistry::create ()
+    {
+      return FunctionRegistryPtr_t (new FunctionRegistry ());
+    }
+
+    RelativeComPtr_t FunctionRegistry::relativeCom (const DevicePtr_t& robot,
+        const CenterOfMassComputationPtr_t& comc, const JointPtr_t& joint,
+        const vector3_t& reference, std::vector <bool> mask)
+    {
+      Key key (typeid (RelativeCom), robot);
+      key.add (comc.get ());
+      key.add (joint);
+      key.add (reference);
+      key.add (mask);
+      RelativeComPtr_t f =
+        boost::static_pointer_cast <RelativeCom> (find (key));
+      if (f) return f;
+      if (comc) f = RelativeCom::create (robot, comc, joint, reference, mask);
+      else      f = RelativeCom::create (robot, joint, reference, mask);
+      insert (key, f);
+      return f;
+    }
+
+    ConfigurationConstraintPtr_t FunctionRegistry::configurationConstraint
+    (const std::string& name, const DevicePtr_t& robot,
+     ConfigurationIn_t goal, std::vector <bool> mask)
+    {
+      Key key (typeid (ConfigurationConstraint), robot);
+      key.add (goal);
+      key.add (mask);
+      ConfigurationConstraintPtr_t f = boost::static_pointer_cast
+        <ConfigurationConstraint> (find (key));
+      if (f) return f;
+      f = ConfigurationConstraint::create (name, robot, goal, mask);
+      insert (key, f);
+      return f;
+    }
+
+    ConfigurationConstraintPtr_t FunctionRegistry::configurationConstraint
+    (const std::string& name, const DevicePtr_t& robot,
+     ConfigurationIn_t goal, const vector_t& weights)
+    {
+      Key key (typeid (ConfigurationConstraint), robot);
+      key.add (goal);
+      key.add (weights);
+      // Distinguish the weights from a mask of the same length.
+      key.add (&typeid (vector_t));
+      ConfigurationConstraintPtr_t f = boost::static_pointer_cast
+        <ConfigurationConstraint> (find (key));
+      if (f) return f;
+      f = ConfigurationConstraint::create (name, robot, goal, weights);
+      insert (key, f);
+      return f;
+    }
+
+    std::size_t FunctionRegistry::size () const
+    {
+      std::size_t n = 0;
+      for (Functions_t::const_iterator _f = functions_.begin ();
+          _f != functions_.end (); ++_f)
+        if (!_f->second.expired ()) ++n;
+      return n;
+    }
+
+    DifferentiableFunctionPtr_t FunctionRegistry::find (const Key& key) const
+    {
+      Functions_t::const_iterator _f = functions_.find (key);
+      if (_f == functions_.end ()) return DifferentiableFunctionPtr_t ();
+      return _f->second.lock ();
+    }
+
+    void FunctionRegistry::insert (const Key& key,
+        const DifferentiableFunctionPtr_t& f)
+    {
+      functions_[key] = f;
+
+      // Remove instances that are not used anymore.
+      for (Functions_t::iterator _f = functions_.begin ();
+          _f != functions_.end ();) {
+        if (_f->second.expired ()) functions_.erase (_f++);
+        else ++_f;
+      }
+    }
+
+    FunctionRegistry::Key::Key (const std::type_info& t,
+        const DevicePtr_t& robot) : type (&t)
+    {
+      objects.push_back (robot.get ());
+    }
+
+    void FunctionRegistry::Key::add (const JointConstPtr_t& joint)
+    {
+      // The robot is part of the key, the index identifies the joint.
+      numbers.push_back (joint ? (value_type) joint->index () : -1);
+    }
+
+    void FunctionRegistry::Key::add (const Transform3f& M)
+    {
+      const matrix3_t& R = M.rotation ();
+      for (int j = 0; j < 3; ++j)
+        for (int i = 0; i < 3; ++i)
+          numbers.push_back (R (i, j));
+      for (int i = 0; i < 3; ++i)
+        numbers.push_back (M.translation () [i]);
+    }
+
+    void FunctionRegistry::Key::add (const std::vector <bool>& mask)
+    {
+      numbers.push_back ((value_type) mask.size ());
+      for (std::size_t i = 0; i < mask.size (); ++i)
+        numbers.push_back (mask[i] ? 1 : 0);
+    }
+
+    void FunctionRegistry::Key::add (vectorIn_t v)
+    {
+      numbers.push_back ((value_type) v.size ());
+      for (size_type i = 0; i < v.size (); ++i)
+        numbers.push_back (v[i]);
+    }
+
+    void FunctionRegistry::Key::add (const void* object)
+    {
+      objects.push_back (object);
+    }
+
+    bool FunctionRegistry::Key::operator< (const Key& other) const
+    {
+      if (*type != *other.type) return type->before (*other.type);
+      if (objects != other.objects) return objects < other.objects;
+      return numbers < other.numbers;
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -16,6 +16,10 @@
 
 #include <hpp/constraints/generic-transformation.hh>
 
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
 #include <hpp/fcl/math/transform.h>
 
 #include <hpp/pinocchio/device.hh>
@@ -23,14 +27,16 @@
 
 #include <hpp/constraints/tools.hh>
 #include <hpp/constraints/macros.hh>
+#include <hpp/constraints/kinematics-batch.hh>
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/lipschitz.hh>
+#include <hpp/constraints/packed-kinematics.hh>
+#include <hpp/constraints/relative-kinematics.hh>
+#include <hpp/constraints/workspace.hh>
 
 namespace hpp {
   namespace constraints {
     namespace {
-      typedef JointJacobian_t::ConstNRowsBlockXpr<3>::Type HalfJacobian_t;
-      inline HalfJacobian_t omega(const JointJacobian_t& j) { return j.bottomRows<3>(); }
-      inline HalfJacobian_t trans(const JointJacobian_t& j) { return j.topRows<3>(); }
-
       static inline size_type size (std::vector<bool> mask)
       {
         size_type res = 0;
@@ -43,21 +49,24 @@ namespace hpp {
 
       template <bool flag /* false */ > struct unary
       {
-        template <bool rel, bool pos> static inline void log (
-            const GenericTransformationData<rel, pos, flag>&) {}
-        template <bool rel, bool pos> static inline void Jlog (
-            const GenericTransformationData<rel, pos, flag>&) {}
+        template <bool rel, bool pos, int nv> static inline void log (
+            const GenericTransformationData<rel, pos, flag, nv>&) {}
+        template <bool rel, bool pos, int nv> static inline void Jlog (
+            const GenericTransformationData<rel, pos, flag, nv>&) {}
       };
       template <> struct unary <true>
       {
-        template <bool rel, bool pos> static inline void log (
-            const GenericTransformationData<rel, pos, true>& d)
+        template <bool rel, bool pos, int nv> static inline void log (
+            const GenericTransformationData<rel, pos, true, nv>& d)
           {
-            computeLog(d.M.rotation(), d.theta, d.value.template tail<3>());
+            if (d.useQuaternion)
+              computeLogFromQuaternion(d.M.rotation(), d.theta, d.value.template tail<3>());
+            else
+              computeLog(d.M.rotation(), d.theta, d.value.template tail<3>());
             hppDnum (info, "theta=" << d.theta);
           }
-        template <bool rel, bool pos> static inline void Jlog (
-            const GenericTransformationData<rel, pos, true>& d)
+        template <bool rel, bool pos, int nv> static inline void Jlog (
+            const GenericTransformationData<rel, pos, true, nv>& d)
           {
             computeJlog(d.theta, d.value.template tail<3>(), d.JlogXTR1inJ1);
             hppDnum (info, "Jlog_: " << d.JlogXTR1inJ1);
@@ -65,214 +74,320 @@ namespace hpp {
           }
       };
 
-      template <bool ori, typename Data, typename Derived> void assign_if
-        (bool cond, const Data& d, matrixOut_t J,
-         const Eigen::MatrixBase<Derived>& rhs,
-         const size_type& startRow)
+      /// Write L * X in the rows of J selected by the mask.
+      /// L is a 3x3 matrix and X has the active columns of J.
+      template <bool ori, typename Data, typename Lhs, typename Rhs> void assign
+        (const Data& d, matrixOut_t J, const Eigen::MatrixBase<Lhs>& L,
+         const Eigen::MatrixBase<Rhs>& X)
+      {
+        const matrix3_t l (L);
+        const size_type first = (ori ? Data::RowOri : Data::RowPos);
+        if (ori ? d.fullOri : d.fullPos)
+          J.template middleRows<3>(d.outputRow[first]).middleCols(d.colBegin, d.activeCols).noalias() = l * X;
+        else
+          for (size_type k = 0; k < 3; ++k)
+            if (d.outputRow[first + k] >= 0)
+              J.row(d.outputRow[first + k]).segment(d.colBegin, d.activeCols).noalias() = l.row(k) * X;
+      }
+
+      /// Write X in the rows of J selected by the mask.
+      template <bool ori, typename Data, typename Rhs> void assign
+        (const Data& d, matrixOut_t J, const Eigen::MatrixBase<Rhs>& X)
       {
-        const int& rowCache = (ori ? Data::RowOri : Data::RowPos);
-        if (cond) d.jacobian.template middleRows<3>(rowCache)                 .noalias() = rhs;
-        else               J.template middleRows<3>(startRow).leftCols(d.cols).noalias() = rhs;
+        const size_type first = (ori ? Data::RowOri : Data::RowPos);
+        if (ori ? d.fullOri : d.fullPos)
+          J.template middleRows<3>(d.outputRow[first]).middleCols(d.colBegin, d.activeCols).noalias() = X;
+        else
+          for (size_type k = 0; k < 3; ++k)
+            if (d.outputRow[first + k] >= 0)
+              J.row(d.outputRow[first + k]).segment(d.colBegin, d.activeCols).noalias() = X.row(k);
+      }
+
+      /// Copy the coordinates of value selected by the mask.
+      template <typename Data> inline void copyValue
+        (const Data& d, const typename Data::ValueType& value,
+         vectorOut_t result)
+      {
+        if (d.outputSize == Data::NbRows) {
+          result = value;
+          return;
+        }
+        for (size_type i = 0; i < Data::NbRows; ++i)
+          if (d.outputRow[i] >= 0) result[d.outputRow[i]] = value[i];
+      }
+
+      /// Copy the coordinates of the error selected by the mask.
+      template <typename Data> inline void copyValue
+        (const Data& d, vectorOut_t result)
+      {
+        copyValue (d, d.value, result);
+      }
+
+      /// Inverse of copyValue, the coordinates masked out are set to 0.
+      template <typename Data> inline void expandValue
+        (const Data& d, vectorIn_t result, typename Data::ValueType& value)
+      {
+        for (size_type i = 0; i < Data::NbRows; ++i)
+          value[i] = (d.outputRow[i] >= 0 ? result[d.outputRow[i]] : 0);
+      }
+
+      /// View of a jacobian of RelativeKinematics with the number of
+      /// columns of Data, fixed size if Data::NV is not Eigen::Dynamic.
+      template <typename Data> inline typename Data::JacobianMap_t
+        jacobianMap (const Data& d, const RelativeKinematics::Jacobian_t& J)
+      {
+        assert (J.cols () == d.activeCols);
+        return typename Data::JacobianMap_t (J.data (), 3, d.activeCols);
+      }
+
+      /// Velocity of the origin of frame 2 with respect to joint 1,
+      /// expressed in the world frame.
+      template <typename Data> inline typename Data::JacobianMap_t
+        frameVelocity (const Data& d)
+      {
+        // T + [ 0R2 2t* ]x W
+        const RelativeKinematics& rk (*d.relative);
+        if (d.t2isZero) return jacobianMap (d, rk.translation ());
+        matrix3_t X;
+        computeCrossMatrix (d.cross2, X);
+        d.tmpJac.noalias() = X * jacobianMap (d, rk.rotation ());
+        d.tmpJac += jacobianMap (d, rk.translation ());
+        return typename Data::JacobianMap_t (d.tmpJac.data (), 3, d.activeCols);
       }
 
       template <bool lflag /*rel*/, bool rflag /*false*/> struct binary
       {
         // the first template allow us to consider relative transformation as
         // absolute when joint1 is NULL, at run time
-        template <bool rel, bool pos> static inline void Jorientation (
-            const GenericTransformationData<rel, pos, rflag>&, matrixOut_t) {}
-        template <bool rel, bool ori> static inline void Jtranslation (
-            const GenericTransformationData<rel, rflag, ori>&, matrixOut_t) {}
+        template <bool rel, bool pos, int nv> static inline void Jorientation (
+            const GenericTransformationData<rel, pos, rflag, nv>&, matrixOut_t) {}
+        template <bool rel, bool ori, int nv> static inline void Jtranslation (
+            const GenericTransformationData<rel, rflag, ori, nv>&, matrixOut_t) {}
+        template <bool rel, bool pos, int nv> static inline void Lorientation (
+            const GenericTransformationData<rel, pos, rflag, nv>&, matrix3_t&) {}
+        template <bool rel, bool ori, int nv> static inline void Ltranslation (
+            const GenericTransformationData<rel, rflag, ori, nv>&, matrix3_t&) {}
       };
       template <> struct binary<false, true> // Absolute
       {
-        template <bool rel, bool pos> static inline void Jorientation (
-            const GenericTransformationData<rel, pos, true>& d, matrixOut_t J)
+        template <bool rel, bool pos, int nv> static inline void Jorientation (
+            const GenericTransformationData<rel, pos, true, nv>& d, matrixOut_t J)
         {
-          assign_if<true>(!d.fullOri, d, J,
-            (d.JlogXTR1inJ1 * d.R2()) * omega(d.J2()),
-            d.rowOri);
+          // J = Jlog 1RT* 0R2 2Jw2 = - Jlog 1RT* W
+          assign<true>(d, J, - d.JlogXTR1inJ1,
+              jacobianMap (d, d.relative->rotation ()));
         }
-        template <bool rel, bool ori> static inline void Jtranslation (
-            const GenericTransformationData<rel, true, ori>& d,
+        template <bool rel, bool ori, int nv> static inline void Jtranslation (
+            const GenericTransformationData<rel, true, ori, nv>& d,
             matrixOut_t J)
         {
-          const JointJacobian_t& J2 (d.J2());
-          const matrix3_t& R2 (d.R2());
           const matrix3_t& R1inJ1 (d.F1inJ1.rotation ());
 
-          // hpp-model: J = 1RT* ( 0Jt2 - [ 0R2 2t* ]x 0Jw2 )
-          // pinocchio: J = 1RT* ( 0R2 2Jt2 - [ 0R2 2t* ]x 0R2 2Jw2 )
-          if (!d.t2isZero) {
-            d.tmpJac.noalias() = ( R2.colwise().cross(d.cross2)) * omega(J2);
-            d.tmpJac.noalias() += R2 * trans(J2);
-            if (d.R1isID) {
-              assign_if<false> (!d.fullPos, d, J, d.tmpJac, 0);
-            } else { // Generic case
-              assign_if<false> (!d.fullPos, d, J, R1inJ1.transpose() * d.tmpJac, 0);
-            }
-          } else {
-            if (d.R1isID)
-              assign_if<false> (!d.fullPos, d, J, R2 * trans(J2), 0);
-            else
-              assign_if<false> (!d.fullPos, d, J, (R1inJ1.transpose() * R2) * trans(J2), 0);
-          }
+          // J = 1RT* ( T + [ 0R2 2t* ]x W ) with T = 0R2 2Jt2
+          if (d.R1isID) assign<false> (d, J, frameVelocity (d));
+          else assign<false> (d, J, R1inJ1.transpose(), frameVelocity (d));
+        }
+        // The rows of the jacobian are L W for the orientation and
+        // L ( T + [ 0R2 2t* ]x W ) for the translation.
+        template <bool rel, bool pos, int nv> static inline void Lorientation (
+            const GenericTransformationData<rel, pos, true, nv>& d, matrix3_t& L)
+        {
+          L.noalias() = - d.JlogXTR1inJ1;
+        }
+        template <bool rel, bool ori, int nv> static inline void Ltranslation (
+            const GenericTransformationData<rel, true, ori, nv>& d, matrix3_t& L)
+        {
+          if (d.R1isID) L.setIdentity ();
+          else L.noalias() = d.F1inJ1.rotation ().transpose ();
         }
       };
       template <> struct binary<true, true> // Relative
       {
-        template <bool pos> static inline void Jorientation (
-            const GenericTransformationData<true, pos, true>& d,
+        template <bool pos, int nv> static inline void Jorientation (
+            const GenericTransformationData<true, pos, true, nv>& d,
             matrixOut_t J)
         {
-          d.tmpJac.noalias() =
-                  d.R2() * omega(d.J2())
-                - d.R1() * omega(d.J1());
-          assign_if<true>(!d.fullOri, d, J,
-              d.JlogXTR1inJ1 * d.R1().transpose () * d.tmpJac,
-              d.rowOri);
+          // J = Jlog 1RT* 0RT1 ( 0R2 2Jw2 - 0R1 1Jw1 ) = - Jlog 1RT* 0RT1 W
+          assign<true>(d, J, - d.JlogXTR1inJ1 * d.R1().transpose (),
+              jacobianMap (d, d.relative->rotation ()));
         }
-        template <bool ori> static inline void Jtranslation (
-            const GenericTransformationData<true, true, ori>& d,
+        template <bool ori, int nv> static inline void Jtranslation (
+            const GenericTransformationData<true, true, ori, nv>& d,
             matrixOut_t J)
         {
-          const JointJacobian_t& J1 (d.J1()); const JointJacobian_t& J2 (d.J2());
-          const matrix3_t&       R1 (d.R1()); const matrix3_t&       R2 (d.R2());
+          const matrix3_t& R1 (d.R1());
           const matrix3_t& R1inJ1 (d.F1inJ1.rotation ());
 
-          // J = 1RT* 0RT1 ( A + B )
-          // hpp-model:
-          // A = [ 0t2 - 0t1 0R2 2t* ]x 0Jw1
-          // B = ( 0Jt2 - 0Jt1 - [ 0R2 2t* ]x 0Jw2 )
-          // pinocchio:
-          // A = [ 0t2 - 0t1 0R2 2t* ]x 0R1 1Jw1
-          // B = ( 0R2 2Jt2 - 0R1 1Jt1 - [ 0R2 2t* ]x 0R2 2Jw2 )
-          d.tmpJac.noalias() =
-            - R1.colwise().cross(d.cross1) * omega(J1) // A
-            + R2 * trans(J2)  // B1
-            - R1 * trans(J1); // B2
-          if (!d.t2isZero)
-            d.tmpJac.noalias() += R2.colwise().cross(d.cross2) * omega(J2); // B3
-          if (d.R1isID) assign_if<false>(!d.fullPos, d, J,                       R1.transpose()  * d.tmpJac, 0);
-          else          assign_if<false>(!d.fullPos, d, J, (R1inJ1.transpose() * R1.transpose()) * d.tmpJac, 0);
+          // J = 1RT* 0RT1 ( T + [ 0R2 2t* ]x W ) with
+          // T = [ 0t2 - 0t1 ]x 0R1 1Jw1 + 0R2 2Jt2 - 0R1 1Jt1
+          // W = 0R1 1Jw1 - 0R2 2Jw2
+          // See RelativeKinematics.
+          if (d.R1isID) assign<false>(d, J,                        R1.transpose(), frameVelocity (d));
+          else          assign<false>(d, J, R1inJ1.transpose() * R1.transpose(), frameVelocity (d));
+        }
+        template <bool pos, int nv> static inline void Lorientation (
+            const GenericTransformationData<true, pos, true, nv>& d, matrix3_t& L)
+        {
+          L.noalias() = - d.JlogXTR1inJ1 * d.R1().transpose ();
+        }
+        template <bool ori, int nv> static inline void Ltranslation (
+            const GenericTransformationData<true, true, ori, nv>& d, matrix3_t& L)
+        {
+          if (d.R1isID) L.noalias() = d.R1().transpose ();
+          else L.noalias() = d.F1inJ1.rotation ().transpose () * d.R1().transpose ();
         }
       };
 
-      template <bool compileTimeRel /* false */, bool ori /* false */> struct relativeTransform {
-        template <bool runtimeRel> static inline void run (
-            const GenericTransformationData<runtimeRel, true, false>& d)
+      // The placement of joint2 in joint1 (in the world frame if there is
+      // no joint1) is computed by RelativeKinematics.
+      template <bool ori /* false */> struct relativeTransform {
+        template <bool rel, int nv> static inline void run (
+            const GenericTransformationData<rel, true, false, nv>& d)
         {
-          // There is no joint1
-          const Transform3f& J2 = d.joint2->currentTransformation ();
-          d.value.noalias() = J2.act (d.F2inJ2.translation());
+          d.value.noalias() = d.relative->placement ().act (d.F2inJ2.translation());
           if (!d.t1isZero) d.value.noalias() -= d.F1inJ1.translation();
           if (!d.R1isID)
             d.value.applyOnTheLeft(d.F1inJ1.rotation().transpose());
         }
       };
-      template <> struct relativeTransform<false, true> {
-        template <bool runtimeRel, bool pos> static inline void run (
-            const GenericTransformationData<runtimeRel, pos, true>& d)
-        {
-          const Transform3f& J2 = d.joint2->currentTransformation ();
-          d.M = d.F1inJ1.actInv(J2 * d.F2inJ2);
-          if (pos) d.value.template head<3>().noalias() = d.M.translation();
-        }
-      };
-      template <> struct relativeTransform<true, true> {
-        template <bool pos> static inline void run (
-            const GenericTransformationData<true, pos, true>& d)
+      template <> struct relativeTransform<true> {
+        template <bool rel, bool pos, int nv> static inline void run (
+            const GenericTransformationData<rel, pos, true, nv>& d)
         {
-          if (d.joint1 == NULL) {
-            // runtime absolute reference.
-            relativeTransform<false, true>::run(d);
-            return;
-          }
-          const Transform3f& J1 = d.joint1->currentTransformation ();
-          const Transform3f& J2 = d.joint2->currentTransformation ();
-          d.M = d.F1inJ1.actInv(J1.actInv(J2 * d.F2inJ2));
+          d.M = d.F1inJ1.actInv(d.relative->placement () * d.F2inJ2);
           if (pos) d.value.template head<3>().noalias() = d.M.translation();
         }
       };
-      template <> struct relativeTransform<true, false> {
-        static inline void run (const GenericTransformationData<true, true, false>& d)
-        {
-          if (d.joint1 == NULL) {
-            // runtime absolute reference.
-            relativeTransform<false, false>::run(d);
-            return;
-          }
-          const Transform3f& J2 = d.joint2->currentTransformation ();
-          const Transform3f& J1 = d.joint1->currentTransformation ();
-          d.value.noalias() = J2.act (d.F2inJ2.translation())
-                              - J1.translation();
-          d.value.applyOnTheLeft(J1.rotation().derived().transpose());
-
-          if (!d.t1isZero) d.value.noalias() -= d.F1inJ1.translation();
-          if (!d.R1isID)
-            d.value.applyOnTheLeft(d.F1inJ1.rotation().derived().transpose());
-        }
-      };
 
-      template <bool rel, bool pos, bool ori> struct compute
+      template <bool rel, bool pos, bool ori, int nv> struct compute
       {
-        static inline void error (const GenericTransformationData<rel, pos, ori>& d)
+        static inline void error (const GenericTransformationData<rel, pos, ori, nv>& d)
         {
-          relativeTransform<rel, ori>::run (d);
+          relativeTransform<ori>::run (d);
           unary<ori>::log(d);
         }
 
-        static inline void jacobian (const GenericTransformationData<rel, pos, ori>& d,
-            matrixOut_t jacobian, const std::vector<bool>& mask)
+        static inline void jacobian (const GenericTransformationData<rel, pos, ori, nv>& d,
+            matrixOut_t jacobian)
         {
-          const Transform3f& J2 = d.joint2->currentTransformation ();
-          const vector3_t& t2inJ2 (d.F2inJ2.translation ());
-          const vector3_t& t2 (J2.translation ());
-          const matrix3_t& R2 (J2.rotation ());
-
           if (!d.t2isZero)
-            d.cross2.noalias() = R2*t2inJ2;
+            d.cross2.noalias() = d.R2() * d.F2inJ2.translation ();
 
           unary<ori>::Jlog (d);
 
           // rel:           relative known at compile time
           // d.getJoint1(): relative known at run time
           if (rel && d.getJoint1()) {
-            const Transform3f& J1 = d.getJoint1()->currentTransformation ();
-            const vector3_t& t1 (J1.translation ());
-            d.cross1.noalias() = d.cross2 + t2 - t1;
             binary<rel, pos>::Jtranslation (d, jacobian);
             binary<rel, ori>::Jorientation (d, jacobian);
           } else {
-            d.cross1.noalias() = d.cross2 + t2;
             binary<false, pos>::Jtranslation (d, jacobian);
             binary<false, ori>::Jorientation (d, jacobian);
           }
 
-          // Copy necessary rows.
-          size_type index=0;
-          const std::size_t lPos = (pos?3:0), lOri = (ori?3:0);
-          if (!d.fullPos) {
-            for (size_type i=0; i<lPos; ++i) {
-              if (mask [i]) {
-                jacobian.row(index).leftCols(d.cols).noalias() = d.jacobian.row(i); ++index;
-              }
-            }
-          } else index = lPos;
-          if (!d.fullOri) {
-            for (size_type i=lPos; i<lPos+lOri; ++i) {
-              if (mask [i]) {
-                jacobian.row(index).leftCols(d.cols).noalias() = d.jacobian.row(i); ++index;
-              }
-            }
+          jacobian.leftCols(d.colBegin).setZero();
+          jacobian.rightCols(jacobian.cols()-d.colBegin-d.activeCols).setZero();
+        }
+
+        /// Left factors of the rows of the jacobian, see binary.
+        static inline void factors (const GenericTransformationData<rel, pos, ori, nv>& d,
+            matrix3_t& Lpos, matrix3_t& Lori)
+        {
+          if (!d.t2isZero)
+            d.cross2.noalias() = d.R2() * d.F2inJ2.translation ();
+
+          unary<ori>::Jlog (d);
+
+          if (rel && d.getJoint1()) {
+            binary<rel, pos>::Ltranslation (d, Lpos);
+            binary<rel, ori>::Lorientation (d, Lori);
+          } else {
+            binary<false, pos>::Ltranslation (d, Lpos);
+            binary<false, ori>::Lorientation (d, Lori);
+          }
+        }
+
+        /// Compute J v from the relative velocity of the frames, without
+        /// computing J.
+        static inline void jacobianTimes (const GenericTransformationData<rel, pos, ori, nv>& d,
+            vectorIn_t v, vectorOut_t result)
+        {
+          typedef GenericTransformationData<rel, pos, ori, nv> Data;
+          matrix3_t Lpos, Lori;
+          factors (d, Lpos, Lori);
+          const RelativeKinematics& rk (*d.relative);
+          const Eigen::VectorBlock<vectorIn_t> x (v.segment (d.colBegin, d.activeCols));
+          const vector3_t W (rk.rotation () * x);
+          typename Data::ValueType Jv;
+          if (pos) {
+            // T + [ 0R2 2t* ]x W
+            vector3_t T (rk.translation () * x);
+            if (!d.t2isZero) T += d.cross2.cross (W);
+            Jv.template segment<3> (Data::RowPos).noalias() = Lpos * T;
           }
-          jacobian.rightCols(jacobian.cols()-d.cols).setZero();
+          if (ori) Jv.template segment<3> (Data::RowOri).noalias() = Lori * W;
+          copyValue (d, Jv, result);
         }
+
+        /// Compute J^T w by pulling w back to the relative velocity of the
+        /// frames, without computing J.
+        static inline void jacobianTransposeTimes (const GenericTransformationData<rel, pos, ori, nv>& d,
+            vectorIn_t w, vectorOut_t result)
+        {
+          typedef GenericTransformationData<rel, pos, ori, nv> Data;
+          matrix3_t Lpos, Lori;
+          factors (d, Lpos, Lori);
+          const RelativeKinematics& rk (*d.relative);
+          typename Data::ValueType y;
+          expandValue (d, w, y);
+          vector3_t yW (vector3_t::Zero ());
+          result.setZero ();
+          Eigen::VectorBlock<vectorOut_t> x (result.segment (d.colBegin, d.activeCols));
+          if (pos) {
+            const vector3_t yT (Lpos.transpose () * y.template segment<3> (Data::RowPos));
+            // [ 0R2 2t* ]x^T yT = yT x 0R2 2t*
+            if (!d.t2isZero) yW = yT.cross (d.cross2);
+            x.noalias() = rk.translation ().transpose () * yT;
+          }
+          if (ori) yW.noalias() += Lori.transpose () * y.template segment<3> (Data::RowOri);
+          x.noalias() += rk.rotation ().transpose () * yW;
+        }
+      };
+    }
+
+    namespace {
+      template <typename Data>
+      struct GenericTransformationWorkspaceData : Workspace::FunctionData
+      {
+        GenericTransformationWorkspaceData (const Data& data) :
+          d (data), version (0),
+          definitionVersion (std::numeric_limits<std::size_t>::max()) {}
+        Data d;
+        std::size_t version, definitionVersion;
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
       };
+
+      /// Copy the definition and bind the joints to the workspace robot.
+      template <bool rel, bool pos, bool ori, int nv> void copyDefinition
+        (const GenericTransformationData<rel, pos, ori, nv>& from,
+         GenericTransformationData<rel, pos, ori, nv>& to,
+         const Workspace& workspace)
+      {
+        to.F1inJ1 = from.F1inJ1; to.R1isID = from.R1isID; to.t1isZero = from.t1isZero;
+        to.F2inJ2 = from.F2inJ2; to.R2isID = from.R2isID; to.t2isZero = from.t2isZero;
+        to.colBegin = from.colBegin; to.activeCols = from.activeCols;
+        to.tmpJac.resize (3, from.activeCols);
+        to.useQuaternion = from.useQuaternion;
+        if (to.t2isZero) to.cross2.setZero();
+        to.setJoint1 (workspace.joint (from.getJoint1 ()));
+        to.joint2 = workspace.joint (from.joint2);
+        to.relative = RelativeKinematics::get (workspace.kinematics (),
+            to.getJoint1 (), to.joint2, to.colBegin, to.activeCols);
+      }
     }
 
-    template <int _Options> std::ostream&
-      GenericTransformation<_Options>::print (std::ostream& os) const
+    template <int _Options, int _NV> std::ostream&
+      GenericTransformation<_Options, _NV>::print (std::ostream& os) const
     {
       os << (IsRelative ? "Relative" : "") <<
             (IsPosition ? (IsOrientation ? "Transformation" : "Position")
@@ -286,14 +401,48 @@ namespace hpp {
       return os;
     }
 
-    template <int _Options> typename GenericTransformation<_Options>::Ptr_t
-      GenericTransformation<_Options>::create
+    template <int _Options, int _NV> MemoryUsage
+      GenericTransformation<_Options, _NV>::memoryUsage () const
+    {
+      MemoryUsage m (DifferentiableFunction::memoryUsage ());
+      m.definition += sizeof (GenericTransformation)
+        - sizeof (DifferentiableFunction)
+        + memorySize (mask_) + memorySize (joints_);
+      m.scratch += memorySize (d_.tmpJac);
+      return m;
+    }
+
+    template <int _Options, int _NV> value_type
+      GenericTransformation<_Options, _NV>::lipschitzConstant () const
+    {
+      if (!joint2 ()) return DifferentiableFunction::lipschitzConstant ();
+      bool pos = false, ori = false, fullOri = true;
+      for (size_type i = 0; i < ValueSize; ++i) {
+        if (ComputePosition && i < 3) pos = pos || mask_ [i];
+        else {
+          ori = ori || mask_ [i];
+          fullOri = fullOri && mask_ [i];
+        }
+      }
+      if (ori && !fullOri)
+        return DifferentiableFunction::lipschitzConstant ();
+      const VelocityBounds bounds (relativeVelocityBounds (robot_,
+            (IsRelative && joint1 ()) ? joint1 ()->index () : 0,
+            joint2 ()->index (), d_.F2inJ2.translation ().norm ()));
+      value_type squared = 0;
+      if (pos) squared += bounds.linear * bounds.linear;
+      if (ori) squared += bounds.angular * bounds.angular;
+      return std::sqrt (squared);
+    }
+
+    template <int _Options, int _NV> typename GenericTransformation<_Options, _NV>::Ptr_t
+      GenericTransformation<_Options, _NV>::create
     (const std::string& name, const DevicePtr_t& robot,
      const JointConstPtr_t& joint2,
      const Transform3f& reference, std::vector <bool> mask)
     {
-      GenericTransformation<_Options>* ptr =
-        new GenericTransformation<_Options> (name, robot, mask);
+      GenericTransformation<_Options, _NV>* ptr =
+        new GenericTransformation<_Options, _NV> (name, robot, mask);
       ptr->joint1 (JointConstPtr_t());
       ptr->joint2 (joint2);
       ptr->reference (reference);
@@ -302,15 +451,15 @@ namespace hpp {
       return shPtr;
     }
 
-    template <int _Options> typename GenericTransformation<_Options>::Ptr_t
-      GenericTransformation<_Options>::create
+    template <int _Options, int _NV> typename GenericTransformation<_Options, _NV>::Ptr_t
+      GenericTransformation<_Options, _NV>::create
     (const std::string& name, const DevicePtr_t& robot,
      /* World frame          */ const JointConstPtr_t& joint2,
      const Transform3f& frame2, const Transform3f& frame1,
      std::vector <bool> mask)
     {
-      GenericTransformation<_Options>* ptr =
-        new GenericTransformation<_Options> (name, robot, mask);
+      GenericTransformation<_Options, _NV>* ptr =
+        new GenericTransformation<_Options, _NV> (name, robot, mask);
       ptr->joint1 (JointConstPtr_t());
       ptr->joint2 (joint2);
       ptr->frame1InJoint1 (frame1);
@@ -319,14 +468,14 @@ namespace hpp {
       return shPtr;
     }
 
-    template <int _Options> typename GenericTransformation<_Options>::Ptr_t
-      GenericTransformation<_Options>::create
+    template <int _Options, int _NV> typename GenericTransformation<_Options, _NV>::Ptr_t
+      GenericTransformation<_Options, _NV>::create
     (const std::string& name, const DevicePtr_t& robot,
      const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
      const Transform3f& reference, std::vector <bool> mask)
     {
-      GenericTransformation<_Options>* ptr =
-        new GenericTransformation<_Options> (name, robot, mask);
+      GenericTransformation<_Options, _NV>* ptr =
+        new GenericTransformation<_Options, _NV> (name, robot, mask);
       ptr->joint1 (joint1);
       ptr->joint2 (joint2);
       ptr->reference (reference);
@@ -335,15 +484,15 @@ namespace hpp {
       return shPtr;
     }
 
-    template <int _Options> typename GenericTransformation<_Options>::Ptr_t
-      GenericTransformation<_Options>::create
+    template <int _Options, int _NV> typename GenericTransformation<_Options, _NV>::Ptr_t
+      GenericTransformation<_Options, _NV>::create
     (const std::string& name, const DevicePtr_t& robot,
      const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
      const Transform3f& frame1, const Transform3f& frame2,
      std::vector <bool> mask)
     {
-      GenericTransformation<_Options>* ptr =
-        new GenericTransformation<_Options> (name, robot, mask);
+      GenericTransformation<_Options, _NV>* ptr =
+        new GenericTransformation<_Options, _NV> (name, robot, mask);
       ptr->joint1 (joint1);
       ptr->joint2 (joint2);
       ptr->frame1InJoint1 (frame1);
@@ -352,13 +501,15 @@ namespace hpp {
       return shPtr;
     }
 
-    template <int _Options>
-      GenericTransformation<_Options>::GenericTransformation
+    template <int _Options, int _NV>
+      GenericTransformation<_Options, _NV>::GenericTransformation
       (const std::string& name, const DevicePtr_t& robot,
        std::vector <bool> mask) :
         DifferentiableFunction (robot->configSize (), robot->numberDof (),
 			      size (mask), name),
-      robot_ (robot), d_(robot->numberDof()-robot->extraConfigSpace().dimension()), mask_ (mask)
+      robot_ (robot), d_(robot->numberDof()-robot->extraConfigSpace().dimension()), mask_ (mask),
+      kinematics_ (KinematicsCache::get (robot)), latestVersion_ (0),
+      definitionVersion_ (0)
     {
       assert(mask.size()==ValueSize);
       std::size_t iOri = 0;
@@ -371,41 +522,411 @@ namespace hpp {
       if (ComputeOrientation)
         d_.fullOri = mask_[iOri + 0] && mask_[iOri + 1] && mask_[iOri + 2];
       else d_.fullOri = false;
+      // Decode the mask once for all.
+      d_.outputSize = 0;
+      for (size_type i=0; i<ValueSize; ++i)
+        d_.outputRow[i] = (mask_[i] ? d_.outputSize++ : -1);
+      if (_NV != Eigen::Dynamic && d_.cols != _NV)
+        throw std::invalid_argument ("GenericTransformation: the robot "
+            "does not have the number of degrees of freedom of the "
+            "function");
     }
 
-    template <int _Options>
-    inline void GenericTransformation<_Options>::computeError (const ConfigurationIn_t& argument) const
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::computeActiveColumns ()
+    {
+      activeDerivativeColumns_.setConstant (false);
+      // The columns of the common ancestors of the joints cancel out.
+      activateRelativeColumns (d_.getJoint1 (), d_.joint2);
+      // Columns of the extra config space are always zero.
+      size_type begin = 0, end = d_.cols;
+      // With a fixed number of columns, all of them are kept so that the
+      // jacobians of RelativeKinematics have the size known at compile time.
+      if (_NV == Eigen::Dynamic) {
+        while (begin < end && !activeDerivativeColumns_[begin]) ++begin;
+        while (end > begin && !activeDerivativeColumns_[end - 1]) --end;
+      }
+      d_.colBegin = begin;
+      d_.activeCols = end - begin;
+      // Resize now so that the evaluation does not allocate memory.
+      d_.tmpJac.resize (3, d_.activeCols);
+      joints_.clear ();
+      KinematicsCache::addJoint (joints_, d_.getJoint1 ());
+      KinematicsCache::addJoint (joints_, d_.joint2);
+      if (d_.joint2)
+        d_.relative = RelativeKinematics::get (kinematics_, d_.getJoint1 (),
+            d_.joint2, d_.colBegin, d_.activeCols);
+      else
+        d_.relative.reset ();
+    }
+
+    template <int _Options, int _NV>
+    inline void GenericTransformation<_Options, _NV>::computeError
+    (const ConfigurationIn_t& argument, int quantities) const
     {
       hppDnum (info, "argument=" << argument.transpose ());
-      if (argument.size () != latestArgument_.size () ||
-	  argument != latestArgument_) {
-	robot_->currentConfiguration (argument);
-	robot_->computeForwardKinematics ();
-        compute<IsRelative, ComputePosition, ComputeOrientation>::error (d_);
-	latestArgument_.noalias() = argument;
+      kinematics_->update (argument, quantities, joints_);
+      if (latestVersion_ != kinematics_->version ()) {
+        compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::error (d_);
+        latestVersion_ = kinematics_->version ();
       }
     }
 
-    template <int _Options>
-    void GenericTransformation<_Options>::impl_compute (vectorOut_t result,
+    template <int _Options, int _NV>
+    inline const typename GenericTransformation<_Options, _NV>::Data_t&
+    GenericTransformation<_Options, _NV>::computeError
+    (const ConfigurationIn_t& argument, int quantities,
+     Workspace& workspace) const
+    {
+      typedef GenericTransformationWorkspaceData<Data_t> WsData_t;
+      Workspace::FunctionDataPtr_t& data = workspace.data (*this);
+      if (!data) data.reset (new WsData_t (d_));
+      WsData_t& wsd = static_cast <WsData_t&> (*data);
+      if (wsd.definitionVersion != definitionVersion_) {
+        copyDefinition (d_, wsd.d, workspace);
+        wsd.definitionVersion = definitionVersion_;
+        wsd.version = 0;
+      }
+      const KinematicsCachePtr_t& kinematics = workspace.kinematics ();
+      kinematics->update (argument, quantities, joints_);
+      if (wsd.version != kinematics->version ()) {
+        compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::error (wsd.d);
+        wsd.version = kinematics->version ();
+      }
+      return wsd.d;
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_compute (vectorOut_t result,
 					       ConfigurationIn_t argument)
       const throw ()
     {
-      computeError (argument);
-      size_type index=0;
-      for (size_type i=0; i<ValueSize; ++i) {
-	if (mask_ [i]) {
-	  result [index] = d_.value[i]; ++index;
-	}
+      computeError (argument, KinematicsCache::PLACEMENTS);
+      copyValue (d_, result);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_valueAndJacobian
+    (vectorOut_t result, matrixOut_t jacobian, ConfigurationIn_t arg)
+      const throw ()
+    {
+      computeError (arg, KinematicsCache::JACOBIANS);
+      copyValue (d_, result);
+      compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobian (d_, jacobian);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_valueBatch
+    (matrixOut_t results, matrixIn_t configurations) const
+    {
+      for (size_type c = 0; c < configurations.cols (); ++c) {
+        computeError (configurations.col (c), KinematicsCache::PLACEMENTS);
+        copyValue (d_, results.col (c));
+      }
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_jacobianBatch
+    (matrixOut_t jacobians, matrixIn_t configurations) const
+    {
+      const size_type nv = inputDerivativeSize ();
+      for (size_type c = 0; c < configurations.cols (); ++c) {
+        computeError (configurations.col (c), KinematicsCache::JACOBIANS);
+        compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobian
+          (d_, jacobians.middleCols (c * nv, nv));
       }
     }
 
-    template <int _Options>
-    void GenericTransformation<_Options>::impl_jacobian
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::referenceBatch (matrixOut_t values,
+        matrixOut_t* jacobians, ConfigurationIn_t argument,
+        const std::vector <Transform3f>& references)
+    {
+      assert (values.rows () == outputSize ());
+      assert ((std::size_t) values.cols () == references.size ());
+      const size_type nv = inputDerivativeSize ();
+      assert (!jacobians ||
+          ((std::size_t) jacobians->cols () == nv * references.size ()));
+      kinematics_->update (argument, jacobians ? KinematicsCache::JACOBIANS
+          : KinematicsCache::PLACEMENTS, joints_);
+      const Transform3f F1inJ1 (d_.F1inJ1), F2inJ2 (d_.F2inJ2);
+      d_.F2inJ2.setIdentity ();
+      d_.checkIsIdentity2 ();
+      // Take the general path instead of testing each reference.
+      d_.R1isID = false;
+      d_.t1isZero = false;
+      for (std::size_t k = 0; k < references.size (); ++k) {
+        d_.F1inJ1 = references [k];
+        compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::error (d_);
+        copyValue (d_, values.col (k));
+        if (jacobians)
+          compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobian
+            (d_, jacobians->middleCols (k * nv, nv));
+      }
+      d_.F1inJ1 = F1inJ1;
+      d_.checkIsIdentity1 ();
+      d_.F2inJ2 = F2inJ2;
+      d_.checkIsIdentity2 ();
+      // d_ does not hold the error of the reference anymore.
+      latestVersion_ = 0;
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::valueFromPlacements
+    (matrixOut_t values, const PackedPlacements* M1,
+     const PackedPlacements& M2) const
+    {
+      fromPlacements (&values, NULL, M1, matrix_t (), M2, matrix_t ());
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::jacobianFromPlacements
+    (matrixOut_t jacobians, const PackedPlacements* M1, matrixIn_t J1,
+     const PackedPlacements& M2, matrixIn_t J2) const
+    {
+      fromPlacements (NULL, &jacobians, M1, J1, M2, J2);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::valueAndJacobianFromPlacements
+    (matrixOut_t values, matrixOut_t jacobians, const PackedPlacements* M1,
+     matrixIn_t J1, const PackedPlacements& M2, matrixIn_t J2) const
+    {
+      fromPlacements (&values, &jacobians, M1, J1, M2, J2);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::addKinematics
+    (KinematicsBatch& batch) const
+    {
+      batch.addJoint (d_.getJoint1 ());
+      batch.addJoint (d_.joint2);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::valueFromKinematics
+    (matrixOut_t values, const KinematicsBatch& batch) const
+    {
+      const JointConstPtr_t joint1 = d_.getJoint1 ();
+      fromPlacements (&values, NULL, joint1 ? &batch.placements (joint1)
+          : NULL, matrix_t (), batch.placements (d_.joint2), matrix_t ());
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::jacobianFromKinematics
+    (matrixOut_t jacobians, const KinematicsBatch& batch) const
+    {
+      const JointConstPtr_t joint1 = d_.getJoint1 ();
+      if (joint1)
+        fromPlacements (NULL, &jacobians, &batch.placements (joint1),
+            batch.jacobians (joint1), batch.placements (d_.joint2),
+            batch.jacobians (d_.joint2));
+      else
+        fromPlacements (NULL, &jacobians, NULL, matrix_t (),
+            batch.placements (d_.joint2), batch.jacobians (d_.joint2));
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::valueAndJacobianFromKinematics
+    (matrixOut_t values, matrixOut_t jacobians, const KinematicsBatch& batch)
+      const
+    {
+      const JointConstPtr_t joint1 = d_.getJoint1 ();
+      if (joint1)
+        fromPlacements (&values, &jacobians, &batch.placements (joint1),
+            batch.jacobians (joint1), batch.placements (d_.joint2),
+            batch.jacobians (d_.joint2));
+      else
+        fromPlacements (&values, &jacobians, NULL, matrix_t (),
+            batch.placements (d_.joint2), batch.jacobians (d_.joint2));
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::frameJacobians
+    (matrixOut_t* frame1, matrixOut_t* frame2, ConfigurationIn_t argument)
+      const
+    {
+      assert (d_.relative);
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS, joints_);
+      const Transform3f M (d_.F1inJ1.actInv
+          (d_.relative->placement () * d_.F2inJ2));
+      const matrix3_t& R (M.rotation ());
+      matrix3_t Jlog;
+      if (ComputeOrientation) {
+        value_type theta;
+        vector3_t log;
+        if (d_.useQuaternion) computeLogFromQuaternion (R, theta, log);
+        else                  computeLog (R, theta, log);
+        computeJlog (theta, log, Jlog);
+      }
+      matrix3_t X;
+      computeCrossMatrix (M.translation (), X);
+      if (frame1) frame1->setZero ();
+      if (frame2) frame2->setZero ();
+      for (size_type i = 0; i < 3; ++i) {
+        if (ComputePosition && d_.outputRow[Data_t::RowPos + i] >= 0) {
+          const size_type r = d_.outputRow[Data_t::RowPos + i];
+          if (frame1) {
+            (*frame1) (r, i) = -1;
+            frame1->row (r).template tail<3> () = X.row (i);
+          }
+          if (frame2) frame2->row (r).template head<3> () = R.row (i);
+        }
+        if (ComputeOrientation && d_.outputRow[Data_t::RowOri + i] >= 0) {
+          const size_type r = d_.outputRow[Data_t::RowOri + i];
+          if (frame1) frame1->row (r).template tail<3> () = - Jlog.row (i);
+          if (frame2) frame2->row (r).template tail<3> ().noalias () =
+            Jlog.row (i) * R;
+        }
+      }
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::fromPlacements
+    (matrixOut_t* values, matrixOut_t* jacobians, const PackedPlacements* M1,
+     matrixIn_t J1, const PackedPlacements& M2, matrixIn_t J2) const
+    {
+      const size_type n = M2.size (), nv = inputDerivativeSize ();
+      assert (!M1 == !d_.getJoint1 ());
+      PackedPlacements M;
+      vector_t theta;
+      vectors3_t logs;
+      if (values || ComputeOrientation)
+        relativePlacements (M1, d_.F1inJ1, M2, d_.F2inJ2, M);
+      if (ComputeOrientation) computeLogs (M.rotation, theta, logs);
+      if (values) {
+        assert (values->rows () == outputSize () && values->cols () == n);
+        for (size_type i = 0; i < 3; ++i) {
+          if (ComputePosition && d_.outputRow[Data_t::RowPos + i] >= 0)
+            values->row (d_.outputRow[Data_t::RowPos + i]) =
+              M.translation.row (i);
+          if (ComputeOrientation && d_.outputRow[Data_t::RowOri + i] >= 0)
+            values->row (d_.outputRow[Data_t::RowOri + i]) = logs.row (i);
+        }
+      }
+      if (!jacobians) return;
+      assert (jacobians->rows () == outputDerivativeSize ()
+          && jacobians->cols () == n * nv);
+      matrices3_t Jlogs;
+      if (ComputeOrientation) computeJlogs (theta, logs, Jlogs);
+      // Without mask, the rows of relativeJacobians are those of the
+      // output. The buffer is local so that concurrent calls do not share
+      // it.
+      if (IsTransform && d_.outputSize == ValueSize) {
+        relativeJacobians (M1, J1, d_.F1inJ1, M2, J2, d_.F2inJ2, &Jlogs,
+            *jacobians);
+        return;
+      }
+      matrix_t J (6, n * nv);
+      relativeJacobians (M1, J1, d_.F1inJ1, M2, J2, d_.F2inJ2,
+          ComputeOrientation ? &Jlogs : NULL, J);
+      for (size_type i = 0; i < 3; ++i) {
+        if (ComputePosition && d_.outputRow[Data_t::RowPos + i] >= 0)
+          jacobians->row (d_.outputRow[Data_t::RowPos + i]) = J.row (i);
+        if (ComputeOrientation && d_.outputRow[Data_t::RowOri + i] >= 0)
+          jacobians->row (d_.outputRow[Data_t::RowOri + i]) = J.row (3 + i);
+      }
+    }
+
+    template <int _Options, int _NV>
+    bool GenericTransformation<_Options, _NV>::explicitSolvable () const
+    {
+      if (!IsTransform || d_.outputSize != ValueSize || !d_.joint2)
+        return false;
+      const se3::Model& model = robot_->model ();
+      const se3::JointIndex j2 = d_.joint2->index ();
+      if (model.parents[j2] != 0
+          || model.joints[j2].shortname () != "JointModelFreeFlyer")
+        return false;
+      // Joint 1 should not be in the subtree of joint 2.
+      const JointConstPtr_t joint1 = d_.getJoint1 ();
+      if (joint1)
+        for (se3::JointIndex j = joint1->index (); j > 0; j = model.parents[j])
+          if (j == j2) return false;
+      return true;
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::explicitSolve
+    (ConfigurationOut_t q) const
+    {
+      assert (explicitSolvable ());
+      const se3::Model& model = robot_->model ();
+      const se3::JointIndex j2 = d_.joint2->index ();
+      const JointConstPtr_t joint1 = d_.getJoint1 ();
+      Transform3f M2 (d_.F1inJ1 * d_.F2inJ2.inverse ());
+      if (joint1) {
+        kinematics_->update (q, KinematicsCache::PLACEMENTS, joints_);
+        M2 = joint1->currentTransformation () * M2;
+      }
+      // Placement of joint 2 with respect to its placement in the world.
+      const Transform3f M (model.jointPlacements[j2].inverse () * M2);
+      const size_type iq = model.joints[j2].idx_q ();
+      q.segment <3> (iq) = M.translation ();
+      q.segment <4> (iq + 3) =
+        Eigen::Quaternion <value_type> (M.rotation ()).coeffs ();
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::explicitJacobian
+    (matrixOut_t jacobian, ConfigurationIn_t q) const
+    {
+      assert (explicitSolvable ());
+      assert (jacobian.rows () == 6);
+      const JointConstPtr_t joint1 = d_.getJoint1 ();
+      if (!joint1) {
+        jacobian.setZero ();
+        return;
+      }
+      // The velocity of joint 2 in its frame is the velocity of joint 1 in
+      // the frame of joint 2, that is fixed with respect to joint 1.
+      kinematics_->update (q, KinematicsCache::JACOBIANS, joints_);
+      const Transform3f J2inJ1 (d_.F1inJ1 * d_.F2inJ2.inverse ());
+      jacobian.noalias () =
+        J2inJ1.inverse ().toActionMatrix () * joint1->jacobian ();
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_jacobianTimes
+    (vectorOut_t result, ConfigurationIn_t arg, vectorIn_t v) const
+    {
+      computeError (arg, KinematicsCache::JACOBIANS);
+      compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobianTimes
+        (d_, v, result);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_jacobianTransposeTimes
+    (vectorOut_t result, ConfigurationIn_t arg, vectorIn_t w) const
+    {
+      computeError (arg, KinematicsCache::JACOBIANS);
+      compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobianTransposeTimes
+        (d_, w, result);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_compute (vectorOut_t result,
+        ConfigurationIn_t argument, Workspace& workspace) const throw ()
+    {
+      const Data_t& d = computeError (argument, KinematicsCache::PLACEMENTS,
+          workspace);
+      copyValue (d, result);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_jacobian (matrixOut_t jacobian,
+        ConfigurationIn_t arg, Workspace& workspace) const throw ()
+    {
+      const Data_t& d = computeError (arg, KinematicsCache::JACOBIANS, workspace);
+      compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobian (d, jacobian);
+    }
+
+    template <int _Options, int _NV>
+    void GenericTransformation<_Options, _NV>::impl_jacobian
     (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
     {
-      computeError (arg);
-      compute<IsRelative, ComputePosition, ComputeOrientation>::jacobian (d_, jacobian, mask_);
+      computeError (arg, KinematicsCache::JACOBIANS);
+      compute<IsRelative, ComputePosition, ComputeOrientation, _NV>::jacobian (d_, jacobian);
 
 #ifdef CHECK_JACOBIANS
       const value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon());
@@ -434,5 +955,18 @@ namespace hpp {
     template class GenericTransformation< RelativeBit | PositionBit | OrientationBit >;
     template class GenericTransformation< RelativeBit | PositionBit                  >;
     template class GenericTransformation< RelativeBit |               OrientationBit >;
+    // Robots with 6 and 7 degrees of freedom, like most arms.
+    template class GenericTransformation<               PositionBit | OrientationBit, 6 >;
+    template class GenericTransformation<               PositionBit                 , 6 >;
+    template class GenericTransformation<                             OrientationBit, 6 >;
+    template class GenericTransformation< RelativeBit | PositionBit | OrientationBit, 6 >;
+    template class GenericTransformation< RelativeBit | PositionBit                 , 6 >;
+    template class GenericTransformation< RelativeBit |               OrientationBit, 6 >;
+    template class GenericTransformation<               PositionBit | OrientationBit, 7 >;
+    template class GenericTransformation<               PositionBit                 , 7 >;
+    template class GenericTransformation<                             OrientationBit, 7 >;
+    template class GenericTransformation< RelativeBit | PositionBit | OrientationBit, 7 >;
+    template class GenericTransformation< RelativeBit | PositionBit                 , 7 >;
+    template class GenericTransformation< RelativeBit |               OrientationBit, 7 >;
   } // namespace constraints
 } // namespace hpp
@@ -0,0 +1,60 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/geometry-placements.hh>
+
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+
+namespace hpp {
+  namespace constraints {
+    GeometryPlacementsPtr_t GeometryPlacements::get
+    (const KinematicsCachePtr_t& kinematics)
+    {
+      assert (kinematics);
+      GeometryPlacementsPtr_t gp = kinematics->geometryPlacements_.lock ();
+      if (gp) return gp;
+      gp.reset (new GeometryPlacements (kinematics));
+      kinematics->geometryPlacements_ = gp;
+      return gp;
+    }
+
+    GeometryPlacements::GeometryPlacements
+    (const KinematicsCachePtr_t& kinematics) :
+      kinematics_ (kinematics),
+      placements_ (kinematics->robot ()->geomModel ().geometryObjects.size ()),
+      versions_ (placements_.size (),
+          std::numeric_limits <std::size_t>::max ())
+    {}
+
+    void GeometryPlacements::update (const Geometries_t& geometries)
+    {
+      const std::size_t version = kinematics_->version ();
+      const DevicePtr_t robot (kinematics_->robot ());
+      const se3::GeometryModel& model = robot->geomModel ();
+      const se3::Data& data = robot->data ();
+      for (Geometries_t::const_iterator _g = geometries.begin ();
+          _g != geometries.end (); ++_g) {
+        if (versions_ [*_g] == version) continue;
+        const se3::GeometryObject& object = model.geometryObjects [*_g];
+        placements_ [*_g] = data.oMi [object.parentJoint] * object.placement;
+        versions_ [*_g] = version;
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
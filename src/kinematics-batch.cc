@@ -0,0 +1,123 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/kinematics-batch.hh>
+
+#include <stdexcept>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/center-of-mass-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    KinematicsBatchPtr_t KinematicsBatch::create (const DevicePtr_t& robot)
+    {
+      return KinematicsBatchPtr_t (new KinematicsBatch (robot));
+    }
+
+    KinematicsBatch::KinematicsBatch (const DevicePtr_t& robot) :
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)), size_ (0)
+    {}
+
+    void KinematicsBatch::addJoint (const JointConstPtr_t& joint)
+    {
+      if (!joint) return;
+      if (jointData_.count (joint->index ())) return;
+      KinematicsCache::addJoint (joints_, joint);
+      jointData_[joint->index ()].joint = joint;
+    }
+
+    void KinematicsBatch::addCenterOfMass (const CenterOfMassCachePtr_t& com)
+    {
+      assert (com);
+      comData_[com.get ()].cache = com;
+    }
+
+    void KinematicsBatch::compute (matrixIn_t configurations, int quantities)
+    {
+      const DevicePtr_t robot (robot_.lock ());
+      assert (robot);
+      if (configurations.rows () != robot->configSize ())
+        throw std::invalid_argument ("KinematicsBatch::compute: wrong "
+            "configuration size");
+      const size_type n = configurations.cols (), nv = robot->numberDof ();
+      const bool jacobians = (quantities & Device::JACOBIAN);
+      const Device::Computation_t flag = (jacobians ? Device::ALL
+          : Device::COM);
+
+      for (JointMap_t::iterator _j = jointData_.begin ();
+          _j != jointData_.end (); ++_j) {
+        _j->second.placements.resize (n);
+        if (jacobians) _j->second.jacobians.resize (6, n * nv);
+      }
+      for (CenterOfMassMap_t::iterator _c = comData_.begin ();
+          _c != comData_.end (); ++_c) {
+        _c->second.com.resize (3, n);
+        if (jacobians) _c->second.jacobians.resize (3, n * nv);
+      }
+
+      // One forward kinematics per configuration. The results are copied
+      // right away so that the next configuration can overwrite the Device.
+      for (size_type k = 0; k < n; ++k) {
+        if (comData_.empty ())
+          kinematics_->update (configurations.col (k), quantities, joints_);
+        else
+          kinematics_->update (configurations.col (k), quantities);
+        for (JointMap_t::iterator _j = jointData_.begin ();
+            _j != jointData_.end (); ++_j) {
+          JointData_t& d = _j->second;
+          d.placements.set (k, d.joint->currentTransformation ());
+          if (jacobians)
+            d.jacobians.middleCols (k * nv, nv) = d.joint->jacobian ();
+        }
+        for (CenterOfMassMap_t::iterator _c = comData_.begin ();
+            _c != comData_.end (); ++_c) {
+          CenterOfMassData_t& d = _c->second;
+          d.cache->compute (flag);
+          d.com.col (k) = d.cache->com ();
+          if (jacobians)
+            d.jacobians.middleCols (k * nv, nv) = d.cache->jacobian ();
+        }
+      }
+      size_ = n;
+    }
+
+    const KinematicsBatch::JointData_t& KinematicsBatch::findJoint
+    (const JointConstPtr_t& joint) const
+    {
+      assert (joint);
+      JointMap_t::const_iterator _j = jointData_.find (joint->index ());
+      if (_j == jointData_.end ())
+        throw std::invalid_argument ("KinematicsBatch: joint "
+            + joint->name () + " is not registered");
+      return _j->second;
+    }
+
+    const KinematicsBatch::CenterOfMassData_t&
+    KinematicsBatch::findCenterOfMass (const CenterOfMassCachePtr_t& com)
+      const
+    {
+      CenterOfMassMap_t::const_iterator _c = comData_.find (com.get ());
+      if (_c == comData_.end ())
+        throw std::invalid_argument ("KinematicsBatch: center of mass is "
+            "not registered");
+      return _c->second;
+    }
+  } // namespace constraints
+} // namespace hpp
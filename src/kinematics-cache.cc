@@ -0,0 +1,180 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/kinematics-cache.hh>
+
+#include <map>
+#include <pthread.h>
+
+#include <pinocchio/algorithm/kinematics.hpp>
+#include <pinocchio/algorithm/jacobian.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/statistics.hh>
+#include <hpp/constraints/trace.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef std::map <const Device*, KinematicsCacheWkPtr_t> Caches_t;
+
+      Caches_t& caches ()
+      {
+        static Caches_t caches;
+        return caches;
+      }
+
+      /// The registry is shared by all the threads.
+      pthread_mutex_t cachesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+      /// Lock cachesMutex during the life of the object.
+      struct CachesLock
+      {
+        CachesLock () { pthread_mutex_lock (&cachesMutex); }
+        ~CachesLock () { pthread_mutex_unlock (&cachesMutex); }
+      };
+
+      /// Whether joints contains the joints of subset.
+      bool contains (const KinematicsCache::Joints_t& joints,
+          const KinematicsCache::Joints_t& subset)
+      {
+        assert (joints.size () == subset.size ());
+        for (std::size_t i = 0; i < subset.size (); ++i)
+          if (subset[i] && !joints[i]) return false;
+        return true;
+      }
+    } // namespace
+
+    void KinematicsCache::addJoint (Joints_t& joints,
+        const JointConstPtr_t& joint)
+    {
+      if (!joint) return;
+      const se3::Model& model = joint->robot ()->model ();
+      joints.resize (model.joints.size (), false);
+      for (se3::JointIndex j = joint->index (); j > 0; j = model.parents[j])
+        joints[j] = true;
+    }
+
+    KinematicsCachePtr_t KinematicsCache::get (const DevicePtr_t& robot)
+    {
+      assert (robot);
+      KinematicsCachePtr_t cache;
+      {
+        CachesLock lock;
+        Caches_t& c = caches ();
+        Caches_t::iterator _c = c.find (robot.get ());
+        if (_c != c.end ()) {
+          cache = _c->second.lock ();
+          // The address may have been reused by another Device.
+          if (cache && cache->robot () != robot) cache.reset ();
+        }
+        if (!cache) {
+          cache.reset (new KinematicsCache (robot));
+          c[robot.get ()] = cache;
+
+          // Remove caches that are not used anymore.
+          for (_c = c.begin (); _c != c.end ();) {
+            if (_c->second.expired ()) c.erase (_c++);
+            else ++_c;
+          }
+        }
+      }
+      return cache;
+    }
+
+    KinematicsCache::KinematicsCache (const DevicePtr_t& robot) :
+      robot_ (robot), latest_ (), flag_ (0), valid_ (false), version_ (0)
+    {}
+
+    bool KinematicsCache::update (ConfigurationIn_t q)
+    {
+      DevicePtr_t robot = robot_.lock ();
+      assert (robot);
+      return update (q, robot->computationFlag ());
+    }
+
+    bool KinematicsCache::update (ConfigurationIn_t q, int quantities)
+    {
+      return update (q, quantities, Joints_t ());
+    }
+
+    bool KinematicsCache::update (ConfigurationIn_t q, int quantities,
+        const Joints_t& joints)
+    {
+      DevicePtr_t robot = robot_.lock ();
+      assert (robot);
+      // The Device configuration is also checked in case it was modified
+      // without going through this cache.
+      const bool same = valid_ && q == latest_
+        && robot->currentConfiguration () == q;
+      const bool all = joints.empty ();
+      if (same && (flag_ & quantities) == quantities
+          && (joints_.empty () || (!all && contains (joints_, joints)))) {
+        HPP_CONSTRAINTS_STATISTICS (
+            if (EvaluationStatistics* s = EvaluationStatistics::current ())
+              ++s->nbKinematicsHits;
+            );
+        return false;
+      }
+      HPP_CONSTRAINTS_STATISTICS (
+          if (EvaluationStatistics* s = EvaluationStatistics::current ())
+            ++s->nbKinematicsUpdates;
+          );
+      const int flag = (same ? flag_ | quantities : quantities);
+      // The joints computed previously at q are computed again with the
+      // missing quantities.
+      if (all || (same && joints_.empty ())) joints_.clear ();
+      else if (same)
+        for (std::size_t i = 0; i < joints.size (); ++i)
+          joints_[i] = joints_[i] || joints[i];
+      else joints_ = joints;
+      latest_ = q;
+      {
+        HPP_CONSTRAINTS_TRACE_SCOPE ("forwardKinematics", "kinematics");
+        robot->currentConfiguration (q);
+        if (joints_.empty ()) {
+          const Device::Computation_t previous = robot->computationFlag ();
+          robot->controlComputation ((Device::Computation_t) flag);
+          robot->computeForwardKinematics ();
+          robot->controlComputation (previous);
+        } else computeJoints (*robot, flag);
+      }
+      flag_ = flag;
+      valid_ = true;
+      if (!same) ++version_;
+      return true;
+    }
+
+    void KinematicsCache::computeJoints (Device& robot, int quantities) const
+    {
+      const se3::Model& model = robot.model ();
+      se3::Data& data = robot.data ();
+      // Joints are sorted so that parents come before their children.
+      for (se3::JointIndex i = 1; i < joints_.size (); ++i) {
+        if (!joints_[i]) continue;
+        if (quantities & Device::JACOBIAN)
+          se3::JacobiansForwardStep::run (model.joints[i], data.joints[i],
+              se3::JacobiansForwardStep::ArgsType (model, data, latest_));
+        else
+          se3::ForwardKinematicZeroStep::run (model.joints[i], data.joints[i],
+              se3::ForwardKinematicZeroStep::ArgsType (model, data, latest_));
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
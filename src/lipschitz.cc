@@ -0,0 +1,133 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/lipschitz.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/liegroup.hh>
+
+#include <hpp/constraints/differentiable-function.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef std::vector <se3::JointIndex> Chain_t;
+
+      /// Ancestors of a joint, starting with the joint, and the length of
+      /// the kinematic chain from the joint to each of them.
+      void chain (const DevicePtr_t& robot, se3::JointIndex joint,
+          Chain_t& joints, std::vector <value_type>& lengths)
+      {
+        const se3::Model& model = robot->model ();
+        value_type length = 0;
+        for (se3::JointIndex j = joint; j > 0; j = model.parents[j]) {
+          joints.push_back (j);
+          lengths.push_back (length);
+          length += pinocchio::Joint (robot, j).maximalDistanceToParent ();
+        }
+        // The world frame.
+        joints.push_back (0);
+        lengths.push_back (length);
+      }
+
+      void addJoint (const DevicePtr_t& robot, se3::JointIndex j,
+          value_type lever, value_type& linear, value_type& angular)
+      {
+        const pinocchio::Joint joint (robot, j);
+        const value_type w = joint.upperBoundAngularVelocity ();
+        const value_type v = joint.upperBoundLinearVelocity () + w * lever;
+        linear += v * v;
+        angular += w * w;
+      }
+    } // namespace
+
+    VelocityBounds relativeVelocityBounds (const DevicePtr_t& robot,
+        se3::JointIndex joint1, se3::JointIndex joint2, value_type radius)
+    {
+      Chain_t chain1, chain2;
+      std::vector <value_type> lengths1, lengths2;
+      chain (robot, joint1, chain1, lengths1);
+      chain (robot, joint2, chain2, lengths2);
+      // Common ancestor of the joints.
+      std::size_t i1 = chain1.size () - 1, i2 = chain2.size () - 1;
+      while (i1 > 0 && i2 > 0 && chain1[i1-1] == chain2[i2-1]) {
+        --i1;
+        --i2;
+      }
+      // The velocities of the joints are bounded independently, so that
+      // the bounds of the joints add up in quadrature (Cauchy-Schwarz).
+      value_type linear = 0, angular = 0;
+      for (std::size_t k = 0; k < i2; ++k)
+        addJoint (robot, chain2[k], lengths2[k] + radius, linear, angular);
+      // A joint between joint1 and the common ancestor moves the frame of
+      // joint1 around the points of joint2.
+      for (std::size_t k = 0; k < i1; ++k)
+        addJoint (robot, chain1[k],
+            lengths1[i1] - lengths1[k] + lengths2[i2] + radius,
+            linear, angular);
+      VelocityBounds bounds;
+      bounds.linear = std::sqrt (linear);
+      bounds.angular = std::sqrt (angular);
+      return bounds;
+    }
+
+    bool validateSegment (const DifferentiableFunction& f,
+        const DevicePtr_t& robot, ConfigurationIn_t q0, ConfigurationIn_t q1,
+        value_type threshold, value_type step, value_type& validPart,
+        std::size_t& nbEvaluations)
+    {
+      using hpp::pinocchio::LieGroupTpl;
+      assert (step > 0);
+      vector_t v (robot->numberDof ());
+      hpp::pinocchio::difference<LieGroupTpl> (robot, q1, q0, v);
+      const value_type length = v.norm ();
+      const value_type L = f.lipschitzConstant ();
+
+      Configuration_t q (q0.size ());
+      vector_t value (f.outputSize ());
+      value_type t = 0;
+      validPart = 0;
+      nbEvaluations = 0;
+      while (true) {
+        hpp::pinocchio::interpolate<LieGroupTpl> (robot, q0, q1, t, q);
+        f (value, q);
+        ++nbEvaluations;
+        const value_type norm = value.norm ();
+        if (norm > threshold) return false;
+        if (t >= 1 || length == 0) {
+          validPart = 1;
+          return true;
+        }
+        validPart = t;
+        value_type dt = step / length;
+        if (L == 0)
+          dt = 1;
+        else if (L < std::numeric_limits <value_type>::infinity ()) {
+          const value_type certified = (threshold - norm) / (L * length);
+          validPart = std::min (value_type (1), t + certified);
+          dt = std::max (dt, certified);
+        }
+        t = std::min (value_type (1), t + dt);
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,114 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/model-metadata.hh>
+
+#include <algorithm>
+#include <pthread.h>
+
+#include <pinocchio/algorithm/finite-differences.hpp>
+
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Guards KinematicsCache::metadata_, that several threads may read
+      /// and replace.
+      pthread_mutex_t metadataMutex = PTHREAD_MUTEX_INITIALIZER;
+
+      /// Lock metadataMutex during the life of the object.
+      struct MetadataLock
+      {
+        MetadataLock () { pthread_mutex_lock (&metadataMutex); }
+        ~MetadataLock () { pthread_mutex_unlock (&metadataMutex); }
+      };
+    } // namespace
+
+    ModelMetadataConstPtr_t ModelMetadata::get (const DevicePtr_t& robot)
+    {
+      assert (robot);
+      KinematicsCachePtr_t kinematics (KinematicsCache::get (robot));
+      MetadataLock lock;
+      if (!kinematics->metadata_ || !kinematics->metadata_->matches (robot))
+        kinematics->metadata_ = ModelMetadataConstPtr_t
+          (new ModelMetadata (robot));
+      return kinematics->metadata_;
+    }
+
+    ModelMetadata::ModelMetadata (const DevicePtr_t& robot) :
+      configSize_ (robot->configSize ()), numberDof_ (robot->numberDof ()),
+      extraConfigSize_ (robot->extraConfigSpace ().dimension ())
+    {
+      const se3::Model& model = robot->model ();
+      const std::size_t nbJoints = model.joints.size ();
+
+      velocityToJoint_.assign (model.nv, 0);
+      configurations_.assign (nbJoints, Range_t (0, 0));
+      velocities_.assign (nbJoints, Range_t (0, 0));
+      supports_.resize (nbJoints);
+      supports_[0].setConstant (model.nv, false);
+      // Joints are sorted so that parents come first.
+      for (se3::JointIndex j = 1; j < nbJoints; ++j) {
+        const se3::JointModel& joint = model.joints[j];
+        std::fill (velocityToJoint_.begin () + joint.idx_v (),
+                   velocityToJoint_.begin () + joint.idx_v () + joint.nv (), j);
+        configurations_[j] = Range_t (joint.idx_q (),
+                                      joint.idx_q () + joint.nq ());
+        velocities_[j] = Range_t (joint.idx_v (), joint.idx_v () + joint.nv ());
+        supports_[j] = supports_[model.parents[j]];
+        supports_[j].segment (joint.idx_v (), joint.nv ()).setConstant (true);
+      }
+
+      subtrees_.resize (nbJoints);
+      subtrees_[0] = Range_t (0, model.nv);
+      for (se3::JointIndex j = 1; j < nbJoints; ++j)
+        subtrees_[j] = velocities_[j];
+      for (se3::JointIndex j = nbJoints - 1; j > 0; --j) {
+        const se3::JointIndex parent = model.parents[j];
+        if (parent > 0)
+          subtrees_[parent].second =
+            std::max (subtrees_[parent].second, subtrees_[j].second);
+      }
+
+      increments_ = se3::finiteDifferenceIncrement (model);
+    }
+
+    bool ModelMetadata::matches (const DevicePtr_t& robot) const
+    {
+      return configSize_ == robot->configSize ()
+        && numberDof_ == robot->numberDof ()
+        && extraConfigSize_ == robot->extraConfigSpace ().dimension ()
+        && (std::size_t) robot->model ().joints.size () == supports_.size ();
+    }
+
+    void ModelMetadata::configurationVariables (const ArrayXb& columns,
+        ArrayXb& variables) const
+    {
+      assert (columns.size () == numberDof_);
+      variables.setConstant (configSize_, false);
+      for (std::size_t j = 1; j < velocities_.size (); ++j) {
+        const Range_t& v = velocities_[j];
+        const Range_t& q = configurations_[j];
+        if (columns.segment (v.first, v.second - v.first).any ())
+          variables.segment (q.first, q.second - q.first).setConstant (true);
+      }
+      variables.tail (extraConfigSize_) = columns.tail (extraConfigSize_);
+    }
+  } // namespace constraints
+} // namespace hpp
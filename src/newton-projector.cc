@@ -0,0 +1,166 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/newton-projector.hh>
+
+#include <stdexcept>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/liegroup.hh>
+
+#include <hpp/constraints/differentiable-function-stack.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Sufficient decrease of the squared norm in the line search.
+      const value_type armijo = 1e-4;
+      /// Maximal number of halvings of the step in the line search.
+      const std::size_t maxHalvings = 10;
+    } // namespace
+
+    NewtonProjectorPtr_t NewtonProjector::create
+    (const DifferentiableFunctionStackPtr_t& stack, const DevicePtr_t& robot)
+    {
+      return NewtonProjectorPtr_t (new NewtonProjector (stack, robot));
+    }
+
+    NewtonProjector::NewtonProjector
+    (const DifferentiableFunctionStackPtr_t& stack, const DevicePtr_t& robot) :
+      stack_ (stack), robot_ (robot), squaredErrorThreshold_ (1e-12),
+      maxIterations_ (20), decomposition_ (COLUMN_PIVOTING_QR),
+      rankThreshold_ (1e-8), svd_ (0, 0), iterations_ (0), squaredNorm_ (0),
+      rank_ (0)
+    {
+      update ();
+    }
+
+    void NewtonProjector::update ()
+    {
+      const DifferentiableFunctionStack& f = *stack_;
+      if (f.outputSize () != f.outputDerivativeSize ())
+        throw std::invalid_argument
+          ("NewtonProjector: the value of the stack must be a vector.");
+      const ArrayXb& active = f.activeDerivativeColumns ();
+      columns_.clear ();
+      for (size_type i = 0; i < active.size (); ++i)
+        if (active [i]) columns_.push_back (i);
+      const size_type m = f.outputSize (), n = f.inputDerivativeSize (),
+            na = (size_type) columns_.size ();
+
+      value_.resize (m);
+      trialValue_.resize (m);
+      jacobian_.resize (m, n);
+      reduced_.resize (m, na);
+      rhs_.resize (m);
+      reducedStep_.resize (na);
+      projected_.resize (std::min (m, na));
+      step_.resize (n);
+      scaledStep_.resize (n);
+      trial_.resize (f.inputSize ());
+      qr_ = Eigen::ColPivHouseholderQR <matrix_t> (m, na);
+      svd_.compute (reduced_.setZero ());
+      rankThreshold (rankThreshold_);
+    }
+
+    void NewtonProjector::rankThreshold (value_type threshold)
+    {
+      rankThreshold_ = threshold;
+      qr_.setThreshold (threshold);
+      svd_.setThreshold (threshold);
+    }
+
+    void NewtonProjector::computeStep ()
+    {
+      for (std::size_t j = 0; j < columns_.size (); ++j)
+        reduced_.col (j) = jacobian_.col (columns_[j]);
+      const size_type na = reduced_.cols ();
+      Eigen::VectorBlock <vector_t> x (reducedStep_.head (na));
+      rhs_ = - value_;
+      if (decomposition_ == COLUMN_PIVOTING_QR) {
+        qr_.compute (reduced_);
+        rank_ = qr_.rank ();
+        // x = P R^{-1} Q^T rhs, with zeros on the columns beyond the rank.
+        rhs_.applyOnTheLeft (qr_.householderQ ().setLength
+            (qr_.nonzeroPivots ()).adjoint ());
+        Eigen::VectorBlock <vector_t> y (rhs_.head (rank_));
+        qr_.matrixQR ().topLeftCorner (rank_, rank_)
+          .triangularView <Eigen::Upper> ().solveInPlace (y);
+        x.setZero ();
+        for (size_type i = 0; i < rank_; ++i)
+          x [qr_.colsPermutation ().indices () [i]] = y [i];
+      } else {
+        svd_.compute (reduced_);
+        rank_ = svd_.rank ();
+        // x = V1 S1^{-1} U1^T rhs
+        Eigen::VectorBlock <vector_t> y (projected_.head (rank_));
+        y.noalias () = getU1 (svd_).adjoint () * rhs_;
+        y.array () /= svd_.singularValues ().head (rank_).array ();
+        x.noalias () = getV1 (svd_) * y;
+      }
+      step_.setZero ();
+      for (std::size_t j = 0; j < columns_.size (); ++j)
+        step_ [columns_[j]] = x [j];
+    }
+
+    void NewtonProjector::integrate (vectorIn_t q, value_type alpha,
+        vectorOut_t result)
+    {
+      scaledStep_ = alpha * step_;
+      if (robot_) {
+        using hpp::pinocchio::LieGroupTpl;
+        // Saturate at the joint bounds.
+        hpp::pinocchio::integrate<true, LieGroupTpl>
+          (robot_, q, scaledStep_, result);
+      } else {
+        assert (q.size () == scaledStep_.size ());
+        result = q + scaledStep_;
+      }
+    }
+
+    NewtonProjector::Status_t NewtonProjector::solve (ConfigurationOut_t q)
+    {
+      const DifferentiableFunctionStack& f = *stack_;
+      assert (q.size () == f.inputSize ());
+      iterations_ = 0;
+      f (value_, q);
+      squaredNorm_ = value_.squaredNorm ();
+      while (squaredNorm_ > squaredErrorThreshold_) {
+        if (iterations_ >= maxIterations_) return MAX_ITERATIONS_REACHED;
+        ++iterations_;
+        // The kinematics computed for the value are reused.
+        f.jacobian (jacobian_, q);
+        computeStep ();
+        // Along the Gauss-Newton step, the derivative of the squared norm
+        // is -2 |f|^2 when the jacobian has full row rank.
+        value_type alpha = 1, trialNorm = 0;
+        std::size_t k;
+        for (k = 0; k <= maxHalvings; ++k, alpha /= 2) {
+          integrate (q, alpha, trial_);
+          f (trialValue_, trial_);
+          trialNorm = trialValue_.squaredNorm ();
+          if (trialNorm <= (1 - 2 * armijo * alpha) * squaredNorm_) break;
+        }
+        if (k > maxHalvings) return NO_DESCENT;
+        q = trial_;
+        value_.swap (trialValue_);
+        squaredNorm_ = trialNorm;
+      }
+      return SUCCESS;
+    }
+  } // namespace constraints
+} // namespace hpp
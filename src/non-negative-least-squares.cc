@@ -0,0 +1,134 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/non-negative-least-squares.hh>
+
+#include <algorithm>
+
+#include <Eigen/QR>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef NonNegativeLeastSquares NNLS_t;
+      typedef Eigen::Matrix <value_type, Eigen::Dynamic, Eigen::Dynamic,
+              Eigen::ColMajor, NNLS_t::MaxRows, NNLS_t::MaxRows> Passive_t;
+      typedef Eigen::Matrix <value_type, Eigen::Dynamic, 1, Eigen::ColMajor,
+              NNLS_t::MaxRows, 1> SmallVector_t;
+    } // namespace
+
+    bool NonNegativeLeastSquares::solve (matrixIn_t A, vectorIn_t b,
+        bool warmStart)
+    {
+      assert (A.rows () <= MaxRows);
+      assert (b.size () == A.rows ());
+      const size_type n = A.cols ();
+      if (!warmStart || x_.size () != n) x_.setZero (n);
+      z_.resize (n);
+      passive_.resize (n);
+      nbPassive_ = 0;
+      for (size_type i = 0; i < n; ++i) {
+        passive_[i] = (x_[i] > tolerance_);
+        if (passive_[i]) ++nbPassive_;
+        else x_[i] = 0;
+      }
+      if (nbPassive_ > (std::size_t) A.rows ()) {
+        x_.setZero ();
+        passive_.assign (n, false);
+        nbPassive_ = 0;
+      }
+
+      iterations_ = 0;
+      bool optimal = false;
+      // The positive variables of a warm start may not be optimal for the
+      // new problem: solve on them before adding variables.
+      bool added = (nbPassive_ > 0);
+      SmallVector_t r (A.rows ());
+      while (iterations_ < maxIterations_) {
+        if (!added) {
+          r.noalias () = b - A * x_;
+          dual_.noalias () = A.transpose () * r;
+          // Add the variable that decreases the residual the most.
+          size_type j = -1;
+          value_type best = tolerance_;
+          for (size_type i = 0; i < n; ++i)
+            if (!passive_[i] && dual_[i] > best) { best = dual_[i]; j = i; }
+          if (j < 0 || nbPassive_ == (std::size_t) A.rows ()) {
+            optimal = true;
+            break;
+          }
+          passive_[j] = true;
+          ++nbPassive_;
+          ++iterations_;
+          solvePassive (A, b);
+          // Numerical dependency of column j with the positive columns.
+          if (z_[j] <= tolerance_) {
+            passive_[j] = false;
+            --nbPassive_;
+            optimal = true;
+            break;
+          }
+        } else {
+          ++iterations_;
+          solvePassive (A, b);
+        }
+        added = false;
+        // Move towards z_ while the positive variables remain positive.
+        while (true) {
+          value_type alpha = 1;
+          bool feasible = true;
+          for (size_type i = 0; i < n; ++i) {
+            if (passive_[i] && z_[i] <= tolerance_) {
+              feasible = false;
+              alpha = std::min (alpha, x_[i] / (x_[i] - z_[i]));
+            }
+          }
+          if (feasible) {
+            x_ = z_;
+            break;
+          }
+          x_ += alpha * (z_ - x_);
+          for (size_type i = 0; i < n; ++i) {
+            if (passive_[i] && x_[i] <= tolerance_) {
+              passive_[i] = false;
+              --nbPassive_;
+              x_[i] = 0;
+            }
+          }
+          if (iterations_ >= maxIterations_) break;
+          ++iterations_;
+          solvePassive (A, b);
+        }
+      }
+      r.noalias () = A * x_ - b;
+      dual_.noalias () = A.transpose () * r;
+      residual_ = r.squaredNorm ();
+      return optimal;
+    }
+
+    void NonNegativeLeastSquares::solvePassive (matrixIn_t A, vectorIn_t b)
+    {
+      const size_type n = A.cols ();
+      Passive_t Ap (A.rows (), nbPassive_);
+      for (size_type i = 0, k = 0; i < n; ++i)
+        if (passive_[i]) Ap.col (k++) = A.col (i);
+      const SmallVector_t y (Ap.colPivHouseholderQr ().solve (b));
+      z_.setZero ();
+      for (size_type i = 0, k = 0; i < n; ++i)
+        if (passive_[i]) z_[i] = y[k++];
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,73 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/nullspace-basis.hh>
+
+namespace hpp {
+  namespace constraints {
+    NullspaceBasis::NullspaceBasis (value_type threshold) :
+      threshold_ (threshold), rank_ (0)
+    {}
+
+    void NullspaceBasis::decompose (matrixIn_t jacobian)
+    {
+      qr_.setThreshold (threshold_);
+      qr_.compute (jacobian.transpose ());
+      rank_ = qr_.rank ();
+    }
+
+    void NullspaceBasis::compute (matrixIn_t jacobian)
+    {
+      const size_type n = jacobian.cols ();
+      decompose (jacobian);
+      basis_.setIdentity (n, n);
+      basis_.applyOnTheLeft (qr_.householderQ ());
+      basis_ = basis_.rightCols (n - rank_).eval ();
+    }
+
+    bool NullspaceBasis::update (matrixIn_t jacobian)
+    {
+      const size_type n = jacobian.cols ();
+      if (basis_.rows () != n) {
+        compute (jacobian);
+        return false;
+      }
+      decompose (jacobian);
+      if (rank_ + basis_.cols () != n) {
+        compute (jacobian);
+        return false;
+      }
+
+      // Q1, the rank_ first columns of the orthogonal factor.
+      rows_.setIdentity (n, rank_);
+      rows_.applyOnTheLeft (qr_.householderQ ());
+      basis_.noalias () -= rows_ * (rows_.transpose () * basis_);
+
+      // basis_ = basis_ L^-T where L L^T = basis_^T basis_
+      gram_.noalias () = basis_.transpose () * basis_;
+      llt_.compute (gram_);
+      // The projections of the previous basis must remain independent.
+      if (llt_.info () != Eigen::Success
+          || llt_.matrixLLT ().diagonal ().minCoeff () < .5) {
+        compute (jacobian);
+        return false;
+      }
+      llt_.matrixU ().solveInPlace<Eigen::OnTheRight> (basis_);
+      return true;
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -16,11 +16,19 @@
 
 #include "hpp/constraints/qp-static-stability.hh"
 
+#include <algorithm>
 #include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <qpOASES.hpp>
+
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 
 #include "hpp/constraints/tools.hh"
+#include "hpp/constraints/kinematics-cache.hh"
+#include "hpp/constraints/statistics.hh"
 
 namespace hpp {
   namespace constraints {
@@ -33,6 +41,210 @@ namespace hpp {
           nb += it->points.size ();
         return nb;
       }
+
+      /// Record the iterations of a call to a solver.
+      inline void countIterations (std::size_t iterations)
+      {
+        HPP_CONSTRAINTS_STATISTICS (
+            if (EvaluationStatistics* s = EvaluationStatistics::current ())
+              s->nbQPIterations += iterations;
+            );
+        (void) iterations;
+      }
+
+      /// Default maximal number of working set recalculations of qpOASES.
+      const std::size_t nWSR = 40;
+
+      /// Give the tolerance of solver to qp if it changed.
+      template <typename QProblem>
+      inline void setTolerance (QProblem& qp, qpOASES::Options& options,
+          value_type tolerance)
+      {
+        if (options.terminationTolerance == tolerance) return;
+        options.terminationTolerance = tolerance;
+        qp.setOptions (options);
+      }
+
+      /// qpOASES on the problem with a variable per contact point.
+      class FullQPSolver : public ContactForceSolver
+      {
+        public:
+          FullQPSolver (size_type n) :
+            ContactForceSolver (nWSR, qpOASES::Options ().terminationTolerance),
+            H_ (n, n), G_ (n), zeros_ (n, 0),
+            qp_ ((qpOASES::int_t) n, qpOASES::HST_SEMIDEF), restored_ (false)
+          {
+            solution_.setZero (n);
+            dual_.setZero (n);
+            qp_.setOptions (options_);
+            qp_.setPrintLevel (qpOASES::PL_NONE);
+          }
+
+          virtual bool solve (matrixIn_t A, vectorIn_t b)
+          {
+            using qpOASES::SUCCESSFUL_RETURN;
+            assert (A.cols () == G_.size ());
+            H_.noalias() = A.transpose () * A;
+            G_.noalias() = - A.transpose () * b;
+            setTolerance (qp_, options_, tolerance_);
+
+            qpOASES::int_t nwsr = (qpOASES::int_t) maxIterations_;
+            qpOASES::returnValue ret = qpOASES::RET_INIT_FAILED;
+            iterations_ = 0;
+            warmStarted_ = false;
+            // Successive configurations are close so the active set rarely
+            // changes: start from the previous solution and active set.
+            // H_ changes so QProblemB::hotstart cannot be used.
+            if (restored_) {
+              // qpOASES guesses the active set from the primal solution.
+              qp_.reset ();
+              qp_.setHessianType (qpOASES::HST_SEMIDEF);
+              ret = qp_.init (H_.data(), G_.data(), &zeros_ [0], 0, nwsr, 0,
+                  solution_.data (), 0);
+              iterations_ += (std::size_t) nwsr;
+              warmStarted_ = (ret == SUCCESSFUL_RETURN);
+              restored_ = false;
+            } else if (qp_.isSolved ()) {
+              qpOASES::Bounds bounds;
+              qp_.getBounds (bounds);
+              qp_.setHessianType (qpOASES::HST_SEMIDEF);
+              ret = qp_.init (H_.data(), G_.data(), &zeros_ [0], 0, nwsr, 0,
+                  solution_.data (), dual_.data (), &bounds);
+              iterations_ += (std::size_t) nwsr;
+              warmStarted_ = (ret == SUCCESSFUL_RETURN);
+            }
+            if (ret != SUCCESSFUL_RETURN) {
+              nwsr = (qpOASES::int_t) maxIterations_;
+              qp_.reset ();
+              qp_.setHessianType (qpOASES::HST_SEMIDEF);
+              ret = qp_.init (H_.data(), G_.data(), &zeros_ [0], 0, nwsr, 0);
+              iterations_ += (std::size_t) nwsr;
+            }
+            qp_.getPrimalSolution (solution_.data ());
+            qp_.getDualSolution (dual_.data ());
+            residual_ = 2*qp_.getObjVal () + b.squaredNorm ();
+            return ret == SUCCESSFUL_RETURN;
+          }
+
+          virtual void reset ()
+          {
+            qp_.reset ();
+            restored_ = false;
+          }
+
+          virtual void warmStart (vectorIn_t solution)
+          {
+            if (solution.size () != solution_.size ()) return;
+            solution_ = solution;
+            restored_ = true;
+          }
+
+        private:
+          typedef Eigen::Matrix<qpOASES::real_t, Eigen::Dynamic,
+                  Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrix_t;
+
+          RowMajorMatrix_t H_;
+          vector_t G_;
+          std::vector <qpOASES::real_t> zeros_;
+          qpOASES::Options options_;
+          qpOASES::QProblemB qp_;
+          /// Whether solution_ was given to warmStart.
+          bool restored_;
+      }; // class FullQPSolver
+
+      /// qpOASES on the dual problem, with 6 variables and a constraint per
+      /// contact point.
+      class ReducedQPSolver : public ContactForceSolver
+      {
+        public:
+          ReducedQPSolver (size_type n) :
+            ContactForceSolver (nWSR, qpOASES::Options ().terminationTolerance),
+            y_ (6 + n), zeros_ (n, 0),
+            qp_ (6, (qpOASES::int_t) n, qpOASES::HST_IDENTITY)
+          {
+            qp_.setOptions (options_);
+            qp_.setPrintLevel (qpOASES::PL_NONE);
+          }
+
+          virtual bool solve (matrixIn_t A, vectorIn_t b)
+          {
+            // The dual of min 0.5 * || A F - b ||^2 s.t. F >= 0 is
+            //   min 0.5 * || u ||^2 + b^T u s.t. A^T u >= 0
+            // where u = A F - b and F are the multipliers of the
+            // constraints. It has 6 variables whatever the number of
+            // contacts.
+            using qpOASES::SUCCESSFUL_RETURN;
+            typedef Eigen::Matrix <qpOASES::real_t, 6, 6, Eigen::RowMajor> H_t;
+            typedef Eigen::Matrix <qpOASES::real_t, 6, 1> u_t;
+            static const H_t H (H_t::Identity ());
+            const u_t g (b);
+
+            // qpOASES expects A^T in row major order, which is A in column
+            // major order.
+            assert (A.rows () == 6 && A.outerStride () == 6);
+            assert ((std::size_t) A.cols () == zeros_.size ());
+            const qpOASES::real_t* a = A.data ();
+            setTolerance (qp_, options_, tolerance_);
+
+            qpOASES::int_t nwsr = (qpOASES::int_t) maxIterations_;
+            qpOASES::returnValue ret = qpOASES::RET_HOTSTART_FAILED;
+            iterations_ = 0;
+            warmStarted_ = false;
+            // H and g are constant and A only slightly changes: use the
+            // previous active set.
+            if (start_.size () == A.cols ()) {
+              // qpOASES guesses the active set from the multipliers, which
+              // are the contact forces.
+              u_t u (A * start_ - b);
+              y_.head <6> ().setZero ();
+              y_.tail (A.cols ()) = start_;
+              qp_.reset ();
+              ret = qp_.init (H.data (), g.data (), a, 0, 0, &zeros_ [0], 0,
+                  nwsr, 0, u.data (), y_.data ());
+              iterations_ += (std::size_t) nwsr;
+              warmStarted_ = (ret == SUCCESSFUL_RETURN);
+            } else if (qp_.isSolved ()) {
+              ret = qp_.hotstart (H.data (), g.data (), a, 0, 0, &zeros_ [0],
+                  0, nwsr, 0);
+              iterations_ += (std::size_t) nwsr;
+              warmStarted_ = (ret == SUCCESSFUL_RETURN);
+            }
+            if (ret != SUCCESSFUL_RETURN) {
+              nwsr = (qpOASES::int_t) maxIterations_;
+              qp_.reset ();
+              ret = qp_.init (H.data (), g.data (), a, 0, 0, &zeros_ [0], 0,
+                  nwsr, 0);
+              iterations_ += (std::size_t) nwsr;
+            }
+            start_.resize (0);
+            u_t u;
+            qp_.getPrimalSolution (u.data ());
+            qp_.getDualSolution (y_.data ());
+            solution_ = y_.tail (A.cols ());
+            dual_.noalias () = A.transpose () * u;
+            residual_ = u.squaredNorm ();
+            return ret == SUCCESSFUL_RETURN;
+          }
+
+          virtual void reset ()
+          {
+            qp_.reset ();
+            start_.resize (0);
+          }
+
+          virtual void warmStart (vectorIn_t solution)
+          {
+            start_ = solution;
+          }
+
+        private:
+          vector_t y_;
+          /// Solution given to warmStart, empty if none.
+          vector_t start_;
+          std::vector <qpOASES::real_t> zeros_;
+          qpOASES::Options options_;
+          qpOASES::SQProblem qp_;
+      }; // class ReducedQPSolver
     }
 
     const Eigen::Matrix <value_type, 6, 1> QPStaticStability::Gravity
@@ -45,22 +257,20 @@ namespace hpp {
         const CenterOfMassComputationPtr_t& com):
       DifferentiableFunction (robot->configSize (), robot->numberDof (),
           1, name),
-      Zeros (new qpOASES::real_t [contacts.size()]), nWSR (40),
-      robot_ (robot), nbContacts_ (contacts.size()),
-      com_ (com), H_ (nbContacts_,nbContacts_), G_ (nbContacts_),
-      qp_ (nbContacts_, qpOASES::HST_SEMIDEF),
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)), nbContacts_ (contacts.size()),
+      com_ (com), exactTolerance_ (0), accuracy_ (0),
       phi_ (Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero (6,nbContacts_),
           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero (6,nbContacts_*robot->numberDof())),
-      primal_ (vector_t::Zero (nbContacts_)), dual_ (vector_t::Zero (nbContacts_))
+      primal_ (vector_t::Zero (nbContacts_)), dual_ (vector_t::Zero (nbContacts_)),
+      solvedVersion_ (std::numeric_limits<std::size_t>::max ()),
+      objective_ (0), solvedOptimal_ (true),
+      nbSolves_ (0), nbWarmStarts_ (0)
     {
-      VectorMap_t zeros (Zeros, nbContacts_); zeros.setZero ();
-
-      qpOASES::Options options;
-      qp_.setOptions( options );
-
-      qp_.setPrintLevel (qpOASES::PL_NONE);
+      solver (NNLS);
+      CalculusArena::Scope scope (arena_);
       phi_.setSize (2,nbContacts_);
-      Traits<PointCom>::Ptr_t OG = PointCom::create(com);
+      Traits<PointCom>::Ptr_t OG =
+        PointCom::create (CenterOfMassCache::get (kinematics_, com));
       for (std::size_t i = 0; i < contacts.size(); ++i) {
         Traits<PointInJoint>::Ptr_t OP2 = PointInJoint::create
           (contacts[i].joint2,contacts[i].point2,robot->numberDof());
@@ -77,22 +287,20 @@ namespace hpp {
         const CenterOfMassComputationPtr_t& com):
       DifferentiableFunction (robot->configSize (), robot->numberDof (),
           1, name),
-      Zeros (new qpOASES::real_t [forceDatasToNbContacts (contacts)]), nWSR (40),
-      robot_ (robot), nbContacts_ (forceDatasToNbContacts (contacts)),
-      com_ (com), H_ (nbContacts_, nbContacts_), G_ (nbContacts_),
-      qp_ (nbContacts_, qpOASES::HST_SEMIDEF),
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)), nbContacts_ (forceDatasToNbContacts (contacts)),
+      com_ (com), exactTolerance_ (0), accuracy_ (0),
       phi_ (Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero (6,nbContacts_),
           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero (6,nbContacts_*robot->numberDof())),
-      primal_ (vector_t::Zero (nbContacts_)), dual_ (vector_t::Zero (nbContacts_))
+      primal_ (vector_t::Zero (nbContacts_)), dual_ (vector_t::Zero (nbContacts_)),
+      solvedVersion_ (std::numeric_limits<std::size_t>::max ()),
+      objective_ (0), solvedOptimal_ (true),
+      nbSolves_ (0), nbWarmStarts_ (0)
     {
-      VectorMap_t zeros (Zeros, nbContacts_); zeros.setZero ();
-
-      qpOASES::Options options;
-      qp_.setOptions( options );
-
-      qp_.setPrintLevel (qpOASES::PL_NONE);
+      solver (NNLS);
+      CalculusArena::Scope scope (arena_);
       phi_.setSize (2,nbContacts_);
-      Traits<PointCom>::Ptr_t OG = PointCom::create(com);
+      Traits<PointCom>::Ptr_t OG =
+        PointCom::create (CenterOfMassCache::get (kinematics_, com));
       std::size_t col = 0;
       for (std::size_t i = 0; i < contacts.size (); ++i) {
         Traits<VectorInJoint>::Ptr_t n = VectorInJoint::create
@@ -129,18 +337,60 @@ namespace hpp {
       return create ("QPStaticStability", robot, contacts, com);
     }
 
+    void QPStaticStability::solver (Solver_t solver)
+    {
+      switch (solver) {
+        case FULL_QP:
+          forceSolver_.reset (new FullQPSolver ((size_type) nbContacts_));
+          break;
+        case REDUCED_QP:
+          forceSolver_.reset (new ReducedQPSolver ((size_type) nbContacts_));
+          break;
+        case NNLS:
+          forceSolver_ = NNLSContactForceSolver::create ();
+          break;
+        case DUAL_ACTIVE_SET:
+          forceSolver_ = DualActiveSetContactForceSolver::create ();
+          break;
+        default:
+          throw std::invalid_argument ("QPStaticStability: use forceSolver "
+              "to set a custom solver");
+      }
+      solver_ = solver;
+      exactTolerance_ = forceSolver_->tolerance ();
+      updateTolerance ();
+    }
+
+    void QPStaticStability::forceSolver (const ContactForceSolverPtr_t& solver)
+    {
+      forceSolver_ = solver;
+      solver_ = CUSTOM;
+      exactTolerance_ = forceSolver_->tolerance ();
+      updateTolerance ();
+    }
+
+    void QPStaticStability::accuracy (value_type tolerance)
+    {
+      accuracy_ = tolerance;
+      updateTolerance ();
+    }
+
+    void QPStaticStability::updateTolerance ()
+    {
+      forceSolver_->tolerance (std::max (exactTolerance_, accuracy_));
+      solvedVersion_ = std::numeric_limits<std::size_t>::max ();
+    }
+
     void QPStaticStability::impl_compute (vectorOut_t result, ConfigurationIn_t argument) const
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
 
       phi_.invalidate ();
       phi_.computeValue ();
       // phi_.computeSVD ();
 
-      qpOASES::returnValue ret = solveQP (result);
-      if (ret != qpOASES::SUCCESSFUL_RETURN) {
-        hppDout (error, "QP could not be solved. Error is " << ret);
+      if (!solveQP (result)) {
+        hppDout (error, "QP could not be solved.");
       }
       if (!checkQPSol ()) {
         hppDout (error, "QP solution does not satisfies the constraints");
@@ -149,55 +399,96 @@ namespace hpp {
 
     void QPStaticStability::impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
+      kinematics_->update (argument, KinematicsCache::JACOBIANS);
 
       phi_.invalidate ();
       // phi_.computeSVD ();
-      phi_.computeJacobian ();
+      phi_.computeValue ();
 
-      vector_t res(1);
-      qpOASES::returnValue ret = solveQP (res);
-      if (ret != qpOASES::SUCCESSFUL_RETURN) {
-        hppDout (error, "QP could not be solved. Error is " << ret);
+      Eigen::Matrix <value_type, 1, 1> res;
+      if (!solveQP (res)) {
+        hppDout (error, "QP could not be solved.");
       }
       if (!checkQPSol ()) {
         hppDout (error, "QP solution does not satisfies the constraints");
       }
+      computeJacobian (jacobian);
+    }
+
+    void QPStaticStability::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, ConfigurationIn_t argument) const
+    {
+      kinematics_->update (argument, KinematicsCache::JACOBIANS);
+
+      phi_.invalidate ();
+      phi_.computeValue ();
+
+      if (!solveQP (result)) {
+        hppDout (error, "QP could not be solved.");
+      }
+      if (!checkQPSol ()) {
+        hppDout (error, "QP solution does not satisfies the constraints");
+      }
+      computeJacobian (jacobian);
+    }
+
+    void QPStaticStability::computeJacobian (matrixOut_t jacobian) const
+    {
       if (!checkStrictComplementarity ()) {
         hppDout (error, "Strict complementary slackness does not hold. "
             "Jacobian WILL be wrong.");
       }
 
-      // TODO preallocate this.
-      matrix_t JT_phi_F (nbContacts_, robot_->numberDof());
-      matrix_t J_F (6, robot_->numberDof());
-      phi_.jacobianTransposeTimes (phi_.value () * primal_, JT_phi_F);
-      phi_.jacobianTimes (primal_, J_F);
+      // With F = phi * primal, the jacobian is
+      // 0.5 * primal^T * (dphi^T/dq F) + (0.5 * F + Gravity)^T * (dphi/dq primal)
+      // = (F + Gravity)^T * (dphi/dq primal)
+      Eigen::Matrix <value_type, 6, 1> lhs;
+      lhs.noalias() = phi_.value () * primal_;
+      lhs += Gravity;
+      phi_.jacobianAdjoint (lhs, primal_, jacobian.row (0));
+    }
 
-      jacobian = 0.5 * primal_.transpose() * JT_phi_F
-        + (0.5 * phi_.value() * primal_ + Gravity).transpose() * J_F;
+    void QPStaticStability::saveWarmStart (vector_t& state) const
+    {
+      if (nbSolves_ == 0) state.resize (0);
+      else                state = forceSolver_->solution ();
     }
 
-    inline qpOASES::returnValue QPStaticStability::solveQP
-      (vectorOut_t result) const
+    void QPStaticStability::restoreWarmStart (vectorIn_t state)
     {
-      // TODO: Use the SVD to solve a smaller quadratic problem
-      // Try to find a positive solution
-      using qpOASES::SUCCESSFUL_RETURN;
+      if (state.size () != (size_type) nbContacts_) return;
+      forceSolver_->warmStart (state);
+    }
 
-      H_ = phi_.value().transpose () * phi_.value();
-      G_ = phi_.value().transpose () * Gravity;
+    inline bool QPStaticStability::solveQP (vectorOut_t result) const
+    {
+      // impl_jacobian solves for the configuration of impl_compute.
+      if (solvedVersion_ == kinematics_->version ()) {
+        result[0] = objective_;
+        return solvedOptimal_;
+      }
+
+      HPP_CONSTRAINTS_TRACE_SCOPE ("solveQP", "qp");
+      ++nbSolves_;
+      // min || phi F + Gravity ||^2 s.t. F >= 0, warm started from the
+      // previous solution.
+      const bool optimal = forceSolver_->solve (phi_.value (), MinusGravity);
+      countIterations (forceSolver_->iterations ());
+      if (forceSolver_->warmStarted ()) ++nbWarmStarts_;
+      primal_ = forceSolver_->solution ();
+      dual_ = forceSolver_->dual ();
+      result[0] = forceSolver_->residual ();
+
+      HPP_CONSTRAINTS_STATISTICS (
+          if (EvaluationStatistics* s = EvaluationStatistics::current ()) {
+            ++s->nbQPSolves;
+            if (!optimal) ++s->nbQPFailures;
+          });
 
-      qpOASES::int_t nwsr = nWSR;
-      qp_.reset ();
-      qp_.setHessianType (qpOASES::HST_SEMIDEF);
-      qpOASES::returnValue ret;
-      ret = qp_.init (H_.data(), G_.data(), Zeros, 0, nwsr, 0);
-      qp_.getPrimalSolution (primal_.data ());
-      qp_.getDualSolution (dual_.data ());
-      result[0] = 2*qp_.getObjVal () + MinusGravity.squaredNorm ();
-      return ret;
+      solvedVersion_ = kinematics_->version ();
+      objective_ = result[0];
+      solvedOptimal_ = optimal;
+      return optimal;
     }
 
     bool QPStaticStability::checkQPSol () const
@@ -207,11 +498,20 @@ namespace hpp {
 
     bool QPStaticStability::checkStrictComplementarity () const
     {
-      qpOASES::real_t eps = qp_.getOptions().boundTolerance;
+      static const qpOASES::real_t eps = qpOASES::Options ().boundTolerance;
       return (
              (primal_.array() > eps &&   dual_.cwiseAbs().array() <= eps )
           || (  dual_.array() > eps && primal_.cwiseAbs().array() <= eps )
           ).all();
     }
+
+    MemoryUsage QPStaticStability::memoryUsage () const
+    {
+      MemoryUsage m (DifferentiableFunction::memoryUsage ());
+      m.definition += sizeof (QPStaticStability)
+        - sizeof (DifferentiableFunction) + arena_.used ();
+      m.caches += memorySize (primal_) + memorySize (dual_);
+      return m;
+    }
   } // namespace constraints
 } // namespace hpp
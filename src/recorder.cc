@@ -0,0 +1,233 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/recorder.hh>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef boost::uint64_t Word_t;
+
+      const char magic [8] = { 'H', 'P', 'P', 'C', 'R', 'E', 'C', '1' };
+      /// Number of words of the header after the magic.
+      const std::size_t headerSize = 7;
+
+      /// Microseconds since the epoch.
+      inline long now ()
+      {
+        static const boost::posix_time::ptime epoch
+          (boost::gregorian::date (1970, 1, 1));
+        return (long) (boost::posix_time::microsec_clock::universal_time ()
+            - epoch).total_microseconds ();
+      }
+
+      inline std::size_t padded (std::size_t n)
+      {
+        return (n + sizeof (Word_t) - 1) / sizeof (Word_t) * sizeof (Word_t);
+      }
+
+      inline void write (std::ostream& os, Word_t w)
+      {
+        os.write (reinterpret_cast <const char*> (&w), sizeof (Word_t));
+      }
+
+      inline Word_t read (std::istream& is)
+      {
+        Word_t w = 0;
+        is.read (reinterpret_cast <char*> (&w), sizeof (Word_t));
+        return w;
+      }
+    } // namespace
+
+    RecorderPtr_t Recorder::create
+    (const DifferentiableFunctionPtr_t& function, const std::string& filename)
+    {
+      return RecorderPtr_t (new Recorder (function, filename));
+    }
+
+    Recorder::Recorder (const DifferentiableFunctionPtr_t& function,
+        const std::string& filename) :
+      DifferentiableFunction (function->inputSize (),
+          function->inputDerivativeSize (), function->outputSize (),
+          function->outputDerivativeSize (), function->name ()),
+      function_ (function),
+      file_ (filename.c_str (), std::ios::binary | std::ios::trunc),
+      nbRecords_ (0)
+    {
+      if (!file_)
+        throw std::runtime_error ("Recorder: cannot open " + filename);
+      activeDerivativeColumns_ = function->activeDerivativeColumns ();
+
+      std::ostringstream oss;
+      oss << function->name () << '\n' << *function;
+      const std::string description (oss.str ());
+      file_.write (magic, sizeof (magic));
+      write (file_, (Word_t) inputSize ());
+      write (file_, (Word_t) inputDerivativeSize ());
+      write (file_, (Word_t) outputSize ());
+      write (file_, (Word_t) outputDerivativeSize ());
+      write (file_, (Word_t) description.size ());
+      write (file_, (Word_t) (2 * sizeof (Word_t)
+            + inputSize () * sizeof (double)));
+      write (file_, 0);
+      file_.write (description.data (), description.size ());
+      for (std::size_t i = description.size ();
+          i < padded (description.size ()); ++i)
+        file_.put ('\0');
+    }
+
+    std::ostream& Recorder::print (std::ostream& o) const
+    {
+      o << "Recorder of ";
+      return function_->print (o);
+    }
+
+    void Recorder::flush ()
+    {
+      file_.flush ();
+    }
+
+    void Recorder::record (EvaluationStatistics::Evaluation evaluation,
+        long start, vectorIn_t argument) const
+    {
+      const Word_t duration = (Word_t) (now () - start) * 1000;
+#pragma omp critical (hpp_constraints_recorder)
+      {
+        write (file_, (Word_t) evaluation);
+        write (file_, duration);
+        for (size_type i = 0; i < argument.size (); ++i) {
+          const double x = (double) argument [i];
+          file_.write (reinterpret_cast <const char*> (&x), sizeof (double));
+        }
+        ++nbRecords_;
+      }
+    }
+
+    void Recorder::impl_compute (vectorOut_t result,
+        vectorIn_t argument) const
+    {
+      const long start = now ();
+      (*function_) (result, argument);
+      record (EvaluationStatistics::VALUE, start, argument);
+    }
+
+    void Recorder::impl_jacobian (matrixOut_t jacobian,
+        vectorIn_t argument) const
+    {
+      const long start = now ();
+      function_->jacobian (jacobian, argument);
+      record (EvaluationStatistics::JACOBIAN, start, argument);
+    }
+
+    void Recorder::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, vectorIn_t argument) const
+    {
+      const long start = now ();
+      function_->valueAndJacobian (result, jacobian, argument);
+      record (EvaluationStatistics::VALUE_AND_JACOBIAN, start, argument);
+    }
+
+    RecordingPtr_t Recording::load (const std::string& filename)
+    {
+      std::ifstream file (filename.c_str (), std::ios::binary);
+      if (!file)
+        throw std::runtime_error ("Recording: cannot open " + filename);
+      char m [sizeof (magic)];
+      file.read (m, sizeof (m));
+      if (!file || std::memcmp (m, magic, sizeof (magic)) != 0)
+        throw std::runtime_error ("Recording: " + filename
+            + " is not a recording");
+      Word_t header [headerSize];
+      for (std::size_t i = 0; i < headerSize; ++i) header [i] = read (file);
+      const size_type inputSize = (size_type) header [0];
+      const std::size_t recordSize = (std::size_t) header [5];
+      if (!file || recordSize != 2 * sizeof (Word_t)
+          + (std::size_t) inputSize * sizeof (double))
+        throw std::runtime_error ("Recording: " + filename
+            + " has an invalid header");
+
+      RecordingPtr_t recording (new Recording);
+      recording->inputDerivativeSize_ = (size_type) header [1];
+      recording->outputSize_ = (size_type) header [2];
+      recording->outputDerivativeSize_ = (size_type) header [3];
+      std::vector <char> description (padded ((std::size_t) header [4]));
+      if (!description.empty ())
+        file.read (&description [0], description.size ());
+      if (!file)
+        throw std::runtime_error ("Recording: " + filename
+            + " has an invalid description");
+      recording->description_.assign (description.begin (),
+          description.begin () + (std::ptrdiff_t) header [4]);
+
+      // Number of complete records.
+      const std::streampos begin = file.tellg ();
+      file.seekg (0, std::ios::end);
+      const std::size_t n = (std::size_t) (file.tellg () - begin) / recordSize;
+      file.seekg (begin);
+      recording->evaluations_.resize (n);
+      recording->durations_.resize ((size_type) n);
+      recording->arguments_.resize (inputSize, (size_type) n);
+      std::vector <double> argument ((std::size_t) inputSize);
+      for (std::size_t i = 0; i < n; ++i) {
+        recording->evaluations_ [i] =
+          (EvaluationStatistics::Evaluation) read (file);
+        recording->durations_ [(size_type) i] = 1e-9 * (value_type) read (file);
+        if (inputSize > 0)
+          file.read (reinterpret_cast <char*> (&argument [0]),
+              (std::streamsize) (inputSize * sizeof (double)));
+        for (size_type k = 0; k < inputSize; ++k)
+          recording->arguments_ (k, (size_type) i) = argument [k];
+      }
+      return recording;
+    }
+
+    void Recording::replay (const DifferentiableFunction& function,
+        vector_t& durations) const
+    {
+      if (function.inputSize () != inputSize ()
+          || function.inputDerivativeSize () != inputDerivativeSize_
+          || function.outputSize () != outputSize_
+          || function.outputDerivativeSize () != outputDerivativeSize_)
+        throw std::invalid_argument ("Recording: the function " +
+            function.name () + " does not have the sizes of the recording");
+      vector_t value (outputSize_);
+      matrix_t jacobian (outputDerivativeSize_, inputDerivativeSize_);
+      durations.resize ((size_type) size ());
+      for (std::size_t i = 0; i < size (); ++i) {
+        const long start = now ();
+        switch (evaluations_ [i]) {
+          case EvaluationStatistics::VALUE:
+            function (value, argument (i));
+            break;
+          case EvaluationStatistics::JACOBIAN:
+            function.jacobian (jacobian, argument (i));
+            break;
+          case EvaluationStatistics::VALUE_AND_JACOBIAN:
+            function.valueAndJacobian (value, jacobian, argument (i));
+            break;
+        }
+        durations [(size_type) i] = 1e-6 * (value_type) (now () - start);
+      }
+    }
+  } // namespace constraints
+} // namespace hpp
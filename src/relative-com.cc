@@ -19,12 +19,18 @@
 
 #include <hpp/constraints/relative-com.hh>
 
+#include <algorithm>
+
 #include <hpp/util/debug.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/center-of-mass-computation.hh>
 
 #include <hpp/constraints/macros.hh>
+#include <hpp/constraints/kinematics-batch.hh>
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/lipschitz.hh>
+#include <hpp/constraints/center-of-mass-cache.hh>
 
 namespace hpp {
   namespace constraints {
@@ -44,10 +50,9 @@ namespace hpp {
 					  const vector3_t reference,
                                           std::vector <bool> mask)
     {
-      CenterOfMassComputationPtr_t comc =
-        CenterOfMassComputation::create (robot);
-      comc->add (robot->rootJoint ());
-      return create (robot, comc, joint, reference, mask);
+      CenterOfMassCachePtr_t com =
+        CenterOfMassCache::get (KinematicsCache::get (robot));
+      return create (robot, com->computation (), joint, reference, mask);
     }
 
     RelativeComPtr_t RelativeCom::create (
@@ -67,72 +72,192 @@ namespace hpp {
         std::vector <bool> mask) :
       DifferentiableFunction (robot->configSize (), robot->numberDof (),
                                size (mask), "RelativeCom"),
-      robot_ (robot), comc_ (comc), joint_ (joint), reference_ (reference), mask_ (mask),
-      nominalCase_ (false), jacobian_ (3, robot->numberDof()-robot->extraConfigSpace().dimension())
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)), com_ (CenterOfMassCache::get (kinematics_, comc)), joint_ (joint), reference_ (reference), mask_ (mask),
+      selection_ (RowSelection_t::Zero (size (mask), 3))
     {
-      if (mask[0] && mask[1] && mask[2])
-        nominalCase_ = true;
-      jacobian_.setZero ();
+      size_type index = 0;
+      for (size_type i = 0; i < 3; ++i)
+        if (mask[i]) selection_ (index++, i) = 1;
+      // Only the columns of the joints moving the center of mass or the
+      // reference joint are active.
+      activeDerivativeColumns_ = com_->activeDerivativeColumns ();
+      activateJointColumns (joint_);
+      const size_type nv =
+        robot->numberDof() - robot->extraConfigSpace().dimension();
+      for (size_type i = 0; i < nv; ++i) {
+        if (!activeDerivativeColumns_ [i]) continue;
+        if (columns_.empty () ||
+            columns_.back ().first + columns_.back ().second != i)
+          columns_.push_back (Segment_t (i, 0));
+        ++columns_.back ().second;
+      }
     }
 
     void RelativeCom::impl_compute (vectorOut_t result,
 				    ConfigurationIn_t argument)
       const throw ()
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
-      comc_->compute (Device::COM);
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
+      com_->compute (Device::COM);
+      computeValue (result, joint_->currentTransformation (), com_->com ());
+    }
+
+    void RelativeCom::impl_jacobian (matrixOut_t jacobian,
+				     ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      com_->compute (Device::ALL);
+      computeJacobian (jacobian, joint_->currentTransformation (),
+          com_->com (), com_->jacobian (), joint_->jacobian ());
+    }
+
+    void RelativeCom::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      com_->compute (Device::ALL);
       const Transform3f& M = joint_->currentTransformation ();
-      const vector3_t& x = comc_->com ();
-      const matrix3_t& R = M.rotation ();
-      const vector3_t& t = M.translation ();
+      computeValue (result, M, com_->com ());
+      computeJacobian (jacobian, M, com_->com (), com_->jacobian (),
+          joint_->jacobian ());
+    }
 
-      if (nominalCase_)
-        result = R.transpose() * (x - t) - reference_;
-      else {
-        const vector3_t res ( R.transpose() * (x - t) - reference_);
-        size_t index = 0;
-        for (size_t i = 0; i < 3; ++i)
-          if (mask_[i]) {
-            result [index] = res [i];
-            index++;
-          }
+    void RelativeCom::impl_jacobianTimes (vectorOut_t result,
+        ConfigurationIn_t arg, vectorIn_t v) const
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      com_->compute (Device::ALL);
+      const ComJacobian_t& Jcom = com_->jacobian ();
+      const JointJacobian_t& Jjoint (joint_->jacobian ());
+      const Transform3f& M = joint_->currentTransformation ();
+      const matrix3_t& R (M.rotation ());
+      const RowSelection_t SRt (selection_ * R.transpose ());
+      const RowSelection_t SRtX (SRt * R.colwise().cross
+          (M.translation () - com_->com ()));
+      vector3_t dcom (vector3_t::Zero ()), dw (vector3_t::Zero ()),
+                dv (vector3_t::Zero ());
+      for (std::size_t i = 0; i < columns_.size (); ++i) {
+        const size_type b = columns_[i].first, n = columns_[i].second;
+        dcom.noalias() += Jcom.middleCols (b, n) * v.segment (b, n);
+        dw.noalias() += Jjoint.bottomRows<3>().middleCols (b, n)
+          * v.segment (b, n);
+        dv.noalias() += Jjoint.topRows<3>().middleCols (b, n)
+          * v.segment (b, n);
       }
+      result.noalias() = SRt * dcom + SRtX * dw - selection_ * dv;
     }
 
-    void RelativeCom::impl_jacobian (matrixOut_t jacobian,
-				     ConfigurationIn_t arg) const throw ()
+    void RelativeCom::impl_jacobianTransposeTimes (vectorOut_t result,
+        ConfigurationIn_t arg, vectorIn_t w) const
     {
-      robot_->currentConfiguration (arg);
-      robot_->computeForwardKinematics ();
-      comc_->compute (Device::ALL);
-      const ComJacobian_t& Jcom = comc_->jacobian ();
+      kinematics_->update (arg, KinematicsCache::JACOBIANS);
+      com_->compute (Device::ALL);
+      const ComJacobian_t& Jcom = com_->jacobian ();
       const JointJacobian_t& Jjoint (joint_->jacobian ());
       const Transform3f& M = joint_->currentTransformation ();
       const matrix3_t& R (M.rotation ());
-      const vector3_t& x (comc_->com ());
+      const RowSelection_t SRt (selection_ * R.transpose ());
+      const RowSelection_t SRtX (SRt * R.colwise().cross
+          (M.translation () - com_->com ()));
+      const vector3_t wcom (SRt.transpose () * w),
+                      ww (SRtX.transpose () * w),
+                      wv (selection_.transpose () * w);
+      result.setZero ();
+      for (std::size_t i = 0; i < columns_.size (); ++i) {
+        const size_type b = columns_[i].first, n = columns_[i].second;
+        result.segment (b, n).noalias() =
+          Jcom.middleCols (b, n).transpose () * wcom;
+        result.segment (b, n).noalias() +=
+          Jjoint.bottomRows<3>().middleCols (b, n).transpose () * ww;
+        result.segment (b, n).noalias() -=
+          Jjoint.topRows<3>().middleCols (b, n).transpose () * wv;
+      }
+    }
+
+    void RelativeCom::computeValue (vectorOut_t result, const Transform3f& M,
+        const vector3_t& x) const
+    {
+      const matrix3_t& R = M.rotation ();
+      const vector3_t& t = M.translation ();
+
+      result.noalias() = selection_ * (R.transpose() * (x - t) - reference_);
+    }
+
+    void RelativeCom::computeJacobian (matrixOut_t jacobian,
+        const Transform3f& M, const vector3_t& x, matrixIn_t Jcom,
+        matrixIn_t Jjoint) const
+    {
+      const matrix3_t& R (M.rotation ());
       const vector3_t& t (M.translation ());
 
-      // Right part
-      jacobian.rightCols (jacobian.cols () - Jjoint.cols ()).setZero ();
-      // Left part
-      // J = 0RTj ( Jcom + [ x - 0tj ]x 0Rj jJwj - 0Rj jJtj)
-      jacobian_ = R.transpose() * Jcom;
-      jacobian_.noalias() += (R.transpose() * R.colwise().cross(t-x)) * Jjoint.bottomRows<3>();
-
-      if (nominalCase_) {
-        jacobian.leftCols (Jjoint.cols ()).noalias() = jacobian_ - Jjoint.topRows<3>();
-      } else {
-        size_t index = 0;
-        for (size_t i = 0; i < 3; ++i)
-          if (mask_[i]) {
-            jacobian.row(index).head(Jjoint.cols()) = jacobian_.row (i) - Jjoint.row(i);
-            index++;
-          }
+      // J = S 0RTj ( Jcom + [ x - 0tj ]x 0Rj jJwj - 0Rj jJtj)
+      // where S selects the rows of the mask. The products are computed on
+      // the active columns only.
+      const RowSelection_t SRt (selection_ * R.transpose ());
+      const RowSelection_t SRtX (SRt * R.colwise().cross(t-x));
+      jacobian.setZero ();
+      for (std::size_t i = 0; i < columns_.size (); ++i) {
+        const size_type b = columns_[i].first, n = columns_[i].second;
+        jacobian.middleCols (b, n).noalias() = SRt * Jcom.middleCols (b, n);
+        jacobian.middleCols (b, n).noalias() +=
+          SRtX * Jjoint.bottomRows<3>().middleCols (b, n);
+        jacobian.middleCols (b, n).noalias() -=
+          selection_ * Jjoint.topRows<3>().middleCols (b, n);
       }
       hppDnum (info, "Jcom = " << std::endl << Jcom);
       hppDnum (info, "Jw = " << std::endl << Jjoint.bottomRows<3>());
       hppDnum (info, "Jv = " << std::endl << Jjoint.topRows<3>());
     }
+
+    void RelativeCom::addKinematics (KinematicsBatch& batch) const
+    {
+      batch.addJoint (joint_);
+      batch.addCenterOfMass (com_);
+    }
+
+    void RelativeCom::valueFromKinematics (matrixOut_t values,
+        const KinematicsBatch& batch) const
+    {
+      const PackedPlacements& M = batch.placements (joint_);
+      const vectors3_t& x = batch.centerOfMass (com_);
+      assert (values.rows () == outputSize () && values.cols () == M.size ());
+      for (size_type k = 0; k < M.size (); ++k)
+        computeValue (values.col (k), M.get (k), x.col (k));
+    }
+
+    void RelativeCom::jacobianFromKinematics (matrixOut_t jacobians,
+        const KinematicsBatch& batch) const
+    {
+      const size_type nv = inputDerivativeSize ();
+      const PackedPlacements& M = batch.placements (joint_);
+      const vectors3_t& x = batch.centerOfMass (com_);
+      const matrix_t& Jcom = batch.centerOfMassJacobians (com_);
+      const matrix_t& Jjoint = batch.jacobians (joint_);
+      assert (jacobians.rows () == outputDerivativeSize ()
+          && jacobians.cols () == M.size () * nv);
+      for (size_type k = 0; k < M.size (); ++k)
+        computeJacobian (jacobians.middleCols (k * nv, nv), M.get (k),
+            x.col (k), Jcom.middleCols (k * nv, nv),
+            Jjoint.middleCols (k * nv, nv));
+    }
+
+    value_type RelativeCom::lipschitzConstant () const
+    {
+      const se3::Model& model = robot_->model ();
+      const se3::JointIndex joint = joint_ ? joint_->index () : 0;
+      const ArrayXb& active = com_->activeDerivativeColumns ();
+      value_type L = 0;
+      // The bodies of the joints that do not move the center of mass are
+      // not in the computation.
+      for (se3::JointIndex j = 1; j < model.joints.size (); ++j) {
+        const se3::JointModel& jmodel = model.joints[j];
+        if (model.inertias[j].mass () <= 0
+            || !active.segment (jmodel.idx_v (), jmodel.nv ()).any ())
+          continue;
+        L = std::max (L, relativeVelocityBounds (robot_, joint, j,
+              model.inertias[j].lever ().norm ()).linear);
+      }
+      return L;
+    }
   } // namespace constraints
 } // namespace hpp
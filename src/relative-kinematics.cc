@@ -0,0 +1,106 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/relative-kinematics.hh>
+
+#include <limits>
+
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/tools.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      typedef Eigen::Block<const JointJacobian_t, 3, Eigen::Dynamic> HalfJacobian_t;
+    } // namespace
+
+    RelativeKinematicsPtr_t RelativeKinematics::get
+    (const KinematicsCachePtr_t& kinematics,
+     const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
+     size_type colBegin, size_type activeCols)
+    {
+      assert (kinematics && joint2);
+      KinematicsCache::RelativeKinematicsMap_t& c =
+        kinematics->relativeKinematics_;
+      const KinematicsCache::RelativeKinematicsMap_t::key_type key
+        (joint1 ? joint1->index () : 0, joint2->index ());
+      KinematicsCache::RelativeKinematicsMap_t::iterator _c = c.find (key);
+      if (_c != c.end ()) {
+        RelativeKinematicsPtr_t rk = _c->second.lock ();
+        if (rk) {
+          assert (rk->colBegin_ == colBegin && rk->activeCols_ == activeCols);
+          return rk;
+        }
+      }
+      RelativeKinematicsPtr_t rk (new RelativeKinematics
+          (kinematics, joint1, joint2, colBegin, activeCols));
+      c[key] = rk;
+
+      // Remove instances that are not used anymore.
+      for (_c = c.begin (); _c != c.end ();) {
+        if (_c->second.expired ()) c.erase (_c++);
+        else ++_c;
+      }
+      return rk;
+    }
+
+    RelativeKinematics::RelativeKinematics
+    (const KinematicsCachePtr_t& kinematics,
+     const JointConstPtr_t& joint1, const JointConstPtr_t& joint2,
+     size_type colBegin, size_type activeCols) :
+      kinematics_ (kinematics), joint1_ (joint1), joint2_ (joint2),
+      colBegin_ (colBegin), activeCols_ (activeCols),
+      translation_ (3, activeCols), rotation_ (3, activeCols),
+      placementVersion_ (std::numeric_limits<std::size_t>::max ()),
+      jacobianVersion_ (std::numeric_limits<std::size_t>::max ())
+    {}
+
+    void RelativeKinematics::computePlacement () const
+    {
+      const Transform3f& M2 = joint2_->currentTransformation ();
+      if (joint1_) placement_ = joint1_->currentTransformation ().actInv (M2);
+      else         placement_ = M2;
+      placementVersion_ = kinematics_->version ();
+    }
+
+    void RelativeKinematics::computeJacobian () const
+    {
+      const Transform3f& M2 = joint2_->currentTransformation ();
+      const JointJacobian_t& J2 = joint2_->jacobian ();
+      const HalfJacobian_t v2 (J2, 0, colBegin_, 3, activeCols_);
+      const HalfJacobian_t w2 (J2, 3, colBegin_, 3, activeCols_);
+
+      translation_.noalias() = M2.rotation () * v2;
+      if (joint1_) {
+        const Transform3f& M1 = joint1_->currentTransformation ();
+        const JointJacobian_t& J1 = joint1_->jacobian ();
+        const HalfJacobian_t v1 (J1, 0, colBegin_, 3, activeCols_);
+        const HalfJacobian_t w1 (J1, 3, colBegin_, 3, activeCols_);
+        matrix3_t X;
+        computeCrossMatrix (M2.translation () - M1.translation (), X);
+
+        rotation_.noalias() = M1.rotation () * w1;
+        translation_.noalias() -= M1.rotation () * v1;
+        translation_.noalias() += X * rotation_;
+        rotation_.noalias() -= M2.rotation () * w2;
+      } else {
+        rotation_.noalias() = - M2.rotation () * w2;
+      }
+      jacobianVersion_ = kinematics_->version ();
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,107 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/row-redundancy.hh>
+
+#include <algorithm>
+
+#include <hpp/constraints/differentiable-function-stack.hh>
+
+namespace hpp {
+  namespace constraints {
+    RowRedundancy::RowRedundancy (const DifferentiableFunctionStackPtr_t& stack,
+        value_type threshold) :
+      stack_ (stack), threshold_ (threshold), rank_ (0)
+    {
+      assert (stack_);
+      const DifferentiableFunctionStack::Functions_t& functions =
+        stack_->functions ();
+      ArrayXXb pattern;
+      stack_->jacobianPattern (pattern);
+      structural_ = ! pattern.rowwise ().any ();
+      for (std::size_t i = 0; i < functions.size (); ++i)
+        if (!stack_->active (stack_->handle (i)))
+          structural_.segment (stack_->derivativeRow (i),
+              functions[i]->outputDerivativeSize ()).setConstant (true);
+      redundant_ = structural_;
+    }
+
+    void RowRedundancy::analyse (matrixIn_t configurations)
+    {
+      assert (configurations.rows () == stack_->inputSize ());
+      if (configurations.cols () == 0) return;
+      const size_type m = stack_->outputDerivativeSize (),
+                      n = stack_->inputDerivativeSize ();
+      basis_.resize (n, std::min (m, n));
+      jacobian_.resize (m, n);
+      redundant_.setConstant (true);
+      vector_t v (n);
+      for (size_type s = 0; s < configurations.cols (); ++s) {
+        stack_->jacobian (jacobian_, configurations.col (s));
+        size_type k = 0;
+        for (size_type i = 0; i < m && k < n; ++i) {
+          if (structural_[i]) continue;
+          v = jacobian_.row (i).transpose ();
+          const value_type norm = v.norm ();
+          if (norm <= threshold_) continue;
+          // Orthogonalize twice for the sake of numerical stability.
+          for (int pass = 0; pass < 2; ++pass)
+            v.noalias () -= basis_.leftCols (k)
+              * (basis_.leftCols (k).transpose () * v);
+          const value_type residual = v.norm ();
+          if (residual <= threshold_ * norm) continue;
+          basis_.col (k) = v / residual;
+          ++k;
+          redundant_[i] = false;
+        }
+        rank_ = std::max (rank_, k);
+      }
+    }
+
+    bool RowRedundancy::redundant (std::size_t i) const
+    {
+      assert (i < stack_->functions ().size ());
+      return redundant_.segment (stack_->derivativeRow (i),
+          stack_->functions ()[i]->outputDerivativeSize ()).all ();
+    }
+
+    std::size_t RowRedundancy::prune ()
+    {
+      std::size_t nb = 0;
+      for (std::size_t i = 0; i < stack_->functions ().size (); ++i) {
+        const DifferentiableFunctionStack::Handle_t h = stack_->handle (i);
+        if (stack_->active (h) && redundant (i)) {
+          stack_->active (h, false);
+          ++nb;
+        }
+      }
+      return nb;
+    }
+
+    DifferentiableFunctionStackPtr_t RowRedundancy::reducedStack () const
+    {
+      DifferentiableFunctionStackPtr_t reduced =
+        DifferentiableFunctionStack::create (stack_->name () + " (reduced)");
+      const DifferentiableFunctionStack::Functions_t& functions =
+        stack_->functions ();
+      for (std::size_t i = 0; i < functions.size (); ++i)
+        if (stack_->active (stack_->handle (i)) && !redundant (i))
+          reduced->add (functions[i]);
+      return reduced;
+    }
+  } // namespace constraints
+} // namespace hpp
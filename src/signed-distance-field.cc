@@ -0,0 +1,354 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/constraints/signed-distance-field.hh>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <hpp/fcl/collision.h>
+#include <hpp/fcl/shape/geometric_shapes.h>
+#include <pinocchio/multibody/fcl.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/pinocchio/collision-object.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Header of the cache files.
+      struct CacheHeader
+      {
+        char magic [8];
+        unsigned long long key;
+        int dimensions [4];
+      };
+
+      const char cacheMagic [8] = "HPPSDF1";
+
+      /// Squared distance used for the voxels without any source.
+      const value_type farDistance = 1e20;
+
+      /// FNV-1a hash.
+      void hash (unsigned long long& h, const void* data, std::size_t size)
+      {
+        const unsigned char* bytes = static_cast <const unsigned char*> (data);
+        for (std::size_t i = 0; i < size; ++i) {
+          h ^= bytes [i];
+          h *= 1099511628211ULL;
+        }
+      }
+
+      void hash (unsigned long long& h, value_type v)
+      {
+        hash (h, &v, sizeof (v));
+      }
+
+      /// Squared distance transform of a sampled function in one dimension
+      /// (Felzenszwalb and Huttenlocher).
+      /// \param f the function, of size n,
+      /// \retval d the transform, of size n,
+      /// \param v, z buffers of size n and n + 1.
+      void distanceTransform (const value_type* f, value_type* d, int n,
+          int* v, value_type* z)
+      {
+        int k = 0;
+        v [0] = 0;
+        z [0] = - std::numeric_limits <value_type>::infinity ();
+        z [1] = + std::numeric_limits <value_type>::infinity ();
+        for (int q = 1; q < n; ++q) {
+          value_type s = ((f [q] + q * q) - (f [v [k]] + v [k] * v [k]))
+            / (2 * q - 2 * v [k]);
+          while (s <= z [k]) {
+            --k;
+            s = ((f [q] + q * q) - (f [v [k]] + v [k] * v [k]))
+              / (2 * q - 2 * v [k]);
+          }
+          ++k;
+          v [k] = q;
+          z [k] = s;
+          z [k + 1] = + std::numeric_limits <value_type>::infinity ();
+        }
+        k = 0;
+        for (int q = 0; q < n; ++q) {
+          while (z [k + 1] < q) ++k;
+          d [q] = (q - v [k]) * (q - v [k]) + f [v [k]];
+        }
+      }
+
+      /// Squared distance transform of a grid, one axis after the other.
+      void distanceTransform (std::vector <value_type>& f,
+          const Eigen::Vector3i& dims)
+      {
+        const int n = dims.maxCoeff ();
+        std::vector <value_type> line (n), d (n), z (n + 1);
+        std::vector <int> v (n);
+        const int strides [3] = { 1, dims [0], dims [0] * dims [1] };
+        for (int axis = 0; axis < 3; ++axis) {
+          const int a1 = (axis + 1) % 3, a2 = (axis + 2) % 3;
+          for (int i2 = 0; i2 < dims [a2]; ++i2) {
+            for (int i1 = 0; i1 < dims [a1]; ++i1) {
+              const int start = i1 * strides [a1] + i2 * strides [a2];
+              for (int i = 0; i < dims [axis]; ++i)
+                line [i] = f [start + i * strides [axis]];
+              distanceTransform (&line [0], &d [0], dims [axis], &v [0],
+                  &z [0]);
+              for (int i = 0; i < dims [axis]; ++i)
+                f [start + i * strides [axis]] = d [i];
+            }
+          }
+        }
+      }
+
+      /// Bounding sphere of an object in the world frame.
+      void boundingSphere (const CollisionObjectPtr_t& object,
+          vector3_t& center, value_type& radius)
+      {
+        fcl::CollisionGeometry& g = *object->geometry ();
+        g.computeLocalAABB ();
+        center = object->getTransform ().act (vector3_t
+            (g.aabb_center [0], g.aabb_center [1], g.aabb_center [2]));
+        radius = g.aabb_radius;
+      }
+    } // namespace
+
+    SignedDistanceFieldPtr_t SignedDistanceField::create
+    (const std::vector <CollisionObjectPtr_t>& objects,
+     value_type resolution, value_type margin, const std::string& cacheFile)
+    {
+      if (objects.empty ())
+        throw std::invalid_argument ("SignedDistanceField: no object.");
+      if (resolution <= 0)
+        throw std::invalid_argument
+          ("SignedDistanceField: the resolution must be positive.");
+      SignedDistanceFieldPtr_t ptr (new SignedDistanceField (resolution));
+
+      // Bounding box of the objects and identifier of the cache.
+      unsigned long long key = 14695981039346656037ULL;
+      vector3_t lower, upper;
+      lower.setConstant (+ std::numeric_limits <value_type>::infinity ());
+      upper.setConstant (- std::numeric_limits <value_type>::infinity ());
+      for (std::size_t i = 0; i < objects.size (); ++i) {
+        vector3_t c; value_type r;
+        boundingSphere (objects [i], c, r);
+        lower = lower.cwiseMin ((c.array () - r).matrix ());
+        upper = upper.cwiseMax ((c.array () + r).matrix ());
+        const std::string& name = objects [i]->name ();
+        hash (key, name.c_str (), name.size () + 1);
+        const Transform3f& M = objects [i]->getTransform ();
+        for (int j = 0; j < 3; ++j) {
+          hash (key, M.translation () [j]);
+          for (int k = 0; k < 3; ++k) hash (key, M.rotation () (j, k));
+          hash (key, c [j]);
+        }
+        hash (key, r);
+      }
+      hash (key, resolution);
+      hash (key, margin);
+
+      ptr->origin_ = (lower.array () - margin).matrix ();
+      for (int j = 0; j < 3; ++j)
+        ptr->dimensions_ [j] = std::max (2, (int) std::ceil
+            ((upper [j] - lower [j] + 2 * margin) / resolution) + 1);
+
+      if (!cacheFile.empty () && ptr->load (cacheFile, key)) return ptr;
+      ptr->bake (objects);
+      if (!cacheFile.empty ()) ptr->save (cacheFile, key);
+      return ptr;
+    }
+
+    SignedDistanceField::SignedDistanceField (value_type resolution) :
+      resolution_ (resolution), values_ (NULL), map_ (NULL), mapSize_ (0)
+    {}
+
+    SignedDistanceField::~SignedDistanceField ()
+    {
+      if (map_) munmap (map_, mapSize_);
+    }
+
+    void SignedDistanceField::bake
+    (const std::vector <CollisionObjectPtr_t>& objects)
+    {
+      const Eigen::Vector3i& dims = dimensions_;
+      const std::size_t n = (std::size_t) dims.prod ();
+      // Test the collision of each voxel with the objects whose bounding
+      // sphere overlaps the bounding sphere of the voxel.
+      std::vector <vector3_t> centers (objects.size ());
+      std::vector <value_type> radii (objects.size ());
+      std::vector <fcl::Transform3f> placements (objects.size ());
+      for (std::size_t o = 0; o < objects.size (); ++o) {
+        boundingSphere (objects [o], centers [o], radii [o]);
+        placements [o] = se3::toFclTransform3f (objects [o]->getTransform ());
+      }
+      const value_type voxelRadius = std::sqrt (3.) / 2 * resolution_;
+      const fcl::Box voxel (resolution_, resolution_, resolution_);
+      const fcl::CollisionRequest request;
+      fcl::CollisionResult result;
+      std::vector <value_type> outside (n, farDistance), inside (n, 0);
+      std::size_t index = 0;
+      for (int k = 0; k < dims [2]; ++k)
+        for (int j = 0; j < dims [1]; ++j)
+          for (int i = 0; i < dims [0]; ++i, ++index) {
+            const vector3_t p (origin_ + resolution_ * vector3_t (i, j, k));
+            const fcl::Transform3f placement (fcl::Vec3f (p [0], p [1], p [2]));
+            for (std::size_t o = 0; o < objects.size (); ++o) {
+              if ((p - centers [o]).norm () > radii [o] + voxelRadius) continue;
+              result.clear ();
+              fcl::collide (&voxel, placement, objects [o]->geometry ().get (),
+                  placements [o], request, result);
+              if (result.isCollision ()) {
+                outside [index] = 0;
+                inside [index] = farDistance;
+                break;
+              }
+            }
+          }
+
+      // Distance from the centers of the free voxels to the closest occupied
+      // voxel and conversely. The surface is half way between the centers.
+      distanceTransform (outside, dims);
+      distanceTransform (inside, dims);
+      buffer_.resize (n);
+      for (std::size_t i = 0; i < n; ++i) {
+        if (outside [i] > 0)
+          buffer_ [i] = (float) ((std::sqrt (outside [i]) - .5) * resolution_);
+        else
+          buffer_ [i] = (float) (- (std::sqrt (inside [i]) - .5) * resolution_);
+      }
+      values_ = &buffer_ [0];
+    }
+
+    bool SignedDistanceField::load (const std::string& file,
+        unsigned long long key)
+    {
+      const int fd = open (file.c_str (), O_RDONLY);
+      if (fd < 0) return false;
+      const std::size_t n = (std::size_t) dimensions_.prod ();
+      const std::size_t size = sizeof (CacheHeader) + n * sizeof (float);
+      struct stat st;
+      void* map = MAP_FAILED;
+      if (fstat (fd, &st) == 0 && (std::size_t) st.st_size == size)
+        map = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      close (fd);
+      if (map == MAP_FAILED) return false;
+      const CacheHeader& header = *static_cast <const CacheHeader*> (map);
+      if (std::memcmp (header.magic, cacheMagic, sizeof (cacheMagic)) != 0
+          || header.key != key
+          || header.dimensions [0] != dimensions_ [0]
+          || header.dimensions [1] != dimensions_ [1]
+          || header.dimensions [2] != dimensions_ [2]) {
+        munmap (map, size);
+        return false;
+      }
+      map_ = map;
+      mapSize_ = size;
+      values_ = reinterpret_cast <const float*>
+        (static_cast <const char*> (map) + sizeof (CacheHeader));
+      return true;
+    }
+
+    void SignedDistanceField::save (const std::string& file,
+        unsigned long long key) const
+    {
+      CacheHeader header;
+      std::memset (&header, 0, sizeof (header));
+      std::memcpy (header.magic, cacheMagic, sizeof (cacheMagic));
+      header.key = key;
+      for (int j = 0; j < 3; ++j) header.dimensions [j] = dimensions_ [j];
+      // Write a temporary file so that a concurrent load never maps an
+      // incomplete grid.
+      const std::string tmp (file + ".tmp");
+      {
+        std::ofstream os (tmp.c_str (), std::ios::binary);
+        os.write (reinterpret_cast <const char*> (&header), sizeof (header));
+        os.write (reinterpret_cast <const char*> (values_),
+            (std::streamsize) (buffer_.size () * sizeof (float)));
+        if (!os) {
+          hppDout (error, "Could not write the cache file " << tmp);
+          std::remove (tmp.c_str ());
+          return;
+        }
+      }
+      if (std::rename (tmp.c_str (), file.c_str ()) != 0) {
+        hppDout (error, "Could not write the cache file " << file);
+        std::remove (tmp.c_str ());
+      }
+    }
+
+    value_type SignedDistanceField::value (const vector3_t& point) const
+    {
+      vector3_t gradient;
+      return value (point, gradient);
+    }
+
+    value_type SignedDistanceField::value (const vector3_t& point,
+        vector3_t& gradient) const
+    {
+      // Coordinates in the grid, clamped to the grid.
+      const vector3_t x ((point - origin_) / resolution_);
+      int c [3];
+      value_type t [3];
+      vector3_t clamped;
+      for (int j = 0; j < 3; ++j) {
+        clamped [j] = std::min (std::max (x [j], (value_type) 0),
+            (value_type) (dimensions_ [j] - 1));
+        c [j] = std::min ((int) clamped [j], dimensions_ [j] - 2);
+        t [j] = clamped [j] - c [j];
+      }
+      const value_type
+        v000 = at (c[0]  , c[1]  , c[2]  ), v100 = at (c[0]+1, c[1]  , c[2]  ),
+        v010 = at (c[0]  , c[1]+1, c[2]  ), v110 = at (c[0]+1, c[1]+1, c[2]  ),
+        v001 = at (c[0]  , c[1]  , c[2]+1), v101 = at (c[0]+1, c[1]  , c[2]+1),
+        v011 = at (c[0]  , c[1]+1, c[2]+1), v111 = at (c[0]+1, c[1]+1, c[2]+1);
+      // Interpolate along x, then y, then z.
+      const value_type
+        v00 = v000 + t[0] * (v100 - v000), v10 = v010 + t[0] * (v110 - v010),
+        v01 = v001 + t[0] * (v101 - v001), v11 = v011 + t[0] * (v111 - v011);
+      const value_type v0 = v00 + t[1] * (v10 - v00),
+                       v1 = v01 + t[1] * (v11 - v01);
+      value_type d = v0 + t[2] * (v1 - v0);
+
+      const value_type
+        dx00 = v100 - v000, dx10 = v110 - v010,
+        dx01 = v101 - v001, dx11 = v111 - v011;
+      const value_type dx0 = dx00 + t[1] * (dx10 - dx00),
+                       dx1 = dx01 + t[1] * (dx11 - dx01);
+      gradient [0] = (dx0 + t[2] * (dx1 - dx0)) / resolution_;
+      gradient [1] = ((v10 - v00) + t[2] * ((v11 - v01) - (v10 - v00)))
+        / resolution_;
+      gradient [2] = (v1 - v0) / resolution_;
+
+      // Beyond the grid, add the distance to the grid.
+      const vector3_t offset ((x - clamped) * resolution_);
+      const value_type outside = offset.norm ();
+      if (outside > 0) {
+        d += outside;
+        gradient = offset / outside;
+      }
+      return d;
+    }
+  } // namespace constraints
+} // namespace hpp
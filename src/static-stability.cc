@@ -22,6 +22,7 @@
 #include <hpp/pinocchio/device.hh>
 
 #include "hpp/constraints/tools.hh"
+#include "hpp/constraints/kinematics-cache.hh"
 
 namespace hpp {
   namespace constraints {
@@ -34,17 +35,23 @@ namespace hpp {
         const CenterOfMassComputationPtr_t& com):
       DifferentiableFunction (robot->configSize (), robot->numberDof (),
           contacts.size() + 6, name),
-      robot_ (robot), contacts_ (contacts), com_ (com),
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)), contacts_ (contacts), com_ (com),
       phi_ (Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero (6,contacts.size()),
           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero (6,contacts.size()*robot->numberDof())),
       u_ (contacts.size()), uMinus_ (contacts.size()), v_ (contacts.size()),
       uDot_ (contacts.size(), robot->numberDof()),
       uMinusDot_ (contacts.size(), robot->numberDof()),
       vDot_ (contacts.size(), robot->numberDof()),
-      lambdaDot_ (robot->numberDof())
+      lambdaDot_ (robot->numberDof()), s_ (contacts.size()),
+      timesRhs_ (contacts.size(), 2), transposeTimesRhs_ (6, 3),
+      times_ (2 * 6, robot->numberDof()),
+      transposeTimes_ (3 * contacts.size(), robot->numberDof()),
+      V1tX_ (6, robot->numberDof()), piTX_ (6, robot->numberDof())
     {
+      CalculusArena::Scope scope (arena_);
       phi_.setSize (2,contacts.size());
-      Traits<PointCom>::Ptr_t OG = PointCom::create (com);
+      Traits<PointCom>::Ptr_t OG =
+        PointCom::create (CenterOfMassCache::get (kinematics_, com));
       for (std::size_t i = 0; i < contacts.size(); ++i) {
         Traits<PointInJoint>::Ptr_t OP2 =
           PointInJoint::create (contacts[i].joint2,contacts[i].point2,robot->numberDof());
@@ -72,17 +79,53 @@ namespace hpp {
 
     void StaticStability::impl_compute (vectorOut_t result, ConfigurationIn_t argument) const
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS);
 
       phi_.invalidate ();
 
       phi_.computeSVD ();
 
+      computeValue (result);
+    }
+
+    void StaticStability::impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const
+    {
+      kinematics_->update (argument, KinematicsCache::JACOBIANS);
+
+      phi_.invalidate ();
+
+      phi_.computeSVD ();
+
+      const Eigen::Matrix <value_type, 6, 1> G = - 1 * Gravity;
+      phi_.computePseudoInverse ();
+      u_.noalias() = phi_.pinv () * G;
+      const bool hasUMinus = computeUminusAndV (u_, uMinus_, v_);
+
+      computeJacobian (jacobian, hasUMinus);
+    }
+
+    void StaticStability::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, ConfigurationIn_t argument) const
+    {
+      kinematics_->update (argument, KinematicsCache::JACOBIANS);
+
+      phi_.invalidate ();
+
+      phi_.computeSVD ();
+
+      const bool hasUMinus = computeValue (result);
+      computeJacobian (jacobian, hasUMinus);
+    }
+
+    bool StaticStability::computeValue (vectorOut_t result) const
+    {
       const Eigen::Matrix <value_type, 6, 1> G = - 1 * Gravity;
-      u_.noalias() = phi_.svd().solve (G);
+      // Same as phi_.svd().solve (G), without temporary.
+      phi_.computePseudoInverse ();
+      u_.noalias() = phi_.pinv () * G;
 
-      if (computeUminusAndV (u_, uMinus_, v_)) {
+      const bool hasUMinus = computeUminusAndV (u_, uMinus_, v_);
+      if (hasUMinus) {
         // value_type lambda, unused_lMax; size_type iMax, iMin;
         // findBoundIndex (u_, v_, lambda, &iMin, unused_lMax, &iMax);
         value_type lambda = 1;
@@ -91,32 +134,60 @@ namespace hpp {
       } else {
         result.segment (0, contacts_.size()) = u_;
       }
-      result.segment <6> (contacts_.size()) = Gravity + phi_.value() * u_;
+      result.segment <6> (contacts_.size()).noalias() = phi_.value() * u_;
+      result.segment <6> (contacts_.size()) += Gravity;
+      return hasUMinus;
     }
 
-    void StaticStability::impl_jacobian (matrixOut_t jacobian, ConfigurationIn_t argument) const
+    void StaticStability::computeJacobian (matrixOut_t jacobian,
+        bool hasUMinus) const
     {
-      robot_->currentConfiguration (argument);
-      robot_->computeForwardKinematics ();
-
-      phi_.invalidate ();
+      using namespace hpp::pinocchio;
 
-      phi_.computeSVD ();
       phi_.computeJacobian ();
       phi_.computePseudoInverse ();
 
+      const size_type n = contacts_.size(), nv = robot_->numberDof();
+      const MoE_t::SVD_t& svd = phi_.svd ();
+      const size_type rank = svd.rank ();
       const Eigen::Matrix <value_type, 6, 1> G = - 1 * Gravity;
-      u_.noalias() = phi_.svd().solve (G);
-      phi_.computePseudoInverseJacobian (G);
-      uDot_.noalias () = phi_.pinvJacobian ();
-
-      jacobian.block (0, 0, contacts_.size(), robot_->numberDof()).noalias ()
-        = uDot_;
 
-      if (computeUminusAndV (u_, uMinus_, v_)) {
-        matrix_t S = - matrix_t::Identity (u_.size(), u_.size());
-        S.diagonal () = 1 * (u_.array () >= 0).select
-          (0, - vector_t::Ones (u_.size()));
+      // d (Phi^+ G) = - Phi^+ dPhi u + Phi^+ Phi^+T dPhi^T (I - Phi Phi^+) G
+      //               + (I - Phi^+ Phi) dPhi^T Phi^+T u
+      // d v = (I - Phi^+ Phi) (d uMinus - dPhi^T Phi^+T Phi^+ Phi uMinus)
+      //       - Phi^+ dPhi v
+      // where (I - Phi Phi^+) Phi uMinus = 0 and Phi^+ Phi uMinus = uMinus - v.
+      const size_type nTimes = (hasUMinus ? 2 : 1);
+      const size_type nTransposeTimes = (hasUMinus ? 3 : 2);
+      timesRhs_.col (0) = u_;
+      transposeTimesRhs_.col (0) = G;
+      transposeTimesRhs_.col (0).noalias() -= getU1 <MoE_t::SVD_t> (svd) *
+        (getU1 <MoE_t::SVD_t> (svd).adjoint() * G);
+      transposeTimesRhs_.col (1).noalias() = phi_.pinv ().transpose () * u_;
+      if (hasUMinus) {
+        timesRhs_.col (1) = v_;
+        transposeTimesRhs_.col (2).noalias() =
+          phi_.pinv ().transpose () * (uMinus_ - v_);
+      }
+      phi_.jacobianTimesColumns (timesRhs_.leftCols (nTimes),
+          times_.topRows (6 * nTimes));
+      phi_.jacobianTransposeTimesColumns
+        (transposeTimesRhs_.leftCols (nTransposeTimes),
+         transposeTimes_.topRows (n * nTransposeTimes));
+
+      piTX_.noalias() = phi_.pinv ().transpose () * transposeTimes_.topRows (n);
+      piTX_ -= times_.topRows <6> ();
+      uDot_.noalias() = phi_.pinv () * piTX_;
+      uDot_ += transposeTimes_.middleRows (n, n);
+      V1tX_.topRows (rank).noalias() = getV1 <MoE_t::SVD_t> (svd).adjoint() *
+        transposeTimes_.middleRows (n, n);
+      uDot_.noalias() -= getV1 <MoE_t::SVD_t> (svd) * V1tX_.topRows (rank);
+
+      jacobian.block (0, 0, n, nv).noalias () = uDot_;
+
+      if (hasUMinus) {
+        // Diagonal of d uMinus / d u.
+        s_ = - (u_.array () < 0).cast <value_type> ();
 
         // value_type lambda, unused_lMax; size_type iMax, iMin;
         // findBoundIndex (u_, v_, lambda, &iMin, unused_lMax, &iMax);
@@ -124,22 +195,25 @@ namespace hpp {
           // return;
         value_type lambda = 1;
 
-        computeVDot (uMinus_, S.diagonal(), uDot_, uMinusDot_, vDot_);
+        uMinusDot_.noalias() = s_.asDiagonal() * uDot_;
+        vDot_ = uMinusDot_ - transposeTimes_.middleRows (2 * n, n);
+        V1tX_.topRows (rank).noalias() =
+          getV1 <MoE_t::SVD_t> (svd).adjoint() * vDot_;
+        vDot_.noalias() -= getV1 <MoE_t::SVD_t> (svd) * V1tX_.topRows (rank);
+        vDot_.noalias() -= phi_.pinv () * times_.middleRows <6> (6);
 
         // computeLambdaDot (u_, v_, iMin, uDot_, vDot_, lambdaDot_);
 
         // jacobian.block (0, 0, contacts_.size(), robot_->numberDof()).noalias ()
           // += lambda * vDot_ + v_ * lambdaDot_.transpose ();
 
-        jacobian.block (0, 0, contacts_.size(), robot_->numberDof()).noalias ()
-          += lambda * vDot_;
+        jacobian.block (0, 0, n, nv).noalias () += lambda * vDot_;
       }
 
-      phi_.jacobianTimes (u_,
-          jacobian.block (contacts_.size(), 0, 6, robot_->numberDof()));
-      phi_.computePseudoInverseJacobian (Gravity);
-      jacobian.block (contacts_.size(), 0, 6, robot_->numberDof())
-        += - phi_.value() * phi_.pinvJacobian ();
+      // The pseudo inverse jacobian is linear in the right hand side, so
+      // the one of Gravity is - uDot_.
+      jacobian.block (n, 0, 6, nv) = times_.topRows <6> ();
+      jacobian.block (n, 0, 6, nv).noalias() += phi_.value() * uDot_;
     }
 
     void StaticStability::findBoundIndex (vectorIn_t u, vectorIn_t v,
@@ -164,35 +238,15 @@ namespace hpp {
 
       if (uMinus.isZero ()) return false;
 
-      v.noalias() = getV2 <MoE_t::SVD_t> (phi_.svd()) *
-        ( getV2 <MoE_t::SVD_t> (phi_.svd()).adjoint() * uMinus );
-      // v.noalias() = uMinus;
-      // v.noalias() -= getV1 <MoE_t::SVD_t> (phi_.svd()) *
-        // ( getV1 <MoE_t::SVD_t> (phi_.svd()).adjoint() * uMinus );
+      // V2 * V2^T = I - V1 * V1^T and V1 has at most 6 columns.
+      const size_type rank = phi_.svd().rank ();
+      Eigen::Matrix <value_type, Eigen::Dynamic, 1, 0, 6, 1> V1tu (rank);
+      V1tu.noalias() = getV1 <MoE_t::SVD_t> (phi_.svd()).adjoint() * uMinus;
+      v.noalias() = uMinus;
+      v.noalias() -= getV1 <MoE_t::SVD_t> (phi_.svd()) * V1tu;
       return true;
     }
 
-    void StaticStability::computeVDot (vectorIn_t uMinus,
-        vectorIn_t S, matrixIn_t uDot, matrixOut_t uMinusDot,
-        matrixOut_t vDot) const
-    {
-      using namespace hpp::pinocchio;
-
-      uMinusDot.noalias() = S.asDiagonal() * uDot;
-      vDot.noalias() = uMinusDot;
-      vDot.noalias() -= getV1 <MoE_t::SVD_t> (phi_.svd()) *
-        ( getV1 <MoE_t::SVD_t> (phi_.svd()).adjoint() * uMinusDot );
-
-      // TODO: preallocate this matrix
-      Eigen::Matrix <value_type, 6, Eigen::Dynamic>
-        JphiTimesUMinus (6,robot_->numberDof());
-      phi_.jacobianTimes (uMinus, JphiTimesUMinus);
-      vDot.noalias() -= phi_.pinv () * JphiTimesUMinus;
-
-      phi_.computePseudoInverseJacobian (phi_.value () * uMinus);
-      vDot.noalias() -= phi_.pinvJacobian ();
-    }
-
     void StaticStability::computeLambdaDot (vectorIn_t u, vectorIn_t v,
         const std::size_t i0, matrixIn_t uDot, matrixIn_t vDot,
         vectorOut_t lambdaDot) const
@@ -204,5 +258,33 @@ namespace hpp {
         lambdaDot.noalias () += (u(i0) / (v(i0)*v(i0)) ) * vDot.row(i0);
       }
     }
+
+    void StaticStability::saveWarmStart (vector_t& state) const
+    {
+      const matrix_t& W = phi_.svd ().warmStart ();
+      state = Eigen::Map <const vector_t> (W.data (), W.size ());
+    }
+
+    void StaticStability::restoreWarmStart (vectorIn_t state)
+    {
+      const size_type m = phi_.svd ().warmStart ().rows ();
+      if (state.size () != m * m) return;
+      phi_.svd ().warmStart (Eigen::Map <const matrix_t> (state.data (), m, m));
+    }
+
+    MemoryUsage StaticStability::memoryUsage () const
+    {
+      MemoryUsage m (DifferentiableFunction::memoryUsage ());
+      m.definition += sizeof (StaticStability)
+        - sizeof (DifferentiableFunction) + memorySize (contacts_)
+        + arena_.used ();
+      m.scratch += memorySize (u_) + memorySize (uMinus_) + memorySize (v_)
+        + memorySize (uDot_) + memorySize (uMinusDot_) + memorySize (vDot_)
+        + memorySize (lambdaDot_) + memorySize (s_)
+        + memorySize (timesRhs_) + memorySize (transposeTimesRhs_)
+        + memorySize (times_) + memorySize (transposeTimes_)
+        + memorySize (V1tX_) + memorySize (piTX_);
+      return m;
+    }
   } // namespace constraints
 } // namespace hpp
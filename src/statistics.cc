@@ -0,0 +1,123 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/statistics.hh>
+
+#include <ostream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      EvaluationStatistics* currentStatistics = NULL;
+#pragma omp threadprivate(currentStatistics)
+
+      /// Microseconds since the epoch.
+      inline long now ()
+      {
+        static const boost::posix_time::ptime epoch
+          (boost::gregorian::date (1970, 1, 1));
+        return (long) (boost::posix_time::microsec_clock::universal_time ()
+            - epoch).total_microseconds ();
+      }
+    } // namespace
+
+    void EvaluationStatistics::reset ()
+    {
+      nbValues = nbJacobians = nbValueAndJacobians = 0;
+      valueTime = jacobianTime = valueAndJacobianTime = 0;
+      nbKinematicsUpdates = nbKinematicsHits = 0;
+      nbQPSolves = nbQPIterations = nbQPFailures = 0;
+      nbNarrowPhases = 0;
+    }
+
+    EvaluationStatistics& EvaluationStatistics::operator+=
+    (const EvaluationStatistics& other)
+    {
+      nbValues             += other.nbValues;
+      nbJacobians          += other.nbJacobians;
+      nbValueAndJacobians  += other.nbValueAndJacobians;
+      valueTime            += other.valueTime;
+      jacobianTime         += other.jacobianTime;
+      valueAndJacobianTime += other.valueAndJacobianTime;
+      nbKinematicsUpdates  += other.nbKinematicsUpdates;
+      nbKinematicsHits     += other.nbKinematicsHits;
+      nbQPSolves           += other.nbQPSolves;
+      nbQPIterations       += other.nbQPIterations;
+      nbQPFailures         += other.nbQPFailures;
+      nbNarrowPhases       += other.nbNarrowPhases;
+      return *this;
+    }
+
+    const char* EvaluationStatistics::name (Evaluation evaluation)
+    {
+      switch (evaluation) {
+        case VALUE:              return "value";
+        case JACOBIAN:           return "jacobian";
+        case VALUE_AND_JACOBIAN: return "valueAndJacobian";
+      }
+      return "";
+    }
+
+    EvaluationStatistics* EvaluationStatistics::current ()
+    {
+      return currentStatistics;
+    }
+
+    EvaluationStatistics::Scope::Scope (EvaluationStatistics& statistics,
+        Evaluation evaluation) :
+      statistics_ (statistics), previous_ (currentStatistics),
+      evaluation_ (evaluation), start_ (now ())
+    {
+      currentStatistics = &statistics_;
+    }
+
+    EvaluationStatistics::Scope::~Scope ()
+    {
+      const value_type t = 1e-6 * (value_type) (now () - start_);
+      switch (evaluation_) {
+        case VALUE:
+          ++statistics_.nbValues;
+          statistics_.valueTime += t;
+          break;
+        case JACOBIAN:
+          ++statistics_.nbJacobians;
+          statistics_.jacobianTime += t;
+          break;
+        case VALUE_AND_JACOBIAN:
+          ++statistics_.nbValueAndJacobians;
+          statistics_.valueAndJacobianTime += t;
+          break;
+      }
+      currentStatistics = previous_;
+    }
+
+    std::ostream& operator<< (std::ostream& os,
+        const EvaluationStatistics& s)
+    {
+      return os << "values: " << s.nbValues << " (" << s.valueTime << " s)"
+        << ", jacobians: " << s.nbJacobians << " (" << s.jacobianTime << " s)"
+        << ", both: " << s.nbValueAndJacobians
+        << " (" << s.valueAndJacobianTime << " s)"
+        << ", kinematics: " << s.nbKinematicsUpdates
+        << " updates / " << s.nbKinematicsHits << " hits"
+        << ", QP: " << s.nbQPSolves << " solves / " << s.nbQPIterations
+        << " iterations / " << s.nbQPFailures << " failures"
+        << ", narrow phases: " << s.nbNarrowPhases;
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,236 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/support-polygon-stability.hh>
+
+#include <algorithm>
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/kinematics-cache.hh>
+#include <hpp/constraints/center-of-mass-cache.hh>
+#include <hpp/constraints/qp-static-stability.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Lexicographic order of the projections of the points.
+      struct Lexicographic
+      {
+        Lexicographic (const std::vector <vector3_t>& p) : points (p) {}
+        bool operator() (std::size_t i, std::size_t j) const
+        {
+          const vector3_t& a = points[i]; const vector3_t& b = points[j];
+          return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+        }
+        const std::vector <vector3_t>& points;
+      };
+
+      /// z coordinate of (b - a) x (c - a).
+      inline value_type cross (const vector3_t& a, const vector3_t& b,
+          const vector3_t& c)
+      {
+        return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+      }
+    } // namespace
+
+    SupportPolygonStabilityPtr_t SupportPolygonStability::create
+    (const std::string& name, const DevicePtr_t& robot,
+     const std::vector <ForceData>& contacts,
+     const CenterOfMassComputationPtr_t& com)
+    {
+      return SupportPolygonStabilityPtr_t
+        (new SupportPolygonStability (name, robot, contacts, com));
+    }
+
+    SupportPolygonStability::SupportPolygonStability
+    (const std::string& name, const DevicePtr_t& robot,
+     const std::vector <ForceData>& contacts,
+     const CenterOfMassComputationPtr_t& com) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (), 1,
+          name),
+      robot_ (robot), kinematics_ (KinematicsCache::get (robot)),
+      com_ (CenterOfMassCache::get (kinematics_, com)),
+      fallback_ (QPStaticStability::create (name, robot, contacts, com)),
+      tolerance_ (1e-6), supportPolygon_ (false), ia_ (0), ib_ (0)
+    {
+      for (std::size_t i = 0; i < contacts.size (); ++i) {
+        normals_.push_back (contacts[i].normal);
+        normalJoints_.push_back (contacts[i].joint);
+        for (std::size_t j = 0; j < contacts[i].points.size (); ++j) {
+          Point p;
+          p.joint = contacts[i].joint;
+          p.local = contacts[i].points[j];
+          points_.push_back (p);
+        }
+      }
+      world_.resize (points_.size ());
+      hull_.reserve (2 * points_.size ());
+      order_.resize (points_.size ());
+      activeDerivativeColumns_ = fallback_->activeDerivativeColumns ();
+    }
+
+    bool SupportPolygonStability::computeSupport
+    (ConfigurationIn_t argument, bool jacobian) const
+    {
+      if (points_.empty ()) return false;
+      kinematics_->update (argument, jacobian ? KinematicsCache::JACOBIANS
+          : KinematicsCache::PLACEMENTS);
+      for (std::size_t i = 0; i < normals_.size (); ++i) {
+        const vector3_t n (normalJoints_[i] ?
+            vector3_t (normalJoints_[i]->currentTransformation ().rotation ()
+              * normals_[i]) : normals_[i]);
+        if (n[2] <= 0 || n.head <2> ().norm () > tolerance_) return false;
+      }
+      for (std::size_t i = 0; i < points_.size (); ++i) {
+        const Point& p = points_[i];
+        world_[i] = p.joint ?
+          vector3_t (p.joint->currentTransformation ().act (p.local)) :
+          p.local;
+        if (std::abs (world_[i][2] - world_[0][2]) > tolerance_) return false;
+      }
+      com_->compute (jacobian ? Device::ALL : Device::COM);
+
+      // Convex hull of the projections, by the monotone chain algorithm.
+      for (std::size_t i = 0; i < order_.size (); ++i) order_[i] = i;
+      std::sort (order_.begin (), order_.end (), Lexicographic (world_));
+      hull_.clear ();
+      for (std::size_t k = 0; k < order_.size (); ++k) {
+        while (hull_.size () >= 2 && cross (world_[hull_[hull_.size () - 2]],
+              world_[hull_.back ()], world_[order_[k]]) <= 0)
+          hull_.pop_back ();
+        hull_.push_back (order_[k]);
+      }
+      const std::size_t lower = hull_.size () + 1;
+      for (std::size_t k = order_.size () - 1; k-- > 0;) {
+        while (hull_.size () >= lower && cross (world_[hull_[hull_.size () - 2]],
+              world_[hull_.back ()], world_[order_[k]]) <= 0)
+          hull_.pop_back ();
+        hull_.push_back (order_[k]);
+      }
+      if (hull_.size () > 1) hull_.pop_back ();
+      return true;
+    }
+
+    value_type SupportPolygonStability::computeDistance () const
+    {
+      const vector3_t& c = com_->com ();
+      const std::size_t m = hull_.size ();
+      gc_.setZero (); ga_.setZero (); gb_.setZero ();
+      // Closest edge if the point is inside.
+      bool inside = (m >= 3);
+      value_type sInside = - std::numeric_limits <value_type>::infinity ();
+      std::size_t kInside = 0;
+      // Closest point of the boundary.
+      value_type dOutside = std::numeric_limits <value_type>::infinity ();
+      value_type tOutside = 0;
+      std::size_t kOutside = 0;
+      vector3_t w, rOutside (vector3_t::Zero ());
+      for (std::size_t k = 0; k < m; ++k) {
+        const vector3_t& a = world_[hull_[k]];
+        const vector3_t& b = world_[hull_[(k + 1) % m]];
+        const value_type ex = b[0] - a[0], ey = b[1] - a[1];
+        const value_type L2 = ex * ex + ey * ey;
+        if (L2 == 0) continue;
+        w << c[0] - a[0], c[1] - a[1], 0;
+        const value_type s = - (ex * w[1] - ey * w[0]) / std::sqrt (L2);
+        if (s > 0) inside = false;
+        if (s > sInside) { sInside = s; kInside = k; }
+        const value_type t = std::min (value_type (1), std::max
+            (value_type (0), (w[0] * ex + w[1] * ey) / L2));
+        const vector3_t r (w[0] - t * ex, w[1] - t * ey, 0);
+        const value_type d = r.norm ();
+        if (d < dOutside) {
+          dOutside = d; tOutside = t; kOutside = k; rOutside = r;
+        }
+      }
+      if (dOutside == std::numeric_limits <value_type>::infinity ()) {
+        // All the points project on the same point.
+        ia_ = ib_ = hull_[0];
+        rOutside << c[0] - world_[ia_][0], c[1] - world_[ia_][1], 0;
+        const value_type d = rOutside.norm ();
+        if (d > 0) gc_ = rOutside / d;
+        ga_ = - gc_;
+        return d;
+      }
+      if (inside) {
+        ia_ = hull_[kInside]; ib_ = hull_[(kInside + 1) % m];
+        const vector3_t& a = world_[ia_];
+        const vector3_t& b = world_[ib_];
+        const vector3_t e (b[0] - a[0], b[1] - a[1], 0);
+        w << c[0] - a[0], c[1] - a[1], 0;
+        const value_type L = e.norm ();
+        const value_type cr = e[0] * w[1] - e[1] * w[0];
+        // s = - e x w / |e|
+        gc_ << e[1] / L, - e[0] / L, 0;
+        gb_ << - w[1] / L, w[0] / L, 0;
+        gb_ += cr / (L * L * L) * e;
+        ga_ = - gc_ - gb_;
+        return sInside;
+      }
+      ia_ = hull_[kOutside]; ib_ = hull_[(kOutside + 1) % m];
+      if (dOutside > 0) gc_ = rOutside / dOutside;
+      ga_ = - (1 - tOutside) * gc_;
+      gb_ = - tOutside * gc_;
+      return dOutside;
+    }
+
+    void SupportPolygonStability::addPointJacobian (std::size_t i,
+        const vector3_t& g, matrixOut_t jacobian) const
+    {
+      const JointPtr_t& joint = points_[i].joint;
+      if (!joint) return;
+      const Transform3f& M = joint->currentTransformation ();
+      const JointJacobian_t& J = joint->jacobian ();
+      // The velocity of the point is R (Jv + Jw x local).
+      const vector3_t Rtg (M.rotation ().transpose () * g);
+      const vector3_t b (points_[i].local.cross (Rtg));
+      jacobian.row (0).noalias () += Rtg.transpose () * J.topRows <3> ();
+      jacobian.row (0).noalias () += b.transpose () * J.bottomRows <3> ();
+    }
+
+    void SupportPolygonStability::impl_compute (vectorOut_t result,
+        ConfigurationIn_t argument) const throw ()
+    {
+      supportPolygon_ = computeSupport (argument, false);
+      if (supportPolygon_) result[0] = computeDistance ();
+      else (*fallback_) (result, argument);
+    }
+
+    void SupportPolygonStability::impl_jacobian (matrixOut_t jacobian,
+        ConfigurationIn_t argument) const throw ()
+    {
+      Eigen::Matrix <value_type, 1, 1> value;
+      impl_valueAndJacobian (value, jacobian, argument);
+    }
+
+    void SupportPolygonStability::impl_valueAndJacobian (vectorOut_t result,
+        matrixOut_t jacobian, ConfigurationIn_t argument) const throw ()
+    {
+      supportPolygon_ = computeSupport (argument, true);
+      if (!supportPolygon_) {
+        fallback_->valueAndJacobian (result, jacobian, argument);
+        return;
+      }
+      result[0] = computeDistance ();
+      jacobian.row (0).noalias () = gc_.transpose () * com_->jacobian ();
+      addPointJacobian (ia_, ga_, jacobian);
+      if (ib_ != ia_) addPointJacobian (ib_, gb_, jacobian);
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,159 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/trace.hh>
+
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace hpp {
+  namespace constraints {
+    namespace trace {
+      namespace {
+        struct Event
+        {
+          char name [64];
+          const char* category;
+          long begin, end;
+        };
+
+        /// Ring buffer of a thread. Only this thread writes in it.
+        struct Buffer
+        {
+          Buffer (std::size_t id, std::size_t capacity) :
+            id (id), events (capacity), count (0) {}
+          std::size_t id;
+          std::vector <Event> events;
+          /// Number of spans recorded since the start.
+          std::size_t count;
+        };
+
+        bool recording = false;
+        std::size_t bufferCapacity = 0;
+        /// Incremented at each start, so that threads reset their buffer.
+        std::size_t generation = 0;
+        std::vector <Buffer*> buffers;
+
+        Buffer* threadBuffer = NULL;
+        std::size_t threadGeneration = 0;
+#pragma omp threadprivate(threadBuffer, threadGeneration)
+
+        /// Microseconds since the epoch.
+        inline long now ()
+        {
+          static const boost::posix_time::ptime epoch
+            (boost::gregorian::date (1970, 1, 1));
+          return (long) (boost::posix_time::microsec_clock::universal_time ()
+              - epoch).total_microseconds ();
+        }
+
+        Buffer& buffer ()
+        {
+          if (!threadBuffer) {
+            // Only done once per thread.
+#pragma omp critical (hpp_constraints_trace)
+            {
+              threadBuffer = new Buffer (buffers.size (), bufferCapacity);
+              buffers.push_back (threadBuffer);
+            }
+            threadGeneration = generation;
+          } else if (threadGeneration != generation) {
+            threadBuffer->events.resize (bufferCapacity);
+            threadBuffer->count = 0;
+            threadGeneration = generation;
+          }
+          return *threadBuffer;
+        }
+
+        void writeString (std::ostream& os, const char* s)
+        {
+          os << '"';
+          for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') os << '\\';
+            os << *s;
+          }
+          os << '"';
+        }
+      } // namespace
+
+      void start (std::size_t capacity)
+      {
+        bufferCapacity = capacity;
+        ++generation;
+        // Buffers of threads that do not record anymore.
+        for (std::size_t i = 0; i < buffers.size (); ++i)
+          buffers [i]->count = 0;
+        recording = true;
+      }
+
+      void stop ()
+      {
+        recording = false;
+      }
+
+      bool started ()
+      {
+        return recording;
+      }
+
+      void write (std::ostream& os)
+      {
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (std::size_t i = 0; i < buffers.size (); ++i) {
+          const Buffer& b = *buffers [i];
+          const std::size_t n = b.events.size ();
+          if (n == 0) continue;
+          const std::size_t begin = (b.count > n ? b.count - n : 0);
+          for (std::size_t k = begin; k < b.count; ++k) {
+            const Event& e = b.events [k % n];
+            if (!first) os << ',';
+            first = false;
+            os << "\n{\"name\":";
+            writeString (os, e.name);
+            os << ",\"cat\":";
+            writeString (os, e.category);
+            os << ",\"ph\":\"X\",\"ts\":" << e.begin
+              << ",\"dur\":" << e.end - e.begin
+              << ",\"pid\":0,\"tid\":" << b.id << '}';
+          }
+        }
+        os << "\n]}" << std::endl;
+      }
+
+      Span::Span (const char* name, const char* category) :
+        name_ (name), category_ (category), begin_ (recording ? now () : -1)
+      {}
+
+      Span::~Span ()
+      {
+        if (begin_ < 0 || !recording) return;
+        Buffer& b = buffer ();
+        if (b.events.empty ()) return;
+        Event& e = b.events [b.count % b.events.size ()];
+        std::strncpy (e.name, name_, sizeof (e.name) - 1);
+        e.name [sizeof (e.name) - 1] = '\0';
+        e.category = category_;
+        e.begin = begin_;
+        e.end = now ();
+        ++b.count;
+      }
+    } // namespace trace
+  } // namespace constraints
+} // namespace hpp
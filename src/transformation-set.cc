@@ -0,0 +1,269 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/transformation-set.hh>
+
+#include <limits>
+#include <stdexcept>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/memory-usage.hh>
+#include <hpp/constraints/packed-kinematics.hh>
+
+namespace hpp {
+  namespace constraints {
+    namespace {
+      /// Column k of the rotation stored in column c of R.
+      inline vector3_t column (const matrices3_t& R, size_type c, int k)
+      {
+        return vector3_t (R (3*k, c), R (3*k+1, c), R (3*k+2, c));
+      }
+
+      inline void set (matrices3_t& R, size_type c, const matrix3_t& M)
+      {
+        for (int j = 0; j < 3; ++j)
+          for (int i = 0; i < 3; ++i)
+            R (3*j+i, c) = M (i, j);
+      }
+    } // namespace
+
+    TransformationSetPtr_t TransformationSet::create
+    (const std::string& name, const DevicePtr_t& robot,
+     const Targets_t& targets)
+    {
+      TransformationSet* ptr = new TransformationSet (name, robot, targets);
+      TransformationSetPtr_t shPtr (ptr);
+      return shPtr;
+    }
+
+    namespace {
+      size_type nbRows (const TransformationSet::Targets_t& targets)
+      {
+        size_type res = 0;
+        for (std::size_t i = 0; i < targets.size (); ++i) {
+          if (targets [i].mask.size () != 6)
+            throw std::invalid_argument
+              ("TransformationSet: the masks must have 6 elements");
+          if (!targets [i].joint)
+            throw std::invalid_argument
+              ("TransformationSet: the joints may not be NULL");
+          for (std::size_t k = 0; k < 6; ++k)
+            if (targets [i].mask [k]) ++res;
+        }
+        return res;
+      }
+    } // namespace
+
+    TransformationSet::TransformationSet
+    (const std::string& name, const DevicePtr_t& robot,
+     const Targets_t& targets) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (),
+                              nbRows (targets), name), robot_ (robot),
+      kinematics_ (KinematicsCache::get (robot)), targets_ (targets),
+      column_ (targets.size ()), rows_ (6, targets.size ()),
+      frameRotation_ (9, targets.size ()),
+      referenceRotation_ (9, targets.size ()),
+      frameTranslation_ (3, targets.size ()),
+      referenceTranslation_ (3, targets.size ()), hasOrientation_ (false),
+      arm_ (3, targets.size ()), rotation_ (9, targets.size ()),
+      difference_ (3, targets.size ()), position_ (3, targets.size ()),
+      log_ (3, targets.size ()), errorRotation_ (9, targets.size ()),
+      Jlog_ (9, targets.size ()), theta_ (targets.size ()),
+      errorVersion_ (std::numeric_limits <std::size_t>::max ()),
+      jacobianVersion_ (std::numeric_limits <std::size_t>::max ())
+    {
+      // Group the targets by joint.
+      std::vector <std::size_t> group (targets_.size ());
+      for (std::size_t i = 0; i < targets_.size (); ++i) {
+        std::size_t j = 0;
+        while (j < joints_.size () &&
+            joints_ [j]->index () != targets_ [i].joint->index ()) ++j;
+        if (j == joints_.size ()) {
+          joints_.push_back (targets_ [i].joint);
+          KinematicsCache::addJoint (jointSet_, targets_ [i].joint);
+        }
+        group [i] = j;
+      }
+      groupBegin_.assign (joints_.size () + 1, 0);
+      for (std::size_t i = 0; i < targets_.size (); ++i)
+        ++groupBegin_ [group [i] + 1];
+      for (std::size_t j = 0; j < joints_.size (); ++j)
+        groupBegin_ [j + 1] += groupBegin_ [j];
+      std::vector <size_type> next (groupBegin_.begin (),
+          groupBegin_.end () - 1);
+      for (std::size_t i = 0; i < targets_.size (); ++i)
+        column_ [i] = next [group [i]]++;
+
+      size_type row = 0;
+      for (std::size_t i = 0; i < targets_.size (); ++i) {
+        const size_type c = column_ [i];
+        for (int k = 0; k < 6; ++k)
+          rows_ (k, c) = (targets_ [i].mask [k] ? row++ : -1);
+        for (int k = 3; k < 6; ++k)
+          hasOrientation_ = hasOrientation_ || targets_ [i].mask [k];
+        set (frameRotation_, c, targets_ [i].frame.rotation ());
+        frameTranslation_.col (c) = targets_ [i].frame.translation ();
+        set (referenceRotation_, c, targets_ [i].reference.rotation ());
+        referenceTranslation_.col (c) = targets_ [i].reference.translation ();
+      }
+
+      activeDerivativeColumns_.setConstant (false);
+      for (std::size_t j = 0; j < joints_.size (); ++j)
+        activateJointColumns (joints_ [j]);
+      size_type begin = 0, end = robot->numberDof ();
+      while (begin < end && !activeDerivativeColumns_[begin]) ++begin;
+      while (end > begin && !activeDerivativeColumns_[end - 1]) --end;
+      colBegin_ = begin;
+      activeCols_ = end - begin;
+      RJ_.resize (6 * joints_.size (), activeCols_);
+    }
+
+    void TransformationSet::reference (std::size_t i,
+        const Transform3f& reference)
+    {
+      assert (i < targets_.size ());
+      targets_ [i].reference = reference;
+      set (referenceRotation_, column_ [i], reference.rotation ());
+      referenceTranslation_.col (column_ [i]) = reference.translation ();
+      errorVersion_ = std::numeric_limits <std::size_t>::max ();
+    }
+
+    void TransformationSet::computeErrors () const
+    {
+      if (errorVersion_ == kinematics_->version ()) return;
+      for (std::size_t j = 0; j < joints_.size (); ++j) {
+        const size_type b = groupBegin_ [j], n = groupBegin_ [j+1] - b;
+        const Transform3f& M (joints_ [j]->currentTransformation ());
+        const matrix3_t& R (M.rotation ());
+        // Origin of the frames: R t_F + t
+        arm_.middleCols (b, n).noalias () =
+          R * frameTranslation_.middleCols (b, n);
+        difference_.middleCols (b, n) = arm_.middleCols (b, n);
+        difference_.middleCols (b, n).colwise () += M.translation ();
+        if (!hasOrientation_) continue;
+        // Rotation of the frames: R R_F
+        for (int c = 0; c < 3; ++c)
+          for (int r = 0; r < 3; ++r)
+            rotation_.row (3*c+r).segment (b, n) =
+                R (r, 0) * frameRotation_.row (3*c    ).segment (b, n)
+              + R (r, 1) * frameRotation_.row (3*c + 1).segment (b, n)
+              + R (r, 2) * frameRotation_.row (3*c + 2).segment (b, n);
+      }
+      difference_ -= referenceTranslation_;
+      packed::apply (referenceRotation_, difference_, position_, true);
+      if (hasOrientation_) {
+        packed::multiply (referenceRotation_, rotation_, errorRotation_, true);
+        computeLogs (errorRotation_, theta_, log_);
+      }
+      errorVersion_ = kinematics_->version ();
+    }
+
+    void TransformationSet::computeJointJacobians () const
+    {
+      if (jacobianVersion_ == kinematics_->version ()) return;
+      for (std::size_t j = 0; j < joints_.size (); ++j) {
+        const JointJacobian_t& J (joints_ [j]->jacobian ());
+        const matrix3_t& R (joints_ [j]->currentTransformation ().rotation ());
+        RJ_.middleRows <3> (6*j    ).noalias () = R *
+          J.topRows <3> ().middleCols (colBegin_, activeCols_);
+        RJ_.middleRows <3> (6*j + 3).noalias () = R *
+          J.bottomRows <3> ().middleCols (colBegin_, activeCols_);
+      }
+      if (hasOrientation_) computeJlogs (theta_, log_, Jlog_);
+      jacobianVersion_ = kinematics_->version ();
+    }
+
+    void TransformationSet::copyValue (vectorOut_t result) const
+    {
+      for (size_type c = 0; c < rows_.cols (); ++c)
+        for (int k = 0; k < 3; ++k) {
+          if (rows_ (k, c) >= 0) result [rows_ (k, c)] = position_ (k, c);
+          if (rows_ (k+3, c) >= 0) result [rows_ (k+3, c)] = log_ (k, c);
+        }
+    }
+
+    void TransformationSet::impl_compute
+    (vectorOut_t result, ConfigurationIn_t argument) const throw ()
+    {
+      kinematics_->update (argument, KinematicsCache::PLACEMENTS, jointSet_);
+      computeErrors ();
+      copyValue (result);
+    }
+
+    void TransformationSet::impl_jacobian
+    (matrixOut_t jacobian, ConfigurationIn_t arg) const throw ()
+    {
+      kinematics_->update (arg, KinematicsCache::JACOBIANS, jointSet_);
+      computeErrors ();
+      computeJointJacobians ();
+      for (std::size_t j = 0; j < joints_.size (); ++j) {
+        const Eigen::Block <matrix_t, 3, Eigen::Dynamic> Jv
+          (RJ_.middleRows <3> (6*j)), Jw (RJ_.middleRows <3> (6*j + 3));
+        for (size_type c = groupBegin_ [j]; c < groupBegin_ [j+1]; ++c) {
+          const vector3_t a (arm_.col (c));
+          for (int k = 0; k < 3; ++k) {
+            // Row k of RrefT ( R Jv - [R t_F]x R Jw )
+            const size_type row = rows_ (k, c);
+            if (row < 0) continue;
+            const vector3_t r (column (referenceRotation_, c, k));
+            jacobian.row (row).segment (colBegin_, activeCols_).noalias () =
+              r.transpose () * Jv + a.cross (r).transpose () * Jw;
+          }
+          for (int k = 0; k < 3; ++k) {
+            // Row k of Jlog RrefT R Jw
+            const size_type row = rows_ (k+3, c);
+            if (row < 0) continue;
+            const vector3_t l (Jlog_ (k, c) * column (referenceRotation_, c, 0)
+                + Jlog_ (k+3, c) * column (referenceRotation_, c, 1)
+                + Jlog_ (k+6, c) * column (referenceRotation_, c, 2));
+            jacobian.row (row).segment (colBegin_, activeCols_).noalias () =
+              l.transpose () * Jw;
+          }
+        }
+      }
+      jacobian.leftCols (colBegin_).setZero ();
+      jacobian.rightCols (jacobian.cols () - colBegin_ - activeCols_)
+        .setZero ();
+    }
+
+    void TransformationSet::impl_valueAndJacobian
+    (vectorOut_t result, matrixOut_t jacobian, ConfigurationIn_t arg) const
+    {
+      impl_jacobian (jacobian, arg);
+      copyValue (result);
+    }
+
+    MemoryUsage TransformationSet::memoryUsage () const
+    {
+      MemoryUsage m (DifferentiableFunction::memoryUsage ());
+      m.definition += sizeof (TransformationSet)
+        - sizeof (DifferentiableFunction) + memorySize (targets_)
+        + memorySize (jointSet_) + memorySize (joints_)
+        + memorySize (groupBegin_) + memorySize (column_)
+        + memorySize (rows_) + memorySize (frameRotation_)
+        + memorySize (referenceRotation_) + memorySize (frameTranslation_)
+        + memorySize (referenceTranslation_);
+      m.scratch += memorySize (RJ_) + memorySize (arm_)
+        + memorySize (rotation_) + memorySize (difference_)
+        + memorySize (position_) + memorySize (log_)
+        + memorySize (errorRotation_) + memorySize (Jlog_)
+        + memorySize (theta_);
+      return m;
+    }
+  } // namespace constraints
+} // namespace hpp
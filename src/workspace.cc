@@ -0,0 +1,47 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/constraints/workspace.hh>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/constraints/kinematics-cache.hh>
+
+namespace hpp {
+  namespace constraints {
+    WorkspacePtr_t Workspace::create (const DevicePtr_t& robot)
+    {
+      return WorkspacePtr_t (new Workspace (robot));
+    }
+
+    Workspace::Workspace (const DevicePtr_t& robot) :
+      reference_ (robot), robot_ (robot->clone ()),
+      kinematics_ (KinematicsCache::get (robot_)),
+      joints_ (robot->model ().joints.size ())
+    {}
+
+    JointPtr_t Workspace::joint (const JointConstPtr_t& joint) const
+    {
+      if (!joint) return JointPtr_t ();
+      assert (joint->robot () == reference_);
+      const std::size_t i = joint->index ();
+      assert (i < joints_.size ());
+      if (!joints_[i]) joints_[i] = JointPtr_t (new pinocchio::Joint (robot_, i));
+      return joints_[i];
+    }
+  } // namespace constraints
+} // namespace hpp
@@ -0,0 +1,68 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#define BOOST_TEST_MODULE AutoDiffFunction
+#include <boost/test/unit_test.hpp>
+
+#include <hpp/constraints/auto-diff-function.hh>
+
+using hpp::constraints::AutoDiffFunction;
+using hpp::constraints::matrix_t;
+using hpp::constraints::vector_t;
+using hpp::constraints::value_type;
+
+/// f (x) = (x0 x1, sin (x2) + x0^2, 1)
+class Polynomial : public AutoDiffFunction <Polynomial>
+{
+  public:
+    Polynomial () : AutoDiffFunction <Polynomial> (3, 3, 3, "Polynomial") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      using std::sin;
+      result [0] = x [0] * x [1];
+      result [1] = sin (x [2]) + x [0] * x [0];
+      result [2] = Scalar (1);
+    }
+};
+
+BOOST_AUTO_TEST_CASE (jacobian)
+{
+  Polynomial f;
+  for (std::size_t k = 0; k < 10; ++k) {
+    const vector_t x (vector_t::Random (3));
+    vector_t value (3), expected (3);
+    f (value, x);
+    expected << x[0] * x[1], std::sin (x[2]) + x[0] * x[0], 1;
+    BOOST_CHECK (value.isApprox (expected));
+
+    matrix_t J (3, 3), expectedJ (3, 3);
+    f.jacobian (J, x);
+    expectedJ << x[1], x[0], 0,
+                 2 * x[0], 0, std::cos (x[2]),
+                 0, 0, 0;
+    BOOST_CHECK (J.isApprox (expectedJ));
+
+    vector_t value2 (3);
+    matrix_t J2 (3, 3);
+    f.valueAndJacobian (value2, J2, x);
+    BOOST_CHECK (value2.isApprox (value));
+    BOOST_CHECK (J2.isApprox (J));
+  }
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE BroydenJacobian
+#include <boost/test/unit_test.hpp>
+
+#include <hpp/constraints/broyden-jacobian.hh>
+#include <hpp/constraints/auto-diff-function.hh>
+
+using hpp::constraints::AutoDiffFunction;
+using hpp::constraints::BroydenJacobian;
+using hpp::constraints::BroydenJacobianPtr_t;
+using hpp::constraints::matrix_t;
+using hpp::constraints::vector_t;
+
+/// f (x) = (x0 x1, x2^2 + x0)
+class Quadratic : public AutoDiffFunction <Quadratic>
+{
+  public:
+    Quadratic () : AutoDiffFunction <Quadratic> (3, 3, 2, "Quadratic") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = x [0] * x [1];
+      result [1] = x [2] * x [2] + x [0];
+    }
+};
+
+BOOST_AUTO_TEST_CASE (secant)
+{
+  boost::shared_ptr <Quadratic> f (new Quadratic);
+  BroydenJacobianPtr_t b (BroydenJacobian::create (f));
+  b->maxUpdates (3);
+  b->refreshRatio (1e10);
+
+  vector_t x (vector_t::Random (3)), value (2), previous (2), exact (2);
+  matrix_t J (2, 3), expected (2, 3);
+  b->valueAndJacobian (value, J, x);
+  f->jacobian (expected, x);
+  BOOST_CHECK (J.isApprox (expected));
+  BOOST_CHECK_EQUAL (b->nbExactJacobians (), 1);
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    const vector_t step (1e-1 * vector_t::Random (3));
+    previous = value;
+    x += step;
+    b->valueAndJacobian (value, J, x);
+    (*f) (exact, x);
+    BOOST_CHECK (value.isApprox (exact));
+    // The update satisfies the secant equation.
+    BOOST_CHECK ((J * step).isApprox (value - previous));
+  }
+  BOOST_CHECK_EQUAL (b->nbExactJacobians (), 1);
+  BOOST_CHECK_EQUAL (b->nbUpdates (), 3);
+
+  // The maximal number of updates is reached.
+  x += 1e-1 * vector_t::Random (3);
+  b->jacobian (J, x);
+  f->jacobian (expected, x);
+  BOOST_CHECK (J.isApprox (expected));
+  BOOST_CHECK_EQUAL (b->nbExactJacobians (), 2);
+
+  // The norm of the value does not decrease.
+  b->refreshRatio (0);
+  x += 1e-1 * vector_t::Random (3);
+  b->jacobian (J, x);
+  f->jacobian (expected, x);
+  BOOST_CHECK (J.isApprox (expected));
+  BOOST_CHECK_EQUAL (b->nbExactJacobians (), 3);
+}
@@ -17,9 +17,14 @@
 #define BOOST_TEST_MODULE ConvexShape
 #include <boost/test/included/unit_test.hpp>
 
+#include <limits>
+
 #include "hpp/constraints/convex-shape.hh"
+#include "hpp/constraints/convex-shape-tree.hh"
 
 using hpp::constraints::ConvexShape;
+using hpp::constraints::ConvexShapeTree;
+using hpp::constraints::size_type;
 using hpp::constraints::value_type;
 using hpp::constraints::vector3_t;
 
@@ -89,3 +94,93 @@ BOOST_AUTO_TEST_CASE (distance)
   checkDistance(t, vector3_t(1, 1, 0), -1);
   checkDistance(t, vector3_t(0, 1, 0),  0);
 }
+
+BOOST_AUTO_TEST_CASE (tree)
+{
+  // Squares of a staircase, tilted around the x axis.
+  ConvexShapeTree::ConvexShapes_t shapes;
+  for (int i = 0; i < 20; ++i) {
+    for (int j = 0; j < 20; ++j) {
+      const value_type z = 0.1 * i, t = 0.05 * (j % 3);
+      std::vector <vector3_t> pts;
+      pts.push_back (vector3_t (i    , j    , z));
+      pts.push_back (vector3_t (i + 1, j    , z));
+      pts.push_back (vector3_t (i + 1, j + 1, z + t));
+      pts.push_back (vector3_t (i    , j + 1, z + t));
+      shapes.push_back (ConvexShape (pts));
+    }
+  }
+  ConvexShapeTree tree;
+  tree.build (shapes);
+
+  for (int k = 0; k < 1000; ++k) {
+    const vector3_t p = 12 * (vector3_t::Random () + vector3_t (1, 1, 0));
+    value_type expected = std::numeric_limits <value_type>::infinity ();
+    size_type iExpected = -1;
+    bool inside, insideExpected = false;
+    for (std::size_t i = 0; i < shapes.size (); ++i) {
+      const value_type d = ConvexShapeTree::squaredDistance (shapes [i], p,
+          inside);
+      if (d < expected) {
+        expected = d;
+        iExpected = i;
+        insideExpected = inside;
+      }
+    }
+    value_type minDist = std::numeric_limits <value_type>::infinity ();
+    const size_type i = tree.closest (p, minDist, inside);
+    BOOST_CHECK_EQUAL (i, iExpected);
+    BOOST_CHECK_EQUAL (minDist, expected);
+    BOOST_CHECK_EQUAL (inside, insideExpected);
+
+    // A bound smaller than the distance discards all the shapes.
+    minDist = expected / 2;
+    if (expected > 0) BOOST_CHECK_EQUAL (tree.closest (p, minDist, inside), -1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (singlePrecision)
+{
+  std::vector <vector3_t> pts;
+  pts.push_back (vector3_t (0, 0, 0));
+  pts.push_back (vector3_t (2, 0, 0));
+  pts.push_back (vector3_t (2, 2, 0));
+  pts.push_back (vector3_t (0, 2, 0));
+  ConvexShape t (pts);
+
+  for (int k = 0; k < 100; ++k) {
+    const vector3_t p = 3 * vector3_t::Random () + vector3_t (1, 1, 0);
+    const vector3_t a = t.intersection (p, t.normal ());
+    const value_type d = t.distance (a);
+    // Single precision far from the shape, double precision close to it.
+    BOOST_CHECK_SMALL (t.distance (a, 0) - d, 1e-5);
+    BOOST_CHECK_EQUAL (t.distance (a, std::abs (d) + 1), d);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (sharedGeometry)
+{
+  std::vector <vector3_t> pts;
+  pts.push_back (vector3_t (0, 0, 0));
+  pts.push_back (vector3_t (1, 0, 0));
+  pts.push_back (vector3_t (1, 1, 0));
+  pts.push_back (vector3_t (0, 1, 0));
+  ConvexShape t (pts), u (pts), copy (t);
+  BOOST_CHECK_EQUAL (t.geometryPtr (), u.geometryPtr ());
+  BOOST_CHECK_EQUAL (t.geometryPtr (), copy.geometryPtr ());
+
+  // Reversing gives the same geometry as the reversed points.
+  std::vector <vector3_t> rpts (pts.rbegin (), pts.rend ());
+  ConvexShape r (rpts);
+  u.reverse ();
+  BOOST_CHECK_EQUAL (u.geometryPtr (), r.geometryPtr ());
+  BOOST_CHECK (u.normal ().isApprox (- t.normal ()));
+
+  // Swap exchanges the instances.
+  const vector3_t p (0.5, 0.25, 0);
+  const value_type dt = t.distance (p), du = u.distance (p);
+  t.swap (u);
+  BOOST_CHECK_EQUAL (t.distance (p), du);
+  BOOST_CHECK_EQUAL (u.distance (p), dt);
+  BOOST_CHECK_EQUAL (u.geometryPtr (), copy.geometryPtr ());
+}
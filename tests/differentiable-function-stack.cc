@@ -0,0 +1,243 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/differentiable-function-stack.hh"
+#include "hpp/constraints/generic-transformation.hh"
+
+#define BOOST_TEST_MODULE DifferentiableFunctionStack
+#include <boost/test/unit_test.hpp>
+
+#include "humanoid-fixture.hh"
+
+BOOST_FIXTURE_TEST_CASE (sparseJacobian, Humanoid) {
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("stack");
+  stack->add (Position::create       ("Position1"   , device, ee1, tf1, tf2));
+  stack->add (Orientation::create    ("Orientation2", device, ee2, tf2));
+  stack->add (RelativePosition::create ("RelativePosition", device, ee1, ee2, tf1, tf2));
+
+  DifferentiableFunctionStack::SparseMatrix_t sparse;
+  matrix_t J (stack->outputDerivativeSize (), stack->inputDerivativeSize ());
+  for (int i = 0; i < 3; ++i) {
+    Configuration_t q = *cs.shoot ();
+    stack->jacobian (sparse, q);
+    stack->jacobian (J, q);
+    BOOST_CHECK (sparse.nonZeros () < J.size ());
+    BOOST_CHECK (matrix_t (sparse).isApprox (J));
+  }
+
+  // Replace a function by one with as many rows and active columns, but
+  // other columns: the structure must be rebuilt.
+  stack->erase (stack->handle (0));
+  stack->add (Position::create ("Position2", device, ee2, tf2, tf1));
+  Configuration_t q = *cs.shoot ();
+  stack->jacobian (sparse, q);
+  stack->jacobian (J, q);
+  BOOST_CHECK (matrix_t (sparse).isApprox (J));
+}
+
+BOOST_FIXTURE_TEST_CASE (parallelStack, Humanoid) {
+  DifferentiableFunctionStackPtr_t
+    sequential = DifferentiableFunctionStack::create ("sequential"),
+    parallel   = DifferentiableFunctionStack::create ("parallel");
+  for (int i = 0; i < 2; ++i) {
+    DifferentiableFunctionStackPtr_t stack = (i == 0 ? sequential : parallel);
+    stack->add (Position::create       ("Position1"   , device, ee1, tf1, tf2));
+    stack->add (Orientation::create    ("Orientation2", device, ee2, tf2));
+    stack->add (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+  }
+  parallel->parallel (device, 2, 0);
+
+  vector_t v1 (sequential->outputSize ()), v2 (parallel->outputSize ());
+  matrix_t J1 (sequential->outputDerivativeSize (), sequential->inputDerivativeSize ()),
+           J2 (parallel->outputDerivativeSize (), parallel->inputDerivativeSize ());
+  for (int i = 0; i < 5; ++i) {
+    Configuration_t q = *cs.shoot ();
+    (*sequential) (v1, q); sequential->jacobian (J1, q);
+    (*parallel)   (v2, q); parallel->jacobian   (J2, q);
+    BOOST_CHECK (v1.isApprox (v2));
+    BOOST_CHECK (J1.isApprox (J2));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (compiledStack, Humanoid) {
+  // Functions of the same type are interleaved with the others, and one of
+  // them is in a nested stack.
+  DifferentiableFunctionStackPtr_t
+    sequential = DifferentiableFunctionStack::create ("sequential"),
+    compiled   = DifferentiableFunctionStack::create ("compiled");
+  DifferentiableFunctionStack::Handle_t inactive = 0;
+  for (int i = 0; i < 2; ++i) {
+    DifferentiableFunctionStackPtr_t stack = (i == 0 ? sequential : compiled);
+    DifferentiableFunctionStackPtr_t nested =
+      DifferentiableFunctionStack::create ("nested");
+    nested->add (Orientation::create ("Orientation1", device, ee1, tf1));
+    nested->add (Position::create    ("Position2"   , device, ee2, tf2, tf1));
+    stack->add (Position::create       ("Position1"   , device, ee1, tf1, tf2));
+    stack->add (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+    stack->add (nested);
+    inactive = stack->add (Orientation::create ("Orientation2", device, ee2, tf2));
+    stack->add (Position::create       ("Position3"   , device, ee2, tf1, tf2));
+    stack->active (inactive, false);
+  }
+  compiled->compile (true);
+
+  vector_t v1 (sequential->outputSize ()), v2 (compiled->outputSize ());
+  matrix_t J1 (sequential->outputDerivativeSize (), sequential->inputDerivativeSize ()),
+           J2 (compiled->outputDerivativeSize (), compiled->inputDerivativeSize ()),
+           J3 (J2);
+  vector_t v3 (v2);
+  for (int i = 0; i < 5; ++i) {
+    Configuration_t q = *cs.shoot ();
+    (*sequential) (v1, q); sequential->jacobian (J1, q);
+    (*compiled)   (v2, q); compiled->jacobian   (J2, q);
+    compiled->valueAndJacobian (v3, J3, q);
+    BOOST_CHECK (v1.isApprox (v2));
+    BOOST_CHECK (J1.isApprox (J2));
+    BOOST_CHECK (v1.isApprox (v3));
+    BOOST_CHECK (J1.isApprox (J3));
+  }
+  BOOST_CHECK (v2.segment (compiled->row (compiled->index (inactive)), 3).isZero ());
+
+  // Activating a function updates the buckets.
+  sequential->active (inactive, true);
+  compiled->active (inactive, true);
+  Configuration_t q = *cs.shoot ();
+  (*sequential) (v1, q); (*compiled) (v2, q);
+  BOOST_CHECK (v1.isApprox (v2));
+}
+
+BOOST_FIXTURE_TEST_CASE (stackHandles, Humanoid) {
+  DifferentiableFunctionPtr_t
+    p1 = Position::create    ("Position1"   , device, ee1, tf1, tf2),
+    o2 = Orientation::create ("Orientation2", device, ee2, tf2),
+    t  = RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2);
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("stack");
+  DifferentiableFunctionStack::Handle_t hp1 = stack->add (p1),
+    ho2 = stack->add (o2), ht = stack->add (t);
+  BOOST_CHECK_EQUAL (stack->derivativeRow (stack->index (ht)), 6);
+
+  Configuration_t q = *cs.shoot ();
+  vector_t value (stack->outputSize ()), tValue (t->outputSize ());
+  matrix_t J (stack->outputDerivativeSize (), stack->inputDerivativeSize ());
+
+  // An inactive function keeps its rows, set to zero.
+  stack->active (ho2, false);
+  BOOST_CHECK (!stack->active (ho2));
+  (*stack) (value, q);
+  stack->jacobian (J, q);
+  BOOST_CHECK (value.segment (3, 3).isZero ());
+  BOOST_CHECK (J.middleRows (3, 3).isZero ());
+  (*t) (tValue, q);
+  BOOST_CHECK (value.tail (6).isApprox (tValue));
+  stack->active (ho2, true);
+
+  // Handles remain valid after erasing another function.
+  stack->erase (hp1);
+  BOOST_CHECK_EQUAL (stack->functions ().size (), 2);
+  BOOST_CHECK_EQUAL (stack->index (ho2), 0);
+  BOOST_CHECK_EQUAL (stack->index (ht), 1);
+  BOOST_CHECK_EQUAL (stack->row (stack->index (ht)), 3);
+  BOOST_CHECK_EQUAL (stack->outputSize (), 9);
+  BOOST_CHECK (stack->functions ()[stack->index (ht)] == t);
+}
+
+BOOST_FIXTURE_TEST_CASE (cachedRows, Humanoid) {
+  PositionPtr_t left = Position::create ("Position1", device, ee1, tf1, tf2);
+  DifferentiableFunctionPtr_t right =
+    Orientation::create ("Orientation2", device, ee2, tf2);
+  DifferentiableFunctionStackPtr_t
+    cached = DifferentiableFunctionStack::create ("cached"),
+    fresh  = DifferentiableFunctionStack::create ("fresh");
+  const DifferentiableFunctionStack::Handle_t hl = cached->add (left);
+  cached->add (right);
+  fresh->add (left); fresh->add (right);
+  cached->cacheRows (device);
+
+  vector_t v (cached->outputSize ()), vRef (v), vOld (v);
+  matrix_t J (cached->outputDerivativeSize (), cached->inputDerivativeSize ()),
+           JRef (J);
+  // The first evaluations compute a single output.
+  Configuration_t q = *cs.shoot ();
+  cached->jacobian (J, q); fresh->jacobian (JRef, q);
+  BOOST_CHECK (J.isApprox (JRef));
+  (*cached) (v, q); (*fresh) (vRef, q);
+  BOOST_CHECK (v.isApprox (vRef));
+
+  // Only the right leg moves: the rows of the left foot are reused.
+  q [ee2->rankInConfiguration ()] += .1;
+  (*cached) (v, q); (*fresh) (vRef, q);
+  cached->jacobian (J, q); fresh->jacobian (JRef, q);
+  BOOST_CHECK (v.isApprox (vRef));
+  BOOST_CHECK (J.isApprox (JRef));
+
+  // The rows of a modified function are reused until they are invalidated.
+  vOld = v;
+  left->reference (Transform3f::Random ());
+  q [ee2->rankInConfiguration ()] += .1;
+  (*cached) (v, q); (*fresh) (vRef, q);
+  BOOST_CHECK (v.head (3).isApprox (vOld.head (3)));
+  BOOST_CHECK (!v.head (3).isApprox (vRef.head (3)));
+  BOOST_CHECK (v.tail (3).isApprox (vRef.tail (3)));
+  cached->invalidateRows ();
+  (*cached) (v, q);
+  BOOST_CHECK (v.isApprox (vRef));
+
+  // An inactive function has zero rows and is computed again once active.
+  cached->active (hl, false);
+  (*cached) (v, q);
+  BOOST_CHECK (v.head (3).isZero ());
+  BOOST_CHECK (v.tail (3).isApprox (vRef.tail (3)));
+  left->reference (Transform3f::Random ());
+  cached->active (hl, true);
+  (*cached) (v, q); (*fresh) (vRef, q);
+  BOOST_CHECK (v.isApprox (vRef));
+}
+
+BOOST_FIXTURE_TEST_CASE (blockJacobians, Humanoid) {
+  // The ankles relative to their parents: one block per leg.
+  const se3::Model& model = device->model ();
+  JointPtr_t
+    parent1 = device->getJointByName (model.names [model.parents [ee1->index ()]]),
+    parent2 = device->getJointByName (model.names [model.parents [ee2->index ()]]);
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("stack");
+  stack->add (RelativeTransformation::create ("left" , device, parent1, ee1, tf1, tf2));
+  stack->add (RelativeTransformation::create ("right", device, parent2, ee2, tf2, tf1));
+  const DifferentiableFunctionStack::Blocks_t& blocks = stack->blocks ();
+  BOOST_REQUIRE_EQUAL (blocks.size (), 2);
+
+  matrix_t J (stack->outputDerivativeSize (), stack->inputDerivativeSize ());
+  std::vector <matrix_t> jacobians;
+  for (int mode = 0; mode < 3; ++mode) {
+    if (mode == 1) stack->blockKinematics (device);
+    if (mode == 2) stack->parallel (device, 2, 0);
+    Configuration_t q = *cs.shoot ();
+    stack->blockJacobians (jacobians, q);
+    stack->jacobian (J, q);
+    BOOST_REQUIRE_EQUAL (jacobians.size (), blocks.size ());
+    for (std::size_t b = 0; b < blocks.size (); ++b) {
+      BOOST_CHECK (!blocks[b].joints.empty () == (mode > 0));
+      matrix_t expected (blocks[b].derivativeSize,
+          blocks[b].columns.dimension ());
+      blocks[b].columns.reduce (J.middleRows
+          (stack->derivativeRow (blocks[b].functions[0]),
+           blocks[b].derivativeSize), expected);
+      BOOST_CHECK (jacobians[b].isApprox (expected));
+    }
+  }
+}
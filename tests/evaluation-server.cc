@@ -0,0 +1,103 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/evaluation-server.hh"
+#include "hpp/constraints/batch-evaluator.hh"
+#include "hpp/constraints/generic-transformation.hh"
+
+#define BOOST_TEST_MODULE EvaluationServer
+#include <boost/test/unit_test.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "humanoid-fixture.hh"
+
+BOOST_FIXTURE_TEST_CASE (evaluationServer, Humanoid) {
+  EvaluationServer::Functions_t functions;
+  functions.push_back (RelativeTransformation::create ("f", device, ee1, ee2,
+        Transform3f::Random (), Transform3f::Random ()));
+  functions.push_back (Position::create ("g", device, ee2,
+        Transform3f::Random (), Transform3f::Random ()));
+  EvaluationServerPtr_t server = EvaluationServer::create
+    (BatchEvaluator::create (device, 2), functions);
+
+  int fds [2];
+  BOOST_REQUIRE (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  EvaluationClientPtr_t client = EvaluationClient::create (fds[0], fds[0]);
+
+  const size_type N = 4;
+  matrix_t qs (device->configSize (), N);
+  for (size_type c = 0; c < N; ++c) qs.col (c) = *cs.shoot ();
+
+  std::vector <matrix_t> values, jacobians;
+  client->send (qs, true);
+  BOOST_CHECK (server->process (fds[1], fds[1]));
+  client->receive (values, &jacobians);
+  BOOST_REQUIRE_EQUAL (values.size (), functions.size ());
+  BOOST_REQUIRE_EQUAL (jacobians.size (), functions.size ());
+  for (std::size_t i = 0; i < functions.size (); ++i) {
+    const DifferentiableFunction& f = *functions[i];
+    const size_type nv = f.inputDerivativeSize ();
+    vector_t v (f.outputSize ());
+    matrix_t J (f.outputDerivativeSize (), nv);
+    for (size_type c = 0; c < N; ++c) {
+      f.valueAndJacobian (v, J, qs.col (c));
+      BOOST_CHECK (values[i].col (c).isApprox (v));
+      BOOST_CHECK (jacobians[i].middleCols (c * nv, nv).isApprox (J));
+    }
+  }
+  BOOST_CHECK_EQUAL (server->nbConfigurations (), (std::size_t) N);
+
+  client->send (qs.leftCols (1), false);
+  BOOST_CHECK (server->process (fds[1], fds[1]));
+  client->receive (values);
+  BOOST_CHECK_EQUAL (values[0].cols (), 1);
+
+  close (fds[0]);
+  BOOST_CHECK (!server->process (fds[1], fds[1]));
+  close (fds[1]);
+
+  // An invalid request is reported to the client before anything is
+  // allocated, and the server stops processing this connection.
+  server = EvaluationServer::create (BatchEvaluator::create (device, 2),
+      functions, N);
+  BOOST_REQUIRE (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  client = EvaluationClient::create (fds[0], fds[0]);
+  client->send (qs.topRows (3), false);
+  BOOST_CHECK (!server->process (fds[1], fds[1]));
+  BOOST_CHECK_THROW (client->receive (values), std::runtime_error);
+  close (fds[0]); close (fds[1]);
+
+  BOOST_REQUIRE (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  client = EvaluationClient::create (fds[0], fds[0]);
+  matrix_t tooMany (device->configSize (), N + 1);
+  tooMany.leftCols (N) = qs; tooMany.col (N) = qs.col (0);
+  client->send (tooMany, false);
+  BOOST_CHECK (!server->process (fds[1], fds[1]));
+  BOOST_CHECK_THROW (client->receive (values), std::runtime_error);
+  close (fds[0]); close (fds[1]);
+
+  BOOST_REQUIRE (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  const char garbage [32] = "not a request";
+  BOOST_REQUIRE (write (fds[0], garbage, sizeof (garbage))
+      == (ssize_t) sizeof (garbage));
+  BOOST_CHECK (!server->process (fds[1], fds[1]));
+  client = EvaluationClient::create (fds[0], fds[0]);
+  BOOST_CHECK_THROW (client->receive (values), std::runtime_error);
+  close (fds[0]); close (fds[1]);
+  BOOST_CHECK_EQUAL (server->nbConfigurations (), (std::size_t) 0);
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/executor.hh"
+#include "hpp/constraints/generic-transformation.hh"
+
+#define BOOST_TEST_MODULE Executor
+#include <boost/test/unit_test.hpp>
+
+#include "humanoid-fixture.hh"
+
+BOOST_FIXTURE_TEST_CASE (evaluateAsync, Humanoid) {
+  std::vector<DifferentiableFunctionPtr_t> functions;
+  functions.push_back (Position::create               ("Position"              , device, ee2, tf2, tf1));
+  functions.push_back (Orientation::create            ("Orientation"           , device, ee2, tf2));
+  functions.push_back (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+  ExecutorPtr_t executor = Executor::create (device, 2);
+
+  // Values and jacobians computed directly, before the batch runs.
+  const std::size_t nbConfigs = 5;
+  std::vector<Configuration_t> qs;
+  std::vector<vector_t> values;
+  std::vector<matrix_t> jacobians;
+  for (std::size_t k = 0; k < nbConfigs; ++k) {
+    qs.push_back (*cs.shoot ());
+    for (std::size_t i = 0; i < functions.size (); ++i) {
+      const DifferentiableFunction& f = *functions[i];
+      values.push_back (vector_t (f.outputSize ()));
+      jacobians.push_back (matrix_t (f.outputDerivativeSize (),
+            f.inputDerivativeSize ()));
+      f.valueAndJacobian (values.back (), jacobians.back (), qs[k]);
+    }
+  }
+
+  std::vector<EvaluationFuture> futures;
+  for (std::size_t k = 0; k < nbConfigs; ++k)
+    for (std::size_t i = 0; i < functions.size (); ++i)
+      futures.push_back (functions[i]->evaluateAsync (qs[k], *executor,
+            i != 1));
+  BOOST_CHECK_EQUAL (executor->pending (), futures.size ());
+  executor->run ();
+  BOOST_CHECK_EQUAL (executor->pending (), 0);
+  for (std::size_t j = 0; j < futures.size (); ++j) {
+    BOOST_CHECK (futures[j].value ().isApprox (values[j]));
+    BOOST_CHECK (futures[j].ready ());
+    if (j % functions.size () == 1)
+      BOOST_CHECK_EQUAL (futures[j].jacobian ().size (), 0);
+    else
+      BOOST_CHECK (futures[j].jacobian ().isApprox (jacobians[j]));
+  }
+
+  // Waiting for an evaluation that was not started runs the pending ones.
+  EvaluationFuture f1 = functions[0]->evaluateAsync (qs[0], *executor),
+                   f2 = functions[2]->evaluateAsync (qs[1], *executor);
+  BOOST_CHECK (!f1.ready ());
+  f2.wait ();
+  BOOST_CHECK_EQUAL (executor->pending (), 0);
+  executor->wait ();
+  BOOST_CHECK (f1.ready () && f2.ready ());
+  BOOST_CHECK (f1.value ().isApprox (values[0]));
+  BOOST_CHECK (f2.jacobian ().isApprox (jacobians[functions.size () + 2]));
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/function-archive.hh"
+#include "hpp/constraints/configuration-constraint.hh"
+#include "hpp/constraints/convex-shape-contact.hh"
+#include "hpp/constraints/differentiable-function-stack.hh"
+#include "hpp/constraints/generic-transformation.hh"
+
+#define BOOST_TEST_MODULE FunctionArchive
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+#include "humanoid-fixture.hh"
+
+BOOST_FIXTURE_TEST_CASE (functionArchive, Humanoid) {
+  std::vector <bool> mask (6, true);
+  mask [2] = false;
+  RelativeTransformationPtr_t f = RelativeTransformation::create ("f",
+      device, ee1, ee2, Transform3f::Random (), Transform3f::Random (), mask);
+  f->useQuaternion (true);
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("stack");
+  stack->add (f);
+  stack->add (Orientation::create ("g", device, ee2, Transform3f::Random (),
+        Transform3f::Random ()));
+  stack->add (ConfigurationConstraint::create ("h", device, *cs.shoot (),
+        vector_t::Random (device->numberDof ()).cwiseAbs ()));
+
+  std::vector <vector3_t> square (4);
+  square [0] = vector3_t (-1, -1, 0); square [1] = vector3_t ( 1, -1, 0);
+  square [2] = vector3_t ( 1,  1, 0); square [3] = vector3_t (-1,  1, 0);
+  std::vector <vector3_t> foot (3);
+  foot [0] = vector3_t (0, 0, 0); foot [1] = vector3_t (.1, 0, 0);
+  foot [2] = vector3_t (0, .1, 0);
+  ConvexShapeContactPtr_t contact = ConvexShapeContact::create ("contact",
+      device);
+  contact->addObject (ConvexShape (foot, ee2));
+  contact->addFloor (ConvexShape (square));
+  contact->setNormalMargin (.01);
+
+  FunctionArchive::Functions_t functions;
+  functions.push_back (stack);
+  functions.push_back (f);
+  functions.push_back (contact);
+  const std::string filename ("function-archive-test.bin");
+  FunctionArchive::save (filename, functions);
+  const FunctionArchive::Functions_t loaded =
+    FunctionArchive::load (filename, device);
+  std::remove (filename.c_str ());
+
+  BOOST_REQUIRE_EQUAL (loaded.size (), functions.size ());
+  // f is shared by the stack and the list.
+  BOOST_CHECK (loaded [1] == boost::static_pointer_cast
+      <DifferentiableFunctionStack> (loaded [0])->functions () [0]);
+  for (std::size_t i = 0; i < functions.size (); ++i) {
+    const DifferentiableFunction &a = *functions [i], &b = *loaded [i];
+    BOOST_CHECK_EQUAL (a.name (), b.name ());
+    BOOST_REQUIRE_EQUAL (a.outputSize (), b.outputSize ());
+    vector_t va (a.outputSize ()), vb (b.outputSize ());
+    matrix_t Ja (a.outputDerivativeSize (), a.inputDerivativeSize ()),
+             Jb (b.outputDerivativeSize (), b.inputDerivativeSize ());
+    for (int k = 0; k < 5; ++k) {
+      Configuration_t q = *cs.shoot ();
+      a.valueAndJacobian (va, Ja, q);
+      b.valueAndJacobian (vb, Jb, q);
+      BOOST_CHECK (va.isApprox (vb));
+      BOOST_CHECK (Ja.isApprox (Jb));
+    }
+  }
+}
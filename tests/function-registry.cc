@@ -0,0 +1,71 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/function-registry.hh"
+#include "hpp/constraints/differentiable-function-stack.hh"
+#include "hpp/constraints/generic-transformation.hh"
+
+#define BOOST_TEST_MODULE FunctionRegistry
+#include <boost/test/unit_test.hpp>
+
+#include "humanoid-fixture.hh"
+
+BOOST_FIXTURE_TEST_CASE (functionRegistry, Humanoid) {
+  FunctionRegistryPtr_t registry = FunctionRegistry::create ();
+  std::vector<bool> mask (6, true); mask[5] = false;
+  RelativeTransformationPtr_t
+    f1 = registry->transformation <RelativeTransformation>
+      ("edge1", device, ee1, ee2, tf1, tf2),
+    f2 = registry->transformation <RelativeTransformation>
+      ("edge2", device, ee1, ee2, tf1, tf2),
+    f3 = registry->transformation <RelativeTransformation>
+      ("edge3", device, ee1, ee2, tf1, tf2, mask);
+  PositionPtr_t p = registry->transformation <Position>
+    ("position", device, JointPtr_t (), ee2, tf1, tf2);
+  BOOST_CHECK (f1 == f2);
+  BOOST_CHECK (f1 != f3);
+  BOOST_CHECK_EQUAL (registry->size (), 3);
+
+  // A function shared by two nested stacks is evaluated once.
+  DifferentiableFunctionStackPtr_t
+    sequential = DifferentiableFunctionStack::create ("sequential"),
+    flat       = DifferentiableFunctionStack::create ("flat");
+  for (int i = 0; i < 2; ++i) {
+    DifferentiableFunctionStackPtr_t stack = (i == 0 ? sequential : flat);
+    DifferentiableFunctionStackPtr_t
+      edge1 = DifferentiableFunctionStack::create ("edge1"),
+      edge2 = DifferentiableFunctionStack::create ("edge2");
+    edge1->add (f1); edge1->add (p);
+    edge2->add (f3); edge2->add (f2);
+    stack->add (edge1);
+    stack->add (edge2);
+  }
+  flat->flatten (true);
+  vector_t v1 (sequential->outputSize ()), v2 (flat->outputSize ());
+  matrix_t J1 (sequential->outputDerivativeSize (), sequential->inputDerivativeSize ()),
+           J2 (flat->outputDerivativeSize (), flat->inputDerivativeSize ());
+  for (int i = 0; i < 3; ++i) {
+    Configuration_t q = *cs.shoot ();
+    sequential->valueAndJacobian (v1, J1, q);
+    flat->valueAndJacobian (v2, J2, q);
+    BOOST_CHECK (v1.isApprox (v2));
+    BOOST_CHECK (J1.isApprox (J2));
+  }
+  flat->compile (true);
+  Configuration_t q = *cs.shoot ();
+  (*sequential) (v1, q); (*flat) (v2, q);
+  BOOST_CHECK (v1.isApprox (v2));
+}
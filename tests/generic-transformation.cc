@@ -15,63 +15,30 @@
 // hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
 
 #include "hpp/constraints/generic-transformation.hh"
+#include "hpp/constraints/differentiable-function-stack.hh"
 
 #include <pinocchio/algorithm/joint-configuration.hpp>
+#include <pinocchio/multibody/model.hpp>
+#include <pinocchio/multibody/joint/joint-revolute.hpp>
 
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/simple-device.hh>
 
+#include "hpp/constraints/kinematics-batch.hh"
+#include "hpp/constraints/packed-kinematics.hh"
 #include "hpp/constraints/tools.hh"
+#include "hpp/constraints/workspace.hh"
 
 #define BOOST_TEST_MODULE hpp_constraints
 #include <boost/test/included/unit_test.hpp>
 
-#include <stdlib.h>
-
-using hpp::pinocchio::Configuration_t;
-using hpp::pinocchio::ConfigurationPtr_t;
-using hpp::pinocchio::Device;
-using hpp::pinocchio::DevicePtr_t;
-using hpp::pinocchio::JointPtr_t;
-using hpp::pinocchio::Transform3f;
-
-using namespace hpp::constraints;
+#include "humanoid-fixture.hh"
 
-class BasicConfigurationShooter
-{
-public:
-  BasicConfigurationShooter (const DevicePtr_t& robot) : robot_ (robot)
-  {
-  }
-  virtual ConfigurationPtr_t shoot () const
-  {
-    size_type extraDim = robot_->extraConfigSpace ().dimension ();
-    size_type offset = robot_->configSize () - extraDim;
-
-    Configuration_t config(robot_->configSize ());
-    config.head(offset) = se3::randomConfiguration(robot_->model());
-
-    // Shoot extra configuration variables
-    for (size_type i=0; i<extraDim; ++i) {
-      value_type lower = robot_->extraConfigSpace ().lower (i);
-      value_type upper = robot_->extraConfigSpace ().upper (i);
-      value_type range = upper - lower;
-      if ((range < 0) ||
-          (range == std::numeric_limits<double>::infinity())) {
-        std::ostringstream oss
-          ("Cannot uniformy sample extra config variable ");
-        oss << i << ". min = " <<lower<< ", max = " << upper << std::endl;
-        throw std::runtime_error (oss.str ());
-      }
-      config [offset + i] = lower + (upper - lower) * rand ()/RAND_MAX;
-    }
-    return boost::make_shared<Configuration_t>(config);
-  }
-private:
-  const DevicePtr_t& robot_;
-}; // class BasicConfigurationShooter
+#include <stdlib.h>
+#include <sstream>
+#include <stdexcept>
 
 BOOST_AUTO_TEST_CASE (print) {
   DevicePtr_t device = hpp::pinocchio::humanoidSimple ("test");
@@ -93,3 +60,370 @@ BOOST_AUTO_TEST_CASE (print) {
   std::cout << *RelativePosition::create       ("RelativePosition"      , device, ee1, ee2, tf1, tf2) << std::endl;
   std::cout << *RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2) << std::endl;
 }
+
+BOOST_FIXTURE_TEST_CASE (valueAndJacobian, Humanoid) {
+  std::vector<DifferentiableFunctionPtr_t> functions;
+  functions.push_back (Orientation::create            ("Orientation"           , device, ee2, tf2));
+  functions.push_back (Position::create               ("Position"              , device, ee2, tf2, tf1));
+  functions.push_back (Transformation::create         ("Transformation"        , device, ee1, tf1));
+  functions.push_back (RelativeOrientation::create    ("RelativeOrientation"   , device, ee1, ee2, tf1));
+  functions.push_back (RelativePosition::create       ("RelativePosition"      , device, ee1, ee2, tf1, tf2));
+  functions.push_back (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+
+  for (std::size_t i = 0; i < functions.size (); ++i) {
+    const DifferentiableFunction& f = *functions[i];
+    vector_t value (f.outputSize ()), valueRef (f.outputSize ());
+    matrix_t J (f.outputDerivativeSize (), f.inputDerivativeSize ()),
+             JRef (f.outputDerivativeSize (), f.inputDerivativeSize ());
+    for (int iter = 0; iter < 10; ++iter) {
+      Configuration_t q = *cs.shoot ();
+      f (valueRef, q);
+      f.jacobian (JRef, q);
+      // Evaluate at another configuration to invalidate the cache.
+      f (value, *cs.shoot ());
+      f.valueAndJacobian (value, J, q);
+      BOOST_CHECK_MESSAGE (value.isApprox (valueRef), f.name ());
+      BOOST_CHECK_MESSAGE (J.isApprox (JRef), f.name ());
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (workspace, Humanoid) {
+  RelativeTransformationPtr_t f = RelativeTransformation::create
+    ("RelativeTransformation", device, ee1, ee2, tf1, tf2);
+  WorkspacePtr_t ws = Workspace::create (device);
+
+  vector_t value (f->outputSize ()), valueRef (f->outputSize ());
+  matrix_t J (f->outputDerivativeSize (), f->inputDerivativeSize ()),
+           JRef (f->outputDerivativeSize (), f->inputDerivativeSize ());
+  for (int iter = 0; iter < 10; ++iter) {
+    Configuration_t q = *cs.shoot (), q2 = *cs.shoot ();
+    (*f) (valueRef, q);
+    f->jacobian (JRef, q);
+    (*f) (value, q, *ws);
+    f->jacobian (J, q, *ws);
+    BOOST_CHECK (value.isApprox (valueRef));
+    BOOST_CHECK (J.isApprox (JRef));
+    // The workspace does not modify the robot.
+    (*f) (value, q2, *ws);
+    BOOST_CHECK (device->currentConfiguration () == q);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (batch, Humanoid) {
+  std::vector<bool> mask (6, true); mask[1] = false; mask[4] = false;
+  RelativeTransformationPtr_t f = RelativeTransformation::create
+    ("RelativeTransformation", device, ee1, ee2, tf1, tf2, mask);
+
+  const size_type N = 8, nv = f->inputDerivativeSize ();
+  matrix_t qs (f->inputSize (), N);
+  for (size_type i = 0; i < N; ++i) qs.col (i) = *cs.shoot ();
+
+  matrix_t values (f->outputSize (), N);
+  matrix_t Js (f->outputDerivativeSize (), N * nv);
+  f->valueBatch (values, qs);
+  f->jacobianBatch (Js, qs);
+
+  vector_t value (f->outputSize ());
+  matrix_t J (f->outputDerivativeSize (), nv);
+  for (size_type i = 0; i < N; ++i) {
+    (*f) (value, qs.col (i));
+    f->jacobian (J, qs.col (i));
+    BOOST_CHECK (values.col (i).isApprox (value));
+    BOOST_CHECK (Js.middleCols (i * nv, nv).isApprox (J));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (fromPlacements, Humanoid) {
+  std::vector<bool> mask (6, true); mask[1] = false; mask[4] = false;
+  DifferentiableFunctionPtr_t relative = RelativeTransformation::create
+    ("RelativeTransformation", device, ee1, ee2, tf1, tf2, mask);
+  DifferentiableFunctionPtr_t absolute = Transformation::create
+    ("Transformation", device, ee2, tf2);
+
+  const size_type N = 8, nv = device->numberDof ();
+  matrix_t qs (device->configSize (), N);
+  matrix_t J1 (6, N * nv), J2 (6, N * nv);
+  PackedPlacements M1 (N), M2 (N);
+  for (size_type k = 0; k < N; ++k) {
+    qs.col (k) = *cs.shoot ();
+    device->currentConfiguration (qs.col (k));
+    device->computeForwardKinematics ();
+    M1.set (k, ee1->currentTransformation ());
+    M2.set (k, ee2->currentTransformation ());
+    J1.middleCols (k * nv, nv) = ee1->jacobian ();
+    J2.middleCols (k * nv, nv) = ee2->jacobian ();
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    const DifferentiableFunction& f = (i == 0 ? *relative : *absolute);
+    matrix_t values (f.outputSize (), N), expectedValues (values),
+             Js (f.outputDerivativeSize (), N * nv), expectedJs (Js);
+    f.valueBatch (expectedValues, qs);
+    f.jacobianBatch (expectedJs, qs);
+    if (i == 0)
+      static_cast <const RelativeTransformation&> (f)
+        .valueAndJacobianFromPlacements (values, Js, &M1, J1, M2, J2);
+    else
+      static_cast <const Transformation&> (f)
+        .valueAndJacobianFromPlacements (values, Js, NULL, J1, M2, J2);
+    BOOST_CHECK (values.isApprox (expectedValues));
+    BOOST_CHECK (Js.isApprox (expectedJs));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (fromKinematics, Humanoid) {
+  RelativeTransformationPtr_t relative = RelativeTransformation::create
+    ("RelativeTransformation", device, ee1, ee2, tf1, tf2);
+  KinematicsBatchPtr_t batch = KinematicsBatch::create (device);
+  relative->addKinematics (*batch);
+
+  const size_type N = 8, nv = device->numberDof ();
+  matrix_t qs (device->configSize (), N);
+  for (size_type k = 0; k < N; ++k) qs.col (k) = *cs.shoot ();
+  batch->compute (qs, KinematicsCache::JACOBIANS);
+  BOOST_CHECK_EQUAL (batch->size (), N);
+
+  matrix_t values (relative->outputSize (), N), expectedValues (values),
+           Js (relative->outputDerivativeSize (), N * nv), expectedJs (Js);
+  relative->valueBatch (expectedValues, qs);
+  relative->jacobianBatch (expectedJs, qs);
+  relative->valueAndJacobianFromKinematics (values, Js, *batch);
+  BOOST_CHECK (values.isApprox (expectedValues));
+  BOOST_CHECK (Js.isApprox (expectedJs));
+}
+
+BOOST_FIXTURE_TEST_CASE (frameJacobians, Humanoid) {
+  std::vector<bool> mask (6, true); mask[1] = false;
+  RelativeTransformationPtr_t f = RelativeTransformation::create
+    ("RelativeTransformation", device, ee1, ee2, tf1, tf2, mask);
+  Configuration_t q = *cs.shoot ();
+  matrix_t J1 (f->outputDerivativeSize (), 6), J2 (J1);
+  matrixOut_t frame1 (J1), frame2 (J2);
+  f->frameJacobians (&frame1, &frame2, q);
+
+  // Finite differences along each direction of the frames.
+  const value_type eps = 1e-6;
+  vector_t v0 (f->outputSize ()), v (v0);
+  (*f) (v0, q);
+  for (int k = 0; k < 6; ++k) {
+    vector3_t u (vector3_t::Zero ()), w (vector3_t::Zero ());
+    if (k < 3) u[k] = eps; else w[k-3] = eps;
+    const Transform3f E (matrix3_t (Eigen::AngleAxis<value_type> (w.norm (),
+            k < 3 ? vector3_t::UnitX () : vector3_t (w / eps))), u);
+    (*RelativeTransformation::create ("RelativeTransformation", device,
+        ee1, ee2, tf1 * E, tf2, mask)) (v, q);
+    BOOST_CHECK (((v - v0) / eps - J1.col (k)).norm () < 1e-4);
+    (*RelativeTransformation::create ("RelativeTransformation", device,
+        ee1, ee2, tf1, tf2 * E, mask)) (v, q);
+    BOOST_CHECK (((v - v0) / eps - J2.col (k)).norm () < 1e-4);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (activeColumns, Humanoid) {
+  std::vector<DifferentiableFunctionPtr_t> functions;
+  functions.push_back (Position::create               ("Position"              , device, ee2, tf2, tf1));
+  functions.push_back (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+
+  for (std::size_t i = 0; i < functions.size (); ++i) {
+    DifferentiableFunctionPtr_t f = functions[i];
+    const ArrayXb& active = f->activeDerivativeColumns ();
+    BOOST_REQUIRE_EQUAL (active.size (), f->inputDerivativeSize ());
+    BOOST_CHECK (active.count () < f->inputDerivativeSize ());
+
+    matrix_t J (f->outputDerivativeSize (), f->inputDerivativeSize ());
+    J.setConstant (1);
+    Configuration_t q = *cs.shoot ();
+    f->jacobian (J, q);
+    for (size_type c = 0; c < J.cols (); ++c)
+      if (!active[c]) BOOST_CHECK (J.col (c).isZero ());
+
+    matrix_t Jfd (f->outputDerivativeSize (), f->inputDerivativeSize ());
+    f->finiteDifferenceCentral (Jfd, q, device, 1e-6);
+    BOOST_CHECK ((J - Jfd).isZero (1e-4));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (commonAncestors, Humanoid) {
+  // The free-flyer moves both feet: its columns are not active.
+  DifferentiableFunctionPtr_t f (RelativeTransformation::create
+      ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+  const ArrayXb& active = f->activeDerivativeColumns ();
+  BOOST_CHECK (!active.head (6).any ());
+  BOOST_CHECK (active.tail (active.size () - 6).any ());
+
+  f = Position::create ("Position", device, ee2, tf2, tf1);
+  BOOST_CHECK (f->activeDerivativeColumns ().head (6).all ());
+}
+
+BOOST_FIXTURE_TEST_CASE (quaternionLog, Humanoid) {
+  RelativeTransformationPtr_t f = RelativeTransformation::create
+    ("RelativeTransformation", device, ee1, ee2, tf1, tf2);
+  vector_t v1 (f->outputSize ()), v2 (f->outputSize ());
+  matrix_t J1 (f->outputDerivativeSize (), f->inputDerivativeSize ()),
+           J2 (f->outputDerivativeSize (), f->inputDerivativeSize ());
+  for (int i = 0; i < 10; ++i) {
+    Configuration_t q = *cs.shoot ();
+    f->useQuaternion (false);
+    f->valueAndJacobian (v1, J1, q);
+    f->useQuaternion (true);
+    f->valueAndJacobian (v2, J2, q);
+    BOOST_CHECK ((v1 - v2).isZero (1e-6));
+    BOOST_CHECK ((J1 - J2).isZero (1e-6));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (partialMask, Humanoid) {
+  // z, roll, pitch
+  std::vector<bool> mask (6, false); mask[2] = mask[3] = mask[4] = true;
+  const size_type rows[3] = { 2, 3, 4 };
+  RelativeTransformationPtr_t
+    full = RelativeTransformation::create
+      ("full"   , device, ee1, ee2, tf1, tf2),
+    partial = RelativeTransformation::create
+      ("partial", device, ee1, ee2, tf1, tf2, mask);
+
+  vector_t v (6), vp (3);
+  matrix_t J (6, full->inputDerivativeSize ()),
+           Jp (3, partial->inputDerivativeSize ());
+  for (int i = 0; i < 5; ++i) {
+    Configuration_t q = *cs.shoot ();
+    full->valueAndJacobian (v, J, q);
+    partial->valueAndJacobian (vp, Jp, q);
+    for (size_type k = 0; k < 3; ++k) {
+      BOOST_CHECK_CLOSE (vp[k] + 1, v[rows[k]] + 1, 1e-8);
+      BOOST_CHECK (Jp.row (k).isApprox (J.row (rows[k])));
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (jacobianProducts, Humanoid) {
+  std::vector<bool> mask (6, true); mask[1] = mask[5] = false;
+  std::vector<DifferentiableFunctionPtr_t> functions;
+  functions.push_back (Orientation::create            ("Orientation"           , device, ee2, tf2));
+  functions.push_back (Position::create               ("Position"              , device, ee2, tf2, tf1));
+  functions.push_back (Transformation::create         ("Transformation"        , device, ee1, tf1, mask));
+  functions.push_back (RelativeOrientation::create    ("RelativeOrientation"   , device, ee1, ee2, tf1));
+  functions.push_back (RelativePosition::create       ("RelativePosition"      , device, ee1, ee2, tf1, tf2));
+  functions.push_back (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2));
+  functions.push_back (RelativeTransformation::create ("RelativeTransformation", device, ee1, ee2, tf1, tf2, mask));
+
+  for (std::size_t i = 0; i < functions.size (); ++i) {
+    const DifferentiableFunction& f = *functions[i];
+    matrix_t J (f.outputDerivativeSize (), f.inputDerivativeSize ());
+    vector_t Jv (f.outputDerivativeSize ()), JTw (f.inputDerivativeSize ());
+    for (int iter = 0; iter < 5; ++iter) {
+      Configuration_t q = *cs.shoot ();
+      const vector_t v (vector_t::Random (f.inputDerivativeSize ())),
+                     w (vector_t::Random (f.outputDerivativeSize ()));
+      f.jacobian (J, q);
+      f.jacobianTimes (Jv, q, v);
+      f.jacobianTransposeTimes (JTw, q, w);
+      BOOST_CHECK_MESSAGE (Jv.isApprox (J * v), f.name ());
+      BOOST_CHECK_MESSAGE (JTw.isApprox (J.transpose () * w), f.name ());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (sharedJointPair) {
+  DevicePtr_t device = hpp::pinocchio::humanoidSimple ("test"),
+              other  = hpp::pinocchio::humanoidSimple ("other");
+  BOOST_REQUIRE (device && other);
+  const std::string n1 ("lleg5_joint"), n2 ("rleg5_joint");
+  JointPtr_t ee1 = device->getJointByName (n1),
+             ee2 = device->getJointByName (n2);
+  BasicConfigurationShooter cs (device);
+
+  // Two functions sharing the same pair of joints, with different frames.
+  Transform3f F1 (Transform3f::Random ()), F2 (Transform3f::Random ()),
+              G1 (Transform3f::Random ()), G2 (Transform3f::Random ());
+  RelativeTransformationPtr_t
+    f = RelativeTransformation::create ("f", device, ee1, ee2, F1, F2),
+    g = RelativeTransformation::create ("g", device, ee1, ee2, G1, G2);
+  TransformationPtr_t
+    h = Transformation::create ("h", device, ee2, G2, F1);
+  // The same functions on another robot, so that nothing is shared.
+  RelativeTransformationPtr_t
+    fo = RelativeTransformation::create ("f", other,
+        other->getJointByName (n1), other->getJointByName (n2), F1, F2),
+    go = RelativeTransformation::create ("g", other,
+        other->getJointByName (n1), other->getJointByName (n2), G1, G2);
+  TransformationPtr_t
+    ho = Transformation::create ("h", other, other->getJointByName (n2),
+        G2, F1);
+
+  vector_t v (6), vo (6);
+  matrix_t J (6, f->inputDerivativeSize ()), Jo (6, f->inputDerivativeSize ());
+  for (int i = 0; i < 5; ++i) {
+    Configuration_t q = *cs.shoot ();
+    f->valueAndJacobian (v, J, q); fo->valueAndJacobian (vo, Jo, q);
+    BOOST_CHECK (v.isApprox (vo)); BOOST_CHECK (J.isApprox (Jo));
+    g->valueAndJacobian (v, J, q); go->valueAndJacobian (vo, Jo, q);
+    BOOST_CHECK (v.isApprox (vo)); BOOST_CHECK (J.isApprox (Jo));
+    h->valueAndJacobian (v, J, q); ho->valueAndJacobian (vo, Jo, q);
+    BOOST_CHECK (v.isApprox (vo)); BOOST_CHECK (J.isApprox (Jo));
+  }
+}
+
+
+// Serial arm with 6 revolute joints.
+DevicePtr_t createArm ()
+{
+  DevicePtr_t robot = Device::create ("arm");
+  se3::Model& model = robot->model ();
+  se3::JointIndex parent = 0;
+  for (int i = 0; i < 6; ++i) {
+    std::ostringstream name; name << "joint" << i + 1;
+    const se3::SE3 placement (se3::SE3::Matrix3::Identity (),
+        se3::SE3::Vector3 (0, 0.1, 0.3));
+    if (i % 2) parent = model.addJoint (parent, se3::JointModelRY (),
+        placement, name.str ());
+    else parent = model.addJoint (parent, se3::JointModelRZ (),
+        placement, name.str ());
+    model.appendBodyToJoint (parent, se3::Inertia::Random (),
+        se3::SE3::Identity ());
+  }
+  robot->createData ();
+  robot->createGeomData ();
+  return robot;
+}
+
+BOOST_AUTO_TEST_CASE (fixedNumberDof) {
+  typedef GenericTransformation<PositionBit | OrientationBit, 6> Transformation6;
+  typedef GenericTransformation<RelativeBit | PositionBit | OrientationBit, 6>
+    RelativeTransformation6;
+  typedef GenericTransformation<PositionBit | OrientationBit, 7> Transformation7;
+  DevicePtr_t device = createArm ();
+  BOOST_REQUIRE (device->numberDof () == 6);
+  JointPtr_t j2 = device->getJointByName ("joint2"),
+             j6 = device->getJointByName ("joint6");
+  BasicConfigurationShooter cs (device);
+  const Transform3f F1 (Transform3f::Random ()), F2 (Transform3f::Random ());
+  std::vector<bool> mask (6, true); mask[1] = mask[5] = false;
+
+  std::vector<DifferentiableFunctionPtr_t> functions, references;
+  functions.push_back (Transformation6::create ("Transformation", device, j6, F2, F1));
+  references.push_back (Transformation::create ("Transformation", device, j6, F2, F1));
+  functions.push_back (RelativeTransformation6::create ("RelativeTransformation", device, j2, j6, F1, F2));
+  references.push_back (RelativeTransformation::create ("RelativeTransformation", device, j2, j6, F1, F2));
+  functions.push_back (RelativeTransformation6::create ("RelativeTransformation", device, j2, j6, F1, F2, mask));
+  references.push_back (RelativeTransformation::create ("RelativeTransformation", device, j2, j6, F1, F2, mask));
+
+  for (std::size_t i = 0; i < functions.size (); ++i) {
+    const DifferentiableFunction& f = *functions[i], & ref = *references[i];
+    vector_t value (f.outputSize ()), valueRef (f.outputSize ());
+    matrix_t J (f.outputDerivativeSize (), f.inputDerivativeSize ()),
+             JRef (f.outputDerivativeSize (), f.inputDerivativeSize ());
+    for (int iter = 0; iter < 10; ++iter) {
+      Configuration_t q = *cs.shoot ();
+      f.valueAndJacobian (value, J, q);
+      ref.valueAndJacobian (valueRef, JRef, q);
+      BOOST_CHECK_MESSAGE (value.isApprox (valueRef), f.name ());
+      BOOST_CHECK_MESSAGE (J.isApprox (JRef), f.name ());
+    }
+  }
+
+  // The number of degrees of freedom must match.
+  BOOST_CHECK_THROW (Transformation7::create ("Transformation", device, j6,
+        F2, F1), std::invalid_argument);
+}
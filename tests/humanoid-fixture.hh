@@ -0,0 +1,99 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CONSTRAINTS_TESTS_HUMANOID_FIXTURE_HH
+# define HPP_CONSTRAINTS_TESTS_HUMANOID_FIXTURE_HH
+
+// Include after boost/test/unit_test.hpp.
+
+# include <limits>
+# include <sstream>
+# include <stdexcept>
+# include <stdlib.h>
+
+# include <pinocchio/algorithm/joint-configuration.hpp>
+
+# include <hpp/pinocchio/device.hh>
+# include <hpp/pinocchio/joint.hh>
+# include <hpp/pinocchio/configuration.hh>
+# include <hpp/pinocchio/simple-device.hh>
+
+# include <hpp/constraints/fwd.hh>
+
+using hpp::pinocchio::Configuration_t;
+using hpp::pinocchio::ConfigurationPtr_t;
+using hpp::pinocchio::Device;
+using hpp::pinocchio::DevicePtr_t;
+using hpp::pinocchio::JointPtr_t;
+using hpp::pinocchio::Transform3f;
+
+using namespace hpp::constraints;
+
+class BasicConfigurationShooter
+{
+public:
+  BasicConfigurationShooter (const DevicePtr_t& robot) : robot_ (robot)
+  {
+  }
+  virtual ConfigurationPtr_t shoot () const
+  {
+    size_type extraDim = robot_->extraConfigSpace ().dimension ();
+    size_type offset = robot_->configSize () - extraDim;
+
+    Configuration_t config(robot_->configSize ());
+    config.head(offset) = se3::randomConfiguration(robot_->model());
+
+    // Shoot extra configuration variables
+    for (size_type i=0; i<extraDim; ++i) {
+      value_type lower = robot_->extraConfigSpace ().lower (i);
+      value_type upper = robot_->extraConfigSpace ().upper (i);
+      value_type range = upper - lower;
+      if ((range < 0) ||
+          (range == std::numeric_limits<double>::infinity())) {
+        std::ostringstream oss
+          ("Cannot uniformy sample extra config variable ");
+        oss << i << ". min = " <<lower<< ", max = " << upper << std::endl;
+        throw std::runtime_error (oss.str ());
+      }
+      config [offset + i] = lower + (upper - lower) * rand ()/RAND_MAX;
+    }
+    return boost::make_shared<Configuration_t>(config);
+  }
+private:
+  const DevicePtr_t& robot_;
+}; // class BasicConfigurationShooter
+
+/// Humanoid robot with the frames of its feet at a random configuration.
+struct Humanoid
+{
+  Humanoid () : device (hpp::pinocchio::humanoidSimple ("test")), cs (device)
+  {
+    BOOST_REQUIRE (device);
+    ee1 = device->getJointByName ("lleg5_joint");
+    ee2 = device->getJointByName ("rleg5_joint");
+    device->currentConfiguration (*cs.shoot ());
+    device->computeForwardKinematics ();
+    tf1 = ee1->currentTransformation ();
+    tf2 = ee2->currentTransformation ();
+  }
+
+  DevicePtr_t device;
+  JointPtr_t ee1, ee2;
+  BasicConfigurationShooter cs;
+  Transform3f tf1, tf2;
+}; // struct Humanoid
+
+#endif // HPP_CONSTRAINTS_TESTS_HUMANOID_FIXTURE_HH
@@ -0,0 +1,161 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/kinematics-cache.hh"
+#include "hpp/constraints/center-of-mass-cache.hh"
+#include "hpp/constraints/geometry-placements.hh"
+
+#define BOOST_TEST_MODULE KinematicsCache
+#include <boost/test/unit_test.hpp>
+
+#include "humanoid-fixture.hh"
+
+#include <pinocchio/multibody/model.hpp>
+#include <pinocchio/multibody/geometry.hpp>
+
+/// Copy of the humanoid with all the quantities computed at q.
+DevicePtr_t reference (const Configuration_t& q)
+{
+  DevicePtr_t robot (hpp::pinocchio::humanoidSimple ("reference"));
+  robot->controlComputation (Device::ALL);
+  robot->currentConfiguration (q);
+  robot->computeForwardKinematics ();
+  return robot;
+}
+
+/// Check the placements of some joints, all of them if joints is empty.
+void checkPlacements (const DevicePtr_t& robot, const DevicePtr_t& ref,
+    const KinematicsCache::Joints_t& joints = KinematicsCache::Joints_t ())
+{
+  for (std::size_t j = 1; j < robot->model ().joints.size (); ++j) {
+    if (!joints.empty () && !joints [j]) continue;
+    BOOST_CHECK_MESSAGE (robot->data ().oMi [j].isApprox
+        (ref->data ().oMi [j], 1e-12), "joint " << robot->model ().names [j]);
+  }
+}
+
+/// Check the center of mass and the placements of the geometries.
+void checkDependents (const KinematicsCachePtr_t& kinematics,
+    const DevicePtr_t& ref)
+{
+  CenterOfMassCachePtr_t com (CenterOfMassCache::get (kinematics));
+  com->compute (Device::COM);
+  BOOST_CHECK (com->com ().isApprox (ref->positionCenterOfMass (), 1e-12));
+
+  const se3::GeometryModel& model = ref->geomModel ();
+  GeometryPlacements::Geometries_t geometries;
+  for (std::size_t g = 0; g < model.geometryObjects.size (); ++g)
+    geometries.push_back (g);
+  GeometryPlacementsPtr_t placements (GeometryPlacements::get (kinematics));
+  placements->update (geometries);
+  for (std::size_t g = 0; g < geometries.size (); ++g) {
+    const se3::GeometryObject& object = model.geometryObjects [g];
+    BOOST_CHECK (placements->placement (g).isApprox
+        (ref->data ().oMi [object.parentJoint] * object.placement, 1e-12));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE (restrictedThenFull, Humanoid) {
+  KinematicsCachePtr_t kinematics (KinematicsCache::get (device));
+  const Configuration_t q (*cs.shoot ());
+  const DevicePtr_t ref (reference (q));
+  KinematicsCache::Joints_t joints;
+  KinematicsCache::addJoint (joints, ee1);
+
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS, joints));
+  const std::size_t version = kinematics->version ();
+  checkPlacements (device, ref, joints);
+
+  // The other joints are computed at the same version.
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS));
+  BOOST_CHECK_EQUAL (kinematics->version (), version);
+  checkPlacements (device, ref);
+  checkDependents (kinematics, ref);
+
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::PLACEMENTS));
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::PLACEMENTS, joints));
+  BOOST_CHECK_EQUAL (kinematics->version (), version);
+}
+
+BOOST_FIXTURE_TEST_CASE (disjointJoints, Humanoid) {
+  KinematicsCachePtr_t kinematics (KinematicsCache::get (device));
+  const Configuration_t q (*cs.shoot ());
+  const DevicePtr_t ref (reference (q));
+  KinematicsCache::Joints_t left, right, both;
+  KinematicsCache::addJoint (left, ee1);
+  KinematicsCache::addJoint (right, ee2);
+  KinematicsCache::addJoint (both, ee1);
+  KinematicsCache::addJoint (both, ee2);
+
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS, left));
+  const std::size_t version = kinematics->version ();
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS, right));
+  BOOST_CHECK_EQUAL (kinematics->version (), version);
+  checkPlacements (device, ref, both);
+
+  // Both sets are kept.
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::PLACEMENTS, left));
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::PLACEMENTS, right));
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::PLACEMENTS, both));
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS));
+  BOOST_CHECK_EQUAL (kinematics->version (), version);
+  checkPlacements (device, ref);
+}
+
+BOOST_FIXTURE_TEST_CASE (placementsThenJacobians, Humanoid) {
+  KinematicsCachePtr_t kinematics (KinematicsCache::get (device));
+  const Configuration_t q (*cs.shoot ());
+  const DevicePtr_t ref (reference (q));
+  KinematicsCache::Joints_t joints;
+  KinematicsCache::addJoint (joints, ee1);
+
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS, joints));
+  const std::size_t version = kinematics->version ();
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::JACOBIANS, joints));
+  BOOST_CHECK_EQUAL (kinematics->version (), version);
+  checkPlacements (device, ref, joints);
+  BOOST_CHECK (ee1->jacobian ().isApprox
+      (ref->getJointByName (ee1->name ())->jacobian (), 1e-12));
+
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::PLACEMENTS, joints));
+  BOOST_CHECK (!kinematics->update (q, KinematicsCache::JACOBIANS, joints));
+}
+
+BOOST_FIXTURE_TEST_CASE (externalChange, Humanoid) {
+  KinematicsCachePtr_t kinematics (KinematicsCache::get (device));
+  const Configuration_t q (*cs.shoot ()), q2 (*cs.shoot ());
+  const DevicePtr_t ref (reference (q));
+  KinematicsCache::Joints_t joints;
+  KinematicsCache::addJoint (joints, ee1);
+
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS));
+  std::size_t version = kinematics->version ();
+
+  // The Device is moved without going through the cache.
+  device->currentConfiguration (q2);
+  device->computeForwardKinematics ();
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS, joints));
+  BOOST_CHECK_EQUAL (kinematics->version (), version + 1);
+  checkPlacements (device, ref, joints);
+
+  device->currentConfiguration (q2);
+  device->computeForwardKinematics ();
+  version = kinematics->version ();
+  BOOST_CHECK (kinematics->update (q, KinematicsCache::PLACEMENTS));
+  BOOST_CHECK_EQUAL (kinematics->version (), version + 1);
+  checkPlacements (device, ref);
+  checkDependents (kinematics, ref);
+}
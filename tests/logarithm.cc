@@ -98,3 +98,57 @@ BOOST_AUTO_TEST_CASE (logarithm) {
   BOOST_CHECK(check ((M_PI - 1.001 * dlUB) / sqrt(3) * vector3_t (1, 1,1), eps));
   BOOST_CHECK(check ((M_PI - 0.999 * dlUB) / sqrt(3) * vector3_t (1, 1,1)));
 }
+
+BOOST_AUTO_TEST_CASE (logarithms) {
+  const value_type dlUB = 1e-2;
+  std::vector<vector3_t> aas;
+  aas.push_back (vector3_t (0,0,0));
+  aas.push_back (vector3_t (1,1,1));
+  aas.push_back (1e-7 * vector3_t (1,1,1));
+  aas.push_back (M_PI * vector3_t (0,1,0));
+  aas.push_back (M_PI / sqrt(2) * vector3_t (1,0,1));
+  aas.push_back ((M_PI - 0.1 * dlUB) / sqrt(3) * vector3_t (1,-1,1));
+  aas.push_back ((M_PI - 1.001 * dlUB) / sqrt(3) * vector3_t (1, 1,1));
+  for (int i = 0; i < 20; ++i) aas.push_back (vector3_t::Random ());
+
+  const size_type n = aas.size ();
+  matrices3_t R (9, n);
+  for (size_type i = 0; i < n; ++i) {
+    const matrix3_t Ri = exponential (aas[i]);
+    R.col (i) = Eigen::Map<const Eigen::Matrix<value_type, 9, 1> > (Ri.data ());
+  }
+  vector_t thetas; vectors3_t logs; matrices3_t Jlogs;
+  computeLogs (R, thetas, logs);
+  computeJlogs (thetas, logs, Jlogs);
+
+  for (size_type i = 0; i < n; ++i) {
+    const matrix3_t Ri = exponential (aas[i]);
+    vector3_t log; value_type theta; matrix3_t Jlog;
+    computeLog (Ri, theta, log);
+    computeJlog (theta, log, Jlog);
+    BOOST_CHECK_CLOSE (thetas[i] + 1, theta + 1, 1e-8);
+    BOOST_CHECK ((logs.col (i) - log).isZero (1e-10));
+    BOOST_CHECK ((Eigen::Map<const Eigen::Matrix<value_type, 9, 1> >
+          (Jlog.data ()) - Jlogs.col (i)).isZero (1e-8));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (logarithmFromQuaternion) {
+  const value_type dlUB = 1e-2;
+  std::vector<vector3_t> aas;
+  aas.push_back (vector3_t (0,0,0));
+  aas.push_back (vector3_t (1,0,0));
+  aas.push_back (vector3_t (1,1,1));
+  aas.push_back (1e-7 * vector3_t (1,1,1));
+  aas.push_back (M_PI / sqrt(2) * vector3_t (1,1,0));
+  // No loss of precision around pi.
+  aas.push_back (M_PI / sqrt(3) * vector3_t (1,-1,1));
+  aas.push_back ((M_PI - 0.1 * dlUB) / sqrt(3) * vector3_t (1,-1,1));
+  aas.push_back ((M_PI - 1.001 * dlUB) / sqrt(3) * vector3_t (1, 1,1));
+  for (std::size_t i = 0; i < aas.size (); ++i) {
+    vector3_t log; value_type theta;
+    computeLogFromQuaternion (exponential (aas[i]), theta, log);
+    BOOST_CHECK_SMALL ((log - aas[i]).norm (), 1e-10);
+    BOOST_CHECK_SMALL (theta - aas[i].norm (), 1e-10);
+  }
+}
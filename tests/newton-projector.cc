@@ -0,0 +1,83 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE NewtonProjector
+#include <boost/test/unit_test.hpp>
+
+#include <hpp/constraints/newton-projector.hh>
+#include <hpp/constraints/differentiable-function-stack.hh>
+#include <hpp/constraints/auto-diff-function.hh>
+
+using hpp::constraints::AutoDiffFunction;
+using hpp::constraints::DevicePtr_t;
+using hpp::constraints::DifferentiableFunctionStack;
+using hpp::constraints::DifferentiableFunctionStackPtr_t;
+using hpp::constraints::NewtonProjector;
+using hpp::constraints::NewtonProjectorPtr_t;
+using hpp::constraints::vector_t;
+
+/// f (x) = x0^2 + x1^2 - 1
+class Circle : public AutoDiffFunction <Circle>
+{
+  public:
+    Circle () : AutoDiffFunction <Circle> (3, 3, 1, "Circle") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = x [0] * x [0] + x [1] * x [1] - 1;
+    }
+};
+
+/// f (x) = x0 - x1
+class Diagonal : public AutoDiffFunction <Diagonal>
+{
+  public:
+    Diagonal () : AutoDiffFunction <Diagonal> (3, 3, 1, "Diagonal") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = x [0] - x [1];
+    }
+};
+
+BOOST_AUTO_TEST_CASE (solve)
+{
+  DifferentiableFunctionStackPtr_t stack
+    (DifferentiableFunctionStack::create ("stack"));
+  stack->add (boost::shared_ptr <Circle> (new Circle));
+  stack->add (boost::shared_ptr <Diagonal> (new Diagonal));
+  NewtonProjectorPtr_t projector (NewtonProjector::create
+      (stack, DevicePtr_t ()));
+
+  const NewtonProjector::Decomposition_t decompositions[] = {
+    NewtonProjector::COLUMN_PIVOTING_QR, NewtonProjector::TRUNCATED_SVD };
+  for (std::size_t d = 0; d < 2; ++d) {
+    projector->decomposition (decompositions [d]);
+    vector_t q (3);
+    q << 2, 0.5, 0.3;
+    BOOST_CHECK_EQUAL (projector->solve (q), NewtonProjector::SUCCESS);
+    BOOST_CHECK_CLOSE (q [0], std::sqrt (.5), 1e-4);
+    BOOST_CHECK_CLOSE (q [1], std::sqrt (.5), 1e-4);
+    // The third variable is not an active column of the stack.
+    BOOST_CHECK_EQUAL (q [2], 0.3);
+    BOOST_CHECK_EQUAL (projector->rank (), 2);
+    BOOST_CHECK (projector->squaredNorm () <= 1e-12);
+  }
+}
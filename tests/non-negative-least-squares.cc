@@ -0,0 +1,132 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE NonNegativeLeastSquares
+#include <boost/test/unit_test.hpp>
+
+#include <hpp/constraints/non-negative-least-squares.hh>
+#include <hpp/constraints/contact-force-solver.hh>
+
+using hpp::constraints::ContactForceSolver;
+using hpp::constraints::ContactForceSolverPtr_t;
+using hpp::constraints::DualActiveSetContactForceSolver;
+using hpp::constraints::NNLSContactForceSolver;
+using hpp::constraints::NonNegativeLeastSquares;
+using hpp::constraints::matrix_t;
+using hpp::constraints::vector_t;
+using hpp::constraints::value_type;
+using hpp::constraints::size_type;
+
+BOOST_AUTO_TEST_CASE (optimality)
+{
+  const value_type eps = 1e-8;
+  NonNegativeLeastSquares nnls;
+  for (std::size_t k = 0; k < 100; ++k) {
+    const size_type n = 1 + k % 32;
+    const matrix_t A (matrix_t::Random (6, n));
+    const vector_t b (vector_t::Random (6));
+    BOOST_CHECK (nnls.solve (A, b, k % 2 == 1));
+    const vector_t& x = nnls.solution ();
+    const vector_t& w = nnls.dual ();
+    // Karush-Kuhn-Tucker conditions.
+    BOOST_CHECK ((x.array () >= -eps).all ());
+    BOOST_CHECK ((w.array () >= -eps).all ());
+    BOOST_CHECK ((x.cwiseProduct (w).array ().abs () <= eps).all ());
+    BOOST_CHECK_CLOSE (nnls.residual (), (A * x - b).squaredNorm (), 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (warmStart)
+{
+  NonNegativeLeastSquares nnls;
+  matrix_t A (matrix_t::Random (6, 16));
+  const vector_t b (vector_t::Random (6));
+  BOOST_CHECK (nnls.solve (A, b, false));
+  const std::size_t cold = nnls.iterations ();
+  A += 1e-4 * matrix_t::Random (6, 16);
+  BOOST_CHECK (nnls.solve (A, b, true));
+  BOOST_CHECK (nnls.iterations () <= cold);
+}
+
+BOOST_AUTO_TEST_CASE (dualActiveSet)
+{
+  const value_type eps = 1e-8;
+  ContactForceSolverPtr_t solver (DualActiveSetContactForceSolver::create ());
+  ContactForceSolverPtr_t nnls (NNLSContactForceSolver::create ());
+  for (std::size_t k = 0; k < 100; ++k) {
+    const size_type n = 1 + k % 32;
+    matrix_t A (matrix_t::Random (6, n));
+    // Parallel contact wrenches.
+    if (n > 2) A.col (1) = 2 * A.col (0);
+    const vector_t b (vector_t::Random (6));
+    // The second problem is warm started.
+    for (std::size_t i = 0; i < 2; ++i) {
+      if (i == 1) A += 1e-4 * matrix_t::Random (6, n);
+      BOOST_CHECK (solver->solve (A, b));
+      BOOST_CHECK (nnls->solve (A, b));
+      const vector_t& x = solver->solution ();
+      const vector_t& w = solver->dual ();
+      BOOST_CHECK ((x.array () >= -eps).all ());
+      BOOST_CHECK ((w.array () >= -eps).all ());
+      BOOST_CHECK ((x.cwiseProduct (w).array ().abs () <= eps).all ());
+      BOOST_CHECK_SMALL (solver->residual () - nnls->residual (), eps);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (iterationCap)
+{
+  // Each variable enters the active set at a distinct iteration.
+  const matrix_t A (matrix_t::Identity (6, 6));
+  const vector_t b (vector_t::Ones (6));
+  ContactForceSolverPtr_t solvers [2] = {
+    DualActiveSetContactForceSolver::create (),
+    NNLSContactForceSolver::create () };
+  for (std::size_t i = 0; i < 2; ++i) {
+    ContactForceSolver& solver = *solvers [i];
+    solver.maxIterations (2);
+    BOOST_CHECK (!solver.solve (A, b));
+    BOOST_CHECK (solver.iterations () <= 2);
+    solver.reset ();
+    solver.maxIterations (100);
+    BOOST_CHECK (solver.solve (A, b));
+    BOOST_CHECK (solver.solution ().isApprox (b));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (restoreWarmStart)
+{
+  matrix_t A (matrix_t::Random (6, 16));
+  vector_t x0 (vector_t::Zero (16));
+  x0.head (3).setOnes ();
+  const vector_t b (A * x0);
+  ContactForceSolverPtr_t solvers [2] = {
+    DualActiveSetContactForceSolver::create (),
+    NNLSContactForceSolver::create () };
+  for (std::size_t i = 0; i < 2; ++i) {
+    ContactForceSolver& solver = *solvers [i];
+    BOOST_CHECK (solver.solve (A, b));
+    const vector_t x (solver.solution ());
+    const std::size_t cold = solver.iterations ();
+    // Another problem, then the first one from its saved solution.
+    BOOST_CHECK (solver.solve (matrix_t::Random (6, 16), vector_t::Ones (6)));
+    solver.warmStart (x);
+    BOOST_CHECK (solver.solve (A, b));
+    BOOST_CHECK (solver.warmStarted ());
+    BOOST_CHECK (solver.solution ().isApprox (x, 1e-6));
+    BOOST_CHECK (solver.iterations () <= cold);
+  }
+}
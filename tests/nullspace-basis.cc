@@ -0,0 +1,57 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#define BOOST_TEST_MODULE NullspaceBasis
+#include <boost/test/unit_test.hpp>
+
+#include <hpp/constraints/nullspace-basis.hh>
+
+using hpp::constraints::NullspaceBasis;
+using hpp::constraints::matrix_t;
+using hpp::constraints::size_type;
+
+BOOST_AUTO_TEST_CASE (nullspace_basis)
+{
+  const size_type rows = 4, cols = 7;
+  matrix_t J (matrix_t::Random (rows, cols));
+  // One row is a combination of the others.
+  J.row (3) = J.row (0) - 2 * J.row (1);
+  const matrix_t I (matrix_t::Identity (cols - 3, cols - 3));
+
+  NullspaceBasis kernel;
+  BOOST_CHECK (!kernel.update (J));
+  BOOST_CHECK_EQUAL (kernel.rank (), 3);
+  BOOST_CHECK_EQUAL (kernel.basis ().cols (), cols - 3);
+  BOOST_CHECK ((J * kernel.basis ()).isZero (1e-10));
+  BOOST_CHECK ((kernel.basis ().transpose () * kernel.basis ()).isApprox (I));
+
+  // A nearby jacobian of the same rank.
+  const matrix_t N0 (kernel.basis ());
+  J.topRows (3) += 1e-3 * matrix_t::Random (3, cols);
+  J.row (3) = J.row (0) - 2 * J.row (1);
+  BOOST_CHECK (kernel.update (J));
+  BOOST_CHECK ((J * kernel.basis ()).isZero (1e-10));
+  BOOST_CHECK ((kernel.basis ().transpose () * kernel.basis ()).isApprox (I));
+  // The basis moves continuously.
+  BOOST_CHECK ((kernel.basis () - N0).norm () < 1e-1);
+
+  // The rank changes.
+  J.row (3).setRandom ();
+  BOOST_CHECK (!kernel.update (J));
+  BOOST_CHECK_EQUAL (kernel.rank (), 4);
+  BOOST_CHECK ((J * kernel.basis ()).isZero (1e-10));
+}
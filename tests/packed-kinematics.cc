@@ -0,0 +1,46 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE PackedKinematics
+#include <boost/test/included/unit_test.hpp>
+
+#include <hpp/constraints/packed-kinematics.hh>
+
+using hpp::constraints::PackedPlacements;
+using hpp::constraints::Transform3f;
+using hpp::constraints::size_type;
+using hpp::constraints::relativePlacements;
+
+BOOST_AUTO_TEST_CASE (relative)
+{
+  const size_type n = 10;
+  PackedPlacements M1 (n), M2 (n), M;
+  std::vector <Transform3f> m1, m2;
+  for (size_type k = 0; k < n; ++k) {
+    m1.push_back (Transform3f::Random ()); M1.set (k, m1.back ());
+    m2.push_back (Transform3f::Random ()); M2.set (k, m2.back ());
+    BOOST_CHECK (M1.get (k).isApprox (m1.back ()));
+  }
+  const Transform3f F1 (Transform3f::Random ()), F2 (Transform3f::Random ());
+
+  relativePlacements (&M1, F1, M2, F2, M);
+  for (size_type k = 0; k < n; ++k)
+    BOOST_CHECK (M.get (k).isApprox ((m1[k] * F1).inverse () * m2[k] * F2));
+
+  relativePlacements (NULL, F1, M2, F2, M);
+  for (size_type k = 0; k < n; ++k)
+    BOOST_CHECK (M.get (k).isApprox (F1.inverse () * m2[k] * F2));
+}
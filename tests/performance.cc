@@ -0,0 +1,387 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+// Performance regression tests, labelled perf in the test suite.
+//
+// Each workload is evaluated on fixed random configurations of the simple
+// humanoid. The tests check
+// - that the evaluations that promise not to allocate memory do not,
+// - that the time of each workload, divided by the time of the value of a
+//   Position, does not exceed by more than 50% the ratio stored in the
+//   baseline file given by the environment variable
+//   HPP_CONSTRAINTS_PERF_BASELINE.
+// Without a baseline file, the timings are not checked and a message says
+// so. A workload that is missing from an existing baseline is a failure.
+// The ratios of the workloads that were not checked are written in
+// perf-baseline.csv in the working directory, in the format of the
+// baseline: name,ratio. To create or extend the baseline, run the test on
+// the reference machine and append this file to tests/perf-baseline.csv.
+
+#define BOOST_TEST_MODULE Performance
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/simple-device.hh>
+#include <hpp/pinocchio/center-of-mass-computation.hh>
+
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/differentiable-function-stack.hh>
+#include <hpp/constraints/convex-shape.hh>
+#include <hpp/constraints/convex-shape-contact.hh>
+#ifdef HPP_CONSTRAINTS_USE_QPOASES
+# include <hpp/constraints/static-stability.hh>
+#endif
+
+using hpp::pinocchio::Configuration_t;
+using hpp::pinocchio::DevicePtr_t;
+using hpp::pinocchio::JointPtr_t;
+using hpp::pinocchio::Transform3f;
+
+using namespace hpp::constraints;
+
+namespace {
+  std::size_t nbAllocations = 0;
+} // namespace
+
+#ifdef __GLIBC__
+// Count the allocations of the process. operator new and Eigen both call
+// malloc.
+extern "C" {
+  void* __libc_malloc (size_t size);
+  void* __libc_calloc (size_t n, size_t size);
+  void* __libc_realloc (void* ptr, size_t size);
+
+  void* malloc (size_t size)
+  {
+    ++nbAllocations;
+    return __libc_malloc (size);
+  }
+
+  void* calloc (size_t n, size_t size)
+  {
+    ++nbAllocations;
+    return __libc_calloc (n, size);
+  }
+
+  void* realloc (void* ptr, size_t size)
+  {
+    ++nbAllocations;
+    return __libc_realloc (ptr, size);
+  }
+}
+#endif
+
+namespace {
+  typedef std::vector <Configuration_t> Configurations_t;
+  typedef boost::posix_time::ptime Time_t;
+
+  const std::size_t iterations = 1000;
+  const value_type tolerance = 1.5;
+
+  Time_t now ()
+  {
+    return boost::posix_time::microsec_clock::universal_time ();
+  }
+
+  DevicePtr_t robot ()
+  {
+    static DevicePtr_t r;
+    if (!r) r = hpp::pinocchio::humanoidSimple ("performance");
+    return r;
+  }
+
+  /// Random configurations, always the same.
+  const Configurations_t& configurations ()
+  {
+    static Configurations_t qs;
+    if (qs.empty ()) {
+      std::srand (0);
+      qs.resize (100, Configuration_t (robot ()->configSize ()));
+      const size_type extraDim = robot ()->extraConfigSpace ().dimension ();
+      for (std::size_t i = 0; i < qs.size (); ++i) {
+        qs[i].head (robot ()->configSize () - extraDim) =
+          se3::randomConfiguration (robot ()->model ());
+        qs[i].tail (extraDim).setZero ();
+      }
+    }
+    return qs;
+  }
+
+  /// Ratios of the stored baseline and of the current run.
+  class Baseline
+  {
+    public:
+      Baseline () : available_ (false), reference_ (0)
+      {
+        const char* path = std::getenv ("HPP_CONSTRAINTS_PERF_BASELINE");
+        if (path == NULL) {
+          BOOST_TEST_MESSAGE ("HPP_CONSTRAINTS_PERF_BASELINE is not set:"
+              " the timings are not checked");
+          return;
+        }
+        std::ifstream file (path);
+        if (!file) {
+          BOOST_TEST_MESSAGE ("Cannot read the baseline " << path
+              << ": the timings are not checked");
+          return;
+        }
+        available_ = true;
+        std::string line;
+        while (std::getline (file, line)) {
+          const std::string::size_type comma = line.find (',');
+          if (comma == std::string::npos) continue;
+          std::istringstream ratio (line.substr (comma + 1));
+          ratio >> stored_ [line.substr (0, comma)];
+        }
+      }
+
+      ~Baseline ()
+      {
+        if (recorded_.empty ()) return;
+        std::ofstream file ("perf-baseline.csv");
+        for (Ratios_t::const_iterator _r = recorded_.begin ();
+            _r != recorded_.end (); ++_r)
+          file << _r->first << ',' << _r->second << std::endl;
+        std::cout << "Ratios without baseline written in perf-baseline.csv:"
+          " add them to tests/perf-baseline.csv" << std::endl;
+      }
+
+      /// Time of the evaluation all the ratios are relative to.
+      void reference (value_type ns)
+      {
+        reference_ = ns;
+      }
+
+      void check (const std::string& name, value_type ns)
+      {
+        BOOST_REQUIRE (reference_ > 0);
+        const value_type ratio = ns / reference_;
+        BOOST_TEST_MESSAGE (name << ": " << ns << " ns, ratio " << ratio);
+        Ratios_t::const_iterator _r = stored_.find (name);
+        if (_r == stored_.end ()) {
+          recorded_ [name] = ratio;
+          if (available_) BOOST_ERROR (name << " is not in the baseline");
+          return;
+        }
+        BOOST_CHECK_MESSAGE (ratio <= tolerance * _r->second, name
+            << " is slower than the baseline: ratio " << ratio
+            << " instead of " << _r->second);
+      }
+
+    private:
+      typedef std::map <std::string, value_type> Ratios_t;
+      Ratios_t stored_, recorded_;
+      bool available_;
+      value_type reference_;
+  }; // class Baseline
+
+  Baseline& baseline ()
+  {
+    static Baseline b;
+    return b;
+  }
+
+  struct Value
+  {
+    Value (const DifferentiableFunction& f) : f (f), value (f.outputSize ()) {}
+    void operator() (const Configuration_t& q) { f (value, q); }
+    const DifferentiableFunction& f;
+    vector_t value;
+  };
+
+  struct Jacobian
+  {
+    Jacobian (const DifferentiableFunction& f) :
+      f (f), jacobian (f.outputDerivativeSize (), f.inputDerivativeSize ()) {}
+    void operator() (const Configuration_t& q) { f.jacobian (jacobian, q); }
+    const DifferentiableFunction& f;
+    matrix_t jacobian;
+  };
+
+  struct Measure
+  {
+    /// Mean time of an evaluation.
+    value_type ns;
+    /// Mean number of allocations of an evaluation.
+    value_type allocations;
+  };
+
+  /// Evaluate once at each configuration before measuring, so that the
+  /// buffers have their final sizes.
+  template <typename Evaluation>
+  Measure measure (Evaluation evaluation)
+  {
+    const Configurations_t& qs = configurations ();
+    for (std::size_t i = 0; i < qs.size (); ++i) evaluation (qs [i]);
+    Measure m;
+    nbAllocations = 0;
+    const Time_t start = now ();
+    for (std::size_t i = 0; i < iterations; ++i)
+      evaluation (qs [i % qs.size ()]);
+    m.ns = (value_type) (now () - start).total_microseconds () * 1e3
+      / (value_type) iterations;
+    m.allocations = (value_type) nbAllocations / (value_type) iterations;
+    return m;
+  }
+
+  /// Measure the value and the jacobian.
+  /// \param noAllocation whether the evaluations must not allocate memory.
+  void run (const std::string& name, const DifferentiableFunction& f,
+      bool noAllocation)
+  {
+    const Measure value = measure (Value (f));
+    const Measure jacobian = measure (Jacobian (f));
+    baseline ().check (name + "/value", value.ns);
+    baseline ().check (name + "/jacobian", jacobian.ns);
+#ifdef __GLIBC__
+    if (noAllocation) {
+      BOOST_CHECK_MESSAGE (value.allocations == 0, name << ": "
+          << value.allocations << " allocations per value");
+      BOOST_CHECK_MESSAGE (jacobian.allocations == 0, name << ": "
+          << jacobian.allocations << " allocations per jacobian");
+    }
+#endif
+  }
+
+  struct Feet
+  {
+    Feet () :
+      ee1 (robot ()->getJointByName ("lleg5_joint")),
+      ee2 (robot ()->getJointByName ("rleg5_joint"))
+    {
+      robot ()->currentConfiguration (configurations () [0]);
+      robot ()->computeForwardKinematics ();
+      tf1 = ee1->currentTransformation ();
+      tf2 = ee2->currentTransformation ();
+    }
+    JointPtr_t ee1, ee2;
+    Transform3f tf1, tf2;
+  };
+
+  /// Square of side 2*half in the plane z = 0 of a joint.
+  ConvexShape square (const JointPtr_t& joint, const vector3_t& center,
+      value_type half)
+  {
+    std::vector <vector3_t> pts (4, center);
+    pts[0] += vector3_t (-half, -half, 0);
+    pts[1] += vector3_t ( half, -half, 0);
+    pts[2] += vector3_t ( half,  half, 0);
+    pts[3] += vector3_t (-half,  half, 0);
+    return ConvexShape (pts, joint);
+  }
+} // namespace
+
+BOOST_AUTO_TEST_CASE (generic_transformation)
+{
+  Feet feet;
+  PositionPtr_t reference (Position::create
+      ("Position", robot (), feet.ee2, feet.tf2, feet.tf1));
+  baseline ().reference (measure (Value (*reference)).ns);
+
+  run ("Position", *reference, true);
+  run ("Orientation", *Orientation::create
+      ("Orientation", robot (), feet.ee2, feet.tf2), true);
+  run ("Transformation", *Transformation::create
+      ("Transformation", robot (), feet.ee1, feet.tf1), true);
+  run ("RelativePosition", *RelativePosition::create
+      ("RelativePosition", robot (), feet.ee1, feet.ee2, feet.tf1, feet.tf2),
+      true);
+  run ("RelativeOrientation", *RelativeOrientation::create
+      ("RelativeOrientation", robot (), feet.ee1, feet.ee2, feet.tf1), true);
+  run ("RelativeTransformation", *RelativeTransformation::create
+      ("RelativeTransformation", robot (), feet.ee1, feet.ee2, feet.tf1,
+       feet.tf2), true);
+}
+
+#ifdef HPP_CONSTRAINTS_USE_QPOASES
+BOOST_AUTO_TEST_CASE (static_stability)
+{
+  Feet feet;
+  CenterOfMassComputationPtr_t com =
+    CenterOfMassComputation::create (robot ());
+  com->add (robot ()->rootJoint ());
+  for (std::size_t n = 8; n <= 32; n *= 2) {
+    StaticStability::Contacts_t contacts (n);
+    for (std::size_t i = 0; i < n; ++i) {
+      StaticStability::Contact_t& c = contacts [i];
+      c.joint1 = (i % 2 == 0) ? feet.ee1 : feet.ee2;
+      c.point1 = vector3_t (0.01 * (value_type) i, 0, 0);
+      c.normal1 = vector3_t (0, 0, 1);
+      c.point2 = vector3_t (0.01 * (value_type) i, 0, 0);
+      c.normal2 = vector3_t (0, 0, 1);
+    }
+    std::ostringstream name; name << "StaticStability/" << n;
+    run (name.str (), *StaticStability::create
+        ("StaticStability", robot (), contacts, com), false);
+  }
+}
+#endif
+
+BOOST_AUTO_TEST_CASE (convex_shape_contact)
+{
+  Feet feet;
+  for (std::size_t n = 10; n <= 1000; n *= 10) {
+    ConvexShapeContactPtr_t f = ConvexShapeContact::create
+      ("ConvexShapeContact", robot ());
+    f->addObject (square (feet.ee1, vector3_t::Zero (), 0.05));
+    f->addObject (square (feet.ee2, vector3_t::Zero (), 0.05));
+    for (std::size_t i = 0; i < n; ++i)
+      f->addFloor (square (JointPtr_t (),
+            vector3_t (0.2 * (value_type) i, 0, 0), 0.1));
+    std::ostringstream name; name << "ConvexShapeContact/" << n;
+    run (name.str (), *f, true);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (stack)
+{
+  Feet feet;
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("DifferentiableFunctionStack");
+  for (std::size_t i = 0; i < 50; ++i) {
+    // Distinct frames so that the functions do not share their results.
+    Transform3f tf (feet.tf1);
+    tf.translation () [2] += 0.01 * (value_type) i;
+    switch (i % 3) {
+      case 0:
+        stack->add (Position::create ("Position", robot (), feet.ee1, tf));
+        break;
+      case 1:
+        stack->add (Transformation::create
+            ("Transformation", robot (), feet.ee2, tf));
+        break;
+      default:
+        stack->add (RelativeTransformation::create
+            ("RelativeTransformation", robot (), feet.ee1, feet.ee2, tf,
+             feet.tf2));
+    }
+  }
+  run ("DifferentiableFunctionStack/50", *stack, true);
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE Recorder
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+#include <hpp/constraints/recorder.hh>
+#include <hpp/constraints/auto-diff-function.hh>
+
+using hpp::constraints::AutoDiffFunction;
+using hpp::constraints::EvaluationStatistics;
+using hpp::constraints::Recorder;
+using hpp::constraints::RecorderPtr_t;
+using hpp::constraints::Recording;
+using hpp::constraints::RecordingPtr_t;
+using hpp::constraints::matrix_t;
+using hpp::constraints::vector_t;
+
+/// f (x) = (x0 x1, x2^2 + x0)
+class Quadratic : public AutoDiffFunction <Quadratic>
+{
+  public:
+    Quadratic () : AutoDiffFunction <Quadratic> (3, 3, 2, "Quadratic") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = x [0] * x [1];
+      result [1] = x [2] * x [2] + x [0];
+    }
+};
+
+BOOST_AUTO_TEST_CASE (recordAndReplay)
+{
+  const std::string filename ("recorder-test.rec");
+  boost::shared_ptr <Quadratic> f (new Quadratic);
+  std::vector <vector_t> xs (3, vector_t (3));
+  {
+    RecorderPtr_t recorder (Recorder::create (f, filename));
+    vector_t value (2), expected (2);
+    matrix_t J (2, 3);
+    for (std::size_t i = 0; i < xs.size (); ++i) xs [i].setRandom ();
+    (*recorder) (value, xs [0]);
+    (*f) (expected, xs [0]);
+    BOOST_CHECK (value.isApprox (expected));
+    recorder->jacobian (J, xs [1]);
+    recorder->valueAndJacobian (value, J, xs [2]);
+    BOOST_CHECK_EQUAL (recorder->nbRecords (), 3);
+  }
+
+  RecordingPtr_t recording (Recording::load (filename));
+  BOOST_CHECK_EQUAL (recording->size (), 3);
+  BOOST_CHECK_EQUAL (recording->inputSize (), 3);
+  BOOST_CHECK_EQUAL (recording->outputSize (), 2);
+  BOOST_CHECK_EQUAL (recording->description ().find ("Quadratic"), 0);
+  BOOST_CHECK_EQUAL (recording->evaluation (0), EvaluationStatistics::VALUE);
+  BOOST_CHECK_EQUAL (recording->evaluation (1),
+      EvaluationStatistics::JACOBIAN);
+  BOOST_CHECK_EQUAL (recording->evaluation (2),
+      EvaluationStatistics::VALUE_AND_JACOBIAN);
+  for (std::size_t i = 0; i < xs.size (); ++i) {
+    BOOST_CHECK (recording->argument (i) == xs [i]);
+    BOOST_CHECK (recording->duration (i) >= 0);
+  }
+
+  vector_t durations;
+  recording->replay (*f, durations);
+  BOOST_CHECK_EQUAL (durations.size (), 3);
+  std::remove (filename.c_str ());
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+
+#define BOOST_TEST_MODULE RowRedundancy
+#include <boost/test/unit_test.hpp>
+
+#include <hpp/constraints/row-redundancy.hh>
+#include <hpp/constraints/differentiable-function-stack.hh>
+#include <hpp/constraints/auto-diff-function.hh>
+
+using hpp::constraints::AutoDiffFunction;
+using hpp::constraints::DifferentiableFunctionStack;
+using hpp::constraints::DifferentiableFunctionStackPtr_t;
+using hpp::constraints::RowRedundancy;
+using hpp::constraints::matrix_t;
+
+/// f (x) = (x0 x1, x2^2 + x0)
+class Quadratic : public AutoDiffFunction <Quadratic>
+{
+  public:
+    Quadratic () : AutoDiffFunction <Quadratic> (3, 3, 2, "Quadratic") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = x [0] * x [1];
+      result [1] = x [2] * x [2] + x [0];
+    }
+};
+
+/// f (x) = (2 x0 x1 + 1)
+class Product : public AutoDiffFunction <Product>
+{
+  public:
+    Product () : AutoDiffFunction <Product> (3, 3, 1, "Product") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = 2 * x [0] * x [1] + 1;
+    }
+};
+
+/// f (x) = (x2)
+class Last : public AutoDiffFunction <Last>
+{
+  public:
+    Last () : AutoDiffFunction <Last> (3, 3, 1, "Last") {}
+
+    template <typename Scalar>
+    void compute (Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& result,
+        const Eigen::Matrix <Scalar, Eigen::Dynamic, 1>& x) const
+    {
+      result [0] = x [2];
+    }
+};
+
+BOOST_AUTO_TEST_CASE (redundancy)
+{
+  DifferentiableFunctionStackPtr_t stack
+    (DifferentiableFunctionStack::create ("stack"));
+  stack->add (boost::shared_ptr <Quadratic> (new Quadratic));
+  stack->add (boost::shared_ptr <Product> (new Product));
+  stack->add (boost::shared_ptr <Last> (new Last));
+
+  RowRedundancy analysis (stack);
+  BOOST_CHECK (!analysis.structurallyZeroRows ().any ());
+  analysis.analyse (matrix_t::Random (3, 5));
+
+  // The row of Product is twice the first row of Quadratic.
+  BOOST_CHECK_EQUAL (analysis.rank (), 3);
+  BOOST_CHECK_EQUAL (analysis.redundantRows ().count (), 1);
+  BOOST_CHECK (analysis.redundantRows () [2]);
+  BOOST_CHECK (!analysis.redundant (0));
+  BOOST_CHECK ( analysis.redundant (1));
+  BOOST_CHECK (!analysis.redundant (2));
+
+  DifferentiableFunctionStackPtr_t reduced (analysis.reducedStack ());
+  BOOST_CHECK_EQUAL (reduced->functions ().size (), 2);
+  BOOST_CHECK_EQUAL (reduced->outputDerivativeSize (), 3);
+
+  BOOST_CHECK_EQUAL (analysis.prune (), 1);
+  BOOST_CHECK (!stack->active (stack->handle (1)));
+  BOOST_CHECK_EQUAL (analysis.prune (), 0);
+}
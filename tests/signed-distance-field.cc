@@ -0,0 +1,198 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: agent (agent@local)
+//
+// This file is part of hpp-constraints.
+// hpp-constraints is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-constraints is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
+
+#include "hpp/constraints/signed-distance-field.hh"
+#include "hpp/constraints/distance-between-body-and-field.hh"
+
+#include <cmath>
+#include <cstdio>
+
+#include <hpp/fcl/shape/geometric_shapes.h>
+#include <pinocchio/multibody/geometry.hpp>
+
+#include <hpp/pinocchio/collision-object.hh>
+
+#define BOOST_TEST_MODULE SignedDistanceField
+#include <boost/test/unit_test.hpp>
+
+#include "humanoid-fixture.hh"
+
+using hpp::pinocchio::CollisionObject;
+using hpp::pinocchio::GeomModelPtr_t;
+using hpp::pinocchio::GeomDataPtr_t;
+
+/// Fixed box and sphere, not attached to a joint.
+struct Obstacles
+{
+  Obstacles () : model (new se3::GeometryModel ()),
+    halfSides (.2, .3, .4), boxCenter (.1, -.2, .3),
+    radius (.3), sphereCenter (.5, .6, -.4)
+  {
+    add ("box", boost::shared_ptr <fcl::CollisionGeometry>
+        (new fcl::Box (2 * halfSides [0], 2 * halfSides [1],
+                       2 * halfSides [2])));
+    add ("sphere", boost::shared_ptr <fcl::CollisionGeometry>
+        (new fcl::Sphere (radius)));
+    data.reset (new se3::GeometryData (*model));
+    for (se3::GeomIndex i = 0; i < model->ngeoms; ++i)
+      objects.push_back (CollisionObjectPtr_t
+          (new CollisionObject (model, data, i)));
+    move (boxCenter);
+    objects [1]->move (Transform3f (Transform3f::Matrix3::Identity (),
+          sphereCenter));
+  }
+
+  void add (const std::string& name,
+      const boost::shared_ptr <fcl::CollisionGeometry>& geometry)
+  {
+    model->geometryObjects.push_back (se3::GeometryObject
+        (name, 0, 0, geometry, Transform3f::Identity (), ""));
+    ++model->ngeoms;
+  }
+
+  /// Move the box, which is not rotated so that the exact distance is
+  /// simple.
+  void move (const vector3_t& center)
+  {
+    boxCenter = center;
+    objects [0]->move (Transform3f (Transform3f::Matrix3::Identity (),
+          boxCenter));
+  }
+
+  /// Exact signed distance to the objects.
+  value_type distance (const vector3_t& p) const
+  {
+    const vector3_t d ((p - boxCenter).cwiseAbs () - halfSides);
+    const value_type box = (d.maxCoeff () < 0 ? d.maxCoeff () :
+        d.cwiseMax (vector3_t::Zero ()).norm ());
+    return std::min (box, (p - sphereCenter).norm () - radius);
+  }
+
+  GeomModelPtr_t model;
+  GeomDataPtr_t data;
+  std::vector <CollisionObjectPtr_t> objects;
+  vector3_t halfSides, boxCenter;
+  value_type radius;
+  vector3_t sphereCenter;
+}; // struct Obstacles
+
+const value_type resolution = .02, margin = .2;
+
+BOOST_FIXTURE_TEST_CASE (exactDistance, Obstacles) {
+  SignedDistanceFieldPtr_t field (SignedDistanceField::create
+      (objects, resolution, margin));
+  BOOST_CHECK (!field->mapped ());
+  // Points around the objects, inside the grid.
+  for (int i = 0; i < 1000; ++i) {
+    const vector3_t p (boxCenter + .5 * vector3_t::Random ());
+    BOOST_CHECK_SMALL (field->value (p) - distance (p), 2 * resolution);
+  }
+  BOOST_CHECK_SMALL (field->value (boxCenter) - distance (boxCenter),
+      2 * resolution);
+  BOOST_CHECK_SMALL (field->value (sphereCenter) - distance (sphereCenter),
+      2 * resolution);
+
+  // Beyond the grid, the distance is extrapolated along the normal of the
+  // border.
+  const vector3_t p (boxCenter - vector3_t (2, 0, 0));
+  BOOST_CHECK_SMALL (field->value (p) - distance (p), 2 * resolution);
+}
+
+BOOST_FIXTURE_TEST_CASE (gradient, Obstacles) {
+  SignedDistanceFieldPtr_t field (SignedDistanceField::create
+      (objects, resolution, margin));
+  const Eigen::Vector3i& dims = field->dimensions ();
+  const value_type h = 1e-6;
+  vector3_t g, dp;
+  for (int n = 0; n < 100; ++n) {
+    // Inside a voxel so that the interpolation is smooth around p.
+    const vector3_t x (.1 + .8 * (vector3_t::Random ().array () + 1) / 2);
+    vector3_t p;
+    for (int j = 0; j < 3; ++j)
+      p [j] = field->origin () [j] + resolution *
+        (rand () % (dims [j] - 1) + x [j]);
+    field->value (p, g);
+    for (int j = 0; j < 3; ++j) {
+      dp.setZero (); dp [j] = h;
+      const value_type fd = (field->value (p + dp) - field->value (p - dp))
+        / (2 * h);
+      BOOST_CHECK_SMALL (g [j] - fd, 1e-5);
+    }
+  }
+  // Beyond the grid.
+  const vector3_t p (field->origin () - vector3_t (.5, 0, 0));
+  field->value (p, g);
+  BOOST_CHECK (g.isApprox (vector3_t (-1, 0, 0)));
+}
+
+BOOST_FIXTURE_TEST_CASE (cacheFile, Obstacles) {
+  const std::string file ("signed-distance-field.cache");
+  std::remove (file.c_str ());
+  SignedDistanceFieldPtr_t baked (SignedDistanceField::create
+      (objects, resolution, margin, file));
+  BOOST_CHECK (!baked->mapped ());
+  SignedDistanceFieldPtr_t mapped (SignedDistanceField::create
+      (objects, resolution, margin, file));
+  BOOST_CHECK (mapped->mapped ());
+  BOOST_CHECK (mapped->dimensions () == baked->dimensions ());
+  for (int i = 0; i < 100; ++i) {
+    const vector3_t p (boxCenter + .5 * vector3_t::Random ());
+    BOOST_CHECK_EQUAL (mapped->value (p), baked->value (p));
+  }
+
+  // The box is turned around its center: the grid has the same size but
+  // the objects do not match the file anymore.
+  objects [0]->move (Transform3f (Eigen::AngleAxisd
+        (M_PI, vector3_t::UnitZ ()).toRotationMatrix (), boxCenter));
+  SignedDistanceFieldPtr_t moved (SignedDistanceField::create
+      (objects, resolution, margin, file));
+  BOOST_CHECK (!moved->mapped ());
+  BOOST_CHECK (moved->dimensions () == baked->dimensions ());
+  for (int i = 0; i < 100; ++i) {
+    const vector3_t p (boxCenter + .5 * vector3_t::Random ());
+    BOOST_CHECK_SMALL (moved->value (p) - distance (p), 2 * resolution);
+  }
+  BOOST_CHECK (SignedDistanceField::create
+      (objects, resolution, margin, file)->mapped ());
+  std::remove (file.c_str ());
+}
+
+BOOST_FIXTURE_TEST_CASE (distanceBetweenBodyAndField, Humanoid) {
+  // A box in front of the foot, close enough for the center of the
+  // sphere to remain in the grid.
+  Obstacles obstacles;
+  obstacles.move (tf1.translation () + vector3_t (.3, 0, 0));
+  SignedDistanceFieldPtr_t field (SignedDistanceField::create
+      (obstacles.objects, resolution, .5));
+  DistanceBetweenBodyAndField::Spheres_t spheres (1);
+  spheres [0].center = vector3_t (.05, 0, 0);
+  spheres [0].radius = .05;
+  DistanceBetweenBodyAndFieldPtr_t f (DistanceBetweenBodyAndField::create
+      ("foot/field", device, ee1, field, spheres));
+
+  const Configuration_t q (device->currentConfiguration ());
+  vector_t value (1);
+  (*f) (value, q);
+  const vector3_t center (tf1.act (spheres [0].center));
+  BOOST_CHECK_SMALL (value [0] - (field->value (center) - spheres [0].radius),
+      1e-12);
+
+  matrix_t J (1, f->inputDerivativeSize ()),
+           Jfd (1, f->inputDerivativeSize ());
+  f->jacobian (J, q);
+  f->finiteDifferenceCentral (Jfd, q, device, 1e-6);
+  BOOST_CHECK ((J - Jfd).isZero (1e-4));
+}
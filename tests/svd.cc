@@ -74,3 +74,112 @@ BOOST_AUTO_TEST_CASE(eigen_svd_features)
     BOOST_CHECK_MESSAGE ((PSinv + PKinv).isApprox (matrix_t::Identity(rows, rows)), "PSinv + PKinv = I failed");
   }
 }
+
+BOOST_AUTO_TEST_CASE(svd_projectors)
+{
+  const std::size_t rows = 4, cols = 6;
+  typedef Eigen::JacobiSVD <matrix_t> SVD;
+  SVD svd (rows, cols, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  hpp::constraints::SVDProjectors <SVD> projectors (svd);
+  matrix_t P (cols, cols), Pinv (rows, rows);
+  for (int i = 0; i < 100; ++i) {
+    matrix_t M = matrix_t::Random (rows, cols);
+    if (i % 2) M.row (3) = M.row (0) - M.row (2);
+    svd.compute (M);
+    projectors.update ();
+
+    const matrix_t X = matrix_t::Random (cols, 3), Y = matrix_t::Random (rows, 3);
+    matrix_t PX (cols, 3), PY (rows, 3);
+
+    projectorOnKernel <SVD> (svd, P, true);
+    projectors.projectOnKernel (X, PX);
+    BOOST_CHECK (PX.isApprox (P * X));
+    projectorOnSpan <SVD> (svd, P);
+    projectors.projectOnSpan (X, PX);
+    BOOST_CHECK (PX.isApprox (P * X));
+    projectorOnKernelOfInv <SVD> (svd, Pinv, true);
+    projectors.projectOnKernelOfInv (Y, PY);
+    BOOST_CHECK ((PY - Pinv * Y).isZero ());
+    projectorOnSpanOfInv <SVD> (svd, Pinv);
+    projectors.projectOnSpanOfInv (Y, PY);
+    BOOST_CHECK (PY.isApprox (Pinv * Y));
+
+    // In place.
+    PX = X;
+    projectors.projectOnKernel (PX, PX);
+    projectorOnKernel <SVD> (svd, P, true);
+    BOOST_CHECK (PX.isApprox (P * X));
+  }
+}
+
+template <typename SVD>
+void checkDecomposition (SVD& svd, const matrix_t& M, const value_type tol)
+{
+  svd.compute (M);
+  Eigen::JacobiSVD <matrix_t> ref (M, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  const std::size_t k = svd.rank ();
+  BOOST_CHECK_EQUAL (k, (std::size_t) ref.rank ());
+  BOOST_CHECK_MESSAGE (svd.singularValues ().head (k).isApprox
+      (ref.singularValues ().head (k), tol),
+      svd.singularValues ().transpose () << '\n'
+      << ref.singularValues ().transpose ());
+  matrix_t Mpinv (M.cols (), M.rows ());
+  pseudoInverse <SVD> (svd, Mpinv);
+  BOOST_CHECK_MESSAGE ((M * Mpinv * M).isApprox (M, tol),
+      "M = M * M+ * M failed");
+  BOOST_CHECK_MESSAGE ((Mpinv * M * Mpinv).isApprox (Mpinv, tol),
+      "M+ = M+ * M * M+ failed");
+  const matrix_t U1 = svd.matrixU ().leftCols (k), V1 = svd.matrixV ().leftCols (k);
+  BOOST_CHECK ((U1.adjoint () * U1).isIdentity (tol));
+  BOOST_CHECK ((V1.adjoint () * V1).isIdentity (tol));
+  BOOST_CHECK ((U1 * svd.singularValues ().head (k).asDiagonal ()
+        * V1.adjoint ()).isApprox (M, tol));
+}
+
+template <typename SVD>
+void checkDecompositions (const value_type tol)
+{
+  SVD wide (6, 10, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  SVD tall (10, 4, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  for (int i = 0; i < 100; ++i) {
+    checkDecomposition (wide, matrix_t::Random (6, 10), tol);
+    checkDecomposition (tall, matrix_t::Random (10, 4), tol);
+    // Rank deficient.
+    matrix_t M = matrix_t::Random (6, 10);
+    M.row (5) = M.row (0) + M.row (1);
+    checkDecomposition (wide, M, tol);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gram_svd)
+{
+  checkDecompositions <hpp::constraints::GramSVD <matrix_t> > (1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(warm_start_jacobi_svd)
+{
+  typedef hpp::constraints::WarmStartJacobiSVD <matrix_t> SVD;
+  checkDecompositions <SVD> (1e-10);
+
+  // Nearby matrices need less sweeps than a cold start.
+  SVD svd (6, 10);
+  matrix_t M = matrix_t::Random (6, 10);
+  svd.compute (M);
+  for (int i = 0; i < 100; ++i) {
+    const matrix_t dM = 1e-4 * matrix_t::Random (6, 10);
+    svd.reset ();
+    svd.compute (M + dM);
+    const std::size_t cold = svd.sweeps ();
+    svd.compute (M);
+    svd.compute (M + dM);
+    BOOST_CHECK_LT (svd.sweeps (), cold);
+    checkDecomposition (svd, M + dM, 1e-10);
+  }
+}
+
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+BOOST_AUTO_TEST_CASE(bdc_svd)
+{
+  checkDecompositions <Eigen::BDCSVD <matrix_t> > (1e-10);
+}
+#endif
@@ -14,20 +14,55 @@
 // received a copy of the GNU Lesser General Public License along with
 // hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
 
+// Make Eigen check heap allocations in the scope of MallocCounter.
+#define EIGEN_RUNTIME_NO_MALLOC
+
 #define BOOST_TEST_MODULE SymbolicCalculus
 #include <boost/test/included/unit_test.hpp>
 
 #include <stdlib.h>
 #include <limits>
 #include <math.h>
+#include <algorithm>
 
 #include <Eigen/Geometry>
 
 #include <hpp/constraints/symbolic-calculus.hh>
 #include <hpp/constraints/symbolic-function.hh>
+#include <hpp/constraints/fused-calculus.hh>
 
 using namespace hpp::constraints;
 
+/// Count the allocations done with operator new and forbid the allocations
+/// done by Eigen during its lifetime.
+struct MallocCounter {
+  static std::size_t& count () { static std::size_t c = 0; return c; }
+  static bool& active () { static bool a = false; return a; }
+
+  MallocCounter () {
+    count () = 0;
+    active () = true;
+    Eigen::internal::set_is_malloc_allowed (false);
+  }
+  ~MallocCounter () {
+    Eigen::internal::set_is_malloc_allowed (true);
+    active () = false;
+  }
+};
+
+void* operator new (std::size_t size)
+{
+  if (MallocCounter::active ()) ++MallocCounter::count ();
+  void* p = malloc (size == 0 ? 1 : size);
+  if (!p) throw std::bad_alloc ();
+  return p;
+}
+
+void operator delete (void* p) throw ()
+{
+  free (p);
+}
+
 typedef SymbolicFunction<JointFrame> JointFrameFunction;
 
 template <class ValueType = eigen::vector3_t,
@@ -423,3 +458,338 @@ BOOST_AUTO_TEST_CASE (MatrixOfExpTest) {
   delete d1;
   delete d2;
 }
+
+namespace fusedExp {
+  typedef Eigen::Matrix <value_type, 3, 1> Value;
+  typedef Eigen::Matrix <value_type, 3, Eigen::Dynamic, Eigen::RowMajor> Jacobian;
+  typedef PointTesterT <Value, Jacobian> PointTester;
+  typedef PointTester::DataWrapper DataWrapper;
+
+  /// Leaf of a fused expression reading the data of a DataWrapper.
+  class FusedPointTester : public fused::Expression <FusedPointTester>
+  {
+    public:
+      FusedPointTester (DataWrapper* d) : datas (d) {}
+
+      void impl_compute (bool) const
+      {
+        this->value_ = datas->value;
+      }
+      template <int R> void impl_addJacobian
+        (const Eigen::Matrix<value_type, R, 3>& A, matrixOut_t J) const
+      {
+        J.noalias() += A * datas->jacobian;
+      }
+
+      DataWrapper* datas;
+  };
+
+  void setWrappers (DataWrapper* d1, DataWrapper* d2)
+  {
+    d1->value = Value::Random ();
+    d2->value = Value::Random ();
+    d1->jacobian = Jacobian::Random (3, 6);
+    d2->jacobian = Jacobian::Random (3, 6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (FusedExpressionTest) {
+  using namespace fusedExp;
+  DataWrapper* d1 = new DataWrapper ();
+  DataWrapper* d2 = new DataWrapper ();
+  DataWrapper* d3 = new DataWrapper ();
+  Traits<PointTester>::Ptr_t p1 = PointTester::create (d1),
+    p2 = PointTester::create (d2), p3 = PointTester::create (d3);
+  FusedPointTester f1 (d1), f2 (d2), f3 (d3);
+
+  // Same expression as ComBetweenFeet::ecrossu_
+  typedef CrossProduct <Difference <PointTester, ScalarMultiply <
+    Sum <PointTester, PointTester> > >, Difference <PointTester,
+    PointTester> > Dynamic_t;
+  typedef fused::CrossProduct <fused::Difference <FusedPointTester,
+          fused::ScalarMultiply <fused::Sum <FusedPointTester,
+          FusedPointTester> > >, fused::Difference <FusedPointTester,
+          FusedPointTester> > Fused_t;
+  Traits<Dynamic_t>::Ptr_t dyn = (p3 - (0.5 * (p1 + p2))) ^ (p2 - p1);
+  Fused_t fus = (f3 - (0.5 * (f1 + f2))) ^ (f2 - f1);
+
+  typedef ScalarProduct <Difference <PointTester, PointTester>,
+          PointTester> DynamicDot_t;
+  typedef fused::ScalarProduct <fused::Difference <FusedPointTester,
+          FusedPointTester>, FusedPointTester> FusedDot_t;
+  Traits<DynamicDot_t>::Ptr_t dynDot = (p1 - p2) * p2;
+  FusedDot_t fusDot = (f1 - f2) * f2;
+
+  // Wrapped to be used as a CalculusBase.
+  typedef fused::Calculus <Fused_t> Calculus_t;
+  Traits<Calculus_t>::Ptr_t calculus = Calculus_t::create (fus, 6);
+
+  matrix_t J (3, 6), Jdot (1, 6);
+  for (size_t i = 0; i < 100; i++) {
+    setWrappers (d1, d2);
+    setWrappers (d3, d3);
+    dyn->invalidate ();
+    dyn->computeValue ();
+    dyn->computeJacobian ();
+    fus.jacobian (J);
+    BOOST_CHECK (fus.value ().isApprox (dyn->value ()));
+    BOOST_CHECK (J.isApprox (dyn->jacobian ()));
+
+    dynDot->invalidate ();
+    dynDot->computeValue ();
+    dynDot->computeJacobian ();
+    fusDot.jacobian (Jdot);
+    BOOST_CHECK_CLOSE (fusDot.value ()[0], dynDot->value (), 1e-8);
+    BOOST_CHECK (Jdot.isApprox (dynDot->jacobian ()));
+
+    calculus->invalidate ();
+    calculus->computeValue ();
+    calculus->computeJacobian ();
+    BOOST_CHECK (calculus->value ().isApprox (dyn->value ()));
+    BOOST_CHECK (calculus->jacobian ().isApprox (dyn->jacobian ()));
+
+    // Only the last row.
+    fus.compute (true);
+    Eigen::Matrix <value_type, 1, 3> A (0, 0, 1);
+    Jdot.setZero ();
+    fus.addJacobian (A, Jdot);
+    BOOST_CHECK (Jdot.isApprox (dyn->jacobian ().row (2)));
+  }
+  delete d1;
+  delete d2;
+  delete d3;
+}
+
+BOOST_AUTO_TEST_CASE (AdjointTest) {
+  using namespace fusedExp;
+  DataWrapper* d1 = new DataWrapper ();
+  DataWrapper* d2 = new DataWrapper ();
+  DataWrapper* d3 = new DataWrapper ();
+  Traits<PointTester>::Ptr_t p1 = PointTester::create (d1),
+    p2 = PointTester::create (d2), p3 = PointTester::create (d3);
+
+  Traits<CalculusBaseAbstract<> >::Ptr_t cross =
+    (p3 - (0.5 * (p1 + p2))) ^ (p2 - p1);
+  Traits<CalculusBaseAbstract<value_type, RowJacobianMatrix> >::Ptr_t dot =
+    (p1 - p2) * p3;
+
+  typedef MatrixOfExpressions <vector3_t, JacobianMatrix> MoE_t;
+  MoE_t moe (matrix_t::Zero (6, 2), matrix_t::Zero (6, 2 * 6));
+  moe.setSize (2, 2);
+  moe.set (0, 0, p1);
+  moe.set (1, 0, cross);
+  moe.set (0, 1, p2 - p3);
+  moe.set (1, 1, p1 ^ p3);
+
+  RowJacobianMatrix out (6);
+  for (size_t i = 0; i < 100; i++) {
+    setWrappers (d1, d2);
+    setWrappers (d3, d3);
+    cross->invalidate ();
+    cross->computeValue ();
+    cross->computeJacobian ();
+    const vector3_t seed (vector3_t::Random ());
+    out.setZero ();
+    cross->accumulateAdjoint (seed, out);
+    BOOST_CHECK (out.isApprox (seed.transpose () * cross->jacobian ()));
+
+    // Written without forming the jacobians of the nodes.
+    matrix_t J (3, cross->jacobian ().cols ());
+    const JacobianMatrix expectedJ (cross->jacobian ());
+    cross->invalidate ();
+    cross->jacobianInto (J);
+    BOOST_CHECK (J.isApprox (expectedJ));
+
+    dot->invalidate ();
+    dot->computeValue ();
+    dot->computeJacobian ();
+    const vector_t s (vector_t::Constant (1, 2.));
+    out.setZero ();
+    dot->accumulateAdjoint (s, out);
+    BOOST_CHECK (out.isApprox (2 * dot->jacobian ()));
+
+    moe.invalidate ();
+    moe.computeValue ();
+    moe.computeJacobian ();
+    const vector_t lhs (vector_t::Random (6)), rhs (vector_t::Random (2));
+    RowJacobianMatrix expected (RowJacobianMatrix::Zero (6));
+    matrix_t JT (2, 6), expectedJT (2, 6);
+    for (std::size_t j = 0; j < 2; ++j) {
+      expectedJT.row (j) = lhs.transpose () * moe.jacobian ().middleCols (6 * j, 6);
+      expected += rhs[j] * expectedJT.row (j);
+    }
+    moe.jacobianAdjoint (lhs, rhs, out);
+    BOOST_CHECK (out.isApprox (expected));
+    moe.jacobianTransposeTimes (lhs, JT);
+    BOOST_CHECK (JT.isApprox (expectedJT));
+  }
+  delete d1;
+  delete d2;
+  delete d3;
+}
+
+template <typename MoE_t>
+void evaluate (MoE_t& moe, const vector_t& rhs6, const vector_t& rhs4,
+    matrix_t& J6, matrix_t& J4, RowJacobianMatrix& row)
+{
+  moe.invalidate ();
+  moe.computeValue ();
+  moe.computeJacobian ();
+  moe.computeSVD ();
+  moe.computePseudoInverse ();
+  moe.computePseudoInverseJacobian (rhs6);
+  moe.jacobianTimes (rhs4, J6);
+  moe.jacobianTransposeTimes (rhs6, J4);
+  moe.jacobianAdjoint (rhs6, rhs4, row);
+}
+
+BOOST_AUTO_TEST_CASE (MatrixOfExpNoMallocTest) {
+  using namespace fusedExp;
+  DataWrapper* d1 = new DataWrapper ();
+  DataWrapper* d2 = new DataWrapper ();
+  Traits<PointTester>::Ptr_t p1 = PointTester::create (d1),
+    p2 = PointTester::create (d2);
+  typedef MatrixOfExpressions <vector3_t, JacobianMatrix> MoE_t;
+  MoE_t moe (matrix_t::Zero (6, 4), matrix_t::Zero (6, 4 * 6));
+  moe.setSize (2, 4);
+  moe.set (0, 0, p1);
+  moe.set (1, 0, p1 ^ p2);
+  moe.set (0, 1, p1 - p2);
+  moe.set (1, 1, p1 + p2);
+  moe.set (0, 2, p2);
+  moe.set (1, 2, p2 ^ p1);
+  moe.set (0, 3, 2. * p1);
+  moe.set (1, 3, p2 - p1);
+
+  const vector_t rhs6 (vector_t::Random (6)), rhs4 (vector_t::Random (4));
+  matrix_t J6 (6, 6), J4 (4, 6);
+  RowJacobianMatrix row (6);
+  // The first evaluation sizes the buffers.
+  setWrappers (d1, d2);
+  evaluate (moe, rhs6, rhs4, J6, J4, row);
+  for (size_t i = 0; i < 10; i++) {
+    setWrappers (d1, d2);
+    std::size_t count;
+    {
+      MallocCounter counter;
+      evaluate (moe, rhs6, rhs4, J6, J4, row);
+      count = MallocCounter::count ();
+    }
+    BOOST_CHECK_EQUAL (count, 0);
+  }
+
+  // Check the pseudo inverse and its derivative.
+  BOOST_CHECK (moe.pinv ().isApprox (
+        moe.value ().jacobiSvd (Eigen::ComputeFullU | Eigen::ComputeFullV)
+        .solve (matrix_t::Identity (6, 6))));
+  delete d1;
+  delete d2;
+}
+
+BOOST_AUTO_TEST_CASE (CalculusGraphTest) {
+  const vector3_t v (vector3_t::Random ()), w (vector3_t::Random ());
+  Traits<Point>::Ptr_t a = Point::create (v, 6), b = Point::create (v, 6),
+    c = Point::create (w, 6);
+  typedef Difference <Point, Point> D_t;
+  typedef CrossProduct <D_t, Sum <Point, Point> > CP_t;
+  Traits<D_t>::Ptr_t d = a - b;
+  Traits<CP_t>::Ptr_t cp = (a - c) ^ (b + c);
+
+  CalculusGraph graph;
+  graph.add (d);
+  graph.add (cp);
+  // a and b are merged.
+  BOOST_CHECK_EQUAL (graph.nbLeaves (), 2);
+  BOOST_CHECK_EQUAL (graph.nodes ().size (), 6);
+
+  // Each node comes after its dependencies.
+  const std::vector <CalculusNode*>& nodes = graph.nodes ();
+  for (std::size_t i = 0; i < nodes.size (); ++i) {
+    std::vector <CalculusNode*> deps;
+    nodes[i]->dependencies (deps);
+    for (std::size_t j = 0; j < deps.size (); ++j) {
+      std::size_t k =
+        std::find (nodes.begin (), nodes.end (), deps[j]) - nodes.begin ();
+      BOOST_CHECK (k < i);
+    }
+  }
+
+  BOOST_CHECK (graph.update (1));
+  BOOST_CHECK (!graph.update (1));
+  graph.computeValue ();
+  graph.computeJacobian ();
+  BOOST_CHECK (d->value ().isZero ());
+  BOOST_CHECK (cp->value ().isApprox ((v - w).cross (v + w)));
+  BOOST_CHECK (cp->jacobian ().isZero ());
+  BOOST_CHECK (graph.update (2));
+}
+
+BOOST_AUTO_TEST_CASE (CalculusArenaTest) {
+  const vector3_t v (vector3_t::Random ()), w (vector3_t::Random ());
+  typedef CrossProduct <Difference <Point, Point>, Point> CP_t;
+  Traits<CP_t>::Ptr_t cp;
+  {
+    CalculusArena arena;
+    CalculusArena::Scope scope (arena);
+    Traits<Point>::Ptr_t a = Point::create (v, 6), b = Point::create (w, 6);
+    cp = (a - b) ^ b;
+    BOOST_CHECK (arena.used () > 0);
+  }
+  // Outside the scope, nodes are allocated with new.
+  BOOST_CHECK (CalculusArena::current () == NULL);
+
+  // The nodes outlive the arena.
+  cp->invalidate ();
+  cp->computeValue ();
+  cp->computeJacobian ();
+  BOOST_CHECK (cp->value ().isApprox ((v - w).cross (w)));
+  BOOST_CHECK (cp->jacobian ().isZero ());
+}
+
+BOOST_AUTO_TEST_CASE (ConstantOperandTest) {
+  using namespace fusedExp;
+  DataWrapper* d1 = new DataWrapper ();
+  DataWrapper* d2 = new DataWrapper ();
+  setWrappers (d1, d2);
+  Traits<PointTester>::Ptr_t p1 = PointTester::create (d1);
+  const vector3_t v (vector3_t::Random ());
+  Traits<Point>::Ptr_t c = Point::create (v, 6);
+  matrix3_t X;
+  computeCrossMatrix (v, X);
+
+  // The constant operands do not contribute to the column range.
+  size_type b, e;
+  (c - c)->jacobianColumns (b, e);
+  BOOST_CHECK (b >= e);
+  (c ^ p1)->jacobianColumns (b, e);
+  BOOST_CHECK_EQUAL (b, 0);
+  BOOST_CHECK_EQUAL (e, std::numeric_limits <size_type>::max ());
+
+  Traits<CalculusBaseAbstract<> >::Ptr_t sum = c + p1, diff = c - p1,
+    cross = p1 ^ c, constant = (c ^ c) + c;
+  Traits<CalculusBaseAbstract<value_type, RowJacobianMatrix> >::Ptr_t dot =
+    c * p1;
+  sum->invalidate ();
+  diff->invalidate ();
+  cross->invalidate ();
+  constant->invalidate ();
+  dot->invalidate ();
+  sum->computeJacobian ();
+  diff->computeJacobian ();
+  cross->computeJacobian ();
+  constant->computeJacobian ();
+  dot->computeJacobian ();
+  BOOST_CHECK (sum->jacobian ().isApprox (d1->jacobian));
+  BOOST_CHECK (diff->jacobian ().isApprox (- d1->jacobian));
+  BOOST_CHECK (cross->jacobian ().isApprox (- X * d1->jacobian));
+  BOOST_CHECK_EQUAL (constant->jacobian ().cols (), 6);
+  BOOST_CHECK (constant->jacobian ().isZero ());
+  BOOST_CHECK (dot->jacobian ().isApprox (v.transpose () * d1->jacobian));
+
+  RowJacobianMatrix out (RowJacobianMatrix::Zero (6));
+  const vector3_t seed (vector3_t::Random ());
+  cross->accumulateAdjoint (seed, out);
+  BOOST_CHECK (out.isApprox (seed.transpose () * cross->jacobian ()));
+  delete d1;
+  delete d2;
+}
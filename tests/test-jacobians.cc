@@ -23,6 +23,8 @@
 #include <hpp/pinocchio/simple-device.hh>
 
 #include "hpp/constraints/generic-transformation.hh"
+#include "hpp/constraints/axis-alignment.hh"
+#include "hpp/constraints/transformation-set.hh"
 #include "hpp/constraints/symbolic-function.hh"
 #include "hpp/constraints/convex-shape-contact.hh"
 #include "hpp/constraints/static-stability.hh"
@@ -333,6 +335,28 @@ BOOST_AUTO_TEST_CASE (jacobian) {
 
   device->currentConfiguration (*cs.shoot ());
   device->computeForwardKinematics ();
+  functions.push_back ( DFptr (
+        "AxisAlignment parallel",
+        AxisAlignment::create ("AxisAlignment", device, ee1, vector3_t (1,0,0),
+          ee2, vector3_t (0,1,1))
+      ));
+  functions.push_back ( DFptr (
+        "AxisAlignment orthogonal to world axis",
+        AxisAlignment::create ("AxisAlignment", device, JointPtr_t (),
+          vector3_t (0,0,1), ee2, vector3_t (0,0,1), AxisAlignment::ORTHOGONAL)
+      ));
+  TransformationSet::Targets_t targets;
+  targets.push_back (TransformationSet::Target (ee1, tf1, tf2));
+  targets.push_back (TransformationSet::Target (ee2, tf2, tf1,
+        list_of(true)(false)(true)(false)(true)(true)
+        .convert_to_container<BoolVector_t>()));
+  targets.push_back (TransformationSet::Target (ee1, tf2, MId,
+        list_of(true)(true)(true)(false)(false)(false)
+        .convert_to_container<BoolVector_t>()));
+  functions.push_back ( DFptr (
+        "TransformationSet",
+        TransformationSet::create ("TransformationSet", device, targets)
+      ));
   tf1 = ee1->currentTransformation ();
   tf2 = ee2->currentTransformation ();
 
@@ -516,3 +540,51 @@ BOOST_AUTO_TEST_CASE (SymbolicCalculus_jointframe) {
       BOOST_CHECK (jacobian1.isApprox ( jacobian2));
   }
 }
+
+BOOST_AUTO_TEST_CASE (TransformationSet_transformation) {
+  DevicePtr_t device = createRobot ();
+  JointPtr_t ee1 = device->getJointByName ("lleg5_joint"),
+             ee2 = device->getJointByName ("rleg5_joint");
+  BOOST_REQUIRE (device);
+  BasicConfigurationShooter cs (device);
+
+  device->currentConfiguration (*cs.shoot ());
+  device->computeForwardKinematics ();
+  Transform3f tf1 (ee1->currentTransformation ());
+  Transform3f tf2 (ee2->currentTransformation ());
+  BoolVector_t mask (list_of(false)(true)(true)(true)(false)(true)
+      .convert_to_container<BoolVector_t>());
+
+  /// The set must be equal to the stack of the transformations.
+  typedef DifferentiableFunctionPtr_t DFptr;
+  DifferentiableFunctionStackPtr_t stack =
+    DifferentiableFunctionStack::create ("Stack");
+  stack->add (Transformation::create ("T1", device, ee2, tf1, tf2));
+  stack->add (Transformation::create ("T2", device, ee1, tf2, MId, mask));
+  stack->add (Transformation::create ("T3", device, ee2, MId, tf1));
+  TransformationSet::Targets_t targets;
+  targets.push_back (TransformationSet::Target (ee2, tf1, tf2));
+  targets.push_back (TransformationSet::Target (ee1, tf2, MId, mask));
+  targets.push_back (TransformationSet::Target (ee2, MId, tf2));
+  TransformationSetPtr_t set =
+    TransformationSet::create ("TransformationSet", device, targets);
+  set->reference (2, tf1);
+  BOOST_REQUIRE_EQUAL (set->outputSize (), stack->outputSize ());
+
+  ConfigurationPtr_t q1;
+  vector_t value1 = vector_t (stack->outputSize ());
+  vector_t value2 = vector_t (stack->outputSize ());
+  matrix_t jacobian1 = matrix_t (stack->outputSize (), device->numberDof ());
+  matrix_t jacobian2 = matrix_t (stack->outputSize (), device->numberDof ());
+  for (int i = 0; i < 100; i++) {
+      q1 = cs.shoot ();
+      (*stack) (value1, *q1);
+      (*set) (value2, *q1);
+      BOOST_CHECK (value1.isApprox (value2));
+      jacobian1.setZero ();
+      jacobian2.setZero ();
+      stack->jacobian (jacobian1, *q1);
+      set->jacobian (jacobian2, *q1);
+      BOOST_CHECK (jacobian1.isApprox (jacobian2));
+  }
+}